@@ -5,11 +5,13 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "ciri/api/api.h"
 #include "ciri/api/feature.h"
 #include "ciri/node/network/uri.h"
+#include "ciri/storage/batch.h"
 #include "common/helpers/pow.h"
 #include "utils/logger_helper.h"
 #include "utils/time.h"
@@ -18,6 +20,108 @@
 
 static logger_id_t logger_id;
 
+/*
+ * Private functions
+ */
+
+typedef retcode_t (*transaction_loaded_func)(void *const arg, iota_transaction_t const *const tx, bool const found);
+
+/**
+ * Loads transactions by chunks of hashes so that large requests don't need as many transactions in memory
+ * The function is called in order of the hashes with each transaction and whether it was found
+ */
+static retcode_t transactions_load_by_chunks(tangle_t const *const tangle, hash243_queue_t const hashes,
+                                             bool const partial, partial_transaction_model_e const model,
+                                             transaction_loaded_func const func, void *const arg) {
+  retcode_t ret = RC_OK;
+  size_t capacity = MIN(hash243_queue_count(hashes), STORAGE_BATCH_CHUNK_SIZE);
+  iota_transaction_t *txs = NULL;
+  iota_transaction_t **models = NULL;
+  iota_stor_pack_t pack;
+  hash243_queue_t chunk = NULL;
+  hash243_queue_entry_t *iter = NULL;
+  size_t count = 0;
+
+  if (capacity == 0) {
+    return RC_OK;
+  }
+
+  if ((txs = (iota_transaction_t *)calloc(capacity, sizeof(iota_transaction_t))) == NULL ||
+      (models = (iota_transaction_t **)calloc(capacity, sizeof(iota_transaction_t *))) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+  for (size_t i = 0; i < capacity; i++) {
+    models[i] = &txs[i];
+  }
+  pack.models = (void **)models;
+  pack.capacity = capacity;
+
+  CDL_FOREACH(hashes, iter) {
+    if ((ret = hash243_queue_push(&chunk, iter->hash)) != RC_OK) {
+      goto done;
+    }
+    if (++count < capacity && iter->next != hashes) {
+      continue;
+    }
+
+    pack.num_loaded = 0;
+    if (partial) {
+      ret = iota_tangle_transactions_load_partial(tangle, chunk, &pack, model);
+    } else {
+      ret = iota_tangle_transactions_load(tangle, chunk, &pack);
+    }
+    if (ret != RC_OK) {
+      goto done;
+    }
+
+    for (size_t i = 0; i < pack.num_loaded; i++) {
+      if ((ret = func(arg, &txs[i], txs[i].loaded_columns_mask.metadata || txs[i].loaded_columns_mask.essence)) !=
+          RC_OK) {
+        goto done;
+      }
+    }
+
+    hash243_queue_free(&chunk);
+    count = 0;
+  }
+
+done:
+  hash243_queue_free(&chunk);
+  free(models);
+  free(txs);
+
+  return ret;
+}
+
+typedef struct inclusion_states_params_s {
+  get_inclusion_states_res_t *res;
+  uint64_t lsm_index;
+} inclusion_states_params_t;
+
+static retcode_t inclusion_state_add(void *const arg, iota_transaction_t const *const tx, bool const found) {
+  inclusion_states_params_t *params = (inclusion_states_params_t *)arg;
+
+  if (!found || transaction_snapshot_index(tx) == 0 || transaction_snapshot_index(tx) > params->lsm_index) {
+    return get_inclusion_states_res_states_add(params->res, false);
+  }
+
+  return get_inclusion_states_res_states_add(params->res, true);
+}
+
+static retcode_t trytes_add(void *const arg, iota_transaction_t const *const tx, bool const found) {
+  get_trytes_res_t *res = (get_trytes_res_t *)arg;
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+
+  if (found) {
+    transaction_serialize_on_flex_trits((iota_transaction_t *)tx, tx_trits);
+  } else {
+    memset(tx_trits, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_8019);
+  }
+
+  return hash8019_queue_push(&res->trytes, tx_trits);
+}
+
 /*
  * Public functions
  */
@@ -194,6 +298,8 @@ retcode_t iota_api_find_transactions(iota_api_t const *const api, tangle_t *cons
                                      error_res_t **const error) {
   retcode_t ret = RC_OK;
   iota_stor_pack_t pack;
+  storage_cursor_t cursor;
+  size_t found = 0;
 
   if (api == NULL || req == NULL || res == NULL || error == NULL) {
     return RC_NULL_PARAM;
@@ -204,25 +310,33 @@ retcode_t iota_api_find_transactions(iota_api_t const *const api, tangle_t *cons
     return RC_API_FIND_TRANSACTIONS_NO_INPUT;
   }
 
-  // TODO Refactor stor_pack #618
-  hash_pack_init(&pack, 1024);
-
-  if ((ret = iota_tangle_transaction_find(tangle, req->bundles, req->addresses, req->tags, req->approvees, &pack)) !=
-      RC_OK) {
-    goto done;
+  if ((ret = hash_pack_init(&pack, 1024)) != RC_OK) {
+    return ret;
   }
 
-  if (pack.num_loaded > api->conf.max_find_transactions) {
-    ret = RC_API_MAX_FIND_TRANSACTIONS;
+  if ((ret = iota_tangle_cursor_find_open(tangle, &cursor, req->bundles, req->addresses, req->tags,
+                                          req->approvees)) != RC_OK) {
     goto done;
   }
 
-  for (size_t i = 0; i < pack.num_loaded; i++) {
-    if ((ret = hash243_queue_push(&res->hashes, (pack.models)[i])) != RC_OK) {
-      goto done;
+  // Results are streamed so that a request exceeding the maximum is rejected without loading all of them
+  while ((ret = iota_tangle_cursor_next(&cursor, &pack)) == RC_OK && pack.num_loaded > 0) {
+    if ((found += pack.num_loaded) > api->conf.max_find_transactions) {
+      ret = RC_API_MAX_FIND_TRANSACTIONS;
+      break;
+    }
+    for (size_t i = 0; i < pack.num_loaded; i++) {
+      if ((ret = hash243_queue_push(&res->hashes, (pack.models)[i])) != RC_OK) {
+        break;
+      }
+    }
+    if (ret != RC_OK) {
+      break;
     }
   }
 
+  iota_tangle_cursor_close(&cursor);
+
 done:
   hash_pack_free(&pack);
   return ret;
@@ -334,8 +448,6 @@ done:
 retcode_t iota_api_get_inclusion_states(iota_api_t const *const api, tangle_t *const tangle,
                                         get_inclusion_states_req_t const *const req,
                                         get_inclusion_states_res_t *const res, error_res_t **const error) {
-  retcode_t ret = RC_OK;
-
   if (api == NULL || tangle == NULL || req == NULL || res == NULL || error == NULL) {
     return RC_NULL_PARAM;
   }
@@ -346,25 +458,12 @@ retcode_t iota_api_get_inclusion_states(iota_api_t const *const api, tangle_t *c
   }
 
   {
-    hash243_queue_entry_t *iter = NULL;
-    DECLARE_PACK_SINGLE_TX(tx, txp, pack);
-    uint64_t lsm_index = api->core->consensus.milestone_tracker.latest_solid_milestone_index;
-
-    CDL_FOREACH(req->transactions, iter) {
-      hash_pack_reset(&pack);
-      if ((ret = iota_tangle_transaction_load_partial(tangle, iter->hash, &pack, PARTIAL_TX_MODEL_METADATA)) != RC_OK) {
-        return ret;
-      }
+    inclusion_states_params_t params = {
+        .res = res, .lsm_index = api->core->consensus.milestone_tracker.latest_solid_milestone_index};
 
-      if (pack.num_loaded == 0 || transaction_snapshot_index(txp) == 0 || transaction_snapshot_index(txp) > lsm_index) {
-        get_inclusion_states_res_states_add(res, false);
-      } else if (transaction_snapshot_index(txp) <= lsm_index) {
-        get_inclusion_states_res_states_add(res, true);
-      }
-    }
+    return transactions_load_by_chunks(tangle, req->transactions, true, PARTIAL_TX_MODEL_METADATA, inclusion_state_add,
+                                       &params);
   }
-
-  return RC_OK;
 }
 
 retcode_t iota_api_get_missing_transactions(iota_api_t const *const api, get_missing_transactions_res_t *const res,
@@ -468,11 +567,6 @@ retcode_t iota_api_get_transactions_to_approve(iota_api_t const *const api, tang
 
 retcode_t iota_api_get_trytes(iota_api_t const *const api, tangle_t *const tangle, get_trytes_req_t const *const req,
                               get_trytes_res_t *const res, error_res_t **const error) {
-  retcode_t ret = RC_OK;
-  hash243_queue_entry_t *iter = NULL;
-  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
-  DECLARE_PACK_SINGLE_TX(tx, txp, pack);
-
   if (api == NULL || req == NULL || res == NULL || error == NULL) {
     return RC_NULL_PARAM;
   }
@@ -481,22 +575,7 @@ retcode_t iota_api_get_trytes(iota_api_t const *const api, tangle_t *const tangl
     return RC_API_MAX_GET_TRYTES;
   }
 
-  CDL_FOREACH(req->hashes, iter) {
-    hash_pack_reset(&pack);
-    if ((ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH, iter->hash, &pack)) != RC_OK) {
-      return ret;
-    }
-
-    if (pack.num_loaded != 0) {
-      transaction_serialize_on_flex_trits(txp, tx_trits);
-    } else {
-      memset(tx_trits, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_8019);
-    }
-
-    hash8019_queue_push(&res->trytes, tx_trits);
-  }
-
-  return ret;
+  return transactions_load_by_chunks(tangle, req->hashes, false, PARTIAL_TX_MODEL_METADATA, trytes_add, res);
 }
 
 retcode_t iota_api_interrupt_attaching_to_tangle(iota_api_t const *const api, error_res_t **const error) {
@@ -558,6 +637,7 @@ retcode_t iota_api_store_transactions(iota_api_t const *const api, tangle_t *con
     if (exists) {
       continue;
     }
+    transaction_set_arrival_timestamp(&tx, current_timestamp_ms());
     if ((ret = iota_tangle_transaction_store(tangle, &tx)) != RC_OK) {
       return ret;
     }
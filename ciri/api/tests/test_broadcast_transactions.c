@@ -46,7 +46,7 @@ void test_broadcast_transactions(void) {
                                         TX_3_OF_4_VALUE_BUNDLE_TRYTES, TX_4_OF_4_VALUE_BUNDLE_TRYTES};
   flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
   byte_t bytes[GOSSIP_MAX_BYTES_LENGTH];
-  protocol_gossip_queue_entry_t *entry = NULL;
+  protocol_gossip_t *packet = NULL;
 
   memset(bytes, 0, GOSSIP_MAX_BYTES_LENGTH);
 
@@ -65,9 +65,9 @@ void test_broadcast_transactions(void) {
   for (size_t i = 0; i < 4; i++) {
     flex_trits_to_bytes(bytes, NUM_TRITS_SERIALIZED_TRANSACTION, broadcat_transactions_req_trytes_get(req, i),
                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
-    entry = protocol_gossip_queue_pop(&api.core->node.processor.queue);
-    TEST_ASSERT_EQUAL_MEMORY(entry->packet.content, bytes, GOSSIP_MAX_BYTES_LENGTH);
-    free(entry);
+    TEST_ASSERT_EQUAL_INT(stage_queue_pop_batch(&api.core->node.processor.queue, &packet, 1), 1);
+    TEST_ASSERT_EQUAL_MEMORY(packet->content, bytes, GOSSIP_MAX_BYTES_LENGTH);
+    gossip_pool_release(packet);
   }
 
   broadcast_transactions_req_free(&req);
@@ -81,7 +81,10 @@ int main(void) {
 
   config.db_path = tangle_test_db_path;
   api.core = &core;
-  broadcaster_stage_init(&api.core->node.broadcaster, &api.core->node);
+  TEST_ASSERT(iota_node_conf_init(&api.core->node.conf) == RC_OK);
+  TEST_ASSERT(gossip_pool_init(&api.core->node.gossip_pool, api.core->node.conf.pipeline_queue_size) == RC_OK);
+  TEST_ASSERT(broadcaster_stage_init(&api.core->node.broadcaster, &api.core->node) == RC_OK);
+  TEST_ASSERT(processor_stage_init(&api.core->node.processor, &api.core->node) == RC_OK);
   TEST_ASSERT(requester_init(&api.core->node.transaction_requester, &api.core->node) == RC_OK);
   TEST_ASSERT(iota_consensus_conf_init(&api.core->consensus.conf) == RC_OK);
   api.core->consensus.conf.snapshot_timestamp_sec = 1536845195;
@@ -98,6 +101,9 @@ int main(void) {
   RUN_TEST(test_broadcast_transactions_empty);
   RUN_TEST(test_broadcast_transactions);
 
+  TEST_ASSERT(processor_stage_destroy(&api.core->node.processor) == RC_OK);
+  TEST_ASSERT(broadcaster_stage_destroy(&api.core->node.broadcaster) == RC_OK);
+  gossip_pool_destroy(&api.core->node.gossip_pool);
   TEST_ASSERT(storage_destroy() == RC_OK);
   return UNITY_END();
 }
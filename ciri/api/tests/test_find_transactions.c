@@ -369,6 +369,64 @@ void test_find_transactions_intersection(void) {
   error_res_free(&error);
 }
 
+/**
+ * In this test, we store 96 txs each with its own address, which they also approve as branch.
+ * Each tx is labeled by the 1st and 2nd chars of its hash and each address by its 2nd and 3rd chars.
+ * We then request txs by lists of addresses or approvees longer and shorter than the largest IN clause of the
+ * prepared find statements, each list twice so that the second request reuses the statement of the first one.
+ */
+void test_find_transactions_many_addresses(void) {
+  find_transactions_req_t *req = NULL;
+  find_transactions_res_t *res = NULL;
+  error_res_t *error = NULL;
+  hash243_queue_t res_hashes = NULL;
+  size_t const counts[] = {96, 96, 5, 5};
+
+  iota_transaction_t txs[96];
+
+  tryte_t hash_trytes[NUM_TRYTES_HASH];
+  memcpy(hash_trytes, NULL_HASH, NUM_TRYTES_HASH);
+
+  tryte_t address_trytes[NUM_TRYTES_ADDRESS];
+  memcpy(address_trytes, NULL_HASH, NUM_TRYTES_ADDRESS);
+
+  for (size_t i = 0; i < 96; i++) {
+    hash_trytes[0] = 'A' + i % 26;
+    hash_trytes[1] = 'A' + i / 26;
+    address_trytes[1] = 'A' + i % 26;
+    address_trytes[2] = 'A' + i / 26;
+    flex_trits_from_trytes(txs[i].consensus.hash, NUM_TRITS_HASH, hash_trytes, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+    flex_trits_from_trytes(txs[i].essence.address, NUM_TRITS_ADDRESS, address_trytes, NUM_TRYTES_ADDRESS,
+                           NUM_TRYTES_ADDRESS);
+    memcpy(txs[i].attachment.branch, txs[i].essence.address, FLEX_TRIT_SIZE_243);
+    TEST_ASSERT(iota_tangle_transaction_store(&tangle, &txs[i]) == RC_OK);
+  }
+
+  for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+    for (size_t approvees = 0; approvees < 2; approvees++) {
+      req = find_transactions_req_new();
+      res = find_transactions_res_new();
+      res_hashes = NULL;
+
+      for (size_t j = 0; j < counts[i]; j++) {
+        hash243_queue_push(approvees ? &req->approvees : &req->addresses, txs[j].essence.address);
+        hash243_queue_push(&res_hashes, txs[j].consensus.hash);
+      }
+
+      TEST_ASSERT(iota_api_find_transactions(&api, &tangle, req, res, &error) == RC_OK);
+      TEST_ASSERT(error == NULL);
+
+      TEST_ASSERT(hash243_queue_cmp(res->hashes, res_hashes));
+
+      find_transactions_req_free(&req);
+      find_transactions_res_free(&res);
+      hash243_queue_free(&res_hashes);
+    }
+  }
+
+  error_res_free(&error);
+}
+
 void test_find_transactions_no_input(void) {
   find_transactions_req_t *req = find_transactions_req_new();
   find_transactions_res_t *res = find_transactions_res_new();
@@ -427,6 +485,7 @@ int main(void) {
   RUN_TEST(test_find_transactions_tags_only);
   RUN_TEST(test_find_transactions_approvees_only);
   RUN_TEST(test_find_transactions_intersection);
+  RUN_TEST(test_find_transactions_many_addresses);
   RUN_TEST(test_find_transactions_no_input);
 
   api.conf.max_find_transactions = 10;
@@ -41,7 +41,7 @@ void test_get_missing_transactions(void) {
 
   for (size_t i = 0; i < 10; i++) {
     flex_trits_from_trytes(hashes[i], HASH_LENGTH_TRIT, trytes, HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
-    TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[i]) == RC_OK);
+    TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[i], false) == RC_OK);
     trytes[0]++;
   }
 
@@ -64,6 +64,7 @@ int main(void) {
 
   api.core = &core;
   TEST_ASSERT(iota_node_conf_init(&api.core->node.conf) == RC_OK);
+  TEST_ASSERT(gossip_pool_init(&api.core->node.gossip_pool, api.core->node.conf.pipeline_queue_size) == RC_OK);
   TEST_ASSERT(router_init(&api.core->node.router, &api.core->node) == RC_OK);
   api.core->node.conf.requester_queue_size = 100;
   TEST_ASSERT(requester_init(&api.core->node.transaction_requester, &api.core->node) == RC_OK);
@@ -114,9 +115,9 @@ int main(void) {
 
   // Adding requests
 
-  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[0]) == RC_OK);
-  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[1]) == RC_OK);
-  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[2]) == RC_OK);
+  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[0], false) == RC_OK);
+  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[1], false) == RC_OK);
+  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[2], false) == RC_OK);
   // Adding broadcasts
 
   protocol_gossip_t packet;
@@ -129,6 +130,8 @@ int main(void) {
 
   TEST_ASSERT(router_destroy(&api.core->node.router) == RC_OK);
   TEST_ASSERT(requester_destroy(&api.core->node.transaction_requester) == RC_OK);
+  TEST_ASSERT(broadcaster_stage_destroy(&api.core->node.broadcaster) == RC_OK);
+  gossip_pool_destroy(&api.core->node.gossip_pool);
   TEST_ASSERT(tangle_cleanup(&tangle, tangle_test_db_path) == RC_OK);
 
   TEST_ASSERT(storage_destroy() == RC_OK);
@@ -75,7 +75,7 @@ int main(void) {
   api.core->consensus.conf.snapshot_signature_skip_validation = true;
 
   TEST_ASSERT(iota_consensus_init(&api.core->consensus, &tangle, &api.core->node.transaction_requester,
-                                  &api.core->node.tips) == RC_OK);
+                                  &api.core->node.tips, NULL) == RC_OK);
 
   tearDown();
 
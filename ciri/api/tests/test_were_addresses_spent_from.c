@@ -122,7 +122,7 @@ int main(void) {
   // Avoid verifying snapshot signature
   api.core->consensus.conf.snapshot_signature_skip_validation = true;
   TEST_ASSERT(iota_consensus_init(&api.core->consensus, &tangle, &api.core->node.transaction_requester,
-                                  &api.core->node.tips) == RC_OK);
+                                  &api.core->node.tips, NULL) == RC_OK);
 
   state_delta_destroy(&api.core->consensus.snapshots_provider.latest_snapshot.state);
 
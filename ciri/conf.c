@@ -121,6 +121,23 @@ static retcode_t get_sponge_type(char const* const input, sponge_type_t* const o
   return RC_OK;
 }
 
+static retcode_t get_cw_rating_calculator(char const* const input, cw_calculation_implementation_t* const output) {
+  static struct cw_rating_calculator_map {
+    char* str;
+    cw_calculation_implementation_t impl;
+  } map[] = {{"DFS", DFS_FROM_ENTRY_POINT}, {"BITSET", TOPOLOGICAL_BITSET_PROPAGATION}, {NULL, CW_NO_IMPLEMENTATION}};
+  size_t i;
+
+  for (i = 0; map[i].str != NULL && strcmp(map[i].str, input) != 0; i++) {
+  }
+
+  if ((*output = map[i].impl) == CW_NO_IMPLEMENTATION) {
+    return RC_CONF_INVALID_ARGUMENT;
+  }
+
+  return RC_OK;
+}
+
 static retcode_t get_probability(char const* const input, double* const output) {
   *output = atof(input);
   if (*output < 0 || *output > 1) {
@@ -192,14 +209,47 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf, iota_consensu
       strncpy(node_conf->tangle_db_path, value, sizeof(node_conf->tangle_db_path));
       strncpy(api_conf->tangle_db_path, value, sizeof(api_conf->tangle_db_path));
       break;
+    case CONF_TANGLE_DB_READERS:  // --tangle-db-readers
+      ciri_conf->tangle_db_readers = atoi(value);
+      break;
     case CONF_TANGLE_DB_REVALIDATE:  // --tangle-db-revalidate
       ret = get_true_false(value, &ciri_conf->tangle_db_revalidate);
       break;
+    case CONF_TANGLE_CACHE_SIZE:  // --tangle-cache-size
+      ciri_conf->tangle_cache_size = atoi(value);
+      break;
+    case CONF_TANGLE_GRAPH_ENABLED:  // --tangle-graph-enabled
+      ret = get_true_false(value, &ciri_conf->tangle_graph_enabled);
+      break;
+    case CONF_TANGLE_FILTER_SIZE:  // --tangle-filter-size
+      ciri_conf->tangle_filter_size = atoi(value);
+      break;
+    case CONF_TANGLE_FILTER_FALSE_POSITIVE_RATE:  // --tangle-filter-false-positive-rate
+      ret = get_probability(value, &ciri_conf->tangle_filter_false_positive_rate);
+      if (ciri_conf->tangle_filter_false_positive_rate == 0 || ciri_conf->tangle_filter_false_positive_rate == 1) {
+        ret = RC_CONF_INVALID_ARGUMENT;
+      }
+      break;
 
     // Node configuration
     case CONF_AUTO_TETHERING_ENABLED:  // --auto-tethering-enabled
       ret = get_true_false(value, &node_conf->auto_tethering_enabled);
       break;
+    case CONF_HASHER_BATCH_DELAY:  // --hasher-batch-delay
+      node_conf->hasher_batch_delay = atoi(value);
+      break;
+    case CONF_HASHER_BATCH_FILL:  // --hasher-batch-fill
+      node_conf->hasher_batch_fill = atoi(value);
+      if (node_conf->hasher_batch_fill == 0 || node_conf->hasher_batch_fill > 100) {
+        return RC_CONF_INVALID_ARGUMENT;
+      }
+      break;
+    case CONF_HASHER_THREADS:  // --hasher-threads
+      node_conf->hasher_threads = atoi(value);
+      if (node_conf->hasher_threads == 0) {
+        return RC_CONF_INVALID_ARGUMENT;
+      }
+      break;
     case CONF_MAX_NEIGHBORS:  // --max-neighbors
       node_conf->max_neighbors = atoi(value);
       break;
@@ -207,6 +257,9 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf, iota_consensu
       node_conf->mwm = atoi(value);
       consensus_conf->mwm = atoi(value);
       break;
+    case CONF_NEIGHBOR_INGRESS_RATE:  // --neighbor-ingress-rate
+      node_conf->neighbor_ingress_rate = atoi(value);
+      break;
     case CONF_NEIGHBORING_ADDRESS:  // --neighboring-address
       if (strlen(value) == 0) {
         return RC_CONF_INVALID_ARGUMENT;
@@ -228,6 +281,18 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf, iota_consensu
     case CONF_P_SEND_MILESTONE:  // --p-send-milestone
       ret = get_probability(value, &node_conf->p_send_milestone);
       break;
+    case CONF_PIPELINE_QUEUE_SIZE:  // --pipeline-queue-size
+      node_conf->pipeline_queue_size = atoi(value);
+      if (node_conf->pipeline_queue_size == 0) {
+        return RC_CONF_INVALID_ARGUMENT;
+      }
+      break;
+    case CONF_RECENT_SEEN_BYTES_CACHE_SHARDS:  // --recent-seen-bytes-cache-shards
+      node_conf->recent_seen_bytes_cache_shards = atoi(value);
+      if (node_conf->recent_seen_bytes_cache_shards == 0) {
+        return RC_CONF_INVALID_ARGUMENT;
+      }
+      break;
     case CONF_RECENT_SEEN_BYTES_CACHE_SIZE:  // --recent-seen-bytes-cache-size
       node_conf->recent_seen_bytes_cache_size = atoi(value);
       break;
@@ -236,10 +301,40 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf, iota_consensu
       break;
     case CONF_REQUESTER_QUEUE_SIZE:  // --requester-queue-size
       node_conf->requester_queue_size = atoi(value);
+      if (node_conf->requester_queue_size == 0) {
+        return RC_CONF_INVALID_ARGUMENT;
+      }
+      break;
+    case CONF_REQUESTER_RETRY_INTERVAL:  // --requester-retry-interval
+      node_conf->requester_retry_interval = atoi(value);
+      break;
+    case CONF_ROUTER_THREADS:  // --router-threads
+      node_conf->router_threads = atoi(value);
+      if (node_conf->router_threads == 0) {
+        return RC_CONF_INVALID_ARGUMENT;
+      }
+      break;
+    case CONF_STORE_BATCH_DELAY:  // --store-batch-delay
+      node_conf->store_batch_delay = atoi(value);
+      break;
+    case CONF_STORE_BATCH_SIZE:  // --store-batch-size
+      node_conf->store_batch_size = atoi(value);
+      if (node_conf->store_batch_size == 0) {
+        return RC_CONF_INVALID_ARGUMENT;
+      }
       break;
     case CONF_TIPS_CACHE_SIZE:  // --tips-cache-size
       node_conf->tips_cache_size = atoi(value);
       break;
+    case CONF_TRANSACTION_BYTES_CACHE_SIZE:  // --transaction-bytes-cache-size
+      node_conf->transaction_bytes_cache_size = atoi(value);
+      break;
+    case CONF_VALIDATOR_THREADS:  // --validator-threads
+      node_conf->validator_threads = atoi(value);
+      if (node_conf->validator_threads == 0) {
+        return RC_CONF_INVALID_ARGUMENT;
+      }
+      break;
 
     // API configuration
     case 'p':  // --http_port
@@ -308,6 +403,15 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf, iota_consensu
     case CONF_COORDINATOR_SIGNATURE_TYPE:  // --coordinator-signature-type
       ret = get_sponge_type(value, &consensus_conf->coordinator_signature_type);
       break;
+    case CONF_CW_RATING_CALCULATOR:  // --cw-rating-calculator
+      ret = get_cw_rating_calculator(value, &consensus_conf->cw_rating_calculator);
+      break;
+    case CONF_CW_RATING_THREADS:  // --cw-rating-threads
+      consensus_conf->cw_rating_threads = atoi(value);
+      if (consensus_conf->cw_rating_threads == 0) {
+        return RC_CONF_INVALID_ARGUMENT;
+      }
+      break;
     case CONF_LAST_MILESTONE:  // --last-milestone
       consensus_conf->last_milestone = atoi(value);
       break;
@@ -388,7 +492,12 @@ retcode_t iota_ciri_conf_default_init(iota_ciri_conf_t* const ciri_conf, iota_co
           sizeof(consensus_conf->spent_addresses_db_path));
   strncpy(api_conf->spent_addresses_db_path, DEFAULT_SPENT_ADDRESSES_DB_PATH,
           sizeof(api_conf->spent_addresses_db_path));
+  ciri_conf->tangle_db_readers = DEFAULT_TANGLE_DB_READERS;
   ciri_conf->tangle_db_revalidate = DEFAULT_TANGLE_DB_REVALIDATE;
+  ciri_conf->tangle_cache_size = DEFAULT_TANGLE_CACHE_SIZE;
+  ciri_conf->tangle_graph_enabled = DEFAULT_TANGLE_GRAPH_ENABLED;
+  ciri_conf->tangle_filter_size = DEFAULT_TANGLE_FILTER_SIZE;
+  ciri_conf->tangle_filter_false_positive_rate = DEFAULT_TANGLE_FILTER_FALSE_POSITIVE_RATE;
 
   if ((ret = iota_consensus_conf_init(consensus_conf)) != RC_OK) {
     return ret;
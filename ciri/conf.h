@@ -21,7 +21,12 @@
 #define DEFAULT_LOG_LEVEL LOGGER_INFO
 #define DEFAULT_SPENT_ADDRESSES_DB_PATH SPENT_ADDRESSES_DB_PATH
 #define DEFAULT_TANGLE_DB_PATH TANGLE_DB_PATH
+#define DEFAULT_TANGLE_DB_READERS 16
 #define DEFAULT_TANGLE_DB_REVALIDATE false
+#define DEFAULT_TANGLE_CACHE_SIZE 16384
+#define DEFAULT_TANGLE_GRAPH_ENABLED true
+#define DEFAULT_TANGLE_FILTER_SIZE 4194304
+#define DEFAULT_TANGLE_FILTER_FALSE_POSITIVE_RATE 0.001
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,8 +43,18 @@ typedef struct iota_ciri_conf_s {
   char spent_addresses_db_path[FILE_PATH_SIZE];
   // Path of the tangle database file
   char tangle_db_path[FILE_PATH_SIZE];
+  // Maximum number of pooled read-only connections to the tangle database, 0 disables the pool
+  size_t tangle_db_readers;
   // Reloads milestones, state of the ledger and transactions metadata from the tangle database
   bool tangle_db_revalidate;
+  // Number of transactions whose partially loaded fields are cached, 0 disables the cache
+  size_t tangle_cache_size;
+  // Keeps the graph of the tangle and the metadata of its transactions in memory
+  bool tangle_graph_enabled;
+  // Number of transactions the filter answering existence checks can hold, 0 disables the filter
+  size_t tangle_filter_size;
+  // Maximum rate of absent transactions the filter reports as possibly present
+  double tangle_filter_false_positive_rate;
 } iota_ciri_conf_t;
 
 /**
@@ -164,6 +164,8 @@ retcode_t iota_consensus_conf_init(iota_consensus_conf_t *const conf) {
   conf->coordinator_depth = DEFAULT_COORDINATOR_DEPTH;
   conf->coordinator_security_level = DEFAULT_COORDINATOR_SECURITY_LEVEL;
   conf->coordinator_signature_type = DEFAULT_COORDINATOR_SIGNATURE_TYPE;
+  conf->cw_rating_calculator = DEFAULT_TIP_SELECTION_CW_CALC_IMPL;
+  conf->cw_rating_threads = DEFAULT_TIP_SELECTION_CW_CALC_THREADS;
   memset(conf->genesis_hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
   conf->max_depth = DEFAULT_TIP_SELECTION_MAX_DEPTH;
   conf->mwm = DEFAULT_MWN;
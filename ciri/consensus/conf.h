@@ -9,6 +9,7 @@
 #define __CONSENSUS_CONF_H__
 
 #include "ciri/consensus/snapshot/local_snapshots/conf.h"
+#include "ciri/consensus/tip_selection/cw_rating_calculator/conf.h"
 #include "ciri/utils/files.h"
 #include "common/crypto/sponge/sponge.h"
 #include "common/errors.h"
@@ -25,6 +26,7 @@
 #define DEFAULT_TIP_SELECTION_ALPHA 0.001
 #define DEFAULT_TIP_SELECTION_BELOW_MAX_DEPTH 20000
 #define DEFAULT_TIP_SELECTION_CW_CALC_IMPL DFS_FROM_ENTRY_POINT
+#define DEFAULT_TIP_SELECTION_CW_CALC_THREADS 1
 #define DEFAULT_TIP_SELECTION_EP_RAND_IMPL EP_RANDOM_WALK
 #define DEFAULT_SNAPSHOT_CONF_FILE SNAPSHOT_CONF_FILE
 #define DEFAULT_SNAPSHOT_SIG_FILE SNAPSHOT_SIG_FILE
@@ -56,6 +58,10 @@ typedef struct iota_consensus_conf_s {
   uint8_t coordinator_security_level;
   // The signature type used in coordinator signatures
   sponge_type_t coordinator_signature_type;
+  // Implementation calculating cumulative weights of the tip selection
+  cw_calculation_implementation_t cw_rating_calculator;
+  // Number of threads calculating cumulative weights of the tip selection
+  size_t cw_rating_threads;
   // The hash of the genesis transaction
   flex_trit_t genesis_hash[FLEX_TRIT_SIZE_243];
   // The index of the last milestone issued by the corrdinator before the
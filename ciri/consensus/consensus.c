@@ -13,7 +13,8 @@
 static logger_id_t logger_id;
 
 retcode_t iota_consensus_init(iota_consensus_t *const consensus, tangle_t *const tangle,
-                              transaction_requester_t *const transaction_requester, tips_cache_t *const tips) {
+                              transaction_requester_t *const transaction_requester, tips_cache_t *const tips,
+                              transaction_bytes_cache_t *const transaction_bytes_cache) {
   retcode_t ret = RC_OK;
 
   logger_id = logger_helper_enable(CONSENSUS_LOGGER_ID, LOGGER_DEBUG, true);
@@ -25,11 +26,12 @@ retcode_t iota_consensus_init(iota_consensus_t *const consensus, tangle_t *const
   }
 
   log_info(logger_id, "Initializing cumulative weight rating calculator\n");
-  if ((ret = iota_consensus_cw_rating_init(&consensus->cw_rating_calculator, DEFAULT_TIP_SELECTION_CW_CALC_IMPL)) !=
+  if ((ret = iota_consensus_cw_rating_init(&consensus->cw_rating_calculator, consensus->conf.cw_rating_calculator)) !=
       RC_OK) {
     log_critical(logger_id, "Initializing cumulative weight rating calculator failed\n");
     return ret;
   }
+  consensus->cw_rating_calculator.threads = consensus->conf.cw_rating_threads;
 
   log_info(logger_id, "Initializing entry point selector\n");
   if ((ret = iota_consensus_entry_point_selector_init(&consensus->entry_point_selector,
@@ -107,7 +109,8 @@ retcode_t iota_consensus_init(iota_consensus_t *const consensus, tangle_t *const
   log_info(logger_id, "Initializing local snapshots manager\n");
   if ((ret = iota_local_snapshots_manager_init(&consensus->local_snapshots_manager, &consensus->snapshots_service,
                                                &consensus->conf, &consensus->milestone_tracker,
-                                               &consensus->spent_addresses_service, tips)) != RC_OK) {
+                                               &consensus->spent_addresses_service, tips, transaction_bytes_cache)) !=
+      RC_OK) {
     log_critical(logger_id, "Failed initializing local snapshots manager\n");
     return ret;
   }
@@ -53,11 +53,13 @@ extern "C" {
  * @param tangle A tangle
  * @param transaction_requester A transaction requester
  * @param tips A tips cache
+ * @param transaction_bytes_cache The transaction bytes cache of the responder, NULL if none
  *
  * @return a status code
  */
 retcode_t iota_consensus_init(iota_consensus_t* const consensus, tangle_t* const tangle,
-                              transaction_requester_t* const transaction_requester, tips_cache_t* const tips);
+                              transaction_requester_t* const transaction_requester, tips_cache_t* const tips,
+                              transaction_bytes_cache_t* const transaction_bytes_cache);
 
 /**
  * Starts all consensus components
@@ -89,7 +89,7 @@ static void init_test_structs() {
   TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, &snapshots_provider, &lv, &transaction_solidifier) == RC_OK);
   TEST_ASSERT(iota_snapshots_service_init(&snapshots_service, &snapshots_provider, &milestone_service, &conf) == RC_OK);
   TEST_ASSERT(iota_milestone_service_init(&milestone_service, &conf) == RC_OK);
-  TEST_ASSERT(iota_local_snapshots_pruning_service_init(&ps, &snapshots_provider, NULL, &tips, &conf) == RC_OK);
+  TEST_ASSERT(iota_local_snapshots_pruning_service_init(&ps, &snapshots_provider, NULL, &tips, NULL, &conf) == RC_OK);
 }
 
 static void destroy_test_structs() {
@@ -211,8 +211,9 @@ static void* milestone_validator(void* arg) {
           memcpy(mt->latest_milestone, candidate.hash, FLEX_TRIT_SIZE_243);
         }
       } else if (milestone_status == MILESTONE_INCOMPLETE) {
+        // Fetching the bundle of a candidate must not delay the solidification of the next milestone
         if (iota_consensus_transaction_solidifier_check_solidity(mt->transaction_solidifier, &tangle, candidate.hash,
-                                                                 MILESTONE_VALIDATION_TRANSACTIONS_LIMIT,
+                                                                 MILESTONE_VALIDATION_TRANSACTIONS_LIMIT, false,
                                                                  &is_solid) != RC_OK) {
           log_warning(logger_id, "Quick fetching of milestone failed\n");
         }
@@ -250,7 +251,7 @@ retcode_t update_latest_solid_milestone(milestone_tracker_t* const mt, tangle_t*
     is_solid = false;
 
     if ((ret = iota_consensus_transaction_solidifier_check_solidity(mt->transaction_solidifier, tangle, milestone.hash,
-                                                                    MILESTONE_SOLIDIFICATION_TRANSACTIONS_LIMIT,
+                                                                    MILESTONE_SOLIDIFICATION_TRANSACTIONS_LIMIT, true,
                                                                     &is_solid)) != RC_OK) {
       return ret;
     }
@@ -357,6 +358,8 @@ retcode_t iota_milestone_tracker_start(milestone_tracker_t* const mt, tangle_t*
   retcode_t ret = RC_OK;
   DECLARE_PACK_SINGLE_MILESTONE(latest_milestone, latest_milestone_ptr, pack);
   iota_stor_pack_t hash_pack;
+  storage_cursor_t cursor;
+  size_t candidates = 0;
   flex_trit_t* curr_hash;
   hash243_set_t solid_entry_points = NULL;
 
@@ -379,18 +382,24 @@ retcode_t iota_milestone_tracker_start(milestone_tracker_t* const mt, tangle_t*
 
   hash_pack_init(&hash_pack, 512);
 
-  if ((ret = iota_tangle_transaction_load_hashes_of_milestone_candidates(tangle, mt->conf->coordinator_address,
-                                                                         &hash_pack)) != RC_OK) {
-    log_critical(logger_id, "Loading milestone candidates failed\n");
-  }
-  log_info(logger_id, "Loaded %d milestone candidates\n", hash_pack.num_loaded);
-
-  for (size_t i = 0; i < hash_pack.num_loaded; i++) {
-    curr_hash = ((flex_trit_t**)hash_pack.models)[i];
-    if (!hash243_set_contains(solid_entry_points, curr_hash)) {
-      iota_milestone_tracker_add_candidate(mt, curr_hash);
+  // Candidates are streamed by batches of the pack capacity however many of them there are
+  if ((ret = iota_tangle_cursor_open(tangle, &cursor, CURSOR_QUERY_MILESTONE_CANDIDATES, mt->conf->coordinator_address,
+                                     MODEL_HASH)) == RC_OK) {
+    while ((ret = iota_tangle_cursor_next(&cursor, &hash_pack)) == RC_OK && hash_pack.num_loaded > 0) {
+      for (size_t i = 0; i < hash_pack.num_loaded; i++) {
+        curr_hash = ((flex_trit_t**)hash_pack.models)[i];
+        if (!hash243_set_contains(solid_entry_points, curr_hash)) {
+          iota_milestone_tracker_add_candidate(mt, curr_hash);
+        }
+      }
+      candidates += hash_pack.num_loaded;
     }
+    iota_tangle_cursor_close(&cursor);
+  }
+  if (ret != RC_OK) {
+    log_critical(logger_id, "Loading milestone candidates failed\n");
   }
+  log_info(logger_id, "Loaded %zu milestone candidates\n", candidates);
   hash_pack_free(&hash_pack);
   hash243_set_free(&solid_entry_points);
 
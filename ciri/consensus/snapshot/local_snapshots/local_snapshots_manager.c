@@ -118,7 +118,8 @@ retcode_t iota_local_snapshots_manager_init(local_snapshots_manager_t *lsm,
                                             snapshots_service_t *const snapshots_service,
                                             iota_consensus_conf_t *const conf, milestone_tracker_t const *const mt,
                                             spent_addresses_service_t *const spent_addresses_service,
-                                            tips_cache_t *const tips_cache) {
+                                            tips_cache_t *const tips_cache,
+                                            transaction_bytes_cache_t *const transaction_bytes_cache) {
   retcode_t ret = RC_OK;
   if (lsm == NULL || mt == NULL || snapshots_service == NULL) {
     return RC_NULL_PARAM;
@@ -135,7 +136,8 @@ retcode_t iota_local_snapshots_manager_init(local_snapshots_manager_t *lsm,
 
   if (lsm->conf->local_snapshots.pruning_is_enabled) {
     ERR_BIND_RETURN(iota_local_snapshots_pruning_service_init(&lsm->ps, lsm->snapshots_service->snapshots_provider,
-                                                              spent_addresses_service, tips_cache, conf),
+                                                              spent_addresses_service, tips_cache,
+                                                              transaction_bytes_cache, conf),
                     ret);
   }
 
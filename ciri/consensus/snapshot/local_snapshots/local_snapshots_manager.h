@@ -19,6 +19,7 @@
 #include "ciri/consensus/spent_addresses/spent_addresses_service.h"
 #include "ciri/consensus/tangle/tangle.h"
 #include "ciri/node/tips_cache.h"
+#include "ciri/node/transaction_bytes_cache.h"
 #include "utils/handles/cond.h"
 #include "utils/handles/thread.h"
 
@@ -51,7 +52,8 @@ retcode_t iota_local_snapshots_manager_init(local_snapshots_manager_t *lsm,
                                             snapshots_service_t *const snapshots_service,
                                             iota_consensus_conf_t *const conf, milestone_tracker_t const *const mt,
                                             spent_addresses_service_t *const spent_addresses_service,
-                                            tips_cache_t *const tips_cache);
+                                            tips_cache_t *const tips_cache,
+                                            transaction_bytes_cache_t *const transaction_bytes_cache);
 
 /**
  * Starts a local snapshots manager
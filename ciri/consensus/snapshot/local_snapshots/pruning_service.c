@@ -16,6 +16,10 @@
 #include "utils/time.h"
 
 #define PRUNING_SERVICE_LOGGER_ID "pruning_service"
+// Maximum number of transactions deleted per database transaction
+#define PRUNING_SERVICE_BATCH_SIZE 1000
+// Maximum number of database pages given back to the file system after each pruned milestone
+#define PRUNING_SERVICE_COMPACTION_PAGES 1024
 
 static logger_id_t logger_id;
 
@@ -37,6 +41,8 @@ static retcode_t collect_transactions_for_pruning_do_func(flex_trit_t *hash, iot
 
 static uint64_t get_last_snapshot_to_prune_index(pruning_service_t *const ps);
 
+static retcode_t evict_pruned_transactions_bytes(pruning_service_t *const ps, hash243_set_t const pruned);
+
 static void *pruning_service_routine(void *arg);
 
 typedef struct collect_transactions_for_pruning_do_func_params_s {
@@ -97,6 +103,7 @@ static void *pruning_service_routine(void *arg) {
   tangle_t tangle;
   uint64_t start_timestamp, end_timestamp;
   uint64_t start_index;
+  uint64_t start_count;
   spent_addresses_provider_t sap;
   bool should_wait_for_next_snapshot;
   DECLARE_PACK_SINGLE_MILESTONE(milestone, milestone_ptr, milestone_pack);
@@ -132,6 +139,7 @@ static void *pruning_service_routine(void *arg) {
   while (ps->running) {
     cond_handle_wait(&ps->cond_pruning_service, &lock_cond);
     start_index = ps->last_pruned_snapshot_index;
+    start_count = ps->pruned_transactions_count;
     start_timestamp = current_timestamp_ms();
     while ((ps->last_pruned_snapshot_index < get_last_snapshot_to_prune_index(ps)) && ps->running) {
       if (ps->last_pruned_snapshot_index > start_index && (ps->last_pruned_snapshot_index % 10) == 0) {
@@ -146,8 +154,12 @@ static void *pruning_service_routine(void *arg) {
     }
     end_timestamp = current_timestamp_ms();
     if (ps->last_pruned_snapshot_index > start_index) {
-      log_info(logger_id, "Pruning from %" PRIu64 " to %" PRIu64 " took %" PRIu64 " milliseconds\n", start_index,
-               ps->last_pruned_snapshot_index, end_timestamp - start_timestamp);
+      log_info(logger_id,
+               "Pruning from %" PRIu64 " to %" PRIu64 " took %" PRIu64 " milliseconds for %" PRIu64
+               " transactions (%" PRIu64 " tx/s)\n",
+               start_index, ps->last_pruned_snapshot_index, end_timestamp - start_timestamp,
+               ps->pruned_transactions_count - start_count,
+               (ps->pruned_transactions_count - start_count) * 1000 / MAX(end_timestamp - start_timestamp, 1));
     }
   }
 
@@ -224,12 +236,32 @@ cleanup:
   return RC_OK;
 }
 
+static retcode_t evict_pruned_transactions_bytes(pruning_service_t *const ps, hash243_set_t const pruned) {
+  retcode_t ret = RC_OK;
+  hash243_set_entry_t *iter = NULL;
+  hash243_set_entry_t *tmp = NULL;
+
+  if (ps->transaction_bytes_cache == NULL) {
+    return RC_OK;
+  }
+
+  // Evicted once deleted so that a transaction is never loaded and cached again after its eviction
+  HASH_SET_ITER(pruned, iter, tmp) {
+    if ((ret = transaction_bytes_cache_remove(ps->transaction_bytes_cache, iter->hash)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
+}
+
 static retcode_t prune_transactions(pruning_service_t *const ps, tangle_t const *const tangle,
                                     spent_addresses_provider_t *const sap, bool *should_wait_for_next_snapshot) {
   retcode_t err;
   DECLARE_PACK_SINGLE_MILESTONE(milestone, milestone_ptr, milestone_pack);
   hash243_set_t transactions_to_prune = NULL;
   bool has_solid_entry_points;
+  uint64_t count = 0;
 
   *should_wait_for_next_snapshot = false;
 
@@ -242,14 +274,22 @@ static retcode_t prune_transactions(pruning_service_t *const ps, tangle_t const
 
   if (!has_solid_entry_points) {
     hash243_set_remove(&transactions_to_prune, milestone.hash);
-    ERR_BIND_GOTO(iota_tangle_transactions_delete(tangle, transactions_to_prune), err, cleanup);
+    count = hash243_set_size(transactions_to_prune);
+    ERR_BIND_GOTO(iota_tangle_transactions_prune(tangle, transactions_to_prune, PRUNING_SERVICE_BATCH_SIZE), err,
+                  cleanup);
+    ERR_BIND_GOTO(evict_pruned_transactions_bytes(ps, transactions_to_prune), err, cleanup);
     hash243_set_free(&transactions_to_prune);
     // It's important to delete the milestone only after all it's past cone has been deleted to avoid dangle
     // transactions
     hash243_set_add(&transactions_to_prune, milestone.hash);
     ERR_BIND_GOTO(iota_tangle_transactions_delete(tangle, transactions_to_prune), err, cleanup);
+    ERR_BIND_GOTO(evict_pruned_transactions_bytes(ps, transactions_to_prune), err, cleanup);
     ERR_BIND_GOTO(iota_tangle_milestone_delete(tangle, milestone.hash), err, cleanup);
     ps->last_pruned_snapshot_index++;
+    ps->pruned_transactions_count += count + 1;
+    if (iota_tangle_compact(tangle, PRUNING_SERVICE_COMPACTION_PAGES) != RC_OK) {
+      log_warning(logger_id, "Compacting tangle database failed\n");
+    }
   } else {
     *should_wait_for_next_snapshot = true;
   }
@@ -268,6 +308,7 @@ retcode_t iota_local_snapshots_pruning_service_init(pruning_service_t *const ps,
                                                     snapshots_provider_t *const snapshot_provider,
                                                     spent_addresses_service_t *const spent_addresses_service,
                                                     tips_cache_t *const tips_cache,
+                                                    transaction_bytes_cache_t *const transaction_bytes_cache,
                                                     iota_consensus_conf_t const *const conf) {
   logger_id = logger_helper_enable(PRUNING_SERVICE_LOGGER_ID, LOGGER_DEBUG, true);
   memset(ps, 0, sizeof(pruning_service_t));
@@ -276,6 +317,7 @@ retcode_t iota_local_snapshots_pruning_service_init(pruning_service_t *const ps,
   ps->last_snapshot_index_to_prune = ps->last_pruned_snapshot_index;
   ps->spent_addresses_service = spent_addresses_service;
   ps->tips_cache = tips_cache;
+  ps->transaction_bytes_cache = transaction_bytes_cache;
   lock_handle_init(&ps->lock);
   cond_handle_init(&ps->cond_pruning_service);
 
@@ -16,6 +16,7 @@
 #include "ciri/consensus/spent_addresses/spent_addresses_service.h"
 #include "ciri/consensus/tangle/tangle.h"
 #include "ciri/node/tips_cache.h"
+#include "ciri/node/transaction_bytes_cache.h"
 #include "utils/handles/cond.h"
 #include "utils/handles/thread.h"
 
@@ -30,10 +31,14 @@ typedef struct pruning_service_s {
   iota_consensus_conf_t const *conf;
   uint64_t last_pruned_snapshot_index;
   uint64_t last_snapshot_index_to_prune;
+  // Number of transactions pruned since the service was started
+  uint64_t pruned_transactions_count;
   lock_handle_t lock;
   hash243_set_t solid_entry_points;
   spent_addresses_service_t *spent_addresses_service;
   tips_cache_t *tips_cache;
+  // Cache of the responder pruned transactions are evicted from, NULL if none
+  transaction_bytes_cache_t *transaction_bytes_cache;
 } pruning_service_t;
 
 /**
@@ -43,6 +48,7 @@ typedef struct pruning_service_s {
  * @param[in] snapshot_provider The snapshots provider
  * @param[in, out] spent_addresses_service The spent addresses service
  * @param[out] tips_cache The tips cache
+ * @param[out] transaction_bytes_cache The transaction bytes cache of the responder, NULL if none
  * @param[in] conf The consensus's conf
  *
  * @return a status code
@@ -51,6 +57,7 @@ retcode_t iota_local_snapshots_pruning_service_init(pruning_service_t *const ps,
                                                     snapshots_provider_t *const snapshot_provider,
                                                     spent_addresses_service_t *const spent_addresses_service,
                                                     tips_cache_t *const tips_cache,
+                                                    transaction_bytes_cache_t *const transaction_bytes_cache,
                                                     iota_consensus_conf_t const *const conf);
 
 /**
@@ -290,6 +290,7 @@ static retcode_t iota_snapshots_service_add_entry_point_if_not_orphan(
   retcode_t ret;
   check_not_orphan_do_func_params_t params;
   iota_stor_pack_t hashes_pack;
+  storage_cursor_t cursor;
 
   UNUSED(target_milestone_index);
   params.target_milestone_timestamp = target_milestone_timestamp;
@@ -298,20 +299,26 @@ static retcode_t iota_snapshots_service_add_entry_point_if_not_orphan(
 
   ERR_BIND_RETURN(hash_pack_init(&hashes_pack, 8), ret);
 
-  ERR_BIND_GOTO(iota_tangle_transaction_load_hashes_of_approvers(tangle, hash, &hashes_pack, 0), ret, cleanup);
+  ERR_BIND_GOTO(iota_tangle_cursor_open(tangle, &cursor, CURSOR_QUERY_APPROVERS, hash, MODEL_HASH), ret, cleanup);
 
-  while (hashes_pack.num_loaded > 0) {
-    // Add each found approver to the currently traversed tx
-    ERR_BIND_GOTO(
-        tangle_traversal_dfs_to_future(tangle, check_transaction_is_not_orphan_do_func,
-                                       ((flex_trit_t *)hashes_pack.models[--hashes_pack.num_loaded]), NULL, &params),
-        ret, cleanup);
+  // Approvers are streamed by batches so that heavily approved transactions don't need a large pack
+  while (iota_tangle_cursor_next(&cursor, &hashes_pack) == RC_OK && hashes_pack.num_loaded > 0) {
+    while (hashes_pack.num_loaded > 0) {
+      // Add each found approver to the currently traversed tx
+      ERR_BIND_GOTO(
+          tangle_traversal_dfs_to_future(tangle, check_transaction_is_not_orphan_do_func,
+                                         ((flex_trit_t *)hashes_pack.models[--hashes_pack.num_loaded]), NULL, &params),
+          ret, close_cursor);
 
-    if (!params.is_orphan) {
-      ERR_BIND_GOTO(hash_to_uint64_t_map_add(solid_entry_points, hash, min_snapshot_index), ret, cleanup);
+      if (!params.is_orphan) {
+        ERR_BIND_GOTO(hash_to_uint64_t_map_add(solid_entry_points, hash, min_snapshot_index), ret, close_cursor);
+      }
     }
   }
 
+close_cursor:
+  iota_tangle_cursor_close(&cursor);
+
 cleanup:
   hash_pack_free(&hashes_pack);
 
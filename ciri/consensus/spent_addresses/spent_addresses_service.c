@@ -12,6 +12,7 @@
 #include "utils/macros.h"
 
 #define SPENT_ADDRESSES_SERVICE_LOGGER_ID "spent_addresses_service"
+#define SPENT_ADDRESSES_CURSOR_BATCH 8
 
 static logger_id_t logger_id;
 
@@ -118,8 +119,13 @@ retcode_t iota_spent_addresses_service_was_address_spent_from(spent_addresses_se
                                                               tangle_t const *const tangle,
                                                               flex_trit_t const *const address, bool *const spent) {
   retcode_t ret = RC_OK;
-  iota_stor_pack_t pack;
-  DECLARE_PACK_SINGLE_TX(tx, txp, tx_pack);
+  storage_cursor_t cursor;
+  iota_transaction_t txs[SPENT_ADDRESSES_CURSOR_BATCH] = {};
+  iota_transaction_t *txs_ptrs[SPENT_ADDRESSES_CURSOR_BATCH];
+  iota_stor_pack_t pack = {.models = (void **)txs_ptrs,
+                           .capacity = SPENT_ADDRESSES_CURSOR_BATCH,
+                           .num_loaded = 0,
+                           .insufficient_capacity = false};
 
   if (sas == NULL || sap == NULL || tangle == NULL || address == NULL || spent == NULL) {
     return RC_NULL_PARAM;
@@ -140,31 +146,32 @@ retcode_t iota_spent_addresses_service_was_address_spent_from(spent_addresses_se
     return RC_OK;
   }
 
-  hash_pack_init(&pack, 8);
+  for (size_t i = 0; i < SPENT_ADDRESSES_CURSOR_BATCH; i++) {
+    txs_ptrs[i] = &txs[i];
+  }
 
-  if ((ret = iota_tangle_transaction_load_hashes_by_address(tangle, address, &pack)) != RC_OK) {
-    goto done;
+  // Transactions of the address are streamed so that addresses with many of them are checked in constant memory
+  if ((ret = iota_tangle_cursor_open(tangle, &cursor, CURSOR_QUERY_ADDRESS, address,
+                                     MODEL_TRANSACTION_ESSENCE_METADATA)) != RC_OK) {
+    return ret;
   }
 
-  // TODO: If the hash set returned contains more than 100 000 entries, it likely will not be a spent address.
+  // TODO: If the address has more than 100 000 transactions, it likely will not be a spent address.
   // To avoid unnecessary overhead while processing, the loop will return false
-
-  for (size_t i = 0; i < pack.num_loaded; ++i) {
-    if ((ret = iota_tangle_transaction_load_partial(tangle, ((flex_trit_t **)(pack.models))[i], &tx_pack,
-                                                    PARTIAL_TX_MODEL_ESSENCE_METADATA)) != RC_OK) {
-      goto done;
+  while (!*spent && (ret = iota_tangle_cursor_next(&cursor, &pack)) == RC_OK && pack.num_loaded > 0) {
+    for (size_t i = 0; i < pack.num_loaded; ++i) {
+      if ((ret = iota_spent_addresses_service_was_tx_spent_from(tangle, txs_ptrs[i], transaction_hash(txs_ptrs[i]),
+                                                                spent)) != RC_OK ||
+          *spent) {
+        break;
+      }
     }
-    if ((ret = iota_spent_addresses_service_was_tx_spent_from(tangle, txp, ((flex_trit_t **)(pack.models))[i],
-                                                              spent)) != RC_OK) {
-      goto done;
-    }
-    if (*spent) {
-      goto done;
+    if (ret != RC_OK) {
+      break;
     }
   }
 
-done:
-  hash_pack_free(&pack);
+  iota_tangle_cursor_close(&cursor);
 
   return ret;
 }
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xxhash.h"
+
+#include "ciri/consensus/tangle/filter.h"
+
+#define TANGLE_FILTER_FILE_MAGIC 0x49544346494c5452ULL
+// Maximum ratio of used slots, in percents, at which insertions still succeed with high probability
+#define TANGLE_FILTER_LOAD_FACTOR 95
+#define TANGLE_FILTER_FINGERPRINT_BITS_MAX 32
+
+typedef struct tangle_filter_file_header_s {
+  uint64_t magic;
+  uint64_t buckets_num;
+  uint64_t fingerprint_bits;
+  uint64_t size;
+  uint64_t tag;
+} tangle_filter_file_header_t;
+
+/*
+ * Private functions
+ */
+
+static inline size_t next_power_of_two(size_t const value) {
+  size_t power = 1;
+
+  while (power < value) {
+    power <<= 1;
+  }
+
+  return power;
+}
+
+static inline uint8_t *filter_slot(tangle_filter_t const *const filter, size_t const bucket, size_t const slot) {
+  return filter->buckets + (bucket * TANGLE_FILTER_BUCKET_SIZE + slot) * filter->fingerprint_size;
+}
+
+static inline uint32_t slot_get(tangle_filter_t const *const filter, size_t const bucket, size_t const slot) {
+  uint8_t const *data = filter_slot(filter, bucket, slot);
+  uint16_t value16 = 0;
+  uint32_t value32 = 0;
+
+  switch (filter->fingerprint_size) {
+    case 1:
+      return *data;
+    case 2:
+      memcpy(&value16, data, sizeof(uint16_t));
+      return value16;
+    default:
+      memcpy(&value32, data, sizeof(uint32_t));
+      return value32;
+  }
+}
+
+static inline void slot_set(tangle_filter_t *const filter, size_t const bucket, size_t const slot,
+                            uint32_t const fingerprint) {
+  uint8_t *data = filter_slot(filter, bucket, slot);
+  uint16_t value16 = (uint16_t)fingerprint;
+
+  switch (filter->fingerprint_size) {
+    case 1:
+      *data = (uint8_t)fingerprint;
+      break;
+    case 2:
+      memcpy(data, &value16, sizeof(uint16_t));
+      break;
+    default:
+      memcpy(data, &fingerprint, sizeof(uint32_t));
+      break;
+  }
+}
+
+/**
+ * Derives the fingerprint and first bucket of a hash, a null fingerprint marking an empty slot
+ */
+static inline void filter_locate(tangle_filter_t const *const filter, flex_trit_t const *const hash,
+                                 uint32_t *const fingerprint, size_t *const bucket) {
+  uint64_t digest = XXH64(hash, FLEX_TRIT_SIZE_243, 0);
+
+  *fingerprint = (uint32_t)(digest >> 32) & filter->fingerprint_mask;
+  if (*fingerprint == 0) {
+    *fingerprint = 1;
+  }
+  *bucket = (size_t)digest & (filter->buckets_num - 1);
+}
+
+/**
+ * The alternate bucket only depends on the fingerprint and the other bucket so that it can be found when relocating
+ */
+static inline size_t filter_alternate(tangle_filter_t const *const filter, size_t const bucket,
+                                      uint32_t const fingerprint) {
+  return (bucket ^ ((uint64_t)fingerprint * 0x5bd1e995ULL)) & (filter->buckets_num - 1);
+}
+
+static bool bucket_insert(tangle_filter_t *const filter, size_t const bucket, uint32_t const fingerprint) {
+  for (size_t i = 0; i < TANGLE_FILTER_BUCKET_SIZE; i++) {
+    if (slot_get(filter, bucket, i) == 0) {
+      slot_set(filter, bucket, i, fingerprint);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool bucket_contains(tangle_filter_t const *const filter, size_t const bucket, uint32_t const fingerprint) {
+  for (size_t i = 0; i < TANGLE_FILTER_BUCKET_SIZE; i++) {
+    if (slot_get(filter, bucket, i) == fingerprint) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool bucket_remove(tangle_filter_t *const filter, size_t const bucket, uint32_t const fingerprint) {
+  for (size_t i = 0; i < TANGLE_FILTER_BUCKET_SIZE; i++) {
+    if (slot_get(filter, bucket, i) == fingerprint) {
+      slot_set(filter, bucket, i, 0);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static inline size_t filter_kick_slot(tangle_filter_t *const filter) {
+  // xorshift64
+  filter->kick_state ^= filter->kick_state << 13;
+  filter->kick_state ^= filter->kick_state >> 7;
+  filter->kick_state ^= filter->kick_state << 17;
+
+  return filter->kick_state % TANGLE_FILTER_BUCKET_SIZE;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t tangle_filter_init(tangle_filter_t *const filter, size_t const capacity, double const false_positive_rate) {
+  size_t slots_num = 0;
+
+  if (filter == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (false_positive_rate <= 0 || false_positive_rate >= 1) {
+    return RC_INVALID_PARAM;
+  }
+
+  // A lookup compares 2 buckets worth of fingerprints, each matching with a probability of 2^-bits
+  filter->fingerprint_bits = 1;
+  while (filter->fingerprint_bits < TANGLE_FILTER_FINGERPRINT_BITS_MAX &&
+         (double)(1ULL << filter->fingerprint_bits) < 2 * TANGLE_FILTER_BUCKET_SIZE / false_positive_rate) {
+    filter->fingerprint_bits++;
+  }
+  filter->fingerprint_size = filter->fingerprint_bits <= 8 ? 1 : filter->fingerprint_bits <= 16 ? 2 : 4;
+  filter->fingerprint_mask =
+      filter->fingerprint_bits == 32 ? UINT32_MAX : (uint32_t)((1ULL << filter->fingerprint_bits) - 1);
+
+  slots_num = (capacity * 100 + TANGLE_FILTER_LOAD_FACTOR - 1) / TANGLE_FILTER_LOAD_FACTOR;
+  filter->buckets_num = next_power_of_two((slots_num + TANGLE_FILTER_BUCKET_SIZE - 1) / TANGLE_FILTER_BUCKET_SIZE);
+  filter->size = 0;
+  filter->saturated = false;
+  filter->kick_state = 0x9e3779b97f4a7c15ULL;
+  atomic_init(&filter->hit, 0);
+  atomic_init(&filter->miss, 0);
+  atomic_init(&filter->false_positives, 0);
+
+  if ((filter->buckets = (uint8_t *)calloc(filter->buckets_num * TANGLE_FILTER_BUCKET_SIZE,
+                                           filter->fingerprint_size)) == NULL) {
+    return RC_OOM;
+  }
+  rw_lock_handle_init(&filter->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_filter_destroy(tangle_filter_t *const filter) {
+  if (filter == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_destroy(&filter->lock);
+  free(filter->buckets);
+  filter->buckets = NULL;
+  filter->buckets_num = 0;
+  filter->size = 0;
+
+  return RC_OK;
+}
+
+retcode_t tangle_filter_add(tangle_filter_t *const filter, flex_trit_t const *const hash) {
+  uint32_t fingerprint = 0;
+  uint32_t victim = 0;
+  size_t bucket = 0;
+  size_t slot = 0;
+
+  if (filter == NULL || hash == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  filter_locate(filter, hash, &fingerprint, &bucket);
+
+  rw_lock_handle_wrlock(&filter->lock);
+
+  if (filter->saturated) {
+    goto done;
+  }
+
+  if (bucket_insert(filter, bucket, fingerprint) ||
+      bucket_insert(filter, filter_alternate(filter, bucket, fingerprint), fingerprint)) {
+    filter->size++;
+    goto done;
+  }
+
+  // Both buckets are full, fingerprints are relocated to their alternate bucket until one has room
+  for (size_t kicks = 0; kicks < TANGLE_FILTER_MAX_KICKS; kicks++) {
+    slot = filter_kick_slot(filter);
+    victim = slot_get(filter, bucket, slot);
+    slot_set(filter, bucket, slot, fingerprint);
+    fingerprint = victim;
+    bucket = filter_alternate(filter, bucket, fingerprint);
+    if (bucket_insert(filter, bucket, fingerprint)) {
+      filter->size++;
+      goto done;
+    }
+  }
+
+  // The last relocated fingerprint is lost, lookups can't be trusted anymore
+  filter->saturated = true;
+
+done:
+  rw_lock_handle_unlock(&filter->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_filter_remove(tangle_filter_t *const filter, flex_trit_t const *const hash) {
+  uint32_t fingerprint = 0;
+  size_t bucket = 0;
+
+  if (filter == NULL || hash == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  filter_locate(filter, hash, &fingerprint, &bucket);
+
+  rw_lock_handle_wrlock(&filter->lock);
+
+  if (bucket_remove(filter, bucket, fingerprint) ||
+      bucket_remove(filter, filter_alternate(filter, bucket, fingerprint), fingerprint)) {
+    filter->size--;
+  }
+
+  rw_lock_handle_unlock(&filter->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_filter_contains(tangle_filter_t *const filter, flex_trit_t const *const hash, bool *const maybe) {
+  uint32_t fingerprint = 0;
+  size_t bucket = 0;
+
+  if (filter == NULL || hash == NULL || maybe == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  filter_locate(filter, hash, &fingerprint, &bucket);
+
+  rw_lock_handle_rdlock(&filter->lock);
+  *maybe = filter->saturated || bucket_contains(filter, bucket, fingerprint) ||
+           bucket_contains(filter, filter_alternate(filter, bucket, fingerprint), fingerprint);
+  rw_lock_handle_unlock(&filter->lock);
+
+  atomic_fetch_add_explicit(*maybe ? &filter->miss : &filter->hit, 1, memory_order_relaxed);
+
+  return RC_OK;
+}
+
+retcode_t tangle_filter_clear(tangle_filter_t *const filter) {
+  if (filter == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&filter->lock);
+  memset(filter->buckets, 0, filter->buckets_num * TANGLE_FILTER_BUCKET_SIZE * filter->fingerprint_size);
+  filter->size = 0;
+  filter->saturated = false;
+  rw_lock_handle_unlock(&filter->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_filter_save(tangle_filter_t *const filter, char const *const path, uint64_t const tag) {
+  retcode_t ret = RC_OK;
+  FILE *file = NULL;
+  tangle_filter_file_header_t header;
+  size_t buckets_size = 0;
+
+  if (filter == NULL || path == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_rdlock(&filter->lock);
+
+  // A saturated filter is missing fingerprints and has to be rebuilt anyway
+  if (filter->saturated) {
+    goto done;
+  }
+
+  if ((file = fopen(path, "wb")) == NULL) {
+    ret = RC_UTILS_FAILED_TO_OPEN_FILE;
+    goto done;
+  }
+
+  header.magic = TANGLE_FILTER_FILE_MAGIC;
+  header.buckets_num = filter->buckets_num;
+  header.fingerprint_bits = filter->fingerprint_bits;
+  header.size = filter->size;
+  header.tag = tag;
+  buckets_size = filter->buckets_num * TANGLE_FILTER_BUCKET_SIZE * filter->fingerprint_size;
+
+  if (fwrite(&header, sizeof(tangle_filter_file_header_t), 1, file) != 1 ||
+      fwrite(filter->buckets, 1, buckets_size, file) != buckets_size) {
+    ret = RC_UTILS_FAILED_WRITE_FILE;
+  }
+  if (fclose(file) != 0 && ret == RC_OK) {
+    ret = RC_UTILS_FAILED_CLOSE_FILE;
+  }
+  if (ret != RC_OK) {
+    remove(path);
+  }
+
+done:
+  rw_lock_handle_unlock(&filter->lock);
+
+  return ret;
+}
+
+retcode_t tangle_filter_load(tangle_filter_t *const filter, char const *const path, uint64_t const tag,
+                             bool *const loaded) {
+  FILE *file = NULL;
+  tangle_filter_file_header_t header;
+  uint8_t *buckets = NULL;
+  size_t buckets_size = 0;
+
+  if (filter == NULL || path == NULL || loaded == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  *loaded = false;
+
+  if ((file = fopen(path, "rb")) == NULL) {
+    return RC_OK;
+  }
+
+  buckets_size = filter->buckets_num * TANGLE_FILTER_BUCKET_SIZE * filter->fingerprint_size;
+
+  if (fread(&header, sizeof(tangle_filter_file_header_t), 1, file) != 1 || header.magic != TANGLE_FILTER_FILE_MAGIC ||
+      header.buckets_num != filter->buckets_num || header.fingerprint_bits != filter->fingerprint_bits ||
+      header.tag != tag) {
+    goto done;
+  }
+
+  if ((buckets = (uint8_t *)malloc(buckets_size)) == NULL) {
+    fclose(file);
+    return RC_OOM;
+  }
+  if (fread(buckets, 1, buckets_size, file) != buckets_size) {
+    goto done;
+  }
+
+  rw_lock_handle_wrlock(&filter->lock);
+  free(filter->buckets);
+  filter->buckets = buckets;
+  filter->size = header.size;
+  filter->saturated = false;
+  rw_lock_handle_unlock(&filter->lock);
+  buckets = NULL;
+  *loaded = true;
+
+done:
+  free(buckets);
+  fclose(file);
+
+  return RC_OK;
+}
+
+retcode_t tangle_filter_stats(tangle_filter_t *const filter, tangle_filter_stats_t *const stats) {
+  if (filter == NULL || stats == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  stats->hit = atomic_load_explicit(&filter->hit, memory_order_relaxed);
+  stats->miss = atomic_load_explicit(&filter->miss, memory_order_relaxed);
+  stats->false_positives = atomic_load_explicit(&filter->false_positives, memory_order_relaxed);
+
+  rw_lock_handle_rdlock(&filter->lock);
+  stats->size = filter->size;
+  stats->capacity = filter->buckets_num * TANGLE_FILTER_BUCKET_SIZE;
+  stats->fingerprint_bits = filter->fingerprint_bits;
+  stats->saturated = filter->saturated;
+  rw_lock_handle_unlock(&filter->lock);
+
+  return RC_OK;
+}
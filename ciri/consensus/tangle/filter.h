@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_TANGLE_FILTER_H__
+#define __CONSENSUS_TANGLE_FILTER_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/handles/rw_lock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of fingerprints of a bucket
+#define TANGLE_FILTER_BUCKET_SIZE 4
+// Number of fingerprints relocated before an insertion gives up
+#define TANGLE_FILTER_MAX_KICKS 512
+
+typedef struct tangle_filter_stats_s {
+  // Lookups answered by the filter alone, the hash being definitely absent
+  uint64_t hit;
+  // Lookups the filter could not answer, the hash possibly being present
+  uint64_t miss;
+  // Misses for which the hash turned out to be absent
+  uint64_t false_positives;
+  size_t size;
+  size_t capacity;
+  size_t fingerprint_bits;
+  bool saturated;
+} tangle_filter_stats_t;
+
+/**
+ * A cuckoo filter of transaction hashes
+ *
+ * Each hash is represented by a fingerprint stored in one of two buckets, so that lookups read at most two buckets and
+ * fingerprints can be removed, unlike with a Bloom filter. Lookups never miss a hash that was added and not removed but
+ * may report an absent one as present, at the configured false positive rate. Removing a hash that was never added may
+ * remove the fingerprint of another one, so only added hashes must be removed. Once an insertion fails because the
+ * filter is too full, the filter is saturated and reports every hash as possibly present until it is cleared.
+ */
+typedef struct tangle_filter_s {
+  uint8_t *buckets;
+  size_t buckets_num;
+  // Bytes a fingerprint is stored on
+  size_t fingerprint_size;
+  size_t fingerprint_bits;
+  uint32_t fingerprint_mask;
+  size_t size;
+  bool saturated;
+  // State of the generator picking which fingerprint to relocate
+  uint64_t kick_state;
+  atomic_uint_fast64_t hit;
+  atomic_uint_fast64_t miss;
+  atomic_uint_fast64_t false_positives;
+  rw_lock_handle_t lock;
+} tangle_filter_t;
+
+/**
+ * Initializes a filter
+ *
+ * @param filter The filter
+ * @param capacity The number of hashes the filter can hold, the number of buckets being rounded up to a power of two
+ * @param false_positive_rate The maximum rate of absent hashes reported as possibly present, in ]0,1[
+ *
+ * @return a status code
+ */
+retcode_t tangle_filter_init(tangle_filter_t *const filter, size_t const capacity, double const false_positive_rate);
+
+/**
+ * Destroys a filter
+ *
+ * @param filter The filter
+ *
+ * @return a status code
+ */
+retcode_t tangle_filter_destroy(tangle_filter_t *const filter);
+
+/**
+ * Adds a hash, saturating the filter if there is no room left for it
+ *
+ * @param filter The filter
+ * @param hash The hash
+ *
+ * @return a status code
+ */
+retcode_t tangle_filter_add(tangle_filter_t *const filter, flex_trit_t const *const hash);
+
+/**
+ * Removes a hash that was added
+ *
+ * @param filter The filter
+ * @param hash The hash
+ *
+ * @return a status code
+ */
+retcode_t tangle_filter_remove(tangle_filter_t *const filter, flex_trit_t const *const hash);
+
+/**
+ * Looks a hash up
+ *
+ * @param filter The filter
+ * @param hash The hash
+ * @param maybe false if the hash is definitely absent, true if it is possibly present
+ *
+ * @return a status code
+ */
+retcode_t tangle_filter_contains(tangle_filter_t *const filter, flex_trit_t const *const hash, bool *const maybe);
+
+/**
+ * Records that a hash possibly present turned out to be absent
+ *
+ * @param filter The filter
+ */
+static inline void tangle_filter_false_positive(tangle_filter_t *const filter) {
+  atomic_fetch_add_explicit(&filter->false_positives, 1, memory_order_relaxed);
+}
+
+/**
+ * Removes every hash and clears the saturation
+ *
+ * @param filter The filter
+ *
+ * @return a status code
+ */
+retcode_t tangle_filter_clear(tangle_filter_t *const filter);
+
+/**
+ * Saves a filter to a file
+ *
+ * @param filter The filter
+ * @param path The path of the file
+ * @param tag A value saved along the filter, e.g. the number of transactions it was saved with
+ *
+ * @return a status code
+ */
+retcode_t tangle_filter_save(tangle_filter_t *const filter, char const *const path, uint64_t const tag);
+
+/**
+ * Loads a filter from a file saved by a filter with the same capacity and false positive rate
+ *
+ * @param filter The filter
+ * @param path The path of the file
+ * @param tag The value the filter must have been saved with
+ * @param loaded Whether the filter was loaded, the filter is left untouched if the file is missing or doesn't match
+ *
+ * @return a status code
+ */
+retcode_t tangle_filter_load(tangle_filter_t *const filter, char const *const path, uint64_t const tag,
+                             bool *const loaded);
+
+/**
+ * Gets the counters of a filter
+ *
+ * @param filter The filter
+ * @param stats The counters
+ *
+ * @return a status code
+ */
+retcode_t tangle_filter_stats(tangle_filter_t *const filter, tangle_filter_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_TANGLE_FILTER_H__
@@ -0,0 +1,730 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "xxhash.h"
+
+#include "ciri/consensus/tangle/graph.h"
+
+#define TANGLE_GRAPH_INITIAL_CAPACITY 1024
+
+/*
+ * Private functions
+ */
+
+static inline size_t tangle_graph_index_slot(tangle_graph_t const *const graph, flex_trit_t const *const hash) {
+  return XXH64(hash, FLEX_TRIT_SIZE_243, 0) & graph->index_mask;
+}
+
+/**
+ * Finds the index slot of a transaction
+ *
+ * @return the index slot, or the free slot it would be inserted at if *found is false
+ */
+static size_t tangle_graph_index_find(tangle_graph_t const *const graph, flex_trit_t const *const hash,
+                                      bool *const found) {
+  size_t slot = tangle_graph_index_slot(graph, hash);
+
+  // The index is at most half full so there always is a free slot ending the probe sequence
+  while (graph->index[slot] != 0) {
+    if (memcmp(graph->vertices[graph->index[slot] - 1].hash, hash, FLEX_TRIT_SIZE_243) == 0) {
+      *found = true;
+      return slot;
+    }
+    slot = (slot + 1) & graph->index_mask;
+  }
+  *found = false;
+
+  return slot;
+}
+
+/**
+ * Frees an index slot, shifting back following entries of the probe sequence so that lookups never miss them
+ */
+static void tangle_graph_index_remove(tangle_graph_t *const graph, size_t slot) {
+  size_t next = slot;
+  size_t home = 0;
+
+  while (true) {
+    next = (next + 1) & graph->index_mask;
+    if (graph->index[next] == 0) {
+      break;
+    }
+    home = tangle_graph_index_slot(graph, graph->vertices[graph->index[next] - 1].hash);
+    // The entry at next can fill the hole only if its home slot is not cyclically in ]slot, next]
+    if (((next - home) & graph->index_mask) >= ((next - slot) & graph->index_mask)) {
+      graph->index[slot] = graph->index[next];
+      slot = next;
+    }
+  }
+  graph->index[slot] = 0;
+}
+
+static retcode_t tangle_graph_index_grow(tangle_graph_t *const graph) {
+  size_t index_size = 2 * (graph->index_mask + 1);
+  tangle_graph_id_t *index = NULL;
+  tangle_graph_id_t *old_index = graph->index;
+  size_t old_index_mask = graph->index_mask;
+  size_t slot = 0;
+  bool found = false;
+
+  if ((index = (tangle_graph_id_t *)calloc(index_size, sizeof(tangle_graph_id_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  graph->index = index;
+  graph->index_mask = index_size - 1;
+  for (size_t i = 0; i <= old_index_mask; i++) {
+    if (old_index[i] != 0) {
+      slot = tangle_graph_index_find(graph, graph->vertices[old_index[i] - 1].hash, &found);
+      graph->index[slot] = old_index[i];
+    }
+  }
+  free(old_index);
+
+  return RC_OK;
+}
+
+static inline tangle_graph_vertex_t *tangle_graph_vertex_find(tangle_graph_t const *const graph,
+                                                              flex_trit_t const *const hash) {
+  bool found = false;
+  size_t slot = tangle_graph_index_find(graph, hash, &found);
+
+  return found ? &graph->vertices[graph->index[slot] - 1] : NULL;
+}
+
+/**
+ * Finds the vertex of a transaction, creating a placeholder if it is unknown
+ */
+static retcode_t tangle_graph_vertex_get(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                         tangle_graph_id_t *const id) {
+  retcode_t ret = RC_OK;
+  tangle_graph_vertex_t *vertices = NULL;
+  tangle_graph_vertex_t *vertex = NULL;
+  bool found = false;
+  size_t slot = tangle_graph_index_find(graph, hash, &found);
+
+  if (found) {
+    *id = graph->index[slot] - 1;
+    return RC_OK;
+  }
+
+  if (2 * (graph->index_size + 1) > graph->index_mask + 1) {
+    if ((ret = tangle_graph_index_grow(graph)) != RC_OK) {
+      return ret;
+    }
+    slot = tangle_graph_index_find(graph, hash, &found);
+  }
+
+  if (graph->free_vertices != TANGLE_GRAPH_NONE) {
+    *id = graph->free_vertices;
+    graph->free_vertices = graph->vertices[*id].trunk;
+  } else {
+    if (graph->vertices_num == graph->vertices_capacity) {
+      if (graph->vertices_capacity >= TANGLE_GRAPH_NONE / 2) {
+        return RC_OOM;
+      }
+      if ((vertices = (tangle_graph_vertex_t *)realloc(
+               graph->vertices, 2 * graph->vertices_capacity * sizeof(tangle_graph_vertex_t))) == NULL) {
+        return RC_OOM;
+      }
+      graph->vertices = vertices;
+      graph->vertices_capacity *= 2;
+    }
+    *id = graph->vertices_num++;
+  }
+
+  vertex = &graph->vertices[*id];
+  memcpy(vertex->hash, hash, FLEX_TRIT_SIZE_243);
+  // Approvers of a vertex unknown so far have all been seen only if the graph has seen every transaction
+  vertex->flags = graph->complete ? TANGLE_GRAPH_APPROVERS : 0;
+  vertex->validity = 0;
+  vertex->trunk = TANGLE_GRAPH_NONE;
+  vertex->branch = TANGLE_GRAPH_NONE;
+  vertex->approvers = TANGLE_GRAPH_NONE;
+  vertex->approvers_num = 0;
+  vertex->snapshot_index = 0;
+  vertex->arrival_timestamp = 0;
+  graph->index[slot] = *id + 1;
+  graph->index_size++;
+
+  return RC_OK;
+}
+
+/**
+ * Frees a vertex which is neither stored nor approved anymore
+ */
+static void tangle_graph_vertex_release(tangle_graph_t *const graph, tangle_graph_id_t const id) {
+  tangle_graph_vertex_t *vertex = &graph->vertices[id];
+  bool found = false;
+
+  if ((vertex->flags & TANGLE_GRAPH_PRESENT) || vertex->approvers_num != 0) {
+    return;
+  }
+
+  tangle_graph_index_remove(graph, tangle_graph_index_find(graph, vertex->hash, &found));
+  graph->index_size--;
+  vertex->flags = 0;
+  vertex->trunk = graph->free_vertices;
+  graph->free_vertices = id;
+}
+
+/**
+ * Adds an approver to the approvers list of a vertex, unless it already is in it
+ */
+static retcode_t tangle_graph_edge_add(tangle_graph_t *const graph, tangle_graph_id_t const approvee,
+                                       tangle_graph_id_t const approver) {
+  tangle_graph_edge_t *edges = NULL;
+  tangle_graph_vertex_t *vertex = &graph->vertices[approvee];
+  uint32_t edge = 0;
+
+  for (edge = vertex->approvers; edge != TANGLE_GRAPH_NONE; edge = graph->edges[edge].next) {
+    if (graph->edges[edge].approver == approver) {
+      return RC_OK;
+    }
+  }
+
+  if (graph->free_edges != TANGLE_GRAPH_NONE) {
+    edge = graph->free_edges;
+    graph->free_edges = graph->edges[edge].next;
+  } else {
+    if (graph->edges_num == graph->edges_capacity) {
+      if (graph->edges_capacity >= TANGLE_GRAPH_NONE / 2) {
+        return RC_OOM;
+      }
+      if ((edges = (tangle_graph_edge_t *)realloc(graph->edges, 2 * graph->edges_capacity *
+                                                                     sizeof(tangle_graph_edge_t))) == NULL) {
+        return RC_OOM;
+      }
+      graph->edges = edges;
+      graph->edges_capacity *= 2;
+    }
+    edge = graph->edges_num++;
+  }
+
+  graph->edges[edge].approver = approver;
+  graph->edges[edge].next = vertex->approvers;
+  vertex->approvers = edge;
+  vertex->approvers_num++;
+
+  return RC_OK;
+}
+
+static void tangle_graph_edge_remove(tangle_graph_t *const graph, tangle_graph_id_t const approvee,
+                                     tangle_graph_id_t const approver) {
+  tangle_graph_vertex_t *vertex = &graph->vertices[approvee];
+  uint32_t *link = &vertex->approvers;
+  uint32_t edge = 0;
+
+  while (*link != TANGLE_GRAPH_NONE) {
+    edge = *link;
+    if (graph->edges[edge].approver == approver) {
+      *link = graph->edges[edge].next;
+      graph->edges[edge].next = graph->free_edges;
+      graph->free_edges = edge;
+      vertex->approvers_num--;
+      return;
+    }
+    link = &graph->edges[edge].next;
+  }
+}
+
+/**
+ * Records that a vertex approves another one, keeping trunk and branch as the set of its known approvees
+ */
+static retcode_t tangle_graph_approvee_add(tangle_graph_t *const graph, tangle_graph_id_t const id,
+                                           tangle_graph_id_t const approvee) {
+  tangle_graph_vertex_t *vertex = &graph->vertices[id];
+
+  if (vertex->trunk != approvee && vertex->branch != approvee) {
+    if (vertex->flags & TANGLE_GRAPH_EDGES) {
+      return RC_OK;
+    }
+    if (vertex->trunk == TANGLE_GRAPH_NONE) {
+      vertex->trunk = approvee;
+    } else {
+      vertex->branch = approvee;
+    }
+  }
+
+  return tangle_graph_edge_add(graph, approvee, id);
+}
+
+/**
+ * Sets trunk and branch of a vertex, linking it to the approvers lists of both
+ */
+static retcode_t tangle_graph_edges_set(tangle_graph_t *const graph, tangle_graph_id_t const id,
+                                        flex_trit_t const *const trunk_hash, flex_trit_t const *const branch_hash) {
+  retcode_t ret = RC_OK;
+  tangle_graph_id_t trunk = TANGLE_GRAPH_NONE;
+  tangle_graph_id_t branch = TANGLE_GRAPH_NONE;
+
+  // Vertices may move when a placeholder is created so they are only accessed by id
+  if ((ret = tangle_graph_vertex_get(graph, trunk_hash, &trunk)) != RC_OK ||
+      (ret = tangle_graph_vertex_get(graph, branch_hash, &branch)) != RC_OK) {
+    return ret;
+  }
+
+  // Approvees known so far are a subset of trunk and branch so no edge has to be removed
+  if ((ret = tangle_graph_edge_add(graph, trunk, id)) != RC_OK ||
+      (ret = tangle_graph_edge_add(graph, branch, id)) != RC_OK) {
+    return ret;
+  }
+  graph->vertices[id].trunk = trunk;
+  graph->vertices[id].branch = branch;
+  graph->vertices[id].flags |= TANGLE_GRAPH_EDGES;
+
+  return RC_OK;
+}
+
+static inline void tangle_graph_vertex_present(tangle_graph_t *const graph, tangle_graph_vertex_t *const vertex) {
+  if (!(vertex->flags & TANGLE_GRAPH_PRESENT)) {
+    vertex->flags |= TANGLE_GRAPH_PRESENT;
+    graph->size++;
+  }
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t tangle_graph_init(tangle_graph_t *const graph, bool const complete) {
+  if (graph == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(graph, 0, sizeof(tangle_graph_t));
+  graph->free_vertices = TANGLE_GRAPH_NONE;
+  graph->free_edges = TANGLE_GRAPH_NONE;
+  graph->complete = complete;
+
+  if ((graph->vertices = (tangle_graph_vertex_t *)malloc(TANGLE_GRAPH_INITIAL_CAPACITY *
+                                                         sizeof(tangle_graph_vertex_t))) == NULL) {
+    goto oom;
+  }
+  graph->vertices_capacity = TANGLE_GRAPH_INITIAL_CAPACITY;
+  if ((graph->edges = (tangle_graph_edge_t *)malloc(2 * TANGLE_GRAPH_INITIAL_CAPACITY * sizeof(tangle_graph_edge_t))) ==
+      NULL) {
+    goto oom;
+  }
+  graph->edges_capacity = 2 * TANGLE_GRAPH_INITIAL_CAPACITY;
+  if ((graph->index = (tangle_graph_id_t *)calloc(2 * TANGLE_GRAPH_INITIAL_CAPACITY, sizeof(tangle_graph_id_t))) ==
+      NULL) {
+    goto oom;
+  }
+  graph->index_mask = 2 * TANGLE_GRAPH_INITIAL_CAPACITY - 1;
+  rw_lock_handle_init(&graph->lock);
+
+  return RC_OK;
+
+oom:
+  free(graph->vertices);
+  free(graph->edges);
+  memset(graph, 0, sizeof(tangle_graph_t));
+  return RC_OOM;
+}
+
+retcode_t tangle_graph_destroy(tangle_graph_t *const graph) {
+  if (graph == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  free(graph->vertices);
+  free(graph->edges);
+  free(graph->index);
+  rw_lock_handle_destroy(&graph->lock);
+  memset(graph, 0, sizeof(tangle_graph_t));
+
+  return RC_OK;
+}
+
+size_t tangle_graph_size(tangle_graph_t *const graph) {
+  size_t size = 0;
+
+  if (graph == NULL) {
+    return 0;
+  }
+
+  rw_lock_handle_rdlock(&graph->lock);
+  size = graph->size;
+  rw_lock_handle_unlock(&graph->lock);
+
+  return size;
+}
+
+uint64_t tangle_graph_epoch(tangle_graph_t *const graph) {
+  uint64_t epoch = 0;
+
+  if (graph == NULL) {
+    return 0;
+  }
+
+  rw_lock_handle_rdlock(&graph->lock);
+  epoch = graph->epoch;
+  rw_lock_handle_unlock(&graph->lock);
+
+  return epoch;
+}
+
+retcode_t tangle_graph_transaction_add(tangle_graph_t *const graph, iota_transaction_t const *const transaction,
+                                       uint64_t const epoch) {
+  retcode_t ret = RC_OK;
+  tangle_graph_vertex_t *vertex = NULL;
+  tangle_graph_id_t id = TANGLE_GRAPH_NONE;
+
+  if (graph == NULL || transaction == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&graph->lock);
+
+  if ((ret = tangle_graph_vertex_get(graph, transaction_hash(transaction), &id)) != RC_OK) {
+    goto done;
+  }
+  if (!(graph->vertices[id].flags & TANGLE_GRAPH_EDGES) &&
+      (ret = tangle_graph_edges_set(graph, id, transaction_trunk(transaction), transaction_branch(transaction))) !=
+          RC_OK) {
+    goto done;
+  }
+
+  vertex = &graph->vertices[id];
+  tangle_graph_vertex_present(graph, vertex);
+  // A stored transaction has default metadata, unless it was updated in the meantime
+  if (!(vertex->flags & TANGLE_GRAPH_METADATA) && epoch == graph->epoch) {
+    vertex->flags = (vertex->flags & ~TANGLE_GRAPH_SOLID) | TANGLE_GRAPH_METADATA;
+    vertex->snapshot_index = 0;
+    vertex->validity = 0;
+  }
+  // The arrival timestamp never changes once stored, it is only unknown if the store stamped the transaction itself
+  if (transaction->metadata.arrival_timestamp != 0) {
+    vertex->flags |= TANGLE_GRAPH_ARRIVAL;
+    vertex->arrival_timestamp = transaction->metadata.arrival_timestamp;
+  }
+
+done:
+  rw_lock_handle_unlock(&graph->lock);
+
+  return ret;
+}
+
+retcode_t tangle_graph_transaction_remove(tangle_graph_t *const graph, flex_trit_t const *const hash) {
+  tangle_graph_vertex_t *vertex = NULL;
+  tangle_graph_id_t id = TANGLE_GRAPH_NONE;
+  tangle_graph_id_t trunk = TANGLE_GRAPH_NONE;
+  tangle_graph_id_t branch = TANGLE_GRAPH_NONE;
+
+  if (graph == NULL || hash == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&graph->lock);
+
+  graph->epoch++;
+  if ((vertex = tangle_graph_vertex_find(graph, hash)) == NULL) {
+    goto done;
+  }
+
+  id = vertex - graph->vertices;
+  trunk = vertex->trunk;
+  branch = vertex->branch;
+  if (vertex->flags & TANGLE_GRAPH_PRESENT) {
+    graph->size--;
+  }
+  // Approvers still stored keep referencing the vertex, which stays as a placeholder
+  vertex->flags &= TANGLE_GRAPH_APPROVERS;
+  vertex->trunk = TANGLE_GRAPH_NONE;
+  vertex->branch = TANGLE_GRAPH_NONE;
+
+  if (trunk != TANGLE_GRAPH_NONE) {
+    tangle_graph_edge_remove(graph, trunk, id);
+  }
+  if (branch != TANGLE_GRAPH_NONE && branch != trunk) {
+    tangle_graph_edge_remove(graph, branch, id);
+  }
+  tangle_graph_vertex_release(graph, id);
+  if (trunk != TANGLE_GRAPH_NONE && trunk != id) {
+    tangle_graph_vertex_release(graph, trunk);
+  }
+  if (branch != TANGLE_GRAPH_NONE && branch != trunk && branch != id) {
+    tangle_graph_vertex_release(graph, branch);
+  }
+
+done:
+  rw_lock_handle_unlock(&graph->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_graph_transaction_fill(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                        iota_transaction_t const *const transaction, uint64_t const epoch) {
+  retcode_t ret = RC_OK;
+  tangle_graph_vertex_t *vertex = NULL;
+  tangle_graph_id_t id = TANGLE_GRAPH_NONE;
+  field_mask_t const *mask = NULL;
+
+  if (graph == NULL || hash == NULL || transaction == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  mask = &transaction->loaded_columns_mask;
+
+  rw_lock_handle_wrlock(&graph->lock);
+
+  if (epoch != graph->epoch) {
+    goto done;
+  }
+
+  if ((ret = tangle_graph_vertex_get(graph, hash, &id)) != RC_OK) {
+    goto done;
+  }
+  if (!(graph->vertices[id].flags & TANGLE_GRAPH_EDGES) &&
+      (mask->attachment & (MASK_ATTACHMENT_TRUNK | MASK_ATTACHMENT_BRANCH)) ==
+          (MASK_ATTACHMENT_TRUNK | MASK_ATTACHMENT_BRANCH) &&
+      (ret = tangle_graph_edges_set(graph, id, transaction_trunk(transaction), transaction_branch(transaction))) !=
+          RC_OK) {
+    goto done;
+  }
+
+  vertex = &graph->vertices[id];
+  tangle_graph_vertex_present(graph, vertex);
+  if ((mask->metadata & MASK_METADATA_ALL) == MASK_METADATA_ALL) {
+    if (!(vertex->flags & TANGLE_GRAPH_METADATA)) {
+      vertex->flags |= TANGLE_GRAPH_METADATA;
+      vertex->flags = transaction_solid(transaction) ? vertex->flags | TANGLE_GRAPH_SOLID
+                                                     : vertex->flags & ~TANGLE_GRAPH_SOLID;
+      vertex->snapshot_index = transaction_snapshot_index(transaction);
+      vertex->validity = transaction_validity(transaction);
+    }
+    vertex->flags |= TANGLE_GRAPH_ARRIVAL;
+    vertex->arrival_timestamp = transaction_arrival_timestamp(transaction);
+  }
+
+done:
+  rw_lock_handle_unlock(&graph->lock);
+
+  return ret;
+}
+
+retcode_t tangle_graph_transaction_exist(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                         bool *const exist, bool *const found) {
+  tangle_graph_vertex_t const *vertex = NULL;
+
+  if (graph == NULL || hash == NULL || exist == NULL || found == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_rdlock(&graph->lock);
+  vertex = tangle_graph_vertex_find(graph, hash);
+  *exist = vertex != NULL && (vertex->flags & TANGLE_GRAPH_PRESENT);
+  *found = *exist || graph->complete;
+  rw_lock_handle_unlock(&graph->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_graph_metadata_get(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                    iota_transaction_t *const transaction, bool *const found) {
+  tangle_graph_vertex_t const *vertex = NULL;
+
+  if (graph == NULL || hash == NULL || transaction == NULL || found == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_rdlock(&graph->lock);
+  vertex = tangle_graph_vertex_find(graph, hash);
+  *found = vertex != NULL && (vertex->flags & (TANGLE_GRAPH_METADATA | TANGLE_GRAPH_ARRIVAL)) ==
+                                 (TANGLE_GRAPH_METADATA | TANGLE_GRAPH_ARRIVAL);
+  if (*found) {
+    transaction_set_snapshot_index(transaction, vertex->snapshot_index);
+    transaction_set_solid(transaction, (vertex->flags & TANGLE_GRAPH_SOLID) != 0);
+    transaction_set_validity(transaction, vertex->validity);
+    transaction_set_arrival_timestamp(transaction, vertex->arrival_timestamp);
+  }
+  rw_lock_handle_unlock(&graph->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_graph_snapshot_index_set(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                          uint64_t const snapshot_index) {
+  tangle_graph_vertex_t *vertex = NULL;
+
+  if (graph == NULL || hash == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&graph->lock);
+  graph->epoch++;
+  if ((vertex = tangle_graph_vertex_find(graph, hash)) != NULL && (vertex->flags & TANGLE_GRAPH_METADATA)) {
+    vertex->snapshot_index = snapshot_index;
+  }
+  rw_lock_handle_unlock(&graph->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_graph_solid_set(tangle_graph_t *const graph, flex_trit_t const *const hash, bool const solid) {
+  tangle_graph_vertex_t *vertex = NULL;
+
+  if (graph == NULL || hash == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&graph->lock);
+  graph->epoch++;
+  if ((vertex = tangle_graph_vertex_find(graph, hash)) != NULL && (vertex->flags & TANGLE_GRAPH_METADATA)) {
+    vertex->flags = solid ? vertex->flags | TANGLE_GRAPH_SOLID : vertex->flags & ~TANGLE_GRAPH_SOLID;
+  }
+  rw_lock_handle_unlock(&graph->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_graph_validity_set(tangle_graph_t *const graph, flex_trit_t const *const hash, uint8_t const validity) {
+  tangle_graph_vertex_t *vertex = NULL;
+
+  if (graph == NULL || hash == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&graph->lock);
+  graph->epoch++;
+  if ((vertex = tangle_graph_vertex_find(graph, hash)) != NULL && (vertex->flags & TANGLE_GRAPH_METADATA)) {
+    vertex->validity = validity;
+  }
+  rw_lock_handle_unlock(&graph->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_graph_metadata_clear(tangle_graph_t *const graph) {
+  tangle_graph_vertex_t *vertex = NULL;
+
+  if (graph == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&graph->lock);
+  graph->epoch++;
+  for (size_t i = 0; i <= graph->index_mask; i++) {
+    if (graph->index[i] != 0) {
+      vertex = &graph->vertices[graph->index[i] - 1];
+      vertex->flags &= ~TANGLE_GRAPH_SOLID;
+      vertex->snapshot_index = 0;
+      vertex->validity = 0;
+    }
+  }
+  rw_lock_handle_unlock(&graph->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_graph_approvers_get(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                     iota_stor_pack_t *const pack, uint64_t const before_timestamp, bool *const found) {
+  tangle_graph_vertex_t const *vertex = NULL;
+  tangle_graph_vertex_t const *approver = NULL;
+
+  if (graph == NULL || hash == NULL || pack == NULL || found == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_rdlock(&graph->lock);
+
+  vertex = tangle_graph_vertex_find(graph, hash);
+  if (!(*found = vertex != NULL && (vertex->flags & TANGLE_GRAPH_APPROVERS))) {
+    goto done;
+  }
+
+  // Approvers whose arrival timestamp is unknown can't be filtered
+  if (before_timestamp != 0) {
+    for (uint32_t edge = vertex->approvers; edge != TANGLE_GRAPH_NONE; edge = graph->edges[edge].next) {
+      if (!(graph->vertices[graph->edges[edge].approver].flags & TANGLE_GRAPH_ARRIVAL)) {
+        *found = false;
+        goto done;
+      }
+    }
+  }
+
+  pack->insufficient_capacity = false;
+  for (uint32_t edge = vertex->approvers; edge != TANGLE_GRAPH_NONE; edge = graph->edges[edge].next) {
+    approver = &graph->vertices[graph->edges[edge].approver];
+    if (before_timestamp != 0 && approver->arrival_timestamp >= before_timestamp) {
+      continue;
+    }
+    if (pack->num_loaded == pack->capacity) {
+      pack->insufficient_capacity = true;
+      break;
+    }
+    memcpy(pack->models[pack->num_loaded++], approver->hash, FLEX_TRIT_SIZE_243);
+  }
+
+done:
+  rw_lock_handle_unlock(&graph->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_graph_approvers_count(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                       uint64_t *const count, bool *const found) {
+  tangle_graph_vertex_t const *vertex = NULL;
+
+  if (graph == NULL || hash == NULL || count == NULL || found == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_rdlock(&graph->lock);
+  vertex = tangle_graph_vertex_find(graph, hash);
+  if ((*found = vertex != NULL && (vertex->flags & TANGLE_GRAPH_APPROVERS))) {
+    *count = vertex->approvers_num;
+  }
+  rw_lock_handle_unlock(&graph->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_graph_approvers_fill(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                      iota_stor_pack_t const *const pack, uint64_t const epoch) {
+  retcode_t ret = RC_OK;
+  tangle_graph_id_t id = TANGLE_GRAPH_NONE;
+  tangle_graph_id_t approver = TANGLE_GRAPH_NONE;
+
+  if (graph == NULL || hash == NULL || pack == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&graph->lock);
+
+  if (epoch != graph->epoch) {
+    goto done;
+  }
+
+  if ((ret = tangle_graph_vertex_get(graph, hash, &id)) != RC_OK) {
+    goto done;
+  }
+  if (graph->vertices[id].flags & TANGLE_GRAPH_APPROVERS) {
+    goto done;
+  }
+
+  // Approvers added concurrently by stores are already linked and are not added twice
+  for (size_t i = 0; i < pack->num_loaded; i++) {
+    if ((ret = tangle_graph_vertex_get(graph, (flex_trit_t *)pack->models[i], &approver)) != RC_OK) {
+      goto done;
+    }
+    tangle_graph_vertex_present(graph, &graph->vertices[approver]);
+    if ((ret = tangle_graph_approvee_add(graph, approver, id)) != RC_OK) {
+      goto done;
+    }
+  }
+  graph->vertices[id].flags |= TANGLE_GRAPH_APPROVERS;
+
+done:
+  rw_lock_handle_unlock(&graph->lock);
+
+  return ret;
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_TANGLE_GRAPH_H__
+#define __CONSENSUS_TANGLE_GRAPH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ciri/storage/pack.h"
+#include "common/errors.h"
+#include "common/model/transaction.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/handles/rw_lock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t tangle_graph_id_t;
+
+#define TANGLE_GRAPH_NONE UINT32_MAX
+
+typedef enum tangle_graph_flag_e {
+  // The transaction is stored in the tangle database
+  TANGLE_GRAPH_PRESENT = (1u << 0),
+  // Trunk and branch are known, otherwise they hold the approvees known so far
+  TANGLE_GRAPH_EDGES = (1u << 1),
+  // Every approver stored in the tangle database is in the approvers list
+  TANGLE_GRAPH_APPROVERS = (1u << 2),
+  // Snapshot index, solidity and validity are known
+  TANGLE_GRAPH_METADATA = (1u << 3),
+  // Arrival timestamp is known
+  TANGLE_GRAPH_ARRIVAL = (1u << 4),
+  TANGLE_GRAPH_SOLID = (1u << 5),
+} tangle_graph_flag_t;
+
+typedef struct tangle_graph_vertex_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  uint8_t flags;
+  uint8_t validity;
+  tangle_graph_id_t trunk;
+  tangle_graph_id_t branch;
+  // First edge of the approvers list
+  uint32_t approvers;
+  uint32_t approvers_num;
+  uint64_t snapshot_index;
+  uint64_t arrival_timestamp;
+} tangle_graph_vertex_t;
+
+typedef struct tangle_graph_edge_s {
+  tangle_graph_id_t approver;
+  uint32_t next;
+} tangle_graph_edge_t;
+
+/**
+ * A resident index of the tangle graph
+ *
+ * Maps transaction hashes to dense 32 bits ids and keeps, for each id, its trunk and branch ids, its approvers and its
+ * hot metadata so that traversals do not need a database query per transaction. Vertices and edges live in flat
+ * arrays: an open-addressing index maps hashes to vertex ids and approvers lists are chained through an edge array,
+ * freed ids and edges being recycled.
+ *
+ * The index is written through by the tangle on every store, update and delete, and filled from what the tangle loads
+ * from the database, each flag telling which part of a vertex can be trusted. When the index is complete, it has seen
+ * every transaction of the database so approvers lists and presence are always known.
+ */
+typedef struct tangle_graph_s {
+  tangle_graph_vertex_t *vertices;
+  size_t vertices_num;
+  size_t vertices_capacity;
+  tangle_graph_id_t free_vertices;
+  tangle_graph_edge_t *edges;
+  size_t edges_num;
+  size_t edges_capacity;
+  uint32_t free_edges;
+  // Ids + 1 of the vertices, 0 for free slots
+  tangle_graph_id_t *index;
+  size_t index_mask;
+  // Number of vertices, placeholders for approvees not stored included
+  size_t index_size;
+  // Number of vertices of stored transactions
+  size_t size;
+  bool complete;
+  // Incremented by every update so that fills from older database reads can be discarded
+  uint64_t epoch;
+  rw_lock_handle_t lock;
+} tangle_graph_t;
+
+/**
+ * Initializes a tangle graph
+ *
+ * @param graph The graph
+ * @param complete Whether the graph starts from an empty database and sees every transaction stored
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_init(tangle_graph_t *const graph, bool const complete);
+
+/**
+ * Destroys a tangle graph
+ *
+ * @param graph The graph
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_destroy(tangle_graph_t *const graph);
+
+/**
+ * Gets the number of transactions known to be stored
+ *
+ * @param graph The graph
+ *
+ * @return the number of transactions
+ */
+size_t tangle_graph_size(tangle_graph_t *const graph);
+
+/**
+ * Gets the current epoch of a graph, to be read before loading from the database what is filled afterwards
+ *
+ * @param graph The graph
+ *
+ * @return the epoch
+ */
+uint64_t tangle_graph_epoch(tangle_graph_t *const graph);
+
+/**
+ * Adds a newly stored transaction to a graph
+ *
+ * @param graph The graph
+ * @param transaction The transaction, its hash, trunk and branch must be loaded, its arrival timestamp is kept if set
+ * @param epoch The epoch read before storing the transaction, its default metadata are only trusted if the graph was
+ * not updated since
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_transaction_add(tangle_graph_t *const graph, iota_transaction_t const *const transaction,
+                                       uint64_t const epoch);
+
+/**
+ * Removes a deleted transaction from a graph
+ *
+ * @param graph The graph
+ * @param hash The transaction hash
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_transaction_remove(tangle_graph_t *const graph, flex_trit_t const *const hash);
+
+/**
+ * Fills a graph with the trunk, branch and metadata of a transaction loaded from the database
+ * Nothing is filled if the graph was updated since the epoch
+ *
+ * @param graph The graph
+ * @param hash The transaction hash
+ * @param transaction The loaded transaction, only its loaded columns are used
+ * @param epoch The epoch read before loading the transaction
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_transaction_fill(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                        iota_transaction_t const *const transaction, uint64_t const epoch);
+
+/**
+ * Tells whether a transaction is stored
+ *
+ * @param graph The graph
+ * @param hash The transaction hash
+ * @param exist Whether the transaction is stored
+ * @param found Whether the graph knows it, exist is meaningless otherwise
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_transaction_exist(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                         bool *const exist, bool *const found);
+
+/**
+ * Gets the metadata of a transaction
+ *
+ * @param graph The graph
+ * @param hash The transaction hash
+ * @param transaction Filled with the snapshot index, solidity, validity and arrival timestamp if found
+ * @param found Whether the graph knows the metadata
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_metadata_get(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                    iota_transaction_t *const transaction, bool *const found);
+
+retcode_t tangle_graph_snapshot_index_set(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                          uint64_t const snapshot_index);
+
+retcode_t tangle_graph_solid_set(tangle_graph_t *const graph, flex_trit_t const *const hash, bool const solid);
+
+retcode_t tangle_graph_validity_set(tangle_graph_t *const graph, flex_trit_t const *const hash, uint8_t const validity);
+
+/**
+ * Resets the snapshot index, solidity and validity of all transactions
+ *
+ * @param graph The graph
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_metadata_clear(tangle_graph_t *const graph);
+
+/**
+ * Gets the hashes of the approvers of a transaction
+ * As with the database, hashes are appended to the pack and insufficient_capacity is set if they don't all fit
+ *
+ * @param graph The graph
+ * @param hash The transaction hash
+ * @param pack A hash pack
+ * @param before_timestamp Only approvers which arrived before this timestamp are loaded, 0 for all
+ * @param found Whether the graph knows all the approvers
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_approvers_get(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                     iota_stor_pack_t *const pack, uint64_t const before_timestamp, bool *const found);
+
+/**
+ * Counts the approvers of a transaction
+ *
+ * @param graph The graph
+ * @param hash The transaction hash
+ * @param count The number of approvers
+ * @param found Whether the graph knows all the approvers
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_approvers_count(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                       uint64_t *const count, bool *const found);
+
+/**
+ * Fills a graph with all the approvers of a transaction loaded from the database
+ * Nothing is filled if the graph was updated since the epoch
+ *
+ * @param graph The graph
+ * @param hash The transaction hash
+ * @param pack The hashes of all the approvers
+ * @param epoch The epoch read before loading the approvers
+ *
+ * @return a status code
+ */
+retcode_t tangle_graph_approvers_fill(tangle_graph_t *const graph, flex_trit_t const *const hash,
+                                      iota_stor_pack_t const *const pack, uint64_t const epoch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_TANGLE_GRAPH_H__
@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "xxhash.h"
+
+#include "ciri/consensus/tangle/partial_cache.h"
+
+typedef enum partial_cache_group_e {
+  GROUP_ESSENCE = (1u << 0),
+  GROUP_ATTACHMENT = (1u << 1),
+  GROUP_METADATA = (1u << 2),
+} partial_cache_group_t;
+
+static uint8_t const model_groups[TANGLE_PARTIAL_CACHE_MODELS_NUM] = {
+    [TANGLE_PARTIAL_CACHE_METADATA] = GROUP_METADATA,
+    [TANGLE_PARTIAL_CACHE_ESSENCE_METADATA] = GROUP_ESSENCE | GROUP_METADATA,
+    [TANGLE_PARTIAL_CACHE_ESSENCE_ATTACHMENT_METADATA] = GROUP_ESSENCE | GROUP_ATTACHMENT | GROUP_METADATA,
+    [TANGLE_PARTIAL_CACHE_ESSENCE_CONSENSUS] = GROUP_ESSENCE,
+};
+
+/*
+ * Private functions
+ */
+
+static inline size_t next_power_of_two(size_t const value) {
+  size_t power = 1;
+
+  while (power < value) {
+    power <<= 1;
+  }
+
+  return power;
+}
+
+static inline tangle_partial_cache_shard_t *cache_shard(tangle_partial_cache_t const *const cache,
+                                                       uint64_t const digest) {
+  return &cache->shards[(digest >> 32) & (cache->shards_num - 1)];
+}
+
+static inline tangle_partial_cache_entry_t *shard_entry(tangle_partial_cache_shard_t const *const shard,
+                                                       uint64_t const digest, size_t const probe) {
+  return &shard->entries[(digest + probe) & shard->mask];
+}
+
+/**
+ * Looks a hash up in its probe window, entries being removed by invalidations the whole window is scanned
+ */
+static tangle_partial_cache_entry_t *shard_find(tangle_partial_cache_shard_t const *const shard, uint64_t const digest,
+                                                flex_trit_t const *const hash) {
+  tangle_partial_cache_entry_t *entry = NULL;
+
+  for (size_t i = 0; i < TANGLE_PARTIAL_CACHE_PROBE_LENGTH; i++) {
+    entry = shard_entry(shard, digest, i);
+    if (entry->used && memcmp(entry->hash, hash, FLEX_TRIT_SIZE_243) == 0) {
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * Picks the entry to store a new hash in: the first unused entry of its window or, if the window is full, the first
+ * entry that has not been referenced since the CLOCK hand last passed over it
+ */
+static tangle_partial_cache_entry_t *shard_victim(tangle_partial_cache_shard_t *const shard, uint64_t const digest) {
+  tangle_partial_cache_entry_t *entry = NULL;
+
+  for (size_t i = 0; i < TANGLE_PARTIAL_CACHE_PROBE_LENGTH; i++) {
+    entry = shard_entry(shard, digest, i);
+    if (!entry->used) {
+      return entry;
+    }
+  }
+
+  // Every entry gets its reference bit cleared during the first lap so two laps bound the search
+  for (size_t i = 0; i < 2 * TANGLE_PARTIAL_CACHE_PROBE_LENGTH; i++) {
+    entry = shard_entry(shard, digest, shard->clock_hand++ % TANGLE_PARTIAL_CACHE_PROBE_LENGTH);
+    if (!entry->referenced) {
+      break;
+    }
+    entry->referenced = false;
+  }
+
+  return entry;
+}
+
+static uint8_t transaction_groups(iota_transaction_t const *const transaction) {
+  uint8_t groups = 0;
+
+  if (transaction->loaded_columns_mask.essence == MASK_ESSENCE_ALL) {
+    groups |= GROUP_ESSENCE;
+  }
+  if (transaction->loaded_columns_mask.attachment == MASK_ATTACHMENT_ALL) {
+    groups |= GROUP_ATTACHMENT;
+  }
+  if (transaction->loaded_columns_mask.metadata == MASK_METADATA_ALL) {
+    groups |= GROUP_METADATA;
+  }
+
+  return groups;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t tangle_partial_cache_init(tangle_partial_cache_t *const cache, size_t const capacity,
+                                    size_t const shards_num) {
+  tangle_partial_cache_shard_t *shard = NULL;
+  size_t entries_num = 0;
+
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  cache->shards_num = next_power_of_two(shards_num == 0 ? 1 : shards_num);
+  entries_num = next_power_of_two((capacity + cache->shards_num - 1) / cache->shards_num);
+  if (entries_num < TANGLE_PARTIAL_CACHE_PROBE_LENGTH) {
+    entries_num = TANGLE_PARTIAL_CACHE_PROBE_LENGTH;
+  }
+  cache->capacity = entries_num * cache->shards_num;
+  atomic_init(&cache->epoch, 0);
+
+  if ((cache->shards = (tangle_partial_cache_shard_t *)calloc(cache->shards_num,
+                                                              sizeof(tangle_partial_cache_shard_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    shard = &cache->shards[i];
+    if ((shard->entries = (tangle_partial_cache_entry_t *)calloc(entries_num, sizeof(tangle_partial_cache_entry_t))) ==
+        NULL) {
+      cache->shards_num = i;
+      tangle_partial_cache_destroy(cache);
+      return RC_OOM;
+    }
+    shard->mask = entries_num - 1;
+    lock_handle_init(&shard->lock);
+  }
+
+  return RC_OK;
+}
+
+retcode_t tangle_partial_cache_destroy(tangle_partial_cache_t *const cache) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    lock_handle_destroy(&cache->shards[i].lock);
+    free(cache->shards[i].entries);
+  }
+  free(cache->shards);
+  cache->shards = NULL;
+  cache->shards_num = 0;
+  cache->capacity = 0;
+
+  return RC_OK;
+}
+
+retcode_t tangle_partial_cache_get(tangle_partial_cache_t *const cache, flex_trit_t const *const hash,
+                                   tangle_partial_cache_model_t const model, iota_transaction_t *const transaction,
+                                   bool *const found) {
+  uint64_t digest = 0;
+  tangle_partial_cache_shard_t *shard = NULL;
+  tangle_partial_cache_entry_t *entry = NULL;
+  uint8_t groups = 0;
+
+  if (cache == NULL || hash == NULL || transaction == NULL || found == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (model >= TANGLE_PARTIAL_CACHE_MODELS_NUM) {
+    return RC_INVALID_PARAM;
+  }
+
+  digest = XXH64(hash, FLEX_TRIT_SIZE_243, 0);
+  shard = cache_shard(cache, digest);
+  groups = model_groups[model];
+  *found = false;
+
+  lock_handle_lock(&shard->lock);
+
+  if ((entry = shard_find(shard, digest, hash)) == NULL || (entry->groups & groups) != groups) {
+    shard->miss[model]++;
+    goto done;
+  }
+
+  transaction_reset(transaction);
+  if (groups & GROUP_ESSENCE) {
+    transaction->essence = entry->essence;
+    transaction->loaded_columns_mask.essence = MASK_ESSENCE_ALL;
+  }
+  if (groups & GROUP_ATTACHMENT) {
+    transaction->attachment = entry->attachment;
+    transaction->loaded_columns_mask.attachment = MASK_ATTACHMENT_ALL;
+  }
+  if (groups & GROUP_METADATA) {
+    transaction->metadata = entry->metadata;
+    transaction->loaded_columns_mask.metadata = MASK_METADATA_ALL;
+  }
+  if (model == TANGLE_PARTIAL_CACHE_ESSENCE_CONSENSUS) {
+    memcpy(transaction->consensus.hash, hash, FLEX_TRIT_SIZE_243);
+    transaction->loaded_columns_mask.consensus = MASK_CONSENSUS_ALL;
+  }
+  entry->referenced = true;
+  shard->hit[model]++;
+  *found = true;
+
+done:
+  lock_handle_unlock(&shard->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_partial_cache_put(tangle_partial_cache_t *const cache, flex_trit_t const *const hash,
+                                   iota_transaction_t const *const transaction, uint64_t const epoch) {
+  uint64_t digest = 0;
+  tangle_partial_cache_shard_t *shard = NULL;
+  tangle_partial_cache_entry_t *entry = NULL;
+  uint8_t groups = 0;
+
+  if (cache == NULL || hash == NULL || transaction == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((groups = transaction_groups(transaction)) == 0) {
+    return RC_OK;
+  }
+
+  digest = XXH64(hash, FLEX_TRIT_SIZE_243, 0);
+  shard = cache_shard(cache, digest);
+
+  lock_handle_lock(&shard->lock);
+
+  // Invalidations increment the epoch while holding the lock of the shard of their hash
+  if (epoch != atomic_load_explicit(&cache->epoch, memory_order_acquire)) {
+    goto done;
+  }
+
+  if ((entry = shard_find(shard, digest, hash)) == NULL) {
+    entry = shard_victim(shard, digest);
+    if (entry->used) {
+      shard->evictions++;
+    } else {
+      shard->size++;
+    }
+    memcpy(entry->hash, hash, FLEX_TRIT_SIZE_243);
+    entry->groups = 0;
+    entry->used = true;
+    entry->referenced = false;
+  }
+
+  if (groups & GROUP_ESSENCE) {
+    entry->essence = transaction->essence;
+  }
+  if (groups & GROUP_ATTACHMENT) {
+    entry->attachment = transaction->attachment;
+  }
+  if (groups & GROUP_METADATA) {
+    entry->metadata = transaction->metadata;
+  }
+  entry->groups |= groups;
+
+done:
+  lock_handle_unlock(&shard->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_partial_cache_invalidate(tangle_partial_cache_t *const cache, flex_trit_t const *const hash) {
+  uint64_t digest = 0;
+  tangle_partial_cache_shard_t *shard = NULL;
+  tangle_partial_cache_entry_t *entry = NULL;
+
+  if (cache == NULL || hash == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  digest = XXH64(hash, FLEX_TRIT_SIZE_243, 0);
+  shard = cache_shard(cache, digest);
+
+  lock_handle_lock(&shard->lock);
+
+  if ((entry = shard_find(shard, digest, hash)) != NULL) {
+    entry->used = false;
+    shard->size--;
+    shard->invalidations++;
+  }
+  atomic_fetch_add_explicit(&cache->epoch, 1, memory_order_release);
+
+  lock_handle_unlock(&shard->lock);
+
+  return RC_OK;
+}
+
+retcode_t tangle_partial_cache_clear(tangle_partial_cache_t *const cache) {
+  tangle_partial_cache_shard_t *shard = NULL;
+
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    shard = &cache->shards[i];
+    lock_handle_lock(&shard->lock);
+    for (size_t j = 0; j <= shard->mask; j++) {
+      shard->entries[j].used = false;
+    }
+    shard->invalidations += shard->size;
+    shard->size = 0;
+    atomic_fetch_add_explicit(&cache->epoch, 1, memory_order_release);
+    lock_handle_unlock(&shard->lock);
+  }
+
+  return RC_OK;
+}
+
+retcode_t tangle_partial_cache_stats(tangle_partial_cache_t *const cache, tangle_partial_cache_stats_t *const stats) {
+  tangle_partial_cache_shard_t *shard = NULL;
+
+  if (cache == NULL || stats == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(stats, 0, sizeof(tangle_partial_cache_stats_t));
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    shard = &cache->shards[i];
+    lock_handle_lock(&shard->lock);
+    for (size_t j = 0; j < TANGLE_PARTIAL_CACHE_MODELS_NUM; j++) {
+      stats->hit[j] += shard->hit[j];
+      stats->miss[j] += shard->miss[j];
+    }
+    stats->evictions += shard->evictions;
+    stats->invalidations += shard->invalidations;
+    stats->size += shard->size;
+    lock_handle_unlock(&shard->lock);
+  }
+
+  return RC_OK;
+}
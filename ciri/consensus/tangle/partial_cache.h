@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_TANGLE_PARTIAL_CACHE_H__
+#define __CONSENSUS_TANGLE_PARTIAL_CACHE_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "common/model/transaction.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/handles/lock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of consecutive slots an entry can be stored in, starting from the slot its hash maps to
+#define TANGLE_PARTIAL_CACHE_PROBE_LENGTH 8
+
+typedef enum tangle_partial_cache_model_e {
+  TANGLE_PARTIAL_CACHE_METADATA,
+  TANGLE_PARTIAL_CACHE_ESSENCE_METADATA,
+  TANGLE_PARTIAL_CACHE_ESSENCE_ATTACHMENT_METADATA,
+  TANGLE_PARTIAL_CACHE_ESSENCE_CONSENSUS,
+  TANGLE_PARTIAL_CACHE_MODELS_NUM
+} tangle_partial_cache_model_t;
+
+typedef struct tangle_partial_cache_stats_s {
+  // Lookups per partial model that found every field of the model
+  uint64_t hit[TANGLE_PARTIAL_CACHE_MODELS_NUM];
+  uint64_t miss[TANGLE_PARTIAL_CACHE_MODELS_NUM];
+  // Entries evicted to make room for new ones
+  uint64_t evictions;
+  // Entries removed because their transaction was updated or deleted
+  uint64_t invalidations;
+  size_t size;
+} tangle_partial_cache_stats_t;
+
+typedef struct tangle_partial_cache_entry_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  iota_transaction_fields_essence_t essence;
+  iota_transaction_fields_attachment_t attachment;
+  iota_transaction_fields_metadata_t metadata;
+  // Which of essence, attachment and metadata are held
+  uint8_t groups;
+  bool used;
+  bool referenced;
+} tangle_partial_cache_entry_t;
+
+typedef struct tangle_partial_cache_shard_s {
+  tangle_partial_cache_entry_t *entries;
+  size_t mask;
+  // CLOCK hand within a probe window
+  size_t clock_hand;
+  size_t size;
+  uint64_t hit[TANGLE_PARTIAL_CACHE_MODELS_NUM];
+  uint64_t miss[TANGLE_PARTIAL_CACHE_MODELS_NUM];
+  uint64_t evictions;
+  uint64_t invalidations;
+  lock_handle_t lock;
+} tangle_partial_cache_shard_t;
+
+/**
+ * A bounded cache of the fields of transactions that partial models load
+ *
+ * Entries are spread over shards, each with its own lock, by the hash of their transaction and stored in a bounded
+ * probe window of the shard table. When the window is full, an entry is evicted with the CLOCK (second chance)
+ * policy. Entries are invalidated by the tangle whenever their transaction is updated in the database and, as with the
+ * graph, puts of fields loaded before an invalidation are discarded thanks to an epoch.
+ */
+typedef struct tangle_partial_cache_s {
+  tangle_partial_cache_shard_t *shards;
+  size_t shards_num;
+  size_t capacity;
+  // Incremented by every invalidation so that puts from older database reads can be discarded
+  atomic_uint_fast64_t epoch;
+} tangle_partial_cache_t;
+
+/**
+ * Initializes a partial cache
+ *
+ * @param cache The cache
+ * @param capacity The minimum number of entries, rounded up to a power of two per shard
+ * @param shards_num The number of shards, rounded up to a power of two
+ *
+ * @return a status code
+ */
+retcode_t tangle_partial_cache_init(tangle_partial_cache_t *const cache, size_t const capacity,
+                                    size_t const shards_num);
+
+/**
+ * Destroys a partial cache
+ *
+ * @param cache The cache
+ *
+ * @return a status code
+ */
+retcode_t tangle_partial_cache_destroy(tangle_partial_cache_t *const cache);
+
+/**
+ * Gets the current epoch of a partial cache, to be read before loading from the database what is put afterwards
+ *
+ * @param cache The cache
+ *
+ * @return the epoch
+ */
+static inline uint64_t tangle_partial_cache_epoch(tangle_partial_cache_t *const cache) {
+  return atomic_load_explicit(&cache->epoch, memory_order_acquire);
+}
+
+/**
+ * Looks up the fields of a partial model of a transaction
+ *
+ * @param cache The cache
+ * @param hash The transaction hash
+ * @param model The partial model
+ * @param transaction Reset and filled with the fields of the model, and the hash, if found
+ * @param found Whether every field of the model was found
+ *
+ * @return a status code
+ */
+retcode_t tangle_partial_cache_get(tangle_partial_cache_t *const cache, flex_trit_t const *const hash,
+                                   tangle_partial_cache_model_t const model, iota_transaction_t *const transaction,
+                                   bool *const found);
+
+/**
+ * Adds the fully loaded essence, attachment and metadata of a transaction, possibly evicting another entry
+ * Nothing is added if the cache was invalidated since the epoch
+ *
+ * @param cache The cache
+ * @param hash The transaction hash
+ * @param transaction The transaction
+ * @param epoch The epoch read before loading the transaction
+ *
+ * @return a status code
+ */
+retcode_t tangle_partial_cache_put(tangle_partial_cache_t *const cache, flex_trit_t const *const hash,
+                                   iota_transaction_t const *const transaction, uint64_t const epoch);
+
+/**
+ * Removes the entry of a transaction that was updated or deleted in the database
+ *
+ * @param cache The cache
+ * @param hash The transaction hash
+ *
+ * @return a status code
+ */
+retcode_t tangle_partial_cache_invalidate(tangle_partial_cache_t *const cache, flex_trit_t const *const hash);
+
+/**
+ * Removes every entry
+ *
+ * @param cache The cache
+ *
+ * @return a status code
+ */
+retcode_t tangle_partial_cache_clear(tangle_partial_cache_t *const cache);
+
+/**
+ * Gets the counters of a partial cache, summed over all shards
+ *
+ * @param cache The cache
+ * @param stats The counters
+ *
+ * @return a status code
+ */
+retcode_t tangle_partial_cache_stats(tangle_partial_cache_t *const cache, tangle_partial_cache_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_TANGLE_PARTIAL_CACHE_H__
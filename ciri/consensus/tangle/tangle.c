@@ -6,24 +6,426 @@
  */
 
 #include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xxhash.h"
 
 #include "ciri/consensus/tangle/tangle.h"
 #include "utils/logger_helper.h"
 
 #define TANGLE_LOGGER_ID "tangle"
+#define TANGLE_CACHE_SHARDS 16
+// Number of hashes read at once when the filter is rebuilt
+#define TANGLE_FILTER_REBUILD_BATCH 1024
 
 static logger_id_t logger_id;
+static tangle_graph_t graph;
+static bool graph_enabled = false;
+static char *graph_db_path = NULL;
+static storage_pool_t pool;
+static bool pool_enabled = false;
+static tangle_partial_cache_t cache;
+static bool cache_enabled = false;
+static char *cache_db_path = NULL;
+static tangle_filter_t filter;
+static bool filter_enabled = false;
+static char *filter_path = NULL;
+static char *filter_db_path = NULL;
+
+/**
+ * Tells whether a tangle is connected to the database a shared index was enabled for
+ */
+static bool tangle_same_database(tangle_t const *const tangle, char const *const db_path) {
+  return tangle->db_path != NULL && db_path != NULL && strcmp(tangle->db_path, db_path) == 0;
+}
+
+static storage_connection_t const *tangle_writer_acquire(tangle_t const *const tangle) {
+  if (tangle->pool == NULL) {
+    return &tangle->connection;
+  }
+  return storage_pool_writer_acquire(tangle->pool);
+}
+
+static void tangle_writer_release(tangle_t const *const tangle) {
+  if (tangle->pool != NULL) {
+    storage_pool_writer_release(tangle->pool);
+  }
+}
+
+static retcode_t tangle_cache_invalidate(tangle_t const *const tangle, flex_trit_t const *const hash) {
+  if (tangle->cache == NULL) {
+    return RC_OK;
+  }
+  return tangle_partial_cache_invalidate(tangle->cache, hash);
+}
+
+static retcode_t tangle_cache_invalidate_set(tangle_t const *const tangle, hash243_set_t const hashes) {
+  retcode_t ret = RC_OK;
+  hash243_set_entry_t *iter = NULL;
+  hash243_set_entry_t *tmp = NULL;
+
+  if (tangle->cache == NULL) {
+    return RC_OK;
+  }
+
+  HASH_SET_ITER(hashes, iter, tmp) {
+    if ((ret = tangle_partial_cache_invalidate(tangle->cache, iter->hash)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
+}
+
+static tangle_partial_cache_model_t tangle_cache_model(partial_transaction_model_e const models_mask) {
+  switch (models_mask) {
+    case PARTIAL_TX_MODEL_METADATA:
+      return TANGLE_PARTIAL_CACHE_METADATA;
+    case PARTIAL_TX_MODEL_ESSENCE_METADATA:
+      return TANGLE_PARTIAL_CACHE_ESSENCE_METADATA;
+    case PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA:
+      return TANGLE_PARTIAL_CACHE_ESSENCE_ATTACHMENT_METADATA;
+    case PARTIAL_TX_MODEL_ESSENCE_CONSENSUS:
+      return TANGLE_PARTIAL_CACHE_ESSENCE_CONSENSUS;
+    default:
+      return TANGLE_PARTIAL_CACHE_MODELS_NUM;
+  }
+}
 
 retcode_t iota_tangle_init(tangle_t *const tangle, storage_connection_config_t const *const conf) {
+  retcode_t ret = RC_OK;
+
   logger_id = logger_helper_enable(TANGLE_LOGGER_ID, LOGGER_DEBUG, true);
+  tangle->db_path = conf->db_path;
+  tangle->graph = graph_enabled && tangle_same_database(tangle, graph_db_path) ? &graph : NULL;
+  tangle->pool = NULL;
+  tangle->cache = cache_enabled && tangle_same_database(tangle, cache_db_path) ? &cache : NULL;
+  tangle->filter = filter_enabled && tangle_same_database(tangle, filter_db_path) ? &filter : NULL;
+
+  if (pool_enabled && conf->db_path != NULL && strcmp(conf->db_path, pool.db_path) == 0) {
+    if ((ret = storage_pool_reader_acquire(&pool, &tangle->connection)) == RC_OK) {
+      tangle->pool = &pool;
+      return RC_OK;
+    } else if (ret != RC_STORAGE_POOL_EXHAUSTED) {
+      return ret;
+    }
+    log_debug(logger_id, "Connection pool exhausted, opening a private connection\n");
+  }
+
   return storage_connection_init(&tangle->connection, conf, STORAGE_CONNECTION_TANGLE);
 }
 
 retcode_t iota_tangle_destroy(tangle_t *const tangle) {
   logger_helper_release(logger_id);
+  if (tangle->pool != NULL) {
+    return storage_pool_reader_release(tangle->pool, &tangle->connection);
+  }
   return storage_connection_destroy(&tangle->connection);
 }
 
+retcode_t iota_tangle_pool_enable(storage_connection_config_t const *const conf, size_t const readers_max) {
+  retcode_t ret = RC_OK;
+
+  if (pool_enabled) {
+    return RC_OK;
+  }
+
+  if ((ret = storage_pool_init(&pool, conf, STORAGE_CONNECTION_TANGLE, readers_max)) != RC_OK) {
+    return ret;
+  }
+  pool_enabled = true;
+
+  return RC_OK;
+}
+
+retcode_t iota_tangle_pool_disable() {
+  if (!pool_enabled) {
+    return RC_OK;
+  }
+
+  pool_enabled = false;
+
+  return storage_pool_destroy(&pool);
+}
+
+bool iota_tangle_pool_stats(storage_pool_stats_t *const stats) {
+  if (!pool_enabled) {
+    return false;
+  }
+
+  storage_pool_stats(&pool, stats);
+
+  return true;
+}
+
+retcode_t iota_tangle_graph_enable(tangle_t *const tangle) {
+  retcode_t ret = RC_OK;
+  uint64_t count = 0;
+
+  if (graph_enabled) {
+    if (!tangle_same_database(tangle, graph_db_path)) {
+      return RC_TANGLE_OTHER_DATABASE;
+    }
+    tangle->graph = &graph;
+    return RC_OK;
+  }
+
+  if (tangle->db_path == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if ((ret = iota_tangle_transaction_count(tangle, &count)) != RC_OK) {
+    return ret;
+  }
+  if ((graph_db_path = strdup(tangle->db_path)) == NULL) {
+    return RC_OOM;
+  }
+  if ((ret = tangle_graph_init(&graph, count == 0)) != RC_OK) {
+    free(graph_db_path);
+    graph_db_path = NULL;
+    return ret;
+  }
+  graph_enabled = true;
+  tangle->graph = &graph;
+
+  return RC_OK;
+}
+
+retcode_t iota_tangle_graph_disable(tangle_t *const tangle) {
+  if (!graph_enabled) {
+    return RC_OK;
+  }
+  if (!tangle_same_database(tangle, graph_db_path)) {
+    return RC_TANGLE_OTHER_DATABASE;
+  }
+
+  tangle->graph = NULL;
+  graph_enabled = false;
+  free(graph_db_path);
+  graph_db_path = NULL;
+
+  return tangle_graph_destroy(&graph);
+}
+
+retcode_t iota_tangle_cache_enable(tangle_t *const tangle, size_t const capacity) {
+  retcode_t ret = RC_OK;
+
+  if (!cache_enabled) {
+    if (tangle->db_path == NULL) {
+      return RC_NULL_PARAM;
+    }
+    if ((cache_db_path = strdup(tangle->db_path)) == NULL) {
+      return RC_OOM;
+    }
+    if ((ret = tangle_partial_cache_init(&cache, capacity, TANGLE_CACHE_SHARDS)) != RC_OK) {
+      free(cache_db_path);
+      cache_db_path = NULL;
+      return ret;
+    }
+    cache_enabled = true;
+  } else if (!tangle_same_database(tangle, cache_db_path)) {
+    return RC_TANGLE_OTHER_DATABASE;
+  }
+  tangle->cache = &cache;
+
+  return RC_OK;
+}
+
+retcode_t iota_tangle_cache_disable(tangle_t *const tangle) {
+  if (!cache_enabled) {
+    return RC_OK;
+  }
+  if (!tangle_same_database(tangle, cache_db_path)) {
+    return RC_TANGLE_OTHER_DATABASE;
+  }
+
+  tangle->cache = NULL;
+  cache_enabled = false;
+  free(cache_db_path);
+  cache_db_path = NULL;
+
+  return tangle_partial_cache_destroy(&cache);
+}
+
+bool iota_tangle_cache_stats(tangle_partial_cache_stats_t *const stats) {
+  if (!cache_enabled) {
+    return false;
+  }
+
+  tangle_partial_cache_stats(&cache, stats);
+
+  return true;
+}
+
+static retcode_t tangle_filter_rebuild(tangle_t const *const tangle) {
+  retcode_t ret = RC_OK;
+  storage_cursor_t cursor;
+  iota_stor_pack_t pack;
+
+  if ((ret = hash_pack_init(&pack, TANGLE_FILTER_REBUILD_BATCH)) != RC_OK) {
+    return ret;
+  }
+  if ((ret = iota_tangle_cursor_open(tangle, &cursor, CURSOR_QUERY_TRANSACTIONS, NULL, MODEL_HASH)) != RC_OK) {
+    goto done;
+  }
+
+  while ((ret = iota_tangle_cursor_next(&cursor, &pack)) == RC_OK && pack.num_loaded > 0) {
+    for (size_t i = 0; i < pack.num_loaded; i++) {
+      if ((ret = tangle_filter_add(&filter, (flex_trit_t *)pack.models[i])) != RC_OK) {
+        goto close_cursor;
+      }
+    }
+  }
+
+close_cursor:
+  iota_tangle_cursor_close(&cursor);
+done:
+  hash_pack_free(&pack);
+
+  return ret;
+}
+
+/**
+ * Derives the key a filter is saved with from the number of transactions and the first hashes the database streams,
+ * so that a filter isn't loaded back for another database or one written to with as many stores as deletes
+ */
+static retcode_t tangle_filter_key(tangle_t const *const tangle, uint64_t const count, uint64_t *const key) {
+  retcode_t ret = RC_OK;
+  storage_cursor_t cursor;
+  iota_stor_pack_t pack;
+
+  *key = count;
+  if ((ret = hash_pack_init(&pack, TANGLE_FILTER_REBUILD_BATCH)) != RC_OK) {
+    return ret;
+  }
+  if ((ret = iota_tangle_cursor_open(tangle, &cursor, CURSOR_QUERY_TRANSACTIONS, NULL, MODEL_HASH)) != RC_OK) {
+    goto done;
+  }
+  if ((ret = iota_tangle_cursor_next(&cursor, &pack)) == RC_OK) {
+    for (size_t i = 0; i < pack.num_loaded; i++) {
+      *key = XXH64(pack.models[i], FLEX_TRIT_SIZE_243, *key);
+    }
+  }
+  iota_tangle_cursor_close(&cursor);
+
+done:
+  hash_pack_free(&pack);
+
+  return ret;
+}
+
+retcode_t iota_tangle_filter_enable(tangle_t *const tangle, char const *const path, size_t const capacity,
+                                    double const false_positive_rate) {
+  retcode_t ret = RC_OK;
+  uint64_t count = 0;
+  uint64_t key = 0;
+  bool loaded = false;
+
+  if (filter_enabled) {
+    if (!tangle_same_database(tangle, filter_db_path)) {
+      return RC_TANGLE_OTHER_DATABASE;
+    }
+    tangle->filter = &filter;
+    return RC_OK;
+  }
+
+  if (tangle->db_path == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if ((ret = iota_tangle_transaction_count(tangle, &count)) != RC_OK) {
+    return ret;
+  }
+  if (path != NULL && (ret = tangle_filter_key(tangle, count, &key)) != RC_OK) {
+    return ret;
+  }
+  if ((ret = tangle_filter_init(&filter, capacity, false_positive_rate)) != RC_OK) {
+    return ret;
+  }
+
+  if ((filter_db_path = strdup(tangle->db_path)) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+
+  if (path != NULL) {
+    if ((filter_path = strdup(path)) == NULL) {
+      ret = RC_OOM;
+      goto done;
+    }
+    if ((ret = tangle_filter_load(&filter, path, key, &loaded)) != RC_OK) {
+      goto done;
+    }
+    remove(path);
+  }
+
+  if (loaded) {
+    log_info(logger_id, "Tangle filter loaded from %s\n", path);
+  } else {
+    log_info(logger_id, "Rebuilding tangle filter from %" PRIu64 " transactions\n", count);
+    if ((ret = tangle_filter_rebuild(tangle)) != RC_OK) {
+      goto done;
+    }
+  }
+
+  filter_enabled = true;
+  tangle->filter = &filter;
+
+done:
+  if (ret != RC_OK) {
+    free(filter_path);
+    filter_path = NULL;
+    free(filter_db_path);
+    filter_db_path = NULL;
+    tangle_filter_destroy(&filter);
+  }
+  return ret;
+}
+
+retcode_t iota_tangle_filter_disable(tangle_t *const tangle) {
+  retcode_t ret = RC_OK;
+  uint64_t count = 0;
+  uint64_t key = 0;
+
+  if (!filter_enabled) {
+    return RC_OK;
+  }
+  if (!tangle_same_database(tangle, filter_db_path)) {
+    return RC_TANGLE_OTHER_DATABASE;
+  }
+
+  tangle->filter = NULL;
+  filter_enabled = false;
+  free(filter_db_path);
+  filter_db_path = NULL;
+
+  if (filter_path != NULL) {
+    if ((ret = iota_tangle_transaction_count(tangle, &count)) == RC_OK &&
+        (ret = tangle_filter_key(tangle, count, &key)) == RC_OK) {
+      ret = tangle_filter_save(&filter, filter_path, key);
+    }
+    if (ret != RC_OK) {
+      log_error(logger_id, "Saving tangle filter to %s failed\n", filter_path);
+    }
+    free(filter_path);
+    filter_path = NULL;
+  }
+
+  tangle_filter_destroy(&filter);
+
+  return ret;
+}
+
+bool iota_tangle_filter_stats(tangle_filter_stats_t *const stats) {
+  if (!filter_enabled) {
+    return false;
+  }
+
+  tangle_filter_stats(&filter, stats);
+
+  return true;
+}
+
 /*
  * Transaction operations
  */
@@ -33,22 +435,128 @@ retcode_t iota_tangle_transaction_count(tangle_t const *const tangle, uint64_t *
 }
 
 retcode_t iota_tangle_transaction_store(tangle_t const *const tangle, iota_transaction_t const *const tx) {
-  return storage_transaction_store(&tangle->connection, tx);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = NULL;
+  uint64_t epoch = tangle_graph_epoch(tangle->graph);
+
+  // The fingerprint is added before the store commits so that the transaction is never reported absent once stored,
+  // and removed if the store fails, another fingerprint of the hash remaining if it was already stored
+  if (tangle->filter != NULL && (ret = tangle_filter_add(tangle->filter, transaction_hash(tx))) != RC_OK) {
+    return ret;
+  }
+
+  writer = tangle_writer_acquire(tangle);
+  ret = storage_transaction_store(writer, tx);
+  tangle_writer_release(tangle);
+  if (ret != RC_OK && tangle->filter != NULL) {
+    tangle_filter_remove(tangle->filter, transaction_hash(tx));
+  }
+  if (ret != RC_OK || tangle->graph == NULL) {
+    return ret;
+  }
+
+  return tangle_graph_transaction_add(tangle->graph, tx, epoch);
+}
+
+retcode_t iota_tangle_transactions_store(tangle_t const *const tangle, iota_transaction_t const *const txs,
+                                         size_t const count) {
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = NULL;
+  uint64_t epoch = tangle_graph_epoch(tangle->graph);
+
+  // Batches are stored atomically so that their fingerprints can all be removed if the store fails
+  for (size_t i = 0; tangle->filter != NULL && i < count; i++) {
+    if ((ret = tangle_filter_add(tangle->filter, transaction_hash(&txs[i]))) != RC_OK) {
+      return ret;
+    }
+  }
+
+  writer = tangle_writer_acquire(tangle);
+  ret = storage_transactions_store(writer, txs, count);
+  tangle_writer_release(tangle);
+  for (size_t i = 0; ret != RC_OK && tangle->filter != NULL && i < count; i++) {
+    tangle_filter_remove(tangle->filter, transaction_hash(&txs[i]));
+  }
+  if (ret != RC_OK || tangle->graph == NULL) {
+    return ret;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if ((ret = tangle_graph_transaction_add(tangle->graph, &txs[i], epoch)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
 }
 
 retcode_t iota_tangle_transaction_load(tangle_t const *const tangle, storage_transaction_field_t const field,
                                        flex_trit_t const *const key, iota_stor_pack_t *const tx) {
-  return storage_transaction_load(&tangle->connection, field, key, tx);
+  retcode_t ret = RC_OK;
+  size_t num_loaded = tx->num_loaded;
+  uint64_t epoch = tangle_graph_epoch(tangle->graph);
+  uint64_t cache_epoch = tangle->cache != NULL ? tangle_partial_cache_epoch(tangle->cache) : 0;
+
+  if ((ret = storage_transaction_load(&tangle->connection, field, key, tx)) != RC_OK) {
+    return ret;
+  }
+
+  if (field != TRANSACTION_FIELD_HASH || tx->num_loaded == num_loaded) {
+    return RC_OK;
+  }
+  if (tangle->graph != NULL &&
+      (ret = tangle_graph_transaction_fill(tangle->graph, key, tx->models[num_loaded], epoch)) != RC_OK) {
+    return ret;
+  }
+  if (tangle->cache != NULL) {
+    return tangle_partial_cache_put(tangle->cache, key, tx->models[num_loaded], cache_epoch);
+  }
+
+  return RC_OK;
 }
 
 retcode_t iota_tangle_transaction_update_solidity(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                   bool const state) {
-  return storage_transaction_update_solidity(&tangle->connection, hash, state);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = NULL;
+
+  writer = tangle_writer_acquire(tangle);
+  ret = storage_transaction_update_solidity(writer, hash, state);
+  tangle_writer_release(tangle);
+  if (ret == RC_OK) {
+    ret = tangle_cache_invalidate(tangle, hash);
+  }
+  if (ret != RC_OK || tangle->graph == NULL) {
+    return ret;
+  }
+
+  return tangle_graph_solid_set(tangle->graph, hash, state);
 }
 
 retcode_t iota_tangle_transactions_update_solidity(tangle_t const *const tangle, hash243_set_t const hashes,
                                                    bool const is_solid) {
-  return storage_transactions_update_solidity(&tangle->connection, hashes, is_solid);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = NULL;
+  hash243_set_entry_t *iter = NULL;
+  hash243_set_entry_t *tmp = NULL;
+
+  writer = tangle_writer_acquire(tangle);
+  ret = storage_transactions_update_solidity(writer, hashes, is_solid);
+  tangle_writer_release(tangle);
+  if (ret == RC_OK) {
+    ret = tangle_cache_invalidate_set(tangle, hashes);
+  }
+  if (ret != RC_OK || tangle->graph == NULL) {
+    return ret;
+  }
+
+  HASH_SET_ITER(hashes, iter, tmp) {
+    if ((ret = tangle_graph_solid_set(tangle->graph, iter->hash, is_solid)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
 }
 
 retcode_t iota_tangle_transaction_load_hashes_by_address(tangle_t const *const tangle, flex_trit_t const *const address,
@@ -76,6 +584,23 @@ retcode_t iota_tangle_transaction_load_hashes_of_approvers(tangle_t const *const
                                                            flex_trit_t const *const approvee_hash,
                                                            iota_stor_pack_t *const pack, int64_t before_timestamp) {
   retcode_t res = RC_OK;
+  uint64_t epoch = 0;
+  bool found = false;
+
+  if (tangle->graph != NULL) {
+    // Only the approvers known to the graph are loaded when the pack is resized
+    while ((res = tangle_graph_approvers_get(tangle->graph, approvee_hash, pack, before_timestamp, &found)) == RC_OK &&
+           found && pack->insufficient_capacity) {
+      if ((res = hash_pack_resize(pack, 2)) != RC_OK) {
+        break;
+      }
+      pack->num_loaded = 0;
+    }
+    if (res != RC_OK || found) {
+      return res;
+    }
+    epoch = tangle_graph_epoch(tangle->graph);
+  }
 
   res = storage_transaction_load_hashes_of_approvers(&tangle->connection, approvee_hash, pack, before_timestamp);
 
@@ -89,6 +614,8 @@ retcode_t iota_tangle_transaction_load_hashes_of_approvers(tangle_t const *const
 
   if (res != RC_OK) {
     log_error(logger_id, "Failed in loading approvers, error code is: %" PRIu64 "\n", res);
+  } else if (tangle->graph != NULL && before_timestamp == 0) {
+    res = tangle_graph_approvers_fill(tangle->graph, approvee_hash, pack, epoch);
   }
 
   return res;
@@ -96,17 +623,166 @@ retcode_t iota_tangle_transaction_load_hashes_of_approvers(tangle_t const *const
 
 retcode_t iota_tangle_transaction_load_partial(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                iota_stor_pack_t *const pack, partial_transaction_model_e models_mask) {
+  retcode_t ret = RC_OK;
+  size_t num_loaded = pack->num_loaded;
+  tangle_partial_cache_model_t cache_model = tangle_cache_model(models_mask);
+  uint64_t epoch = 0;
+  uint64_t cache_epoch = 0;
+  bool found = false;
+
+  if (cache_model == TANGLE_PARTIAL_CACHE_MODELS_NUM) {
+    return RC_CONSENSUS_NOT_IMPLEMENTED;
+  }
+
+  if (tangle->graph != NULL) {
+    if (models_mask == PARTIAL_TX_MODEL_METADATA && pack->num_loaded < pack->capacity) {
+      transaction_reset(pack->models[pack->num_loaded]);
+      if ((ret = tangle_graph_metadata_get(tangle->graph, hash, pack->models[pack->num_loaded], &found)) != RC_OK ||
+          found) {
+        pack->num_loaded += found;
+        return ret;
+      }
+    }
+    epoch = tangle_graph_epoch(tangle->graph);
+  }
+
+  if (tangle->cache != NULL) {
+    if (pack->num_loaded < pack->capacity) {
+      if ((ret = tangle_partial_cache_get(tangle->cache, hash, cache_model, pack->models[pack->num_loaded], &found)) !=
+              RC_OK ||
+          found) {
+        pack->num_loaded += found;
+        return ret;
+      }
+    }
+    cache_epoch = tangle_partial_cache_epoch(tangle->cache);
+  }
+
   if (models_mask == PARTIAL_TX_MODEL_METADATA) {
-    return storage_transaction_load_metadata(&tangle->connection, hash, pack);
+    ret = storage_transaction_load_metadata(&tangle->connection, hash, pack);
   } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_METADATA) {
-    return storage_transaction_load_essence_metadata(&tangle->connection, hash, pack);
+    ret = storage_transaction_load_essence_metadata(&tangle->connection, hash, pack);
   } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA) {
-    return storage_transaction_load_essence_attachment_metadata(&tangle->connection, hash, pack);
-  } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_CONSENSUS) {
-    return storage_transaction_load_essence_consensus(&tangle->connection, hash, pack);
+    ret = storage_transaction_load_essence_attachment_metadata(&tangle->connection, hash, pack);
   } else {
-    return RC_CONSENSUS_NOT_IMPLEMENTED;
+    ret = storage_transaction_load_essence_consensus(&tangle->connection, hash, pack);
+  }
+
+  if (ret == RC_OK && tangle->graph != NULL && pack->num_loaded > num_loaded) {
+    ret = tangle_graph_transaction_fill(tangle->graph, hash, pack->models[num_loaded], epoch);
   }
+  if (ret == RC_OK && tangle->cache != NULL && pack->num_loaded > num_loaded) {
+    ret = tangle_partial_cache_put(tangle->cache, hash, pack->models[num_loaded], cache_epoch);
+  }
+
+  return ret;
+}
+
+static bool transaction_is_loaded(iota_transaction_t const *const tx) {
+  return tx->loaded_columns_mask.essence || tx->loaded_columns_mask.attachment || tx->loaded_columns_mask.consensus ||
+         tx->loaded_columns_mask.data || tx->loaded_columns_mask.metadata;
+}
+
+static retcode_t transactions_load_model(tangle_t const *const tangle, hash243_queue_t const hashes,
+                                         iota_stor_pack_t *const pack, storage_load_model_t const model,
+                                         tangle_partial_cache_model_t const cache_model) {
+  retcode_t ret = RC_OK;
+  hash243_queue_entry_t *iter = NULL;
+  size_t i = 0;
+  uint64_t epoch = 0;
+  uint64_t cache_epoch = 0;
+  bool found = true;
+
+  if (tangle->graph != NULL) {
+    // Metadata of resident transactions never hits the database
+    if (model == MODEL_TRANSACTION_METADATA && hash243_queue_count(hashes) <= pack->capacity) {
+      CDL_FOREACH(hashes, iter) {
+        transaction_reset(pack->models[i]);
+        if ((ret = tangle_graph_metadata_get(tangle->graph, iter->hash, pack->models[i++], &found)) != RC_OK) {
+          return ret;
+        }
+        if (!found) {
+          break;
+        }
+      }
+      if (found) {
+        pack->num_loaded = i;
+        pack->insufficient_capacity = false;
+        return RC_OK;
+      }
+    }
+    epoch = tangle_graph_epoch(tangle->graph);
+  }
+
+  if (tangle->cache != NULL) {
+    // The database is only queried if some transaction misses, in which case all of them are loaded again
+    if (cache_model != TANGLE_PARTIAL_CACHE_MODELS_NUM && hash243_queue_count(hashes) <= pack->capacity) {
+      i = 0;
+      found = true;
+      CDL_FOREACH(hashes, iter) {
+        if ((ret = tangle_partial_cache_get(tangle->cache, iter->hash, cache_model, pack->models[i++], &found)) !=
+            RC_OK) {
+          return ret;
+        }
+        if (!found) {
+          break;
+        }
+      }
+      if (found) {
+        pack->num_loaded = i;
+        pack->insufficient_capacity = false;
+        return RC_OK;
+      }
+    }
+    cache_epoch = tangle_partial_cache_epoch(tangle->cache);
+  }
+
+  if ((ret = storage_transactions_load_partial(&tangle->connection, hashes, pack, model)) != RC_OK ||
+      (tangle->graph == NULL && tangle->cache == NULL)) {
+    return ret;
+  }
+
+  i = 0;
+  CDL_FOREACH(hashes, iter) {
+    if (i == pack->num_loaded) {
+      break;
+    }
+    if (transaction_is_loaded(pack->models[i])) {
+      if (tangle->graph != NULL &&
+          (ret = tangle_graph_transaction_fill(tangle->graph, iter->hash, pack->models[i], epoch)) != RC_OK) {
+        return ret;
+      }
+      if (tangle->cache != NULL &&
+          (ret = tangle_partial_cache_put(tangle->cache, iter->hash, pack->models[i], cache_epoch)) != RC_OK) {
+        return ret;
+      }
+    }
+    i++;
+  }
+
+  return RC_OK;
+}
+
+retcode_t iota_tangle_transactions_load(tangle_t const *const tangle, hash243_queue_t const hashes,
+                                        iota_stor_pack_t *const pack) {
+  return transactions_load_model(tangle, hashes, pack, MODEL_TRANSACTION, TANGLE_PARTIAL_CACHE_MODELS_NUM);
+}
+
+retcode_t iota_tangle_transactions_load_partial(tangle_t const *const tangle, hash243_queue_t const hashes,
+                                                iota_stor_pack_t *const pack, partial_transaction_model_e models_mask) {
+  tangle_partial_cache_model_t cache_model = tangle_cache_model(models_mask);
+
+  if (models_mask == PARTIAL_TX_MODEL_METADATA) {
+    return transactions_load_model(tangle, hashes, pack, MODEL_TRANSACTION_METADATA, cache_model);
+  } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_METADATA) {
+    return transactions_load_model(tangle, hashes, pack, MODEL_TRANSACTION_ESSENCE_METADATA, cache_model);
+  } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA) {
+    return transactions_load_model(tangle, hashes, pack, MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA, cache_model);
+  } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_CONSENSUS) {
+    return transactions_load_model(tangle, hashes, pack, MODEL_TRANSACTION_ESSENCE_CONSENSUS, cache_model);
+  }
+
+  return RC_CONSENSUS_NOT_IMPLEMENTED;
 }
 
 retcode_t iota_tangle_transaction_load_hashes_of_milestone_candidates(tangle_t const *const tangle,
@@ -135,21 +811,90 @@ retcode_t iota_tangle_transaction_load_hashes_of_milestone_candidates(tangle_t c
 
 retcode_t iota_tangle_transaction_update_snapshot_index(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                         uint64_t const snapshot_index) {
-  return storage_transaction_update_snapshot_index(&tangle->connection, hash, snapshot_index);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = NULL;
+
+  writer = tangle_writer_acquire(tangle);
+  ret = storage_transaction_update_snapshot_index(writer, hash, snapshot_index);
+  tangle_writer_release(tangle);
+  if (ret == RC_OK) {
+    ret = tangle_cache_invalidate(tangle, hash);
+  }
+  if (ret != RC_OK || tangle->graph == NULL) {
+    return ret;
+  }
+
+  return tangle_graph_snapshot_index_set(tangle->graph, hash, snapshot_index);
 }
 
 retcode_t iota_tangle_transactions_update_snapshot_index(tangle_t const *const tangle, hash243_set_t const hashes,
                                                          uint64_t const snapshot_index) {
-  return storage_transactions_update_snapshot_index(&tangle->connection, hashes, snapshot_index);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = NULL;
+  hash243_set_entry_t *iter = NULL;
+  hash243_set_entry_t *tmp = NULL;
+
+  writer = tangle_writer_acquire(tangle);
+  ret = storage_transactions_update_snapshot_index(writer, hashes, snapshot_index);
+  tangle_writer_release(tangle);
+  if (ret == RC_OK) {
+    ret = tangle_cache_invalidate_set(tangle, hashes);
+  }
+  if (ret != RC_OK || tangle->graph == NULL) {
+    return ret;
+  }
+
+  HASH_SET_ITER(hashes, iter, tmp) {
+    if ((ret = tangle_graph_snapshot_index_set(tangle->graph, iter->hash, snapshot_index)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
 }
 
 retcode_t iota_tangle_transaction_exist(tangle_t const *const tangle, storage_transaction_field_t const field,
                                         flex_trit_t const *const key, bool *const exist) {
-  return storage_transaction_exist(&tangle->connection, field, key, exist);
+  retcode_t ret = RC_OK;
+  bool found = false;
+  bool maybe = false;
+
+  if (tangle->filter != NULL && field == TRANSACTION_FIELD_HASH) {
+    if ((ret = tangle_filter_contains(tangle->filter, key, &maybe)) != RC_OK) {
+      return ret;
+    }
+    if (!maybe) {
+      *exist = false;
+      return RC_OK;
+    }
+  }
+
+  if (tangle->graph != NULL && field == TRANSACTION_FIELD_HASH) {
+    if ((ret = tangle_graph_transaction_exist(tangle->graph, key, exist, &found)) != RC_OK || found) {
+      goto done;
+    }
+  }
+
+  ret = storage_transaction_exist(&tangle->connection, field, key, exist);
+
+done:
+  if (ret == RC_OK && maybe && !*exist) {
+    tangle_filter_false_positive(tangle->filter);
+  }
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_approvers_count(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                   uint64_t *const count) {
+  retcode_t ret = RC_OK;
+  bool found = false;
+
+  if (tangle->graph != NULL) {
+    if ((ret = tangle_graph_approvers_count(tangle->graph, hash, count, &found)) != RC_OK || found) {
+      return ret;
+    }
+  }
+
   return storage_transaction_approvers_count(&tangle->connection, hash, count);
 }
 
@@ -160,20 +905,181 @@ retcode_t iota_tangle_transaction_find(tangle_t const *const tangle, hash243_que
 }
 
 retcode_t iota_tangle_transactions_metadata_clear(tangle_t const *const tangle) {
-  return storage_transactions_metadata_clear(&tangle->connection);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = NULL;
+
+  writer = tangle_writer_acquire(tangle);
+  ret = storage_transactions_metadata_clear(writer);
+  tangle_writer_release(tangle);
+  if (ret == RC_OK && tangle->cache != NULL) {
+    ret = tangle_partial_cache_clear(tangle->cache);
+  }
+  if (ret != RC_OK || tangle->graph == NULL) {
+    return ret;
+  }
+
+  return tangle_graph_metadata_clear(tangle->graph);
+}
+
+/**
+ * Collects the hashes of a set that are stored, with the writer held so that they are still stored when deleted
+ */
+static retcode_t tangle_stored_hashes(tangle_t const *const tangle, storage_connection_t const *const writer,
+                                      hash243_set_t const hashes, hash243_set_t *const stored) {
+  retcode_t ret = RC_OK;
+  hash243_set_entry_t *iter = NULL;
+  hash243_set_entry_t *tmp = NULL;
+  bool exist = false;
+  bool found = false;
+
+  HASH_SET_ITER(hashes, iter, tmp) {
+    found = false;
+    if (tangle->graph != NULL &&
+        (ret = tangle_graph_transaction_exist(tangle->graph, iter->hash, &exist, &found)) != RC_OK) {
+      return ret;
+    }
+    if (!found && (ret = storage_transaction_exist(writer, TRANSACTION_FIELD_HASH, iter->hash, &exist)) != RC_OK) {
+      return ret;
+    }
+    if (exist && (ret = hash243_set_add(stored, iter->hash)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
 }
 
 retcode_t iota_tangle_transactions_delete(tangle_t const *const tangle, hash243_set_t const hashes) {
-  return storage_transactions_delete(&tangle->connection, hashes);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = NULL;
+  hash243_set_t stored = NULL;
+  hash243_set_entry_t *iter = NULL;
+  hash243_set_entry_t *tmp = NULL;
+
+  writer = tangle_writer_acquire(tangle);
+  // Removing a hash that was never added from the filter would remove the fingerprint of another transaction
+  if (tangle->filter != NULL) {
+    ret = tangle_stored_hashes(tangle, writer, hashes, &stored);
+  }
+  if (ret == RC_OK) {
+    ret = storage_transactions_delete(writer, hashes);
+  }
+  tangle_writer_release(tangle);
+  if (ret == RC_OK) {
+    ret = tangle_cache_invalidate_set(tangle, hashes);
+  }
+  if (ret != RC_OK) {
+    goto done;
+  }
+
+  HASH_SET_ITER(hashes, iter, tmp) {
+    if (tangle->graph != NULL && (ret = tangle_graph_transaction_remove(tangle->graph, iter->hash)) != RC_OK) {
+      goto done;
+    }
+  }
+  HASH_SET_ITER(stored, iter, tmp) {
+    if ((ret = tangle_filter_remove(tangle->filter, iter->hash)) != RC_OK) {
+      goto done;
+    }
+  }
+
+done:
+  hash243_set_free(&stored);
+
+  return ret;
+}
+
+retcode_t iota_tangle_transactions_prune(tangle_t const *const tangle, hash243_set_t const hashes,
+                                         size_t const batch_size) {
+  retcode_t ret = RC_OK;
+  hash243_set_t batch = NULL;
+  hash243_set_entry_t *iter = NULL;
+  hash243_set_entry_t *tmp = NULL;
+  uint32_t remaining = hash243_set_size(hashes);
+
+  HASH_SET_ITER(hashes, iter, tmp) {
+    if ((ret = hash243_set_add(&batch, iter->hash)) != RC_OK) {
+      goto done;
+    }
+    remaining--;
+    if (hash243_set_size(batch) >= batch_size || remaining == 0) {
+      if ((ret = iota_tangle_transactions_delete(tangle, batch)) != RC_OK) {
+        goto done;
+      }
+      hash243_set_free(&batch);
+    }
+  }
+
+done:
+  hash243_set_free(&batch);
+
+  return ret;
+}
+
+retcode_t iota_tangle_compact(tangle_t const *const tangle, size_t const pages) {
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = NULL;
+
+  writer = tangle_writer_acquire(tangle);
+  ret = storage_compact(writer, pages);
+  tangle_writer_release(tangle);
+
+  return ret;
 }
 
+/*
+ * Cursor operations
+ */
+
+retcode_t iota_tangle_cursor_open(tangle_t const *const tangle, storage_cursor_t *const cursor,
+                                  storage_cursor_query_t const query, flex_trit_t const *const key,
+                                  storage_load_model_t const model) {
+  return storage_cursor_open(&tangle->connection, cursor, query, key, model);
+}
+
+retcode_t iota_tangle_cursor_find_open(tangle_t const *const tangle, storage_cursor_t *const cursor,
+                                       hash243_queue_t const bundles, hash243_queue_t const addresses,
+                                       hash81_queue_t const tags, hash243_queue_t const approvees) {
+  return storage_cursor_find_open(&tangle->connection, cursor, bundles, addresses, tags, approvees);
+}
+
+retcode_t iota_tangle_cursor_next(storage_cursor_t *const cursor, iota_stor_pack_t *const pack) {
+  return storage_cursor_next(cursor, pack);
+}
+
+retcode_t iota_tangle_cursor_close(storage_cursor_t *const cursor) { return storage_cursor_close(cursor); }
+
 /*
  * Bundle operations
  */
 
 retcode_t iota_tangle_bundle_update_validity(tangle_t const *const tangle, bundle_transactions_t const *const bundle,
                                              bundle_status_t const status) {
-  return storage_bundle_update_validity(&tangle->connection, bundle, status);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = NULL;
+  iota_transaction_t *tx = NULL;
+
+  writer = tangle_writer_acquire(tangle);
+  ret = storage_bundle_update_validity(writer, bundle, status);
+  tangle_writer_release(tangle);
+  if (ret == RC_OK && tangle->cache != NULL) {
+    BUNDLE_FOREACH(bundle, tx) {
+      if ((ret = tangle_partial_cache_invalidate(tangle->cache, transaction_hash(tx))) != RC_OK) {
+        break;
+      }
+    }
+  }
+  if (ret != RC_OK || tangle->graph == NULL) {
+    return ret;
+  }
+
+  BUNDLE_FOREACH(bundle, tx) {
+    if ((ret = tangle_graph_validity_set(tangle->graph, transaction_hash(tx), status)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
 }
 
 retcode_t iota_tangle_bundle_load(tangle_t const *const tangle, flex_trit_t const *const tail_hash,
@@ -219,11 +1125,23 @@ retcode_t iota_tangle_bundle_load(tangle_t const *const tangle, flex_trit_t cons
  */
 
 retcode_t iota_tangle_milestone_clear(tangle_t const *const tangle) {
-  return storage_milestone_clear(&tangle->connection);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = tangle_writer_acquire(tangle);
+
+  ret = storage_milestone_clear(writer);
+  tangle_writer_release(tangle);
+
+  return ret;
 }
 
 retcode_t iota_tangle_milestone_store(tangle_t const *const tangle, iota_milestone_t const *const data_in) {
-  return storage_milestone_store(&tangle->connection, data_in);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = tangle_writer_acquire(tangle);
+
+  ret = storage_milestone_store(writer, data_in);
+  tangle_writer_release(tangle);
+
+  return ret;
 }
 
 retcode_t iota_tangle_milestone_load(tangle_t const *const tangle, flex_trit_t const *const hash,
@@ -254,7 +1172,13 @@ retcode_t iota_tangle_milestone_exist(tangle_t const *const tangle, flex_trit_t
 }
 
 retcode_t iota_tangle_milestone_delete(tangle_t const *const tangle, flex_trit_t const *const hash) {
-  return storage_milestone_delete(&tangle->connection, hash);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = tangle_writer_acquire(tangle);
+
+  ret = storage_milestone_delete(writer, hash);
+  tangle_writer_release(tangle);
+
+  return ret;
 }
 
 /*
@@ -324,7 +1248,13 @@ retcode_t iota_tangle_find_tail(tangle_t const *const tangle, flex_trit_t const
 
 retcode_t iota_tangle_state_delta_store(tangle_t const *const tangle, uint64_t const index,
                                         state_delta_t const *const delta) {
-  return storage_state_delta_store(&tangle->connection, index, delta);
+  retcode_t ret = RC_OK;
+  storage_connection_t const *writer = tangle_writer_acquire(tangle);
+
+  ret = storage_state_delta_store(writer, index, delta);
+  tangle_writer_release(tangle);
+
+  return ret;
 }
 
 retcode_t iota_tangle_state_delta_load(tangle_t const *const tangle, uint64_t const index, state_delta_t *const delta) {
@@ -12,8 +12,12 @@
 #include <stdint.h>
 
 #include "ciri/consensus/snapshot/state_delta.h"
+#include "ciri/consensus/tangle/filter.h"
+#include "ciri/consensus/tangle/graph.h"
+#include "ciri/consensus/tangle/partial_cache.h"
 #include "ciri/storage/connection.h"
 #include "ciri/storage/defs.h"
+#include "ciri/storage/pool.h"
 #include "ciri/storage/storage.h"
 #include "common/errors.h"
 #include "common/model/bundle.h"
@@ -29,6 +33,16 @@ extern "C" {
 
 typedef struct tangle_s {
   storage_connection_t connection;
+  // Path of the database the tangle is connected to, not owned, shared indexes are only attached to its tangles
+  char const *db_path;
+  // Graph index shared by all tangles of the same database, NULL if disabled
+  tangle_graph_t *graph;
+  // Pool the connection was checked out of and writes go through, NULL if the connection is private
+  storage_pool_t *pool;
+  // Partial models cache shared by all tangles of the same database, NULL if disabled
+  tangle_partial_cache_t *cache;
+  // Filter of the hashes of stored transactions shared by all tangles of the same database, NULL if disabled
+  tangle_filter_t *filter;
 } tangle_t;
 
 typedef enum _partial_transaction_model {
@@ -43,6 +57,122 @@ retcode_t iota_tangle_init(tangle_t *const tangle, storage_connection_config_t c
 
 retcode_t iota_tangle_destroy(tangle_t *const tangle);
 
+/**
+ * Enables the graph index shared by the tangle and all tangles of the same database initialized afterwards
+ * Stores, updates and deletes are written through to the graph, which answers approvers, existence and metadata
+ * queries when it can. If the database is empty, the graph sees every transaction and is complete, otherwise it is
+ * filled as transactions are loaded.
+ *
+ * @param tangle A tangle connected to the database
+ *
+ * @return a status code, RC_TANGLE_OTHER_DATABASE if the graph is enabled for another database
+ */
+retcode_t iota_tangle_graph_enable(tangle_t *const tangle);
+
+/**
+ * Disables the graph index, all tangles using it must have been destroyed except the given one
+ *
+ * @param tangle The tangle the graph was enabled with
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_graph_disable(tangle_t *const tangle);
+
+/**
+ * Enables the partial models cache shared by the tangle and all tangles of the same database initialized afterwards
+ * Partial loads are answered from the cache when it holds every field of the model, and fill it otherwise. Entries
+ * are invalidated by every update of the metadata of their transaction.
+ *
+ * @param tangle A tangle
+ * @param capacity The minimum number of transactions the cache can hold
+ *
+ * @return a status code, RC_TANGLE_OTHER_DATABASE if the cache is enabled for another database
+ */
+retcode_t iota_tangle_cache_enable(tangle_t *const tangle, size_t const capacity);
+
+/**
+ * Disables the partial models cache, all tangles using it must have been destroyed except the given one
+ *
+ * @param tangle The tangle the cache was enabled with
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_cache_disable(tangle_t *const tangle);
+
+/**
+ * Gets the statistics of the partial models cache
+ *
+ * @param stats Filled with the statistics
+ *
+ * @return false if the cache is disabled, true otherwise
+ */
+bool iota_tangle_cache_stats(tangle_partial_cache_stats_t *const stats);
+
+/**
+ * Enables the filter of transaction hashes shared by the tangle and all tangles of the same database initialized
+ * afterwards
+ * Stores and deletes are written through to the filter, which answers existence checks of absent hashes without
+ * querying the database. The filter is loaded from its file if it was saved with the current number of transactions
+ * and the same first hashes streamed from the database, and rebuilt from the database otherwise. The file is removed
+ * once read so that a filter is never loaded after an unclean shutdown.
+ *
+ * @param tangle A tangle connected to the database
+ * @param path The path of the file the filter is saved to when disabled, NULL to always rebuild it
+ * @param capacity The number of transactions the filter can hold, it reports every hash as possibly present once full
+ * @param false_positive_rate The maximum rate of absent hashes the filter reports as possibly present
+ *
+ * @return a status code, RC_TANGLE_OTHER_DATABASE if the filter is enabled for another database
+ */
+retcode_t iota_tangle_filter_enable(tangle_t *const tangle, char const *const path, size_t const capacity,
+                                    double const false_positive_rate);
+
+/**
+ * Saves and disables the filter of transaction hashes, all tangles using it must have been destroyed except the given
+ * one
+ *
+ * @param tangle The tangle the filter was enabled with
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_filter_disable(tangle_t *const tangle);
+
+/**
+ * Gets the statistics of the filter of transaction hashes
+ *
+ * @param stats Filled with the statistics
+ *
+ * @return false if the filter is disabled, true otherwise
+ */
+bool iota_tangle_filter_stats(tangle_filter_stats_t *const stats);
+
+/**
+ * Enables the connection pool used by all tangles initialized afterwards on the same database
+ * Such tangles check a read-only connection out of the pool for their lifetime, or open a private connection if the
+ * pool is exhausted, and serialize their writes through the single writer connection of the pool
+ *
+ * @param conf The configuration of the database
+ * @param readers_max The maximum number of reader connections
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_pool_enable(storage_connection_config_t const *const conf, size_t const readers_max);
+
+/**
+ * Disables the connection pool, all tangles using it must have been destroyed
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_pool_disable();
+
+/**
+ * Gets the statistics of the connection pool
+ *
+ * @param stats Filled with the statistics
+ *
+ * @return false if the pool is disabled, true otherwise
+ */
+bool iota_tangle_pool_stats(storage_pool_stats_t *const stats);
+
 /*
  * Transaction operations
  */
@@ -51,6 +181,9 @@ retcode_t iota_tangle_transaction_count(tangle_t const *const tangle, uint64_t *
 
 retcode_t iota_tangle_transaction_store(tangle_t const *const tangle, iota_transaction_t const *const tx);
 
+retcode_t iota_tangle_transactions_store(tangle_t const *const tangle, iota_transaction_t const *const txs,
+                                         size_t const count);
+
 retcode_t iota_tangle_transaction_load(tangle_t const *const tangle, storage_transaction_field_t const field,
                                        flex_trit_t const *const key, iota_stor_pack_t *const tx);
 
@@ -75,6 +208,33 @@ retcode_t iota_tangle_transaction_load_hashes_by_address(tangle_t const *const t
 retcode_t iota_tangle_transaction_load_partial(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                iota_stor_pack_t *const pack, partial_transaction_model_e models_mask);
 
+/**
+ * Loads transactions from a list of hashes in as few storage round trips as possible
+ *
+ * @param tangle The tangle
+ * @param hashes The hashes of the transactions
+ * @param pack A pack of transactions, the i-th model is loaded with the i-th hash and has an empty loaded columns
+ * mask if it was not found
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_transactions_load(tangle_t const *const tangle, hash243_queue_t const hashes,
+                                        iota_stor_pack_t *const pack);
+
+/**
+ * Loads partial transaction data from a list of hashes in as few storage round trips as possible
+ *
+ * @param tangle The tangle
+ * @param hashes The hashes of the transactions
+ * @param pack A pack of transactions, the i-th model is loaded with the i-th hash and has an empty loaded columns
+ * mask if it was not found
+ * @param models_mask The bitmask representing the partial data to load
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_transactions_load_partial(tangle_t const *const tangle, hash243_queue_t const hashes,
+                                                iota_stor_pack_t *const pack, partial_transaction_model_e models_mask);
+
 /**
  * Loads hashes of milestone candidates
  *
@@ -109,6 +269,29 @@ retcode_t iota_tangle_transactions_metadata_clear(tangle_t const *const tangle);
 
 retcode_t iota_tangle_transactions_delete(tangle_t const *const tangle, hash243_set_t const hashes);
 
+/**
+ * Deletes transactions in batches, each written in its own database transaction so that other writers are not held
+ * back for the whole deletion
+ *
+ * @param tangle The tangle
+ * @param hashes The hashes of the transactions to delete
+ * @param batch_size The maximum number of transactions deleted per database transaction
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_transactions_prune(tangle_t const *const tangle, hash243_set_t const hashes,
+                                         size_t const batch_size);
+
+/**
+ * Gives the space left by deleted transactions back to the file system, if the storage backend supports it
+ *
+ * @param tangle The tangle
+ * @param pages The maximum number of pages to give back, 0 for all of them
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_compact(tangle_t const *const tangle, size_t const pages);
+
 /**
  * Find the transactions which match the specified input. The input fields can
  * either be bundles, addresses, tags or approvees. Using multiple of these
@@ -127,6 +310,47 @@ retcode_t iota_tangle_transaction_find(tangle_t const *const tangle, hash243_que
                                        hash243_queue_t const addresses, hash81_queue_t const tags,
                                        hash243_queue_t const approvees, iota_stor_pack_t *const pack);
 
+/*
+ * Cursor operations
+ */
+
+/**
+ * Opens a cursor streaming the transactions matching a query, see storage_cursor_open
+ * Partial transactions are loaded from the database, bypassing the partial cache
+ *
+ * @param tangle The tangle, whose connection is used by the cursor until it is closed
+ * @param cursor The cursor
+ * @param query The query
+ * @param key The address or approvee hash the query is about
+ * @param model MODEL_HASH or one of the partial transaction models
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_cursor_open(tangle_t const *const tangle, storage_cursor_t *const cursor,
+                                  storage_cursor_query_t const query, flex_trit_t const *const key,
+                                  storage_load_model_t const model);
+
+/**
+ * Opens a cursor streaming the hashes of the transactions matching the specified input, see
+ * iota_tangle_transaction_find
+ *
+ * @param tangle The tangle, whose connection is used by the cursor until it is closed
+ * @param cursor The cursor
+ * @param bundles List of bundle hashes
+ * @param addresses List of addresses
+ * @param tags List of tags
+ * @param approvees List of approvee transaction hashes
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_cursor_find_open(tangle_t const *const tangle, storage_cursor_t *const cursor,
+                                       hash243_queue_t const bundles, hash243_queue_t const addresses,
+                                       hash81_queue_t const tags, hash243_queue_t const approvees);
+
+retcode_t iota_tangle_cursor_next(storage_cursor_t *const cursor, iota_stor_pack_t *const pack);
+
+retcode_t iota_tangle_cursor_close(storage_cursor_t *const cursor);
+
 /*
  * Bundle operations
  */
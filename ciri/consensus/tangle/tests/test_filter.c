@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdio.h>
+
+#include <unity/unity.h>
+
+#include "ciri/consensus/tangle/filter.h"
+
+#define HASHES_NUM 4096
+#define CAPACITY 4096
+#define FALSE_POSITIVE_RATE 0.01
+
+static char *filter_test_path = "ciri/consensus/tangle/tests/test.filter";
+static flex_trit_t hashes[2 * HASHES_NUM][FLEX_TRIT_SIZE_243];
+static tangle_filter_t filter;
+
+static bool filter_contains(size_t const hash) {
+  bool maybe = false;
+
+  TEST_ASSERT(tangle_filter_contains(&filter, hashes[hash], &maybe) == RC_OK);
+
+  return maybe;
+}
+
+static size_t false_positives(void) {
+  size_t count = 0;
+
+  for (size_t i = HASHES_NUM; i < 2 * HASHES_NUM; i++) {
+    count += filter_contains(i);
+  }
+
+  return count;
+}
+
+void setUp(void) { TEST_ASSERT(tangle_filter_init(&filter, CAPACITY, FALSE_POSITIVE_RATE) == RC_OK); }
+
+void tearDown(void) {
+  TEST_ASSERT(tangle_filter_destroy(&filter) == RC_OK);
+  remove(filter_test_path);
+}
+
+void test_add_remove(void) {
+  tangle_filter_stats_t stats;
+
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    TEST_ASSERT(tangle_filter_add(&filter, hashes[i]) == RC_OK);
+  }
+
+  // Added hashes are never missed and absent ones are rarely reported
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    TEST_ASSERT_TRUE(filter_contains(i));
+  }
+  TEST_ASSERT(false_positives() <= 2 * FALSE_POSITIVE_RATE * HASHES_NUM);
+
+  TEST_ASSERT(tangle_filter_stats(&filter, &stats) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(HASHES_NUM, stats.size);
+  TEST_ASSERT_FALSE(stats.saturated);
+  TEST_ASSERT(stats.capacity >= CAPACITY);
+  TEST_ASSERT_EQUAL_INT(2 * HASHES_NUM, stats.hit + stats.miss);
+
+  for (size_t i = 0; i < HASHES_NUM; i += 2) {
+    TEST_ASSERT(tangle_filter_remove(&filter, hashes[i]) == RC_OK);
+  }
+  for (size_t i = 1; i < HASHES_NUM; i += 2) {
+    TEST_ASSERT_TRUE(filter_contains(i));
+  }
+
+  TEST_ASSERT(tangle_filter_stats(&filter, &stats) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(HASHES_NUM / 2, stats.size);
+
+  TEST_ASSERT(tangle_filter_clear(&filter) == RC_OK);
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    TEST_ASSERT_FALSE(filter_contains(i));
+  }
+}
+
+void test_saturation(void) {
+  tangle_filter_stats_t stats;
+
+  // Twice as many hashes as the filter can hold
+  for (size_t i = 0; i < 2 * HASHES_NUM; i++) {
+    TEST_ASSERT(tangle_filter_add(&filter, hashes[i]) == RC_OK);
+  }
+
+  TEST_ASSERT(tangle_filter_stats(&filter, &stats) == RC_OK);
+  TEST_ASSERT_TRUE(stats.saturated);
+  for (size_t i = 0; i < 2 * HASHES_NUM; i++) {
+    TEST_ASSERT_TRUE(filter_contains(i));
+  }
+
+  TEST_ASSERT(tangle_filter_clear(&filter) == RC_OK);
+  TEST_ASSERT(tangle_filter_stats(&filter, &stats) == RC_OK);
+  TEST_ASSERT_FALSE(stats.saturated);
+}
+
+void test_save_load(void) {
+  tangle_filter_t other;
+  bool loaded = true;
+
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    TEST_ASSERT(tangle_filter_add(&filter, hashes[i]) == RC_OK);
+  }
+
+  // Nothing is loaded without a file
+  TEST_ASSERT(tangle_filter_load(&filter, filter_test_path, 42, &loaded) == RC_OK);
+  TEST_ASSERT_FALSE(loaded);
+
+  TEST_ASSERT(tangle_filter_save(&filter, filter_test_path, 42) == RC_OK);
+  TEST_ASSERT(tangle_filter_clear(&filter) == RC_OK);
+
+  // Nor with another tag
+  TEST_ASSERT(tangle_filter_load(&filter, filter_test_path, 43, &loaded) == RC_OK);
+  TEST_ASSERT_FALSE(loaded);
+
+  // Nor with another configuration
+  TEST_ASSERT(tangle_filter_init(&other, CAPACITY, FALSE_POSITIVE_RATE / 100) == RC_OK);
+  TEST_ASSERT(tangle_filter_load(&other, filter_test_path, 42, &loaded) == RC_OK);
+  TEST_ASSERT_FALSE(loaded);
+  TEST_ASSERT(tangle_filter_destroy(&other) == RC_OK);
+
+  TEST_ASSERT(tangle_filter_load(&filter, filter_test_path, 42, &loaded) == RC_OK);
+  TEST_ASSERT_TRUE(loaded);
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    TEST_ASSERT_TRUE(filter_contains(i));
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  for (size_t i = 0; i < 2 * HASHES_NUM; i++) {
+    memset(hashes[i], 0, FLEX_TRIT_SIZE_243);
+    memcpy(hashes[i], &i, sizeof(i));
+  }
+
+  RUN_TEST(test_add_remove);
+  RUN_TEST(test_saturation);
+  RUN_TEST(test_save_load);
+
+  return UNITY_END();
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/consensus/tangle/graph.h"
+
+#define HASHES_NUM 2000
+
+static flex_trit_t hashes[HASHES_NUM][FLEX_TRIT_SIZE_243];
+static tangle_graph_t graph;
+
+static void transaction_build(iota_transaction_t *const tx, size_t const hash, size_t const trunk,
+                              size_t const branch) {
+  transaction_reset(tx);
+  transaction_set_hash(tx, hashes[hash]);
+  transaction_set_trunk(tx, hashes[trunk]);
+  transaction_set_branch(tx, hashes[branch]);
+}
+
+static void transaction_add(size_t const hash, size_t const trunk, size_t const branch) {
+  iota_transaction_t tx;
+
+  transaction_build(&tx, hash, trunk, branch);
+  TEST_ASSERT(tangle_graph_transaction_add(&graph, &tx, tangle_graph_epoch(&graph)) == RC_OK);
+}
+
+static void assert_approvers(size_t const hash, size_t const *const expected, size_t const expected_num) {
+  iota_stor_pack_t pack;
+  bool found = false;
+  bool matched = false;
+
+  TEST_ASSERT(hash_pack_init(&pack, 2) == RC_OK);
+  while (true) {
+    TEST_ASSERT(tangle_graph_approvers_get(&graph, hashes[hash], &pack, 0, &found) == RC_OK);
+    TEST_ASSERT_TRUE(found);
+    if (!pack.insufficient_capacity) {
+      break;
+    }
+    TEST_ASSERT(hash_pack_resize(&pack, 2) == RC_OK);
+    pack.num_loaded = 0;
+  }
+
+  TEST_ASSERT_EQUAL_INT(expected_num, pack.num_loaded);
+  for (size_t i = 0; i < expected_num; i++) {
+    matched = false;
+    for (size_t j = 0; j < pack.num_loaded; j++) {
+      matched |= memcmp(pack.models[j], hashes[expected[i]], FLEX_TRIT_SIZE_243) == 0;
+    }
+    TEST_ASSERT_TRUE(matched);
+  }
+  hash_pack_free(&pack);
+}
+
+static void assert_exist(size_t const hash, bool const expected) {
+  bool exist = !expected;
+  bool found = false;
+
+  TEST_ASSERT(tangle_graph_transaction_exist(&graph, hashes[hash], &exist, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL(expected, exist);
+}
+
+void test_complete(void) {
+  iota_transaction_t tx;
+  uint64_t count = 0;
+  bool found = false;
+
+  TEST_ASSERT(tangle_graph_init(&graph, true) == RC_OK);
+
+  // 0 <- 1, 0 <- 2, 1 <- 3 -> 2, 3 <- 4 -> 3
+  transaction_add(1, 0, 0);
+  transaction_add(2, 0, 0);
+  transaction_add(3, 1, 2);
+  transaction_add(4, 3, 3);
+  TEST_ASSERT_EQUAL_INT(4, tangle_graph_size(&graph));
+
+  assert_approvers(0, (size_t[]){1, 2}, 2);
+  assert_approvers(1, (size_t[]){3}, 1);
+  assert_approvers(2, (size_t[]){3}, 1);
+  assert_approvers(3, (size_t[]){4}, 1);
+  assert_approvers(4, NULL, 0);
+  TEST_ASSERT(tangle_graph_approvers_count(&graph, hashes[0], &count, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL_INT(2, count);
+
+  // The genesis is only referenced, a complete graph knows it is not stored
+  assert_exist(0, false);
+  assert_exist(3, true);
+  assert_exist(6, false);
+
+  // Without an arrival timestamp, the database sets it so metadata of stored transactions are not known until loaded
+  transaction_reset(&tx);
+  TEST_ASSERT(tangle_graph_metadata_get(&graph, hashes[3], &tx, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+
+  // With one, they are known as soon as added
+  transaction_build(&tx, 5, 4, 4);
+  transaction_set_arrival_timestamp(&tx, 1000);
+  TEST_ASSERT(tangle_graph_transaction_add(&graph, &tx, tangle_graph_epoch(&graph)) == RC_OK);
+  transaction_reset(&tx);
+  TEST_ASSERT(tangle_graph_metadata_get(&graph, hashes[5], &tx, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL_INT(1000, transaction_arrival_timestamp(&tx));
+  TEST_ASSERT_EQUAL_INT(0, transaction_snapshot_index(&tx));
+  TEST_ASSERT_FALSE(transaction_solid(&tx));
+  TEST_ASSERT(tangle_graph_transaction_remove(&graph, hashes[5]) == RC_OK);
+  TEST_ASSERT(tangle_graph_solid_set(&graph, hashes[3], true) == RC_OK);
+  TEST_ASSERT(tangle_graph_snapshot_index_set(&graph, hashes[3], 42) == RC_OK);
+
+  // Deleting a transaction unlinks it from its approvees, approvers still reference it
+  TEST_ASSERT(tangle_graph_transaction_remove(&graph, hashes[1]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(3, tangle_graph_size(&graph));
+  assert_exist(1, false);
+  assert_approvers(0, (size_t[]){2}, 1);
+  assert_approvers(1, (size_t[]){3}, 1);
+
+  // Deleting every transaction frees all vertices
+  TEST_ASSERT(tangle_graph_transaction_remove(&graph, hashes[4]) == RC_OK);
+  TEST_ASSERT(tangle_graph_transaction_remove(&graph, hashes[3]) == RC_OK);
+  TEST_ASSERT(tangle_graph_transaction_remove(&graph, hashes[2]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, tangle_graph_size(&graph));
+  TEST_ASSERT_EQUAL_INT(0, graph.index_size);
+
+  TEST_ASSERT(tangle_graph_destroy(&graph) == RC_OK);
+}
+
+void test_fill(void) {
+  iota_transaction_t tx;
+  iota_stor_pack_t pack;
+  uint64_t epoch = 0;
+  bool exist = false;
+  bool found = true;
+
+  TEST_ASSERT(tangle_graph_init(&graph, false) == RC_OK);
+
+  // Approvers of a transaction of an existing database are unknown until loaded
+  transaction_add(2, 1, 1);
+  TEST_ASSERT(tangle_graph_approvers_get(&graph, hashes[1], NULL, 0, &found) == RC_NULL_PARAM);
+  TEST_ASSERT(hash_pack_init(&pack, 4) == RC_OK);
+  TEST_ASSERT(tangle_graph_approvers_get(&graph, hashes[1], &pack, 0, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+  TEST_ASSERT(tangle_graph_transaction_exist(&graph, hashes[1], &exist, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+
+  // A fill from a read older than an update is discarded
+  epoch = tangle_graph_epoch(&graph);
+  memcpy(pack.models[0], hashes[2], FLEX_TRIT_SIZE_243);
+  memcpy(pack.models[1], hashes[3], FLEX_TRIT_SIZE_243);
+  pack.num_loaded = 2;
+  TEST_ASSERT(tangle_graph_solid_set(&graph, hashes[2], true) == RC_OK);
+  TEST_ASSERT(tangle_graph_approvers_fill(&graph, hashes[1], &pack, epoch) == RC_OK);
+  hash_pack_reset(&pack);
+  TEST_ASSERT(tangle_graph_approvers_get(&graph, hashes[1], &pack, 0, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+
+  // Approver 2 is already linked and not added twice
+  epoch = tangle_graph_epoch(&graph);
+  memcpy(pack.models[0], hashes[2], FLEX_TRIT_SIZE_243);
+  memcpy(pack.models[1], hashes[3], FLEX_TRIT_SIZE_243);
+  pack.num_loaded = 2;
+  TEST_ASSERT(tangle_graph_approvers_fill(&graph, hashes[1], &pack, epoch) == RC_OK);
+  assert_approvers(1, (size_t[]){2, 3}, 2);
+  assert_exist(3, true);
+
+  // Trunk and branch of 3 are partially known from the approvers of 1 and completed by a load
+  epoch = tangle_graph_epoch(&graph);
+  transaction_build(&tx, 3, 4, 1);
+  transaction_set_snapshot_index(&tx, 7);
+  transaction_set_solid(&tx, true);
+  transaction_set_validity(&tx, 1);
+  transaction_set_arrival_timestamp(&tx, 1000);
+  TEST_ASSERT(tangle_graph_transaction_fill(&graph, hashes[3], &tx, epoch) == RC_OK);
+  assert_approvers(1, (size_t[]){2, 3}, 2);
+  TEST_ASSERT(tangle_graph_approvers_get(&graph, hashes[4], &pack, 0, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+
+  transaction_reset(&tx);
+  TEST_ASSERT(tangle_graph_metadata_get(&graph, hashes[3], &tx, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL_INT(7, transaction_snapshot_index(&tx));
+  TEST_ASSERT_TRUE(transaction_solid(&tx));
+  TEST_ASSERT_EQUAL_INT(1, transaction_validity(&tx));
+  TEST_ASSERT_EQUAL_INT(1000, transaction_arrival_timestamp(&tx));
+
+  TEST_ASSERT(tangle_graph_metadata_clear(&graph) == RC_OK);
+  TEST_ASSERT(tangle_graph_metadata_get(&graph, hashes[3], &tx, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL_INT(0, transaction_snapshot_index(&tx));
+  TEST_ASSERT_FALSE(transaction_solid(&tx));
+
+  hash_pack_free(&pack);
+  TEST_ASSERT(tangle_graph_destroy(&graph) == RC_OK);
+}
+
+void test_growth(void) {
+  TEST_ASSERT(tangle_graph_init(&graph, true) == RC_OK);
+
+  // Every transaction approves the two previous ones
+  for (size_t i = 2; i < HASHES_NUM; i++) {
+    transaction_add(i, i - 1, i - 2);
+  }
+  TEST_ASSERT_EQUAL_INT(HASHES_NUM - 2, tangle_graph_size(&graph));
+
+  assert_approvers(0, (size_t[]){2}, 1);
+  for (size_t i = 1; i < HASHES_NUM - 2; i++) {
+    assert_approvers(i, (size_t[]){i + 1, i + 2}, 2);
+  }
+
+  for (size_t i = 2; i < HASHES_NUM; i++) {
+    TEST_ASSERT(tangle_graph_transaction_remove(&graph, hashes[i]) == RC_OK);
+  }
+  TEST_ASSERT_EQUAL_INT(0, graph.index_size);
+
+  TEST_ASSERT(tangle_graph_destroy(&graph) == RC_OK);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    memset(hashes[i], 0, FLEX_TRIT_SIZE_243);
+    memcpy(hashes[i], &i, sizeof(i));
+  }
+
+  RUN_TEST(test_complete);
+  RUN_TEST(test_fill);
+  RUN_TEST(test_growth);
+
+  return UNITY_END();
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/consensus/tangle/partial_cache.h"
+
+#define HASHES_NUM 256
+
+static flex_trit_t hashes[HASHES_NUM][FLEX_TRIT_SIZE_243];
+static tangle_partial_cache_t cache;
+
+static void transaction_build_essence_attachment(iota_transaction_t *const tx, size_t const hash) {
+  transaction_set_address(tx, hashes[hash]);
+  transaction_set_value(tx, -(int64_t)hash);
+  transaction_set_obsolete_tag(tx, hashes[hash]);
+  transaction_set_timestamp(tx, hash);
+  transaction_set_current_index(tx, 0);
+  transaction_set_last_index(tx, 1);
+  transaction_set_bundle(tx, hashes[hash]);
+  transaction_set_trunk(tx, hashes[(hash + 1) % HASHES_NUM]);
+  transaction_set_branch(tx, hashes[(hash + 2) % HASHES_NUM]);
+  transaction_set_attachment_timestamp(tx, hash);
+  transaction_set_attachment_timestamp_lower(tx, 0);
+  transaction_set_attachment_timestamp_upper(tx, hash + 1);
+  transaction_set_nonce(tx, hashes[hash]);
+  transaction_set_tag(tx, hashes[hash]);
+}
+
+static void transaction_build_metadata(iota_transaction_t *const tx, size_t const hash) {
+  transaction_set_snapshot_index(tx, hash + 1);
+  transaction_set_solid(tx, hash % 2);
+  transaction_set_validity(tx, 1);
+  transaction_set_arrival_timestamp(tx, hash + 2);
+}
+
+static void transaction_build(iota_transaction_t *const tx, size_t const hash) {
+  transaction_reset(tx);
+  transaction_set_hash(tx, hashes[hash]);
+  transaction_build_essence_attachment(tx, hash);
+  transaction_build_metadata(tx, hash);
+}
+
+static void transaction_put(size_t const hash) {
+  iota_transaction_t tx;
+
+  transaction_build(&tx, hash);
+  TEST_ASSERT(tangle_partial_cache_put(&cache, hashes[hash], &tx, tangle_partial_cache_epoch(&cache)) == RC_OK);
+}
+
+static bool transaction_get(size_t const hash, tangle_partial_cache_model_t const model, iota_transaction_t *const tx) {
+  bool found = false;
+
+  TEST_ASSERT(tangle_partial_cache_get(&cache, hashes[hash], model, tx, &found) == RC_OK);
+
+  return found;
+}
+
+void test_models(void) {
+  iota_transaction_t tx;
+  iota_transaction_t expected;
+  tangle_partial_cache_stats_t stats;
+
+  TEST_ASSERT(tangle_partial_cache_init(&cache, HASHES_NUM, 4) == RC_OK);
+
+  transaction_build(&expected, 0);
+  TEST_ASSERT_FALSE(transaction_get(0, TANGLE_PARTIAL_CACHE_METADATA, &tx));
+  transaction_put(0);
+
+  TEST_ASSERT_TRUE(transaction_get(0, TANGLE_PARTIAL_CACHE_METADATA, &tx));
+  TEST_ASSERT_EQUAL_MEMORY(&expected.metadata, &tx.metadata, sizeof(iota_transaction_fields_metadata_t));
+  TEST_ASSERT_EQUAL_INT(MASK_METADATA_ALL, tx.loaded_columns_mask.metadata);
+  TEST_ASSERT_EQUAL_INT(0, tx.loaded_columns_mask.essence);
+
+  TEST_ASSERT_TRUE(transaction_get(0, TANGLE_PARTIAL_CACHE_ESSENCE_ATTACHMENT_METADATA, &tx));
+  TEST_ASSERT_EQUAL_MEMORY(&expected.essence, &tx.essence, sizeof(iota_transaction_fields_essence_t));
+  TEST_ASSERT_EQUAL_MEMORY(&expected.attachment, &tx.attachment, sizeof(iota_transaction_fields_attachment_t));
+  TEST_ASSERT_EQUAL_MEMORY(&expected.metadata, &tx.metadata, sizeof(iota_transaction_fields_metadata_t));
+  TEST_ASSERT_EQUAL_INT(MASK_ATTACHMENT_ALL, tx.loaded_columns_mask.attachment);
+  TEST_ASSERT_EQUAL_INT(0, tx.loaded_columns_mask.consensus);
+
+  TEST_ASSERT_TRUE(transaction_get(0, TANGLE_PARTIAL_CACHE_ESSENCE_CONSENSUS, &tx));
+  TEST_ASSERT_EQUAL_MEMORY(hashes[0], transaction_hash(&tx), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_INT(MASK_CONSENSUS_ALL, tx.loaded_columns_mask.consensus);
+  TEST_ASSERT_EQUAL_INT(0, tx.loaded_columns_mask.metadata);
+
+  // Only metadata is known, models also needing the essence miss until it is put
+  transaction_reset(&tx);
+  transaction_build_metadata(&tx, 1);
+  TEST_ASSERT(tangle_partial_cache_put(&cache, hashes[1], &tx, tangle_partial_cache_epoch(&cache)) == RC_OK);
+  TEST_ASSERT_TRUE(transaction_get(1, TANGLE_PARTIAL_CACHE_METADATA, &tx));
+  TEST_ASSERT_FALSE(transaction_get(1, TANGLE_PARTIAL_CACHE_ESSENCE_METADATA, &tx));
+  transaction_reset(&tx);
+  transaction_build_essence_attachment(&tx, 1);
+  TEST_ASSERT(tangle_partial_cache_put(&cache, hashes[1], &tx, tangle_partial_cache_epoch(&cache)) == RC_OK);
+  TEST_ASSERT_TRUE(transaction_get(1, TANGLE_PARTIAL_CACHE_ESSENCE_METADATA, &tx));
+  TEST_ASSERT_EQUAL_INT(1 + 1, transaction_snapshot_index(&tx));
+
+  TEST_ASSERT(tangle_partial_cache_stats(&cache, &stats) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(2, stats.size);
+  TEST_ASSERT_EQUAL_INT(2, stats.hit[TANGLE_PARTIAL_CACHE_METADATA]);
+  TEST_ASSERT_EQUAL_INT(1, stats.miss[TANGLE_PARTIAL_CACHE_METADATA]);
+  TEST_ASSERT_EQUAL_INT(1, stats.hit[TANGLE_PARTIAL_CACHE_ESSENCE_METADATA]);
+  TEST_ASSERT_EQUAL_INT(1, stats.miss[TANGLE_PARTIAL_CACHE_ESSENCE_METADATA]);
+  TEST_ASSERT_EQUAL_INT(1, stats.hit[TANGLE_PARTIAL_CACHE_ESSENCE_ATTACHMENT_METADATA]);
+  TEST_ASSERT_EQUAL_INT(1, stats.hit[TANGLE_PARTIAL_CACHE_ESSENCE_CONSENSUS]);
+
+  TEST_ASSERT(tangle_partial_cache_destroy(&cache) == RC_OK);
+}
+
+void test_invalidation(void) {
+  iota_transaction_t tx;
+  uint64_t epoch = 0;
+  tangle_partial_cache_stats_t stats;
+
+  TEST_ASSERT(tangle_partial_cache_init(&cache, HASHES_NUM, 4) == RC_OK);
+
+  transaction_put(0);
+  transaction_put(1);
+  TEST_ASSERT(tangle_partial_cache_invalidate(&cache, hashes[0]) == RC_OK);
+  TEST_ASSERT_FALSE(transaction_get(0, TANGLE_PARTIAL_CACHE_METADATA, &tx));
+  TEST_ASSERT_TRUE(transaction_get(1, TANGLE_PARTIAL_CACHE_METADATA, &tx));
+
+  // A transaction loaded before an invalidation may be stale and is not put
+  epoch = tangle_partial_cache_epoch(&cache);
+  TEST_ASSERT(tangle_partial_cache_invalidate(&cache, hashes[2]) == RC_OK);
+  transaction_build(&tx, 0);
+  TEST_ASSERT(tangle_partial_cache_put(&cache, hashes[0], &tx, epoch) == RC_OK);
+  TEST_ASSERT_FALSE(transaction_get(0, TANGLE_PARTIAL_CACHE_METADATA, &tx));
+
+  TEST_ASSERT(tangle_partial_cache_clear(&cache) == RC_OK);
+  TEST_ASSERT_FALSE(transaction_get(1, TANGLE_PARTIAL_CACHE_METADATA, &tx));
+
+  TEST_ASSERT(tangle_partial_cache_stats(&cache, &stats) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, stats.size);
+  TEST_ASSERT_EQUAL_INT(2, stats.invalidations);
+
+  TEST_ASSERT(tangle_partial_cache_destroy(&cache) == RC_OK);
+}
+
+void test_eviction(void) {
+  iota_transaction_t tx;
+  tangle_partial_cache_stats_t stats;
+  size_t found = 0;
+
+  TEST_ASSERT(tangle_partial_cache_init(&cache, HASHES_NUM / 4, 2) == RC_OK);
+
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    transaction_put(i);
+  }
+
+  TEST_ASSERT(tangle_partial_cache_stats(&cache, &stats) == RC_OK);
+  TEST_ASSERT_TRUE(stats.size <= cache.capacity);
+  TEST_ASSERT_EQUAL_INT(HASHES_NUM, stats.size + stats.evictions);
+
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    if (transaction_get(i, TANGLE_PARTIAL_CACHE_METADATA, &tx)) {
+      TEST_ASSERT_EQUAL_INT(i + 1, transaction_snapshot_index(&tx));
+      found++;
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(stats.size, found);
+
+  TEST_ASSERT(tangle_partial_cache_destroy(&cache) == RC_OK);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    memset(hashes[i], 0, FLEX_TRIT_SIZE_243);
+    memcpy(hashes[i], &i, sizeof(i));
+  }
+
+  RUN_TEST(test_models);
+  RUN_TEST(test_invalidation);
+  RUN_TEST(test_eviction);
+
+  return UNITY_END();
+}
@@ -5,12 +5,16 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdio.h>
+
 #include <unity/unity.h>
 
 #include "ciri/consensus/test_utils/bundle.h"
 #include "ciri/consensus/test_utils/tangle.h"
 
 static char *tangle_test_db_path = "ciri/consensus/tangle/tests/test.db";
+static char *tangle_test_filter_path = "ciri/consensus/tangle/tests/test.filter";
+static char *tangle_test_other_db_path = "ciri/consensus/tangle/tests/test.other.db";
 static storage_connection_config_t config;
 static tangle_t tangle;
 
@@ -160,6 +164,137 @@ void test_bundle_load_not_a_tail(void) {
   transactions_free(txs, 4);
 }
 
+void test_filter(void) {
+  iota_transaction_t *txs[4];
+  flex_trit_t hashes[4][FLEX_TRIT_SIZE_243];
+  flex_trit_t unknown[FLEX_TRIT_SIZE_243];
+  tryte_t const *const txs_trytes[4] = {TX_1_OF_4_VALUE_BUNDLE_TRYTES, TX_2_OF_4_VALUE_BUNDLE_TRYTES,
+                                        TX_3_OF_4_VALUE_BUNDLE_TRYTES, TX_4_OF_4_VALUE_BUNDLE_TRYTES};
+  tryte_t const *const hashes_trytes[4] = {TX_1_OF_4_HASH, TX_2_OF_4_HASH, TX_3_OF_4_HASH, TX_4_OF_4_HASH};
+  tangle_filter_stats_t stats;
+  hash243_set_t deleted = NULL;
+  bool exist = false;
+
+  transactions_deserialize(txs_trytes, txs, 4, true);
+  for (size_t i = 0; i < 4; i++) {
+    flex_trits_from_trytes(hashes[i], HASH_LENGTH_TRIT, hashes_trytes[i], HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  }
+  memset(unknown, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+
+  // The filter is rebuilt from the transactions already stored and maintained by the following ones
+  TEST_ASSERT(build_tangle(&tangle, txs, 2) == RC_OK);
+  TEST_ASSERT(iota_tangle_filter_enable(&tangle, tangle_test_filter_path, 1024, 0.001) == RC_OK);
+  TEST_ASSERT(build_tangle(&tangle, txs + 2, 2) == RC_OK);
+  for (size_t i = 0; i < 4; i++) {
+    TEST_ASSERT(iota_tangle_transaction_exist(&tangle, TRANSACTION_FIELD_HASH, hashes[i], &exist) == RC_OK);
+    TEST_ASSERT_TRUE(exist);
+  }
+  TEST_ASSERT(iota_tangle_transaction_exist(&tangle, TRANSACTION_FIELD_HASH, unknown, &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+  TEST_ASSERT_TRUE(iota_tangle_filter_stats(&stats));
+  TEST_ASSERT_EQUAL_INT(4, stats.size);
+  TEST_ASSERT_EQUAL_INT(5, stats.hit + stats.miss);
+
+  // The filter is saved when disabled and loaded back as long as the database wasn't written to
+  TEST_ASSERT(iota_tangle_filter_disable(&tangle) == RC_OK);
+  TEST_ASSERT_FALSE(iota_tangle_filter_stats(&stats));
+  TEST_ASSERT(iota_tangle_filter_enable(&tangle, tangle_test_filter_path, 1024, 0.001) == RC_OK);
+  TEST_ASSERT_NULL(fopen(tangle_test_filter_path, "r"));
+  TEST_ASSERT_TRUE(iota_tangle_filter_stats(&stats));
+  TEST_ASSERT_EQUAL_INT(4, stats.size);
+
+  // Only the fingerprints of transactions actually deleted are removed
+  TEST_ASSERT(hash243_set_add(&deleted, hashes[0]) == RC_OK);
+  TEST_ASSERT(hash243_set_add(&deleted, unknown) == RC_OK);
+  TEST_ASSERT(iota_tangle_transactions_delete(&tangle, deleted) == RC_OK);
+  TEST_ASSERT(iota_tangle_transactions_delete(&tangle, deleted) == RC_OK);
+  TEST_ASSERT_TRUE(iota_tangle_filter_stats(&stats));
+  TEST_ASSERT_EQUAL_INT(3, stats.size);
+  TEST_ASSERT(iota_tangle_transaction_exist(&tangle, TRANSACTION_FIELD_HASH, hashes[0], &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+  for (size_t i = 1; i < 4; i++) {
+    TEST_ASSERT(iota_tangle_transaction_exist(&tangle, TRANSACTION_FIELD_HASH, hashes[i], &exist) == RC_OK);
+    TEST_ASSERT_TRUE(exist);
+  }
+
+  // A failed store leaves the filter as it was
+  TEST_ASSERT(iota_tangle_transaction_store(&tangle, txs[1]) != RC_OK);
+  TEST_ASSERT_TRUE(iota_tangle_filter_stats(&stats));
+  TEST_ASSERT_EQUAL_INT(3, stats.size);
+
+  TEST_ASSERT(iota_tangle_filter_disable(&tangle) == RC_OK);
+  remove(tangle_test_filter_path);
+
+  hash243_set_free(&deleted);
+  transactions_free(txs, 4);
+}
+
+void test_graph_other_database(void) {
+  storage_connection_config_t other_config = {.db_path = tangle_test_other_db_path};
+  tangle_t same, other;
+
+  TEST_ASSERT(tangle_setup(&other, &other_config, tangle_test_other_db_path) == RC_OK);
+  TEST_ASSERT(iota_tangle_graph_enable(&tangle) == RC_OK);
+
+  // The graph is only shared with tangles of the database it was enabled for
+  TEST_ASSERT(iota_tangle_init(&same, &config) == RC_OK);
+  TEST_ASSERT_NOT_NULL(same.graph);
+  TEST_ASSERT(iota_tangle_destroy(&same) == RC_OK);
+  TEST_ASSERT(iota_tangle_init(&same, &other_config) == RC_OK);
+  TEST_ASSERT_NULL(same.graph);
+  TEST_ASSERT(iota_tangle_destroy(&same) == RC_OK);
+  TEST_ASSERT(iota_tangle_graph_enable(&other) == RC_TANGLE_OTHER_DATABASE);
+  TEST_ASSERT_NULL(other.graph);
+  TEST_ASSERT(iota_tangle_graph_disable(&other) == RC_TANGLE_OTHER_DATABASE);
+
+  TEST_ASSERT(iota_tangle_graph_disable(&tangle) == RC_OK);
+  TEST_ASSERT(tangle_cleanup(&other, tangle_test_other_db_path) == RC_OK);
+}
+
+void test_cache_other_database(void) {
+  storage_connection_config_t other_config = {.db_path = tangle_test_other_db_path};
+  tangle_t same, other;
+
+  TEST_ASSERT(tangle_setup(&other, &other_config, tangle_test_other_db_path) == RC_OK);
+  TEST_ASSERT(iota_tangle_cache_enable(&tangle, 1024) == RC_OK);
+
+  // The cache is only shared with tangles of the database it was enabled for
+  TEST_ASSERT(iota_tangle_init(&same, &config) == RC_OK);
+  TEST_ASSERT_NOT_NULL(same.cache);
+  TEST_ASSERT(iota_tangle_destroy(&same) == RC_OK);
+  TEST_ASSERT(iota_tangle_init(&same, &other_config) == RC_OK);
+  TEST_ASSERT_NULL(same.cache);
+  TEST_ASSERT(iota_tangle_destroy(&same) == RC_OK);
+  TEST_ASSERT(iota_tangle_cache_enable(&other, 1024) == RC_TANGLE_OTHER_DATABASE);
+  TEST_ASSERT_NULL(other.cache);
+  TEST_ASSERT(iota_tangle_cache_disable(&other) == RC_TANGLE_OTHER_DATABASE);
+
+  TEST_ASSERT(iota_tangle_cache_disable(&tangle) == RC_OK);
+  TEST_ASSERT(tangle_cleanup(&other, tangle_test_other_db_path) == RC_OK);
+}
+
+void test_filter_other_database(void) {
+  storage_connection_config_t other_config = {.db_path = tangle_test_other_db_path};
+  tangle_t same, other;
+
+  TEST_ASSERT(tangle_setup(&other, &other_config, tangle_test_other_db_path) == RC_OK);
+  TEST_ASSERT(iota_tangle_filter_enable(&tangle, NULL, 1024, 0.001) == RC_OK);
+
+  // The filter is only shared with tangles of the database it was enabled for
+  TEST_ASSERT(iota_tangle_init(&same, &config) == RC_OK);
+  TEST_ASSERT_NOT_NULL(same.filter);
+  TEST_ASSERT(iota_tangle_destroy(&same) == RC_OK);
+  TEST_ASSERT(iota_tangle_init(&same, &other_config) == RC_OK);
+  TEST_ASSERT_NULL(same.filter);
+  TEST_ASSERT(iota_tangle_destroy(&same) == RC_OK);
+  TEST_ASSERT(iota_tangle_filter_enable(&other, NULL, 1024, 0.001) == RC_TANGLE_OTHER_DATABASE);
+  TEST_ASSERT_NULL(other.filter);
+  TEST_ASSERT(iota_tangle_filter_disable(&other) == RC_TANGLE_OTHER_DATABASE);
+
+  TEST_ASSERT(iota_tangle_filter_disable(&tangle) == RC_OK);
+  TEST_ASSERT(tangle_cleanup(&other, tangle_test_other_db_path) == RC_OK);
+}
+
 int main(void) {
   UNITY_BEGIN();
   TEST_ASSERT(storage_init() == RC_OK);
@@ -174,6 +309,12 @@ int main(void) {
   RUN_TEST(test_bundle_load_unknown_tx);
   RUN_TEST(test_bundle_load_not_a_tail);
 
+  RUN_TEST(test_filter);
+
+  RUN_TEST(test_graph_other_database);
+  RUN_TEST(test_cache_other_database);
+  RUN_TEST(test_filter_other_database);
+
   TEST_ASSERT(storage_destroy() == RC_OK);
   return UNITY_END();
 }
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/consensus/tangle/traversal.h"
+#include "ciri/consensus/test_utils/bundle.h"
+#include "ciri/consensus/test_utils/tangle.h"
+
+static char *tangle_test_db_path = "ciri/consensus/tangle/tests/test.db";
+static storage_connection_config_t config;
+static tangle_t tangle;
+static iota_transaction_t *txs[4];
+static flex_trit_t hashes[4][FLEX_TRIT_SIZE_243];
+static flex_trit_t null_hash[FLEX_TRIT_SIZE_243];
+
+typedef struct visit_params_s {
+  size_t visited;
+  size_t loaded;
+  size_t stop_after;
+  hash243_set_t visited_hashes;
+} visit_params_t;
+
+static retcode_t visit_do_func(flex_trit_t *hash, iota_stor_pack_t *pack, void *data, bool *should_branch,
+                               bool *should_stop) {
+  visit_params_t *params = data;
+
+  // A transaction must never be visited twice
+  TEST_ASSERT_FALSE(hash243_set_contains(params->visited_hashes, hash));
+  TEST_ASSERT(hash243_set_add(&params->visited_hashes, hash) == RC_OK);
+
+  params->visited++;
+  if (pack->num_loaded == 1) {
+    params->loaded++;
+  }
+  *should_branch = true;
+  *should_stop = params->visited == params->stop_after;
+
+  return RC_OK;
+}
+
+void setUp(void) {
+  tryte_t const *const txs_trytes[4] = {TX_1_OF_4_VALUE_BUNDLE_TRYTES, TX_2_OF_4_VALUE_BUNDLE_TRYTES,
+                                        TX_3_OF_4_VALUE_BUNDLE_TRYTES, TX_4_OF_4_VALUE_BUNDLE_TRYTES};
+  tryte_t const *const hashes_trytes[4] = {TX_1_OF_4_HASH, TX_2_OF_4_HASH, TX_3_OF_4_HASH, TX_4_OF_4_HASH};
+
+  TEST_ASSERT(tangle_setup(&tangle, &config, tangle_test_db_path) == RC_OK);
+  transactions_deserialize(txs_trytes, txs, 4, true);
+  TEST_ASSERT(build_tangle(&tangle, txs, 4) == RC_OK);
+  for (size_t i = 0; i < 4; i++) {
+    flex_trits_from_trytes(hashes[i], HASH_LENGTH_TRIT, hashes_trytes[i], HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  }
+  memset(null_hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+}
+
+void tearDown(void) {
+  transactions_free(txs, 4);
+  TEST_ASSERT(tangle_cleanup(&tangle, tangle_test_db_path) == RC_OK);
+}
+
+void test_traversal_to_past(void) {
+  visit_params_t params = {.visited = 0, .loaded = 0, .stop_after = 0, .visited_hashes = NULL};
+  hash243_set_t analyzed_hashes = NULL;
+
+  TEST_ASSERT(tangle_traversal_dfs_to_past(&tangle, visit_do_func, hashes[0], null_hash, &analyzed_hashes, &params) ==
+              RC_OK);
+
+  // The whole bundle is loaded, the transactions it approves are visited but missing
+  TEST_ASSERT_EQUAL_INT(4, params.loaded);
+  TEST_ASSERT(params.visited > params.loaded);
+  for (size_t i = 0; i < 4; i++) {
+    TEST_ASSERT_TRUE(hash243_set_contains(analyzed_hashes, hashes[i]));
+  }
+  // Missing transactions are not analyzed, only the bundle and the genesis are
+  TEST_ASSERT_EQUAL_INT(5, hash243_set_size(analyzed_hashes));
+
+  hash243_set_free(&params.visited_hashes);
+  hash243_set_free(&analyzed_hashes);
+}
+
+void test_traversal_to_past_analyzed(void) {
+  visit_params_t params = {.visited = 0, .loaded = 0, .stop_after = 0, .visited_hashes = NULL};
+  hash243_set_t analyzed_hashes = NULL;
+
+  // Transactions already analyzed are neither visited nor branched from
+  TEST_ASSERT(hash243_set_add(&analyzed_hashes, hashes[2]) == RC_OK);
+  TEST_ASSERT(tangle_traversal_dfs_to_past(&tangle, visit_do_func, hashes[0], null_hash, &analyzed_hashes, &params) ==
+              RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(2, params.loaded);
+  TEST_ASSERT_FALSE(hash243_set_contains(params.visited_hashes, hashes[2]));
+  TEST_ASSERT_FALSE(hash243_set_contains(params.visited_hashes, hashes[3]));
+
+  hash243_set_free(&params.visited_hashes);
+  hash243_set_free(&analyzed_hashes);
+}
+
+void test_traversal_to_past_stop(void) {
+  visit_params_t params = {.visited = 0, .loaded = 0, .stop_after = 2, .visited_hashes = NULL};
+
+  TEST_ASSERT(tangle_traversal_dfs_to_past(&tangle, visit_do_func, hashes[0], null_hash, NULL, &params) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(2, params.visited);
+
+  hash243_set_free(&params.visited_hashes);
+}
+
+void test_traversal_to_future(void) {
+  visit_params_t params = {.visited = 0, .loaded = 0, .stop_after = 0, .visited_hashes = NULL};
+  hash243_set_t analyzed_hashes = NULL;
+
+  TEST_ASSERT(tangle_traversal_dfs_to_future(&tangle, visit_do_func, hashes[3], &analyzed_hashes, &params) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(4, params.visited);
+  TEST_ASSERT_EQUAL_INT(4, params.loaded);
+  for (size_t i = 0; i < 4; i++) {
+    TEST_ASSERT_TRUE(hash243_set_contains(analyzed_hashes, hashes[i]));
+  }
+
+  hash243_set_free(&params.visited_hashes);
+  hash243_set_free(&analyzed_hashes);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  TEST_ASSERT(storage_init() == RC_OK);
+
+  config.db_path = tangle_test_db_path;
+
+  RUN_TEST(test_traversal_to_past);
+  RUN_TEST(test_traversal_to_past_analyzed);
+  RUN_TEST(test_traversal_to_past_stop);
+  RUN_TEST(test_traversal_to_future);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
@@ -5,139 +5,377 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "xxhash.h"
+
 #include "ciri/consensus/tangle/traversal.h"
 #include "ciri/storage/defs.h"
 #include "ciri/storage/pack.h"
-#include "utils/containers/hash/hash243_stack.h"
 
-retcode_t tangle_traversal_dfs_to_past(tangle_t const *const tangle, tangle_traversal_functor func,
-                                       flex_trit_t const *const entry_point, flex_trit_t const *const genesis_hash,
-                                       hash243_set_t *analyzed_hashes_param, void *data) {
-  retcode_t ret = RC_OK;
-  hash243_stack_t non_analyzed_hashes = NULL;
-  hash243_set_t analyzed_hashes_local = NULL;
-  hash243_set_t *analyzed_hashes = analyzed_hashes_param ? analyzed_hashes_param : &analyzed_hashes_local;
-  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
+// Maximum number of transactions of a layer loaded by a single batch
+#define TANGLE_TRAVERSAL_BATCH_SIZE 256
+#define TANGLE_TRAVERSAL_VISITED_INITIAL_CAPACITY 64
 
+typedef enum tangle_traversal_direction_e {
+  TANGLE_TRAVERSAL_TO_PAST,
+  TANGLE_TRAVERSAL_TO_FUTURE,
+} tangle_traversal_direction_t;
+
+/*
+ * Open addressing set of the hashes already enqueued by a traversal
+ * A null digest marks an empty slot
+ */
+
+typedef struct tangle_traversal_slot_s {
+  uint64_t digest;
   flex_trit_t hash[FLEX_TRIT_SIZE_243];
-  if ((ret = hash243_stack_push(&non_analyzed_hashes, entry_point)) != RC_OK) {
-    return ret;
+} tangle_traversal_slot_t;
+
+typedef struct tangle_traversal_visited_s {
+  tangle_traversal_slot_t *slots;
+  size_t capacity;
+  size_t size;
+} tangle_traversal_visited_t;
+
+/*
+ * A layer of the traversal, its entries are linked by batches into the circular lists expected by the tangle
+ */
+
+typedef struct tangle_traversal_layer_s {
+  hash243_queue_entry_t *entries;
+  size_t capacity;
+  size_t size;
+} tangle_traversal_layer_t;
+
+typedef struct tangle_traversal_s {
+  tangle_t const *tangle;
+  tangle_traversal_functor func;
+  tangle_traversal_direction_t direction;
+  hash243_set_t *analyzed_hashes;
+  void *data;
+  tangle_traversal_visited_t visited;
+  tangle_traversal_layer_t current;
+  tangle_traversal_layer_t next;
+  iota_transaction_t *txs;
+  iota_transaction_t **txs_ptrs;
+  size_t txs_capacity;
+  iota_stor_pack_t approvers;
+} tangle_traversal_t;
+
+static inline uint64_t visited_digest(flex_trit_t const *const hash) {
+  return XXH64(hash, FLEX_TRIT_SIZE_243, 0) | 1;
+}
+
+static retcode_t visited_resize(tangle_traversal_visited_t *const visited, size_t const capacity) {
+  tangle_traversal_slot_t *slots = NULL;
+  size_t mask = capacity - 1;
+
+  if ((slots = (tangle_traversal_slot_t *)calloc(capacity, sizeof(tangle_traversal_slot_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  for (size_t i = 0; i < visited->capacity; i++) {
+    if (visited->slots[i].digest != 0) {
+      size_t j = visited->slots[i].digest & mask;
+      while (slots[j].digest != 0) {
+        j = (j + 1) & mask;
+      }
+      slots[j] = visited->slots[i];
+    }
+  }
+
+  free(visited->slots);
+  visited->slots = slots;
+  visited->capacity = capacity;
+
+  return RC_OK;
+}
+
+static retcode_t visited_add(tangle_traversal_visited_t *const visited, flex_trit_t const *const hash,
+                             bool *const added) {
+  retcode_t ret = RC_OK;
+  uint64_t digest = visited_digest(hash);
+  size_t mask = 0;
+  size_t i = 0;
+
+  *added = false;
+
+  // Keeps the load factor under 3/4 so that probe sequences stay short
+  if (4 * (visited->size + 1) > 3 * visited->capacity) {
+    if ((ret = visited_resize(visited, visited->capacity ? 2 * visited->capacity
+                                                         : TANGLE_TRAVERSAL_VISITED_INITIAL_CAPACITY)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  mask = visited->capacity - 1;
+  for (i = digest & mask; visited->slots[i].digest != 0; i = (i + 1) & mask) {
+    if (visited->slots[i].digest == digest && memcmp(visited->slots[i].hash, hash, FLEX_TRIT_SIZE_243) == 0) {
+      return RC_OK;
+    }
+  }
+
+  visited->slots[i].digest = digest;
+  memcpy(visited->slots[i].hash, hash, FLEX_TRIT_SIZE_243);
+  visited->size++;
+  *added = true;
+
+  return RC_OK;
+}
+
+static retcode_t layer_push(tangle_traversal_layer_t *const layer, flex_trit_t const *const hash) {
+  if (layer->size == layer->capacity) {
+    size_t capacity = layer->capacity ? 2 * layer->capacity : TANGLE_TRAVERSAL_VISITED_INITIAL_CAPACITY;
+    hash243_queue_entry_t *entries = NULL;
+
+    if ((entries = (hash243_queue_entry_t *)realloc(layer->entries, capacity * sizeof(hash243_queue_entry_t))) ==
+        NULL) {
+      return RC_OOM;
+    }
+    layer->entries = entries;
+    layer->capacity = capacity;
   }
-  if ((ret = hash243_set_add(analyzed_hashes, genesis_hash)) != RC_OK) {
+
+  memcpy(layer->entries[layer->size++].hash, hash, FLEX_TRIT_SIZE_243);
+
+  return RC_OK;
+}
+
+/**
+ * Links a batch of entries of a layer into a circular list without any allocation
+ */
+static hash243_queue_t layer_batch(tangle_traversal_layer_t *const layer, size_t const offset, size_t const count) {
+  hash243_queue_entry_t *entries = layer->entries + offset;
+
+  for (size_t i = 0; i < count; i++) {
+    entries[i].next = &entries[(i + 1) % count];
+    entries[i].prev = &entries[(i + count - 1) % count];
+  }
+
+  return entries;
+}
+
+static retcode_t traversal_enqueue(tangle_traversal_t *const traversal, flex_trit_t const *const hash) {
+  retcode_t ret = RC_OK;
+  bool added = false;
+
+  if (hash243_set_contains(*traversal->analyzed_hashes, hash)) {
+    return RC_OK;
+  }
+  if ((ret = visited_add(&traversal->visited, hash, &added)) != RC_OK || !added) {
     return ret;
   }
 
-  bool should_branch = true;
-  bool should_stop = false;
+  return layer_push(&traversal->next, hash);
+}
 
-  while (non_analyzed_hashes != NULL) {
-    memcpy(hash, hash243_stack_peek(non_analyzed_hashes), FLEX_TRIT_SIZE_243);
-    hash243_stack_pop(&non_analyzed_hashes);
-    if (!hash243_set_contains(*analyzed_hashes, hash)) {
-      hash_pack_reset(&pack);
-      if ((ret = iota_tangle_transaction_load_partial(tangle, hash, &pack,
-                                                      PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA)) != RC_OK) {
-        break;
-      }
+static retcode_t traversal_reserve_txs(tangle_traversal_t *const traversal, size_t const count) {
+  iota_transaction_t *txs = NULL;
+  iota_transaction_t **txs_ptrs = NULL;
 
-      if ((ret = func(hash, &pack, data, &should_branch, &should_stop)) != RC_OK) {
-        break;
-      }
+  if (count <= traversal->txs_capacity) {
+    return RC_OK;
+  }
 
-      if (should_stop) {
-        break;
-      }
+  if ((txs = (iota_transaction_t *)realloc(traversal->txs, count * sizeof(iota_transaction_t))) == NULL) {
+    return RC_OOM;
+  }
+  traversal->txs = txs;
+  if ((txs_ptrs = (iota_transaction_t **)realloc(traversal->txs_ptrs, count * sizeof(iota_transaction_t *))) ==
+      NULL) {
+    return RC_OOM;
+  }
+  traversal->txs_ptrs = txs_ptrs;
 
-      if (should_branch) {
-        if ((ret = hash243_stack_push(&non_analyzed_hashes, transaction_branch(&tx))) != RC_OK) {
-          break;
-        }
-        if ((ret = hash243_stack_push(&non_analyzed_hashes, transaction_trunk(&tx))) != RC_OK) {
-          break;
-        }
-      }
-      if ((ret = hash243_set_add(analyzed_hashes, hash)) != RC_OK) {
-        break;
-      }
+  for (size_t i = 0; i < count; i++) {
+    traversal->txs_ptrs[i] = &traversal->txs[i];
+  }
+  traversal->txs_capacity = count;
+
+  return RC_OK;
+}
+
+static bool traversal_transaction_is_loaded(iota_transaction_t const *const tx) {
+  return tx->loaded_columns_mask.essence || tx->loaded_columns_mask.attachment || tx->loaded_columns_mask.consensus ||
+         tx->loaded_columns_mask.data || tx->loaded_columns_mask.metadata;
+}
+
+static retcode_t traversal_branch(tangle_traversal_t *const traversal, flex_trit_t const *const hash,
+                                  iota_transaction_t *const tx) {
+  retcode_t ret = RC_OK;
+
+  if (traversal->direction == TANGLE_TRAVERSAL_TO_PAST) {
+    if ((ret = traversal_enqueue(traversal, transaction_trunk(tx))) != RC_OK) {
+      return ret;
     }
+    return traversal_enqueue(traversal, transaction_branch(tx));
   }
 
-  hash243_stack_free(&non_analyzed_hashes);
-  if (!analyzed_hashes_param) {
-    hash243_set_free(analyzed_hashes);
+  // There is no batch query for approvers, they are loaded one transaction at a time and answered from memory by the
+  // tangle graph when it is enabled
+  hash_pack_reset(&traversal->approvers);
+  if ((ret = iota_tangle_transaction_load_hashes_of_approvers(traversal->tangle, hash, &traversal->approvers, 0)) !=
+      RC_OK) {
+    return ret;
   }
-  return ret;
+  for (size_t i = 0; i < traversal->approvers.num_loaded; i++) {
+    if ((ret = traversal_enqueue(traversal, (flex_trit_t *)traversal->approvers.models[i])) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
 }
 
-retcode_t tangle_traversal_dfs_to_future(tangle_t const *const tangle, tangle_traversal_functor func,
-                                         flex_trit_t const *const entry_point, hash243_set_t *analyzed_hashes_param,
-                                         void *data) {
+/**
+ * Visits a batch of a layer, the whole batch being loaded at once
+ */
+static retcode_t traversal_visit_batch(tangle_traversal_t *const traversal, size_t const offset, size_t const count,
+                                       bool *const should_stop) {
   retcode_t ret = RC_OK;
-  iota_stor_pack_t hashes_pack;
-  hash243_stack_t non_analyzed_hashes = NULL;
-  flex_trit_t curr_tx_hash[FLEX_TRIT_SIZE_243];
-  hash243_set_t analyzed_hashes_local = NULL;
-  hash243_set_t *analyzed_hashes = analyzed_hashes_param ? analyzed_hashes_param : &analyzed_hashes_local;
-  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, transaction_pack);
+  hash243_queue_t hashes = layer_batch(&traversal->current, offset, count);
+  iota_stor_pack_t pack = {
+      .models = (void **)traversal->txs_ptrs, .capacity = count, .num_loaded = 0, .insufficient_capacity = false};
 
-  if ((ret = hash243_stack_push(&non_analyzed_hashes, entry_point)) != RC_OK) {
+  if ((ret = iota_tangle_transactions_load_partial(traversal->tangle, hashes, &pack,
+                                                   PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA)) != RC_OK) {
     return ret;
   }
 
-  if ((ret = hash_pack_init(&hashes_pack, 8)) != RC_OK) {
-    goto done;
+  for (size_t i = 0; i < count; i++) {
+    flex_trit_t *hash = traversal->current.entries[offset + i].hash;
+    iota_transaction_t *tx = traversal->txs_ptrs[i];
+    // Functors are given a pack holding only the visited transaction, as they were with a depth-first traversal
+    iota_stor_pack_t tx_pack = {.models = (void **)&traversal->txs_ptrs[i],
+                                .capacity = 1,
+                                .num_loaded = i < pack.num_loaded && traversal_transaction_is_loaded(tx),
+                                .insufficient_capacity = false};
+    bool should_branch = true;
+
+    // The analyzed set may have been updated by a functor since the hash was enqueued
+    if (hash243_set_contains(*traversal->analyzed_hashes, hash)) {
+      continue;
+    }
+
+    if ((ret = traversal->func(hash, &tx_pack, traversal->data, &should_branch, should_stop)) != RC_OK) {
+      return ret;
+    }
+
+    if (traversal->direction == TANGLE_TRAVERSAL_TO_FUTURE &&
+        (ret = hash243_set_add(traversal->analyzed_hashes, hash)) != RC_OK) {
+      return ret;
+    }
+
+    if (*should_stop) {
+      return RC_OK;
+    }
+
+    if (should_branch && tx_pack.num_loaded == 1 && (ret = traversal_branch(traversal, hash, tx)) != RC_OK) {
+      return ret;
+    }
+
+    // Missing transactions are not marked analyzed so that later traversals sharing the set visit them once received
+    if (traversal->direction == TANGLE_TRAVERSAL_TO_PAST && tx_pack.num_loaded == 1 &&
+        (ret = hash243_set_add(traversal->analyzed_hashes, hash)) != RC_OK) {
+      return ret;
+    }
   }
 
-  bool should_branch = true;
-  bool should_stop = false;
+  return RC_OK;
+}
 
-  while (!hash243_stack_empty(non_analyzed_hashes)) {
-    memcpy(curr_tx_hash, hash243_stack_peek(non_analyzed_hashes), FLEX_TRIT_SIZE_243);
+static retcode_t traversal_run(tangle_traversal_t *const traversal, flex_trit_t const *const entry_point) {
+  retcode_t ret = RC_OK;
+  tangle_traversal_layer_t layer;
+  bool should_stop = false;
 
-    if (!hash243_set_contains(*analyzed_hashes, curr_tx_hash)) {
-      hash_pack_reset(&transaction_pack);
-      if ((ret = iota_tangle_transaction_load_partial(tangle, curr_tx_hash, &transaction_pack,
-                                                      PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA)) != RC_OK) {
-        break;
-      }
+  if ((ret = traversal_enqueue(traversal, entry_point)) != RC_OK) {
+    return ret;
+  }
 
-      if ((ret = func(curr_tx_hash, &transaction_pack, data, &should_branch, &should_stop)) != RC_OK) {
-        break;
-      }
+  while (traversal->next.size > 0 && !should_stop) {
+    layer = traversal->current;
+    traversal->current = traversal->next;
+    traversal->next = layer;
+    traversal->next.size = 0;
 
-      if ((ret = hash243_set_add(analyzed_hashes, curr_tx_hash)) != RC_OK) {
-        goto done;
-      }
+    for (size_t offset = 0; offset < traversal->current.size && !should_stop; offset += TANGLE_TRAVERSAL_BATCH_SIZE) {
+      size_t count = traversal->current.size - offset;
 
-      if (should_stop) {
-        break;
+      if (count > TANGLE_TRAVERSAL_BATCH_SIZE) {
+        count = TANGLE_TRAVERSAL_BATCH_SIZE;
       }
-
-      if (should_branch) {
-        hash243_stack_pop(&non_analyzed_hashes);
-        hash_pack_reset(&hashes_pack);
-        if ((ret = iota_tangle_transaction_load_hashes_of_approvers(tangle, curr_tx_hash, &hashes_pack, 0)) != RC_OK) {
-          goto done;
-        }
-        while (hashes_pack.num_loaded > 0) {
-          // Add each found approver to the currently traversed tx
-          if ((ret = hash243_stack_push(&non_analyzed_hashes,
-                                        ((flex_trit_t *)hashes_pack.models[--hashes_pack.num_loaded]))) != RC_OK) {
-            goto done;
-          }
-        }
-        continue;
+      if ((ret = traversal_reserve_txs(traversal, count)) != RC_OK ||
+          (ret = traversal_visit_batch(traversal, offset, count, &should_stop)) != RC_OK) {
+        return ret;
       }
     }
-    hash243_stack_pop(&non_analyzed_hashes);
   }
 
-done:
-  hash_pack_free(&hashes_pack);
-  hash243_stack_free(&non_analyzed_hashes);
+  return RC_OK;
+}
+
+static retcode_t traversal_bfs(tangle_t const *const tangle, tangle_traversal_functor func,
+                               tangle_traversal_direction_t const direction, flex_trit_t const *const entry_point,
+                               hash243_set_t *const analyzed_hashes, void *data) {
+  retcode_t ret = RC_OK;
+  tangle_traversal_t traversal;
+
+  memset(&traversal, 0, sizeof(tangle_traversal_t));
+  traversal.tangle = tangle;
+  traversal.func = func;
+  traversal.direction = direction;
+  traversal.analyzed_hashes = analyzed_hashes;
+  traversal.data = data;
+
+  if (direction == TANGLE_TRAVERSAL_TO_FUTURE && (ret = hash_pack_init(&traversal.approvers, 8)) != RC_OK) {
+    return ret;
+  }
+
+  ret = traversal_run(&traversal, entry_point);
+
+  if (direction == TANGLE_TRAVERSAL_TO_FUTURE) {
+    hash_pack_free(&traversal.approvers);
+  }
+  free(traversal.visited.slots);
+  free(traversal.current.entries);
+  free(traversal.next.entries);
+  free(traversal.txs);
+  free(traversal.txs_ptrs);
+
+  return ret;
+}
+
+retcode_t tangle_traversal_dfs_to_past(tangle_t const *const tangle, tangle_traversal_functor func,
+                                       flex_trit_t const *const entry_point, flex_trit_t const *const genesis_hash,
+                                       hash243_set_t *analyzed_hashes_param, void *data) {
+  retcode_t ret = RC_OK;
+  hash243_set_t analyzed_hashes_local = NULL;
+  hash243_set_t *analyzed_hashes = analyzed_hashes_param ? analyzed_hashes_param : &analyzed_hashes_local;
+
+  if ((ret = hash243_set_add(analyzed_hashes, genesis_hash)) == RC_OK) {
+    ret = traversal_bfs(tangle, func, TANGLE_TRAVERSAL_TO_PAST, entry_point, analyzed_hashes, data);
+  }
+
   if (!analyzed_hashes_param) {
     hash243_set_free(analyzed_hashes);
   }
+  return ret;
+}
+
+retcode_t tangle_traversal_dfs_to_future(tangle_t const *const tangle, tangle_traversal_functor func,
+                                         flex_trit_t const *const entry_point, hash243_set_t *analyzed_hashes_param,
+                                         void *data) {
+  retcode_t ret = RC_OK;
+  hash243_set_t analyzed_hashes_local = NULL;
+  hash243_set_t *analyzed_hashes = analyzed_hashes_param ? analyzed_hashes_param : &analyzed_hashes_local;
 
+  ret = traversal_bfs(tangle, func, TANGLE_TRAVERSAL_TO_FUTURE, entry_point, analyzed_hashes, data);
+
+  if (!analyzed_hashes_param) {
+    hash243_set_free(analyzed_hashes);
+  }
   return ret;
 }
@@ -33,7 +33,9 @@ typedef retcode_t (*tangle_traversal_functor)(flex_trit_t *const hash, iota_stor
                                               bool *should_branch, bool *should_stop);
 
 /**
- * Traverse the Tangle (DFS) from an entry point and to its past
+ * Traverse the Tangle (BFS) from an entry point and to its past
+ * Each layer is loaded by batches, a transaction is visited at most once and not at all if it is in the analyzed set
+ * Missing transactions are visited but not added to the analyzed set
  *
  * @param tangle The tangle on which we traverse
  * @param func The operation to do when new transaction is visited
@@ -47,7 +49,8 @@ retcode_t tangle_traversal_dfs_to_past(tangle_t const *const tangle, tangle_trav
                                        hash243_set_t *analyzed_hashes_param, void *data);
 
 /**
- * Traverse the Tangle (DFS) from an entry point and to its future
+ * Traverse the Tangle (BFS) from an entry point and to its future
+ * Each layer is loaded by batches, a transaction is visited at most once and not at all if it is in the analyzed set
  *
  * @param tangle The tangle on which we traverse
  * @param func The operation to do when new transaction is visited
@@ -13,6 +13,11 @@
 #include "ciri/utils/files.h"
 
 retcode_t tangle_setup(tangle_t *const tangle, storage_connection_config_t *const config, char *test_db_path) {
+  tangle->db_path = test_db_path;
+  tangle->graph = NULL;
+  tangle->pool = NULL;
+  tangle->cache = NULL;
+  tangle->filter = NULL;
   return storage_test_setup(&tangle->connection, config, test_db_path, STORAGE_CONNECTION_TANGLE);
 }
 
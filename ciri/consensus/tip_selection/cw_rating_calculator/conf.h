@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_CW_RATING_CALCULATOR_CONF_H__
+#define __CONSENSUS_CW_RATING_CALCULATOR_CONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum cw_calculation_implementation_e {
+  CW_NO_IMPLEMENTATION,
+  /// time - O(n^2), place - O(n^2)
+  DFS_FROM_ENTRY_POINT,
+  /// time - O(n), place - O(n^2) implementation with the cost of
+  /// Performing propogation on each incoming transaction
+  BACKWARD_WEIGHT_PROPAGATION,
+  /// time - O(n * n / 64), place - O(n * w / 8) where w is the number of
+  /// ratings kept alive by the width of the subtangle
+  TOPOLOGICAL_BITSET_PROPAGATION,
+} cw_calculation_implementation_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_CW_RATING_CALCULATOR_CONF_H__
@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "ciri/consensus/tip_selection/cw_rating_calculator/cw_rating_bitset_impl.h"
+#include "ciri/consensus/tip_selection/cw_rating_calculator/cw_rating_dfs_impl.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+#include "utils/logger_helper.h"
+#include "utils/macros.h"
+#include "utils/time.h"
+
+#define CW_RATING_CALCULATOR_LOGGER_ID "cw_rating_calculator"
+#define CW_RATING_BITSET_WORD_BITS 64
+
+static logger_id_t logger_id;
+
+typedef struct cw_rating_bitset_s {
+  size_t size;
+  // Number of words of the set of the transaction with id 0
+  size_t words_num;
+  // Approvers of transaction i are approvers[approvers_offsets[i]..approvers_offsets[i + 1]], by index
+  size_t *approvers_offsets;
+  size_t *approvers;
+  // Transactions by id, i.e. in topological order, and ids by index
+  size_t *order;
+  size_t *ids;
+  // Number of approvees of each transaction not rated yet, its set being freed when it drops to 0
+  atomic_size_t *approvees_num;
+  // Sets of transactions approving each transaction, by index
+  uint64_t **sets;
+  int64_t *ratings;
+  // Range of ids of the layer being shared between threads
+  atomic_size_t layer_next;
+  size_t layer_end;
+  // Threads helping with large layers, started on the first one
+  thread_handle_t *workers;
+  size_t workers_num;
+  size_t workers_working;
+  uint64_t generation;
+  bool running;
+  lock_handle_t lock;
+  cond_handle_t start_cond;
+  cond_handle_t done_cond;
+  retcode_t ret;
+} cw_rating_bitset_t;
+
+/*
+ * Private functions
+ */
+
+static inline size_t cw_rating_bitset_first_word(size_t const id) { return id / CW_RATING_BITSET_WORD_BITS; }
+
+static retcode_t cw_rating_bitset_rate_one(cw_rating_bitset_t *const ctx, size_t const id) {
+  size_t const index = ctx->order[id];
+  size_t const first_word = cw_rating_bitset_first_word(id);
+  size_t const words_num = ctx->words_num - first_word;
+  uint64_t *set = NULL;
+  int64_t rating = 0;
+
+  // Only transactions with a greater id can approve this one so the set starts at its own word
+  if ((set = (uint64_t *)calloc(words_num, sizeof(uint64_t))) == NULL) {
+    return RC_OOM;
+  }
+  set[0] = 1ULL << (id % CW_RATING_BITSET_WORD_BITS);
+
+  for (size_t i = ctx->approvers_offsets[index]; i < ctx->approvers_offsets[index + 1]; i++) {
+    size_t const approver = ctx->approvers[i];
+    size_t const approver_first_word = cw_rating_bitset_first_word(ctx->ids[approver]);
+    uint64_t *approver_set = ctx->sets[approver];
+    uint64_t *dst = set + (approver_first_word - first_word);
+
+    for (size_t j = 0; j < ctx->words_num - approver_first_word; j++) {
+      dst[j] |= approver_set[j];
+    }
+
+    // The last approvee to be rated releases the set
+    if (atomic_fetch_sub_explicit(&ctx->approvees_num[approver], 1, memory_order_acq_rel) == 1) {
+      free(approver_set);
+      ctx->sets[approver] = NULL;
+    }
+  }
+
+  for (size_t i = 0; i < words_num; i++) {
+    rating += __builtin_popcountll(set[i]);
+  }
+  ctx->ratings[index] = rating;
+
+  if (atomic_load_explicit(&ctx->approvees_num[index], memory_order_relaxed) == 0) {
+    free(set);
+  } else {
+    ctx->sets[index] = set;
+  }
+
+  return RC_OK;
+}
+
+static void cw_rating_bitset_fail(cw_rating_bitset_t *const ctx, retcode_t const ret) {
+  lock_handle_lock(&ctx->lock);
+  if (ctx->ret == RC_OK) {
+    ctx->ret = ret;
+  }
+  lock_handle_unlock(&ctx->lock);
+}
+
+static void cw_rating_bitset_rate_shared_layer(cw_rating_bitset_t *const ctx) {
+  retcode_t ret = RC_OK;
+  size_t start = 0;
+
+  while ((start = atomic_fetch_add_explicit(&ctx->layer_next, CW_RATING_BITSET_PARALLEL_CHUNK,
+                                            memory_order_relaxed)) < ctx->layer_end) {
+    size_t const end = MIN(start + CW_RATING_BITSET_PARALLEL_CHUNK, ctx->layer_end);
+
+    for (size_t id = start; id < end; id++) {
+      if ((ret = cw_rating_bitset_rate_one(ctx, id)) != RC_OK) {
+        cw_rating_bitset_fail(ctx, ret);
+        return;
+      }
+    }
+  }
+}
+
+static void *cw_rating_bitset_worker(void *arg) {
+  cw_rating_bitset_t *ctx = (cw_rating_bitset_t *)arg;
+  uint64_t generation = 0;
+
+  lock_handle_lock(&ctx->lock);
+  while (true) {
+    while (ctx->running && ctx->generation == generation) {
+      cond_handle_wait(&ctx->start_cond, &ctx->lock);
+    }
+    if (!ctx->running) {
+      break;
+    }
+    generation = ctx->generation;
+    lock_handle_unlock(&ctx->lock);
+
+    cw_rating_bitset_rate_shared_layer(ctx);
+
+    lock_handle_lock(&ctx->lock);
+    if (--ctx->workers_working == 0) {
+      cond_handle_signal(&ctx->done_cond);
+    }
+  }
+  lock_handle_unlock(&ctx->lock);
+
+  return NULL;
+}
+
+static retcode_t cw_rating_bitset_workers_start(cw_rating_bitset_t *const ctx, size_t const threads) {
+  if ((ctx->workers = (thread_handle_t *)calloc(threads - 1, sizeof(thread_handle_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  ctx->running = true;
+  for (; ctx->workers_num < threads - 1; ctx->workers_num++) {
+    if (thread_handle_create(&ctx->workers[ctx->workers_num], cw_rating_bitset_worker, ctx) != 0) {
+      log_warning(logger_id, "Starting rating thread failed, rating with %zu threads\n", ctx->workers_num + 1);
+      break;
+    }
+  }
+
+  return RC_OK;
+}
+
+static void cw_rating_bitset_workers_stop(cw_rating_bitset_t *const ctx) {
+  lock_handle_lock(&ctx->lock);
+  ctx->running = false;
+  cond_handle_broadcast(&ctx->start_cond);
+  lock_handle_unlock(&ctx->lock);
+
+  for (size_t i = 0; i < ctx->workers_num; i++) {
+    thread_handle_join(ctx->workers[i], NULL);
+  }
+  free(ctx->workers);
+  ctx->workers = NULL;
+  ctx->workers_num = 0;
+}
+
+static retcode_t cw_rating_bitset_rate_layer(cw_rating_bitset_t *const ctx, size_t const start, size_t const end,
+                                             size_t const threads) {
+  retcode_t ret = RC_OK;
+
+  // Small layers are not worth waking threads up
+  if (threads <= 1 || end - start < 2 ||
+      (end - start) * (ctx->words_num - cw_rating_bitset_first_word(start)) < CW_RATING_BITSET_PARALLEL_MIN_WORDS) {
+    for (size_t id = start; id < end; id++) {
+      if ((ret = cw_rating_bitset_rate_one(ctx, id)) != RC_OK) {
+        return ret;
+      }
+    }
+    return RC_OK;
+  }
+
+  if (ctx->workers == NULL && (ret = cw_rating_bitset_workers_start(ctx, threads)) != RC_OK) {
+    return ret;
+  }
+
+  lock_handle_lock(&ctx->lock);
+  atomic_store_explicit(&ctx->layer_next, start, memory_order_relaxed);
+  ctx->layer_end = end;
+  ctx->workers_working = ctx->workers_num;
+  ctx->generation++;
+  cond_handle_broadcast(&ctx->start_cond);
+  lock_handle_unlock(&ctx->lock);
+
+  cw_rating_bitset_rate_shared_layer(ctx);
+
+  lock_handle_lock(&ctx->lock);
+  while (ctx->workers_working > 0) {
+    cond_handle_wait(&ctx->done_cond, &ctx->lock);
+  }
+  ret = ctx->ret;
+  lock_handle_unlock(&ctx->lock);
+
+  return ret;
+}
+
+static retcode_t cw_rating_bitset_index(cw_rating_bitset_t *const ctx,
+                                        hash_to_indexed_hash_set_map_t const tx_to_approvers,
+                                        hash_to_indexed_hash_set_entry_t **const entries) {
+  hash_to_indexed_hash_set_entry_t *entry = NULL;
+  hash_to_indexed_hash_set_entry_t *tmp_entry = NULL;
+  hash_to_indexed_hash_set_entry_t *approver_entry = NULL;
+  hash243_set_entry_t *approver = NULL;
+  hash243_set_entry_t *tmp_approver = NULL;
+  size_t approvers_num = 0;
+
+  HASH_ITER(hh, tx_to_approvers, entry, tmp_entry) {
+    if (entry->idx >= ctx->size || entries[entry->idx] != NULL) {
+      return RC_CW_FAILED_IN_PROPAGATION;
+    }
+    entries[entry->idx] = entry;
+    approvers_num += HASH_COUNT(entry->approvers);
+  }
+
+  if ((ctx->approvers = (size_t *)malloc(MAX(approvers_num, 1) * sizeof(size_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  // Approvers missing from the subtangle are ignored, as by the DFS implementation
+  approvers_num = 0;
+  for (size_t index = 0; index < ctx->size; index++) {
+    ctx->approvers_offsets[index] = approvers_num;
+    if (entries[index] == NULL) {
+      return RC_CW_FAILED_IN_PROPAGATION;
+    }
+    HASH_ITER(hh, entries[index]->approvers, approver, tmp_approver) {
+      HASH_FIND(hh, tx_to_approvers, approver->hash, FLEX_TRIT_SIZE_243, approver_entry);
+      if (approver_entry != NULL) {
+        ctx->approvers[approvers_num++] = approver_entry->idx;
+        atomic_fetch_add_explicit(&ctx->approvees_num[approver_entry->idx], 1, memory_order_relaxed);
+      }
+    }
+  }
+  ctx->approvers_offsets[ctx->size] = approvers_num;
+
+  return RC_OK;
+}
+
+static retcode_t cw_rating_bitset_sort(cw_rating_bitset_t *const ctx, size_t const entry_point, size_t *const layers,
+                                       size_t *const layers_num) {
+  size_t *pending = NULL;
+  size_t head = 0, tail = 0;
+
+  if ((pending = (size_t *)malloc(ctx->size * sizeof(size_t))) == NULL) {
+    return RC_OOM;
+  }
+  for (size_t index = 0; index < ctx->size; index++) {
+    pending[index] = atomic_load_explicit(&ctx->approvees_num[index], memory_order_relaxed);
+  }
+
+  // Kahn's algorithm, layer by layer: a transaction joins the layer following the one of its last approvee
+  *layers_num = 0;
+  if (pending[entry_point] == 0) {
+    ctx->order[tail++] = entry_point;
+  }
+  while (head < tail) {
+    size_t const layer_end = tail;
+
+    layers[(*layers_num)++] = head;
+    for (; head < layer_end; head++) {
+      size_t const index = ctx->order[head];
+
+      ctx->ids[index] = head;
+      for (size_t i = ctx->approvers_offsets[index]; i < ctx->approvers_offsets[index + 1]; i++) {
+        if (--pending[ctx->approvers[i]] == 0) {
+          ctx->order[tail++] = ctx->approvers[i];
+        }
+      }
+    }
+  }
+  layers[*layers_num] = tail;
+  free(pending);
+
+  // Every transaction must be reachable from the entry point
+  return tail == ctx->size ? RC_OK : RC_CW_FAILED_IN_PROPAGATION;
+}
+
+/*
+ * Public functions
+ */
+
+void init_cw_calculator_bitset(cw_rating_calculator_base_t *calculator) {
+  logger_id = logger_helper_enable(CW_RATING_CALCULATOR_LOGGER_ID, LOGGER_DEBUG, true);
+  calculator->vtable = cw_bitset_vtable;
+}
+
+retcode_t cw_rating_bitset_rate(hash_to_indexed_hash_set_map_t const tx_to_approvers,
+                                flex_trit_t const *const entry_point, uint64_t const subtangle_size,
+                                size_t const threads, hash_to_int64_t_map_t *const cw_ratings) {
+  retcode_t ret = RC_OK;
+  cw_rating_bitset_t ctx;
+  hash_to_indexed_hash_set_entry_t **entries = NULL;
+  hash_to_indexed_hash_set_entry_t *entry_point_entry = NULL;
+  size_t *layers = NULL;
+  size_t layers_num = 0;
+
+  if (subtangle_size <= 1) {
+    return hash_to_int64_t_map_add(cw_ratings, entry_point, subtangle_size);
+  }
+
+  HASH_FIND(hh, tx_to_approvers, entry_point, FLEX_TRIT_SIZE_243, entry_point_entry);
+  if (entry_point_entry == NULL || HASH_COUNT(tx_to_approvers) != subtangle_size) {
+    return RC_CW_FAILED_IN_PROPAGATION;
+  }
+
+  memset(&ctx, 0, sizeof(cw_rating_bitset_t));
+  ctx.size = subtangle_size;
+  ctx.words_num = (ctx.size + CW_RATING_BITSET_WORD_BITS - 1) / CW_RATING_BITSET_WORD_BITS;
+  lock_handle_init(&ctx.lock);
+  cond_handle_init(&ctx.start_cond);
+  cond_handle_init(&ctx.done_cond);
+
+  if ((entries = (hash_to_indexed_hash_set_entry_t **)calloc(ctx.size, sizeof(*entries))) == NULL ||
+      (ctx.approvers_offsets = (size_t *)malloc((ctx.size + 1) * sizeof(size_t))) == NULL ||
+      (ctx.order = (size_t *)malloc(ctx.size * sizeof(size_t))) == NULL ||
+      (ctx.ids = (size_t *)malloc(ctx.size * sizeof(size_t))) == NULL ||
+      (ctx.approvees_num = (atomic_size_t *)calloc(ctx.size, sizeof(atomic_size_t))) == NULL ||
+      (ctx.sets = (uint64_t **)calloc(ctx.size, sizeof(uint64_t *))) == NULL ||
+      (ctx.ratings = (int64_t *)malloc(ctx.size * sizeof(int64_t))) == NULL ||
+      (layers = (size_t *)malloc((ctx.size + 1) * sizeof(size_t))) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+
+  ERR_BIND_GOTO(cw_rating_bitset_index(&ctx, tx_to_approvers, entries), ret, done);
+  ERR_BIND_GOTO(cw_rating_bitset_sort(&ctx, entry_point_entry->idx, layers, &layers_num), ret, done);
+
+  // From the tips down to the entry point, a layer only needing the sets of the following ones
+  for (size_t layer = layers_num; layer > 0; layer--) {
+    ERR_BIND_GOTO(cw_rating_bitset_rate_layer(&ctx, layers[layer - 1], layers[layer], threads), ret, done);
+  }
+
+  // Entry point first
+  for (size_t id = 0; id < ctx.size; id++) {
+    size_t const index = ctx.order[id];
+
+    ERR_BIND_GOTO(hash_to_int64_t_map_add(cw_ratings, entries[index]->hash, ctx.ratings[index]), ret, done);
+  }
+
+done:
+  if (ctx.workers != NULL) {
+    cw_rating_bitset_workers_stop(&ctx);
+  }
+  if (ctx.sets != NULL) {
+    for (size_t index = 0; index < ctx.size; index++) {
+      free(ctx.sets[index]);
+    }
+  }
+  free(entries);
+  free(ctx.approvers_offsets);
+  free(ctx.approvers);
+  free(ctx.order);
+  free(ctx.ids);
+  free(ctx.approvees_num);
+  free(ctx.sets);
+  free(ctx.ratings);
+  free(layers);
+  cond_handle_destroy(&ctx.done_cond);
+  cond_handle_destroy(&ctx.start_cond);
+  lock_handle_destroy(&ctx.lock);
+
+  return ret;
+}
+
+retcode_t cw_rating_calculate_bitset(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                     flex_trit_t const *const entry_point, cw_calc_result *const out) {
+  retcode_t ret = RC_OK;
+  uint64_t subtangle_size = 0;
+  uint64_t start_timestamp, end_timestamp;
+
+  out->cw_ratings = NULL;
+  out->tx_to_approvers = NULL;
+
+  if (!entry_point) {
+    return RC_NULL_PARAM;
+  }
+
+  start_timestamp = current_timestamp_ms();
+
+  if ((ret = cw_rating_dfs_do_dfs_from_db(tangle, entry_point, &out->tx_to_approvers, &subtangle_size, 0)) != RC_OK) {
+    log_error(logger_id, "Failed in DFS from DB, error code is: %" PRIu64 "\n", ret);
+    return RC_CW_FAILED_IN_DFS_FROM_DB;
+  }
+
+  if ((ret = cw_rating_bitset_rate(out->tx_to_approvers, entry_point, subtangle_size, cw_calc->threads,
+                                   &out->cw_ratings)) != RC_OK) {
+    log_error(logger_id, "Failed in propagation, error code is: %" PRIu64 "\n", ret);
+    return ret;
+  }
+
+  end_timestamp = current_timestamp_ms();
+  log_debug(logger_id, "%s took %" PRId64 " milliseconds\n", __FUNCTION__, end_timestamp - start_timestamp);
+
+  return ret;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_CW_RATING_CALCULATOR_CW_RATING_BITSET_IMPL_H__
+#define __CONSENSUS_CW_RATING_CALCULATOR_CW_RATING_BITSET_IMPL_H__
+
+#include "ciri/consensus/tip_selection/cw_rating_calculator/cw_rating_calculator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Minimum number of words a layer has to OR for its ratings to be shared between threads
+#define CW_RATING_BITSET_PARALLEL_MIN_WORDS 16384
+// Number of transactions a thread takes at once from a shared layer
+#define CW_RATING_BITSET_PARALLEL_CHUNK 4
+
+void init_cw_calculator_bitset(cw_rating_calculator_base_t *calculator);
+
+/**
+ *
+ * @param cw_calc - the calculator
+ * @param entry_point  - where should the rating calculation start from
+ * @param out - a struct containing the ratings and mapping between txs and
+ *              their approvers - both should be freed!!!
+ * @return retcode_t
+ *
+ * This implementation loads the subtangle like DFS_FROM_ENTRY_POINT and then
+ * rates it in a single pass with cw_rating_bitset_rate
+ */
+extern retcode_t cw_rating_calculate_bitset(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                            flex_trit_t const *const entry_point, cw_calc_result *const out);
+
+/**
+ * Rates every transaction of a loaded subtangle in a single topological pass
+ *
+ * Transactions are sorted in layers so that a transaction only approves transactions of previous layers, and given
+ * dense ids in that order. Layers are then rated from the tips down to the entry point: the set of transactions
+ * approving a transaction is a bitset of the ids following its own, obtained by ORing the sets of its direct
+ * approvers, and its rating is the number of bits set. A set is freed as soon as every transaction it approves has
+ * been rated, so that only the sets of the last few layers are alive at once. Transactions of a layer don't approve
+ * each other and large layers are rated on several threads.
+ *
+ * Complexity: (E+V) + E*V/64 word operations (E ~ 2*V)
+ *
+ * @param tx_to_approvers The subtangle, as loaded by cw_rating_dfs_do_dfs_from_db
+ * @param entry_point The entry point of the subtangle
+ * @param subtangle_size The number of transactions of the subtangle
+ * @param threads The number of threads rating large layers
+ * @param cw_ratings The ratings - should be freed!!!
+ *
+ * @return retcode_t
+ */
+extern retcode_t cw_rating_bitset_rate(hash_to_indexed_hash_set_map_t const tx_to_approvers,
+                                       flex_trit_t const *const entry_point, uint64_t const subtangle_size,
+                                       size_t const threads, hash_to_int64_t_map_t *const cw_ratings);
+
+static cw_calculator_vtable cw_bitset_vtable = {
+    .cw_rating_calculate = cw_rating_calculate_bitset,
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  //__CONSENSUS_CW_RATING_CALCULATOR_CW_RATING_BITSET_IMPL_H__
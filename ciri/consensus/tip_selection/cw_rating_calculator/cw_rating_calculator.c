@@ -5,6 +5,7 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include "ciri/consensus/tip_selection/cw_rating_calculator/cw_rating_bitset_impl.h"
 #include "ciri/consensus/tip_selection/cw_rating_calculator/cw_rating_dfs_impl.h"
 #include "common/errors.h"
 #include "utils/logger_helper.h"
@@ -16,9 +17,13 @@ static logger_id_t logger_id;
 
 retcode_t iota_consensus_cw_rating_init(cw_rating_calculator_t *const cw_calc, cw_calculation_implementation_t impl) {
   logger_id = logger_helper_enable(CW_RATING_CALCULATOR_LOGGER_ID, LOGGER_DEBUG, true);
+  cw_calc->threads = 1;
   if (impl == DFS_FROM_ENTRY_POINT) {
     init_cw_calculator_dfs(&cw_calc->base);
     return RC_OK;
+  } else if (impl == TOPOLOGICAL_BITSET_PROPAGATION) {
+    init_cw_calculator_bitset(&cw_calc->base);
+    return RC_OK;
   }
   return RC_OK;
 }
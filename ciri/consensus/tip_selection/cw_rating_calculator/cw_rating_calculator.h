@@ -14,6 +14,7 @@
 #include "uthash.h"
 
 #include "ciri/consensus/tangle/tangle.h"
+#include "ciri/consensus/tip_selection/cw_rating_calculator/conf.h"
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
 #include "utils/containers/hash/hash_int64_t_map.h"
@@ -27,15 +28,6 @@ extern "C" {
 typedef struct cw_rating_calculator_base cw_rating_calculator_base_t;
 typedef struct cw_rating_calculator_t cw_rating_calculator_t;
 
-typedef enum cw_calculation_implementation_e {
-  CW_NO_IMPLEMENTATION,
-  /// time - O(n^2), place - O(n^2)
-  DFS_FROM_ENTRY_POINT,
-  /// time - O(n), place - O(n^2) implementation with the cost of
-  /// Performing propogation on each incoming transaction
-  BACKWARD_WEIGHT_PROPAGATION,
-} cw_calculation_implementation_t;
-
 typedef struct cw_calc_result {
   hash_to_int64_t_map_t cw_ratings;
   hash_to_indexed_hash_set_map_t tx_to_approvers;
@@ -54,6 +46,8 @@ struct cw_rating_calculator_base {
 
 struct cw_rating_calculator_t {
   cw_rating_calculator_base_t base;
+  // Number of threads ratings are calculated on, for implementations that support it
+  size_t threads;
 };
 
 extern retcode_t iota_consensus_cw_rating_init(cw_rating_calculator_t *const cw_calc,
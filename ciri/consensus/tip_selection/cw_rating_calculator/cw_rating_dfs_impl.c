@@ -23,9 +23,55 @@ static logger_id_t logger_id;
  * Private functions
  */
 
-static retcode_t cw_rating_dfs_do_dfs_from_db(tangle_t *const tangle, flex_trit_t const *const entry_point,
-                                              hash_to_indexed_hash_set_map_t *tx_to_approvers, uint64_t *subtangle_size,
-                                              int64_t subtangle_before_timestamp) {
+static retcode_t cw_rating_dfs_do_dfs_light(hash_to_indexed_hash_set_map_t tx_to_approvers, flex_trit_t *ep,
+                                            bitset_t *visited_bitset, uint64_t *subtangle_size) {
+  *subtangle_size = 0;
+  flex_trit_t *curr_hash = NULL;
+  hash_to_indexed_hash_set_entry_t *curr_tx_entry = NULL;
+  retcode_t ret = RC_OK;
+  hash243_stack_t stack = NULL;
+
+  if ((ret = hash243_stack_push(&stack, ep)) != RC_OK) {
+    goto done;
+  }
+
+  while (!hash243_stack_empty(stack)) {
+    curr_hash = hash243_stack_peek(stack);
+
+    HASH_FIND(hh, tx_to_approvers, curr_hash, FLEX_TRIT_SIZE_243, curr_tx_entry);
+
+    hash243_stack_pop(&stack);
+
+    if (!curr_tx_entry) {
+      continue;
+    }
+
+    if (bitset_is_set(visited_bitset, curr_tx_entry->idx)) {
+      continue;
+    }
+    ++(*subtangle_size);
+
+    bitset_set_true(visited_bitset, curr_tx_entry->idx);
+
+    if ((ret = hash243_set_for_each(curr_tx_entry->approvers, (hash243_on_container_func)hash243_stack_push, &stack)) !=
+        RC_OK) {
+      goto done;
+    }
+  }
+
+done:
+  hash243_stack_free(&stack);
+
+  return ret;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t cw_rating_dfs_do_dfs_from_db(tangle_t *const tangle, flex_trit_t const *const entry_point,
+                                       hash_to_indexed_hash_set_map_t *tx_to_approvers, uint64_t *subtangle_size,
+                                       int64_t subtangle_before_timestamp) {
   hash_to_indexed_hash_set_entry_t *curr_tx = NULL;
   retcode_t ret = RC_OK;
   iota_stor_pack_t approvers_pack;
@@ -79,94 +125,30 @@ done:
   return ret;
 }
 
-static retcode_t cw_rating_dfs_do_dfs_light(hash_to_indexed_hash_set_map_t tx_to_approvers, flex_trit_t *ep,
-                                            bitset_t *visited_bitset, uint64_t *subtangle_size) {
-  *subtangle_size = 0;
-  flex_trit_t *curr_hash = NULL;
-  hash_to_indexed_hash_set_entry_t *curr_tx_entry = NULL;
-  retcode_t ret = RC_OK;
-  hash243_stack_t stack = NULL;
-
-  if ((ret = hash243_stack_push(&stack, ep)) != RC_OK) {
-    goto done;
-  }
-
-  while (!hash243_stack_empty(stack)) {
-    curr_hash = hash243_stack_peek(stack);
-
-    HASH_FIND(hh, tx_to_approvers, curr_hash, FLEX_TRIT_SIZE_243, curr_tx_entry);
-
-    hash243_stack_pop(&stack);
-
-    if (!curr_tx_entry) {
-      continue;
-    }
-
-    if (bitset_is_set(visited_bitset, curr_tx_entry->idx)) {
-      continue;
-    }
-    ++(*subtangle_size);
-
-    bitset_set_true(visited_bitset, curr_tx_entry->idx);
-
-    if ((ret = hash243_set_for_each(curr_tx_entry->approvers, (hash243_on_container_func)hash243_stack_push, &stack)) !=
-        RC_OK) {
-      goto done;
-    }
-  }
-
-done:
-  hash243_stack_free(&stack);
-
-  return ret;
-}
-
-/*
- * Public functions
- */
-
 void init_cw_calculator_dfs(cw_rating_calculator_base_t *calculator) {
   logger_id = logger_helper_enable(CW_RATING_CALCULATOR_LOGGER_ID, LOGGER_DEBUG, true);
   calculator->vtable = cw_topological_vtable;
 }
 
-retcode_t cw_rating_calculate_dfs(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
-                                  flex_trit_t const *const entry_point, cw_calc_result *const out) {
+retcode_t cw_rating_dfs_rate(hash_to_indexed_hash_set_map_t const tx_to_approvers, flex_trit_t const *const entry_point,
+                             uint64_t const subtangle_size, hash_to_int64_t_map_t *const cw_ratings) {
   retcode_t ret = RC_OK;
   hash_to_indexed_hash_set_entry_t *curr_hash_to_approvers_entry = NULL;
   hash_to_indexed_hash_set_entry_t *tmp_hash_to_approvers_entry = NULL;
   uint64_t sub_tangle_size = 0;
-  uint64_t max_subtangle_size = 0;
   uint64_t bitset_size = 0;
-  uint64_t start_timestamp, end_timestamp;
-  UNUSED(cw_calc);
-
-  out->cw_ratings = NULL;
-  out->tx_to_approvers = NULL;
-
-  if (!entry_point) {
-    return RC_NULL_PARAM;
-  }
-
-  start_timestamp = current_timestamp_ms();
-
-  if ((ret = cw_rating_dfs_do_dfs_from_db(tangle, entry_point, &out->tx_to_approvers, &max_subtangle_size, 0)) !=
-      RC_OK) {
-    log_error(logger_id, "Failed in DFS from DB, error code is: %" PRIu64 "\n", ret);
-    return RC_CW_FAILED_IN_DFS_FROM_DB;
-  }
 
   // Insert first "ratings" entry
-  if ((ret = hash_to_int64_t_map_add(&out->cw_ratings, entry_point, max_subtangle_size)) != RC_OK) {
+  if ((ret = hash_to_int64_t_map_add(cw_ratings, entry_point, subtangle_size)) != RC_OK) {
     log_error(logger_id, "Failed adding entrypoint into map\n");
     return ret;
   }
 
-  if (max_subtangle_size <= 1) {
+  if (subtangle_size <= 1) {
     return RC_OK;
   }
 
-  bitset_size = bistset_required_size(max_subtangle_size);
+  bitset_size = bistset_required_size(subtangle_size);
 
   {
     uint64_t visited_raw_bits[bitset_size];
@@ -174,26 +156,55 @@ retcode_t cw_rating_calculate_dfs(cw_rating_calculator_t const *const cw_calc, t
         .raw_bits = visited_raw_bits, .bitset_integer_index = 0, .bitset_relative_index = 0, .size = bitset_size};
     flex_trit_t curr_hash[FLEX_TRIT_SIZE_243];
 
-    HASH_ITER(hh, out->tx_to_approvers, curr_hash_to_approvers_entry, tmp_hash_to_approvers_entry) {
+    HASH_ITER(hh, tx_to_approvers, curr_hash_to_approvers_entry, tmp_hash_to_approvers_entry) {
       if (curr_hash_to_approvers_entry->idx == 0) {
         continue;
       }
 
       bitset_reset(&visited_txs_bitset);
       memcpy(curr_hash, curr_hash_to_approvers_entry->hash, FLEX_TRIT_SIZE_243);
-      if ((ret = cw_rating_dfs_do_dfs_light(out->tx_to_approvers, curr_hash, &visited_txs_bitset, &sub_tangle_size)) !=
+      if ((ret = cw_rating_dfs_do_dfs_light(tx_to_approvers, curr_hash, &visited_txs_bitset, &sub_tangle_size)) !=
           RC_OK) {
         log_error(logger_id, "Failed in light DFS, error code is: %" PRIu64 "\n", ret);
         return RC_CW_FAILED_IN_LIGHT_DFS;
       }
 
-      if ((ret = hash_to_int64_t_map_add(&out->cw_ratings, curr_hash, sub_tangle_size))) {
+      if ((ret = hash_to_int64_t_map_add(cw_ratings, curr_hash, sub_tangle_size))) {
         log_error(logger_id, "Failed in light DFS, error code is: %" PRIu64 "\n", ret);
         return ret;
       }
     }
   }
 
+  return ret;
+}
+
+retcode_t cw_rating_calculate_dfs(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
+                                  flex_trit_t const *const entry_point, cw_calc_result *const out) {
+  retcode_t ret = RC_OK;
+  uint64_t max_subtangle_size = 0;
+  uint64_t start_timestamp, end_timestamp;
+  UNUSED(cw_calc);
+
+  out->cw_ratings = NULL;
+  out->tx_to_approvers = NULL;
+
+  if (!entry_point) {
+    return RC_NULL_PARAM;
+  }
+
+  start_timestamp = current_timestamp_ms();
+
+  if ((ret = cw_rating_dfs_do_dfs_from_db(tangle, entry_point, &out->tx_to_approvers, &max_subtangle_size, 0)) !=
+      RC_OK) {
+    log_error(logger_id, "Failed in DFS from DB, error code is: %" PRIu64 "\n", ret);
+    return RC_CW_FAILED_IN_DFS_FROM_DB;
+  }
+
+  if ((ret = cw_rating_dfs_rate(out->tx_to_approvers, entry_point, max_subtangle_size, &out->cw_ratings)) != RC_OK) {
+    return ret;
+  }
+
   end_timestamp = current_timestamp_ms();
   log_debug(logger_id, "%s took %" PRId64 " milliseconds\n", __FUNCTION__, end_timestamp - start_timestamp);
 
@@ -39,6 +39,36 @@ void init_cw_calculator_dfs(cw_rating_calculator_base_t *calculator);
 extern retcode_t cw_rating_calculate_dfs(cw_rating_calculator_t const *const cw_calc, tangle_t *const tangle,
                                          flex_trit_t const *const entry_point, cw_calc_result *const out);
 
+/**
+ * Loads the subtangle approving an entry point from storage
+ *
+ * @param tangle A tangle
+ * @param entry_point The entry point
+ * @param tx_to_approvers The approvers of every transaction of the subtangle, indexed from 0 for the entry point to
+ *                        subtangle_size - 1 - should be freed!!!
+ * @param subtangle_size The number of transactions of the subtangle
+ * @param subtangle_before_timestamp Only approvers attached before this timestamp are loaded, 0 for all of them
+ *
+ * @return retcode_t
+ */
+extern retcode_t cw_rating_dfs_do_dfs_from_db(tangle_t *const tangle, flex_trit_t const *const entry_point,
+                                              hash_to_indexed_hash_set_map_t *tx_to_approvers,
+                                              uint64_t *subtangle_size, int64_t subtangle_before_timestamp);
+
+/**
+ * Rates every transaction of a loaded subtangle with a DFS from each of them
+ *
+ * @param tx_to_approvers The subtangle, as loaded by cw_rating_dfs_do_dfs_from_db
+ * @param entry_point The entry point of the subtangle
+ * @param subtangle_size The number of transactions of the subtangle
+ * @param cw_ratings The ratings - should be freed!!!
+ *
+ * @return retcode_t
+ */
+extern retcode_t cw_rating_dfs_rate(hash_to_indexed_hash_set_map_t const tx_to_approvers,
+                                    flex_trit_t const *const entry_point, uint64_t const subtangle_size,
+                                    hash_to_int64_t_map_t *const cw_ratings);
+
 static cw_calculator_vtable cw_topological_vtable = {
     .cw_rating_calculate = cw_rating_calculate_dfs,
 };
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * Compares the cumulative weight implementations on synthetic subtangles of growing sizes, the DFS implementation only
+ * being run up to a size it rates in reasonable time
+ *
+ * Usage: benchmark_cw_rating [maximum number of transactions] [threads] [maximum number of transactions for DFS]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ciri/consensus/tip_selection/cw_rating_calculator/cw_rating_bitset_impl.h"
+#include "ciri/consensus/tip_selection/cw_rating_calculator/cw_rating_dfs_impl.h"
+#include "ciri/consensus/tip_selection/cw_rating_calculator/tests/synthetic_tangle.h"
+#include "utils/time.h"
+
+#define BENCHMARK_MIN_TRANSACTIONS_NUM 10000
+#define BENCHMARK_MAX_TRANSACTIONS_NUM 1000000
+#define BENCHMARK_DFS_MAX_TRANSACTIONS_NUM 10000
+#define BENCHMARK_THREADS 4
+// Number of previous transactions a transaction can approve, about twice the number of tips
+#define BENCHMARK_WIDTH 64
+
+static bool same_ratings(hash_to_int64_t_map_t const expected, hash_to_int64_t_map_t const actual) {
+  hash_to_int64_t_map_entry_t *entry = NULL;
+  hash_to_int64_t_map_entry_t *tmp_entry = NULL;
+  hash_to_int64_t_map_entry_t *actual_entry = NULL;
+
+  if (HASH_COUNT(expected) != HASH_COUNT(actual)) {
+    return false;
+  }
+  HASH_ITER(hh, expected, entry, tmp_entry) {
+    HASH_FIND(hh, actual, entry->hash, FLEX_TRIT_SIZE_243, actual_entry);
+    if (actual_entry == NULL || actual_entry->value != entry->value) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void report(char const *const name, size_t const size, uint64_t const elapsed) {
+  printf("%-16s %8zu txs in %8" PRIu64 " ms: %10.0f txs/s\n", name, size, elapsed,
+         elapsed ? size * 1000.0 / elapsed : 0.0);
+}
+
+static retcode_t benchmark(size_t const size, size_t const threads, size_t const dfs_max_size) {
+  retcode_t ret = RC_OK;
+  hash_to_indexed_hash_set_map_t tx_to_approvers = NULL;
+  hash_to_int64_t_map_t dfs_ratings = NULL;
+  hash_to_int64_t_map_t bitset_ratings = NULL;
+  hash_to_int64_t_map_t parallel_ratings = NULL;
+  flex_trit_t entry_point[FLEX_TRIT_SIZE_243];
+  uint64_t start = 0;
+
+  if ((ret = synthetic_tangle_generate(&tx_to_approvers, entry_point, size, BENCHMARK_WIDTH, size)) != RC_OK) {
+    fprintf(stderr, "Generating subtangle failed: %d\n", ret);
+    return ret;
+  }
+
+  if (size <= dfs_max_size) {
+    start = current_timestamp_ms();
+    if ((ret = cw_rating_dfs_rate(tx_to_approvers, entry_point, size, &dfs_ratings)) != RC_OK) {
+      fprintf(stderr, "Rating with DFS failed: %d\n", ret);
+      goto done;
+    }
+    report("dfs", size, current_timestamp_ms() - start);
+  }
+
+  start = current_timestamp_ms();
+  if ((ret = cw_rating_bitset_rate(tx_to_approvers, entry_point, size, 1, &bitset_ratings)) != RC_OK) {
+    fprintf(stderr, "Rating with bitsets failed: %d\n", ret);
+    goto done;
+  }
+  report("bitset", size, current_timestamp_ms() - start);
+
+  if (threads > 1) {
+    start = current_timestamp_ms();
+    if ((ret = cw_rating_bitset_rate(tx_to_approvers, entry_point, size, threads, &parallel_ratings)) != RC_OK) {
+      fprintf(stderr, "Rating with bitsets on %zu threads failed: %d\n", threads, ret);
+      goto done;
+    }
+    report("bitset parallel", size, current_timestamp_ms() - start);
+  }
+
+  if ((dfs_ratings && !same_ratings(dfs_ratings, bitset_ratings)) ||
+      (parallel_ratings && !same_ratings(bitset_ratings, parallel_ratings))) {
+    fprintf(stderr, "Ratings differ\n");
+    ret = RC_CW_FAILED_IN_PROPAGATION;
+  }
+
+done:
+  hash_to_int64_t_map_free(&dfs_ratings);
+  hash_to_int64_t_map_free(&bitset_ratings);
+  hash_to_int64_t_map_free(&parallel_ratings);
+  hash_to_indexed_hash_set_map_free(&tx_to_approvers);
+
+  return ret;
+}
+
+int main(int argc, char **argv) {
+  size_t max_size = argc > 1 ? strtoul(argv[1], NULL, 10) : BENCHMARK_MAX_TRANSACTIONS_NUM;
+  size_t threads = argc > 2 ? strtoul(argv[2], NULL, 10) : BENCHMARK_THREADS;
+  size_t dfs_max_size = argc > 3 ? strtoul(argv[3], NULL, 10) : BENCHMARK_DFS_MAX_TRANSACTIONS_NUM;
+
+  for (size_t size = BENCHMARK_MIN_TRANSACTIONS_NUM; size <= max_size; size *= 10) {
+    if (benchmark(size, threads, dfs_max_size) != RC_OK) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ciri/consensus/tip_selection/cw_rating_calculator/tests/synthetic_tangle.h"
+#include "utils/macros.h"
+
+static void synthetic_tangle_hash(flex_trit_t *const hash, size_t const index) {
+  memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+  memcpy(hash, &index, sizeof(index));
+}
+
+retcode_t synthetic_tangle_generate(hash_to_indexed_hash_set_map_t *const tx_to_approvers,
+                                    flex_trit_t *const entry_point, size_t const size, size_t const width,
+                                    unsigned int const seed) {
+  retcode_t ret = RC_OK;
+  hash_to_indexed_hash_set_entry_t **entries = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  if ((entries = (hash_to_indexed_hash_set_entry_t **)calloc(MAX(size, 1), sizeof(*entries))) == NULL) {
+    return RC_OOM;
+  }
+
+  srand(seed);
+  *tx_to_approvers = NULL;
+  synthetic_tangle_hash(entry_point, 0);
+
+  for (size_t i = 0; i < size; i++) {
+    synthetic_tangle_hash(hash, i);
+    ERR_BIND_GOTO(hash_to_indexed_hash_set_map_add_new_set(tx_to_approvers, hash, &entries[i], i), ret, done);
+    if (i == 0) {
+      continue;
+    }
+    // Trunk and branch
+    for (size_t j = 0; j < 2; j++) {
+      size_t approvee = i - 1 - (size_t)rand() % MIN(i, width);
+
+      ERR_BIND_GOTO(hash243_set_add(&entries[approvee]->approvers, hash), ret, done);
+    }
+  }
+
+done:
+  free(entries);
+  if (ret != RC_OK) {
+    hash_to_indexed_hash_set_map_free(tx_to_approvers);
+  }
+
+  return ret;
+}
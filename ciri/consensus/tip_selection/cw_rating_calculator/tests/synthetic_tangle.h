@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_CW_RATING_CALCULATOR_TESTS_SYNTHETIC_TANGLE_H__
+#define __CONSENSUS_CW_RATING_CALCULATOR_TESTS_SYNTHETIC_TANGLE_H__
+
+#include <stddef.h>
+
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/hash_indexed_map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Generates a subtangle as loaded by cw_rating_dfs_do_dfs_from_db, without storage
+ *
+ * Transaction i has index i, the hash i and, for i > 0, approves two random transactions among the width previous ones,
+ * so that width 1 generates a chain and the subtangle widens with width.
+ *
+ * @param tx_to_approvers The subtangle - should be freed!!!
+ * @param entry_point The hash of the entry point, transaction 0
+ * @param size The number of transactions
+ * @param width The number of previous transactions a transaction can approve
+ * @param seed The seed of the random approvees
+ *
+ * @return a status code
+ */
+retcode_t synthetic_tangle_generate(hash_to_indexed_hash_set_map_t *const tx_to_approvers,
+                                    flex_trit_t *const entry_point, size_t const size, size_t const width,
+                                    unsigned int const seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_CW_RATING_CALCULATOR_TESTS_SYNTHETIC_TANGLE_H__
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/consensus/test_utils/bundle.h"
+#include "ciri/consensus/test_utils/tangle.h"
+#include "ciri/consensus/tip_selection/cw_rating_calculator/cw_rating_bitset_impl.h"
+#include "ciri/consensus/tip_selection/cw_rating_calculator/cw_rating_dfs_impl.h"
+#include "ciri/consensus/tip_selection/cw_rating_calculator/tests/synthetic_tangle.h"
+
+#define STORED_TRANSACTIONS_NUM 300
+#define STORED_WIDTH 16
+
+static char *tangle_test_db_path = "ciri/consensus/tip_selection/cw_rating_calculator/tests/test.db";
+static storage_connection_config_t config;
+static tangle_t tangle;
+
+static void assert_same_ratings(hash_to_int64_t_map_t const expected, hash_to_int64_t_map_t const actual) {
+  hash_to_int64_t_map_entry_t *entry = NULL;
+  hash_to_int64_t_map_entry_t *tmp_entry = NULL;
+  hash_to_int64_t_map_entry_t *actual_entry = NULL;
+
+  TEST_ASSERT_EQUAL_INT(HASH_COUNT(expected), HASH_COUNT(actual));
+  // The entry point comes first
+  TEST_ASSERT_EQUAL_MEMORY(expected->hash, actual->hash, FLEX_TRIT_SIZE_243);
+
+  HASH_ITER(hh, expected, entry, tmp_entry) {
+    HASH_FIND(hh, actual, entry->hash, FLEX_TRIT_SIZE_243, actual_entry);
+    TEST_ASSERT_NOT_NULL(actual_entry);
+    TEST_ASSERT_EQUAL_INT64(entry->value, actual_entry->value);
+  }
+}
+
+static void test_synthetic(size_t const size, size_t const width, size_t const threads, bool const against_dfs) {
+  hash_to_indexed_hash_set_map_t tx_to_approvers = NULL;
+  hash_to_int64_t_map_t expected = NULL;
+  hash_to_int64_t_map_t actual = NULL;
+  flex_trit_t entry_point[FLEX_TRIT_SIZE_243];
+
+  TEST_ASSERT(synthetic_tangle_generate(&tx_to_approvers, entry_point, size, width, size + width) == RC_OK);
+
+  if (against_dfs) {
+    TEST_ASSERT(cw_rating_dfs_rate(tx_to_approvers, entry_point, size, &expected) == RC_OK);
+  } else {
+    TEST_ASSERT(cw_rating_bitset_rate(tx_to_approvers, entry_point, size, 1, &expected) == RC_OK);
+  }
+  TEST_ASSERT(cw_rating_bitset_rate(tx_to_approvers, entry_point, size, threads, &actual) == RC_OK);
+
+  // Every transaction approves the entry point
+  TEST_ASSERT_EQUAL_INT64(size, actual->value);
+  assert_same_ratings(expected, actual);
+
+  hash_to_int64_t_map_free(&expected);
+  hash_to_int64_t_map_free(&actual);
+  hash_to_indexed_hash_set_map_free(&tx_to_approvers);
+}
+
+void test_single_tx(void) { test_synthetic(1, 1, 1, true); }
+
+void test_chain(void) {
+  hash_to_indexed_hash_set_map_t tx_to_approvers = NULL;
+  hash_to_int64_t_map_t ratings = NULL;
+  hash_to_int64_t_map_entry_t *entry = NULL;
+  hash_to_int64_t_map_entry_t *tmp_entry = NULL;
+  flex_trit_t entry_point[FLEX_TRIT_SIZE_243];
+  int64_t total_weight = 0;
+
+  TEST_ASSERT(synthetic_tangle_generate(&tx_to_approvers, entry_point, 100, 1, 0) == RC_OK);
+  TEST_ASSERT(cw_rating_bitset_rate(tx_to_approvers, entry_point, 100, 1, &ratings) == RC_OK);
+
+  // Sum of series 1 + 2 + ... + 100
+  HASH_ITER(hh, ratings, entry, tmp_entry) { total_weight += entry->value; }
+  TEST_ASSERT_EQUAL_INT64(100 * 101 / 2, total_weight);
+
+  hash_to_int64_t_map_free(&ratings);
+  hash_to_indexed_hash_set_map_free(&tx_to_approvers);
+}
+
+void test_against_dfs(void) {
+  test_synthetic(2000, 2, 1, true);
+  test_synthetic(2000, 64, 1, true);
+}
+
+void test_parallel(void) {
+  test_synthetic(2000, 64, 4, true);
+  // Large enough for layers to be shared between threads
+  test_synthetic(20000, 512, 4, false);
+}
+
+void test_missing_approver(void) {
+  hash_to_indexed_hash_set_map_t tx_to_approvers = NULL;
+  hash_to_int64_t_map_t expected = NULL;
+  hash_to_int64_t_map_t actual = NULL;
+  flex_trit_t entry_point[FLEX_TRIT_SIZE_243];
+  flex_trit_t missing[FLEX_TRIT_SIZE_243];
+
+  // Approvers outside of the subtangle are ignored
+  memset(missing, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+  memset(missing + FLEX_TRIT_SIZE_243 - 8, 1, 8);
+  TEST_ASSERT(synthetic_tangle_generate(&tx_to_approvers, entry_point, 100, 8, 0) == RC_OK);
+  TEST_ASSERT(hash243_set_add(&tx_to_approvers->approvers, missing) == RC_OK);
+
+  TEST_ASSERT(cw_rating_dfs_rate(tx_to_approvers, entry_point, 100, &expected) == RC_OK);
+  TEST_ASSERT(cw_rating_bitset_rate(tx_to_approvers, entry_point, 100, 1, &actual) == RC_OK);
+  assert_same_ratings(expected, actual);
+
+  hash_to_int64_t_map_free(&expected);
+  hash_to_int64_t_map_free(&actual);
+  hash_to_indexed_hash_set_map_free(&tx_to_approvers);
+}
+
+void test_calculate(void) {
+  tryte_t const *const txs_trytes[4] = {TX_1_OF_4_VALUE_BUNDLE_TRYTES, TX_2_OF_4_VALUE_BUNDLE_TRYTES,
+                                        TX_3_OF_4_VALUE_BUNDLE_TRYTES, TX_4_OF_4_VALUE_BUNDLE_TRYTES};
+  iota_transaction_t *txs[4];
+  flex_trit_t entry_point[FLEX_TRIT_SIZE_243];
+  cw_rating_calculator_t dfs_calc, bitset_calc;
+  cw_calc_result expected, actual;
+
+  TEST_ASSERT(tangle_setup(&tangle, &config, tangle_test_db_path) == RC_OK);
+  transactions_deserialize(txs_trytes, txs, 4, true);
+  TEST_ASSERT(build_tangle(&tangle, txs, 4) == RC_OK);
+  // The last transaction of the bundle is approved by the three others
+  memcpy(entry_point, transaction_hash(txs[3]), FLEX_TRIT_SIZE_243);
+
+  TEST_ASSERT(iota_consensus_cw_rating_init(&dfs_calc, DFS_FROM_ENTRY_POINT) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_init(&bitset_calc, TOPOLOGICAL_BITSET_PROPAGATION) == RC_OK);
+  bitset_calc.threads = 2;
+
+  TEST_ASSERT(iota_consensus_cw_rating_calculate(&dfs_calc, &tangle, entry_point, &expected) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_calculate(&bitset_calc, &tangle, entry_point, &actual) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(4, HASH_COUNT(actual.tx_to_approvers));
+  TEST_ASSERT_EQUAL_INT64(4, actual.cw_ratings->value);
+  assert_same_ratings(expected.cw_ratings, actual.cw_ratings);
+
+  cw_calc_result_destroy(&expected);
+  cw_calc_result_destroy(&actual);
+  TEST_ASSERT(iota_consensus_cw_rating_destroy(&dfs_calc) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_destroy(&bitset_calc) == RC_OK);
+  transactions_free(txs, 4);
+  TEST_ASSERT(tangle_cleanup(&tangle, tangle_test_db_path) == RC_OK);
+}
+
+static void stored_hash(flex_trit_t *const hash, size_t const i) {
+  static tryte_t const alphabet[] = "9ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  tryte_t trytes[NUM_TRYTES_HASH];
+
+  memset(trytes, '9', NUM_TRYTES_HASH);
+  trytes[0] = alphabet[i % 27];
+  trytes[1] = alphabet[(i / 27) % 27];
+  trytes[2] = alphabet[i / (27 * 27)];
+  flex_trits_from_trytes(hash, NUM_TRITS_HASH, trytes, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+}
+
+void test_calculate_stored_subtangle(void) {
+  tryte_t const *const txs_trytes[1] = {TX_1_OF_4_VALUE_BUNDLE_TRYTES};
+  iota_transaction_t *txs[1];
+  iota_transaction_t tx = {};
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t entry_point[FLEX_TRIT_SIZE_243];
+  cw_rating_calculator_t dfs_calc, bitset_calc;
+  cw_calc_result expected, actual;
+
+  TEST_ASSERT(tangle_setup(&tangle, &config, tangle_test_db_path) == RC_OK);
+  transactions_deserialize(txs_trytes, txs, 1, true);
+
+  // Every transaction approves two of the previous ones, the first one being approved by all of them and approving a
+  // transaction that is not stored
+  stored_hash(entry_point, 0);
+  for (size_t i = 0; i < STORED_TRANSACTIONS_NUM; i++) {
+    size_t const window = i < STORED_WIDTH ? i : STORED_WIDTH;
+
+    tx = *txs[0];
+    stored_hash(hash, i);
+    transaction_set_hash(&tx, hash);
+    stored_hash(hash, i == 0 ? STORED_TRANSACTIONS_NUM : i - 1 - (i * 7) % window);
+    transaction_set_trunk(&tx, hash);
+    stored_hash(hash, i == 0 ? STORED_TRANSACTIONS_NUM : i - 1 - (i * 13) % window);
+    transaction_set_branch(&tx, hash);
+    TEST_ASSERT(iota_tangle_transaction_store(&tangle, &tx) == RC_OK);
+  }
+
+  TEST_ASSERT(iota_consensus_cw_rating_init(&dfs_calc, DFS_FROM_ENTRY_POINT) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_init(&bitset_calc, TOPOLOGICAL_BITSET_PROPAGATION) == RC_OK);
+  bitset_calc.threads = 4;
+
+  TEST_ASSERT(iota_consensus_cw_rating_calculate(&dfs_calc, &tangle, entry_point, &expected) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_calculate(&bitset_calc, &tangle, entry_point, &actual) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(STORED_TRANSACTIONS_NUM, HASH_COUNT(actual.tx_to_approvers));
+  TEST_ASSERT_EQUAL_INT64(STORED_TRANSACTIONS_NUM, actual.cw_ratings->value);
+  assert_same_ratings(expected.cw_ratings, actual.cw_ratings);
+
+  cw_calc_result_destroy(&expected);
+  cw_calc_result_destroy(&actual);
+  TEST_ASSERT(iota_consensus_cw_rating_destroy(&dfs_calc) == RC_OK);
+  TEST_ASSERT(iota_consensus_cw_rating_destroy(&bitset_calc) == RC_OK);
+  transactions_free(txs, 1);
+  TEST_ASSERT(tangle_cleanup(&tangle, tangle_test_db_path) == RC_OK);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  TEST_ASSERT(storage_init() == RC_OK);
+
+  config.db_path = tangle_test_db_path;
+
+  RUN_TEST(test_single_tx);
+  RUN_TEST(test_chain);
+  RUN_TEST(test_against_dfs);
+  RUN_TEST(test_parallel);
+  RUN_TEST(test_missing_approver);
+  RUN_TEST(test_calculate);
+  RUN_TEST(test_calculate_stored_subtangle);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
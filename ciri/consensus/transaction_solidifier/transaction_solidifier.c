@@ -40,6 +40,7 @@ typedef struct check_solidity_do_func_params_s {
   hash243_set_t *solid_transactions_candidates;
   hash243_set_t *solid_entry_points;
   int max_analyzed;
+  bool milestone;
 } check_solidity_do_func_params_t;
 
 static retcode_t propagate_solid_transactions(transaction_solidifier_t *const ts, tangle_t *const tangle) {
@@ -225,7 +226,7 @@ static retcode_t check_solidity_do_func(flex_trit_t *hash, iota_stor_pack_t *pac
     return hash243_set_add(params->solid_transactions_candidates, hash);
   } else if (pack->num_loaded == 0 && !hash243_set_contains(*params->solid_entry_points, hash)) {
     params->is_solid = false;
-    return request_transaction(ts->transaction_requester, tangle, hash);
+    return request_transaction(ts->transaction_requester, tangle, hash, params->milestone);
   }
 
   return RC_OK;
@@ -233,7 +234,8 @@ static retcode_t check_solidity_do_func(flex_trit_t *hash, iota_stor_pack_t *pac
 
 retcode_t iota_consensus_transaction_solidifier_check_solidity(transaction_solidifier_t *const ts,
                                                                tangle_t *const tangle, flex_trit_t *const hash,
-                                                               int max_analyzed, bool *const is_solid) {
+                                                               int max_analyzed, bool const milestone,
+                                                               bool *const is_solid) {
   retcode_t ret = RC_OK;
   DECLARE_PACK_SINGLE_TX(curr_tx_s, curr_tx, pack);
   hash243_set_t solid_transactions_candidates = NULL;
@@ -261,7 +263,8 @@ retcode_t iota_consensus_transaction_solidifier_check_solidity(transaction_solid
                                             .is_solid = true,
                                             .solid_transactions_candidates = &solid_transactions_candidates,
                                             .solid_entry_points = &solid_entry_points_hashes,
-                                            .max_analyzed = max_analyzed};
+                                            .max_analyzed = max_analyzed,
+                                            .milestone = milestone};
 
   if ((ret = tangle_traversal_dfs_to_past(tangle, check_solidity_do_func, hash, ts->conf->genesis_hash,
                                           &analyzed_hashes, &params)) != RC_OK) {
@@ -399,27 +402,29 @@ static retcode_t add_new_solid_transaction(transaction_solidifier_t *const ts, f
   return tips_cache_set_solid(ts->tips, hash);
 }
 
-retcode_t iota_consensus_transaction_solidifier_update_status(transaction_solidifier_t *const ts,
-                                                              tangle_t *const tangle, iota_transaction_t *const tx) {
+static retcode_t transaction_approved(flex_trit_t const *const hash, void *const tangle, bool *const approved) {
   retcode_t ret = RC_OK;
   uint64_t approvers_count = 0;
 
-  if ((ret = requester_clear_request(ts->transaction_requester, transaction_hash(tx))) != RC_OK) {
+  if ((ret = iota_tangle_transaction_approvers_count((tangle_t *)tangle, hash, &approvers_count)) != RC_OK) {
     return ret;
   }
+  *approved = approvers_count != 0;
 
-  if ((ret = iota_tangle_transaction_approvers_count(tangle, transaction_hash(tx), &approvers_count)) != RC_OK) {
-    return ret;
-  }
+  return ret;
+}
 
-  if (approvers_count == 0) {
-    if ((ret = tips_cache_add(ts->tips, transaction_hash(tx))) != RC_OK) {
-      return ret;
-    }
+retcode_t iota_consensus_transaction_solidifier_update_status(transaction_solidifier_t *const ts,
+                                                              tangle_t *const tangle, iota_transaction_t *const tx) {
+  retcode_t ret = RC_OK;
+
+  if ((ret = requester_clear_request(ts->transaction_requester, transaction_hash(tx))) != RC_OK) {
+    return ret;
   }
 
-  if ((ret = tips_cache_remove(ts->tips, transaction_trunk(tx))) != RC_OK ||
-      (ret = tips_cache_remove(ts->tips, transaction_branch(tx))) != RC_OK) {
+  // Validator workers update statuses concurrently, the tips cache serializes the approvers check with the update
+  if ((ret = tips_cache_update(ts->tips, transaction_hash(tx), transaction_trunk(tx), transaction_branch(tx),
+                               transaction_approved, tangle)) != RC_OK) {
     return ret;
   }
 
@@ -23,8 +23,8 @@ retcode_t core_init(core_t* const core, tangle_t* const tangle) {
   core->running = false;
 
   log_info(logger_id, "Initializing consensus\n");
-  if ((ret = iota_consensus_init(&core->consensus, tangle, &core->node.transaction_requester, &core->node.tips)) !=
-      RC_OK) {
+  if ((ret = iota_consensus_init(&core->consensus, tangle, &core->node.transaction_requester, &core->node.tips,
+                                 &core->node.responder.cache)) != RC_OK) {
     log_critical(logger_id, "Initializing consensus failed\n");
     return ret;
   }
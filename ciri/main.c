@@ -5,6 +5,8 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -17,6 +19,7 @@
 
 #define MAIN_LOGGER_ID "ciri"
 #define STATS_LOG_INTERVAL_S 10
+#define TANGLE_FILTER_PATH_SUFFIX ".filter"
 
 static core_t ciri_core;
 static iota_api_t api;
@@ -149,6 +152,14 @@ int main(int argc, char* argv[]) {
   {
     storage_connection_config_t db_conf = {.db_path = ciri_core.conf.tangle_db_path};
 
+    if (ciri_core.conf.tangle_db_readers > 0) {
+      log_info(logger_id, "Initializing tangle connection pool\n");
+      if (iota_tangle_pool_enable(&db_conf, ciri_core.conf.tangle_db_readers) != RC_OK) {
+        log_critical(logger_id, "Initializing tangle connection pool failed\n");
+        return EXIT_FAILURE;
+      }
+    }
+
     if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
       log_critical(logger_id, "Initializing tangle connection failed\n");
       return EXIT_FAILURE;
@@ -163,6 +174,35 @@ int main(int argc, char* argv[]) {
     }
   }
 
+  if (ciri_core.conf.tangle_graph_enabled) {
+    log_info(logger_id, "Initializing tangle graph\n");
+    if (iota_tangle_graph_enable(&tangle) != RC_OK) {
+      log_critical(logger_id, "Initializing tangle graph failed\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (ciri_core.conf.tangle_cache_size > 0) {
+    log_info(logger_id, "Initializing tangle cache\n");
+    if (iota_tangle_cache_enable(&tangle, ciri_core.conf.tangle_cache_size) != RC_OK) {
+      log_critical(logger_id, "Initializing tangle cache failed\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (ciri_core.conf.tangle_filter_size > 0) {
+    char filter_path[FILE_PATH_SIZE + sizeof(TANGLE_FILTER_PATH_SUFFIX)];
+
+    // The filter is saved next to the database it was built from
+    snprintf(filter_path, sizeof(filter_path), "%s" TANGLE_FILTER_PATH_SUFFIX, ciri_core.conf.tangle_db_path);
+    log_info(logger_id, "Initializing tangle filter\n");
+    if (iota_tangle_filter_enable(&tangle, filter_path, ciri_core.conf.tangle_filter_size,
+                                  ciri_core.conf.tangle_filter_false_positive_rate) != RC_OK) {
+      log_critical(logger_id, "Initializing tangle filter failed\n");
+      return EXIT_FAILURE;
+    }
+  }
+
   log_info(logger_id, "Initializing cIRI\n");
   if (ciri_init() != RC_OK) {
     log_critical(logger_id, "Initializing cIRI failed\n");
@@ -191,6 +231,100 @@ int main(int argc, char* argv[]) {
                validator_stage_size(&ciri_core.node.validator), broadcaster_stage_size(&ciri_core.node.broadcaster),
                requester_size(&ciri_core.node.transaction_requester), responder_stage_size(&ciri_core.node.responder),
                count);
+      {
+        stage_queue_stats_t processor_stats, hasher_stats, validator_stats, broadcaster_stats, responder_stats;
+
+        stage_queue_stats(&ciri_core.node.processor.queue, &processor_stats);
+        stage_queue_stats(&ciri_core.node.hasher.queue, &hasher_stats);
+        validator_stage_stats(&ciri_core.node.validator, &validator_stats);
+        stage_queue_stats(&ciri_core.node.broadcaster.queue, &broadcaster_stats);
+        stage_queue_stats(&ciri_core.node.responder.queue, &responder_stats);
+        log_info(logger_id,
+                 "Dropped: to process %" PRIu64 ", to hash %" PRIu64 ", to validate %" PRIu64 ", to broadcast %" PRIu64
+                 ", to reply %" PRIu64 "\n",
+                 processor_stats.dropped, hasher_stats.dropped, validator_stats.dropped, broadcaster_stats.dropped,
+                 responder_stats.dropped);
+      }
+      {
+        hasher_stage_stats_t hasher_stats;
+        double fill_ratio = 0.0;
+
+        hasher_stage_stats(&ciri_core.node.hasher, &hasher_stats);
+        if (hasher_stats.batches > 0) {
+          fill_ratio = (double)hasher_stats.hashes / (hasher_stats.batches * hasher_stats.lanes);
+        }
+        log_info(logger_id, "Hasher: batches %" PRIu64 ", full batches %" PRIu64 ", lanes fill ratio %.2f\n",
+                 hasher_stats.batches, hasher_stats.full_batches, fill_ratio);
+      }
+      {
+        recent_seen_bytes_cache_stats_t cache_stats;
+        double hit_ratio = 0.0;
+
+        recent_seen_bytes_cache_stats(&ciri_core.node.recent_seen_bytes, &cache_stats);
+        if (cache_stats.hit + cache_stats.miss > 0) {
+          hit_ratio = (double)cache_stats.hit / (cache_stats.hit + cache_stats.miss);
+        }
+        log_info(logger_id, "Recent seen bytes: size %zu, hit ratio %.2f, evictions %" PRIu64 "\n", cache_stats.size,
+                 hit_ratio, cache_stats.evictions);
+      }
+      if (tangle.graph != NULL) {
+        log_info(logger_id, "Tangle graph: size %zu\n", tangle_graph_size(tangle.graph));
+      }
+      {
+        tangle_partial_cache_stats_t cache_stats;
+        double hit_ratio[TANGLE_PARTIAL_CACHE_MODELS_NUM];
+
+        if (iota_tangle_cache_stats(&cache_stats)) {
+          for (size_t i = 0; i < TANGLE_PARTIAL_CACHE_MODELS_NUM; i++) {
+            hit_ratio[i] = 0.0;
+            if (cache_stats.hit[i] + cache_stats.miss[i] > 0) {
+              hit_ratio[i] = (double)cache_stats.hit[i] / (cache_stats.hit[i] + cache_stats.miss[i]);
+            }
+          }
+          log_info(logger_id,
+                   "Tangle cache: size %zu, hit ratio metadata %.2f, essence metadata %.2f, essence attachment "
+                   "metadata %.2f, essence consensus %.2f, evictions %" PRIu64 ", invalidations %" PRIu64 "\n",
+                   cache_stats.size, hit_ratio[TANGLE_PARTIAL_CACHE_METADATA],
+                   hit_ratio[TANGLE_PARTIAL_CACHE_ESSENCE_METADATA],
+                   hit_ratio[TANGLE_PARTIAL_CACHE_ESSENCE_ATTACHMENT_METADATA],
+                   hit_ratio[TANGLE_PARTIAL_CACHE_ESSENCE_CONSENSUS], cache_stats.evictions,
+                   cache_stats.invalidations);
+        }
+      }
+      {
+        tangle_filter_stats_t filter_stats;
+        double hit_ratio = 0.0;
+
+        if (iota_tangle_filter_stats(&filter_stats)) {
+          if (filter_stats.hit + filter_stats.miss > 0) {
+            hit_ratio = (double)filter_stats.hit / (filter_stats.hit + filter_stats.miss);
+          }
+          log_info(logger_id,
+                   "Tangle filter: size %zu/%zu, hit ratio %.2f, false positives %" PRIu64 ", saturated %s\n",
+                   filter_stats.size, filter_stats.capacity, hit_ratio, filter_stats.false_positives,
+                   filter_stats.saturated ? "yes" : "no");
+        }
+      }
+      {
+        storage_pool_stats_t pool_stats;
+
+        if (iota_tangle_pool_stats(&pool_stats)) {
+          log_info(logger_id,
+                   "Tangle connection pool: readers %zu/%zu, checkouts %" PRIu64 ", exhaustions %" PRIu64
+                   ", writer checkouts %" PRIu64 ", writer waits %" PRIu64 ", time in writer waits %.2f ms\n",
+                   pool_stats.readers_in_use, pool_stats.readers_open, pool_stats.reader_checkouts,
+                   pool_stats.reader_exhaustions, pool_stats.writer_checkouts, pool_stats.writer_waits,
+                   pool_stats.writer_wait_us / 1e3);
+        }
+      }
+      for (size_t i = 0; i < ciri_core.node.router.loops_num; i++) {
+        router_loop_stats_t loop_stats;
+
+        if (router_loop_stats(&ciri_core.node.router, i, &loop_stats) == RC_OK) {
+          log_info(logger_id, "Router loop %zu: neighbors %zu, reads %" PRIu64 ", time in reads %.2f ms\n", i,
+                   loop_stats.neighbors, loop_stats.reads, loop_stats.read_time / 1e6);
+        }
+      }
       sleep(STATS_LOG_INTERVAL_S);
     }
   }
@@ -203,11 +337,31 @@ destroy:
     ret = EXIT_FAILURE;
   }
 
+  if (iota_tangle_filter_disable(&tangle) != RC_OK) {
+    log_error(logger_id, "Destroying tangle filter failed\n");
+    ret = EXIT_FAILURE;
+  }
+
+  if (iota_tangle_cache_disable(&tangle) != RC_OK) {
+    log_error(logger_id, "Destroying tangle cache failed\n");
+    ret = EXIT_FAILURE;
+  }
+
+  if (iota_tangle_graph_disable(&tangle) != RC_OK) {
+    log_error(logger_id, "Destroying tangle graph failed\n");
+    ret = EXIT_FAILURE;
+  }
+
   if (iota_tangle_destroy(&tangle) != RC_OK) {
     log_error(logger_id, "Destroying tangle connection failed\n");
     ret = EXIT_FAILURE;
   }
 
+  if (iota_tangle_pool_disable() != RC_OK) {
+    log_error(logger_id, "Destroying tangle connection pool failed\n");
+    ret = EXIT_FAILURE;
+  }
+
   log_info(logger_id, "Destroying storage\n");
   if (storage_destroy() != RC_OK) {
     log_error(logger_id, "Destroying storage failed\n");
@@ -19,8 +19,12 @@ retcode_t iota_node_conf_init(iota_node_conf_t* const conf) {
   conf->neighbors = DEFAULT_NEIGHBORS;
   conf->p_send_milestone = DEFAULT_PROBABILITY_SEND_MILESTONE;
   conf->recent_seen_bytes_cache_size = DEFAULT_RECENT_SEEN_BYTES_CACHE_SIZE;
+  conf->recent_seen_bytes_cache_shards = DEFAULT_RECENT_SEEN_BYTES_CACHE_SHARDS;
   conf->requester_queue_size = DEFAULT_REQUESTER_QUEUE_SIZE;
+  conf->requester_retry_interval = DEFAULT_REQUESTER_RETRY_INTERVAL;
+  conf->pipeline_queue_size = DEFAULT_PIPELINE_QUEUE_SIZE;
   conf->tips_cache_size = DEFAULT_TIPS_CACHE_SIZE;
+  conf->transaction_bytes_cache_size = DEFAULT_TRANSACTION_BYTES_CACHE_SIZE;
   flex_trits_from_trytes(coordinator_address, HASH_LENGTH_TRIT, (tryte_t*)COORDINATOR_ADDRESS, HASH_LENGTH_TRYTE,
                          HASH_LENGTH_TRYTE);
   flex_trits_to_bytes(conf->coordinator_address, HASH_LENGTH_TRIT, coordinator_address, HASH_LENGTH_TRIT,
@@ -29,7 +33,15 @@ retcode_t iota_node_conf_init(iota_node_conf_t* const conf) {
   conf->neighboring_port = DEFAULT_NEIGHBORING_PORT;
   conf->auto_tethering_enabled = DEFAULT_AUTO_TETHERING_ENABLED;
   conf->max_neighbors = DEFAULT_MAX_NEIGHBORS;
+  conf->neighbor_ingress_rate = DEFAULT_NEIGHBOR_INGRESS_RATE;
   conf->reconnect_attempt_interval = DEFAULT_RECONNECT_ATTEMPT_INTERVAL;
+  conf->validator_threads = DEFAULT_VALIDATOR_THREADS;
+  conf->store_batch_size = DEFAULT_STORE_BATCH_SIZE;
+  conf->store_batch_delay = DEFAULT_STORE_BATCH_DELAY;
+  conf->router_threads = DEFAULT_ROUTER_THREADS;
+  conf->hasher_threads = DEFAULT_HASHER_THREADS;
+  conf->hasher_batch_fill = DEFAULT_HASHER_BATCH_FILL;
+  conf->hasher_batch_delay = DEFAULT_HASHER_BATCH_DELAY;
 
   return RC_OK;
 }
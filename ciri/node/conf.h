@@ -17,17 +17,29 @@
 
 #define DEFAULT_AUTO_TETHERING_ENABLED false
 #define DEFAULT_COORDINATOR_ADDRESS COORDINATOR_ADDRESS
+#define DEFAULT_HASHER_BATCH_DELAY 0
+#define DEFAULT_HASHER_BATCH_FILL 100
+#define DEFAULT_HASHER_THREADS 1
 #define DEFAULT_MAX_NEIGHBORS 5
 #define DEFAULT_MWN MWM
+#define DEFAULT_NEIGHBOR_INGRESS_RATE 0
 #define DEFAULT_NEIGHBORING_ADDRESS "0.0.0.0"
 #define DEFAULT_NEIGHBORING_PORT 15600
 #define DEFAULT_NEIGHBORS NULL
+#define DEFAULT_PIPELINE_QUEUE_SIZE 4096
 #define DEFAULT_PROBABILITY_REPLY_RANDOM_TIP 0.66
 #define DEFAULT_PROBABILITY_SEND_MILESTONE 0.02
+#define DEFAULT_RECENT_SEEN_BYTES_CACHE_SHARDS 16
 #define DEFAULT_RECENT_SEEN_BYTES_CACHE_SIZE 1500
 #define DEFAULT_RECONNECT_ATTEMPT_INTERVAL 60
 #define DEFAULT_REQUESTER_QUEUE_SIZE 10000
+#define DEFAULT_REQUESTER_RETRY_INTERVAL 1000
+#define DEFAULT_ROUTER_THREADS 1
+#define DEFAULT_STORE_BATCH_DELAY 2000
+#define DEFAULT_STORE_BATCH_SIZE 64
 #define DEFAULT_TIPS_CACHE_SIZE 5000
+#define DEFAULT_TRANSACTION_BYTES_CACHE_SIZE 5000
+#define DEFAULT_VALIDATOR_THREADS 2
 
 #ifdef __cplusplus
 extern "C" {
@@ -45,10 +57,18 @@ typedef struct iota_node_conf_s {
   double p_send_milestone;
   // Size of the tips cache
   size_t tips_cache_size;
+  // Number of transactions whose gossip bytes are cached by the responder, 0 disables the cache
+  size_t transaction_bytes_cache_size;
   // The number of entries to keep in the network cache
   size_t recent_seen_bytes_cache_size;
+  // The number of independently locked shards of the network cache
+  size_t recent_seen_bytes_cache_shards;
   // Size of the requester queue
   size_t requester_queue_size;
+  // Interval (in milliseconds) before a missing transaction is requested again, doubled after each attempt
+  uint64_t requester_retry_interval;
+  // Maximum number of elements queued in front of each pipeline stage, additional elements are dropped
+  size_t pipeline_queue_size;
   // Path of the tangle database file
   char tangle_db_path[FILE_PATH_SIZE];
   // The address of the coordinator encoded in bytes
@@ -62,8 +82,25 @@ typedef struct iota_node_conf_s {
   bool auto_tethering_enabled;
   // The maximum number of neighbors allowed to be connected
   size_t max_neighbors;
+  // Maximum number of transactions per second received from a neighbor, lowered for neighbors sending invalid or stale
+  // transactions, 0 for no limit
+  size_t neighbor_ingress_rate;
   // The interval (in seconds) at which to reconnect to neighbors
   size_t reconnect_attempt_interval;
+  // Number of router threads, each one running an event loop serving the neighbors pinned to it
+  size_t router_threads;
+  // Number of validator threads, each one having its own tangle connection
+  size_t validator_threads;
+  // Maximum number of new transactions a validator thread stores in a single database transaction
+  size_t store_batch_size;
+  // Maximum time (in microseconds) a new transaction waits for its batch to be stored
+  uint64_t store_batch_delay;
+  // Number of hasher threads
+  size_t hasher_threads;
+  // Percentage of the lanes of a Curl transform a hasher thread waits to fill before hashing
+  size_t hasher_batch_fill;
+  // Maximum time (in microseconds) a transaction waits for its hasher batch to be filled
+  uint64_t hasher_batch_delay;
 } iota_node_conf_t;
 
 /**
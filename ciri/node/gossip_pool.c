@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "ciri/node/gossip_pool.h"
+
+/**
+ * A pooled packet is preceded by its reference count and the pool it belongs to
+ */
+typedef struct gossip_buffer_s {
+  atomic_uint refs;
+  gossip_pool_t *pool;
+  protocol_gossip_t gossip;
+} gossip_buffer_t;
+
+/*
+ * Private functions
+ */
+
+static inline gossip_buffer_t *gossip_buffer_from_gossip(protocol_gossip_t *const gossip) {
+  return (gossip_buffer_t *)((uint8_t *)gossip - offsetof(gossip_buffer_t, gossip));
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t gossip_pool_init(gossip_pool_t *const pool, size_t const capacity) {
+  if (pool == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  return lf_ring_buffer_init(&pool->free_buffers, capacity, sizeof(gossip_buffer_t *));
+}
+
+void gossip_pool_destroy(gossip_pool_t *const pool) {
+  gossip_buffer_t *buffer = NULL;
+
+  if (pool == NULL) {
+    return;
+  }
+
+  while (lf_ring_buffer_pop(&pool->free_buffers, &buffer)) {
+    free(buffer);
+  }
+  lf_ring_buffer_destroy(&pool->free_buffers);
+}
+
+protocol_gossip_t *gossip_pool_acquire(gossip_pool_t *const pool) {
+  gossip_buffer_t *buffer = NULL;
+
+  if (pool == NULL) {
+    return NULL;
+  }
+
+  if (!lf_ring_buffer_pop(&pool->free_buffers, &buffer)) {
+    if ((buffer = (gossip_buffer_t *)malloc(sizeof(gossip_buffer_t))) == NULL) {
+      return NULL;
+    }
+    buffer->pool = pool;
+  }
+  atomic_init(&buffer->refs, 1);
+
+  return &buffer->gossip;
+}
+
+protocol_gossip_t *gossip_pool_ref(protocol_gossip_t *const gossip) {
+  if (gossip == NULL) {
+    return NULL;
+  }
+
+  atomic_fetch_add_explicit(&gossip_buffer_from_gossip(gossip)->refs, 1, memory_order_relaxed);
+
+  return gossip;
+}
+
+void gossip_pool_release(protocol_gossip_t *const gossip) {
+  gossip_buffer_t *buffer = NULL;
+
+  if (gossip == NULL) {
+    return;
+  }
+
+  buffer = gossip_buffer_from_gossip(gossip);
+  if (atomic_fetch_sub_explicit(&buffer->refs, 1, memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  if (lf_ring_buffer_push(&buffer->pool->free_buffers, &buffer) != RC_OK) {
+    free(buffer);
+  }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CIRI_NODE_GOSSIP_POOL_H__
+#define __CIRI_NODE_GOSSIP_POOL_H__
+
+#include <stddef.h>
+
+#include "ciri/node/protocol/gossip.h"
+#include "common/errors.h"
+#include "utils/containers/lf_ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A pool of reference counted gossip packets
+ *
+ * Packets flow through the pipeline stages as pointers to pooled buffers instead of being copied from a stage to
+ * another. A packet is acquired with a single reference, each additional owner takes a reference and the packet goes
+ * back to the pool when the last reference is released. Released packets are kept in a lock-free ring buffer so that
+ * acquiring and releasing them from different threads neither allocates nor locks in the steady state. When the pool
+ * is exhausted, packets are allocated and freed on demand.
+ */
+typedef struct gossip_pool_s {
+  lf_ring_buffer_t free_buffers; /*!< Buffers available for reuse */
+} gossip_pool_t;
+
+/**
+ * @brief Initializes a gossip pool
+ *
+ * @param[out]  pool      The gossip pool
+ * @param[in]   capacity  The maximum number of released packets kept for reuse
+ *
+ * @return a status code
+ */
+retcode_t gossip_pool_init(gossip_pool_t *const pool, size_t const capacity);
+
+/**
+ * @brief Destroys a gossip pool
+ *
+ * All packets acquired from the pool must have been released beforehand.
+ *
+ * @param[in,out] pool  The gossip pool
+ */
+void gossip_pool_destroy(gossip_pool_t *const pool);
+
+/**
+ * @brief Acquires a packet from a gossip pool
+ *
+ * The content of the packet is undefined.
+ *
+ * @param[in,out] pool  The gossip pool
+ *
+ * @return a packet holding a single reference, NULL if it could not be allocated
+ */
+protocol_gossip_t *gossip_pool_acquire(gossip_pool_t *const pool);
+
+/**
+ * @brief Takes an additional reference on a pooled packet
+ *
+ * @param[in,out] gossip  The packet
+ *
+ * @return the packet
+ */
+protocol_gossip_t *gossip_pool_ref(protocol_gossip_t *const gossip);
+
+/**
+ * @brief Releases a reference on a pooled packet, the packet goes back to its pool with the last reference
+ *
+ * @param[in,out] gossip  The packet, may be NULL
+ */
+void gossip_pool_release(protocol_gossip_t *const gossip);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CIRI_NODE_GOSSIP_POOL_H__
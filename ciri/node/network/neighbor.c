@@ -11,6 +11,7 @@
 #include "ciri/node/network/uri.h"
 #include "ciri/node/node.h"
 #include "utils/handles/rand.h"
+#include "utils/macros.h"
 
 retcode_t neighbor_init(neighbor_t *const neighbor) {
   if (neighbor == NULL) {
@@ -22,6 +23,7 @@ retcode_t neighbor_init(neighbor_t *const neighbor) {
   neighbor->endpoint.stream = NULL;
   neighbor->state = NEIGHBOR_DISCONNECTED;
   neighbor->write_queue = NULL;
+  neighbor->ingress_weight = NEIGHBOR_INGRESS_WEIGHT_MAX;
 
   return RC_OK;
 }
@@ -82,49 +84,109 @@ retcode_t neighbor_init_with_values(neighbor_t *const neighbor, char const *cons
   return RC_OK;
 }
 
-retcode_t neighbor_send_packet(node_t *const node, neighbor_t *const neighbor, protocol_gossip_t const *const packet) {
-  retcode_t ret = RC_OK;
+neighbor_packet_t *neighbor_packet_new(protocol_gossip_t const *const packet) {
+  neighbor_packet_t *serialized = NULL;
   protocol_header_t header;
   size_t content_length = GOSSIP_SIG_MAX_BYTES_LENGTH;
-  void *buffer = NULL;
-  size_t buffer_size = 0;
   size_t offset = 0;
 
-  if (node == NULL || neighbor == NULL || neighbor->endpoint.stream == NULL || packet == NULL) {
-    return RC_NULL_PARAM;
+  if (packet == NULL) {
+    return NULL;
   }
 
   for (int i = GOSSIP_SIG_MAX_BYTES_LENGTH - 1; i >= 0 && packet->content[i] == 0; i--) {
     content_length--;
   }
 
-  buffer_size = content_length + GOSSIP_NON_SIG_BYTES_LENGTH + GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH;
-
-  if ((buffer = malloc(HEADER_BYTES_LENGTH + buffer_size)) == NULL) {
-    return RC_OOM;
+  if ((serialized = (neighbor_packet_t *)malloc(sizeof(neighbor_packet_t) + HEADER_BYTES_LENGTH + content_length +
+                                                GOSSIP_NON_SIG_BYTES_LENGTH)) == NULL) {
+    return NULL;
   }
+  atomic_init(&serialized->refs, 1);
+  serialized->size = HEADER_BYTES_LENGTH + content_length + GOSSIP_NON_SIG_BYTES_LENGTH;
 
   header.type = PROTOCOL_GOSSIP;
-  header.length = htons(buffer_size);
+  header.length = htons(content_length + GOSSIP_NON_SIG_BYTES_LENGTH + GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH);
 
-  memcpy(buffer + offset, &header, HEADER_BYTES_LENGTH);
+  memcpy(serialized->bytes + offset, &header, HEADER_BYTES_LENGTH);
   offset += HEADER_BYTES_LENGTH;
-  memcpy(buffer + offset, packet->content, content_length);
+  memcpy(serialized->bytes + offset, packet->content, content_length);
   offset += content_length;
-  memcpy(buffer + offset, packet->content + GOSSIP_SIG_MAX_BYTES_LENGTH,
-         GOSSIP_NON_SIG_BYTES_LENGTH + GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH);
+  memcpy(serialized->bytes + offset, packet->content + GOSSIP_SIG_MAX_BYTES_LENGTH, GOSSIP_NON_SIG_BYTES_LENGTH);
+
+  return serialized;
+}
+
+void neighbor_packet_release(neighbor_packet_t *const packet) {
+  if (packet != NULL && atomic_fetch_sub_explicit(&packet->refs, 1, memory_order_acq_rel) == 1) {
+    free(packet);
+  }
+}
+
+retcode_t neighbor_queue_packet(node_t *const node, tangle_t const *const tangle, neighbor_t *const neighbor,
+                                neighbor_packet_t *const packet, protocol_gossip_t const *const gossip) {
+  retcode_t ret = RC_OK;
+  flex_trit_t request[FLEX_TRIT_SIZE_243];
+  byte_t request_bytes[GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH];
+  size_t request_size = 0;
+
+  if (node == NULL || tangle == NULL || neighbor == NULL || packet == NULL || gossip == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((ret = get_transaction_to_request(&node->transaction_requester, tangle, neighbor, request)) != RC_OK) {
+    return ret;
+  }
+
+  request_size = HASH_LENGTH_TRIT - node->conf.mwm;
+  memcpy(request_bytes, gossip->content + GOSSIP_TX_BYTES_LENGTH, GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH);
+  if (flex_trits_to_bytes(request_bytes, request_size, request, HASH_LENGTH_TRIT, request_size) != request_size) {
+    return RC_NODE_SET_PACKET_REQUEST_FAILED;
+  }
 
   lock_handle_lock(&neighbor->write_queue_lock);
-  neighbor_write_queue_push(neighbor, buffer, HEADER_BYTES_LENGTH + buffer_size);
+  ret = neighbor_write_queue_push(neighbor, packet, request_bytes);
   lock_handle_unlock(&neighbor->write_queue_lock);
 
+  return ret;
+}
+
+retcode_t neighbor_flush(neighbor_t *const neighbor) {
+  if (neighbor == NULL) {
+    return RC_NULL_PARAM;
+  }
+
   // TODO not here
   neighbor->writer->data = neighbor;
   if (uv_async_send(neighbor->writer) != 0) {
     return RC_ASYNC_CALL_FAILED;
   }
 
-  return ret;
+  return RC_OK;
+}
+
+retcode_t neighbor_send_packet(node_t *const node, neighbor_t *const neighbor, protocol_gossip_t const *const packet) {
+  retcode_t ret = RC_OK;
+  neighbor_packet_t *serialized = NULL;
+
+  if (node == NULL || neighbor == NULL || neighbor->endpoint.stream == NULL || packet == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((serialized = neighbor_packet_new(packet)) == NULL) {
+    return RC_OOM;
+  }
+
+  lock_handle_lock(&neighbor->write_queue_lock);
+  ret = neighbor_write_queue_push(neighbor, serialized, packet->content + GOSSIP_TX_BYTES_LENGTH);
+  lock_handle_unlock(&neighbor->write_queue_lock);
+  neighbor_packet_release(serialized);
+
+  if (ret != RC_OK) {
+    return ret;
+  }
+
+  return neighbor_flush(neighbor);
 }
 
 static retcode_t neighbor_send(node_t *const node, tangle_t const *const tangle, neighbor_t *const neighbor,
@@ -132,7 +194,7 @@ static retcode_t neighbor_send(node_t *const node, tangle_t const *const tangle,
   retcode_t ret = RC_OK;
   flex_trit_t request[FLEX_TRIT_SIZE_243];
 
-  if ((ret = get_transaction_to_request(&node->transaction_requester, tangle, request)) != RC_OK) {
+  if ((ret = get_transaction_to_request(&node->transaction_requester, tangle, neighbor, request)) != RC_OK) {
     return ret;
   }
 
@@ -172,24 +234,67 @@ retcode_t neighbor_send_bytes(node_t *const node, tangle_t const *const tangle,
   return neighbor_send(node, tangle, neighbor, &packet);
 }
 
-retcode_t neighbor_write_queue_push(neighbor_t *const neighbor, void *const buffer, size_t const buffer_size) {
-  uv_buf_t_queue_entry_t *entry = NULL;
+bool neighbor_ingress_allow(neighbor_t *const neighbor, size_t const rate, uint64_t const now) {
+  uint64_t all = neighbor->nbr_all_txs;
+  uint64_t bad = neighbor->nbr_invalid_txs + neighbor->nbr_stale_txs;
+  unsigned int weight = 0;
+
+  // A bucket that has never been used starts full
+  if (rate != 0 && neighbor->ingress_bucket.burst == 0) {
+    token_bucket_init(&neighbor->ingress_bucket, (double)rate * neighbor->ingress_weight / NEIGHBOR_INGRESS_WEIGHT_MAX,
+                      rate, now);
+  }
 
-  if (neighbor == NULL || buffer == NULL) {
+  if (all - neighbor->ingress_window_all >= NEIGHBOR_INGRESS_WINDOW) {
+    // Weight of the last window averaged with the previous weight so that a single bad window does not cut a neighbor
+    weight = NEIGHBOR_INGRESS_WEIGHT_MAX -
+             NEIGHBOR_INGRESS_WEIGHT_MAX * MIN(bad - neighbor->ingress_window_bad, all - neighbor->ingress_window_all) /
+                 (all - neighbor->ingress_window_all);
+    weight = (MAX(weight, NEIGHBOR_INGRESS_WEIGHT_MIN) + neighbor->ingress_weight) / 2;
+    neighbor->ingress_weight = weight;
+    neighbor->ingress_window_all = all;
+    neighbor->ingress_window_bad = bad;
+    if (rate != 0) {
+      token_bucket_set_rate(&neighbor->ingress_bucket, (double)rate * weight / NEIGHBOR_INGRESS_WEIGHT_MAX, rate, now);
+    }
+  }
+
+  if (rate == 0) {
+    return true;
+  }
+
+  return token_bucket_consume(&neighbor->ingress_bucket, 1, now);
+}
+
+bool neighbor_ingress_share_allow(neighbor_t const *const neighbor, size_t const capacity, uint64_t const weights) {
+  if (weights == 0) {
+    return true;
+  }
+
+  return neighbor->ingress_queued < MAX(capacity * neighbor->ingress_weight / weights, 1);
+}
+
+retcode_t neighbor_write_queue_push(neighbor_t *const neighbor, neighbor_packet_t *const packet,
+                                    byte_t const *const request) {
+  neighbor_write_queue_entry_t *entry = NULL;
+
+  if (neighbor == NULL || packet == NULL || request == NULL) {
     return RC_NULL_PARAM;
   }
 
-  if ((entry = (uv_buf_t_queue_entry_t *)malloc(sizeof(uv_buf_t_queue_entry_t))) == NULL) {
+  if ((entry = (neighbor_write_queue_entry_t *)malloc(sizeof(neighbor_write_queue_entry_t))) == NULL) {
     return RC_OOM;
   }
-  entry->buf = uv_buf_init(buffer, buffer_size);
+  atomic_fetch_add_explicit(&packet->refs, 1, memory_order_relaxed);
+  entry->packet = packet;
+  memcpy(entry->request, request, GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH);
   CDL_APPEND(neighbor->write_queue, entry);
 
   return RC_OK;
 }
 
-uv_buf_t_queue_entry_t *neighbor_write_queue_pop(neighbor_t *const neighbor) {
-  uv_buf_t_queue_entry_t *front = NULL;
+neighbor_write_queue_entry_t *neighbor_write_queue_pop(neighbor_t *const neighbor) {
+  neighbor_write_queue_entry_t *front = NULL;
 
   if (neighbor == NULL) {
     return NULL;
@@ -203,8 +308,17 @@ uv_buf_t_queue_entry_t *neighbor_write_queue_pop(neighbor_t *const neighbor) {
   return front;
 }
 
+void neighbor_write_queue_entry_free(neighbor_write_queue_entry_t *const entry) {
+  if (entry == NULL) {
+    return;
+  }
+
+  neighbor_packet_release(entry->packet);
+  free(entry);
+}
+
 void neighbor_write_queue_free(neighbor_t *const neighbor) {
-  uv_buf_t_queue_entry_t *iter = NULL, *tmp1 = NULL, *tmp2 = NULL;
+  neighbor_write_queue_entry_t *iter = NULL, *tmp1 = NULL, *tmp2 = NULL;
 
   if (neighbor == NULL || neighbor->write_queue == NULL) {
     return;
@@ -212,8 +326,7 @@ void neighbor_write_queue_free(neighbor_t *const neighbor) {
 
   CDL_FOREACH_SAFE(neighbor->write_queue, iter, tmp1, tmp2) {
     CDL_DELETE(neighbor->write_queue, iter);
-    free(iter->buf.base);
-    free(iter);
+    neighbor_write_queue_entry_free(iter);
   }
   neighbor->write_queue = NULL;
 }
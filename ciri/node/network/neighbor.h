@@ -8,6 +8,7 @@
 #ifndef __CIRI_NODE_NETWORK_NEIGHBOR_H__
 #define __CIRI_NODE_NETWORK_NEIGHBOR_H__
 
+#include <stdatomic.h>
 #include <stdbool.h>
 
 #include <uv.h>
@@ -17,6 +18,7 @@
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
 #include "utils/handles/lock.h"
+#include "utils/token_bucket.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,19 +35,45 @@ typedef enum neighbor_state_e {
   NEIGHBOR_MARKED_FOR_DISCONNECT,
 } neighbor_state_t;
 
-typedef struct uv_buf_t_queue_entry_s {
-  uv_buf_t buf;
-  struct uv_buf_t_queue_entry_s *next;
-  struct uv_buf_t_queue_entry_s *prev;
-} uv_buf_t_queue_entry_t;
+/**
+ * A gossip packet serialized for the wire, up to its requested transaction hash which is specific to each neighbor.
+ * Reference counted so that a packet broadcast to several neighbors is serialized once and shared by their write
+ * queues.
+ */
+typedef struct neighbor_packet_s {
+  atomic_uint refs;
+  size_t size;
+  byte_t bytes[];
+} neighbor_packet_t;
 
-typedef uv_buf_t_queue_entry_t *uv_buf_t_queue_t;
+/**
+ * A packet waiting to be written to a neighbor: the shared packet followed by the requested transaction hash
+ */
+typedef struct neighbor_write_queue_entry_s {
+  neighbor_packet_t *packet;
+  byte_t request[GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH];
+  struct neighbor_write_queue_entry_s *next;
+  struct neighbor_write_queue_entry_s *prev;
+} neighbor_write_queue_entry_t;
+
+typedef neighbor_write_queue_entry_t *neighbor_write_queue_t;
+
+// Size of the buffer receiving data from a neighbor, holds several packets so that compactions are rare
+#define NEIGHBOR_BUFFER_SIZE (4 * (PACKET_MAX_BYTES_LENGTH))
+// Number of transactions received from a neighbor between two updates of its ingress weight
+#define NEIGHBOR_INGRESS_WINDOW 100
+// Ingress weight, in permille, of a neighbor sending only valid transactions
+#define NEIGHBOR_INGRESS_WEIGHT_MAX 1000
+// Ingress weight, in permille, of a neighbor sending only invalid or stale transactions
+#define NEIGHBOR_INGRESS_WEIGHT_MIN 50
 
 typedef struct neighbor_s {
-  byte_t buffer[PACKET_MAX_BYTES_LENGTH];
+  // Data is received in place in the buffer and parsed from buffer_start, buffer_size bytes are pending
+  byte_t buffer[NEIGHBOR_BUFFER_SIZE];
+  size_t buffer_start;
   size_t buffer_size;
   uv_async_t *writer;
-  uv_buf_t_queue_t write_queue;
+  neighbor_write_queue_t write_queue;
   lock_handle_t write_queue_lock;
   endpoint_t endpoint;
   neighbor_state_t state;
@@ -57,6 +85,15 @@ typedef struct neighbor_s {
   uint64_t nbr_sent_txs;
   uint64_t nbr_new_txs;
   uint64_t nbr_dropped_send;
+  uint64_t nbr_throttled_txs;
+  // Ingress rate limiting, the bucket rate is the configured rate scaled by the weight
+  token_bucket_t ingress_bucket;
+  uint64_t ingress_window_all;
+  uint64_t ingress_window_bad;
+  // Share of the processor stage given to the neighbor, lowered when it sends invalid or stale transactions
+  atomic_uint ingress_weight;
+  // Number of packets of the neighbor waiting in the processor stage
+  atomic_uint ingress_queued;
 } neighbor_t;
 
 /**
@@ -98,6 +135,46 @@ retcode_t neighbor_init_with_uri(neighbor_t *const neighbor, char const *const u
  */
 retcode_t neighbor_init_with_values(neighbor_t *const neighbor, char const *const ip, uint16_t const port);
 
+/**
+ * Serializes a gossip packet for the wire, except its requested transaction hash
+ *
+ * @param[in] packet The gossip packet
+ *
+ * @return a packet holding a single reference, NULL if it could not be allocated
+ */
+neighbor_packet_t *neighbor_packet_new(protocol_gossip_t const *const packet);
+
+/**
+ * Releases a reference on a serialized packet, the packet is freed with the last reference
+ *
+ * @param[in,out] packet The serialized packet, may be NULL
+ */
+void neighbor_packet_release(neighbor_packet_t *const packet);
+
+/**
+ * Queues a serialized packet to be written to a neighbor with a transaction request picked for this neighbor
+ * The packet is written once the neighbor is flushed
+ *
+ * @param[in,out] node      A node
+ * @param[in]     tangle    A tangle
+ * @param[in,out] neighbor  The neighbor
+ * @param[in]     packet    The serialized packet, a reference is taken
+ * @param[in]     gossip    The gossip packet the serialized packet comes from
+ *
+ * @return a status code
+ */
+retcode_t neighbor_queue_packet(node_t *const node, tangle_t const *const tangle, neighbor_t *const neighbor,
+                                neighbor_packet_t *const packet, protocol_gossip_t const *const gossip);
+
+/**
+ * Wakes up the writer of a neighbor up so that all its queued packets are written
+ *
+ * @param[in,out] neighbor  The neighbor
+ *
+ * @return a status code
+ */
+retcode_t neighbor_flush(neighbor_t *const neighbor);
+
 /**
  * Sends a packet to a neighbor
  *
@@ -135,8 +212,35 @@ retcode_t neighbor_send_trits(node_t *const node, tangle_t const *const tangle,
 retcode_t neighbor_send_bytes(node_t *const node, tangle_t const *const tangle, neighbor_t *const neighbor,
                               byte_t const *const bytes);
 
-retcode_t neighbor_write_queue_push(neighbor_t *const neighbor, void *const buffer, size_t const buffer_size);
-uv_buf_t_queue_entry_t *neighbor_write_queue_pop(neighbor_t *const neighbor);
+/**
+ * Decides whether a transaction received from a neighbor is let in
+ * Every NEIGHBOR_INGRESS_WINDOW transactions, the ingress weight of the neighbor is updated from the ratio of invalid
+ * and stale transactions it sent in the meantime, and its token bucket rate is scaled by this weight.
+ *
+ * @param[in,out] neighbor  The neighbor
+ * @param[in]     rate      Maximum number of transactions per second of a neighbor, 0 for no limit
+ * @param[in]     now       Current time in milliseconds
+ *
+ * @return true if the transaction is let in, false if the neighbor is over its rate
+ */
+bool neighbor_ingress_allow(neighbor_t *const neighbor, size_t const rate, uint64_t const now);
+
+/**
+ * Decides whether a neighbor can queue one more transaction in a crowded queue, where it can only hold a share of the
+ * queue proportional to its ingress weight
+ *
+ * @param[in] neighbor  The neighbor
+ * @param[in] capacity  The capacity of the queue
+ * @param[in] weights   The sum of the ingress weights of the neighbors sharing the queue
+ *
+ * @return true if the transaction is let in, false if the neighbor holds its share already
+ */
+bool neighbor_ingress_share_allow(neighbor_t const *const neighbor, size_t const capacity, uint64_t const weights);
+
+retcode_t neighbor_write_queue_push(neighbor_t *const neighbor, neighbor_packet_t *const packet,
+                                    byte_t const *const request);
+neighbor_write_queue_entry_t *neighbor_write_queue_pop(neighbor_t *const neighbor);
+void neighbor_write_queue_entry_free(neighbor_write_queue_entry_t *const entry);
 void neighbor_write_queue_free(neighbor_t *const neighbor);
 
 #ifdef __cplusplus
@@ -6,21 +6,23 @@
  */
 
 #include <stdlib.h>
+#include <unistd.h>
 
 #include "uv.h"
+#include "xxhash.h"
 
 #include "ciri/node/network/router.h"
 #include "ciri/node/node.h"
 #include "utils/logger_helper.h"
 #include "utils/macros.h"
+#include "utils/time.h"
 
 #define ROUTER_LOGGER_ID "router"
+// Maximum number of packets written to a neighbor with a single write
+#define ROUTER_WRITE_MAX_PACKETS 64
 
 static UT_icd neighbors_icd = {sizeof(neighbor_t), 0, 0, 0};
 static logger_id_t logger_id;
-static uv_tcp_t *server = NULL;
-static uv_async_t *async = NULL;
-static uv_timer_t *reconnect_timer = NULL;
 
 static int router_neighbor_cmp(void const *const lhs, void const *const rhs) {
   if (lhs == NULL || rhs == NULL) {
@@ -60,29 +62,62 @@ static retcode_t router_neighbors_init(router_t *const router) {
  * Private functions
  */
 
+static inline router_loop_t *router_loop_of(uv_handle_t const *const handle) {
+  return (router_loop_t *)handle->loop->data;
+}
+
 static void router_alloc_buffer(uv_handle_t *const handle, size_t suggested_size, uv_buf_t *const buf) {
-  UNUSED(handle);
+  neighbor_t *neighbor = (neighbor_t *)handle->data;
+
+  // Packets from a connected neighbor are received in place in its buffer
+  if (neighbor != NULL && neighbor->state != NEIGHBOR_HANDSHAKING) {
+    router_read_buffer(neighbor, buf);
+    return;
+  }
 
   buf->base = (char *)malloc(suggested_size);
   buf->len = suggested_size;
 }
 
+static inline bool router_is_read_buffer(neighbor_t const *const neighbor, char const *const base) {
+  return neighbor != NULL && (byte_t const *)base >= neighbor->buffer &&
+         (byte_t const *)base < neighbor->buffer + NEIGHBOR_BUFFER_SIZE;
+}
+
 static void router_on_close(uv_handle_t *const handle) {
   if (handle != NULL) {
     free(handle);
   }
 }
 
+/**
+ * Closes a client, its neighbor being left disconnected with no pending bytes so that it is reconnected later on
+ */
+static void router_close(uv_stream_t *const client) {
+  neighbor_t *neighbor = (neighbor_t *)client->data;
+
+  if (neighbor != NULL && neighbor->endpoint.stream == client) {
+    neighbor->state = NEIGHBOR_DISCONNECTED;
+    neighbor->endpoint.stream = NULL;
+    neighbor->buffer_start = 0;
+    neighbor->buffer_size = 0;
+  } else if (neighbor != NULL && neighbor->endpoint.stream == NULL && neighbor->state == NEIGHBOR_HANDSHAKING) {
+    neighbor->state = NEIGHBOR_DISCONNECTED;
+  }
+  uv_close((uv_handle_t *)client, router_on_close);
+}
+
 static void router_on_walk(uv_handle_t *const handle, void *arg) {
   UNUSED(arg);
 
-  uv_close(handle, router_on_close);
+  if (!uv_is_closing(handle)) {
+    uv_close(handle, router_on_close);
+  }
 }
 
-static void router_on_async(uv_async_t *const handle) {
-  UNUSED(handle);
-
-  uv_stop(uv_default_loop());
+static void router_on_stop(uv_async_t *const handle) {
+  // The loop returns once all its handles are closed
+  uv_walk(handle->loop, router_on_walk, NULL);
 }
 
 static void router_on_write(uv_write_t *const req, int const status) {
@@ -93,39 +128,84 @@ static void router_on_write(uv_write_t *const req, int const status) {
   free(req);
 }
 
+static void router_write_queue_free(neighbor_write_queue_t *const entries) {
+  neighbor_write_queue_entry_t *iter = NULL, *tmp1 = NULL, *tmp2 = NULL;
+
+  CDL_FOREACH_SAFE(*entries, iter, tmp1, tmp2) {
+    CDL_DELETE(*entries, iter);
+    neighbor_write_queue_entry_free(iter);
+  }
+}
+
+static void router_on_write_packets(uv_write_t *const req, int const status) {
+  neighbor_write_queue_t entries = (neighbor_write_queue_t)req->data;
+
+  if (status && status != UV_ECANCELED && status != UV_ECONNRESET) {
+    log_warning(logger_id, "Writing packets failed: %s\n", uv_strerror(status));
+  }
+  router_write_queue_free(&entries);
+  free(req);
+}
+
 static void router_on_async_write(uv_async_t *const handle) {
   neighbor_t *neighbor = (neighbor_t *)handle->data;
-  uv_buf_t_queue_entry_t *entry = NULL;
+  neighbor_write_queue_t entries = NULL;
+  neighbor_write_queue_entry_t *entry = NULL;
+  uv_buf_t bufs[2 * ROUTER_WRITE_MAX_PACKETS];
+  size_t packets_num = 0;
   uv_write_t *req = NULL;
   int err = 0;
 
   while (true) {
+    entries = NULL;
+    packets_num = 0;
     lock_handle_lock(&neighbor->write_queue_lock);
-    entry = neighbor_write_queue_pop(neighbor);
+    while (packets_num < ROUTER_WRITE_MAX_PACKETS && (entry = neighbor_write_queue_pop(neighbor)) != NULL) {
+      CDL_APPEND(entries, entry);
+      packets_num++;
+    }
     lock_handle_unlock(&neighbor->write_queue_lock);
 
-    if (entry == NULL) {
+    if (packets_num == 0) {
       break;
     }
 
+    if (neighbor->endpoint.stream == NULL) {
+      router_write_queue_free(&entries);
+      continue;
+    }
+
     if ((req = malloc(sizeof(uv_write_t))) == NULL) {
       log_warning(logger_id, "Allocating write request failed\n");
+      router_write_queue_free(&entries);
       return;
     }
 
-    req->data = entry->buf.base;
-    if ((err = uv_write(req, neighbor->endpoint.stream, &entry->buf, 1, router_on_write)) != 0) {
+    // All pending packets are written at once, each one being the shared serialized packet followed by its request
+    packets_num = 0;
+    CDL_FOREACH(entries, entry) {
+      bufs[2 * packets_num] = uv_buf_init((char *)entry->packet->bytes, entry->packet->size);
+      bufs[2 * packets_num + 1] = uv_buf_init((char *)entry->request, GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH);
+      packets_num++;
+    }
+
+    req->data = entries;
+    if ((err = uv_write(req, neighbor->endpoint.stream, bufs, 2 * packets_num, router_on_write_packets)) != 0) {
       log_warning(logger_id, "Writing failed: %s\n", uv_err_name(err));
+      router_write_queue_free(&entries);
+      free(req);
     } else {
-      neighbor->nbr_sent_txs++;
+      neighbor->nbr_sent_txs += packets_num;
     }
-    free(entry);
   }
 }
 
 static void router_on_read(uv_stream_t *const client, ssize_t const nread, uv_buf_t const *const buf) {
   neighbor_t *neighbor = (neighbor_t *)client->data;
-  router_t *router = &((node_t *)server->data)->router;
+  router_loop_t *loop = router_loop_of((uv_handle_t *)client);
+  router_t *router = loop->router;
+  bool const in_place = router_is_read_buffer(neighbor, buf->base);
+  uint64_t const start = uv_hrtime();
 
   if (nread < 0) {
     if (nread != UV_EOF) {
@@ -133,10 +213,8 @@ static void router_on_read(uv_stream_t *const client, ssize_t const nread, uv_bu
     } else if (neighbor != NULL) {
       log_info(logger_id, "Connection with neighbor tcp://%s:%d lost\n", neighbor->endpoint.domain,
                neighbor->endpoint.port);
-      neighbor->state = NEIGHBOR_DISCONNECTED;
-      neighbor->endpoint.stream = NULL;
     }
-    uv_close((uv_handle_t *)client, router_on_close);
+    router_close(client);
   } else if (nread > 0) {
     if (neighbor == NULL || neighbor->state == NEIGHBOR_HANDSHAKING) {
       char host[NI_MAXHOST];
@@ -149,8 +227,8 @@ static void router_on_read(uv_stream_t *const client, ssize_t const nread, uv_bu
           getnameinfo((struct sockaddr *)&addr, sizeof(addr), host, NI_MAXHOST, serv, NI_MAXSERV,
                       NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
         log_warning(logger_id, "Unable to get peer information\n");
-        uv_close((uv_handle_t *)client, router_on_close);
-        return;
+        router_close(client);
+        goto done;
       }
       port = atoi(serv);
 
@@ -160,29 +238,153 @@ static void router_on_read(uv_stream_t *const client, ssize_t const nread, uv_bu
                  neighbor->endpoint.port);
         client->data = neighbor;
         neighbor->endpoint.stream = client;
+        neighbor->buffer_start = 0;
+        neighbor->buffer_size = 0;
         neighbor->state = NEIGHBOR_READY_FOR_MESSAGES;
       } else {
-        uv_close((uv_handle_t *)client, router_on_close);
+        router_close(client);
       }
     } else {
       log_debug(logger_id, "Packet received from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
                 neighbor->endpoint.port);
-      if (router_read(router, neighbor, buf->base, nread) != RC_OK) {
+      size_t received = nread;
+
+      // Data read before the neighbor was connected still has to be moved to its buffer
+      if (!in_place) {
+        uv_buf_t read_buf;
+
+        router_read_buffer(neighbor, &read_buf);
+        if (received > read_buf.len) {
+          log_warning(logger_id, "Too much data from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
+                      neighbor->endpoint.port);
+          router_close(client);
+          goto done;
+        }
+        memcpy(read_buf.base, buf->base, received);
+      }
+      // The stream can't be resynchronized after an invalid packet
+      if (router_read(router, neighbor, received) != RC_OK) {
         log_warning(logger_id, "Read error from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
                     neighbor->endpoint.port);
+        router_close(client);
       }
     }
   }
 
-  if (buf->base) {
+done:
+  if (buf->base && !in_place) {
     free(buf->base);
   }
+  atomic_fetch_add_explicit(&loop->read_time, uv_hrtime() - start, memory_order_relaxed);
+  atomic_fetch_add_explicit(&loop->reads, 1, memory_order_relaxed);
+}
+
+/**
+ * Sends the handshake to a newly accepted client and starts reading from it
+ */
+static void router_accept(router_t *const router, uv_tcp_t *const client) {
+  protocol_handshake_t handshake;
+  uint16_t handshake_size = 0;
+  int ret = 0;
+
+  handshake_init(&handshake, router->node->conf.neighboring_port, router->node->conf.coordinator_address,
+                 router->node->conf.mwm, &handshake_size);
+  if (router_write((uv_stream_t *)client, PROTOCOL_HANDSHAKE, &handshake, handshake_size) != RC_OK) {
+    log_error(logger_id, "Sending handshake to new peer failed\n");
+    uv_close((uv_handle_t *)client, router_on_close);
+    return;
+  }
+  if ((ret = uv_read_start((uv_stream_t *)client, router_alloc_buffer, router_on_read)) != 0) {
+    log_error(logger_id, "Starting to read from new client failed: %s\n", uv_err_name(ret));
+    uv_close((uv_handle_t *)client, router_on_close);
+  }
+}
+
+/**
+ * Hands a client accepted by the listening loop off to another loop: its socket is duplicated so that closing the
+ * client here leaves the connection open, and the target loop is woken up to adopt it. Failing means that the
+ * connection was not handed off and nothing is left queued.
+ */
+static retcode_t router_handoff(router_loop_t *const target, uv_tcp_t *const client) {
+  router_handoff_t *handoff = NULL;
+  router_handoff_t *queued = NULL;
+  uv_os_fd_t fd;
+
+  if (uv_fileno((uv_handle_t *)client, &fd) != 0) {
+    return RC_TCP_SERVER_INIT;
+  }
+  if ((handoff = (router_handoff_t *)malloc(sizeof(router_handoff_t))) == NULL) {
+    return RC_OOM;
+  }
+  if ((handoff->socket = dup(fd)) < 0) {
+    free(handoff);
+    return RC_TCP_SERVER_INIT;
+  }
+
+  lock_handle_lock(&target->handoffs_lock);
+  LL_APPEND(target->handoffs, handoff);
+  lock_handle_unlock(&target->handoffs_lock);
+  if (uv_async_send(target->dispatch) != 0) {
+    // Waking the loop up for another handoff may still have adopted it, it is only given up if still queued
+    lock_handle_lock(&target->handoffs_lock);
+    LL_FOREACH(target->handoffs, queued) {
+      if (queued == handoff) {
+        LL_DELETE(target->handoffs, handoff);
+        break;
+      }
+    }
+    lock_handle_unlock(&target->handoffs_lock);
+    if (queued == NULL) {
+      return RC_OK;
+    }
+    close(handoff->socket);
+    free(handoff);
+    return RC_ASYNC_CALL_FAILED;
+  }
+
+  return RC_OK;
+}
+
+static void router_on_dispatch(uv_async_t *const handle) {
+  router_loop_t *loop = router_loop_of((uv_handle_t *)handle);
+  router_handoff_t *handoffs = NULL, *handoff = NULL, *tmp = NULL;
+  uv_tcp_t *client = NULL;
+  int ret = 0;
+
+  lock_handle_lock(&loop->handoffs_lock);
+  handoffs = loop->handoffs;
+  loop->handoffs = NULL;
+  lock_handle_unlock(&loop->handoffs_lock);
+
+  LL_FOREACH_SAFE(handoffs, handoff, tmp) {
+    LL_DELETE(handoffs, handoff);
+    if ((client = (uv_tcp_t *)malloc(sizeof(uv_tcp_t))) == NULL) {
+      log_warning(logger_id, "Allocation of new client failed\n");
+      close(handoff->socket);
+    } else if ((ret = uv_tcp_init(&loop->loop, client)) != 0) {
+      log_warning(logger_id, "Initializing new client failed: %s\n", uv_err_name(ret));
+      free(client);
+      close(handoff->socket);
+    } else if ((ret = uv_tcp_open(client, handoff->socket)) != 0 || (ret = uv_tcp_nodelay(client, true)) != 0) {
+      log_warning(logger_id, "Adopting new client failed: %s\n", uv_err_name(ret));
+      uv_close((uv_handle_t *)client, router_on_close);
+    } else {
+      client->data = NULL;
+      router_accept(loop->router, client);
+    }
+    free(handoff);
+  }
 }
 
 static void router_on_new_connection(uv_stream_t *const server, int const status) {
   int ret = 0;
   uv_tcp_t *client = NULL;
-  router_t *router = &((node_t *)server->data)->router;
+  router_loop_t *loop = router_loop_of((uv_handle_t *)server);
+  router_loop_t *target = NULL;
+  router_t *router = loop->router;
+  struct sockaddr_storage addr;
+  int len = sizeof(struct sockaddr_storage);
+  char host[NI_MAXHOST];
 
   log_debug(logger_id, "New TCP connection\n");
 
@@ -197,37 +399,40 @@ static void router_on_new_connection(uv_stream_t *const server, int const status
   }
   client->data = NULL;
 
-  if ((ret = uv_tcp_init(uv_default_loop(), client)) != 0 || (ret = uv_tcp_nodelay(client, true)) != 0) {
+  if ((ret = uv_tcp_init(&loop->loop, client)) != 0 || (ret = uv_tcp_nodelay(client, true)) != 0) {
     log_warning(logger_id, "Initializing new client failed: %s\n", uv_err_name(ret));
     uv_close((uv_handle_t *)client, router_on_close);
     return;
   }
 
-  if ((ret = uv_accept(server, (uv_stream_t *)client)) == 0) {
-    protocol_handshake_t handshake;
-    uint16_t handshake_size = 0;
-
-    handshake_init(&handshake, router->node->conf.neighboring_port, router->node->conf.coordinator_address,
-                   router->node->conf.mwm, &handshake_size);
-    if (router_write((uv_stream_t *)client, PROTOCOL_HANDSHAKE, &handshake, handshake_size) != RC_OK) {
-      log_error(logger_id, "Sending handshake to new peer failed\n");
-      uv_close((uv_handle_t *)client, router_on_close);
-    }
-    if ((ret = uv_read_start((uv_stream_t *)client, router_alloc_buffer, router_on_read)) != 0) {
-      log_error(logger_id, "Starting to read from new client failed: %s\n", uv_err_name(ret));
-      uv_close((uv_handle_t *)client, router_on_close);
-    }
-  } else {
+  if ((ret = uv_accept(server, (uv_stream_t *)client)) != 0) {
     log_warning(logger_id, "Accepting new connection failed: %s\n", uv_err_name(ret));
     uv_close((uv_handle_t *)client, router_on_close);
+    return;
+  }
+
+  // The connection is served by the loop its peer address is pinned to
+  if (uv_tcp_getpeername(client, (struct sockaddr *)&addr, &len) != 0 ||
+      getnameinfo((struct sockaddr *)&addr, sizeof(addr), host, NI_MAXHOST, NULL, 0, NI_NUMERICHOST) != 0) {
+    log_warning(logger_id, "Unable to get peer information\n");
+    uv_close((uv_handle_t *)client, router_on_close);
+    return;
+  }
+  if ((target = router_loop_by_ip(router, host)) == loop) {
+    router_accept(router, client);
+    return;
+  }
+  if (router_handoff(target, client) != RC_OK) {
+    log_warning(logger_id, "Handing new connection off to event loop %zu failed\n", target->index);
   }
+  uv_close((uv_handle_t *)client, router_on_close);
 }
 
 void router_on_connect(uv_connect_t *const connection, int const status) {
   int ret = 0;
   uv_stream_t *client = connection->handle;
   neighbor_t *neighbor = (neighbor_t *)client->data;
-  router_t *router = &((node_t *)server->data)->router;
+  router_t *router = router_loop_of((uv_handle_t *)client)->router;
   protocol_handshake_t handshake;
   uint16_t handshake_size = 0;
 
@@ -244,36 +449,92 @@ void router_on_connect(uv_connect_t *const connection, int const status) {
                  router->node->conf.mwm, &handshake_size);
   if (router_write((uv_stream_t *)client, PROTOCOL_HANDSHAKE, &handshake, handshake_size) != RC_OK) {
     log_error(logger_id, "Sending handshake to new peer failed\n");
-    uv_close((uv_handle_t *)client, router_on_close);
-  }
-
-  if ((ret = uv_read_start(client, router_alloc_buffer, router_on_read)) != 0) {
+    router_close(client);
+  } else if ((ret = uv_read_start(client, router_alloc_buffer, router_on_read)) != 0) {
     log_error(logger_id, "Starting to read from %s:%d failed: %s\n", neighbor->endpoint.domain, neighbor->endpoint.port,
               uv_err_name(ret));
-    uv_close((uv_handle_t *)client, router_on_close);
+    router_close(client);
   }
 
   free(connection);
 }
 
 static void router_on_reconnect_timer(uv_timer_t *const handle) {
-  if (router_reconnect_attempt(&((node_t *)handle->data)->router) != RC_OK) {
+  router_loop_t *loop = router_loop_of((uv_handle_t *)handle);
+
+  if (router_reconnect_attempt(loop->router, loop) != RC_OK) {
     log_warning(logger_id, "Attempt to reconnect disconnected neighbors failed\n");
   }
 }
 
-static void *router_routine(void *param) {
-  UNUSED(param);
-
-  log_info(logger_id, "Starting TCP server on port %d\n", ((node_t *)server->data)->conf.neighboring_port);
-  if (uv_run(uv_default_loop(), UV_RUN_DEFAULT) != 0) {
-    log_critical(logger_id, "Starting TCP server failed\n");
+static void *router_routine(router_loop_t *const loop) {
+  if (loop->index == 0) {
+    log_info(logger_id, "Starting TCP server on port %d\n", loop->router->node->conf.neighboring_port);
+  }
+  if (uv_run(&loop->loop, UV_RUN_DEFAULT) != 0) {
+    log_critical(logger_id, "Running event loop %zu failed\n", loop->index);
     return NULL;
   }
 
   return NULL;
 }
 
+static retcode_t router_loop_init(router_t *const router, router_loop_t *const loop, size_t const index) {
+  int err = 0;
+
+  loop->index = index;
+  loop->router = router;
+  loop->handoffs = NULL;
+  lock_handle_init(&loop->handoffs_lock);
+  atomic_init(&loop->read_time, 0);
+  atomic_init(&loop->reads, 0);
+
+  if ((err = uv_loop_init(&loop->loop)) != 0) {
+    log_critical(logger_id, "Initializing event loop %zu failed: %s\n", index, uv_err_name(err));
+    return RC_EVENT_LOOP;
+  }
+  loop->loop.data = loop;
+
+  // Handles are allocated so that closing all handles of the loop frees them
+  if ((loop->stop = (uv_async_t *)malloc(sizeof(uv_async_t))) == NULL ||
+      (err = uv_async_init(&loop->loop, loop->stop, router_on_stop)) != 0 ||
+      (loop->dispatch = (uv_async_t *)malloc(sizeof(uv_async_t))) == NULL ||
+      (err = uv_async_init(&loop->loop, loop->dispatch, router_on_dispatch)) != 0 ||
+      (loop->reconnect_timer = (uv_timer_t *)malloc(sizeof(uv_timer_t))) == NULL ||
+      (err = uv_timer_init(&loop->loop, loop->reconnect_timer)) != 0) {
+    log_critical(logger_id, "Initializing event loop %zu handles failed: %s\n", index, uv_err_name(err));
+    return RC_EVENT_LOOP;
+  }
+
+  return RC_OK;
+}
+
+static retcode_t router_loop_destroy(router_loop_t *const loop) {
+  router_handoff_t *handoff = NULL, *tmp = NULL;
+  int err = 0;
+
+  // Closes the handles left if the loop never ran
+  uv_walk(&loop->loop, router_on_walk, NULL);
+  uv_run(&loop->loop, UV_RUN_DEFAULT);
+  if ((err = uv_loop_close(&loop->loop)) != 0) {
+    log_error(logger_id, "Closing event loop %zu failed: %s\n", loop->index, uv_err_name(err));
+    return RC_EVENT_LOOP;
+  }
+
+  LL_FOREACH_SAFE(loop->handoffs, handoff, tmp) {
+    LL_DELETE(loop->handoffs, handoff);
+    close(handoff->socket);
+    free(handoff);
+  }
+  lock_handle_destroy(&loop->handoffs_lock);
+
+  return RC_OK;
+}
+
+/*
+ * Public functions
+ */
+
 retcode_t router_init(router_t *const router, node_t *const node) {
   retcode_t ret = RC_OK;
   struct sockaddr_in addr;
@@ -285,31 +546,34 @@ retcode_t router_init(router_t *const router, node_t *const node) {
 
   logger_id = logger_helper_enable(ROUTER_LOGGER_ID, LOGGER_DEBUG, true);
 
-  if ((server = (uv_tcp_t *)malloc(sizeof(uv_tcp_t))) == NULL ||
-      (async = (uv_async_t *)malloc(sizeof(uv_async_t))) == NULL ||
-      (reconnect_timer = (uv_timer_t *)malloc(sizeof(uv_timer_t))) == NULL) {
-    return RC_OOM;
-  }
-
   router->node = node;
   router->running = false;
+  router->loops_num = node->conf.router_threads;
+  if ((router->loops = (router_loop_t *)calloc(router->loops_num, sizeof(router_loop_t))) == NULL) {
+    return RC_OOM;
+  }
+  for (size_t i = 0; i < router->loops_num; i++) {
+    if ((ret = router_loop_init(router, &router->loops[i], i)) != RC_OK) {
+      return ret;
+    }
+  }
   utarray_new(router->neighbors, &neighbors_icd);
   rw_lock_handle_init(&router->neighbors_lock);
-  server->data = node;
-  reconnect_timer->data = node;
 
   if ((ret = router_neighbors_init(router)) != RC_OK) {
     log_critical(logger_id, "Initializing neighbors failed\n");
     return ret;
   }
 
-  if ((err = uv_tcp_init(uv_default_loop(), server)) != 0 ||
+  // The first loop listens for incoming connections
+  if ((router->server = (uv_tcp_t *)malloc(sizeof(uv_tcp_t))) == NULL) {
+    return RC_OOM;
+  }
+  if ((err = uv_tcp_init(&router->loops[0].loop, router->server)) != 0 ||
       (err = uv_ip4_addr(node->conf.neighboring_address, node->conf.neighboring_port, &addr)) != 0 ||
-      (err = uv_tcp_nodelay(server, true)) != 0 ||
-      (err = uv_tcp_bind(server, (const struct sockaddr *)&addr, 0)) != 0 ||
-      (err = uv_listen((uv_stream_t *)server, node->conf.max_neighbors, router_on_new_connection)) != 0 ||
-      (err = uv_async_init(uv_default_loop(), async, router_on_async)) != 0 ||
-      (err = uv_timer_init(uv_default_loop(), reconnect_timer)) != 0) {
+      (err = uv_tcp_nodelay(router->server, true)) != 0 ||
+      (err = uv_tcp_bind(router->server, (const struct sockaddr *)&addr, 0)) != 0 ||
+      (err = uv_listen((uv_stream_t *)router->server, node->conf.max_neighbors, router_on_new_connection)) != 0) {
     log_critical(logger_id, "TCP server initialization failed: %s\n", uv_err_name(err));
     return RC_TCP_SERVER_INIT;
   }
@@ -324,15 +588,17 @@ retcode_t router_start(router_t *const router) {
     return RC_NULL_PARAM;
   }
 
-  log_info(logger_id, "Spawning TCP server thread\n");
+  log_info(logger_id, "Spawning %zu TCP server threads\n", router->loops_num);
   router->running = true;
-  if (thread_handle_create(&router->thread, (thread_routine_t)router_routine, NULL) != 0) {
-    log_critical(logger_id, "Spawning TCP server thread failed\n");
-    return RC_THREAD_CREATE;
-  }
-  if ((ret = uv_timer_start(reconnect_timer, router_on_reconnect_timer, 0,
-                            router->node->conf.reconnect_attempt_interval * 1000)) != 0) {
-    log_critical(logger_id, "Starting reconnect attempt timer failed: %s\n", uv_err_name(ret));
+  for (size_t i = 0; i < router->loops_num; i++) {
+    if ((ret = uv_timer_start(router->loops[i].reconnect_timer, router_on_reconnect_timer, 0,
+                              router->node->conf.reconnect_attempt_interval * 1000)) != 0) {
+      log_critical(logger_id, "Starting reconnect attempt timer failed: %s\n", uv_err_name(ret));
+    }
+    if (thread_handle_create(&router->loops[i].thread, (thread_routine_t)router_routine, &router->loops[i]) != 0) {
+      log_critical(logger_id, "Spawning TCP server thread failed\n");
+      return RC_THREAD_CREATE;
+    }
   }
 
   return RC_OK;
@@ -348,25 +614,25 @@ retcode_t router_stop(router_t *const router) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down TCP server thread\n");
+  log_info(logger_id, "Shutting down TCP server threads\n");
   router->running = false;
 
-  uv_walk(uv_default_loop(), router_on_walk, NULL);
-
-  if ((ret = uv_async_send(async)) != 0) {
-    log_error(logger_id, "Sending async request to stop event loop failed: %s\n", uv_err_name(err));
-  }
-
-  if (thread_handle_join(router->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down TCP server thread failed\n");
-    ret = RC_THREAD_JOIN;
+  for (size_t i = 0; i < router->loops_num; i++) {
+    if ((err = uv_async_send(router->loops[i].stop)) != 0) {
+      log_error(logger_id, "Sending async request to stop event loop failed: %s\n", uv_err_name(err));
+      ret = RC_ASYNC_CALL_FAILED;
+      continue;
+    }
+    if (thread_handle_join(router->loops[i].thread, NULL) != 0) {
+      log_error(logger_id, "Shutting down TCP server thread failed\n");
+      ret = RC_THREAD_JOIN;
+    }
   }
 
   return ret;
 }
 
 retcode_t router_destroy(router_t *const router) {
-  int err = 0;
   retcode_t ret = RC_OK;
   neighbor_t *neighbor = NULL;
 
@@ -376,10 +642,14 @@ retcode_t router_destroy(router_t *const router) {
     return RC_STILL_RUNNING;
   }
 
-  if ((err = uv_loop_close(uv_default_loop())) != 0) {
-    log_error(logger_id, "Closing event loop failed: %s\n", uv_err_name(err));
-    ret = RC_EVENT_LOOP;
+  for (size_t i = 0; i < router->loops_num; i++) {
+    if (router_loop_destroy(&router->loops[i]) != RC_OK) {
+      ret = RC_EVENT_LOOP;
+    }
   }
+  free(router->loops);
+  router->loops = NULL;
+  router->loops_num = 0;
 
   NEIGHBORS_FOREACH(router->neighbors, neighbor) { neighbor_destroy(neighbor); }
   utarray_free(router->neighbors);
@@ -387,7 +657,7 @@ retcode_t router_destroy(router_t *const router) {
 
   logger_helper_release(logger_id);
 
-  return RC_OK;
+  return ret;
 }
 
 retcode_t router_neighbor_add(router_t *const router, neighbor_t *const neighbor) {
@@ -417,7 +687,8 @@ retcode_t router_neighbor_add(router_t *const router, neighbor_t *const neighbor
       ret = RC_OOM;
       goto done;
     }
-    if ((err = uv_async_init(uv_default_loop(), elt->writer, router_on_async_write)) != 0) {
+    if ((err = uv_async_init(&router_loop_by_ip(router, elt->endpoint.ip)->loop, elt->writer, router_on_async_write)) !=
+        0) {
       log_warning(logger_id, "Initializing async writer failed: %s\n", uv_err_name(err));
       ret = RC_ASYNC_INIT_FAILED;
       goto done;
@@ -576,87 +847,124 @@ retcode_t router_read_handshake(router_t *const router, char const *const ip, ui
   return RC_OK;
 }
 
-retcode_t router_read(router_t *const router, neighbor_t *const neighbor, void const *const buffer,
-                      size_t const buffer_size) {
-  retcode_t ret = RC_OK;
-  protocol_header_t const *header = NULL;
-  uint16_t header_length = 0;
-  size_t chunk_size = 0;
-
-  if (router == NULL || neighbor == NULL || buffer == NULL) {
-    return RC_NULL_PARAM;
+void router_read_buffer(neighbor_t *const neighbor, uv_buf_t *const buf) {
+  if (NEIGHBOR_BUFFER_SIZE - (neighbor->buffer_start + neighbor->buffer_size) < PACKET_MAX_BYTES_LENGTH) {
+    memmove(neighbor->buffer, neighbor->buffer + neighbor->buffer_start, neighbor->buffer_size);
+    neighbor->buffer_start = 0;
   }
 
-  if (buffer_size == 0) {
-    return RC_OK;
+  buf->base = (char *)neighbor->buffer + neighbor->buffer_start + neighbor->buffer_size;
+  buf->len = NEIGHBOR_BUFFER_SIZE - (neighbor->buffer_start + neighbor->buffer_size);
+}
+
+/**
+ * Decides whether a gossip packet of a neighbor is pushed to the processor stage
+ * Besides its own rate limit, once the processor stage is half full a neighbor can only hold a share of it proportional
+ * to its ingress weight, so that a spamming neighbor can not starve the others.
+ */
+static bool router_ingress_allow(router_t *const router, neighbor_t *const neighbor) {
+  size_t capacity = router->node->conf.pipeline_queue_size;
+  uint64_t weights = 0;
+  neighbor_t *iter = NULL;
+
+  if (!neighbor_ingress_allow(neighbor, router->node->conf.neighbor_ingress_rate, current_timestamp_ms())) {
+    return false;
   }
 
-  // We concatenate read data to previously read data
-  chunk_size = MIN(PACKET_MAX_BYTES_LENGTH - neighbor->buffer_size, buffer_size);
-  memcpy(neighbor->buffer + neighbor->buffer_size, buffer, chunk_size);
-  neighbor->buffer_size += chunk_size;
+  if (processor_stage_size(&router->node->processor) <= capacity / 2) {
+    return true;
+  }
 
-  // We haven't received a full header yet
-  if (neighbor->buffer_size <= HEADER_BYTES_LENGTH) {
-    return RC_OK;
+  rw_lock_handle_rdlock(&router->neighbors_lock);
+  NEIGHBORS_FOREACH(router->neighbors, iter) {
+    if (iter->state == NEIGHBOR_READY_FOR_MESSAGES) {
+      weights += iter->ingress_weight;
+    }
   }
+  rw_lock_handle_unlock(&router->neighbors_lock);
 
-  header = (protocol_header_t const *)neighbor->buffer;
-  header_length = ntohs(header->length);
+  return neighbor_ingress_share_allow(neighbor, capacity, weights);
+}
+
+/**
+ * Parses a gossip packet into a pooled gossip packet and hands it to the processor stage
+ *
+ * @param router The router
+ * @param neighbor The neighbor that sent the packet
+ * @param ptr The packet payload
+ * @param length The packet payload length
+ *
+ * @return a status code
+ */
+static retcode_t router_read_gossip(router_t *const router, neighbor_t *const neighbor, byte_t const *ptr,
+                                    uint16_t const length) {
+  retcode_t ret = RC_OK;
+  protocol_gossip_t *gossip = NULL;
+  size_t offset = 0;
+  size_t variable_size = 0;
 
-  // We haven't received the full packet yet
-  if (neighbor->buffer_size - HEADER_BYTES_LENGTH < header_length) {
+  if (!router_ingress_allow(router, neighbor)) {
+    neighbor->nbr_throttled_txs++;
     return RC_OK;
   }
 
-  if (header->type < PACKET_TYPES_NUM) {
-    switch (header->type) {
-      case PROTOCOL_HANDSHAKE:
-        break;
-      case PROTOCOL_GOSSIP: {
-        protocol_gossip_t gossip;
-        void const *ptr = neighbor->buffer + HEADER_BYTES_LENGTH;
-        size_t offset = 0;
-        size_t variable_size = 0;
-
-        // Check whether the packet length matches gossip packet length
-        if (header_length < GOSSIP_MIN_BYTES_LENGTH || header_length > GOSSIP_MAX_BYTES_LENGTH) {
-          log_warning(logger_id, "Invalid packet size %d from neighbor tcp://%s:%d\n", header_length,
-                      neighbor->endpoint.domain, neighbor->endpoint.port);
-          return RC_INVALID_PACKET;
-        }
+  if ((gossip = gossip_pool_acquire(&router->node->gossip_pool)) == NULL) {
+    return RC_OOM;
+  }
 
-        memset(&gossip, 0, sizeof(protocol_gossip_t));
+  variable_size = length - GOSSIP_NON_SIG_BYTES_LENGTH - GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH;
+  memcpy(gossip->content + offset, ptr, variable_size);
+  ptr += variable_size;
+  offset += variable_size;
 
-        variable_size = header_length - GOSSIP_NON_SIG_BYTES_LENGTH - GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH;
-        memcpy(gossip.content + offset, ptr, variable_size);
-        ptr += variable_size;
-        offset += variable_size;
+  memset(gossip->content + offset, 0, GOSSIP_SIG_MAX_BYTES_LENGTH - variable_size);
+  offset += GOSSIP_SIG_MAX_BYTES_LENGTH - variable_size;
 
-        memset(gossip.content + offset, 0, GOSSIP_SIG_MAX_BYTES_LENGTH - variable_size);
-        offset += GOSSIP_SIG_MAX_BYTES_LENGTH - variable_size;
+  memcpy(gossip->content + offset, ptr, GOSSIP_NON_SIG_BYTES_LENGTH);
+  ptr += GOSSIP_NON_SIG_BYTES_LENGTH;
+  offset += GOSSIP_NON_SIG_BYTES_LENGTH;
 
-        memcpy(gossip.content + offset, ptr, GOSSIP_NON_SIG_BYTES_LENGTH);
-        ptr += GOSSIP_NON_SIG_BYTES_LENGTH;
-        offset += GOSSIP_NON_SIG_BYTES_LENGTH;
+  memcpy(gossip->content + offset, ptr, GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH);
 
-        memcpy(gossip.content + offset, ptr, GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH);
-        ptr += GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH;
-        offset += GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH;
+  memset(&gossip->source, 0, sizeof(endpoint_t));
+  protocol_gossip_set_endpoint(gossip, neighbor->endpoint.ip, neighbor->endpoint.port);
 
-        protocol_gossip_set_endpoint(&gossip, neighbor->endpoint.ip, neighbor->endpoint.port);
+  // Drops due to a full processor queue are accounted by the queue itself
+  neighbor->ingress_queued++;
+  if ((ret = processor_stage_push(&router->node->processor, gossip)) != RC_OK) {
+    neighbor->ingress_queued--;
+    if (ret != RC_UTILS_RING_BUFFER_FULL) {
+      log_warning(logger_id, "Pushing gossip packet from tcp://%s:%d failed\n", neighbor->endpoint.domain,
+                  neighbor->endpoint.port);
+    }
+  }
 
-        if ((ret = processor_stage_add(&router->node->processor, &gossip)) != RC_OK) {
-          log_warning(logger_id, "Pushing gossip packet from tcp://%s:%d failed\n", neighbor->endpoint.domain,
-                      neighbor->endpoint.port);
-        }
-        break;
-      }
-      default:
-        log_warning(logger_id, "Invalid packet type %d from neighbor tcp://%s:%d\n", header->type,
-                    neighbor->endpoint.domain, neighbor->endpoint.port);
-        return RC_INVALID_PACKET_TYPE;
-        break;
+  return RC_OK;
+}
+
+/**
+ * Checks the type and length of a packet as soon as its header is received, so that a packet that could never be
+ * parsed is rejected before its payload is waited for
+ *
+ * @param neighbor The neighbor that sent the packet
+ * @param header The packet header
+ *
+ * @return a status code
+ */
+static retcode_t router_read_header(neighbor_t const *const neighbor, protocol_header_t const *const header) {
+  uint16_t const length = ntohs(header->length);
+
+  if (header->type == PROTOCOL_GOSSIP) {
+    if (length < GOSSIP_MIN_BYTES_LENGTH || length > GOSSIP_MAX_BYTES_LENGTH) {
+      log_warning(logger_id, "Invalid packet size %d from neighbor tcp://%s:%d\n", length, neighbor->endpoint.domain,
+                  neighbor->endpoint.port);
+      return RC_INVALID_PACKET;
+    }
+  } else if (header->type == PROTOCOL_HANDSHAKE) {
+    if (length < HANDSHAKE_MIN_BYTES_LENGTH || length > HANDSHAKE_MAX_BYTES_LENGTH) {
+      log_warning(logger_id, "Invalid handshake size %d from neighbor tcp://%s:%d\n", length,
+                  neighbor->endpoint.domain, neighbor->endpoint.port);
+      return RC_INVALID_PACKET;
     }
   } else {
     log_warning(logger_id, "Invalid packet type %d from neighbor tcp://%s:%d\n", header->type,
@@ -664,21 +972,66 @@ retcode_t router_read(router_t *const router, neighbor_t *const neighbor, void c
     return RC_INVALID_PACKET_TYPE;
   }
 
-  memmove(neighbor->buffer, neighbor->buffer + HEADER_BYTES_LENGTH + header_length,
-          PACKET_MAX_BYTES_LENGTH - (HEADER_BYTES_LENGTH + header_length));
-  neighbor->buffer_size -= (HEADER_BYTES_LENGTH + header_length);
+  return RC_OK;
+}
+
+retcode_t router_read(router_t *const router, neighbor_t *const neighbor, size_t const received) {
+  retcode_t ret = RC_OK;
+  protocol_header_t const *header = NULL;
+  uint16_t header_length = 0;
+
+  if (router == NULL || neighbor == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  neighbor->buffer_size += received;
+
+  // Parses every complete packet, a partially received one stays pending
+  while (neighbor->buffer_size >= HEADER_BYTES_LENGTH) {
+    header = (protocol_header_t const *)(neighbor->buffer + neighbor->buffer_start);
+    header_length = ntohs(header->length);
+
+    if ((ret = router_read_header(neighbor, header)) == RC_OK) {
+      // We haven't received the full packet yet
+      if (neighbor->buffer_size - HEADER_BYTES_LENGTH < header_length) {
+        break;
+      }
+      if (header->type == PROTOCOL_GOSSIP) {
+        ret = router_read_gossip(router, neighbor, (byte_t const *)header + HEADER_BYTES_LENGTH, header_length);
+      }
+    }
+
+    // The stream can't be resynchronized after an invalid packet, pending bytes are discarded
+    if (ret != RC_OK) {
+      neighbor->buffer_start = 0;
+      neighbor->buffer_size = 0;
+      return ret;
+    }
+
+    neighbor->buffer_start += HEADER_BYTES_LENGTH + header_length;
+    neighbor->buffer_size -= HEADER_BYTES_LENGTH + header_length;
+  }
+
+  if (neighbor->buffer_size == 0) {
+    neighbor->buffer_start = 0;
+  }
 
-  return router_read(router, neighbor, buffer + chunk_size, buffer_size - chunk_size);
+  return RC_OK;
 }
 
-retcode_t router_reconnect_attempt(router_t *const router) {
+retcode_t router_reconnect_attempt(router_t *const router, router_loop_t *const loop) {
   retcode_t ret = RC_OK;
   neighbor_t *neighbor = NULL;
 
+  if (router == NULL || loop == NULL) {
+    return RC_NULL_PARAM;
+  }
+
   rw_lock_handle_wrlock(&router->neighbors_lock);
   NEIGHBORS_FOREACH(router->neighbors, neighbor) {
-    if (neighbor->state == NEIGHBOR_DISCONNECTED && neighbor->endpoint.stream == NULL) {
-      if ((ret = router_connect(neighbor)) != RC_OK) {
+    if (neighbor->state == NEIGHBOR_DISCONNECTED && neighbor->endpoint.stream == NULL &&
+        router_loop_by_ip(router, neighbor->endpoint.ip) == loop) {
+      if ((ret = router_connect(loop, neighbor)) != RC_OK) {
         log_warning(logger_id, "Trying to reconnect to neighbor %s:%d failed\n", neighbor->endpoint.domain,
                     neighbor->endpoint.port);
       }
@@ -765,7 +1118,7 @@ retcode_t router_resolve(char const *const domain, char *const ip) {
   return ret;
 }
 
-retcode_t router_connect(neighbor_t *const neighbor) {
+retcode_t router_connect(router_loop_t *const loop, neighbor_t *const neighbor) {
   struct sockaddr_in addr;
   uv_tcp_t *client = NULL;
   uv_connect_t *connection = NULL;
@@ -778,7 +1131,7 @@ retcode_t router_connect(neighbor_t *const neighbor) {
 
   client->data = neighbor;
 
-  if ((ret = uv_tcp_init(uv_default_loop(), client)) != 0 ||
+  if ((ret = uv_tcp_init(&loop->loop, client)) != 0 ||
       (ret = uv_ip4_addr(neighbor->endpoint.ip, neighbor->endpoint.port, &addr)) != 0 ||
       (ret = uv_tcp_nodelay(client, true)) != 0 ||
       (ret = uv_tcp_connect(connection, client, (struct sockaddr *)&addr, router_on_connect)) != 0) {
@@ -788,3 +1141,37 @@ retcode_t router_connect(neighbor_t *const neighbor) {
 
   return RC_OK;
 }
+
+router_loop_t *router_loop_by_ip(router_t const *const router, char const *const ip) {
+  if (router == NULL || ip == NULL) {
+    return NULL;
+  }
+
+  return &router->loops[XXH64(ip, strlen(ip), 0) % router->loops_num];
+}
+
+retcode_t router_loop_stats(router_t *const router, size_t const index, router_loop_stats_t *const stats) {
+  router_loop_t *loop = NULL;
+  neighbor_t *neighbor = NULL;
+
+  if (router == NULL || stats == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (index >= router->loops_num) {
+    return RC_INVALID_PARAM;
+  }
+
+  loop = &router->loops[index];
+  stats->neighbors = 0;
+  rw_lock_handle_rdlock(&router->neighbors_lock);
+  NEIGHBORS_FOREACH(router->neighbors, neighbor) {
+    if (router_loop_by_ip(router, neighbor->endpoint.ip) == loop) {
+      stats->neighbors++;
+    }
+  }
+  rw_lock_handle_unlock(&router->neighbors_lock);
+  stats->reads = atomic_load_explicit(&loop->reads, memory_order_relaxed);
+  stats->read_time = atomic_load_explicit(&loop->read_time, memory_order_relaxed);
+
+  return RC_OK;
+}
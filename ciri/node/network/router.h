@@ -8,12 +8,15 @@
 #ifndef __CIRI_NODE_NETWORK_ROUTER_H__
 #define __CIRI_NODE_NETWORK_ROUTER_H__
 
+#include <stdatomic.h>
+
 #include "utarray.h"
 #include "uv.h"
 
 #include "ciri/node/network/neighbor.h"
 #include "ciri/node/protocol/protocol.h"
 #include "common/errors.h"
+#include "utils/handles/lock.h"
 #include "utils/handles/rw_lock.h"
 #include "utils/handles/thread.h"
 
@@ -28,15 +31,61 @@ extern "C" {
 // Forward declarations
 typedef struct node_s node_t;
 
-typedef struct router_s {
+typedef struct router_s router_t;
+
+/**
+ * A connection accepted by the listening event loop and handed off to the event loop of its neighbor
+ */
+typedef struct router_handoff_s {
+  uv_os_sock_t socket;
+  struct router_handoff_s *next;
+} router_handoff_t;
+
+/**
+ * An event loop running in its own thread and serving the neighbors pinned to it
+ */
+typedef struct router_loop_s {
+  uv_loop_t loop;
+  thread_handle_t thread;
+  size_t index;
+  router_t *router;
+  // Wakes the loop up to close all its handles
+  uv_async_t *stop;
+  // Wakes the loop up to adopt connections handed off by the listening loop
+  uv_async_t *dispatch;
+  router_handoff_t *handoffs;
+  lock_handle_t handoffs_lock;
+  uv_timer_t *reconnect_timer;
+  // Time (in nanoseconds) spent in read callbacks and their number
+  atomic_uint_fast64_t read_time;
+  atomic_uint_fast64_t reads;
+} router_loop_t;
+
+/**
+ * Counters of a router event loop
+ */
+typedef struct router_loop_stats_s {
+  size_t neighbors;   /*!< Number of neighbors pinned to the loop */
+  uint64_t reads;     /*!< Number of read callbacks */
+  uint64_t read_time; /*!< Time (in nanoseconds) spent in read callbacks */
+} router_loop_stats_t;
+
+/**
+ * A router connects the node to its neighbors over several event loops. Each neighbor is pinned to a loop by a hash of
+ * its IP address, which handles its connection, handshake, reads and writes. The first loop also listens for incoming
+ * connections and hands them off to the loop of their peer address.
+ */
+struct router_s {
   // Metadata
   bool running;
-  thread_handle_t thread;
+  router_loop_t *loops;
+  size_t loops_num;
+  uv_tcp_t *server;
   // Data
   node_t *node;
   UT_array *neighbors;
   rw_lock_handle_t neighbors_lock;
-} router_t;
+};
 
 /**
  * Initializes a router
@@ -141,17 +190,26 @@ retcode_t router_read_handshake(router_t *const router, char const *const ip, ui
                                 void const *const buf, size_t const nread, neighbor_t **const neighbor);
 
 /**
- * Reads a buffer from a neighbor
+ * Gets the free space of a neighbor receive buffer, where the next bytes from the neighbor should be read
+ * Pending bytes of a partially received packet are moved to the beginning of the buffer if there is no room left for a
+ * full packet
+ *
+ * @param[in,out] neighbor  The neighbor
+ * @param[out]    buf       The free space
+ */
+void router_read_buffer(neighbor_t *const neighbor, uv_buf_t *const buf);
+
+/**
+ * Parses all complete packets received from a neighbor and hands them to the processor stage
+ * Packets are parsed in place from the neighbor receive buffer into pooled gossip packets
  *
- * @param[in,out] router      The router
- * @param[in]     neighbor    The neighbor
- * @param[in]     buffer      The buffer
- * @param[in]     buffer_size The buffer size
+ * @param[in,out] router    The router
+ * @param[in,out] neighbor  The neighbor
+ * @param[in]     received  The number of bytes just received in the free space of the neighbor receive buffer
  *
  * @return a status code
  */
-retcode_t router_read(router_t *const router, neighbor_t *const neighbor, void const *const buffer,
-                      size_t const buffer_size);
+retcode_t router_read(router_t *const router, neighbor_t *const neighbor, size_t const received);
 
 /**
  * Writes data to a stream
@@ -167,13 +225,14 @@ retcode_t router_write(uv_stream_t *const stream, protocol_packet_type_t const t
                        uint16_t const buffer_size);
 
 /**
- * Attempts to reconnect all disconnected neighbors
+ * Attempts to reconnect all disconnected neighbors pinned to an event loop
  *
  * @param[in,out] router  The router
+ * @param[in,out] loop    The event loop
  *
  * @return a status code
  */
-retcode_t router_reconnect_attempt(router_t *const router);
+retcode_t router_reconnect_attempt(router_t *const router, router_loop_t *const loop);
 
 /**
  * Resolves a domain name into an IP address
@@ -188,11 +247,33 @@ retcode_t router_resolve(char const *const domain, char *const ip);
 /**
  * Initiates a connection with a neighbor
  *
- * @param[in] neighbor The neighbor
+ * @param[in,out] loop      The event loop the neighbor is pinned to
+ * @param[in]     neighbor  The neighbor
+ *
+ * @return a status code
+ */
+retcode_t router_connect(router_loop_t *const loop, neighbor_t *const neighbor);
+
+/**
+ * Gets the event loop a peer address is pinned to
+ *
+ * @param[in] router  The router
+ * @param[in] ip      The IP address
+ *
+ * @return the event loop
+ */
+router_loop_t *router_loop_by_ip(router_t const *const router, char const *const ip);
+
+/**
+ * Gets the counters of an event loop of a router
+ *
+ * @param[in]   router  The router
+ * @param[in]   index   The index of the event loop, lower than the number of loops
+ * @param[out]  stats   The counters
  *
  * @return a status code
  */
-retcode_t router_connect(neighbor_t *const neighbor);
+retcode_t router_loop_stats(router_t *const router, size_t const index, router_loop_stats_t *const stats);
 
 #ifdef __cplusplus
 }
@@ -28,6 +28,12 @@ retcode_t node_init(node_t* const node, core_t* const core, tangle_t* const tang
   node->running = false;
   node->core = core;
 
+  log_info(logger_id, "Initializing gossip pool\n");
+  if ((ret = gossip_pool_init(&node->gossip_pool, node->conf.pipeline_queue_size)) != RC_OK) {
+    log_critical(logger_id, "Initializing gossip pool failed\n");
+    return ret;
+  }
+
   log_info(logger_id, "Initializing broadcaster stage\n");
   if ((ret = broadcaster_stage_init(&node->broadcaster, node)) != RC_OK) {
     log_critical(logger_id, "Initializing broadcaster stage failed\n");
@@ -79,8 +85,8 @@ retcode_t node_init(node_t* const node, core_t* const core, tangle_t* const tang
   }
 
   log_info(logger_id, "Initializing recent seen bytes cache\n");
-  if ((ret = recent_seen_bytes_cache_init(&node->recent_seen_bytes, node->conf.recent_seen_bytes_cache_size)) !=
-      RC_OK) {
+  if ((ret = recent_seen_bytes_cache_init(&node->recent_seen_bytes, node->conf.recent_seen_bytes_cache_size,
+                                          node->conf.recent_seen_bytes_cache_shards)) != RC_OK) {
     log_critical(logger_id, "Initializing recent seen bytes cache failed\n");
     return ret;
   }
@@ -248,6 +254,8 @@ retcode_t node_destroy(node_t* const node) {
 
   tips_cache_destroy(&node->tips);
   recent_seen_bytes_cache_destroy(&node->recent_seen_bytes);
+  // Destroyed last since all stages release their pending packets to the pool
+  gossip_pool_destroy(&node->gossip_pool);
   free(node->conf.neighbors);
 
   logger_helper_release(logger_id);
@@ -9,6 +9,7 @@
 #define __CIRI_NODE_NODE_H__
 
 #include "ciri/node/conf.h"
+#include "ciri/node/gossip_pool.h"
 #include "ciri/node/network/router.h"
 #include "ciri/node/pipeline/broadcaster.h"
 #include "ciri/node/pipeline/hasher.h"
@@ -32,6 +33,7 @@ typedef struct node_s {
   iota_node_conf_t conf;
   bool running;
   core_t* core;
+  gossip_pool_t gossip_pool;
   broadcaster_stage_t broadcaster;
   hasher_stage_t hasher;
   processor_stage_t processor;
@@ -5,12 +5,16 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "ciri/node/pipeline/broadcaster.h"
 #include "ciri/consensus/tangle/tangle.h"
 #include "ciri/node/node.h"
 #include "utils/logger_helper.h"
 
 #define BROADCASTER_LOGGER_ID "broadcaster"
+#define BROADCASTER_BATCH_SIZE 32
 
 static logger_id_t logger_id;
 
@@ -28,9 +32,11 @@ static logger_id_t logger_id;
  */
 static void *broadcaster_stage_routine(broadcaster_stage_t *const broadcaster) {
   tangle_t tangle;
-  lock_handle_t cond_lock;
   neighbor_t *neighbor = NULL;
-  protocol_gossip_queue_entry_t *entry = NULL;
+  protocol_gossip_t *packets[BROADCASTER_BATCH_SIZE];
+  neighbor_packet_t *serialized[BROADCASTER_BATCH_SIZE];
+  size_t packets_num = 0;
+  size_t queued = 0;
 
   if (broadcaster == NULL) {
     return NULL;
@@ -45,34 +51,48 @@ static void *broadcaster_stage_routine(broadcaster_stage_t *const broadcaster) {
     }
   }
 
-  lock_handle_init(&cond_lock);
-  lock_handle_lock(&cond_lock);
-
   while (broadcaster->running) {
-    lock_handle_lock(&broadcaster->lock);
-    entry = protocol_gossip_queue_pop(&broadcaster->queue);
-    lock_handle_unlock(&broadcaster->lock);
-
-    if (entry == NULL) {
-      cond_handle_wait(&broadcaster->cond, &cond_lock);
+    if ((packets_num = stage_queue_pop_batch(&broadcaster->queue, packets, BROADCASTER_BATCH_SIZE)) == 0) {
+      stage_queue_wait(&broadcaster->queue);
       continue;
     }
 
-    log_debug(logger_id, "Broadcasting transaction\n");
+    log_debug(logger_id, "Broadcasting %zu transactions\n", packets_num);
+
+    // Each packet is serialized once and shared by all neighbors
+    for (size_t i = 0; i < packets_num; i++) {
+      if ((serialized[i] = neighbor_packet_new(packets[i])) == NULL) {
+        log_warning(logger_id, "Serializing transaction failed\n");
+      }
+    }
+
     rw_lock_handle_rdlock(&broadcaster->node->router.neighbors_lock);
     NEIGHBORS_FOREACH(broadcaster->node->router.neighbors, neighbor) {
-      if (!endpoint_cmp(&entry->packet.source, &neighbor->endpoint) && neighbor->endpoint.stream != NULL) {
-        if (neighbor_send_bytes(broadcaster->node, &tangle, neighbor, entry->packet.content) != RC_OK) {
-          log_warning(logger_id, "Broadcasting transaction failed\n");
+      if (neighbor->endpoint.stream == NULL) {
+        continue;
+      }
+      queued = 0;
+      for (size_t i = 0; i < packets_num; i++) {
+        if (serialized[i] != NULL && !endpoint_cmp(&packets[i]->source, &neighbor->endpoint)) {
+          if (neighbor_queue_packet(broadcaster->node, &tangle, neighbor, serialized[i], packets[i]) != RC_OK) {
+            log_warning(logger_id, "Broadcasting transaction failed\n");
+          } else {
+            queued++;
+          }
         }
       }
+      // The neighbor writer is woken up once per batch and writes all queued packets at once
+      if (queued > 0 && neighbor_flush(neighbor) != RC_OK) {
+        log_warning(logger_id, "Flushing packets to neighbor failed\n");
+      }
     }
     rw_lock_handle_unlock(&broadcaster->node->router.neighbors_lock);
-    free(entry);
-  }
 
-  lock_handle_unlock(&cond_lock);
-  lock_handle_destroy(&cond_lock);
+    for (size_t i = 0; i < packets_num; i++) {
+      neighbor_packet_release(serialized[i]);
+      gossip_pool_release(packets[i]);
+    }
+  }
 
   if (iota_tangle_destroy(&tangle) != RC_OK) {
     log_critical(logger_id, "Destroying tangle connection failed\n");
@@ -86,6 +106,8 @@ static void *broadcaster_stage_routine(broadcaster_stage_t *const broadcaster) {
  */
 
 retcode_t broadcaster_stage_init(broadcaster_stage_t *const broadcaster, node_t *const node) {
+  retcode_t ret = RC_OK;
+
   if (broadcaster == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -94,20 +116,16 @@ retcode_t broadcaster_stage_init(broadcaster_stage_t *const broadcaster, node_t
 
   // Metadata
 
-  if (cond_handle_init(&broadcaster->cond) != 0) {
-    log_critical(logger_id, "Initializing condition variable failed\n");
-    return RC_COND_INIT;
-  }
-  if (lock_handle_init(&broadcaster->lock) != 0) {
-    log_critical(logger_id, "Initializing lock failed\n");
-    return RC_LOCK_INIT;
-  }
   broadcaster->running = false;
 
   // Data
 
   broadcaster->node = node;
-  broadcaster->queue = NULL;
+  if ((ret = stage_queue_init(&broadcaster->queue, node->conf.pipeline_queue_size, sizeof(protocol_gossip_t *))) !=
+      RC_OK) {
+    log_critical(logger_id, "Initializing broadcaster stage queue failed\n");
+    return ret;
+  }
 
   return RC_OK;
 }
@@ -138,10 +156,7 @@ retcode_t broadcaster_stage_stop(broadcaster_stage_t *const broadcaster) {
 
   log_info(logger_id, "Shutting down broadcaster stage thread\n");
   broadcaster->running = false;
-  if (cond_handle_signal(&broadcaster->cond) != 0) {
-    log_warning(logger_id, "Signaling condition variable failed\n");
-    ret = RC_COND_SIGNAL;
-  }
+  stage_queue_wake_all(&broadcaster->queue);
   if (thread_handle_join(broadcaster->thread, NULL) != 0) {
     log_error(logger_id, "Shutting down broadcaster stage thread failed\n");
     ret = RC_THREAD_JOIN;
@@ -159,21 +174,17 @@ retcode_t broadcaster_stage_destroy(broadcaster_stage_t *const broadcaster) {
     return RC_STILL_RUNNING;
   }
 
-  // Metadata
-
-  if (cond_handle_destroy(&broadcaster->cond) != 0) {
-    log_error(logger_id, "Destroying condition variable failed\n");
-    ret = RC_COND_DESTROY;
-  }
-  if (lock_handle_destroy(&broadcaster->lock) != 0) {
-    log_error(logger_id, "Destroying lock failed\n");
-    ret = RC_LOCK_DESTROY;
-  }
-
   // Data
 
   broadcaster->node = NULL;
-  protocol_gossip_queue_free(&broadcaster->queue);
+  {
+    protocol_gossip_t *packet = NULL;
+
+    while (stage_queue_pop_batch(&broadcaster->queue, &packet, 1) == 1) {
+      gossip_pool_release(packet);
+    }
+  }
+  stage_queue_destroy(&broadcaster->queue);
 
   logger_helper_release(logger_id);
 
@@ -181,36 +192,41 @@ retcode_t broadcaster_stage_destroy(broadcaster_stage_t *const broadcaster) {
 }
 
 retcode_t broadcaster_stage_add(broadcaster_stage_t *const broadcaster, protocol_gossip_t const *const packet) {
-  retcode_t ret = RC_OK;
+  protocol_gossip_t *copy = NULL;
 
   if (broadcaster == NULL || packet == NULL) {
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&broadcaster->lock);
-  ret = protocol_gossip_queue_push(&broadcaster->queue, packet);
-  lock_handle_unlock(&broadcaster->lock);
+  if ((copy = gossip_pool_acquire(&broadcaster->node->gossip_pool)) == NULL) {
+    return RC_OOM;
+  }
+  memcpy(copy, packet, sizeof(protocol_gossip_t));
 
-  if (ret != RC_OK) {
-    log_warning(logger_id, "Pushing packet to broadcaster stage queue failed\n");
-    return ret;
+  return broadcaster_stage_push(broadcaster, copy);
+}
+
+retcode_t broadcaster_stage_push(broadcaster_stage_t *const broadcaster, protocol_gossip_t *const packet) {
+  retcode_t ret = RC_OK;
+
+  if (broadcaster == NULL || packet == NULL) {
+    gossip_pool_release(packet);
+    return RC_NULL_PARAM;
   }
 
-  cond_handle_signal(&broadcaster->cond);
+  if ((ret = stage_queue_push(&broadcaster->queue, &packet)) != RC_OK) {
+    log_debug(logger_id, "Broadcaster stage queue full, dropping packet\n");
+    gossip_pool_release(packet);
+    return ret;
+  }
 
-  return ret;
+  return RC_OK;
 }
 
 size_t broadcaster_stage_size(broadcaster_stage_t *const broadcaster) {
-  size_t size = 0;
-
   if (broadcaster == NULL) {
     return 0;
   }
 
-  lock_handle_lock(&broadcaster->lock);
-  size = protocol_gossip_queue_count(broadcaster->queue);
-  lock_handle_unlock(&broadcaster->lock);
-
-  return size;
+  return stage_queue_size(&broadcaster->queue);
 }
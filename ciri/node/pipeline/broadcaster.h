@@ -10,10 +10,9 @@
 
 #include <stdbool.h>
 
+#include "ciri/node/pipeline/stage_queue.h"
 #include "ciri/node/protocol/gossip.h"
 #include "common/errors.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
 #include "utils/handles/thread.h"
 
 #ifdef __cplusplus
@@ -29,13 +28,11 @@ typedef struct node_s node_t;
  */
 typedef struct broadcaster_stage_s {
   // Metadata
-  cond_handle_t cond;     /*!< Condition variable to wait/signal the broadcaster */
-  lock_handle_t lock;     /*!< Lock for the broadcaster queue */
   bool running;           /*!< State of the broadcaster */
   thread_handle_t thread; /*!< Handle for the broadcaster thread */
   // Data
-  node_t *node;                  /*!< The parent node */
-  protocol_gossip_queue_t queue; /*!< A queue of packets to be broadcasted */
+  node_t *node;        /*!< The parent node */
+  stage_queue_t queue; /*!< A queue of pointers to pooled packets to be broadcasted */
 } broadcaster_stage_t;
 
 /**
@@ -76,7 +73,9 @@ retcode_t broadcaster_stage_stop(broadcaster_stage_t *const broadcaster);
 retcode_t broadcaster_stage_destroy(broadcaster_stage_t *const broadcaster);
 
 /**
- * @brief Adds a packet to be broadcasted
+ * @brief Adds a copy of a packet to be broadcasted
+ *
+ * If the queue is full the packet is dropped and RC_UTILS_RING_BUFFER_FULL is returned
  *
  * @param[out]  broadcaster The broadcaster stage
  * @param[in]   packet      The packet
@@ -85,6 +84,18 @@ retcode_t broadcaster_stage_destroy(broadcaster_stage_t *const broadcaster);
  */
 retcode_t broadcaster_stage_add(broadcaster_stage_t *const broadcaster, protocol_gossip_t const *const packet);
 
+/**
+ * @brief Adds a pooled packet to be broadcasted without copying it
+ *
+ * The broadcaster stage takes ownership of the packet reference, even if the packet is dropped.
+ *
+ * @param[out]  broadcaster The broadcaster stage
+ * @param[in]   packet      A packet acquired from the node gossip pool
+ *
+ * @return a status code
+ */
+retcode_t broadcaster_stage_push(broadcaster_stage_t *const broadcaster, protocol_gossip_t *const packet);
+
 /**
  * @brief Gets the size of the broadcaster stage queue
  *
@@ -15,6 +15,7 @@
 #include "common/trinary/trit_byte.h"
 #include "common/trinary/trit_ptrit.h"
 #include "utils/logger_helper.h"
+#include "utils/time.h"
 
 #define HASHER_LOGGER_ID "hasher"
 #define HASHER_MAX PTRIT_SIZE
@@ -25,79 +26,91 @@ static logger_id_t logger_id;
  * Private functions
  */
 
-static void *hasher_stage_routine(hasher_stage_t *const hasher) {
-  hasher_payload_queue_entry_t *entries[HASHER_MAX] = {NULL};
-  lock_handle_t lock_cond;
-  size_t packets_num = 0;
+/**
+ * Hashes a batch of payloads in a single Curl transform and propagates them to the validator
+ *
+ * @param hasher The hasher stage
+ * @param payloads The payloads
+ * @param payloads_num The number of payloads, at most HASHER_MAX
+ */
+static void hasher_hash_batch(hasher_stage_t *const hasher, hasher_payload_t *const payloads,
+                              size_t const payloads_num) {
   trit_t tx[NUM_TRITS_SERIALIZED_TRANSACTION];
   ptrit_t acc[NUM_TRITS_SERIALIZED_TRANSACTION];
   trit_t hash[HASH_LENGTH_TRIT];
   flex_trit_t flex_hash[FLEX_TRIT_SIZE_243];
   PCurl curl;
 
-  if (hasher == NULL) {
-    return NULL;
-  }
+  ptrit_curl_init(&curl, CURL_P_81);
+  memset(acc, 0, NUM_TRITS_SERIALIZED_TRANSACTION * sizeof(ptrit_t));
+  memset(flex_hash, FLEX_TRIT_NULL_VALUE, sizeof(flex_hash));
 
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
+  for (size_t i = 0; i < payloads_num; i++) {
+    bytes_to_trits(payloads[i].gossip->content, GOSSIP_TX_BYTES_LENGTH, tx, NUM_TRITS_SERIALIZED_TRANSACTION);
+    trits_to_ptrits(tx, acc, i, NUM_TRITS_SERIALIZED_TRANSACTION);
+  }
 
-  while (hasher->running) {
-    packets_num = 0;
-    ptrit_curl_init(&curl, CURL_P_81);
-    memset(acc, 0, NUM_TRITS_SERIALIZED_TRANSACTION * sizeof(ptrit_t));
-    memset(flex_hash, FLEX_TRIT_NULL_VALUE, sizeof(flex_hash));
-
-    while (hasher->running && packets_num < HASHER_MAX) {
-      lock_handle_lock(&hasher->lock);
-      entries[packets_num] = hasher_payload_queue_pop(&hasher->queue);
-      lock_handle_unlock(&hasher->lock);
-
-      if (entries[packets_num] == NULL) {
-        break;
-      }
+  ptrit_curl_absorb(&curl, acc, NUM_TRITS_SERIALIZED_TRANSACTION);
+  ptrit_curl_squeeze(&curl, acc, HASH_LENGTH_TRIT);
 
-      bytes_to_trits(entries[packets_num]->payload.gossip->packet.content, GOSSIP_TX_BYTES_LENGTH, tx,
-                     NUM_TRITS_SERIALIZED_TRANSACTION);
-      trits_to_ptrits(tx, acc, packets_num, NUM_TRITS_SERIALIZED_TRANSACTION);
+  for (size_t j = 0; j < payloads_num; j++) {
+    ptrits_to_trits(acc, hash, j, HASH_LENGTH_TRIT);
+    flex_trits_from_trits(flex_hash, HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
 
-      packets_num++;
+    if (validator_stage_add(&hasher->node->validator, payloads[j].gossip, payloads[j].digest, payloads[j].neighbor,
+                            flex_hash) != RC_OK) {
+      log_warning(logger_id, "Propagating payload to validator failed\n");
+      gossip_pool_release(payloads[j].gossip);
     }
+  }
+
+  atomic_fetch_add_explicit(&hasher->batches, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&hasher->hashes, payloads_num, memory_order_relaxed);
+  if (payloads_num >= hasher->batch_fill) {
+    atomic_fetch_add_explicit(&hasher->full_batches, 1, memory_order_relaxed);
+  }
+}
+
+static void *hasher_stage_routine(hasher_stage_t *const hasher) {
+  hasher_payload_t payloads[HASHER_MAX];
+  size_t payloads_num = 0;
+  size_t popped = 0;
+  uint64_t since = 0;
+  uint64_t elapsed = 0;
+
+  if (hasher == NULL) {
+    return NULL;
+  }
 
-    if (!hasher->running) {
-      break;
+  while (hasher->running) {
+    if ((popped = stage_queue_pop_batch(&hasher->queue, payloads + payloads_num,
+                                        hasher->batch_fill - payloads_num)) > 0 &&
+        payloads_num == 0) {
+      since = current_timestamp_us();
     }
+    payloads_num += popped;
 
-    if (packets_num == 0) {
-      cond_handle_wait(&hasher->cond, &lock_cond);
+    if (payloads_num == 0) {
+      stage_queue_wait(&hasher->queue);
       continue;
     }
 
-    ptrit_curl_absorb(&curl, acc, NUM_TRITS_SERIALIZED_TRANSACTION);
-    ptrit_curl_squeeze(&curl, acc, HASH_LENGTH_TRIT);
-
-    for (size_t j = 0; hasher->running && j < packets_num; j++) {
-      ptrits_to_trits(acc, hash, j, HASH_LENGTH_TRIT);
-      flex_trits_from_trits(flex_hash, HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
-
-      if (validator_stage_add(&hasher->node->validator, entries[j]->payload.gossip, entries[j]->payload.digest,
-                              entries[j]->payload.neighbor, flex_hash) != RC_OK) {
-        log_warning(logger_id, "Propagating request to responder failed\n");
+    // Waits for more transactions until the batch is filled or its oldest transaction is due
+    if (payloads_num < hasher->batch_fill && (elapsed = current_timestamp_us() - since) < hasher->batch_delay) {
+      if (popped == 0) {
+        // Rounded up so that the batch is not polled before its deadline
+        stage_queue_wait_for(&hasher->queue, (hasher->batch_delay - elapsed + 999) / 1000);
       }
-
-      free(entries[j]);
-      entries[j] = NULL;
+      continue;
     }
-  }
 
-  for (size_t j = 0; j < HASHER_MAX; j++) {
-    if (entries[j] != NULL) {
-      free(entries[j]);
-    }
+    hasher_hash_batch(hasher, payloads, payloads_num);
+    payloads_num = 0;
   }
 
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
+  for (size_t i = 0; i < payloads_num; i++) {
+    gossip_pool_release(payloads[i].gossip);
+  }
 
   return NULL;
 }
@@ -107,6 +120,8 @@ static void *hasher_stage_routine(hasher_stage_t *const hasher) {
  */
 
 retcode_t hasher_stage_init(hasher_stage_t *const hasher, node_t *const node) {
+  retcode_t ret = RC_OK;
+
   if (hasher == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -114,9 +129,26 @@ retcode_t hasher_stage_init(hasher_stage_t *const hasher, node_t *const node) {
   logger_id = logger_helper_enable(HASHER_LOGGER_ID, LOGGER_DEBUG, true);
 
   hasher->running = false;
-  hasher->queue = NULL;
-  lock_handle_init(&hasher->lock);
-  cond_handle_init(&hasher->cond);
+  hasher->threads_num = node->conf.hasher_threads > 0 ? node->conf.hasher_threads : 1;
+  if ((hasher->threads = (thread_handle_t *)calloc(hasher->threads_num, sizeof(thread_handle_t))) == NULL) {
+    return RC_OOM;
+  }
+  if ((ret = stage_queue_init(&hasher->queue, node->conf.pipeline_queue_size, sizeof(hasher_payload_t))) != RC_OK) {
+    log_critical(logger_id, "Initializing hasher stage queue failed\n");
+    free(hasher->threads);
+    hasher->threads = NULL;
+    return ret;
+  }
+  hasher->batch_fill = HASHER_MAX * node->conf.hasher_batch_fill / 100;
+  if (hasher->batch_fill == 0) {
+    hasher->batch_fill = 1;
+  } else if (hasher->batch_fill > HASHER_MAX) {
+    hasher->batch_fill = HASHER_MAX;
+  }
+  hasher->batch_delay = node->conf.hasher_batch_delay;
+  atomic_init(&hasher->batches, 0);
+  atomic_init(&hasher->hashes, 0);
+  atomic_init(&hasher->full_batches, 0);
   hasher->node = node;
 
   return RC_OK;
@@ -127,11 +159,18 @@ retcode_t hasher_stage_start(hasher_stage_t *const hasher) {
     return RC_NULL_PARAM;
   }
 
-  log_info(logger_id, "Spawning hasher stage thread\n");
+  log_info(logger_id, "Spawning %zu hasher stage threads\n", hasher->threads_num);
   hasher->running = true;
-  if (thread_handle_create(&hasher->thread, (thread_routine_t)hasher_stage_routine, hasher) != 0) {
-    log_critical(logger_id, "Spawning hasher stage thread failed\n");
-    return RC_THREAD_CREATE;
+  for (size_t i = 0; i < hasher->threads_num; i++) {
+    if (thread_handle_create(&hasher->threads[i], (thread_routine_t)hasher_stage_routine, hasher) != 0) {
+      log_critical(logger_id, "Spawning hasher stage thread failed\n");
+      hasher->running = false;
+      stage_queue_wake_all(&hasher->queue);
+      while (i-- > 0) {
+        thread_handle_join(hasher->threads[i], NULL);
+      }
+      return RC_THREAD_CREATE;
+    }
   }
 
   return RC_OK;
@@ -146,12 +185,14 @@ retcode_t hasher_stage_stop(hasher_stage_t *const hasher) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down hasher stage thread\n");
+  log_info(logger_id, "Shutting down hasher stage threads\n");
   hasher->running = false;
-  cond_handle_signal(&hasher->cond);
-  if (thread_handle_join(hasher->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down hasher stage thread failed\n");
-    ret = RC_THREAD_JOIN;
+  stage_queue_wake_all(&hasher->queue);
+  for (size_t i = 0; i < hasher->threads_num; i++) {
+    if (thread_handle_join(hasher->threads[i], NULL) != 0) {
+      log_error(logger_id, "Shutting down hasher stage thread failed\n");
+      ret = RC_THREAD_JOIN;
+    }
   }
 
   return ret;
@@ -166,105 +207,49 @@ retcode_t hasher_stage_destroy(hasher_stage_t *const hasher) {
     return RC_STILL_RUNNING;
   }
 
-  hasher_payload_queue_free(&hasher->queue);
-  lock_handle_destroy(&hasher->lock);
-  cond_handle_destroy(&hasher->cond);
+  {
+    hasher_payload_t payload;
+
+    while (stage_queue_pop_batch(&hasher->queue, &payload, 1) == 1) {
+      gossip_pool_release(payload.gossip);
+    }
+  }
+  stage_queue_destroy(&hasher->queue);
+  free(hasher->threads);
+  hasher->threads = NULL;
+  hasher->threads_num = 0;
 
   logger_helper_release(logger_id);
 
   return ret;
 }
 
-retcode_t hasher_stage_add(hasher_stage_t *const hasher, protocol_gossip_queue_entry_t *const gossip,
-                           uint64_t const digest, neighbor_t *const neighbor) {
-  retcode_t ret = RC_OK;
+retcode_t hasher_stage_add(hasher_stage_t *const hasher, protocol_gossip_t *const gossip, uint64_t const digest,
+                           neighbor_t *const neighbor) {
+  hasher_payload_t payload = {.gossip = gossip, .digest = digest, .neighbor = neighbor};
 
-  if (hasher == NULL) {
+  if (hasher == NULL || gossip == NULL) {
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&hasher->lock);
-  ret = hasher_payload_queue_push(&hasher->queue, gossip, digest, neighbor);
-  lock_handle_unlock(&hasher->lock);
-
-  if (ret != RC_OK) {
-    log_warning(logger_id, "Pushing packet to hasher stage queue failed\n");
-    return ret;
-  } else {
-    cond_handle_signal(&hasher->cond);
-  }
-
-  return RC_OK;
+  return stage_queue_push(&hasher->queue, &payload);
 }
 
 size_t hasher_stage_size(hasher_stage_t *const hasher) {
-  size_t size = 0;
-
   if (hasher == NULL) {
     return 0;
   }
 
-  lock_handle_lock(&hasher->lock);
-  size = hasher_payload_queue_count(hasher->queue);
-  lock_handle_unlock(&hasher->lock);
-
-  return size;
+  return stage_queue_size(&hasher->queue);
 }
 
-size_t hasher_payload_queue_count(hasher_payload_queue_t const queue) {
-  hasher_payload_queue_entry_t *iter = NULL;
-  size_t count = 0;
-
-  CDL_COUNT(queue, iter, count);
-
-  return count;
-}
-
-retcode_t hasher_payload_queue_push(hasher_payload_queue_t *const queue, protocol_gossip_queue_entry_t *const gossip,
-                                    uint64_t const digest, neighbor_t *const neighbor) {
-  hasher_payload_queue_entry_t *entry = NULL;
-
-  if (queue == NULL || gossip == NULL) {
-    return RC_NULL_PARAM;
-  }
-
-  if ((entry = (hasher_payload_queue_entry_t *)malloc(sizeof(hasher_payload_queue_entry_t))) == NULL) {
-    return RC_OOM;
-  }
-
-  entry->payload.gossip = gossip;
-  entry->payload.digest = digest;
-  entry->payload.neighbor = neighbor;
-  CDL_APPEND(*queue, entry);
-
-  return RC_OK;
-}
-
-hasher_payload_queue_entry_t *hasher_payload_queue_pop(hasher_payload_queue_t *const queue) {
-  hasher_payload_queue_entry_t *front = NULL;
-
-  if (queue == NULL) {
-    return NULL;
-  }
-
-  front = *queue;
-  if (front != NULL) {
-    CDL_DELETE(*queue, front);
-  }
-
-  return front;
-}
-
-void hasher_payload_queue_free(hasher_payload_queue_t *const queue) {
-  hasher_payload_queue_entry_t *iter = NULL, *tmp1 = NULL, *tmp2 = NULL;
-
-  if (queue == NULL) {
+void hasher_stage_stats(hasher_stage_t *const hasher, hasher_stage_stats_t *const stats) {
+  if (hasher == NULL || stats == NULL) {
     return;
   }
 
-  CDL_FOREACH_SAFE(*queue, iter, tmp1, tmp2) {
-    CDL_DELETE(*queue, iter);
-    free(iter);
-  }
-  *queue = NULL;
+  stats->batches = atomic_load_explicit(&hasher->batches, memory_order_relaxed);
+  stats->hashes = atomic_load_explicit(&hasher->hashes, memory_order_relaxed);
+  stats->full_batches = atomic_load_explicit(&hasher->full_batches, memory_order_relaxed);
+  stats->lanes = HASHER_MAX;
 }
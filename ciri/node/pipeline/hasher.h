@@ -8,12 +8,12 @@
 #ifndef __CIRI_NODE_PIPELINE_HASHER_H__
 #define __CIRI_NODE_PIPELINE_HASHER_H__
 
+#include <stdatomic.h>
 #include <stdbool.h>
 
+#include "ciri/node/pipeline/stage_queue.h"
 #include "ciri/node/protocol/gossip.h"
 #include "common/errors.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
 #include "utils/handles/thread.h"
 
 #ifdef __cplusplus
@@ -24,25 +24,38 @@ extern "C" {
 typedef struct node_s node_t;
 
 typedef struct hasher_payload_s {
-  protocol_gossip_queue_entry_t *gossip;
+  protocol_gossip_t *gossip;
   uint64_t digest;
   neighbor_t *neighbor;
 } hasher_payload_t;
 
-typedef struct hasher_payload_queue_entry_s {
-  hasher_payload_t payload;
-  struct hasher_payload_queue_entry_s *next;
-  struct hasher_payload_queue_entry_s *prev;
-} hasher_payload_queue_entry_t;
-
-typedef hasher_payload_queue_entry_t *hasher_payload_queue_t;
+/**
+ * Counters of a hasher stage
+ */
+typedef struct hasher_stage_stats_s {
+  uint64_t batches;      /*!< Number of Curl transforms */
+  uint64_t hashes;       /*!< Number of hashed transactions */
+  uint64_t full_batches; /*!< Number of Curl transforms that reached the fill target */
+  size_t lanes;          /*!< Number of transactions a Curl transform can hash */
+} hasher_stage_stats_t;
 
+/**
+ * A hasher stage hashes transactions in batches, each transaction using a lane of a single Curl transform.
+ * A hasher thread hashes its batch as soon as it reaches the fill target or its oldest transaction waited for the
+ * maximum batching delay, whichever comes first. Without delay, a batch is whatever was queued when the thread woke up:
+ * under load, batches fill up and transforms are fully used while quiet traffic is hashed right away. A delay trades
+ * latency for fuller transforms when traffic is quiet. Hasher threads share the same queue.
+ */
 typedef struct hasher_stage_s {
-  thread_handle_t thread;
   bool running;
-  hasher_payload_queue_t queue;
-  lock_handle_t lock;
-  cond_handle_t cond;
+  size_t threads_num;
+  thread_handle_t *threads;
+  stage_queue_t queue;
+  size_t batch_fill;
+  uint64_t batch_delay;
+  atomic_uint_fast64_t batches;
+  atomic_uint_fast64_t hashes;
+  atomic_uint_fast64_t full_batches;
   node_t *node;
 } hasher_stage_t;
 
@@ -85,16 +98,17 @@ retcode_t hasher_stage_destroy(hasher_stage_t *const hasher);
 
 /**
  * Adds a payload to a hasher stage queue
+ * On success the hasher stage takes ownership of the gossip packet
  *
  * @param[in, out]  hasher    The hasher stage
- * @param[in]       gossip    A gossip packet
+ * @param[in]       gossip    A gossip packet acquired from the node gossip pool
  * @param[in]       digest    The digest of the gossip transaction
  * @param[in]       neighbor  The neighbor that sent the packet
  *
  * @return a status code
  */
-retcode_t hasher_stage_add(hasher_stage_t *const hasher, protocol_gossip_queue_entry_t *const gossip,
-                           uint64_t const digest, neighbor_t *const neighbor);
+retcode_t hasher_stage_add(hasher_stage_t *const hasher, protocol_gossip_t *const gossip, uint64_t const digest,
+                           neighbor_t *const neighbor);
 
 /**
  * Gets the size of the hasher stage queue
@@ -106,44 +120,12 @@ retcode_t hasher_stage_add(hasher_stage_t *const hasher, protocol_gossip_queue_e
 size_t hasher_stage_size(hasher_stage_t *const hasher);
 
 /**
- * Gets the size of a hasher payload queue
- *
- * @param[in] queue The hasher payload queue
- *
- * @return the size of the packet queue
- */
-size_t hasher_payload_queue_count(hasher_payload_queue_t const queue);
-
-/**
- * Pushes a packet to a hasher payload queue
- *
- * @param[out]  queue     The hasher payload queue
- * @param[in]   gossip    A gossip packet
- * @param[in]   digest    The digest of the gossip transaction
- * @param[in]   neighbor  The neighbor that sent the packet
+ * Gets the batching counters of a hasher stage
  *
- * @return a status code
- */
-retcode_t hasher_payload_queue_push(hasher_payload_queue_t *const queue, protocol_gossip_queue_entry_t *const gossip,
-                                    uint64_t const digest, neighbor_t *const neighbor);
-
-/**
- * Pops a packet from a hasher payload queue
- *
- * @param[out]  queue The hasher payload queue
- *
- * @return the hasher payload
- */
-hasher_payload_queue_entry_t *hasher_payload_queue_pop(hasher_payload_queue_t *const queue);
-
-/**
- * Frees a hasher payload queue
- *
- * @param[out]  queue The hasher payload queue
- *
- * @return a status code
+ * @param[in]   hasher  The hasher stage
+ * @param[out]  stats   The counters
  */
-void hasher_payload_queue_free(hasher_payload_queue_t *const queue);
+void hasher_stage_stats(hasher_stage_t *const hasher, hasher_stage_stats_t *const stats);
 
 #ifdef __cplusplus
 }
@@ -5,6 +5,9 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "ciri/node/pipeline/processor.h"
 #include "ciri/node/network/neighbor.h"
 #include "ciri/node/node.h"
@@ -12,6 +15,7 @@
 #include "utils/logger_helper.h"
 
 #define PROCESSOR_LOGGER_ID "processor"
+#define PROCESSOR_BATCH_SIZE 32
 
 static logger_id_t logger_id;
 
@@ -20,68 +24,75 @@ static logger_id_t logger_id;
  */
 
 /**
- * Continuously looks for a packet from a processor packet queue and process it.
+ * Processes a packet: known transactions are answered right away, new ones are sent to the hasher stage
  *
  * @param processor The processor stage
+ * @param packet The packet, ownership is taken
  */
-static void *processor_stage_routine(processor_stage_t *const processor) {
-  protocol_gossip_queue_entry_t *entry = NULL;
+static void processor_stage_process(processor_stage_t *const processor, protocol_gossip_t *const packet) {
   neighbor_t *neighbor = NULL;
   flex_trit_t hash[FLEX_TRIT_SIZE_243];
   uint64_t digest = 0;
+  unsigned int queued = 0;
   bool cached = false;
-  lock_handle_t lock_cond;
 
-  if (processor == NULL) {
-    return NULL;
+  rw_lock_handle_rdlock(&processor->node->router.neighbors_lock);
+  neighbor = router_neighbor_find_by_endpoint(&processor->node->router, &packet->source);
+  rw_lock_handle_unlock(&processor->node->router.neighbors_lock);
+
+  if (neighbor) {
+    log_debug(logger_id, "Processing packet from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
+              neighbor->endpoint.port);
+    neighbor->nbr_all_txs++;
+    // A neighbor added again while its previous packets were queued has not counted them
+    queued = atomic_load(&neighbor->ingress_queued);
+    while (queued > 0 && !atomic_compare_exchange_weak(&neighbor->ingress_queued, &queued, queued - 1)) {
+    }
+  } else {
+    log_debug(logger_id, "Processing packet from API\n");
   }
 
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
+  recent_seen_bytes_cache_hash(packet->content, &digest);
+  recent_seen_bytes_cache_get(&processor->node->recent_seen_bytes, digest, hash, &cached);
 
-  while (processor->running) {
-    lock_handle_lock(&processor->lock);
-    entry = protocol_gossip_queue_pop(&processor->queue);
-    lock_handle_unlock(&processor->lock);
-
-    if (entry == NULL) {
-      cond_handle_wait(&processor->cond, &lock_cond);
-      continue;
+  if (cached) {
+    if (neighbor) {
+      log_debug(logger_id, "Processing request bytes\n");
+      if (responder_process_request(&processor->node->responder, neighbor, packet, hash) != RC_OK) {
+        log_warning(logger_id, "Processing request bytes failed\n");
+      }
     }
+    gossip_pool_release(packet);
+  } else if (hasher_stage_add(&processor->node->hasher, packet, digest, neighbor) != RC_OK) {
+    log_warning(logger_id, "Sending payload to hasher stage failed\n");
+    gossip_pool_release(packet);
+  }
+}
 
-    rw_lock_handle_rdlock(&processor->node->router.neighbors_lock);
-    neighbor = router_neighbor_find_by_endpoint(&processor->node->router, &entry->packet.source);
-    rw_lock_handle_unlock(&processor->node->router.neighbors_lock);
+/**
+ * Continuously looks for packets from a processor packet queue and process them.
+ *
+ * @param processor The processor stage
+ */
+static void *processor_stage_routine(processor_stage_t *const processor) {
+  protocol_gossip_t *packets[PROCESSOR_BATCH_SIZE];
+  size_t packets_num = 0;
 
-    if (neighbor) {
-      log_debug(logger_id, "Processing packet from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
-                neighbor->endpoint.port);
-      neighbor->nbr_all_txs++;
-    } else {
-      log_debug(logger_id, "Processing packet from API\n");
-    }
+  if (processor == NULL) {
+    return NULL;
+  }
 
-    recent_seen_bytes_cache_hash(entry->packet.content, &digest);
-    recent_seen_bytes_cache_get(&processor->node->recent_seen_bytes, digest, hash, &cached);
+  while (processor->running) {
+    if ((packets_num = stage_queue_pop_batch(&processor->queue, packets, PROCESSOR_BATCH_SIZE)) == 0) {
+      stage_queue_wait(&processor->queue);
+      continue;
+    }
 
-    if (cached) {
-      if (neighbor) {
-        log_debug(logger_id, "Processing request bytes\n");
-        if (responder_process_request(&processor->node->responder, neighbor, &entry->packet, hash) != RC_OK) {
-          log_warning(logger_id, "Processing request bytes failed\n");
-        }
-      }
-      free(entry);
-    } else {
-      if (hasher_stage_add(&processor->node->hasher, entry, digest, neighbor) != RC_OK) {
-        log_warning(logger_id, "Sending payload to hasher stage failed\n");
-      }
+    for (size_t i = 0; i < packets_num; i++) {
+      processor_stage_process(processor, packets[i]);
     }
   }
 
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
-
   return NULL;
 }
 
@@ -90,6 +101,8 @@ static void *processor_stage_routine(processor_stage_t *const processor) {
  */
 
 retcode_t processor_stage_init(processor_stage_t *const processor, node_t *const node) {
+  retcode_t ret = RC_OK;
+
   if (processor == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -97,9 +110,11 @@ retcode_t processor_stage_init(processor_stage_t *const processor, node_t *const
   logger_id = logger_helper_enable(PROCESSOR_LOGGER_ID, LOGGER_DEBUG, true);
 
   processor->running = false;
-  processor->queue = NULL;
-  lock_handle_init(&processor->lock);
-  cond_handle_init(&processor->cond);
+  if ((ret = stage_queue_init(&processor->queue, node->conf.pipeline_queue_size, sizeof(protocol_gossip_t *))) !=
+      RC_OK) {
+    log_critical(logger_id, "Initializing processor stage queue failed\n");
+    return ret;
+  }
   processor->node = node;
 
   return RC_OK;
@@ -129,7 +144,7 @@ retcode_t processor_stage_stop(processor_stage_t *const processor) {
 
   log_info(logger_id, "Shutting down processor stage thread\n");
   processor->running = false;
-  cond_handle_signal(&processor->cond);
+  stage_queue_wake_all(&processor->queue);
   if (thread_handle_join(processor->thread, NULL) != 0) {
     log_error(logger_id, "Shutting down processor stage thread failed\n");
     return RC_THREAD_JOIN;
@@ -145,9 +160,14 @@ retcode_t processor_stage_destroy(processor_stage_t *const processor) {
     return RC_STILL_RUNNING;
   }
 
-  protocol_gossip_queue_free(&processor->queue);
-  lock_handle_destroy(&processor->lock);
-  cond_handle_destroy(&processor->cond);
+  {
+    protocol_gossip_t *packet = NULL;
+
+    while (stage_queue_pop_batch(&processor->queue, &packet, 1) == 1) {
+      gossip_pool_release(packet);
+    }
+  }
+  stage_queue_destroy(&processor->queue);
   processor->node = NULL;
 
   logger_helper_release(logger_id);
@@ -156,36 +176,41 @@ retcode_t processor_stage_destroy(processor_stage_t *const processor) {
 }
 
 retcode_t processor_stage_add(processor_stage_t *const processor, protocol_gossip_t const *const packet) {
-  retcode_t ret = RC_OK;
+  protocol_gossip_t *copy = NULL;
 
-  if (processor == NULL) {
+  if (processor == NULL || packet == NULL) {
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&processor->lock);
-  ret = protocol_gossip_queue_push(&processor->queue, packet);
-  lock_handle_unlock(&processor->lock);
+  if ((copy = gossip_pool_acquire(&processor->node->gossip_pool)) == NULL) {
+    return RC_OOM;
+  }
+  memcpy(copy, packet, sizeof(protocol_gossip_t));
+
+  return processor_stage_push(processor, copy);
+}
+
+retcode_t processor_stage_push(processor_stage_t *const processor, protocol_gossip_t *const packet) {
+  retcode_t ret = RC_OK;
+
+  if (processor == NULL || packet == NULL) {
+    gossip_pool_release(packet);
+    return RC_NULL_PARAM;
+  }
 
-  if (ret != RC_OK) {
-    log_warning(logger_id, "Pushing packet to processor stage queue failed\n");
+  if ((ret = stage_queue_push(&processor->queue, &packet)) != RC_OK) {
+    log_debug(logger_id, "Processor stage queue full, dropping packet\n");
+    gossip_pool_release(packet);
     return ret;
-  } else {
-    cond_handle_signal(&processor->cond);
   }
 
   return RC_OK;
 }
 
 size_t processor_stage_size(processor_stage_t *const processor) {
-  size_t size = 0;
-
   if (processor == NULL) {
     return 0;
   }
 
-  lock_handle_lock(&processor->lock);
-  size = protocol_gossip_queue_count(processor->queue);
-  lock_handle_unlock(&processor->lock);
-
-  return size;
+  return stage_queue_size(&processor->queue);
 }
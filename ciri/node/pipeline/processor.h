@@ -10,10 +10,9 @@
 
 #include <stdbool.h>
 
+#include "ciri/node/pipeline/stage_queue.h"
 #include "ciri/node/protocol/gossip.h"
 #include "common/errors.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
 #include "utils/handles/thread.h"
 
 #ifdef __cplusplus
@@ -25,13 +24,12 @@ typedef struct node_s node_t;
 
 /**
  * A processor is responsible for analyzing packets sent by neighbors.
+ * Its queue holds pointers to heap allocated packets owned by the queue until popped.
  */
 typedef struct processor_stage_s {
   thread_handle_t thread;
   bool running;
-  protocol_gossip_queue_t queue;
-  lock_handle_t lock;
-  cond_handle_t cond;
+  stage_queue_t queue;
   node_t *node;
 } processor_stage_t;
 
@@ -73,7 +71,8 @@ retcode_t processor_stage_stop(processor_stage_t *const processor);
 retcode_t processor_stage_destroy(processor_stage_t *const processor);
 
 /**
- * Adds a packet to a processor stage queue
+ * Adds a copy of a packet to a processor stage queue
+ * If the queue is full the packet is dropped and RC_UTILS_RING_BUFFER_FULL is returned
  *
  * @param processor The processor stage
  * @param packet The packet
@@ -82,6 +81,17 @@ retcode_t processor_stage_destroy(processor_stage_t *const processor);
  */
 retcode_t processor_stage_add(processor_stage_t *const processor, protocol_gossip_t const *const packet);
 
+/**
+ * Adds a pooled packet to a processor stage queue without copying it
+ * The processor stage takes ownership of the packet reference, even if the packet is dropped
+ *
+ * @param processor The processor stage
+ * @param packet A packet acquired from the node gossip pool
+ *
+ * @return a status code
+ */
+retcode_t processor_stage_push(processor_stage_t *const processor, protocol_gossip_t *const packet);
+
 /**
  * Gets the size of the processor stage queue
  *
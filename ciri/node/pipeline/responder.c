@@ -14,6 +14,7 @@
 #include "utils/logger_helper.h"
 
 #define RESPONDER_LOGGER_ID "responder"
+#define RESPONDER_BATCH_SIZE 32
 
 static logger_id_t logger_id;
 
@@ -21,6 +22,46 @@ static logger_id_t logger_id;
  * Private functions
  */
 
+/**
+ * Gets the gossip bytes of a transaction, from the cache or by loading and serializing it
+ *
+ * @param responder The responder
+ * @param tangle A tangle
+ * @param hash The transaction hash
+ * @param bytes Filled with the gossip bytes of the transaction if found
+ * @param digest Filled with the recent seen bytes digest of the bytes if found
+ * @param found Whether the transaction was found
+ *
+ * @return a status code
+ */
+static retcode_t get_transaction_bytes(responder_stage_t *const responder, tangle_t *const tangle,
+                                       flex_trit_t const *const hash, byte_t *const bytes, uint64_t *const digest,
+                                       bool *const found) {
+  retcode_t ret = RC_OK;
+  flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
+  DECLARE_PACK_SINGLE_TX(transaction, transaction_ptr, pack);
+
+  if ((ret = transaction_bytes_cache_get(&responder->cache, hash, bytes, digest, found)) != RC_OK || *found) {
+    return ret;
+  }
+
+  if ((ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH, hash, &pack)) != RC_OK) {
+    log_warning(logger_id, "Loading transaction failed\n");
+    return ret;
+  }
+  if (pack.num_loaded == 0) {
+    return RC_OK;
+  }
+
+  transaction_serialize_on_flex_trits(transaction_ptr, transaction_flex_trits);
+  flex_trits_to_bytes(bytes, NUM_TRITS_SERIALIZED_TRANSACTION, transaction_flex_trits, NUM_TRITS_SERIALIZED_TRANSACTION,
+                      NUM_TRITS_SERIALIZED_TRANSACTION);
+  recent_seen_bytes_cache_hash(bytes, digest);
+  *found = true;
+
+  return transaction_bytes_cache_put(&responder->cache, hash, bytes, *digest);
+}
+
 /**
  * Gets a transaction according to a request hash
  * - if null hash: gets a random tip
@@ -30,44 +71,48 @@ static logger_id_t logger_id;
  * @param tangle A tangle
  * @param neighbor The requesting neighbor
  * @param hash The request hash
- * @param pack A stor pack to be filled with a transaction
+ * @param transaction_hash Filled with the hash of the transaction to send
+ * @param bytes Filled with the gossip bytes of the transaction if found
+ * @param digest Filled with the recent seen bytes digest of the bytes if found
+ * @param found Whether the transaction was found
+ * @param respond Whether the request should be replied to
  *
  * @return a status code
  */
-static retcode_t get_transaction_for_request(responder_stage_t const *const responder, tangle_t *const tangle,
+static retcode_t get_transaction_for_request(responder_stage_t *const responder, tangle_t *const tangle,
                                              neighbor_t *const neighbor, flex_trit_t const *const hash,
-                                             iota_stor_pack_t *const pack, bool *const respond) {
+                                             flex_trit_t *const transaction_hash, byte_t *const bytes,
+                                             uint64_t *const digest, bool *const found, bool *const respond) {
   retcode_t ret = RC_OK;
 
-  if (responder == NULL || neighbor == NULL || hash == NULL || pack == NULL) {
+  if (responder == NULL || neighbor == NULL || hash == NULL || transaction_hash == NULL || bytes == NULL ||
+      digest == NULL || found == NULL || respond == NULL) {
     return RC_NULL_PARAM;
   }
 
+  *found = false;
+
   // If the hash is null, a random tip was requested
   if (flex_trits_are_null(hash, FLEX_TRIT_SIZE_243)) {
-    flex_trit_t tip[FLEX_TRIT_SIZE_243];
-
     // Don't reply to random tip requests if the node is synchronized
     *respond = !node_is_synced(responder->node);
     if (respond) {
       log_debug(logger_id, "Responding to random tip request\n");
       neighbor->nbr_random_tx_reqs++;
-      if ((ret = tips_cache_random_tip(&responder->node->tips, tip)) != RC_OK) {
+      if ((ret = tips_cache_random_tip(&responder->node->tips, transaction_hash)) != RC_OK) {
         return ret;
       }
-      if ((ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH, tip, pack)) != RC_OK ||
-          pack->num_loaded == 0) {
-        return ret;
+      if (flex_trits_are_null(transaction_hash, FLEX_TRIT_SIZE_243)) {
+        return RC_OK;
       }
+      return get_transaction_bytes(responder, tangle, transaction_hash, bytes, digest, found);
     }
   }
   // If the hash is non-null, a transaction was requested
   else {
     log_debug(logger_id, "Responding to regular transaction request\n");
-    if ((ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH, hash, pack)) != RC_OK) {
-      log_warning(logger_id, "Loading transaction failed\n");
-      return ret;
-    }
+    memcpy(transaction_hash, hash, FLEX_TRIT_SIZE_243);
+    return get_transaction_bytes(responder, tangle, transaction_hash, bytes, digest, found);
   }
 
   return ret;
@@ -81,34 +126,26 @@ static retcode_t get_transaction_for_request(responder_stage_t const *const resp
  * @param responder The responder
  * @param tangle A tangle
  * @param neighbor The requesting neighbor
- * @param hash The request hash
- * @param pack A stor pack containing a transaction
+ * @param transaction_hash The hash of the transaction to send
+ * @param packet A packet holding the gossip bytes of the transaction if found
+ * @param digest The recent seen bytes digest of the transaction if found
+ * @param found Whether the transaction was found
  *
  * @return a status code
  */
-static retcode_t respond_to_request(responder_stage_t const *const responder, tangle_t *const tangle,
-                                    neighbor_t *const neighbor, flex_trit_t const *const hash,
-                                    iota_stor_pack_t *const pack) {
+static retcode_t respond_to_request(responder_stage_t *const responder, tangle_t *const tangle,
+                                    neighbor_t *const neighbor, flex_trit_t const *const transaction_hash,
+                                    protocol_gossip_t *const packet, uint64_t digest, bool found) {
   retcode_t ret = RC_OK;
-  flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t *transaction = NULL;
 
-  if (responder == NULL || neighbor == NULL || hash == NULL || pack == NULL) {
+  if (responder == NULL || neighbor == NULL || transaction_hash == NULL || packet == NULL) {
     return RC_NULL_PARAM;
   }
 
   // Send the requested transaction back to the neighbor
-  if (pack->num_loaded != 0) {
-    byte_t transaction_bytes[GOSSIP_TX_BYTES_LENGTH];
-    uint64_t digest = 0;
-
-    transaction = ((iota_transaction_t **)(pack->models))[0];
-    transaction_serialize_on_flex_trits(transaction, transaction_flex_trits);
-    flex_trits_to_bytes(transaction_bytes, NUM_TRITS_SERIALIZED_TRANSACTION, transaction_flex_trits,
-                        NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
-    recent_seen_bytes_cache_hash(transaction_bytes, &digest);
-    recent_seen_bytes_cache_put(&responder->node->recent_seen_bytes, digest, hash);
-    if ((ret = neighbor_send_trits(responder->node, tangle, neighbor, transaction_flex_trits)) != RC_OK) {
+  if (found) {
+    recent_seen_bytes_cache_put(&responder->node->recent_seen_bytes, digest, transaction_hash);
+    if ((ret = neighbor_send_bytes(responder->node, tangle, neighbor, packet->content)) != RC_OK) {
       log_warning(logger_id, "Sending transaction failed\n");
       return ret;
     }
@@ -120,16 +157,13 @@ static retcode_t respond_to_request(responder_stage_t const *const responder, ta
   {
     DECLARE_PACK_SINGLE_MILESTONE(latest_milestone, latest_milestone_ptr, milestone_pack);
 
-    hash_pack_reset(pack);
     if ((ret = iota_tangle_milestone_load_last(tangle, &milestone_pack)) != RC_OK || milestone_pack.num_loaded == 0 ||
-        (ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH, latest_milestone.hash, pack)) != RC_OK ||
-        pack->num_loaded == 0) {
-      memset(transaction_flex_trits, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_8019);
-    } else {
-      transaction = ((iota_transaction_t **)(pack->models))[0];
-      transaction_serialize_on_flex_trits(transaction, transaction_flex_trits);
+        (ret = get_transaction_bytes(responder, tangle, latest_milestone.hash, packet->content, &digest, &found)) !=
+            RC_OK ||
+        !found) {
+      memset(packet->content, 0, GOSSIP_TX_BYTES_LENGTH);
     }
-    if ((ret = neighbor_send_trits(responder->node, tangle, neighbor, transaction_flex_trits)) != RC_OK) {
+    if ((ret = neighbor_send_bytes(responder->node, tangle, neighbor, packet->content)) != RC_OK) {
       log_warning(logger_id, "Sending transaction failed\n");
       return ret;
     }
@@ -139,15 +173,18 @@ static retcode_t respond_to_request(responder_stage_t const *const responder, ta
 }
 
 /**
- * Continuously looks for a transaction request from a responder queue and process it
+ * Continuously looks for transaction requests from a responder queue and process them
  *
  * @param responder The responder stage
  */
 static void *responder_stage_routine(responder_stage_t *const responder) {
-  transaction_request_queue_entry_t *entry = NULL;
-  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
-  lock_handle_t lock_cond;
+  transaction_request_t requests[RESPONDER_BATCH_SIZE];
+  size_t requests_num = 0;
+  flex_trit_t transaction_hash[FLEX_TRIT_SIZE_243];
+  protocol_gossip_t packet;
+  uint64_t digest = 0;
   tangle_t tangle;
+  bool found = false;
   bool respond = true;
 
   if (responder == NULL) {
@@ -163,36 +200,27 @@ static void *responder_stage_routine(responder_stage_t *const responder) {
     }
   }
 
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
-
   while (responder->running) {
-    lock_handle_lock(&responder->lock);
-    entry = transaction_request_queue_pop(&responder->queue);
-    lock_handle_unlock(&responder->lock);
-
-    if (entry == NULL) {
-      cond_handle_wait(&responder->cond, &lock_cond);
+    if ((requests_num = stage_queue_pop_batch(&responder->queue, requests, RESPONDER_BATCH_SIZE)) == 0) {
+      stage_queue_wait(&responder->queue);
       continue;
     }
 
-    hash_pack_reset(&pack);
-    respond = true;
-    if (get_transaction_for_request(responder, &tangle, entry->request.neighbor, entry->request.hash, &pack,
-                                    &respond) != RC_OK) {
-      log_warning(logger_id, "Getting transaction for request failed\n");
-    }
-    if (respond) {
-      if (respond_to_request(responder, &tangle, entry->request.neighbor, entry->request.hash, &pack) != RC_OK) {
-        log_warning(logger_id, "Replying to request failed\n");
+    for (size_t i = 0; i < requests_num; i++) {
+      respond = true;
+      if (get_transaction_for_request(responder, &tangle, requests[i].neighbor, requests[i].hash, transaction_hash,
+                                      packet.content, &digest, &found, &respond) != RC_OK) {
+        log_warning(logger_id, "Getting transaction for request failed\n");
+      }
+      if (respond) {
+        if (respond_to_request(responder, &tangle, requests[i].neighbor, transaction_hash, &packet, digest, found) !=
+            RC_OK) {
+          log_warning(logger_id, "Replying to request failed\n");
+        }
       }
     }
-    free(entry);
   }
 
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
-
   if (iota_tangle_destroy(&tangle) != RC_OK) {
     log_critical(logger_id, "Destroying tangle connection failed\n");
   }
@@ -205,6 +233,8 @@ static void *responder_stage_routine(responder_stage_t *const responder) {
  */
 
 retcode_t responder_stage_init(responder_stage_t *const responder, node_t *const node) {
+  retcode_t ret = RC_OK;
+
   if (responder == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -212,9 +242,16 @@ retcode_t responder_stage_init(responder_stage_t *const responder, node_t *const
   logger_id = logger_helper_enable(RESPONDER_LOGGER_ID, LOGGER_DEBUG, true);
 
   responder->running = false;
-  responder->queue = NULL;
-  lock_handle_init(&responder->lock);
-  cond_handle_init(&responder->cond);
+  if ((ret = stage_queue_init(&responder->queue, node->conf.pipeline_queue_size, sizeof(transaction_request_t))) !=
+      RC_OK) {
+    log_critical(logger_id, "Initializing responder stage queue failed\n");
+    return ret;
+  }
+  if ((ret = transaction_bytes_cache_init(&responder->cache, node->conf.transaction_bytes_cache_size)) != RC_OK) {
+    log_critical(logger_id, "Initializing responder transaction bytes cache failed\n");
+    stage_queue_destroy(&responder->queue);
+    return ret;
+  }
   responder->node = node;
 
   return RC_OK;
@@ -246,7 +283,7 @@ retcode_t responder_stage_stop(responder_stage_t *const responder) {
 
   log_info(logger_id, "Shutting down responder stage thread\n");
   responder->running = false;
-  cond_handle_signal(&responder->cond);
+  stage_queue_wake_all(&responder->queue);
   if (thread_handle_join(responder->thread, NULL) != 0) {
     log_error(logger_id, "Shutting down responder stage thread failed\n");
     ret = RC_THREAD_JOIN;
@@ -264,9 +301,8 @@ retcode_t responder_stage_destroy(responder_stage_t *const responder) {
     return RC_STILL_RUNNING;
   }
 
-  transaction_request_queue_free(&responder->queue);
-  lock_handle_destroy(&responder->lock);
-  cond_handle_destroy(&responder->cond);
+  stage_queue_destroy(&responder->queue);
+  transaction_bytes_cache_destroy(&responder->cache);
   responder->node = NULL;
 
   logger_helper_release(logger_id);
@@ -276,38 +312,24 @@ retcode_t responder_stage_destroy(responder_stage_t *const responder) {
 
 retcode_t responder_stage_add(responder_stage_t *const responder, neighbor_t *const neighbor,
                               flex_trit_t const *const hash) {
-  retcode_t ret = RC_OK;
+  transaction_request_t request;
 
   if (responder == NULL || neighbor == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&responder->lock);
-  ret = transaction_request_queue_push(&responder->queue, neighbor, hash);
-  lock_handle_unlock(&responder->lock);
+  request.neighbor = neighbor;
+  memcpy(request.hash, hash, FLEX_TRIT_SIZE_243);
 
-  if (ret != RC_OK) {
-    log_warning(logger_id, "Pushing transaction_request to responder stage queue failed\n");
-    return ret;
-  } else {
-    cond_handle_signal(&responder->cond);
-  }
-
-  return RC_OK;
+  return stage_queue_push(&responder->queue, &request);
 }
 
 size_t responder_stage_size(responder_stage_t *const responder) {
-  size_t size = 0;
-
   if (responder == NULL) {
     return 0;
   }
 
-  lock_handle_lock(&responder->lock);
-  size = transaction_request_queue_count(responder->queue);
-  lock_handle_unlock(&responder->lock);
-
-  return size;
+  return stage_queue_size(&responder->queue);
 }
 
 retcode_t responder_process_request(responder_stage_t *const responder, neighbor_t *const neighbor,
@@ -10,12 +10,12 @@
 
 #include <stdbool.h>
 
+#include "ciri/node/pipeline/stage_queue.h"
 #include "ciri/node/protocol/gossip.h"
 #include "ciri/node/protocol/transaction_request.h"
+#include "ciri/node/transaction_bytes_cache.h"
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
 #include "utils/handles/thread.h"
 
 // Forward declarations
@@ -24,13 +24,14 @@ typedef struct node_s node_t;
 
 /**
  * A responder stage is responsible for responding to transaction requests sent by neighbors.
+ * Its queue holds transaction_request_t elements.
+ * Its cache holds the gossip bytes of the most recently sent transactions, only accessed by its thread.
  */
 typedef struct responder_stage_s {
   thread_handle_t thread;
   bool running;
-  transaction_request_queue_t queue;
-  lock_handle_t lock;
-  cond_handle_t cond;
+  stage_queue_t queue;
+  transaction_bytes_cache_t cache;
   node_t *node;
 } responder_stage_t;
 
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "ciri/node/pipeline/stage_queue.h"
+
+retcode_t stage_queue_init(stage_queue_t *const queue, size_t const capacity, size_t const element_size) {
+  retcode_t ret = RC_OK;
+
+  if (queue == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((ret = lf_ring_buffer_init(&queue->ring, capacity, element_size)) != RC_OK) {
+    return ret;
+  }
+  if (lock_handle_init(&queue->lock) != 0) {
+    lf_ring_buffer_destroy(&queue->ring);
+    return RC_LOCK_INIT;
+  }
+  if (cond_handle_init(&queue->cond) != 0) {
+    lock_handle_destroy(&queue->lock);
+    lf_ring_buffer_destroy(&queue->ring);
+    return RC_COND_INIT;
+  }
+  atomic_init(&queue->waiters, 0);
+  atomic_init(&queue->pushed, 0);
+  atomic_init(&queue->dropped, 0);
+  atomic_init(&queue->popped, 0);
+  atomic_init(&queue->batches, 0);
+
+  return RC_OK;
+}
+
+void stage_queue_destroy(stage_queue_t *const queue) {
+  if (queue == NULL) {
+    return;
+  }
+
+  cond_handle_destroy(&queue->cond);
+  lock_handle_destroy(&queue->lock);
+  lf_ring_buffer_destroy(&queue->ring);
+}
+
+retcode_t stage_queue_push(stage_queue_t *const queue, void const *const element) {
+  if (queue == NULL || element == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if (lf_ring_buffer_push(&queue->ring, element) != RC_OK) {
+    atomic_fetch_add_explicit(&queue->dropped, 1, memory_order_relaxed);
+    return RC_UTILS_RING_BUFFER_FULL;
+  }
+  atomic_fetch_add_explicit(&queue->pushed, 1, memory_order_relaxed);
+
+  // Pairs with the fence in stage_queue_wait: either the waiter sees the element or we see the waiter
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&queue->waiters, memory_order_relaxed) > 0) {
+    lock_handle_lock(&queue->lock);
+    cond_handle_signal(&queue->cond);
+    lock_handle_unlock(&queue->lock);
+  }
+
+  return RC_OK;
+}
+
+size_t stage_queue_pop_batch(stage_queue_t *const queue, void *const elements, size_t const max) {
+  size_t count = 0;
+
+  if (queue == NULL || elements == NULL) {
+    return 0;
+  }
+
+  if ((count = lf_ring_buffer_pop_batch(&queue->ring, elements, max)) > 0) {
+    atomic_fetch_add_explicit(&queue->popped, count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&queue->batches, 1, memory_order_relaxed);
+  }
+
+  return count;
+}
+
+void stage_queue_wait(stage_queue_t *const queue) { stage_queue_wait_for(queue, STAGE_QUEUE_WAIT_TIMEOUT_MS); }
+
+void stage_queue_wait_for(stage_queue_t *const queue, uint64_t const timeout_ms) {
+  if (queue == NULL) {
+    return;
+  }
+
+  lock_handle_lock(&queue->lock);
+  atomic_fetch_add_explicit(&queue->waiters, 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  if (lf_ring_buffer_size(&queue->ring) == 0) {
+    cond_handle_timedwait(&queue->cond, &queue->lock, timeout_ms);
+  }
+  atomic_fetch_sub_explicit(&queue->waiters, 1, memory_order_relaxed);
+  lock_handle_unlock(&queue->lock);
+}
+
+void stage_queue_wake_all(stage_queue_t *const queue) {
+  if (queue == NULL) {
+    return;
+  }
+
+  lock_handle_lock(&queue->lock);
+  cond_handle_broadcast(&queue->cond);
+  lock_handle_unlock(&queue->lock);
+}
+
+size_t stage_queue_size(stage_queue_t *const queue) {
+  if (queue == NULL) {
+    return 0;
+  }
+
+  return lf_ring_buffer_size(&queue->ring);
+}
+
+void stage_queue_stats(stage_queue_t *const queue, stage_queue_stats_t *const stats) {
+  if (queue == NULL || stats == NULL) {
+    return;
+  }
+
+  stats->pushed = atomic_load_explicit(&queue->pushed, memory_order_relaxed);
+  stats->dropped = atomic_load_explicit(&queue->dropped, memory_order_relaxed);
+  stats->popped = atomic_load_explicit(&queue->popped, memory_order_relaxed);
+  stats->batches = atomic_load_explicit(&queue->batches, memory_order_relaxed);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CIRI_NODE_PIPELINE_STAGE_QUEUE_H__
+#define __CIRI_NODE_PIPELINE_STAGE_QUEUE_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "utils/containers/lf_ring_buffer.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum time a stage thread sleeps on an empty queue before checking its running state again
+#define STAGE_QUEUE_WAIT_TIMEOUT_MS 100
+
+/**
+ * @brief Counters of a stage queue
+ */
+typedef struct stage_queue_stats_s {
+  uint64_t pushed;  /*!< Number of elements pushed */
+  uint64_t dropped; /*!< Number of elements dropped because the queue was full */
+  uint64_t popped;  /*!< Number of elements popped */
+  uint64_t batches; /*!< Number of non-empty batches popped */
+} stage_queue_stats_t;
+
+/**
+ * @brief A bounded queue feeding a pipeline stage
+ *
+ * Elements go through a lock-free ring buffer so producers never contend on a lock with the stage thread. The lock and
+ * condition variable are only used to park the stage thread when the queue is empty and are only touched by producers
+ * if the stage thread is actually waiting. When the queue is full, pushes fail and are accounted as drops: this is the
+ * backpressure signal of the stage.
+ */
+typedef struct stage_queue_s {
+  lf_ring_buffer_t ring;        /*!< The elements */
+  lock_handle_t lock;           /*!< Lock protecting the condition variable */
+  cond_handle_t cond;           /*!< Condition variable to wait/signal the stage thread */
+  atomic_uint waiters;          /*!< Number of threads waiting on the condition variable */
+  atomic_uint_fast64_t pushed;  /*!< Number of elements pushed */
+  atomic_uint_fast64_t dropped; /*!< Number of elements dropped */
+  atomic_uint_fast64_t popped;  /*!< Number of elements popped */
+  atomic_uint_fast64_t batches; /*!< Number of non-empty batches popped */
+} stage_queue_t;
+
+/**
+ * @brief Initializes a stage queue
+ *
+ * @param[out]  queue         The stage queue
+ * @param[in]   capacity      The maximum number of elements in the queue
+ * @param[in]   element_size  The size of an element
+ *
+ * @return a status code
+ */
+retcode_t stage_queue_init(stage_queue_t *const queue, size_t const capacity, size_t const element_size);
+
+/**
+ * @brief Destroys a stage queue, remaining elements are discarded
+ *
+ * @param[in,out] queue The stage queue
+ */
+void stage_queue_destroy(stage_queue_t *const queue);
+
+/**
+ * @brief Pushes a copy of an element to a stage queue and wakes the stage thread up if needed
+ *
+ * @param[in,out] queue   The stage queue
+ * @param[in]     element The element
+ *
+ * @return RC_OK if pushed, RC_UTILS_RING_BUFFER_FULL if the element was dropped
+ */
+retcode_t stage_queue_push(stage_queue_t *const queue, void const *const element);
+
+/**
+ * @brief Pops up to a given number of elements from a stage queue
+ *
+ * @param[in,out] queue     The stage queue
+ * @param[out]    elements  An array of at least max elements
+ * @param[in]     max       The maximum number of elements to pop
+ *
+ * @return the number of popped elements
+ */
+size_t stage_queue_pop_batch(stage_queue_t *const queue, void *const elements, size_t const max);
+
+/**
+ * @brief Waits until a stage queue is not empty, woken up or STAGE_QUEUE_WAIT_TIMEOUT_MS elapsed
+ *
+ * @param[in,out] queue The stage queue
+ */
+void stage_queue_wait(stage_queue_t *const queue);
+
+/**
+ * @brief Waits until a stage queue is not empty, woken up or a given timeout elapsed
+ *
+ * @param[in,out] queue       The stage queue
+ * @param[in]     timeout_ms  The maximum time to wait in milliseconds
+ */
+void stage_queue_wait_for(stage_queue_t *const queue, uint64_t const timeout_ms);
+
+/**
+ * @brief Wakes up all threads waiting on a stage queue, typically when stopping a stage
+ *
+ * @param[in,out] queue The stage queue
+ */
+void stage_queue_wake_all(stage_queue_t *const queue);
+
+/**
+ * @brief Gets the number of elements in a stage queue
+ *
+ * @param[in] queue The stage queue
+ *
+ * @return the number of elements
+ */
+size_t stage_queue_size(stage_queue_t *const queue);
+
+/**
+ * @brief Gets the counters of a stage queue
+ *
+ * @param[in]   queue The stage queue
+ * @param[out]  stats The counters
+ */
+void stage_queue_stats(stage_queue_t *const queue, stage_queue_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  //__CIRI_NODE_PIPELINE_STAGE_QUEUE_H__
@@ -8,18 +8,151 @@
 #include "ciri/node/pipeline/transaction_requester.h"
 #include "ciri/consensus/tangle/tangle.h"
 #include "ciri/node/node.h"
-#include "utils/handles/rand.h"
 #include "utils/logger_helper.h"
+#include "utils/time.h"
 
 #define REQUESTER_LOGGER_ID "requester"
 
 static logger_id_t logger_id;
 
+/*
+ * Private functions
+ */
+
+static inline bool requester_entry_before(requester_entry_t const *const a, requester_entry_t const *const b) {
+  return a->due < b->due || (a->due == b->due && a->sequence < b->sequence);
+}
+
+static inline void requester_heap_set(requester_entry_t **const heap, size_t const position,
+                                      requester_entry_t *const entry) {
+  heap[position] = entry;
+  entry->position = position;
+}
+
+static void requester_heap_sift_up(requester_entry_t **const heap, size_t position) {
+  requester_entry_t *const entry = heap[position];
+  size_t parent = 0;
+
+  while (position > 0) {
+    parent = (position - 1) / 2;
+    if (!requester_entry_before(entry, heap[parent])) {
+      break;
+    }
+    requester_heap_set(heap, position, heap[parent]);
+    position = parent;
+  }
+  requester_heap_set(heap, position, entry);
+}
+
+static void requester_heap_sift_down(requester_entry_t **const heap, size_t const size, size_t position) {
+  requester_entry_t *const entry = heap[position];
+  size_t child = 0;
+
+  while ((child = 2 * position + 1) < size) {
+    if (child + 1 < size && requester_entry_before(heap[child + 1], heap[child])) {
+      child++;
+    }
+    if (!requester_entry_before(heap[child], entry)) {
+      break;
+    }
+    requester_heap_set(heap, position, heap[child]);
+    position = child;
+  }
+  requester_heap_set(heap, position, entry);
+}
+
+static void requester_heap_push(transaction_requester_t *const transaction_requester, requester_entry_t *const entry) {
+  requester_entry_t **const heap = transaction_requester->heaps[entry->priority];
+  size_t const position = transaction_requester->heaps_size[entry->priority]++;
+
+  requester_heap_set(heap, position, entry);
+  requester_heap_sift_up(heap, position);
+}
+
+static void requester_heap_remove(transaction_requester_t *const transaction_requester,
+                                  requester_entry_t *const entry) {
+  requester_entry_t **const heap = transaction_requester->heaps[entry->priority];
+  size_t const last = --transaction_requester->heaps_size[entry->priority];
+  size_t const position = entry->position;
+
+  if (position == last) {
+    return;
+  }
+  requester_heap_set(heap, position, heap[last]);
+  if (position > 0 && requester_entry_before(heap[position], heap[(position - 1) / 2])) {
+    requester_heap_sift_up(heap, position);
+  } else {
+    requester_heap_sift_down(heap, last, position);
+  }
+}
+
+static void requester_entry_remove(transaction_requester_t *const transaction_requester,
+                                   requester_entry_t *const entry) {
+  requester_heap_remove(transaction_requester, entry);
+  HASH_DEL(transaction_requester->entries, entry);
+  free(entry);
+}
+
+static size_t requester_entries_size(transaction_requester_t const *const transaction_requester) {
+  size_t size = 0;
+
+  for (size_t i = 0; i < REQUESTER_PRIORITIES; i++) {
+    size += transaction_requester->heaps_size[i];
+  }
+
+  return size;
+}
+
+/**
+ * Picks the due entry to request from a neighbor: the root of the heap or, if the root was last requested from the
+ * same neighbor, one of its children if it is due too
+ */
+static requester_entry_t *requester_heap_due(transaction_requester_t const *const transaction_requester,
+                                             requester_priority_t const priority, neighbor_t const *const neighbor,
+                                             uint64_t const now) {
+  requester_entry_t *const *const heap = transaction_requester->heaps[priority];
+  size_t const size = transaction_requester->heaps_size[priority];
+
+  if (size == 0 || heap[0]->due > now) {
+    return NULL;
+  }
+  if (heap[0]->last_neighbor == neighbor) {
+    for (size_t child = 1; child <= 2 && child < size; child++) {
+      if (heap[child]->due <= now && heap[child]->last_neighbor != neighbor) {
+        return heap[child];
+      }
+    }
+  }
+
+  return heap[0];
+}
+
+static bool requester_was_received(transaction_requester_t const *const transaction_requester,
+                                   flex_trit_t const *const hash) {
+  return bloom_filter_contains(&transaction_requester->received[0], hash, FLEX_TRIT_SIZE_243) ||
+         bloom_filter_contains(&transaction_requester->received[1], hash, FLEX_TRIT_SIZE_243);
+}
+
+static void requester_set_received(transaction_requester_t *const transaction_requester,
+                                   flex_trit_t const *const hash) {
+  bloom_filter_t *current = &transaction_requester->received[transaction_requester->received_current];
+
+  // The older generation is dropped so that the filters never saturate
+  if (bloom_filter_is_full(current)) {
+    transaction_requester->received_current ^= 1;
+    current = &transaction_requester->received[transaction_requester->received_current];
+    bloom_filter_reset(current);
+  }
+  bloom_filter_add(current, hash, FLEX_TRIT_SIZE_243);
+}
+
 /*
  * Public functions
  */
 
 retcode_t requester_init(transaction_requester_t *const transaction_requester, node_t *const node) {
+  retcode_t ret = RC_OK;
+
   if (transaction_requester == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -28,25 +161,61 @@ retcode_t requester_init(transaction_requester_t *const transaction_requester, n
   memset(transaction_requester, 0, sizeof(transaction_requester_t));
   transaction_requester->node = node;
   transaction_requester->running = false;
-  transaction_requester->hashes = NULL;
-  rw_lock_handle_init(&transaction_requester->hashes_lock);
-  transaction_requester->requested_hashes = NULL;
-  rw_lock_handle_init(&transaction_requester->requested_hashes_lock);
+  transaction_requester->entries = NULL;
+  transaction_requester->capacity = node->conf.requester_queue_size;
+  for (size_t i = 0; i < REQUESTER_PRIORITIES; i++) {
+    if ((transaction_requester->heaps[i] = (requester_entry_t **)malloc(transaction_requester->capacity *
+                                                                         sizeof(requester_entry_t *))) == NULL) {
+      ret = RC_OOM;
+      goto done;
+    }
+  }
+  for (size_t i = 0; i < 2; i++) {
+    if ((ret = bloom_filter_init(&transaction_requester->received[i], REQUESTER_RECEIVED_FILTER_CAPACITY,
+                                 REQUESTER_RECEIVED_FILTER_FALSE_POSITIVE_RATE)) != RC_OK) {
+      goto done;
+    }
+  }
+  lock_handle_init(&transaction_requester->lock);
 
-  return RC_OK;
+done:
+  if (ret != RC_OK) {
+    for (size_t i = 0; i < REQUESTER_PRIORITIES; i++) {
+      free(transaction_requester->heaps[i]);
+    }
+    for (size_t i = 0; i < 2; i++) {
+      bloom_filter_destroy(&transaction_requester->received[i]);
+    }
+    logger_helper_release(logger_id);
+  }
+
+  return ret;
 }
 
 retcode_t requester_destroy(transaction_requester_t *const transaction_requester) {
+  requester_entry_t *iter = NULL;
+  requester_entry_t *tmp = NULL;
+
   if (transaction_requester == NULL) {
     return RC_NULL_PARAM;
   } else if (transaction_requester->running) {
     return RC_STILL_RUNNING;
   }
 
-  hash243_set_free(&transaction_requester->hashes);
+  HASH_ITER(hh, transaction_requester->entries, iter, tmp) {
+    HASH_DEL(transaction_requester->entries, iter);
+    free(iter);
+  }
+  for (size_t i = 0; i < REQUESTER_PRIORITIES; i++) {
+    free(transaction_requester->heaps[i]);
+    transaction_requester->heaps[i] = NULL;
+    transaction_requester->heaps_size[i] = 0;
+  }
+  for (size_t i = 0; i < 2; i++) {
+    bloom_filter_destroy(&transaction_requester->received[i]);
+  }
   transaction_requester->node = NULL;
-  rw_lock_handle_destroy(&transaction_requester->hashes_lock);
-  rw_lock_handle_destroy(&transaction_requester->requested_hashes_lock);
+  lock_handle_destroy(&transaction_requester->lock);
   logger_helper_release(logger_id);
 
   return RC_OK;
@@ -55,30 +224,20 @@ retcode_t requester_destroy(transaction_requester_t *const transaction_requester
 retcode_t requester_get_requested_transactions(transaction_requester_t *const transaction_requester,
                                                hash243_stack_t *const hashes) {
   retcode_t ret = RC_OK;
-  hash243_set_entry_t *iter = NULL;
-  hash243_set_entry_t *tmp = NULL;
 
   if (transaction_requester == NULL || hashes == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&transaction_requester->hashes_lock);
-  HASH_SET_ITER(transaction_requester->hashes, iter, tmp) {
-    if ((ret = hash243_stack_push(hashes, iter->hash)) != RC_OK) {
-      break;
-    }
-  }
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
-
-  if (ret != RC_OK) {
-    rw_lock_handle_rdlock(&transaction_requester->requested_hashes_lock);
-    HASH_SET_ITER(transaction_requester->requested_hashes, iter, tmp) {
-      if ((ret = hash243_stack_push(hashes, iter->hash)) != RC_OK) {
+  lock_handle_lock(&transaction_requester->lock);
+  for (size_t i = 0; i < REQUESTER_PRIORITIES && ret == RC_OK; i++) {
+    for (size_t j = 0; j < transaction_requester->heaps_size[i]; j++) {
+      if ((ret = hash243_stack_push(hashes, transaction_requester->heaps[i][j]->hash)) != RC_OK) {
         break;
       }
     }
-    rw_lock_handle_unlock(&transaction_requester->requested_hashes_lock);
   }
+  lock_handle_unlock(&transaction_requester->lock);
 
   return ret;
 }
@@ -90,63 +249,62 @@ size_t requester_size(transaction_requester_t *const transaction_requester) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&transaction_requester->hashes_lock);
-  size = hash243_set_size(transaction_requester->hashes);
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
-
-  rw_lock_handle_rdlock(&transaction_requester->requested_hashes_lock);
-  size += hash243_set_size(transaction_requester->requested_hashes);
-  rw_lock_handle_unlock(&transaction_requester->requested_hashes_lock);
+  lock_handle_lock(&transaction_requester->lock);
+  size = requester_entries_size(transaction_requester);
+  lock_handle_unlock(&transaction_requester->lock);
 
   return size;
 }
 
 bool requester_is_full(transaction_requester_t *const transaction_requester) {
-  size_t size = 0;
-
   if (transaction_requester == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&transaction_requester->hashes_lock);
-  size = hash243_set_size(transaction_requester->hashes);
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
-
-  return size >= transaction_requester->node->conf.requester_queue_size;
+  return requester_size(transaction_requester) >= transaction_requester->capacity;
 }
 
 retcode_t requester_clear_request(transaction_requester_t *const transaction_requester, flex_trit_t const *const hash) {
+  requester_entry_t *entry = NULL;
+
   if (transaction_requester == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&transaction_requester->hashes_lock);
-  hash243_set_remove(&transaction_requester->hashes, hash);
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
-
-  rw_lock_handle_wrlock(&transaction_requester->requested_hashes_lock);
-  hash243_set_remove(&transaction_requester->requested_hashes, hash);
-  rw_lock_handle_unlock(&transaction_requester->requested_hashes_lock);
+  lock_handle_lock(&transaction_requester->lock);
+  requester_set_received(transaction_requester, hash);
+  HASH_FIND(hh, transaction_requester->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry != NULL) {
+    requester_entry_remove(transaction_requester, entry);
+  }
+  lock_handle_unlock(&transaction_requester->lock);
 
   return RC_OK;
 }
 
 retcode_t requester_was_requested(transaction_requester_t *const transaction_requester, flex_trit_t const *const hash,
                                   bool *const was_requested) {
+  requester_entry_t *entry = NULL;
+
   if (transaction_requester == NULL || hash == NULL || was_requested == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&transaction_requester->requested_hashes_lock);
-  *was_requested = hash243_set_contains(transaction_requester->requested_hashes, hash);
-  rw_lock_handle_unlock(&transaction_requester->requested_hashes_lock);
+  lock_handle_lock(&transaction_requester->lock);
+  HASH_FIND(hh, transaction_requester->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  *was_requested = entry != NULL && entry->attempts > 0;
+  lock_handle_unlock(&transaction_requester->lock);
 
   return RC_OK;
 }
 
 retcode_t request_transaction(transaction_requester_t *const transaction_requester, tangle_t *const tangle,
-                              flex_trit_t const *const hash) {
+                              flex_trit_t const *const hash, bool const milestone) {
   retcode_t ret = RC_OK;
+  requester_priority_t const priority = milestone ? REQUESTER_PRIORITY_MILESTONE : REQUESTER_PRIORITY_NORMAL;
+  requester_entry_t *entry = NULL;
+  size_t size = 0;
+  bool received = false;
   bool exists = false;
 
   if (transaction_requester == NULL || hash == NULL) {
@@ -157,49 +315,97 @@ retcode_t request_transaction(transaction_requester_t *const transaction_request
     return RC_OK;
   }
 
-  if ((ret = iota_tangle_transaction_exist(tangle, TRANSACTION_FIELD_HASH, hash, &exists)) != RC_OK) {
-    return ret;
-  }
-  if (exists) {
+  lock_handle_lock(&transaction_requester->lock);
+  HASH_FIND(hh, transaction_requester->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry != NULL) {
+    // Already scheduled, only promote it if it is now needed by a milestone
+    if (priority < entry->priority) {
+      requester_heap_remove(transaction_requester, entry);
+      entry->priority = priority;
+      requester_heap_push(transaction_requester, entry);
+    }
+    lock_handle_unlock(&transaction_requester->lock);
     return RC_OK;
   }
+  received = requester_was_received(transaction_requester, hash);
+  lock_handle_unlock(&transaction_requester->lock);
+
+  if (received) {
+    if ((ret = iota_tangle_transaction_exist(tangle, TRANSACTION_FIELD_HASH, hash, &exists)) != RC_OK) {
+      return ret;
+    }
+    if (exists) {
+      return RC_OK;
+    }
+  }
+
+  lock_handle_lock(&transaction_requester->lock);
 
-  rw_lock_handle_wrlock(&transaction_requester->hashes_lock);
+  // Another thread may have scheduled it in the meantime
+  HASH_FIND(hh, transaction_requester->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry != NULL) {
+    goto done;
+  }
 
-  if (hash243_set_size(transaction_requester->hashes) >= transaction_requester->node->conf.requester_queue_size) {
-    if ((ret = hash243_set_remove_entry(&transaction_requester->hashes, transaction_requester->hashes)) != RC_OK) {
+  if (requester_entries_size(transaction_requester) >= transaction_requester->capacity) {
+    // Milestone requests make room by dropping a normal request, normal requests are dropped
+    size = transaction_requester->heaps_size[REQUESTER_PRIORITY_NORMAL];
+    if (priority == REQUESTER_PRIORITY_NORMAL || size == 0) {
       goto done;
     }
+    // A leaf of the heap is removed without moving any other entry
+    requester_entry_remove(transaction_requester, transaction_requester->heaps[REQUESTER_PRIORITY_NORMAL][size - 1]);
   }
-  if ((ret = hash243_set_add(&transaction_requester->hashes, hash)) != RC_OK) {
+
+  if ((entry = (requester_entry_t *)malloc(sizeof(requester_entry_t))) == NULL) {
+    ret = RC_OOM;
     goto done;
   }
+  memcpy(entry->hash, hash, FLEX_TRIT_SIZE_243);
+  entry->due = 0;
+  entry->sequence = transaction_requester->sequence++;
+  entry->attempts = 0;
+  entry->priority = priority;
+  entry->last_neighbor = NULL;
+  HASH_ADD(hh, transaction_requester->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  requester_heap_push(transaction_requester, entry);
 
 done:
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
+  lock_handle_unlock(&transaction_requester->lock);
 
   return ret;
 }
 
 retcode_t get_transaction_to_request(transaction_requester_t *const transaction_requester, tangle_t const *const tangle,
-                                     flex_trit_t *const hash) {
+                                     neighbor_t const *const neighbor, flex_trit_t *const hash) {
+  requester_entry_t *entry = NULL;
+  uint64_t const now = current_timestamp_ms();
+  uint32_t shift = 0;
+
   if (transaction_requester == NULL || tangle == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&transaction_requester->hashes_lock);
+  lock_handle_lock(&transaction_requester->lock);
+
+  for (size_t i = 0; i < REQUESTER_PRIORITIES && entry == NULL; i++) {
+    entry = requester_heap_due(transaction_requester, i, neighbor, now);
+  }
 
-  if (transaction_requester->hashes != NULL) {
-    memcpy(hash, transaction_requester->hashes->hash, FLEX_TRIT_SIZE_243);
-    hash243_set_remove_entry(&transaction_requester->hashes, transaction_requester->hashes);
-    rw_lock_handle_wrlock(&transaction_requester->requested_hashes_lock);
-    hash243_set_add(&transaction_requester->requested_hashes, hash);
-    rw_lock_handle_unlock(&transaction_requester->requested_hashes_lock);
+  if (entry != NULL) {
+    memcpy(hash, entry->hash, FLEX_TRIT_SIZE_243);
+    // The transaction stays scheduled until received, each attempt doubling the interval before the next one
+    shift = entry->attempts < REQUESTER_MAX_BACKOFF_SHIFT ? entry->attempts : REQUESTER_MAX_BACKOFF_SHIFT;
+    entry->attempts++;
+    entry->due = now + (transaction_requester->node->conf.requester_retry_interval << shift);
+    entry->last_neighbor = neighbor;
+    requester_heap_sift_down(transaction_requester->heaps[entry->priority],
+                             transaction_requester->heaps_size[entry->priority], entry->position);
   } else {
     memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
   }
 
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
+  lock_handle_unlock(&transaction_requester->lock);
 
   return RC_OK;
 }
@@ -9,24 +9,68 @@
 #define __NODE_PIPELINE_TRANSACTION_REQUESTER_H__
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "uthash.h"
 
 #include "common/errors.h"
-#include "utils/containers/hash/hash243_set.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/containers/bloom_filter.h"
 #include "utils/containers/hash/hash243_stack.h"
-#include "utils/handles/rw_lock.h"
+#include "utils/handles/lock.h"
 #include "utils/handles/thread.h"
 
+// Maximum number of times the retry interval of a request is doubled
+#define REQUESTER_MAX_BACKOFF_SHIFT 6
+// Number of recently received transactions remembered by each of the two generations of the received filter
+#define REQUESTER_RECEIVED_FILTER_CAPACITY 100000
+#define REQUESTER_RECEIVED_FILTER_FALSE_POSITIVE_RATE 0.001
+
 // Forward declarations
 typedef struct tangle_s tangle_t;
 typedef struct node_s node_t;
+typedef struct neighbor_s neighbor_t;
+
+/**
+ * Priorities of requests, milestone requests are always served first
+ */
+typedef enum requester_priority_e {
+  REQUESTER_PRIORITY_MILESTONE = 0,
+  REQUESTER_PRIORITY_NORMAL,
+  REQUESTER_PRIORITIES
+} requester_priority_t;
+
+typedef struct requester_entry_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  uint64_t due;                     // Time in ms at which the transaction can be requested (again)
+  uint64_t sequence;                // Insertion order, breaks ties between equally due requests
+  uint32_t attempts;                // Number of times the transaction was requested
+  size_t position;                  // Position in the heap of its priority
+  requester_priority_t priority;
+  neighbor_t const *last_neighbor;  // Neighbor the transaction was last requested from
+  UT_hash_handle hh;
+} requester_entry_t;
 
+/**
+ * A transaction requester
+ *
+ * Missing transactions are indexed by hash and scheduled in one min-heap per priority, ordered by the time they are
+ * due. Every time a transaction is requested, its next attempt is pushed back by an exponentially growing interval and
+ * it stays scheduled until it is received. Consecutive attempts are spread over neighbors. Received transactions are
+ * remembered by a pair of rotating Bloom filters, so that requests for transactions that were just received only hit
+ * the database when the filters say so.
+ */
 typedef struct transaction_requester_s {
   thread_handle_t thread;
   bool running;
-  hash243_set_t hashes;
-  rw_lock_handle_t hashes_lock;
-  hash243_set_t requested_hashes;
-  rw_lock_handle_t requested_hashes_lock;
+  requester_entry_t *entries;
+  requester_entry_t **heaps[REQUESTER_PRIORITIES];
+  size_t heaps_size[REQUESTER_PRIORITIES];
+  size_t capacity;
+  uint64_t sequence;
+  bloom_filter_t received[2];
+  size_t received_current;
+  lock_handle_t lock;
   node_t *node;
 } transaction_requester_t;
 
@@ -107,26 +151,34 @@ retcode_t requester_was_requested(transaction_requester_t *const transaction_req
 /**
  * Adds a transaction to be requested by a transaction requester
  *
+ * Callers are expected to have just failed to load the transaction: the database is only checked if the transaction
+ * was possibly received since.
+ *
  * @param[out]  transaction_requester The transaction requester
  * @param[in]   tangle                A tangle
  * @param[int]  hash                  The transaction to request
+ * @param[in]   milestone             Whether the transaction is needed to solidify a milestone
  *
  * @return a status code
  */
 retcode_t request_transaction(transaction_requester_t *const transaction_requester, tangle_t *const tangle,
-                              flex_trit_t const *const hash);
+                              flex_trit_t const *const hash, bool const milestone);
 
 /**
  * Gets a transaction to request from a transaction requester
  *
+ * The most urgent due transaction is picked, milestone transactions first, avoiding the neighbor it was last requested
+ * from when another one is due.
+ *
  * @param[in, out]  transaction_requester The transaction requester
  * @param[in]       tangle                A tangle
- * @param[out]      hash                  The transaction to be requested
+ * @param[in]       neighbor              The neighbor the request is sent to
+ * @param[out]      hash                  The transaction to be requested, null hash if none is due
  *
  * @return a status code
  */
 retcode_t get_transaction_to_request(transaction_requester_t *const transaction_requester, tangle_t const *const tangle,
-                                     flex_trit_t *const hash);
+                                     neighbor_t const *const neighbor, flex_trit_t *const hash);
 
 #ifdef __cplusplus
 }
@@ -12,8 +12,10 @@
 #include "ciri/consensus/transaction_validator/transaction_validator.h"
 #include "ciri/node/node.h"
 #include "utils/logger_helper.h"
+#include "utils/time.h"
 
 #define VALIDATOR_LOGGER_ID "validator"
+#define VALIDATOR_BATCH_SIZE 32
 
 static logger_id_t logger_id;
 
@@ -22,33 +24,63 @@ static logger_id_t logger_id;
  */
 
 /**
- * Converts transaction bytes from a packet to a transaction, validates it and
- * updates its status.
- * If valid and new: stores and broadcasts it.
+ * New transactions waiting to be stored together in a single database transaction
+ */
+typedef struct validator_batch_s {
+  validator_payload_t *payloads;
+  iota_transaction_t *transactions;
+  size_t size;
+  size_t capacity;
+  uint64_t since;
+} validator_batch_t;
+
+/**
+ * Checks whether a transaction is already waiting in a batch
+ *
+ * @param batch The batch
+ * @param hash The transaction hash
+ *
+ * @return true if the transaction is in the batch, false otherwise
+ */
+static bool validator_batch_contains(validator_batch_t const *const batch, flex_trit_t const *const hash) {
+  for (size_t i = 0; i < batch->size; i++) {
+    if (memcmp(batch->payloads[i].hash, hash, FLEX_TRIT_SIZE_243) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Converts transaction bytes from a packet to a transaction and validates it.
+ * If valid and new: appends it to the batch of transactions to store.
  *
  * @param validator The validator stage
  * @param tangle A tangle
- * @param neighbor The neighbor that sent the packet
- * @param packet The packet from which to process transaction bytes
- * @param hash The transaction hash
+ * @param batch The batch of new transactions
+ * @param payload The payload from which to process transaction bytes
+ * @param is_new Whether the transaction was appended to the batch
  *
  * @return a status code
  */
 static retcode_t validate_transaction_bytes(validator_stage_t const *const validator, tangle_t *const tangle,
-                                            neighbor_t *const neighbor, protocol_gossip_t const *const gossip,
-                                            flex_trit_t const *const hash) {
+                                            validator_batch_t *const batch, validator_payload_t const *const payload,
+                                            bool *const is_new) {
   retcode_t ret = RC_OK;
   bool exists = false;
-  iota_transaction_t transaction;
+  iota_transaction_t *transaction = NULL;
   flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
 
-  if (validator == NULL || gossip == NULL || hash == NULL) {
+  if (validator == NULL || batch == NULL || payload == NULL || is_new == NULL) {
     return RC_NULL_PARAM;
   }
 
-  transaction_reset(&transaction);
+  *is_new = false;
+  transaction = &batch->transactions[batch->size];
+  transaction_reset(transaction);
   // Retreives the transaction from the packet
-  if (flex_trits_from_bytes(transaction_flex_trits, NUM_TRITS_SERIALIZED_TRANSACTION, gossip->content,
+  if (flex_trits_from_bytes(transaction_flex_trits, NUM_TRITS_SERIALIZED_TRANSACTION, payload->gossip->content,
                             NUM_TRITS_SERIALIZED_TRANSACTION,
                             NUM_TRITS_SERIALIZED_TRANSACTION) != NUM_TRITS_SERIALIZED_TRANSACTION) {
     log_warning(logger_id, "Invalid transaction bytes\n");
@@ -57,76 +89,177 @@ static retcode_t validate_transaction_bytes(validator_stage_t const *const valid
   }
 
   // Deserializes the transaction
-  if (transaction_deserialize_from_trits(&transaction, transaction_flex_trits, false) !=
+  if (transaction_deserialize_from_trits(transaction, transaction_flex_trits, false) !=
       NUM_TRITS_SERIALIZED_TRANSACTION) {
     log_warning(logger_id, "Deserializing transaction failed\n");
     ret = RC_PROCESSOR_INVALID_TRANSACTION;
     goto failure;
   }
-  transaction_set_hash(&transaction, hash);
+  transaction_set_hash(transaction, payload->hash);
 
   // Validates the transaction
-  if (!iota_consensus_transaction_validate(validator->transaction_validator, &transaction)) {
+  if (!iota_consensus_transaction_validate(validator->transaction_validator, transaction)) {
     log_debug(logger_id, "Invalid transaction\n");
     goto failure;
   }
 
-  // Checks if the transaction is already persisted
-  if ((ret = iota_tangle_transaction_exist(tangle, TRANSACTION_FIELD_HASH, hash, &exists)) != RC_OK) {
+  // Checks if the transaction is already persisted or about to be
+  if (validator_batch_contains(batch, payload->hash)) {
+    return RC_OK;
+  }
+  // Local failures are not held against the neighbor, whose ingress weight only reflects its invalid transactions
+  if ((ret = iota_tangle_transaction_exist(tangle, TRANSACTION_FIELD_HASH, payload->hash, &exists)) != RC_OK) {
     log_warning(logger_id, "Checking if transaction exists failed\n");
-    goto failure;
+    return ret;
   }
 
   if (!exists) {
-    // Stores the new transaction
-    log_debug(logger_id, "Storing new transaction\n");
-    if ((ret = iota_tangle_transaction_store(tangle, &transaction)) != RC_OK) {
-      log_warning(logger_id, "Storing new transaction failed\n");
-      goto failure;
+    if (batch->size == 0) {
+      batch->since = current_timestamp_us();
     }
+    batch->payloads[batch->size++] = *payload;
+    *is_new = true;
+  }
 
-    // Updates transaction status
-    if ((ret = iota_consensus_transaction_solidifier_update_status(validator->transaction_solidifier, tangle,
-                                                                   &transaction)) != RC_OK) {
-      log_warning(logger_id, "Updating transaction status failed\n");
-      return ret;
-    }
+  return ret;
 
-    // TODO Store transaction metadata
+failure:
+  if (payload->neighbor) {
+    payload->neighbor->nbr_invalid_txs++;
+  }
 
-    // Broadcast the new transaction
-    if ((ret = broadcaster_stage_add(&validator->node->broadcaster, gossip)) != RC_OK) {
-      log_warning(logger_id, "Propagating packet to broadcaster failed\n");
-      goto failure;
-    }
+  return ret;
+}
 
-    if (transaction_current_index(&transaction) == 0 &&
-        memcmp(transaction_address(&transaction), validator->milestone_tracker->conf->coordinator_address,
-               FLEX_TRIT_SIZE_243) == 0) {
-      ret = iota_milestone_tracker_add_candidate(validator->milestone_tracker, transaction_hash(&transaction));
-    }
+/**
+ * Updates the status of a newly stored transaction and broadcasts it
+ *
+ * @param validator The validator stage
+ * @param tangle A tangle
+ * @param payload The payload of the transaction
+ * @param transaction The transaction
+ *
+ * @return a status code
+ */
+static retcode_t process_stored_transaction(validator_stage_t const *const validator, tangle_t *const tangle,
+                                            validator_payload_t const *const payload,
+                                            iota_transaction_t *const transaction) {
+  retcode_t ret = RC_OK;
 
-    if (neighbor) {
-      neighbor->nbr_new_txs++;
-    }
+  // Updates transaction status
+  if ((ret = iota_consensus_transaction_solidifier_update_status(validator->transaction_solidifier, tangle,
+                                                                 transaction)) != RC_OK) {
+    log_warning(logger_id, "Updating transaction status failed\n");
+    return ret;
   }
 
-  return ret;
+  // TODO Store transaction metadata
 
-failure:
-  if (neighbor) {
-    neighbor->nbr_invalid_txs++;
+  // Broadcast the new transaction
+  if ((ret = broadcaster_stage_push(&validator->node->broadcaster, gossip_pool_ref(payload->gossip))) != RC_OK) {
+    log_warning(logger_id, "Propagating packet to broadcaster failed\n");
+    return ret;
+  }
+
+  if (transaction_current_index(transaction) == 0 &&
+      memcmp(transaction_address(transaction), validator->milestone_tracker->conf->coordinator_address,
+             FLEX_TRIT_SIZE_243) == 0) {
+    ret = iota_milestone_tracker_add_candidate(validator->milestone_tracker, transaction_hash(transaction));
+  }
+
+  if (payload->neighbor) {
+    payload->neighbor->nbr_new_txs++;
   }
 
   return ret;
 }
 
-static void *validator_stage_routine(validator_stage_t *const validator) {
-  validator_payload_queue_entry_t *entry = NULL;
-  lock_handle_t lock_cond;
+/**
+ * Releases a payload once its transaction has been handled
+ *
+ * @param validator The validator stage
+ * @param payload The payload
+ */
+static void complete_payload(validator_stage_t *const validator, validator_payload_t *const payload) {
+  recent_seen_bytes_cache_put(&validator->node->recent_seen_bytes, payload->digest, payload->hash);
+  if (responder_process_request(&validator->node->responder, payload->neighbor, payload->gossip, payload->hash) !=
+      RC_OK) {
+    log_warning(logger_id, "Processing request bytes failed\n");
+  }
+
+  gossip_pool_release(payload->gossip);
+}
+
+/**
+ * Stores a batch of new transactions in a single database transaction then processes them.
+ * If the batch can't be stored as a whole, e.g. because one of its transactions was concurrently stored through the
+ * API, transactions are stored one by one.
+ *
+ * @param validator The validator stage
+ * @param tangle A tangle
+ * @param batch The batch of new transactions
+ */
+static void flush_batch(validator_stage_t *const validator, tangle_t *const tangle, validator_batch_t *const batch) {
+  bool batch_stored = false;
+  bool exists = false;
+  uint64_t const now = current_timestamp_ms();
+
+  if (batch->size == 0) {
+    return;
+  }
+
+  // Stamped here rather than by the storage so that the tangle graph knows the arrival timestamps of new transactions
+  for (size_t i = 0; i < batch->size; i++) {
+    transaction_set_arrival_timestamp(&batch->transactions[i], now);
+  }
+
+  log_debug(logger_id, "Storing %zu new transactions\n", batch->size);
+  if (!(batch_stored = iota_tangle_transactions_store(tangle, batch->transactions, batch->size) == RC_OK)) {
+    log_warning(logger_id, "Storing batch of new transactions failed, storing them one by one\n");
+  }
+
+  for (size_t i = 0; i < batch->size; i++) {
+    validator_payload_t *const payload = &batch->payloads[i];
+    iota_transaction_t *const transaction = &batch->transactions[i];
+
+    if (batch_stored || iota_tangle_transaction_store(tangle, transaction) == RC_OK) {
+      if (process_stored_transaction(validator, tangle, payload, transaction) != RC_OK) {
+        log_warning(logger_id, "Processing new transaction failed\n");
+      }
+    } else if (iota_tangle_transaction_exist(tangle, TRANSACTION_FIELD_HASH, payload->hash, &exists) == RC_OK &&
+               exists) {
+      // Concurrently stored, e.g. through the API, the transaction is a duplicate rather than an invalid one
+      log_debug(logger_id, "New transaction already stored\n");
+    } else {
+      log_warning(logger_id, "Storing new transaction failed\n");
+    }
+    complete_payload(validator, payload);
+  }
+
+  batch->size = 0;
+}
+
+static void *validator_worker_routine(validator_worker_t *const worker) {
+  validator_stage_t *validator = NULL;
+  validator_payload_t payloads[VALIDATOR_BATCH_SIZE];
+  size_t payloads_num = 0;
+  validator_batch_t batch;
+  uint64_t elapsed = 0;
+  bool is_new = false;
   tangle_t tangle;
 
-  if (validator == NULL) {
+  if (worker == NULL) {
+    return NULL;
+  }
+
+  validator = worker->validator;
+
+  memset(&batch, 0, sizeof(validator_batch_t));
+  batch.capacity = validator->node->conf.store_batch_size > 0 ? validator->node->conf.store_batch_size : 1;
+  if ((batch.payloads = (validator_payload_t *)malloc(batch.capacity * sizeof(validator_payload_t))) == NULL ||
+      (batch.transactions = (iota_transaction_t *)malloc(batch.capacity * sizeof(iota_transaction_t))) == NULL) {
+    log_critical(logger_id, "Allocating batch of new transactions failed\n");
+    free(batch.payloads);
     return NULL;
   }
 
@@ -135,39 +268,41 @@ static void *validator_stage_routine(validator_stage_t *const validator) {
 
     if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
       log_critical(logger_id, "Initializing tangle connection failed\n");
+      free(batch.payloads);
+      free(batch.transactions);
       return NULL;
     }
   }
 
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
-
   while (validator->running) {
-    lock_handle_lock(&validator->lock);
-    entry = validator_payload_queue_pop(&validator->queue);
-    lock_handle_unlock(&validator->lock);
-
-    if (entry == NULL) {
-      cond_handle_wait(&validator->cond, &lock_cond);
-      continue;
+    payloads_num = stage_queue_pop_batch(&worker->queue, payloads, VALIDATOR_BATCH_SIZE);
+
+    for (size_t i = 0; i < payloads_num; i++) {
+      if (validate_transaction_bytes(validator, &tangle, &batch, &payloads[i], &is_new) != RC_OK) {
+        log_warning(logger_id, "Processing packet failed\n");
+      }
+      if (!is_new) {
+        complete_payload(validator, &payloads[i]);
+      } else if (batch.size == batch.capacity) {
+        flush_batch(validator, &tangle, &batch);
+      }
     }
 
-    if (validate_transaction_bytes(validator, &tangle, entry->payload.neighbor, &entry->payload.gossip->packet,
-                                   entry->payload.hash) != RC_OK) {
-      log_warning(logger_id, "Processing packet failed\n");
-    }
-    recent_seen_bytes_cache_put(&validator->node->recent_seen_bytes, entry->payload.digest, entry->payload.hash);
-    if (responder_process_request(&validator->node->responder, entry->payload.neighbor, &entry->payload.gossip->packet,
-                                  entry->payload.hash) != RC_OK) {
-      log_warning(logger_id, "Processing request bytes failed\n");
+    if (batch.size > 0) {
+      if ((elapsed = current_timestamp_us() - batch.since) >= validator->node->conf.store_batch_delay) {
+        flush_batch(validator, &tangle, &batch);
+      } else if (payloads_num == 0) {
+        // Rounded up so that the batch is not polled before its deadline
+        stage_queue_wait_for(&worker->queue, (validator->node->conf.store_batch_delay - elapsed + 999) / 1000);
+      }
+    } else if (payloads_num == 0) {
+      stage_queue_wait(&worker->queue);
     }
-
-    free(entry->payload.gossip);
-    free(entry);
   }
 
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
+  flush_batch(validator, &tangle, &batch);
+  free(batch.payloads);
+  free(batch.transactions);
 
   if (iota_tangle_destroy(&tangle) != RC_OK) {
     log_critical(logger_id, "Destroying tangle connection failed\n");
@@ -176,6 +311,23 @@ static void *validator_stage_routine(validator_stage_t *const validator) {
   return NULL;
 }
 
+/**
+ * Picks the worker in charge of a transaction hash
+ *
+ * @param validator The validator stage
+ * @param hash The transaction hash
+ *
+ * @return a worker
+ */
+static inline validator_worker_t *validator_worker_for_hash(validator_stage_t const *const validator,
+                                                            flex_trit_t const *const hash) {
+  uint64_t shard = 0;
+
+  memcpy(&shard, hash, sizeof(shard));
+
+  return &validator->workers[shard % validator->workers_num];
+}
+
 /*
  * Public functions
  */
@@ -184,6 +336,8 @@ retcode_t validator_stage_init(validator_stage_t *const validator, node_t *const
                                transaction_validator_t *const transaction_validator,
                                transaction_solidifier_t *const transaction_solidifier,
                                milestone_tracker_t *const milestone_tracker) {
+  retcode_t ret = RC_OK;
+
   if (validator == NULL || node == NULL || transaction_validator == NULL || transaction_solidifier == NULL ||
       milestone_tracker == NULL) {
     return RC_NULL_PARAM;
@@ -192,9 +346,24 @@ retcode_t validator_stage_init(validator_stage_t *const validator, node_t *const
   logger_id = logger_helper_enable(VALIDATOR_LOGGER_ID, LOGGER_DEBUG, true);
 
   validator->running = false;
-  validator->queue = NULL;
-  lock_handle_init(&validator->lock);
-  cond_handle_init(&validator->cond);
+  validator->workers_num = node->conf.validator_threads > 0 ? node->conf.validator_threads : 1;
+  if ((validator->workers = (validator_worker_t *)calloc(validator->workers_num, sizeof(validator_worker_t))) ==
+      NULL) {
+    return RC_OOM;
+  }
+  for (size_t i = 0; i < validator->workers_num; i++) {
+    validator->workers[i].validator = validator;
+    if ((ret = stage_queue_init(&validator->workers[i].queue, node->conf.pipeline_queue_size,
+                                sizeof(validator_payload_t))) != RC_OK) {
+      log_critical(logger_id, "Initializing validator stage queue failed\n");
+      while (i-- > 0) {
+        stage_queue_destroy(&validator->workers[i].queue);
+      }
+      free(validator->workers);
+      validator->workers = NULL;
+      return ret;
+    }
+  }
   validator->node = node;
   validator->transaction_validator = transaction_validator;
   validator->transaction_solidifier = transaction_solidifier;
@@ -208,44 +377,66 @@ retcode_t validator_stage_start(validator_stage_t *const validator) {
     return RC_NULL_PARAM;
   }
 
-  log_info(logger_id, "Spawning validator stage thread\n");
+  log_info(logger_id, "Spawning %zu validator stage threads\n", validator->workers_num);
   validator->running = true;
-  if (thread_handle_create(&validator->thread, (thread_routine_t)validator_stage_routine, validator) != 0) {
-    log_critical(logger_id, "Spawning validator stage thread failed\n");
-    return RC_THREAD_CREATE;
+  for (size_t i = 0; i < validator->workers_num; i++) {
+    if (thread_handle_create(&validator->workers[i].thread, (thread_routine_t)validator_worker_routine,
+                             &validator->workers[i]) != 0) {
+      log_critical(logger_id, "Spawning validator stage thread failed\n");
+      validator->running = false;
+      while (i-- > 0) {
+        stage_queue_wake_all(&validator->workers[i].queue);
+        thread_handle_join(validator->workers[i].thread, NULL);
+      }
+      return RC_THREAD_CREATE;
+    }
   }
 
   return RC_OK;
 }
 
 retcode_t validator_stage_stop(validator_stage_t *const validator) {
+  retcode_t ret = RC_OK;
+
   if (validator == NULL) {
     return RC_NULL_PARAM;
   } else if (validator->running == false) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down validator stage thread\n");
+  log_info(logger_id, "Shutting down validator stage threads\n");
   validator->running = false;
-  cond_handle_signal(&validator->cond);
-  if (thread_handle_join(validator->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down validator stage thread failed\n");
-    return RC_THREAD_JOIN;
+  for (size_t i = 0; i < validator->workers_num; i++) {
+    stage_queue_wake_all(&validator->workers[i].queue);
+  }
+  for (size_t i = 0; i < validator->workers_num; i++) {
+    if (thread_handle_join(validator->workers[i].thread, NULL) != 0) {
+      log_error(logger_id, "Shutting down validator stage thread failed\n");
+      ret = RC_THREAD_JOIN;
+    }
   }
 
-  return RC_OK;
+  return ret;
 }
 
 retcode_t validator_stage_destroy(validator_stage_t *const validator) {
+  validator_payload_t payload;
+
   if (validator == NULL) {
     return RC_NULL_PARAM;
   } else if (validator->running) {
     return RC_STILL_RUNNING;
   }
 
-  validator_payload_queue_free(&validator->queue);
-  lock_handle_destroy(&validator->lock);
-  cond_handle_destroy(&validator->cond);
+  for (size_t i = 0; i < validator->workers_num; i++) {
+    while (stage_queue_pop_batch(&validator->workers[i].queue, &payload, 1) == 1) {
+      gossip_pool_release(payload.gossip);
+    }
+    stage_queue_destroy(&validator->workers[i].queue);
+  }
+  free(validator->workers);
+  validator->workers = NULL;
+  validator->workers_num = 0;
   validator->node = NULL;
 
   logger_helper_release(logger_id);
@@ -253,26 +444,17 @@ retcode_t validator_stage_destroy(validator_stage_t *const validator) {
   return RC_OK;
 }
 
-retcode_t validator_stage_add(validator_stage_t *const validator, protocol_gossip_queue_entry_t *const gossip,
+retcode_t validator_stage_add(validator_stage_t *const validator, protocol_gossip_t *const gossip,
                               uint64_t const digest, neighbor_t *const neighbor, flex_trit_t const *const hash) {
-  retcode_t ret = RC_OK;
+  validator_payload_t payload = {.gossip = gossip, .digest = digest, .neighbor = neighbor};
 
-  if (validator == NULL) {
+  if (validator == NULL || gossip == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&validator->lock);
-  ret = validator_payload_queue_push(&validator->queue, gossip, digest, neighbor, hash);
-  lock_handle_unlock(&validator->lock);
-
-  if (ret != RC_OK) {
-    log_warning(logger_id, "Pushing packet to validator stage queue failed\n");
-    return ret;
-  } else {
-    cond_handle_signal(&validator->cond);
-  }
+  memcpy(payload.hash, hash, FLEX_TRIT_SIZE_243);
 
-  return RC_OK;
+  return stage_queue_push(&validator_worker_for_hash(validator, hash)->queue, &payload);
 }
 
 size_t validator_stage_size(validator_stage_t *const validator) {
@@ -282,70 +464,26 @@ size_t validator_stage_size(validator_stage_t *const validator) {
     return 0;
   }
 
-  lock_handle_lock(&validator->lock);
-  size = validator_payload_queue_count(validator->queue);
-  lock_handle_unlock(&validator->lock);
-
-  return size;
-}
-
-size_t validator_payload_queue_count(validator_payload_queue_t const queue) {
-  validator_payload_queue_entry_t *iter = NULL;
-  size_t count = 0;
-
-  CDL_COUNT(queue, iter, count);
-
-  return count;
-}
-
-retcode_t validator_payload_queue_push(validator_payload_queue_t *const queue,
-                                       protocol_gossip_queue_entry_t *const gossip, uint64_t const digest,
-                                       neighbor_t *const neighbor, flex_trit_t const *const hash) {
-  validator_payload_queue_entry_t *entry = NULL;
-
-  if (queue == NULL || gossip == NULL) {
-    return RC_NULL_PARAM;
+  for (size_t i = 0; i < validator->workers_num; i++) {
+    size += stage_queue_size(&validator->workers[i].queue);
   }
 
-  if ((entry = (validator_payload_queue_entry_t *)malloc(sizeof(validator_payload_queue_entry_t))) == NULL) {
-    return RC_OOM;
-  }
-
-  entry->payload.gossip = gossip;
-  entry->payload.digest = digest;
-  entry->payload.neighbor = neighbor;
-  memcpy(entry->payload.hash, hash, FLEX_TRIT_SIZE_243);
-  CDL_APPEND(*queue, entry);
-
-  return RC_OK;
-}
-
-validator_payload_queue_entry_t *validator_payload_queue_pop(validator_payload_queue_t *const queue) {
-  validator_payload_queue_entry_t *front = NULL;
-
-  if (queue == NULL) {
-    return NULL;
-  }
-
-  front = *queue;
-  if (front != NULL) {
-    CDL_DELETE(*queue, front);
-  }
-
-  return front;
+  return size;
 }
 
-void validator_payload_queue_free(validator_payload_queue_t *const queue) {
-  validator_payload_queue_entry_t *iter = NULL, *tmp1 = NULL, *tmp2 = NULL;
+void validator_stage_stats(validator_stage_t *const validator, stage_queue_stats_t *const stats) {
+  stage_queue_stats_t worker_stats;
 
-  if (queue == NULL) {
+  if (validator == NULL || stats == NULL) {
     return;
   }
 
-  CDL_FOREACH_SAFE(*queue, iter, tmp1, tmp2) {
-    CDL_DELETE(*queue, iter);
-    free(iter->payload.gossip);
-    free(iter);
+  memset(stats, 0, sizeof(stage_queue_stats_t));
+  for (size_t i = 0; i < validator->workers_num; i++) {
+    stage_queue_stats(&validator->workers[i].queue, &worker_stats);
+    stats->pushed += worker_stats.pushed;
+    stats->dropped += worker_stats.dropped;
+    stats->popped += worker_stats.popped;
+    stats->batches += worker_stats.batches;
   }
-  *queue = NULL;
 }
@@ -11,10 +11,9 @@
 #include <stdbool.h>
 
 #include "ciri/node/network/neighbor.h"
+#include "ciri/node/pipeline/stage_queue.h"
 #include "ciri/node/protocol/gossip.h"
 #include "common/errors.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
 #include "utils/handles/thread.h"
 
 #ifdef __cplusplus
@@ -28,26 +27,32 @@ typedef struct transaction_solidifier_s transaction_solidifier_t;
 typedef struct milestone_tracker_s milestone_tracker_t;
 
 typedef struct validator_payload_s {
-  protocol_gossip_queue_entry_t *gossip;
+  protocol_gossip_t *gossip;
   uint64_t digest;
   neighbor_t *neighbor;
   flex_trit_t hash[FLEX_TRIT_SIZE_243];
 } validator_payload_t;
 
-typedef struct validator_payload_queue_entry_s {
-  validator_payload_t payload;
-  struct validator_payload_queue_entry_s *next;
-  struct validator_payload_queue_entry_s *prev;
-} validator_payload_queue_entry_t;
+typedef struct validator_stage_s validator_stage_t;
 
-typedef validator_payload_queue_entry_t *validator_payload_queue_t;
+/**
+ * A validator worker owns a thread, a queue and, while running, a tangle connection.
+ */
+typedef struct validator_worker_s {
+  thread_handle_t thread;
+  stage_queue_t queue;
+  validator_stage_t *validator;
+} validator_worker_t;
 
+/**
+ * A validator stage dispatches payloads to a pool of workers.
+ * Payloads are sharded by transaction hash so that a given transaction is always validated by the same worker, which
+ * serializes its exists check and store.
+ */
 typedef struct validator_stage_s {
-  thread_handle_t thread;
   bool running;
-  validator_payload_queue_t queue;
-  lock_handle_t lock;
-  cond_handle_t cond;
+  size_t workers_num;
+  validator_worker_t *workers;
   node_t *node;
   transaction_validator_t *transaction_validator;
   transaction_solidifier_t *transaction_solidifier;
@@ -99,15 +104,17 @@ retcode_t validator_stage_destroy(validator_stage_t *const validator);
 
 /**
  * Adds a packet to a validator stage queue
+ * On success the validator stage takes ownership of the gossip packet
  *
  * @param validator The validator stage
- * @param[in]       gossip    A gossip packet
+ * @param[in]       gossip    A gossip packet acquired from the node gossip pool
  * @param[in]       digest    The digest of the gossip transaction
  * @param[in]       neighbor  The neighbor that sent the packet
+ * @param[in]       hash      The hash of the gossip transaction
  *
  * @return a status code
  */
-retcode_t validator_stage_add(validator_stage_t *const validator, protocol_gossip_queue_entry_t *const gossip,
+retcode_t validator_stage_add(validator_stage_t *const validator, protocol_gossip_t *const gossip,
                               uint64_t const digest, neighbor_t *const neighbor, flex_trit_t const *const hash);
 
 /**
@@ -115,50 +122,17 @@ retcode_t validator_stage_add(validator_stage_t *const validator, protocol_gossi
  *
  * @param validator The validator stage
  *
- * @return a status code
+ * @return the total number of payloads queued on all workers
  */
 size_t validator_stage_size(validator_stage_t *const validator);
 
 /**
- * Gets the size of a validator payload queue
- *
- * @param[in] queue The validator payload queue
- *
- * @return the size of the packet queue
- */
-size_t validator_payload_queue_count(validator_payload_queue_t const queue);
-
-/**
- * Pushes a packet to a validator payload queue
- *
- * @param[out]  queue     The validator payload queue
- * @param[in]   gossip    A gossip packet
- * @param[in]   digest    The digest of the gossip transaction
- * @param[in]   neighbor  The neighbor that sent the packet
+ * Gets the queue counters of a validator stage, accumulated over all workers
  *
- * @return a status code
- */
-retcode_t validator_payload_queue_push(validator_payload_queue_t *const queue,
-                                       protocol_gossip_queue_entry_t *const gossip, uint64_t const digest,
-                                       neighbor_t *const neighbor, flex_trit_t const *const hash);
-
-/**
- * Pops a packet from a validator payload queue
- *
- * @param[out]  queue The validator payload queue
- *
- * @return the validator payload
- */
-validator_payload_queue_entry_t *validator_payload_queue_pop(validator_payload_queue_t *const queue);
-
-/**
- * Frees a validator payload queue
- *
- * @param[out]  queue The validator payload queue
- *
- * @return a status code
+ * @param[in]   validator The validator stage
+ * @param[out]  stats     The counters
  */
-void validator_payload_queue_free(validator_payload_queue_t *const queue);
+void validator_stage_stats(validator_stage_t *const validator, stage_queue_stats_t *const stats);
 
 #ifdef __cplusplus
 }
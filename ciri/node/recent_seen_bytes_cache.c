@@ -5,19 +5,172 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "ciri/node/recent_seen_bytes_cache.h"
 
-retcode_t recent_seen_bytes_cache_init(recent_seen_bytes_cache_t *const cache, size_t const capacity) {
+/*
+ * Private functions
+ */
+
+static inline size_t next_power_of_two(size_t const value) {
+  size_t power = 1;
+
+  while (power < value) {
+    power <<= 1;
+  }
+
+  return power;
+}
+
+/**
+ * Hints the CPU that the thread is spinning, sparing the resources of a sibling hardware thread that may be the writer
+ */
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * Backs off after a failed lookup attempt: spins briefly since writers hold a shard for a few slot writes, then yields
+ * so that a writer preempted in the middle of an update gets to finish it
+ */
+static inline void shard_backoff(size_t *const attempts) {
+  if (++*attempts < RECENT_SEEN_BYTES_CACHE_SPINS) {
+    cpu_relax();
+  } else {
+    sched_yield();
+  }
+}
+
+static inline recent_seen_bytes_cache_shard_t *cache_shard(recent_seen_bytes_cache_t const *const cache,
+                                                          uint64_t const digest) {
+  return &cache->shards[(digest >> 32) & (cache->shards_num - 1)];
+}
+
+static inline recent_seen_bytes_cache_slot_t *shard_slot(recent_seen_bytes_cache_shard_t const *const shard,
+                                                        uint64_t const digest, size_t const probe) {
+  return &shard->slots[(digest + probe) & shard->mask];
+}
+
+/**
+ * Looks a digest up in the probe window of a shard without taking the lock
+ *
+ * Entries are never removed, only replaced, so an entry always sits before the first unused slot of its window.
+ */
+static recent_seen_bytes_cache_slot_t *shard_find(recent_seen_bytes_cache_shard_t *const shard, uint64_t const digest,
+                                                  flex_trit_t *const hash) {
+  recent_seen_bytes_cache_slot_t *slot = NULL;
+  recent_seen_bytes_cache_slot_t *found = NULL;
+  uint_fast32_t version = 0;
+  size_t attempts = 0;
+
+  while (true) {
+    if ((version = atomic_load_explicit(&shard->version, memory_order_acquire)) & 1) {
+      shard_backoff(&attempts);
+      continue;
+    }
+    found = NULL;
+    for (size_t i = 0; i < RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH; i++) {
+      slot = shard_slot(shard, digest, i);
+      if (!slot->used) {
+        break;
+      }
+      if (slot->digest == digest) {
+        memcpy(hash, slot->hash, FLEX_TRIT_SIZE_243);
+        found = slot;
+        break;
+      }
+    }
+    // Pairs with the release fence of the writer: if the version did not change, no writer touched the slots
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&shard->version, memory_order_relaxed) == version) {
+      return found;
+    }
+    shard_backoff(&attempts);
+  }
+}
+
+/**
+ * Picks the slot to store a new digest in: the first unused slot of its window or, if the window is full, the first
+ * slot that has not been referenced since the CLOCK hand last passed over it
+ */
+static recent_seen_bytes_cache_slot_t *shard_victim(recent_seen_bytes_cache_shard_t *const shard,
+                                                    uint64_t const digest, bool *const evicted) {
+  recent_seen_bytes_cache_slot_t *slot = NULL;
+
+  *evicted = false;
+  for (size_t i = 0; i < RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH; i++) {
+    slot = shard_slot(shard, digest, i);
+    if (!slot->used) {
+      return slot;
+    }
+  }
+
+  // Readers keep setting reference bits concurrently, two laps bound the search
+  *evicted = true;
+  for (size_t i = 0; i < 2 * RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH; i++) {
+    slot = shard_slot(shard, digest, shard->clock_hand++ % RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH);
+    if (!atomic_exchange_explicit(&slot->referenced, false, memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  return slot;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t recent_seen_bytes_cache_init(recent_seen_bytes_cache_t *const cache, size_t const capacity,
+                                       size_t const shards_num) {
+  recent_seen_bytes_cache_shard_t *shard = NULL;
+  size_t slots_num = 0;
+
   if (cache == NULL) {
     return RC_NULL_PARAM;
   }
 
-  cache->capacity = capacity;
-  cache->miss = 0;
-  cache->hit = 0;
-  lock_handle_init(&cache->lock);
+  cache->shards_num = next_power_of_two(shards_num == 0 ? 1 : shards_num);
+  slots_num = next_power_of_two((capacity + cache->shards_num - 1) / cache->shards_num);
+  if (slots_num < RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH) {
+    slots_num = RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH;
+  }
+  cache->capacity = slots_num * cache->shards_num;
+
+  if ((cache->shards = (recent_seen_bytes_cache_shard_t *)aligned_alloc(
+           RECENT_SEEN_BYTES_CACHE_LINE_SIZE, cache->shards_num * sizeof(recent_seen_bytes_cache_shard_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    shard = &cache->shards[i];
+    if ((shard->slots = (recent_seen_bytes_cache_slot_t *)calloc(slots_num, sizeof(recent_seen_bytes_cache_slot_t))) ==
+        NULL) {
+      cache->shards_num = i;
+      recent_seen_bytes_cache_destroy(cache);
+      return RC_OOM;
+    }
+    for (size_t j = 0; j < slots_num; j++) {
+      atomic_init(&shard->slots[j].referenced, false);
+    }
+    shard->mask = slots_num - 1;
+    shard->clock_hand = 0;
+    lock_handle_init(&shard->lock);
+    atomic_init(&shard->version, 0);
+    atomic_init(&shard->size, 0);
+    atomic_init(&shard->hit, 0);
+    atomic_init(&shard->miss, 0);
+    atomic_init(&shard->evictions, 0);
+  }
 
-  return uint64_t_to_flex_trit_t_map_init(&cache->map, sizeof(uint64_t), FLEX_TRIT_SIZE_243);
+  return RC_OK;
 }
 
 retcode_t recent_seen_bytes_cache_destroy(recent_seen_bytes_cache_t *const cache) {
@@ -25,56 +178,116 @@ retcode_t recent_seen_bytes_cache_destroy(recent_seen_bytes_cache_t *const cache
     return RC_NULL_PARAM;
   }
 
-  lock_handle_destroy(&cache->lock);
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    lock_handle_destroy(&cache->shards[i].lock);
+    free(cache->shards[i].slots);
+  }
+  free(cache->shards);
+  cache->shards = NULL;
+  cache->shards_num = 0;
+  cache->capacity = 0;
 
-  return uint64_t_to_flex_trit_t_map_free(&cache->map);
+  return RC_OK;
 }
 
 retcode_t recent_seen_bytes_cache_get(recent_seen_bytes_cache_t *const cache, uint64_t const digest,
                                       flex_trit_t *const hash, bool *const found) {
-  retcode_t ret = RC_OK;
-  uint64_t_to_flex_trit_t_map_entry_t *entry = NULL;
+  recent_seen_bytes_cache_shard_t *shard = NULL;
+  recent_seen_bytes_cache_slot_t *slot = NULL;
 
   if (cache == NULL || hash == NULL || found == NULL) {
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&cache->lock);
+  shard = cache_shard(cache, digest);
 
-  if ((*found = uint64_t_to_flex_trit_t_map_find(cache->map, &digest, &entry))) {
-    memcpy(hash, entry->value, FLEX_TRIT_SIZE_243);
-    cache->hit++;
+  if ((*found = (slot = shard_find(shard, digest, hash)) != NULL)) {
+    atomic_store_explicit(&slot->referenced, true, memory_order_relaxed);
+    atomic_fetch_add_explicit(&shard->hit, 1, memory_order_relaxed);
   } else {
-    cache->miss++;
+    atomic_fetch_add_explicit(&shard->miss, 1, memory_order_relaxed);
   }
 
-  lock_handle_unlock(&cache->lock);
-
-  return ret;
+  return RC_OK;
 }
 
 retcode_t recent_seen_bytes_cache_put(recent_seen_bytes_cache_t *const cache, uint64_t const digest,
                                       flex_trit_t const *const hash) {
-  retcode_t ret = RC_OK;
-  uint64_t_to_flex_trit_t_map_entry_t *entry = NULL;
+  recent_seen_bytes_cache_shard_t *shard = NULL;
+  recent_seen_bytes_cache_slot_t *slot = NULL;
+  flex_trit_t cached[FLEX_TRIT_SIZE_243];
+  uint_fast32_t version = 0;
+  bool evicted = false;
 
   if (cache == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&cache->lock);
+  shard = cache_shard(cache, digest);
 
-  if (!uint64_t_to_flex_trit_t_map_find(cache->map, &digest, &entry)) {
-    if (uint64_t_to_flex_trit_t_map_size(cache->map) >= cache->capacity) {
-      if ((ret = uint64_t_to_flex_trit_t_map_remove_entry(&cache->map, cache->map.map)) != RC_OK) {
-        goto done;
-      }
-    }
-    ret = uint64_t_to_flex_trit_t_map_add(&cache->map, &digest, hash);
+  lock_handle_lock(&shard->lock);
+
+  // Writers are serialized by the lock so the lookup always succeeds at first try
+  if (shard_find(shard, digest, cached) != NULL) {
+    goto done;
+  }
+
+  slot = shard_victim(shard, digest, &evicted);
+
+  version = atomic_load_explicit(&shard->version, memory_order_relaxed);
+  atomic_store_explicit(&shard->version, version + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  slot->digest = digest;
+  memcpy(slot->hash, hash, FLEX_TRIT_SIZE_243);
+  slot->used = true;
+  atomic_store_explicit(&slot->referenced, false, memory_order_relaxed);
+  atomic_store_explicit(&shard->version, version + 2, memory_order_release);
+
+  if (evicted) {
+    atomic_fetch_add_explicit(&shard->evictions, 1, memory_order_relaxed);
+  } else {
+    atomic_fetch_add_explicit(&shard->size, 1, memory_order_relaxed);
   }
 
 done:
-  lock_handle_unlock(&cache->lock);
+  lock_handle_unlock(&shard->lock);
+
+  return RC_OK;
+}
+
+retcode_t recent_seen_bytes_cache_shard_stats(recent_seen_bytes_cache_t const *const cache, size_t const shard,
+                                              recent_seen_bytes_cache_stats_t *const stats) {
+  if (cache == NULL || stats == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (shard >= cache->shards_num) {
+    return RC_INVALID_PARAM;
+  }
+
+  stats->hit = atomic_load_explicit(&cache->shards[shard].hit, memory_order_relaxed);
+  stats->miss = atomic_load_explicit(&cache->shards[shard].miss, memory_order_relaxed);
+  stats->evictions = atomic_load_explicit(&cache->shards[shard].evictions, memory_order_relaxed);
+  stats->size = atomic_load_explicit(&cache->shards[shard].size, memory_order_relaxed);
+
+  return RC_OK;
+}
+
+retcode_t recent_seen_bytes_cache_stats(recent_seen_bytes_cache_t const *const cache,
+                                        recent_seen_bytes_cache_stats_t *const stats) {
+  recent_seen_bytes_cache_stats_t shard_stats;
+
+  if (cache == NULL || stats == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(stats, 0, sizeof(recent_seen_bytes_cache_stats_t));
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    recent_seen_bytes_cache_shard_stats(cache, i, &shard_stats);
+    stats->hit += shard_stats.hit;
+    stats->miss += shard_stats.miss;
+    stats->evictions += shard_stats.evictions;
+    stats->size += shard_stats.size;
+  }
 
-  return ret;
+  return RC_OK;
 }
@@ -8,10 +8,14 @@
 #ifndef __NODE_RECENT_SEEN_BYTES_CACHE_H__
 #define __NODE_RECENT_SEEN_BYTES_CACHE_H__
 
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "xxhash.h"
 
 #include "ciri/node/protocol/gossip.h"
-#include "ciri/node/uint64_t_to_flex_trit_t_map.h"
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
 #include "utils/handles/lock.h"
@@ -20,22 +24,129 @@
 extern "C" {
 #endif
 
-// A fixed capacity FIFO-behaving recent seen bytes cache
+#define RECENT_SEEN_BYTES_CACHE_LINE_SIZE 64
+// Number of consecutive slots an entry can be stored in, starting from the slot its digest maps to
+#define RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH 8
+// Number of failed lock-free lookup attempts after which a reader yields its CPU to the writer instead of spinning
+#define RECENT_SEEN_BYTES_CACHE_SPINS 16
+
+/**
+ * @brief Counters of a recent seen bytes cache shard
+ */
+typedef struct recent_seen_bytes_cache_stats_s {
+  uint64_t hit;       /*!< Number of lookups that found their digest */
+  uint64_t miss;      /*!< Number of lookups that did not find their digest */
+  uint64_t evictions; /*!< Number of entries evicted to make room for new ones */
+  size_t size;        /*!< Number of entries */
+} recent_seen_bytes_cache_stats_t;
+
+typedef struct recent_seen_bytes_cache_slot_s {
+  uint64_t digest;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  bool used;
+  atomic_bool referenced;
+} recent_seen_bytes_cache_slot_t;
+
+/**
+ * @brief A shard of a recent seen bytes cache
+ *
+ * Lookups are lock-free: the version is odd while a writer modifies the slots and readers retry if it changed while
+ * they were reading. Writers are serialized by the lock.
+ */
+typedef struct recent_seen_bytes_cache_shard_s {
+  alignas(RECENT_SEEN_BYTES_CACHE_LINE_SIZE) atomic_uint_fast32_t version; /*!< Odd while the slots are modified */
+  recent_seen_bytes_cache_slot_t *slots;                                   /*!< Open-addressing table of entries */
+  size_t mask;                                                             /*!< Number of slots - 1 */
+  size_t clock_hand;                                                       /*!< CLOCK hand within a probe window */
+  lock_handle_t lock;                                                      /*!< Serializes writers */
+  atomic_size_t size;                                                      /*!< Number of entries */
+  atomic_uint_fast64_t hit;                                                /*!< Number of hits */
+  atomic_uint_fast64_t miss;                                               /*!< Number of misses */
+  atomic_uint_fast64_t evictions;                                          /*!< Number of evictions */
+} recent_seen_bytes_cache_shard_t;
+
+/**
+ * @brief A fixed memory cache mapping digests of transaction bytes to transaction hashes
+ *
+ * Entries are spread over shards by the high bits of their digest and stored in a bounded probe window of the shard
+ * table. When the window is full, an entry is evicted with the CLOCK (second chance) policy: entries that were hit
+ * since the hand last passed are spared once.
+ */
 typedef struct recent_seen_bytes_cache_s {
-  uint64_t_to_flex_trit_t_map_t map;
-  size_t capacity;
-  uint64_t miss;
-  uint64_t hit;
-  lock_handle_t lock;
+  recent_seen_bytes_cache_shard_t *shards; /*!< The shards */
+  size_t shards_num;                       /*!< Number of shards, a power of two */
+  size_t capacity;                         /*!< Total number of slots */
 } recent_seen_bytes_cache_t;
 
-retcode_t recent_seen_bytes_cache_init(recent_seen_bytes_cache_t *const cache, size_t const capacity);
+/**
+ * @brief Initializes a recent seen bytes cache
+ *
+ * @param[out]  cache       The cache
+ * @param[in]   capacity    The minimum number of entries, rounded up to a power of two per shard
+ * @param[in]   shards_num  The number of shards, rounded up to a power of two
+ *
+ * @return a status code
+ */
+retcode_t recent_seen_bytes_cache_init(recent_seen_bytes_cache_t *const cache, size_t const capacity,
+                                       size_t const shards_num);
+
+/**
+ * @brief Destroys a recent seen bytes cache
+ *
+ * @param[in,out] cache The cache
+ *
+ * @return a status code
+ */
 retcode_t recent_seen_bytes_cache_destroy(recent_seen_bytes_cache_t *const cache);
+
+/**
+ * @brief Looks up the transaction hash of a digest
+ *
+ * @param[in,out] cache   The cache
+ * @param[in]     digest  The digest of the transaction bytes
+ * @param[out]    hash    The transaction hash, if found
+ * @param[out]    found   Whether the digest was found
+ *
+ * @return a status code
+ */
 retcode_t recent_seen_bytes_cache_get(recent_seen_bytes_cache_t *const cache, uint64_t const digest,
                                       flex_trit_t *const hash, bool *const found);
+
+/**
+ * @brief Adds a digest and its transaction hash, possibly evicting another entry
+ *
+ * @param[in,out] cache   The cache
+ * @param[in]     digest  The digest of the transaction bytes
+ * @param[in]     hash    The transaction hash
+ *
+ * @return a status code
+ */
 retcode_t recent_seen_bytes_cache_put(recent_seen_bytes_cache_t *const cache, uint64_t const digest,
                                       flex_trit_t const *const hash);
 
+/**
+ * @brief Gets the counters of a shard of a recent seen bytes cache
+ *
+ * @param[in]   cache The cache
+ * @param[in]   shard The index of the shard
+ * @param[out]  stats The counters
+ *
+ * @return a status code
+ */
+retcode_t recent_seen_bytes_cache_shard_stats(recent_seen_bytes_cache_t const *const cache, size_t const shard,
+                                              recent_seen_bytes_cache_stats_t *const stats);
+
+/**
+ * @brief Gets the counters of a recent seen bytes cache, summed over all shards
+ *
+ * @param[in]   cache The cache
+ * @param[out]  stats The counters
+ *
+ * @return a status code
+ */
+retcode_t recent_seen_bytes_cache_stats(recent_seen_bytes_cache_t const *const cache,
+                                        recent_seen_bytes_cache_stats_t *const stats);
+
 static inline retcode_t recent_seen_bytes_cache_hash(byte_t const *const bytes, uint64_t *const digest) {
   if (bytes == NULL || digest == NULL) {
     return RC_NULL_PARAM;
@@ -49,9 +160,9 @@ static inline retcode_t recent_seen_bytes_cache_hash(byte_t const *const bytes,
 static inline size_t recent_seen_bytes_cache_size(recent_seen_bytes_cache_t *const cache) {
   size_t size = 0;
 
-  lock_handle_lock(&cache->lock);
-  size = uint64_t_to_flex_trit_t_map_size(cache->map);
-  lock_handle_unlock(&cache->lock);
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    size += atomic_load_explicit(&cache->shards[i].size, memory_order_relaxed);
+  }
 
   return size;
 }
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "ciri/node/gossip_pool.h"
+
+static gossip_pool_t pool;
+
+void setUp(void) { TEST_ASSERT(gossip_pool_init(&pool, 2) == RC_OK); }
+
+void tearDown(void) { gossip_pool_destroy(&pool); }
+
+void test_acquire_release(void) {
+  protocol_gossip_t *gossip = NULL;
+
+  TEST_ASSERT_NOT_NULL(gossip = gossip_pool_acquire(&pool));
+  memset(gossip, 0, sizeof(protocol_gossip_t));
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_size(&pool.free_buffers), 0);
+
+  gossip_pool_release(gossip);
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_size(&pool.free_buffers), 1);
+
+  // Released packets are reused
+  TEST_ASSERT(gossip_pool_acquire(&pool) == gossip);
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_size(&pool.free_buffers), 0);
+  gossip_pool_release(gossip);
+}
+
+void test_references(void) {
+  protocol_gossip_t *gossip = NULL;
+
+  TEST_ASSERT_NOT_NULL(gossip = gossip_pool_acquire(&pool));
+  TEST_ASSERT(gossip_pool_ref(gossip) == gossip);
+  TEST_ASSERT(gossip_pool_ref(gossip) == gossip);
+
+  // The packet goes back to the pool with its last reference
+  gossip_pool_release(gossip);
+  gossip_pool_release(gossip);
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_size(&pool.free_buffers), 0);
+  gossip_pool_release(gossip);
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_size(&pool.free_buffers), 1);
+}
+
+void test_exhausted(void) {
+  protocol_gossip_t *gossips[4];
+
+  // Acquiring more packets than the pool keeps allocates them on demand
+  for (size_t i = 0; i < 4; i++) {
+    TEST_ASSERT_NOT_NULL(gossips[i] = gossip_pool_acquire(&pool));
+  }
+
+  // Releasing more packets than the pool keeps frees them
+  for (size_t i = 0; i < 4; i++) {
+    gossip_pool_release(gossips[i]);
+  }
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_size(&pool.free_buffers), 2);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_acquire_release);
+  RUN_TEST(test_references);
+  RUN_TEST(test_exhausted);
+
+  return UNITY_END();
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/node/network/neighbor.h"
+
+#define RATE 10
+
+static neighbor_t spammer;
+static neighbor_t honest;
+
+void setUp(void) {
+  TEST_ASSERT(neighbor_init_with_values(&spammer, "127.0.0.1", 14600) == RC_OK);
+  TEST_ASSERT(neighbor_init_with_values(&honest, "127.0.0.2", 14600) == RC_OK);
+}
+
+void tearDown(void) {
+  TEST_ASSERT(neighbor_destroy(&spammer) == RC_OK);
+  TEST_ASSERT(neighbor_destroy(&honest) == RC_OK);
+}
+
+void test_neighbor_ingress_rate(void) {
+  // A neighbor over its rate is dropped while another one is still let in
+  for (size_t i = 0; i < RATE; i++) {
+    TEST_ASSERT_TRUE(neighbor_ingress_allow(&spammer, RATE, 1000));
+  }
+  TEST_ASSERT_FALSE(neighbor_ingress_allow(&spammer, RATE, 1000));
+  TEST_ASSERT_TRUE(neighbor_ingress_allow(&honest, RATE, 1000));
+
+  // Until it is refilled
+  TEST_ASSERT_TRUE(neighbor_ingress_allow(&spammer, RATE, 1100));
+
+  // No rate means no limit
+  for (size_t i = 0; i < 10 * RATE; i++) {
+    TEST_ASSERT_TRUE(neighbor_ingress_allow(&spammer, 0, 1100));
+  }
+}
+
+void test_neighbor_ingress_weight(void) {
+  size_t allowed = 0;
+
+  // A window of invalid transactions lowers the weight and rate of a neighbor
+  spammer.nbr_all_txs = NEIGHBOR_INGRESS_WINDOW;
+  spammer.nbr_invalid_txs = NEIGHBOR_INGRESS_WINDOW;
+  honest.nbr_all_txs = NEIGHBOR_INGRESS_WINDOW;
+  TEST_ASSERT_TRUE(neighbor_ingress_allow(&spammer, RATE, 0));
+  TEST_ASSERT_TRUE(neighbor_ingress_allow(&honest, RATE, 0));
+  TEST_ASSERT_EQUAL_UINT((NEIGHBOR_INGRESS_WEIGHT_MIN + NEIGHBOR_INGRESS_WEIGHT_MAX) / 2, spammer.ingress_weight);
+  TEST_ASSERT_EQUAL_UINT(NEIGHBOR_INGRESS_WEIGHT_MAX, honest.ingress_weight);
+
+  // Over a second, once their bursts are spent, the spammer is let in at about half the rate of the honest neighbor
+  for (size_t i = 0; i < RATE - 1; i++) {
+    TEST_ASSERT_TRUE(neighbor_ingress_allow(&spammer, RATE, 0));
+    TEST_ASSERT_TRUE(neighbor_ingress_allow(&honest, RATE, 0));
+  }
+  for (uint64_t now = 100; now <= 1000; now += 100) {
+    allowed += neighbor_ingress_allow(&spammer, RATE, now);
+    TEST_ASSERT_TRUE(neighbor_ingress_allow(&honest, RATE, now));
+  }
+  TEST_ASSERT_TRUE(allowed >= RATE / 2 - 1 && allowed <= RATE / 2 + 1);
+}
+
+void test_neighbor_ingress_share(void) {
+  size_t const capacity = 100;
+  uint64_t weights = 0;
+
+  spammer.ingress_weight = NEIGHBOR_INGRESS_WEIGHT_MIN;
+  weights = spammer.ingress_weight + honest.ingress_weight;
+
+  // The spammer only holds its share of a crowded queue while the honest neighbor can hold more
+  spammer.ingress_queued = capacity * NEIGHBOR_INGRESS_WEIGHT_MIN / weights - 1;
+  TEST_ASSERT_TRUE(neighbor_ingress_share_allow(&spammer, capacity, weights));
+  spammer.ingress_queued++;
+  TEST_ASSERT_FALSE(neighbor_ingress_share_allow(&spammer, capacity, weights));
+  honest.ingress_queued = spammer.ingress_queued;
+  TEST_ASSERT_TRUE(neighbor_ingress_share_allow(&honest, capacity, weights));
+  honest.ingress_queued = capacity * NEIGHBOR_INGRESS_WEIGHT_MAX / weights;
+  TEST_ASSERT_FALSE(neighbor_ingress_share_allow(&honest, capacity, weights));
+
+  // A neighbor can always queue at least one transaction
+  spammer.ingress_queued = 0;
+  TEST_ASSERT_TRUE(neighbor_ingress_share_allow(&spammer, 1, weights));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_neighbor_ingress_rate);
+  RUN_TEST(test_neighbor_ingress_weight);
+  RUN_TEST(test_neighbor_ingress_share);
+
+  return UNITY_END();
+}
@@ -30,9 +30,10 @@ void test_recent_seen_bytes_cache() {
   }
   transactions_deserialize(txs_trytes, txs, 4, true);
 
-  TEST_ASSERT(recent_seen_bytes_cache_init(&cache, 3) == RC_OK);
+  TEST_ASSERT(recent_seen_bytes_cache_init(&cache, 3, 1) == RC_OK);
 
   TEST_ASSERT(recent_seen_bytes_cache_size(&cache) == 0);
+  TEST_ASSERT_EQUAL_INT(cache.capacity, RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH);
 
   // Checking that 4 trytes are not in the cache
 
@@ -108,7 +109,7 @@ void test_recent_seen_bytes_cache() {
   TEST_ASSERT_EQUAL_MEMORY(transaction_hash(txs[2]), hash, FLEX_TRIT_SIZE_243);
   TEST_ASSERT(recent_seen_bytes_cache_size(&cache) == 3);
 
-  // Adding an element in excess should drop latest element
+  // The capacity was rounded up so an additional element still fits
 
   digest = 0;
   digest_found = false;
@@ -118,24 +119,95 @@ void test_recent_seen_bytes_cache() {
   TEST_ASSERT(recent_seen_bytes_cache_get(&cache, digest, hash, &digest_found) == RC_OK);
   TEST_ASSERT_TRUE(digest_found);
   TEST_ASSERT_EQUAL_MEMORY(transaction_hash(txs[3]), hash, FLEX_TRIT_SIZE_243);
-  TEST_ASSERT(recent_seen_bytes_cache_size(&cache) == 3);
+  TEST_ASSERT(recent_seen_bytes_cache_size(&cache) == 4);
 
-  digest = 0;
-  digest_found = false;
-  TEST_ASSERT(recent_seen_bytes_cache_hash(tx_bytes[0], &digest) == RC_OK);
-  TEST_ASSERT(digest != 0);
-  TEST_ASSERT(recent_seen_bytes_cache_get(&cache, digest, hash, &digest_found) == RC_OK);
+  TEST_ASSERT(recent_seen_bytes_cache_destroy(&cache) == RC_OK);
+  transactions_free(txs, 4);
+}
+
+void test_recent_seen_bytes_cache_clock_eviction() {
+  recent_seen_bytes_cache_t cache;
+  recent_seen_bytes_cache_stats_t stats;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  bool digest_found = false;
+
+  memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+
+  TEST_ASSERT(recent_seen_bytes_cache_init(&cache, RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH, 1) == RC_OK);
+
+  // With a single shard, digests 0 to PROBE_LENGTH - 1 fill the probe window of digest 0
+  for (uint64_t digest = 0; digest < RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH; digest++) {
+    TEST_ASSERT(recent_seen_bytes_cache_put(&cache, digest, hash) == RC_OK);
+  }
+  TEST_ASSERT_EQUAL_INT(recent_seen_bytes_cache_size(&cache), RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH);
+
+  // Referencing all entries but the last one gives them a second chance
+  for (uint64_t digest = 0; digest < RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH - 1; digest++) {
+    TEST_ASSERT(recent_seen_bytes_cache_get(&cache, digest, hash, &digest_found) == RC_OK);
+    TEST_ASSERT_TRUE(digest_found);
+  }
+
+  TEST_ASSERT(recent_seen_bytes_cache_put(&cache, RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH, hash) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(recent_seen_bytes_cache_size(&cache), RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH);
+
+  TEST_ASSERT(recent_seen_bytes_cache_get(&cache, RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH, hash, &digest_found) == RC_OK);
+  TEST_ASSERT_TRUE(digest_found);
+  TEST_ASSERT(recent_seen_bytes_cache_get(&cache, RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH - 1, hash, &digest_found) ==
+              RC_OK);
   TEST_ASSERT_FALSE(digest_found);
-  TEST_ASSERT(recent_seen_bytes_cache_size(&cache) == 3);
+  for (uint64_t digest = 0; digest < RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH - 1; digest++) {
+    TEST_ASSERT(recent_seen_bytes_cache_get(&cache, digest, hash, &digest_found) == RC_OK);
+    TEST_ASSERT_TRUE(digest_found);
+  }
+
+  TEST_ASSERT(recent_seen_bytes_cache_stats(&cache, &stats) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(stats.hit, 2 * (RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH - 1) + 1);
+  TEST_ASSERT_EQUAL_INT(stats.miss, 1);
+  TEST_ASSERT_EQUAL_INT(stats.evictions, 1);
+  TEST_ASSERT_EQUAL_INT(stats.size, RECENT_SEEN_BYTES_CACHE_PROBE_LENGTH);
+
+  TEST_ASSERT(recent_seen_bytes_cache_destroy(&cache) == RC_OK);
+}
+
+void test_recent_seen_bytes_cache_shards() {
+  recent_seen_bytes_cache_t cache;
+  recent_seen_bytes_cache_stats_t stats;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  bool digest_found = false;
+
+  memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+
+  // Shards and their slots are rounded up to powers of two
+  TEST_ASSERT(recent_seen_bytes_cache_init(&cache, 100, 3) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(cache.shards_num, 4);
+  TEST_ASSERT_EQUAL_INT(cache.capacity, 4 * 32);
+
+  // High bits of the digest select the shard
+  for (uint64_t shard = 0; shard < 4; shard++) {
+    TEST_ASSERT(recent_seen_bytes_cache_put(&cache, shard << 32, hash) == RC_OK);
+  }
+  TEST_ASSERT(recent_seen_bytes_cache_get(&cache, 2ULL << 32, hash, &digest_found) == RC_OK);
+  TEST_ASSERT_TRUE(digest_found);
+  TEST_ASSERT(recent_seen_bytes_cache_get(&cache, (2ULL << 32) + 1, hash, &digest_found) == RC_OK);
+  TEST_ASSERT_FALSE(digest_found);
+
+  for (size_t shard = 0; shard < 4; shard++) {
+    TEST_ASSERT(recent_seen_bytes_cache_shard_stats(&cache, shard, &stats) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(stats.size, 1);
+    TEST_ASSERT_EQUAL_INT(stats.hit, shard == 2 ? 1 : 0);
+    TEST_ASSERT_EQUAL_INT(stats.miss, shard == 2 ? 1 : 0);
+  }
+  TEST_ASSERT(recent_seen_bytes_cache_shard_stats(&cache, 4, &stats) == RC_INVALID_PARAM);
 
   TEST_ASSERT(recent_seen_bytes_cache_destroy(&cache) == RC_OK);
-  transactions_free(txs, 4);
 }
 
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(test_recent_seen_bytes_cache);
+  RUN_TEST(test_recent_seen_bytes_cache_clock_eviction);
+  RUN_TEST(test_recent_seen_bytes_cache_shards);
 
   return UNITY_END();
 }
@@ -8,6 +8,23 @@
 #include <unity/unity.h>
 
 #include "ciri/node/tips_cache.h"
+#include "utils/containers/hash/hash243_set.h"
+
+static retcode_t add_to_set(flex_trit_t const *const tip, void *const set) {
+  return hash243_set_add((hash243_set_t *)set, tip);
+}
+
+static retcode_t approved_in_set(flex_trit_t const *const tip, void *const set, bool *const approved) {
+  *approved = hash243_set_contains(*(hash243_set_t *)set, tip);
+  return RC_OK;
+}
+
+static retcode_t approved_failure(flex_trit_t const *const tip, void *const data, bool *const approved) {
+  (void)tip;
+  (void)data;
+  (void)approved;
+  return RC_NULL_PARAM;
+}
 
 void test_tips_cache() {
   tips_cache_t cache;
@@ -74,17 +91,16 @@ void test_tips_cache() {
   TEST_ASSERT_EQUAL_INT(tips_cache_non_solid_size(&cache), 5);
 
   {
-    hash243_set_entry_t *iter = cache.tips;
+    hash243_set_t tips = NULL;
 
-    TEST_ASSERT_EQUAL_MEMORY(iter->hash, hashes[4], FLEX_TRIT_SIZE_243);
-    iter = iter->hh.next;
-    TEST_ASSERT_EQUAL_MEMORY(iter->hash, hashes[7], FLEX_TRIT_SIZE_243);
-    iter = iter->hh.next;
-    TEST_ASSERT_EQUAL_MEMORY(iter->hash, hashes[1], FLEX_TRIT_SIZE_243);
-    iter = iter->hh.next;
-    TEST_ASSERT_EQUAL_MEMORY(iter->hash, hashes[2], FLEX_TRIT_SIZE_243);
-    iter = iter->hh.next;
-    TEST_ASSERT_EQUAL_MEMORY(iter->hash, hashes[8], FLEX_TRIT_SIZE_243);
+    TEST_ASSERT(tips_cache_for_each(&cache, add_to_set, &tips) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(hash243_set_size(tips), 5);
+    TEST_ASSERT_TRUE(hash243_set_contains(tips, hashes[4]));
+    TEST_ASSERT_TRUE(hash243_set_contains(tips, hashes[7]));
+    TEST_ASSERT_TRUE(hash243_set_contains(tips, hashes[1]));
+    TEST_ASSERT_TRUE(hash243_set_contains(tips, hashes[2]));
+    TEST_ASSERT_TRUE(hash243_set_contains(tips, hashes[8]));
+    hash243_set_free(&tips);
 
     TEST_ASSERT_EQUAL_INT(tips_cache_non_solid_size(&cache), 5);
     TEST_ASSERT_EQUAL_INT(tips_cache_solid_size(&cache), 0);
@@ -116,14 +132,10 @@ void test_tips_cache() {
     hash243_stack_entry_t *iter = NULL;
 
     TEST_ASSERT(tips_cache_get_tips(&cache, &tips) == RC_OK);
-    iter = tips;
+    TEST_ASSERT_EQUAL_INT(hash243_stack_count(tips), 5);
 
-    TEST_ASSERT_EQUAL_MEMORY(iter->hash, hashes[4], FLEX_TRIT_SIZE_243);
-    iter = iter->next;
-    TEST_ASSERT_EQUAL_MEMORY(iter->hash, hashes[2], FLEX_TRIT_SIZE_243);
-    iter = iter->next;
-    TEST_ASSERT_EQUAL_MEMORY(iter->hash, hashes[7], FLEX_TRIT_SIZE_243);
-    iter = iter->next;
+    // Solid tips come first so they end up at the bottom of the stack
+    iter = tips;
     TEST_ASSERT_EQUAL_MEMORY(iter->hash, hashes[8], FLEX_TRIT_SIZE_243);
     iter = iter->next;
     TEST_ASSERT_EQUAL_MEMORY(iter->hash, hashes[1], FLEX_TRIT_SIZE_243);
@@ -131,6 +143,18 @@ void test_tips_cache() {
     hash243_stack_free(&tips);
   }
 
+  {
+    flex_trit_t tip[FLEX_TRIT_SIZE_243];
+
+    TEST_ASSERT(tips_cache_random_solid_tip(&cache, tip) == RC_OK);
+    TEST_ASSERT_TRUE(memcmp(tip, hashes[2], FLEX_TRIT_SIZE_243) == 0 ||
+                     memcmp(tip, hashes[4], FLEX_TRIT_SIZE_243) == 0 ||
+                     memcmp(tip, hashes[7], FLEX_TRIT_SIZE_243) == 0);
+    TEST_ASSERT(tips_cache_random_tip(&cache, tip) == RC_OK);
+    TEST_ASSERT_TRUE(memcmp(tip, hashes[1], FLEX_TRIT_SIZE_243) == 0 ||
+                     memcmp(tip, hashes[8], FLEX_TRIT_SIZE_243) == 0);
+  }
+
   TEST_ASSERT(tips_cache_set_solid(&cache, hashes[1]) == RC_OK);
   TEST_ASSERT_EQUAL_INT(tips_cache_non_solid_size(&cache), 1);
   TEST_ASSERT_EQUAL_INT(tips_cache_solid_size(&cache), 4);
@@ -152,10 +176,98 @@ void test_tips_cache() {
   TEST_ASSERT(tips_cache_destroy(&cache) == RC_OK);
 }
 
+void test_tips_cache_fifo() {
+  tips_cache_t cache;
+  hash243_set_t tips = NULL;
+  flex_trit_t hashes[6][FLEX_TRIT_SIZE_243];
+  tryte_t trytes[81] =
+      "A99999999999999999999999999999999999999999999999999999999999999999999999"
+      "999999999";
+
+  for (size_t i = 0; i < 6; i++) {
+    flex_trits_from_trytes(hashes[i], HASH_LENGTH_TRIT, trytes, HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+    trytes[0]++;
+  }
+
+  TEST_ASSERT(tips_cache_init(&cache, 3) == RC_OK);
+
+  // Solid tips are evicted in the order they were promoted, regardless of their position in the cache
+  for (size_t i = 0; i < 4; i++) {
+    TEST_ASSERT(tips_cache_add(&cache, hashes[i]) == RC_OK);
+  }
+  TEST_ASSERT(tips_cache_set_solid(&cache, hashes[3]) == RC_OK);
+  TEST_ASSERT(tips_cache_set_solid(&cache, hashes[1]) == RC_OK);
+  TEST_ASSERT(tips_cache_set_solid(&cache, hashes[2]) == RC_OK);
+  TEST_ASSERT(tips_cache_add(&cache, hashes[4]) == RC_OK);
+  TEST_ASSERT(tips_cache_set_solid(&cache, hashes[4]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(tips_cache_solid_size(&cache), 3);
+  TEST_ASSERT_EQUAL_INT(tips_cache_non_solid_size(&cache), 0);
+
+  TEST_ASSERT(tips_cache_for_each(&cache, add_to_set, &tips) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(tips), 3);
+  TEST_ASSERT_FALSE(hash243_set_contains(tips, hashes[3]));
+  TEST_ASSERT_TRUE(hash243_set_contains(tips, hashes[1]));
+  TEST_ASSERT_TRUE(hash243_set_contains(tips, hashes[2]));
+  TEST_ASSERT_TRUE(hash243_set_contains(tips, hashes[4]));
+  hash243_set_free(&tips);
+
+  // Removing a solid tip keeps both partitions consistent
+  TEST_ASSERT(tips_cache_add(&cache, hashes[5]) == RC_OK);
+  TEST_ASSERT(tips_cache_remove(&cache, hashes[1]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(tips_cache_solid_size(&cache), 2);
+  TEST_ASSERT_EQUAL_INT(tips_cache_non_solid_size(&cache), 1);
+  TEST_ASSERT(tips_cache_set_solid(&cache, hashes[5]) == RC_OK);
+  TEST_ASSERT(tips_cache_remove(&cache, hashes[2]) == RC_OK);
+  TEST_ASSERT(tips_cache_remove(&cache, hashes[4]) == RC_OK);
+  TEST_ASSERT(tips_cache_remove(&cache, hashes[5]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(tips_cache_size(&cache), 0);
+
+  TEST_ASSERT(tips_cache_destroy(&cache) == RC_OK);
+}
+
+void test_tips_cache_update() {
+  tips_cache_t cache;
+  hash243_set_t approved = NULL;
+  flex_trit_t hashes[5][FLEX_TRIT_SIZE_243];
+  tryte_t trytes[81] =
+      "A99999999999999999999999999999999999999999999999999999999999999999999999"
+      "999999999";
+
+  for (size_t i = 0; i < 5; i++) {
+    flex_trits_from_trytes(hashes[i], HASH_LENGTH_TRIT, trytes, HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+    trytes[0]++;
+  }
+
+  TEST_ASSERT(tips_cache_init(&cache, 5) == RC_OK);
+  TEST_ASSERT(tips_cache_add(&cache, hashes[0]) == RC_OK);
+  TEST_ASSERT(tips_cache_add(&cache, hashes[1]) == RC_OK);
+
+  // A transaction that is not approved replaces its trunk and branch
+  TEST_ASSERT(tips_cache_update(&cache, hashes[2], hashes[0], hashes[1], approved_in_set, &approved) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(tips_cache_size(&cache), 1);
+  TEST_ASSERT(tips_cache_random_tip(&cache, hashes[4]) == RC_OK);
+  TEST_ASSERT_EQUAL_MEMORY(hashes[2], hashes[4], FLEX_TRIT_SIZE_243);
+
+  // A transaction already approved only removes its trunk and branch
+  TEST_ASSERT(hash243_set_add(&approved, hashes[3]) == RC_OK);
+  TEST_ASSERT(tips_cache_update(&cache, hashes[3], hashes[2], hashes[2], approved_in_set, &approved) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(tips_cache_size(&cache), 0);
+
+  // Nothing is updated when the approval check fails
+  TEST_ASSERT(tips_cache_add(&cache, hashes[0]) == RC_OK);
+  TEST_ASSERT(tips_cache_update(&cache, hashes[1], hashes[0], hashes[0], approved_failure, NULL) == RC_NULL_PARAM);
+  TEST_ASSERT_EQUAL_INT(tips_cache_size(&cache), 1);
+
+  hash243_set_free(&approved);
+  TEST_ASSERT(tips_cache_destroy(&cache) == RC_OK);
+}
+
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(test_tips_cache);
+  RUN_TEST(test_tips_cache_fifo);
+  RUN_TEST(test_tips_cache_update);
 
   return UNITY_END();
 }
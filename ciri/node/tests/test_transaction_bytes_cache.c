@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/node/transaction_bytes_cache.h"
+
+#define HASHES_NUM 10
+
+static flex_trit_t hashes[HASHES_NUM][FLEX_TRIT_SIZE_243];
+static byte_t bytes[HASHES_NUM][GOSSIP_TX_BYTES_LENGTH];
+
+static void assert_cached(transaction_bytes_cache_t *const cache, size_t const i) {
+  byte_t cached[GOSSIP_TX_BYTES_LENGTH];
+  uint64_t digest = 0;
+  bool found = false;
+
+  TEST_ASSERT(transaction_bytes_cache_get(cache, hashes[i], cached, &digest, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL_MEMORY(bytes[i], cached, GOSSIP_TX_BYTES_LENGTH);
+  TEST_ASSERT_EQUAL_UINT64(i, digest);
+}
+
+static void assert_not_cached(transaction_bytes_cache_t *const cache, size_t const i) {
+  byte_t cached[GOSSIP_TX_BYTES_LENGTH];
+  uint64_t digest = 0;
+  bool found = true;
+
+  TEST_ASSERT(transaction_bytes_cache_get(cache, hashes[i], cached, &digest, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+}
+
+void test_transaction_bytes_cache_lru(void) {
+  transaction_bytes_cache_t cache;
+
+  TEST_ASSERT(transaction_bytes_cache_init(&cache, 5) == RC_OK);
+
+  for (size_t i = 0; i < 5; i++) {
+    assert_not_cached(&cache, i);
+    TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[i], bytes[i], i) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(transaction_bytes_cache_size(&cache), i + 1);
+  }
+  for (size_t i = 0; i < 5; i++) {
+    assert_cached(&cache, i);
+  }
+
+  // 0 is now the least recently used one, using it makes 1 the next one to be evicted
+  assert_cached(&cache, 0);
+  TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[5], bytes[5], 5) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(transaction_bytes_cache_size(&cache), 5);
+  assert_not_cached(&cache, 1);
+  assert_cached(&cache, 0);
+  assert_cached(&cache, 5);
+
+  // Putting a cached transaction again only refreshes it
+  TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[2], bytes[2], 2) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(transaction_bytes_cache_size(&cache), 5);
+  TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[6], bytes[6], 6) == RC_OK);
+  TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[7], bytes[7], 7) == RC_OK);
+  assert_not_cached(&cache, 3);
+  assert_not_cached(&cache, 4);
+  assert_cached(&cache, 0);
+  assert_cached(&cache, 2);
+  assert_cached(&cache, 5);
+  assert_cached(&cache, 6);
+  assert_cached(&cache, 7);
+
+  // Every lookup counted, including the ones of assert_not_cached
+  TEST_ASSERT_EQUAL_UINT64(cache.hits + cache.misses, 21);
+  TEST_ASSERT_EQUAL_UINT64(cache.misses, 8);
+
+  TEST_ASSERT(transaction_bytes_cache_destroy(&cache) == RC_OK);
+}
+
+void test_transaction_bytes_cache_remove(void) {
+  transaction_bytes_cache_t cache;
+
+  TEST_ASSERT(transaction_bytes_cache_init(&cache, 5) == RC_OK);
+
+  for (size_t i = 0; i < 5; i++) {
+    TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[i], bytes[i], i) == RC_OK);
+  }
+
+  // Removing an entry moves the last one in its place, which stays cached and keeps its recency
+  TEST_ASSERT(transaction_bytes_cache_remove(&cache, hashes[1]) == RC_OK);
+  TEST_ASSERT(transaction_bytes_cache_remove(&cache, hashes[1]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(transaction_bytes_cache_size(&cache), 4);
+  assert_not_cached(&cache, 1);
+  assert_cached(&cache, 4);
+
+  // Removing the least and most recently used ones
+  TEST_ASSERT(transaction_bytes_cache_remove(&cache, hashes[0]) == RC_OK);
+  TEST_ASSERT(transaction_bytes_cache_remove(&cache, hashes[4]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(transaction_bytes_cache_size(&cache), 2);
+  assert_not_cached(&cache, 0);
+  assert_not_cached(&cache, 4);
+
+  // Freed positions are reused before anything is evicted, 2 then being the least recently used one
+  for (size_t i = 5; i < 8; i++) {
+    TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[i], bytes[i], i) == RC_OK);
+  }
+  TEST_ASSERT_EQUAL_INT(transaction_bytes_cache_size(&cache), 5);
+  TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[8], bytes[8], 8) == RC_OK);
+  assert_not_cached(&cache, 2);
+  for (size_t i = 3; i < 9; i++) {
+    if (i != 4) {
+      assert_cached(&cache, i);
+    }
+  }
+
+  TEST_ASSERT(transaction_bytes_cache_destroy(&cache) == RC_OK);
+}
+
+void test_transaction_bytes_cache_disabled(void) {
+  transaction_bytes_cache_t cache;
+
+  TEST_ASSERT(transaction_bytes_cache_init(&cache, 0) == RC_OK);
+  TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[0], bytes[0], 0) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(transaction_bytes_cache_size(&cache), 0);
+  assert_not_cached(&cache, 0);
+  TEST_ASSERT(transaction_bytes_cache_remove(&cache, hashes[0]) == RC_OK);
+  TEST_ASSERT(transaction_bytes_cache_destroy(&cache) == RC_OK);
+}
+
+int main(void) {
+  tryte_t trytes[HASH_LENGTH_TRYTE] =
+      "A99999999999999999999999999999999999999999999999999999999999999999999999"
+      "999999999";
+
+  UNITY_BEGIN();
+
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    flex_trits_from_trytes(hashes[i], HASH_LENGTH_TRIT, trytes, HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+    memset(bytes[i], i, GOSSIP_TX_BYTES_LENGTH);
+    trytes[0]++;
+  }
+
+  RUN_TEST(test_transaction_bytes_cache_lru);
+  RUN_TEST(test_transaction_bytes_cache_remove);
+  RUN_TEST(test_transaction_bytes_cache_disabled);
+
+  return UNITY_END();
+}
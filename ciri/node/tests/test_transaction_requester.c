@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/consensus/test_utils/bundle.h"
+#include "ciri/consensus/test_utils/tangle.h"
+#include "ciri/node/node.h"
+#include "utils/time.h"
+
+#define CAPACITY 4
+#define RETRY_INTERVAL 1000
+
+static char *tangle_test_db_path = "ciri/node/tests/test.db";
+static storage_connection_config_t config;
+static tangle_t tangle;
+static node_t node;
+static transaction_requester_t *requester = &node.transaction_requester;
+static neighbor_t neighbors[2];
+static flex_trit_t hashes[2 * CAPACITY][FLEX_TRIT_SIZE_243];
+
+static requester_entry_t *entry_find(size_t const hash) {
+  requester_entry_t *entry = NULL;
+
+  HASH_FIND(hh, requester->entries, hashes[hash], FLEX_TRIT_SIZE_243, entry);
+  return entry;
+}
+
+static void assert_next_request(neighbor_t const *const neighbor, size_t const expected) {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  TEST_ASSERT(get_transaction_to_request(requester, &tangle, neighbor, hash) == RC_OK);
+  TEST_ASSERT_EQUAL_MEMORY(hashes[expected], hash, FLEX_TRIT_SIZE_243);
+}
+
+static void assert_no_request(neighbor_t const *const neighbor) {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  TEST_ASSERT(get_transaction_to_request(requester, &tangle, neighbor, hash) == RC_OK);
+  TEST_ASSERT_TRUE(flex_trits_are_null(hash, FLEX_TRIT_SIZE_243));
+}
+
+void setUp(void) {
+  tryte_t trytes[NUM_TRYTES_HASH];
+
+  memset(trytes, '9', NUM_TRYTES_HASH);
+  for (size_t i = 0; i < 2 * CAPACITY; i++) {
+    trytes[0] = 'A' + i;
+    flex_trits_from_trytes(hashes[i], NUM_TRITS_HASH, trytes, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  }
+
+  TEST_ASSERT(iota_node_conf_init(&node.conf) == RC_OK);
+  node.conf.requester_queue_size = CAPACITY;
+  node.conf.requester_retry_interval = RETRY_INTERVAL;
+  TEST_ASSERT(requester_init(requester, &node) == RC_OK);
+}
+
+void tearDown(void) { TEST_ASSERT(requester_destroy(requester) == RC_OK); }
+
+void test_requester_priority(void) {
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[0], false) == RC_OK);
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[1], false) == RC_OK);
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[2], true) == RC_OK);
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[3], false) == RC_OK);
+
+  // Requesting a transaction again only promotes it
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[3], true) == RC_OK);
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[2], false) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(4, requester_size(requester));
+
+  // Milestone transactions come first, then transactions in the order they were requested
+  assert_next_request(&neighbors[0], 2);
+  assert_next_request(&neighbors[0], 3);
+  assert_next_request(&neighbors[0], 0);
+  assert_next_request(&neighbors[0], 1);
+  assert_no_request(&neighbors[0]);
+
+  // Requested transactions stay scheduled until received
+  TEST_ASSERT_EQUAL_INT(4, requester_size(requester));
+  TEST_ASSERT(requester_clear_request(requester, hashes[2]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(3, requester_size(requester));
+  TEST_ASSERT_NULL(entry_find(2));
+}
+
+void test_requester_backoff(void) {
+  requester_entry_t *entry = NULL;
+  uint64_t before = 0;
+  uint64_t after = 0;
+  bool was_requested = true;
+
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[0], false) == RC_OK);
+  TEST_ASSERT(requester_was_requested(requester, hashes[0], &was_requested) == RC_OK);
+  TEST_ASSERT_FALSE(was_requested);
+
+  // Every attempt doubles the interval before the next one, up to a maximum
+  for (uint32_t attempt = 0; attempt <= REQUESTER_MAX_BACKOFF_SHIFT + 1; attempt++) {
+    uint32_t const shift = attempt < REQUESTER_MAX_BACKOFF_SHIFT ? attempt : REQUESTER_MAX_BACKOFF_SHIFT;
+
+    before = current_timestamp_ms();
+    assert_next_request(&neighbors[0], 0);
+    after = current_timestamp_ms();
+    assert_no_request(&neighbors[0]);
+
+    entry = entry_find(0);
+    TEST_ASSERT_EQUAL_INT(attempt + 1, entry->attempts);
+    TEST_ASSERT_TRUE(entry->due >= before + ((uint64_t)RETRY_INTERVAL << shift));
+    TEST_ASSERT_TRUE(entry->due <= after + ((uint64_t)RETRY_INTERVAL << shift));
+    // Due again without waiting, the only entry of its heap can be changed in place
+    entry->due = 0;
+  }
+
+  TEST_ASSERT(requester_was_requested(requester, hashes[0], &was_requested) == RC_OK);
+  TEST_ASSERT_TRUE(was_requested);
+}
+
+void test_requester_spread(void) {
+  // Requests are always due again
+  node.conf.requester_retry_interval = 0;
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[0], false) == RC_OK);
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[1], false) == RC_OK);
+
+  assert_next_request(&neighbors[0], 0);
+  assert_next_request(&neighbors[1], 1);
+
+  // A transaction is not requested again from the same neighbor while another one is due
+  assert_next_request(&neighbors[0], 1);
+  assert_next_request(&neighbors[1], 0);
+
+  // Unless it is the only one
+  TEST_ASSERT(requester_clear_request(requester, hashes[0]) == RC_OK);
+  assert_next_request(&neighbors[0], 1);
+  assert_next_request(&neighbors[0], 1);
+}
+
+void test_requester_eviction(void) {
+  for (size_t i = 0; i < CAPACITY; i++) {
+    TEST_ASSERT(request_transaction(requester, &tangle, hashes[i], false) == RC_OK);
+  }
+  TEST_ASSERT_TRUE(requester_is_full(requester));
+
+  // A full requester drops new normal requests
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[CAPACITY], false) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(CAPACITY, requester_size(requester));
+  TEST_ASSERT_NULL(entry_find(CAPACITY));
+
+  // Milestone requests make room by evicting normal ones
+  for (size_t i = CAPACITY; i < 2 * CAPACITY; i++) {
+    TEST_ASSERT(request_transaction(requester, &tangle, hashes[i], true) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(CAPACITY, requester_size(requester));
+    TEST_ASSERT_NOT_NULL(entry_find(i));
+  }
+  TEST_ASSERT_EQUAL_INT(0, requester->heaps_size[REQUESTER_PRIORITY_NORMAL]);
+  TEST_ASSERT_EQUAL_INT(CAPACITY, requester->heaps_size[REQUESTER_PRIORITY_MILESTONE]);
+
+  // But never evict other milestone requests
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[0], true) == RC_OK);
+  TEST_ASSERT_NULL(entry_find(0));
+
+  for (size_t i = CAPACITY; i < 2 * CAPACITY; i++) {
+    assert_next_request(&neighbors[0], i);
+  }
+}
+
+void test_requester_received(void) {
+  tryte_t const *const txs_trytes[1] = {TX_1_OF_4_VALUE_BUNDLE_TRYTES};
+  iota_transaction_t *txs[1];
+
+  transactions_deserialize(txs_trytes, txs, 1, true);
+  TEST_ASSERT(build_tangle(&tangle, txs, 1) == RC_OK);
+
+  // A received transaction is not requested again once stored
+  TEST_ASSERT(request_transaction(requester, &tangle, transaction_hash(txs[0]), false) == RC_OK);
+  TEST_ASSERT(requester_clear_request(requester, transaction_hash(txs[0])) == RC_OK);
+  TEST_ASSERT(request_transaction(requester, &tangle, transaction_hash(txs[0]), false) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, requester_size(requester));
+
+  // But it is if it was not stored, e.g. because it was invalid
+  TEST_ASSERT(requester_clear_request(requester, hashes[0]) == RC_OK);
+  TEST_ASSERT(request_transaction(requester, &tangle, hashes[0], false) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, requester_size(requester));
+
+  transactions_free(txs, 1);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  TEST_ASSERT(storage_init() == RC_OK);
+
+  config.db_path = tangle_test_db_path;
+  TEST_ASSERT(tangle_setup(&tangle, &config, tangle_test_db_path) == RC_OK);
+
+  RUN_TEST(test_requester_priority);
+  RUN_TEST(test_requester_backoff);
+  RUN_TEST(test_requester_spread);
+  RUN_TEST(test_requester_eviction);
+  RUN_TEST(test_requester_received);
+
+  TEST_ASSERT(tangle_cleanup(&tangle, tangle_test_db_path) == RC_OK);
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
@@ -5,39 +5,191 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "xxhash.h"
+
 #include "ciri/node/tips_cache.h"
+#include "utils/handles/rand.h"
+
+#define TIPS_CACHE_NONE UINT32_MAX
 
 /*
  * Private functions
  */
 
-static retcode_t tips_cache_fifo_add(hash243_set_t* const set, size_t const capacity, flex_trit_t const* const tip) {
-  retcode_t ret = RC_OK;
+static inline tips_cache_partition_t tips_cache_partition(tips_cache_t const* const cache, size_t const position) {
+  return position < cache->solid_size ? TIPS_CACHE_SOLID : TIPS_CACHE_NON_SOLID;
+}
 
-  if (set == NULL || tip == NULL) {
-    return RC_NULL_PARAM;
+static inline size_t tips_cache_index_slot(tips_cache_t const* const cache, flex_trit_t const* const tip) {
+  return XXH64(tip, FLEX_TRIT_SIZE_243, 0) & cache->index_mask;
+}
+
+/**
+ * Finds the index slot of a tip
+ *
+ * @return the index slot, or the free slot it would be inserted at if *found is false
+ */
+static size_t tips_cache_index_find(tips_cache_t const* const cache, flex_trit_t const* const tip, bool* const found) {
+  size_t slot = tips_cache_index_slot(cache, tip);
+
+  // The index is at most half full so there always is a free slot ending the probe sequence
+  while (cache->index[slot] != 0) {
+    if (memcmp(cache->entries[cache->index[slot] - 1].hash, tip, FLEX_TRIT_SIZE_243) == 0) {
+      *found = true;
+      return slot;
+    }
+    slot = (slot + 1) & cache->index_mask;
   }
+  *found = false;
 
-  if (hash243_set_size(*set) >= capacity) {
-    if ((ret = hash243_set_remove_entry(set, *set)) != RC_OK) {
-      return ret;
+  return slot;
+}
+
+/**
+ * Frees an index slot, shifting back following entries of the probe sequence so that lookups never miss them
+ */
+static void tips_cache_index_remove(tips_cache_t* const cache, size_t slot) {
+  size_t next = slot;
+  size_t home = 0;
+
+  while (true) {
+    next = (next + 1) & cache->index_mask;
+    if (cache->index[next] == 0) {
+      break;
+    }
+    home = tips_cache_index_slot(cache, cache->entries[cache->index[next] - 1].hash);
+    // The entry at next can fill the hole only if its home slot is not cyclically in ]slot, next]
+    if (((next - home) & cache->index_mask) >= ((next - slot) & cache->index_mask)) {
+      cache->index[slot] = cache->index[next];
+      slot = next;
     }
   }
+  cache->index[slot] = 0;
+}
 
-  return hash243_set_add(set, tip);
+static void tips_cache_list_append(tips_cache_t* const cache, tips_cache_partition_t const partition,
+                                   uint32_t const position) {
+  tips_cache_entry_t* const entry = &cache->entries[position];
+
+  entry->prev = cache->newest[partition];
+  entry->next = TIPS_CACHE_NONE;
+  if (cache->newest[partition] != TIPS_CACHE_NONE) {
+    cache->entries[cache->newest[partition]].next = position;
+  } else {
+    cache->oldest[partition] = position;
+  }
+  cache->newest[partition] = position;
 }
 
-static retcode_t tips_cache_random_tip_from_set(hash243_set_t* const set, flex_trit_t* const tip) {
-  if (set == NULL || tip == NULL) {
-    return RC_NULL_PARAM;
+static void tips_cache_list_unlink(tips_cache_t* const cache, tips_cache_partition_t const partition,
+                                   uint32_t const position) {
+  tips_cache_entry_t const* const entry = &cache->entries[position];
+
+  if (entry->prev != TIPS_CACHE_NONE) {
+    cache->entries[entry->prev].next = entry->next;
+  } else {
+    cache->oldest[partition] = entry->next;
+  }
+  if (entry->next != TIPS_CACHE_NONE) {
+    cache->entries[entry->next].prev = entry->prev;
+  } else {
+    cache->newest[partition] = entry->prev;
   }
+}
+
+/**
+ * Moves an entry to a free position, keeping its index slot and its neighbours in the partition list up to date
+ */
+static void tips_cache_move(tips_cache_t* const cache, tips_cache_partition_t const partition, uint32_t const from,
+                            uint32_t const to) {
+  tips_cache_entry_t* const entry = &cache->entries[to];
+  bool found = false;
+  size_t const slot = tips_cache_index_find(cache, cache->entries[from].hash, &found);
+
+  memcpy(entry, &cache->entries[from], sizeof(tips_cache_entry_t));
+  cache->index[slot] = to + 1;
+  if (entry->prev != TIPS_CACHE_NONE) {
+    cache->entries[entry->prev].next = to;
+  } else {
+    cache->oldest[partition] = to;
+  }
+  if (entry->next != TIPS_CACHE_NONE) {
+    cache->entries[entry->next].prev = to;
+  } else {
+    cache->newest[partition] = to;
+  }
+}
 
-  if (hash243_set_size(*set) == 0) {
+static void tips_cache_remove_at(tips_cache_t* const cache, uint32_t const position) {
+  tips_cache_partition_t const partition = tips_cache_partition(cache, position);
+  uint32_t const last = cache->size - 1;
+  uint32_t last_solid = 0;
+  bool found = false;
+
+  tips_cache_list_unlink(cache, partition, position);
+  tips_cache_index_remove(cache, tips_cache_index_find(cache, cache->entries[position].hash, &found));
+
+  if (partition == TIPS_CACHE_SOLID) {
+    // The last solid tip fills the hole and the last non solid tip fills the one it left
+    last_solid = cache->solid_size - 1;
+    if (position != last_solid) {
+      tips_cache_move(cache, TIPS_CACHE_SOLID, last_solid, position);
+    }
+    if (last != last_solid) {
+      tips_cache_move(cache, TIPS_CACHE_NON_SOLID, last, last_solid);
+    }
+    cache->solid_size--;
+  } else if (position != last) {
+    tips_cache_move(cache, TIPS_CACHE_NON_SOLID, last, position);
+  }
+  cache->size--;
+}
+
+/**
+ * Adds a tip, evicting the oldest non solid tip if the partition is full
+ */
+static void tips_cache_insert(tips_cache_t* const cache, flex_trit_t const* const tip) {
+  uint32_t position = 0;
+  bool found = false;
+
+  tips_cache_index_find(cache, tip, &found);
+  if (!found) {
+    if (cache->size - cache->solid_size >= cache->capacity) {
+      tips_cache_remove_at(cache, cache->oldest[TIPS_CACHE_NON_SOLID]);
+    }
+    position = cache->size++;
+    memcpy(cache->entries[position].hash, tip, FLEX_TRIT_SIZE_243);
+    cache->index[tips_cache_index_find(cache, tip, &found)] = position + 1;
+    tips_cache_list_append(cache, TIPS_CACHE_NON_SOLID, position);
+  }
+}
+
+static void tips_cache_erase(tips_cache_t* const cache, flex_trit_t const* const tip) {
+  bool found = false;
+  size_t slot = tips_cache_index_find(cache, tip, &found);
+
+  if (found) {
+    tips_cache_remove_at(cache, cache->index[slot] - 1);
+  }
+}
+
+static retcode_t tips_cache_push_tip(flex_trit_t const* const tip, void* const tips) {
+  return hash243_stack_push((hash243_stack_t*)tips, tip);
+}
+
+static retcode_t tips_cache_random_tip_from_range(tips_cache_t* const cache, size_t const start, size_t const end,
+                                                  flex_trit_t* const tip) {
+  if (end == start) {
     memset(tip, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
     return RC_OK;
   }
 
-  return hash243_set_random_hash(set, tip);
+  memcpy(tip, cache->entries[rand_handle_rand_interval(start, end - start)].hash, FLEX_TRIT_SIZE_243);
+
+  return RC_OK;
 }
 
 /*
@@ -45,15 +197,33 @@ static retcode_t tips_cache_random_tip_from_set(hash243_set_t* const set, flex_t
  */
 
 retcode_t tips_cache_init(tips_cache_t* const cache, size_t const capacity) {
+  size_t index_size = 1;
+
   if (cache == NULL) {
     return RC_NULL_PARAM;
   }
 
-  cache->tips = NULL;
-  rw_lock_handle_init(&cache->tips_lock);
-  cache->solid_tips = NULL;
-  rw_lock_handle_init(&cache->solid_tips_lock);
+  // Each partition holds up to capacity tips and the index is kept at most half full
+  while (index_size < 4 * capacity) {
+    index_size <<= 1;
+  }
+
+  if ((cache->entries = (tips_cache_entry_t*)calloc(2 * capacity + 1, sizeof(tips_cache_entry_t))) == NULL) {
+    return RC_OOM;
+  }
+  if ((cache->index = (uint32_t*)calloc(index_size, sizeof(uint32_t))) == NULL) {
+    free(cache->entries);
+    return RC_OOM;
+  }
+  cache->index_mask = index_size - 1;
+  cache->size = 0;
+  cache->solid_size = 0;
+  for (size_t i = 0; i < TIPS_CACHE_PARTITIONS; i++) {
+    cache->oldest[i] = TIPS_CACHE_NONE;
+    cache->newest[i] = TIPS_CACHE_NONE;
+  }
   cache->capacity = capacity;
+  rw_lock_handle_init(&cache->lock);
 
   return RC_OK;
 }
@@ -63,107 +233,138 @@ retcode_t tips_cache_destroy(tips_cache_t* const cache) {
     return RC_NULL_PARAM;
   }
 
-  hash243_set_free(&cache->tips);
-  rw_lock_handle_destroy(&cache->tips_lock);
-  hash243_set_free(&cache->solid_tips);
-  rw_lock_handle_destroy(&cache->solid_tips_lock);
+  free(cache->entries);
+  cache->entries = NULL;
+  free(cache->index);
+  cache->index = NULL;
+  rw_lock_handle_destroy(&cache->lock);
 
   return RC_OK;
 }
 
 retcode_t tips_cache_get_tips(tips_cache_t* const cache, hash243_stack_t* const tips) {
-  retcode_t ret = RC_OK;
-  hash243_set_entry_t* iter = NULL;
-  hash243_set_entry_t* tmp = NULL;
-
   if (cache == NULL || tips == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&cache->tips_lock);
-  HASH_SET_ITER(cache->tips, iter, tmp) {
-    if ((ret = hash243_stack_push(tips, iter->hash)) != RC_OK) {
-      break;
-    }
-  }
-  rw_lock_handle_unlock(&cache->tips_lock);
+  return tips_cache_for_each(cache, tips_cache_push_tip, tips);
+}
 
-  if (ret != RC_OK) {
-    return ret;
+retcode_t tips_cache_for_each(tips_cache_t* const cache, tips_cache_functor functor, void* const data) {
+  retcode_t ret = RC_OK;
+
+  if (cache == NULL || functor == NULL) {
+    return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&cache->solid_tips_lock);
-  HASH_SET_ITER(cache->solid_tips, iter, tmp) {
-    if ((ret = hash243_stack_push(tips, iter->hash)) != RC_OK) {
+  rw_lock_handle_rdlock(&cache->lock);
+  for (size_t i = 0; i < cache->size; i++) {
+    if ((ret = functor(cache->entries[i].hash, data)) != RC_OK) {
       break;
     }
   }
-  rw_lock_handle_unlock(&cache->solid_tips_lock);
+  rw_lock_handle_unlock(&cache->lock);
 
   return ret;
 }
 
 retcode_t tips_cache_add(tips_cache_t* const cache, flex_trit_t const* const tip) {
-  retcode_t ret = RC_OK;
-
   if (cache == NULL || tip == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&cache->tips_lock);
-  ret = tips_cache_fifo_add(&cache->tips, cache->capacity, tip);
-  rw_lock_handle_unlock(&cache->tips_lock);
+  if (cache->capacity == 0) {
+    return RC_OK;
+  }
 
-  return ret;
+  rw_lock_handle_wrlock(&cache->lock);
+  tips_cache_insert(cache, tip);
+  rw_lock_handle_unlock(&cache->lock);
+
+  return RC_OK;
 }
 
 retcode_t tips_cache_remove(tips_cache_t* const cache, flex_trit_t const* const tip) {
+  if (cache == NULL || tip == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&cache->lock);
+  tips_cache_erase(cache, tip);
+  rw_lock_handle_unlock(&cache->lock);
+
+  return RC_OK;
+}
+
+retcode_t tips_cache_update(tips_cache_t* const cache, flex_trit_t const* const tip, flex_trit_t const* const trunk,
+                            flex_trit_t const* const branch, tips_cache_approved_functor approved, void* const data) {
   retcode_t ret = RC_OK;
+  bool is_approved = false;
 
-  if (cache == NULL || tip == NULL) {
+  if (cache == NULL || tip == NULL || trunk == NULL || branch == NULL || approved == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&cache->tips_lock);
-  ret = hash243_set_remove(&cache->tips, tip);
-  rw_lock_handle_unlock(&cache->tips_lock);
+  if (cache->capacity == 0) {
+    return RC_OK;
+  }
+
+  rw_lock_handle_wrlock(&cache->lock);
 
-  if (ret != RC_OK) {
-    return ret;
+  if ((ret = approved(tip, data, &is_approved)) == RC_OK) {
+    if (!is_approved) {
+      tips_cache_insert(cache, tip);
+    }
+    tips_cache_erase(cache, trunk);
+    tips_cache_erase(cache, branch);
   }
 
-  rw_lock_handle_wrlock(&cache->solid_tips_lock);
-  ret = hash243_set_remove(&cache->solid_tips, tip);
-  rw_lock_handle_unlock(&cache->solid_tips_lock);
+  rw_lock_handle_unlock(&cache->lock);
 
   return ret;
 }
 
 retcode_t tips_cache_set_solid(tips_cache_t* const cache, flex_trit_t const* const tip) {
-  retcode_t ret = RC_OK;
-  bool solidify = false;
+  tips_cache_entry_t promoted;
+  size_t slot = 0;
+  uint32_t position = 0;
+  uint32_t first_non_solid = 0;
+  bool found = false;
 
   if (cache == NULL || tip == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&cache->tips_lock);
-  if ((solidify = hash243_set_contains(cache->tips, tip))) {
-    ret = hash243_set_remove(&cache->tips, tip);
-  }
-  rw_lock_handle_unlock(&cache->tips_lock);
+  rw_lock_handle_wrlock(&cache->lock);
 
-  if (ret != RC_OK) {
-    return ret;
+  slot = tips_cache_index_find(cache, tip, &found);
+  if (!found || cache->index[slot] - 1 < cache->solid_size) {
+    goto done;
   }
 
-  if (solidify) {
-    rw_lock_handle_wrlock(&cache->solid_tips_lock);
-    ret = tips_cache_fifo_add(&cache->solid_tips, cache->capacity, tip);
-    rw_lock_handle_unlock(&cache->solid_tips_lock);
+  // Evicting the oldest solid tip moves entries around
+  if (cache->solid_size >= cache->capacity) {
+    tips_cache_remove_at(cache, cache->oldest[TIPS_CACHE_SOLID]);
+    slot = tips_cache_index_find(cache, tip, &found);
   }
+  position = cache->index[slot] - 1;
+
+  // Swaps the tip with the first non solid tip and extends the solid partition over it
+  tips_cache_list_unlink(cache, TIPS_CACHE_NON_SOLID, position);
+  first_non_solid = cache->solid_size;
+  if (position != first_non_solid) {
+    memcpy(&promoted, &cache->entries[position], sizeof(tips_cache_entry_t));
+    tips_cache_move(cache, TIPS_CACHE_NON_SOLID, first_non_solid, position);
+    memcpy(&cache->entries[first_non_solid], &promoted, sizeof(tips_cache_entry_t));
+    cache->index[slot] = first_non_solid + 1;
+  }
+  cache->solid_size++;
+  tips_cache_list_append(cache, TIPS_CACHE_SOLID, first_non_solid);
 
-  return ret;
+done:
+  rw_lock_handle_unlock(&cache->lock);
+
+  return RC_OK;
 }
 
 size_t tips_cache_non_solid_size(tips_cache_t* const cache) {
@@ -173,9 +374,9 @@ size_t tips_cache_non_solid_size(tips_cache_t* const cache) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&cache->tips_lock);
-  size = hash243_set_size(cache->tips);
-  rw_lock_handle_unlock(&cache->tips_lock);
+  rw_lock_handle_rdlock(&cache->lock);
+  size = cache->size - cache->solid_size;
+  rw_lock_handle_unlock(&cache->lock);
 
   return size;
 }
@@ -187,9 +388,9 @@ size_t tips_cache_solid_size(tips_cache_t* const cache) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&cache->solid_tips_lock);
-  size = hash243_set_size(cache->solid_tips);
-  rw_lock_handle_unlock(&cache->solid_tips_lock);
+  rw_lock_handle_rdlock(&cache->lock);
+  size = cache->solid_size;
+  rw_lock_handle_unlock(&cache->lock);
 
   return size;
 }
@@ -201,13 +402,9 @@ size_t tips_cache_size(tips_cache_t* const cache) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&cache->tips_lock);
-  size = hash243_set_size(cache->tips);
-  rw_lock_handle_unlock(&cache->tips_lock);
-
-  rw_lock_handle_rdlock(&cache->solid_tips_lock);
-  size += hash243_set_size(cache->solid_tips);
-  rw_lock_handle_unlock(&cache->solid_tips_lock);
+  rw_lock_handle_rdlock(&cache->lock);
+  size = cache->size;
+  rw_lock_handle_unlock(&cache->lock);
 
   return size;
 }
@@ -219,9 +416,9 @@ retcode_t tips_cache_random_tip(tips_cache_t* const cache, flex_trit_t* const ti
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&cache->tips_lock);
-  ret = tips_cache_random_tip_from_set(&cache->tips, tip);
-  rw_lock_handle_unlock(&cache->tips_lock);
+  rw_lock_handle_rdlock(&cache->lock);
+  ret = tips_cache_random_tip_from_range(cache, cache->solid_size, cache->size, tip);
+  rw_lock_handle_unlock(&cache->lock);
 
   return ret;
 }
@@ -233,9 +430,9 @@ retcode_t tips_cache_random_solid_tip(tips_cache_t* const cache, flex_trit_t* co
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&cache->solid_tips_lock);
-  ret = tips_cache_random_tip_from_set(&cache->solid_tips, tip);
-  rw_lock_handle_unlock(&cache->solid_tips_lock);
+  rw_lock_handle_rdlock(&cache->lock);
+  ret = tips_cache_random_tip_from_range(cache, 0, cache->solid_size, tip);
+  rw_lock_handle_unlock(&cache->lock);
 
   return ret;
 }
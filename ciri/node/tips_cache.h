@@ -8,21 +8,68 @@
 #ifndef __NODE_TIPS_H__
 #define __NODE_TIPS_H__
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
-#include "utils/containers/hash/hash243_set.h"
 #include "utils/containers/hash/hash243_stack.h"
 #include "utils/handles/rw_lock.h"
 
-// A fixed capacity FIFO-behaving tips cache
+typedef struct tips_cache_entry_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  // Positions of the previous and next entries of the same partition, in insertion order
+  uint32_t prev;
+  uint32_t next;
+} tips_cache_entry_t;
+
+typedef enum tips_cache_partition_e {
+  TIPS_CACHE_SOLID = 0,
+  TIPS_CACHE_NON_SOLID,
+  TIPS_CACHE_PARTITIONS
+} tips_cache_partition_t;
+
+/**
+ * A fixed capacity FIFO-behaving tips cache
+ *
+ * Tips are stored in a dense array, solid tips first and non solid tips after them, so that picking a random tip of
+ * either partition is a single index and iterating tips does not chase pointers. An open-addressing index maps hashes
+ * to positions, which makes adding, removing and promoting a tip constant time: holes are filled by moving the last
+ * entry of the partition. Each partition also links its entries in insertion order to evict the oldest one when full.
+ */
 typedef struct tips_cache_s {
-  hash243_set_t tips;
-  rw_lock_handle_t tips_lock;
-  hash243_set_t solid_tips;
-  rw_lock_handle_t solid_tips_lock;
-  size_t capacity;
+  tips_cache_entry_t* entries;
+  uint32_t* index;  // Positions + 1 of the entries, 0 for free slots
+  size_t index_mask;
+  size_t size;
+  size_t solid_size;
+  uint32_t oldest[TIPS_CACHE_PARTITIONS];
+  uint32_t newest[TIPS_CACHE_PARTITIONS];
+  size_t capacity;  // Per partition
+  rw_lock_handle_t lock;
 } tips_cache_t;
 
+/**
+ * A function called on each tip of a tips cache
+ *
+ * @param tip The tip
+ * @param data User data
+ *
+ * @return a status code, iteration stops on anything else than RC_OK
+ */
+typedef retcode_t (*tips_cache_functor)(flex_trit_t const* const tip, void* const data);
+
+/**
+ * A function telling whether a tip is already approved
+ *
+ * @param tip The tip
+ * @param data User data
+ * @param approved Whether the tip is approved
+ *
+ * @return a status code
+ */
+typedef retcode_t (*tips_cache_approved_functor)(flex_trit_t const* const tip, void* const data, bool* const approved);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -56,6 +103,19 @@ retcode_t tips_cache_destroy(tips_cache_t* const cache);
  */
 retcode_t tips_cache_get_tips(tips_cache_t* const cache, hash243_stack_t* const tips);
 
+/**
+ * Calls a function on each tip of a tips cache, solid tips first
+ *
+ * Tips are not copied: the function is called under the read lock of the cache and must not modify it.
+ *
+ * @param cache The cache
+ * @param functor The function
+ * @param data User data passed to the function
+ *
+ * @return a status code
+ */
+retcode_t tips_cache_for_each(tips_cache_t* const cache, tips_cache_functor functor, void* const data);
+
 /**
  * Adds a tip to a tips cache
  *
@@ -76,6 +136,24 @@ retcode_t tips_cache_add(tips_cache_t* const cache, flex_trit_t const* const tip
  */
 retcode_t tips_cache_remove(tips_cache_t* const cache, flex_trit_t const* const tip);
 
+/**
+ * Updates a tips cache with a new transaction: it is added if not yet approved and its trunk and branch are removed
+ *
+ * The approval check and the update are done under the write lock of the cache so that a transaction and one of its
+ * approvers updated concurrently can't leave an approved transaction in the cache.
+ *
+ * @param cache The cache
+ * @param tip The transaction hash
+ * @param trunk The trunk of the transaction
+ * @param branch The branch of the transaction
+ * @param approved A function telling whether the transaction is already approved
+ * @param data User data passed to the function
+ *
+ * @return a status code
+ */
+retcode_t tips_cache_update(tips_cache_t* const cache, flex_trit_t const* const tip, flex_trit_t const* const trunk,
+                            flex_trit_t const* const branch, tips_cache_approved_functor approved, void* const data);
+
 /**
  * Sets a cached tip as solid
  *
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "xxhash.h"
+
+#include "ciri/node/transaction_bytes_cache.h"
+
+#define TRANSACTION_BYTES_CACHE_NONE UINT32_MAX
+
+/*
+ * Private functions
+ */
+
+static inline size_t transaction_bytes_cache_index_slot(transaction_bytes_cache_t const* const cache,
+                                                        flex_trit_t const* const hash) {
+  return XXH64(hash, FLEX_TRIT_SIZE_243, 0) & cache->index_mask;
+}
+
+/**
+ * Finds the index slot of a transaction
+ *
+ * @return the index slot, or the free slot it would be inserted at if *found is false
+ */
+static size_t transaction_bytes_cache_index_find(transaction_bytes_cache_t const* const cache,
+                                                 flex_trit_t const* const hash, bool* const found) {
+  size_t slot = transaction_bytes_cache_index_slot(cache, hash);
+
+  // The index is at most half full so there always is a free slot ending the probe sequence
+  while (cache->index[slot] != 0) {
+    if (memcmp(cache->entries[cache->index[slot] - 1].hash, hash, FLEX_TRIT_SIZE_243) == 0) {
+      *found = true;
+      return slot;
+    }
+    slot = (slot + 1) & cache->index_mask;
+  }
+  *found = false;
+
+  return slot;
+}
+
+/**
+ * Frees an index slot, shifting back following entries of the probe sequence so that lookups never miss them
+ */
+static void transaction_bytes_cache_index_remove(transaction_bytes_cache_t* const cache, size_t slot) {
+  size_t next = slot;
+  size_t home = 0;
+
+  while (true) {
+    next = (next + 1) & cache->index_mask;
+    if (cache->index[next] == 0) {
+      break;
+    }
+    home = transaction_bytes_cache_index_slot(cache, cache->entries[cache->index[next] - 1].hash);
+    // The entry at next can fill the hole only if its home slot is not cyclically in ]slot, next]
+    if (((next - home) & cache->index_mask) >= ((next - slot) & cache->index_mask)) {
+      cache->index[slot] = cache->index[next];
+      slot = next;
+    }
+  }
+  cache->index[slot] = 0;
+}
+
+static void transaction_bytes_cache_list_push_front(transaction_bytes_cache_t* const cache, uint32_t const position) {
+  transaction_bytes_cache_entry_t* const entry = &cache->entries[position];
+
+  entry->prev = TRANSACTION_BYTES_CACHE_NONE;
+  entry->next = cache->most_recent;
+  if (cache->most_recent != TRANSACTION_BYTES_CACHE_NONE) {
+    cache->entries[cache->most_recent].prev = position;
+  } else {
+    cache->least_recent = position;
+  }
+  cache->most_recent = position;
+}
+
+static void transaction_bytes_cache_list_unlink(transaction_bytes_cache_t* const cache, uint32_t const position) {
+  transaction_bytes_cache_entry_t const* const entry = &cache->entries[position];
+
+  if (entry->prev != TRANSACTION_BYTES_CACHE_NONE) {
+    cache->entries[entry->prev].next = entry->next;
+  } else {
+    cache->most_recent = entry->next;
+  }
+  if (entry->next != TRANSACTION_BYTES_CACHE_NONE) {
+    cache->entries[entry->next].prev = entry->prev;
+  } else {
+    cache->least_recent = entry->prev;
+  }
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t transaction_bytes_cache_init(transaction_bytes_cache_t* const cache, size_t const capacity) {
+  size_t index_size = 1;
+
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(cache, 0, sizeof(transaction_bytes_cache_t));
+  cache->most_recent = TRANSACTION_BYTES_CACHE_NONE;
+  cache->least_recent = TRANSACTION_BYTES_CACHE_NONE;
+  lock_handle_init(&cache->lock);
+  if (capacity == 0) {
+    return RC_OK;
+  }
+
+  // The index is kept at most half full
+  while (index_size < 2 * capacity) {
+    index_size <<= 1;
+  }
+
+  if ((cache->entries = (transaction_bytes_cache_entry_t*)malloc(capacity * sizeof(transaction_bytes_cache_entry_t))) ==
+      NULL) {
+    return RC_OOM;
+  }
+  if ((cache->index = (uint32_t*)calloc(index_size, sizeof(uint32_t))) == NULL) {
+    free(cache->entries);
+    cache->entries = NULL;
+    return RC_OOM;
+  }
+  cache->index_mask = index_size - 1;
+  cache->capacity = capacity;
+
+  return RC_OK;
+}
+
+retcode_t transaction_bytes_cache_destroy(transaction_bytes_cache_t* const cache) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  free(cache->entries);
+  cache->entries = NULL;
+  free(cache->index);
+  cache->index = NULL;
+  cache->size = 0;
+  cache->capacity = 0;
+  lock_handle_destroy(&cache->lock);
+
+  return RC_OK;
+}
+
+retcode_t transaction_bytes_cache_get(transaction_bytes_cache_t* const cache, flex_trit_t const* const hash,
+                                      byte_t* const bytes, uint64_t* const digest, bool* const found) {
+  transaction_bytes_cache_entry_t const* entry = NULL;
+  size_t slot = 0;
+
+  if (cache == NULL || hash == NULL || bytes == NULL || digest == NULL || found == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  *found = false;
+  if (cache->capacity == 0) {
+    return RC_OK;
+  }
+
+  lock_handle_lock(&cache->lock);
+  slot = transaction_bytes_cache_index_find(cache, hash, found);
+  if (!*found) {
+    cache->misses++;
+    lock_handle_unlock(&cache->lock);
+    return RC_OK;
+  }
+
+  cache->hits++;
+  if (cache->index[slot] - 1 != cache->most_recent) {
+    transaction_bytes_cache_list_unlink(cache, cache->index[slot] - 1);
+    transaction_bytes_cache_list_push_front(cache, cache->index[slot] - 1);
+  }
+  entry = &cache->entries[cache->index[slot] - 1];
+  memcpy(bytes, entry->bytes, GOSSIP_TX_BYTES_LENGTH);
+  *digest = entry->digest;
+  lock_handle_unlock(&cache->lock);
+
+  return RC_OK;
+}
+
+retcode_t transaction_bytes_cache_put(transaction_bytes_cache_t* const cache, flex_trit_t const* const hash,
+                                      byte_t const* const bytes, uint64_t const digest) {
+  transaction_bytes_cache_entry_t* entry = NULL;
+  uint32_t position = 0;
+  size_t slot = 0;
+  bool found = false;
+
+  if (cache == NULL || hash == NULL || bytes == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if (cache->capacity == 0) {
+    return RC_OK;
+  }
+
+  lock_handle_lock(&cache->lock);
+  slot = transaction_bytes_cache_index_find(cache, hash, &found);
+  if (found) {
+    position = cache->index[slot] - 1;
+    transaction_bytes_cache_list_unlink(cache, position);
+  } else if (cache->size < cache->capacity) {
+    position = cache->size++;
+    cache->index[slot] = position + 1;
+  } else {
+    // The least recently used entry is overwritten in place
+    position = cache->least_recent;
+    transaction_bytes_cache_list_unlink(cache, position);
+    transaction_bytes_cache_index_remove(
+        cache, transaction_bytes_cache_index_find(cache, cache->entries[position].hash, &found));
+    cache->index[transaction_bytes_cache_index_find(cache, hash, &found)] = position + 1;
+  }
+
+  entry = &cache->entries[position];
+  memcpy(entry->hash, hash, FLEX_TRIT_SIZE_243);
+  memcpy(entry->bytes, bytes, GOSSIP_TX_BYTES_LENGTH);
+  entry->digest = digest;
+  transaction_bytes_cache_list_push_front(cache, position);
+  lock_handle_unlock(&cache->lock);
+
+  return RC_OK;
+}
+
+retcode_t transaction_bytes_cache_remove(transaction_bytes_cache_t* const cache, flex_trit_t const* const hash) {
+  transaction_bytes_cache_entry_t const* last = NULL;
+  uint32_t position = 0;
+  size_t slot = 0;
+  bool found = false;
+
+  if (cache == NULL || hash == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if (cache->capacity == 0) {
+    return RC_OK;
+  }
+
+  lock_handle_lock(&cache->lock);
+  slot = transaction_bytes_cache_index_find(cache, hash, &found);
+  if (!found) {
+    lock_handle_unlock(&cache->lock);
+    return RC_OK;
+  }
+
+  position = cache->index[slot] - 1;
+  transaction_bytes_cache_list_unlink(cache, position);
+  transaction_bytes_cache_index_remove(cache, slot);
+  cache->size--;
+
+  // The last entry fills the hole so that free positions always follow the used ones
+  if (position != cache->size) {
+    last = &cache->entries[cache->size];
+    cache->index[transaction_bytes_cache_index_find(cache, last->hash, &found)] = position + 1;
+    if (last->prev != TRANSACTION_BYTES_CACHE_NONE) {
+      cache->entries[last->prev].next = position;
+    } else {
+      cache->most_recent = position;
+    }
+    if (last->next != TRANSACTION_BYTES_CACHE_NONE) {
+      cache->entries[last->next].prev = position;
+    } else {
+      cache->least_recent = position;
+    }
+    memcpy(&cache->entries[position], last, sizeof(transaction_bytes_cache_entry_t));
+  }
+  lock_handle_unlock(&cache->lock);
+
+  return RC_OK;
+}
+
+size_t transaction_bytes_cache_size(transaction_bytes_cache_t* const cache) {
+  size_t size = 0;
+
+  if (cache == NULL) {
+    return 0;
+  }
+
+  lock_handle_lock(&cache->lock);
+  size = cache->size;
+  lock_handle_unlock(&cache->lock);
+
+  return size;
+}
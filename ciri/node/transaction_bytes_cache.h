@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __NODE_TRANSACTION_BYTES_CACHE_H__
+#define __NODE_TRANSACTION_BYTES_CACHE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ciri/node/protocol/gossip.h"
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/handles/lock.h"
+
+typedef struct transaction_bytes_cache_entry_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  // Gossip bytes of the transaction and their recent seen bytes digest
+  byte_t bytes[GOSSIP_TX_BYTES_LENGTH];
+  uint64_t digest;
+  // Positions of the more and less recently used entries
+  uint32_t prev;
+  uint32_t next;
+} transaction_bytes_cache_entry_t;
+
+/**
+ * A fixed capacity LRU cache of serialized transactions
+ *
+ * Maps transaction hashes to the gossip bytes sent to neighbors so that transactions requested over and over do not
+ * have to be loaded and serialized again. Entries are packed at the first positions: an open-addressing index maps
+ * hashes to positions and a list links positions from the most to the least recently used one, which is overwritten
+ * when full. The last entry only moves to fill the position of a removed one. The cache is filled by the responder and
+ * emptied of pruned transactions by the pruning service, a lock serializes them.
+ */
+typedef struct transaction_bytes_cache_s {
+  transaction_bytes_cache_entry_t* entries;
+  uint32_t* index;  // Positions + 1 of the entries, 0 for free slots
+  size_t index_mask;
+  size_t size;
+  size_t capacity;
+  uint32_t most_recent;
+  uint32_t least_recent;
+  uint64_t hits;
+  uint64_t misses;
+  lock_handle_t lock;
+} transaction_bytes_cache_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a transaction bytes cache
+ *
+ * @param cache The cache
+ * @param capacity The number of transactions the cache holds, 0 disables the cache
+ *
+ * @return a status code
+ */
+retcode_t transaction_bytes_cache_init(transaction_bytes_cache_t* const cache, size_t const capacity);
+
+/**
+ * Destroys a transaction bytes cache
+ *
+ * @param cache The cache
+ *
+ * @return a status code
+ */
+retcode_t transaction_bytes_cache_destroy(transaction_bytes_cache_t* const cache);
+
+/**
+ * Gets the gossip bytes of a transaction and marks it as the most recently used one
+ *
+ * @param cache The cache
+ * @param hash The transaction hash
+ * @param bytes Filled with GOSSIP_TX_BYTES_LENGTH bytes if found
+ * @param digest Filled with the recent seen bytes digest of the bytes if found
+ * @param found Whether the transaction was found
+ *
+ * @return a status code
+ */
+retcode_t transaction_bytes_cache_get(transaction_bytes_cache_t* const cache, flex_trit_t const* const hash,
+                                      byte_t* const bytes, uint64_t* const digest, bool* const found);
+
+/**
+ * Puts the gossip bytes of a transaction in the cache, evicting the least recently used one if full
+ *
+ * @param cache The cache
+ * @param hash The transaction hash
+ * @param bytes GOSSIP_TX_BYTES_LENGTH bytes of the transaction
+ * @param digest The recent seen bytes digest of the bytes
+ *
+ * @return a status code
+ */
+retcode_t transaction_bytes_cache_put(transaction_bytes_cache_t* const cache, flex_trit_t const* const hash,
+                                      byte_t const* const bytes, uint64_t const digest);
+
+/**
+ * Removes a transaction from the cache, e.g. because it was deleted from the database
+ *
+ * @param cache The cache
+ * @param hash The transaction hash, absent hashes are ignored
+ *
+ * @return a status code
+ */
+retcode_t transaction_bytes_cache_remove(transaction_bytes_cache_t* const cache, flex_trit_t const* const hash);
+
+/**
+ * Gets the number of transactions in the cache
+ *
+ * @param cache The cache
+ *
+ * @return the number of transactions
+ */
+size_t transaction_bytes_cache_size(transaction_bytes_cache_t* const cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __NODE_TRANSACTION_BYTES_CACHE_H__
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ciri/storage/batch.h"
+#include "common/model/transaction.h"
+
+static int entry_cmp(void const *const lhs, void const *const rhs) {
+  storage_batch_entry_t const *const l = lhs;
+  storage_batch_entry_t const *const r = rhs;
+  int cmp = memcmp(l->hash, r->hash, FLEX_TRIT_SIZE_243);
+
+  if (cmp != 0) {
+    return cmp;
+  }
+
+  // Keeps duplicates in list order
+  return (l->position > r->position) - (l->position < r->position);
+}
+
+retcode_t storage_batch_init(storage_batch_t *const batch, hash243_queue_t const hashes) {
+  hash243_queue_entry_t *iter = NULL;
+
+  batch->entries = NULL;
+  batch->size = hash243_queue_count(hashes);
+
+  if (batch->size == 0) {
+    return RC_OK;
+  }
+
+  if ((batch->entries = (storage_batch_entry_t *)malloc(batch->size * sizeof(storage_batch_entry_t))) == NULL) {
+    batch->size = 0;
+    return RC_OOM;
+  }
+
+  batch->size = 0;
+  CDL_FOREACH(hashes, iter) {
+    batch->entries[batch->size].hash = iter->hash;
+    batch->entries[batch->size].position = batch->size;
+    batch->size++;
+  }
+
+  qsort(batch->entries, batch->size, sizeof(storage_batch_entry_t), entry_cmp);
+
+  return RC_OK;
+}
+
+void storage_batch_destroy(storage_batch_t *const batch) {
+  free(batch->entries);
+  batch->entries = NULL;
+  batch->size = 0;
+}
+
+size_t storage_batch_find(storage_batch_t const *const batch, flex_trit_t const *const hash, size_t *const first) {
+  size_t low = 0;
+  size_t high = batch->size;
+  size_t mid = 0;
+  size_t count = 0;
+
+  // Lower bound of the hash
+  while (low < high) {
+    mid = low + (high - low) / 2;
+    if (memcmp(batch->entries[mid].hash, hash, FLEX_TRIT_SIZE_243) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  *first = low;
+  while (low + count < batch->size && memcmp(batch->entries[low + count].hash, hash, FLEX_TRIT_SIZE_243) == 0) {
+    count++;
+  }
+
+  return count;
+}
+
+retcode_t storage_batch_pack_prepare(iota_stor_pack_t *const pack, size_t const count) {
+  pack->num_loaded = 0;
+  pack->insufficient_capacity = count > pack->capacity;
+
+  if (pack->insufficient_capacity) {
+    return RC_OK;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    transaction_reset((iota_transaction_t *)pack->models[i]);
+  }
+  pack->num_loaded = count;
+
+  return RC_OK;
+}
+
+void storage_batch_pack_reset(iota_stor_pack_t *const pack) {
+  for (size_t i = 0; i < pack->capacity; i++) {
+    transaction_reset((iota_transaction_t *)pack->models[i]);
+  }
+  pack->num_loaded = 0;
+  pack->insufficient_capacity = false;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CIRI_STORAGE_BATCH_H__
+#define __CIRI_STORAGE_BATCH_H__
+
+#include <stddef.h>
+
+#include "ciri/storage/pack.h"
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/containers/hash/hash243_queue.h"
+
+// Maximum number of hashes looked up by a single statement
+#define STORAGE_BATCH_CHUNK_SIZE 512
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct storage_batch_entry_s {
+  flex_trit_t const *hash;
+  size_t position;
+} storage_batch_entry_t;
+
+/**
+ * A list of hashes sorted for batched loads
+ * Backends look hashes up in sorted order, which is the order of their indexes, and use the batch to find the positions
+ * in the original list of the hash of a loaded row
+ */
+typedef struct storage_batch_s {
+  storage_batch_entry_t *entries;
+  size_t size;
+} storage_batch_t;
+
+/**
+ * Initializes a batch
+ * Hashes are referenced, not copied, so the queue must outlive the batch
+ *
+ * @param batch The batch
+ * @param hashes A list of hashes, possibly with duplicates
+ *
+ * @return a status code
+ */
+retcode_t storage_batch_init(storage_batch_t *const batch, hash243_queue_t const hashes);
+
+/**
+ * Destroys a batch
+ *
+ * @param batch The batch
+ */
+void storage_batch_destroy(storage_batch_t *const batch);
+
+/**
+ * Finds the entries of a hash
+ *
+ * @param batch The batch
+ * @param hash The hash
+ * @param first Set to the index of the first entry of the hash
+ *
+ * @return the number of entries of the hash, more than one if the hash was given several times
+ */
+size_t storage_batch_find(storage_batch_t const *const batch, flex_trit_t const *const hash, size_t *const first);
+
+/**
+ * Prepares a pack of transactions for a batched load
+ * On success every model is reset and counted as loaded, models of hashes that are not found keep an empty loaded
+ * columns mask; if the pack can't hold all hashes, insufficient_capacity is set and nothing is counted as loaded
+ *
+ * @param pack A pack of transactions
+ * @param count The number of hashes to load
+ *
+ * @return a status code
+ */
+retcode_t storage_batch_pack_prepare(iota_stor_pack_t *const pack, size_t const count);
+
+/**
+ * Empties a pack of transactions and resets all its models, so that none keeps fields of a previous load
+ *
+ * @param pack A pack of transactions
+ */
+void storage_batch_pack_reset(iota_stor_pack_t *const pack);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CIRI_STORAGE_BATCH_H__
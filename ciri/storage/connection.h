@@ -8,6 +8,8 @@
 #ifndef __CIRI_STORAGE_CONNECTION_H__
 #define __CIRI_STORAGE_CONNECTION_H__
 
+#include <stdbool.h>
+
 #include "common/errors.h"
 
 #ifdef __cplusplus
@@ -26,6 +28,8 @@ typedef struct storage_connection_s {
 
 typedef struct storage_connection_config_s {
   char const* db_path;
+  // Opens a connection that is not allowed to write, honored where the backend supports it
+  bool read_only;
 } storage_connection_config_t;
 
 extern retcode_t storage_connection_init(storage_connection_t* const connection,
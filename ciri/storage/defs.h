@@ -59,4 +59,13 @@
 
 #define SPENT_ADDRESS_NUM_COLS 1
 
+/*
+ * Find keys definitions
+ */
+
+#define FIND_KEYS_TABLE_NAME "temp.iota_find_keys"
+
+#define FIND_KEYS_COL_LIST "list"
+#define FIND_KEYS_COL_KEY "key"
+
 #endif  // __CIRI_STORAGE_DEFS_H__
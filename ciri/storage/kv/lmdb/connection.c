@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <lmdb.h>
+
+#include "ciri/storage/kv/lmdb/connection.h"
+#include "ciri/storage/kv/lmdb/wrappers.h"
+#include "utils/handles/lock.h"
+#include "utils/logger_helper.h"
+
+#define LMDB_LOGGER_ID "lmdb"
+
+static logger_id_t logger_id;
+
+static lock_handle_t connections_lock;
+static lmdb_connection_t* connections = NULL;
+
+static char const* const keyspaces_names[LMDB_KEYSPACE_NUM] = {
+    [LMDB_KEYSPACE_TRANSACTION] = "transaction",
+    [LMDB_KEYSPACE_TRANSACTION_METADATA] = "transaction_metadata",
+    [LMDB_KEYSPACE_APPROVER] = "approver",
+    [LMDB_KEYSPACE_ADDRESS] = "address",
+    [LMDB_KEYSPACE_BUNDLE] = "bundle",
+    [LMDB_KEYSPACE_TAG] = "tag",
+    [LMDB_KEYSPACE_MILESTONE] = "milestone",
+    [LMDB_KEYSPACE_MILESTONE_HASH] = "milestone_hash",
+    [LMDB_KEYSPACE_STATE_DELTA] = "state_delta",
+    [LMDB_KEYSPACE_SPENT_ADDRESS] = "spent_address",
+};
+
+static retcode_t open_keyspaces(lmdb_connection_t* const connection, storage_connection_type_t const type) {
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  size_t first = 0, last = 0;
+
+  if (type == STORAGE_CONNECTION_TANGLE) {
+    first = LMDB_KEYSPACE_TRANSACTION;
+    last = LMDB_KEYSPACE_STATE_DELTA;
+  } else if (type == STORAGE_CONNECTION_SPENT_ADDRESSES) {
+    first = LMDB_KEYSPACE_SPENT_ADDRESS;
+    last = LMDB_KEYSPACE_SPENT_ADDRESS;
+  }
+
+  if ((ret = begin_write_transaction(connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  for (size_t i = first; i <= last; i++) {
+    if (mdb_dbi_open(txn, keyspaces_names[i], MDB_CREATE, &connection->dbis[i]) != MDB_SUCCESS) {
+      log_critical(logger_id, "Opening keyspace %s failed\n", keyspaces_names[i]);
+      ret = RC_STORAGE_FAILED_OPEN_DB;
+      break;
+    }
+  }
+
+  return end_write_transaction(txn, ret);
+}
+
+static retcode_t environment_open(lmdb_connection_t* const connection) {
+  int rc = 0;
+
+  if ((rc = mdb_env_create(&connection->env)) != MDB_SUCCESS ||
+      (rc = mdb_env_set_maxdbs(connection->env, LMDB_KEYSPACE_NUM)) != MDB_SUCCESS ||
+      (rc = mdb_env_set_maxreaders(connection->env, LMDB_MAX_READERS)) != MDB_SUCCESS ||
+      (rc = mdb_env_set_mapsize(connection->env, LMDB_MAP_SIZE)) != MDB_SUCCESS) {
+    log_critical(logger_id, "Configuring environment failed: %s\n", mdb_strerror(rc));
+    return RC_STORAGE_FAILED_CONFIG;
+  }
+
+  // Read transactions are not bound to threads since connections are
+  if ((rc = mdb_env_open(connection->env, connection->path, MDB_NOSUBDIR | MDB_NOTLS, 0644)) != MDB_SUCCESS) {
+    log_critical(logger_id, "Failed to open db on path: %s: %s\n", connection->path, mdb_strerror(rc));
+    return RC_STORAGE_FAILED_OPEN_DB;
+  }
+
+  return RC_OK;
+}
+
+static void environment_close(lmdb_connection_t* const connection) {
+  if (connection->env) {
+    mdb_env_close(connection->env);
+  }
+  free(connection->path);
+  free(connection);
+}
+
+static void environment_release(lmdb_connection_t* const connection) {
+  lmdb_connection_t** iter = NULL;
+
+  if (connection->references > 0) {
+    return;
+  }
+
+  for (iter = &connections; *iter != NULL; iter = &(*iter)->next) {
+    if (*iter == connection) {
+      *iter = connection->next;
+      break;
+    }
+  }
+  environment_close(connection);
+}
+
+retcode_t lmdb_connections_init() {
+  logger_id = logger_helper_enable(LMDB_LOGGER_ID, LOGGER_DEBUG, true);
+  lock_handle_init(&connections_lock);
+  connections = NULL;
+
+  return RC_OK;
+}
+
+retcode_t lmdb_connections_destroy() {
+  lmdb_connection_t* connection = NULL;
+
+  while ((connection = connections) != NULL) {
+    log_warning(logger_id, "Environment %s still referenced\n", connection->path);
+    connections = connection->next;
+    environment_close(connection);
+  }
+  lock_handle_destroy(&connections_lock);
+  logger_helper_release(logger_id);
+
+  return RC_OK;
+}
+
+retcode_t storage_connection_init(storage_connection_t* const connection,
+                                  storage_connection_config_t const* const config,
+                                  storage_connection_type_t const type) {
+  retcode_t ret = RC_OK;
+  lmdb_connection_t* lmdb_connection = NULL;
+
+  if (connection == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  // read_only is ignored since environments are shared and LMDB readers never contend with its single writer anyway
+  connection->actual = NULL;
+  connection->type = type;
+
+  if (config->db_path == NULL) {
+    log_critical(logger_id, "No path for db specified\n");
+    return RC_STORAGE_NO_PATH_FOR_DB_SPECIFIED;
+  }
+
+  lock_handle_lock(&connections_lock);
+
+  for (lmdb_connection = connections; lmdb_connection != NULL; lmdb_connection = lmdb_connection->next) {
+    if (strcmp(lmdb_connection->path, config->db_path) == 0) {
+      break;
+    }
+  }
+
+  if (lmdb_connection == NULL) {
+    if ((lmdb_connection = (lmdb_connection_t*)calloc(1, sizeof(lmdb_connection_t))) == NULL ||
+        (lmdb_connection->path = strdup(config->db_path)) == NULL) {
+      free(lmdb_connection);
+      ret = RC_OOM;
+      goto done;
+    }
+    if ((ret = environment_open(lmdb_connection)) != RC_OK) {
+      environment_close(lmdb_connection);
+      goto done;
+    }
+    lmdb_connection->next = connections;
+    connections = lmdb_connection;
+  }
+
+  // Opening an already opened keyspace gives the same handle
+  if ((ret = open_keyspaces(lmdb_connection, type)) != RC_OK) {
+    environment_release(lmdb_connection);
+    goto done;
+  }
+
+  lmdb_connection->references++;
+  connection->actual = lmdb_connection;
+
+done:
+  lock_handle_unlock(&connections_lock);
+
+  return ret;
+}
+
+retcode_t storage_connection_destroy(storage_connection_t* const connection) {
+  lmdb_connection_t* lmdb_connection = NULL;
+
+  if (connection == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((lmdb_connection = (lmdb_connection_t*)connection->actual) == NULL) {
+    return RC_OK;
+  }
+
+  lock_handle_lock(&connections_lock);
+
+  lmdb_connection->references--;
+  environment_release(lmdb_connection);
+
+  lock_handle_unlock(&connections_lock);
+
+  connection->actual = NULL;
+
+  return RC_OK;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CIRI_STORAGE_KV_LMDB_CONNECTION_H__
+#define __CIRI_STORAGE_KV_LMDB_CONNECTION_H__
+
+#include <stddef.h>
+
+#include <lmdb.h>
+
+#include "ciri/storage/connection.h"
+#include "common/errors.h"
+
+// Maximum size of the memory map, only address space is reserved
+#define LMDB_MAP_SIZE ((size_t)1 << (sizeof(size_t) > 4 ? 40 : 30))
+#define LMDB_MAX_READERS 256
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Keyspaces are LMDB named databases, the equivalent of column families
+ * Keys holding several hashes are concatenations so that all the entries of an indexed value are found with a prefix
+ * scan
+ */
+typedef enum lmdb_keyspace_e {
+  // Transaction hash -> essence, attachment and signature or message
+  LMDB_KEYSPACE_TRANSACTION,
+  // Transaction hash -> snapshot index, solidity, validity and arrival timestamp
+  LMDB_KEYSPACE_TRANSACTION_METADATA,
+  // Approvee hash + approver hash -> nothing
+  LMDB_KEYSPACE_APPROVER,
+  // Address + transaction hash -> nothing
+  LMDB_KEYSPACE_ADDRESS,
+  // Bundle hash + transaction hash -> nothing
+  LMDB_KEYSPACE_BUNDLE,
+  // Tag + transaction hash -> nothing
+  LMDB_KEYSPACE_TAG,
+  // Big-endian milestone index -> milestone hash
+  LMDB_KEYSPACE_MILESTONE,
+  // Milestone hash -> big-endian milestone index
+  LMDB_KEYSPACE_MILESTONE_HASH,
+  // Big-endian milestone index -> serialized state delta
+  LMDB_KEYSPACE_STATE_DELTA,
+  // Spent address -> nothing
+  LMDB_KEYSPACE_SPENT_ADDRESS,
+  LMDB_KEYSPACE_NUM
+} lmdb_keyspace_t;
+
+/**
+ * An LMDB environment must not be opened twice in the same process so every connection to the same database file
+ * shares one, reference counted, and begins its own transactions on it
+ */
+typedef struct lmdb_connection_s {
+  char* path;
+  MDB_env* env;
+  MDB_dbi dbis[LMDB_KEYSPACE_NUM];
+  size_t references;
+  struct lmdb_connection_s* next;
+} lmdb_connection_t;
+
+/**
+ * Initializes the registry of shared environments
+ * Called by storage_init
+ *
+ * @return a status code
+ */
+retcode_t lmdb_connections_init();
+
+/**
+ * Destroys the registry of shared environments
+ * Called by storage_destroy
+ *
+ * @return a status code
+ */
+retcode_t lmdb_connections_destroy();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CIRI_STORAGE_KV_LMDB_CONNECTION_H__
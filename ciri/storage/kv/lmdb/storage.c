@@ -0,0 +1,1489 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lmdb.h>
+
+#include "ciri/storage/batch.h"
+#include "ciri/storage/kv/lmdb/connection.h"
+#include "ciri/storage/kv/lmdb/wrappers.h"
+#include "ciri/storage/storage.h"
+#include "common/model/milestone.h"
+#include "common/model/transaction.h"
+#include "utils/logger_helper.h"
+#include "utils/macros.h"
+#include "utils/time.h"
+
+#define LMDB_LOGGER_ID "lmdb"
+
+static logger_id_t logger_id;
+
+retcode_t storage_init() {
+  logger_id = logger_helper_enable(LMDB_LOGGER_ID, LOGGER_DEBUG, true);
+
+  return lmdb_connections_init();
+}
+
+retcode_t storage_destroy() {
+  retcode_t ret = lmdb_connections_destroy();
+
+  logger_helper_release(logger_id);
+
+  return ret;
+}
+
+/*
+ * Records
+ *
+ * Transactions are stored as fixed size records: essence first, then attachment, then signature or message so that
+ * partial loads only touch the beginning of the record. Integers are big-endian.
+ */
+
+#define RECORD_ADDRESS 0
+#define RECORD_VALUE (RECORD_ADDRESS + FLEX_TRIT_SIZE_243)
+#define RECORD_OBSOLETE_TAG (RECORD_VALUE + sizeof(uint64_t))
+#define RECORD_TIMESTAMP (RECORD_OBSOLETE_TAG + FLEX_TRIT_SIZE_81)
+#define RECORD_CURRENT_INDEX (RECORD_TIMESTAMP + sizeof(uint64_t))
+#define RECORD_LAST_INDEX (RECORD_CURRENT_INDEX + sizeof(uint64_t))
+#define RECORD_BUNDLE (RECORD_LAST_INDEX + sizeof(uint64_t))
+#define RECORD_TRUNK (RECORD_BUNDLE + FLEX_TRIT_SIZE_243)
+#define RECORD_BRANCH (RECORD_TRUNK + FLEX_TRIT_SIZE_243)
+#define RECORD_ATTACHMENT_TIMESTAMP (RECORD_BRANCH + FLEX_TRIT_SIZE_243)
+#define RECORD_ATTACHMENT_TIMESTAMP_LOWER (RECORD_ATTACHMENT_TIMESTAMP + sizeof(uint64_t))
+#define RECORD_ATTACHMENT_TIMESTAMP_UPPER (RECORD_ATTACHMENT_TIMESTAMP_LOWER + sizeof(uint64_t))
+#define RECORD_NONCE (RECORD_ATTACHMENT_TIMESTAMP_UPPER + sizeof(uint64_t))
+#define RECORD_TAG (RECORD_NONCE + FLEX_TRIT_SIZE_81)
+#define RECORD_SIG_OR_MSG (RECORD_TAG + FLEX_TRIT_SIZE_81)
+#define RECORD_SIZE (RECORD_SIG_OR_MSG + FLEX_TRIT_SIZE_6561)
+
+#define METADATA_SNAPSHOT_INDEX 0
+#define METADATA_SOLID (METADATA_SNAPSHOT_INDEX + sizeof(uint64_t))
+#define METADATA_VALIDITY (METADATA_SOLID + 1)
+#define METADATA_ARRIVAL_TIMESTAMP (METADATA_VALIDITY + 1)
+#define METADATA_SIZE (METADATA_ARRIVAL_TIMESTAMP + sizeof(uint64_t))
+
+#define INDEX_KEY_SIZE_MAX (2 * FLEX_TRIT_SIZE_243)
+
+static void record_write(uint8_t* const record, iota_transaction_t const* const tx) {
+  memcpy(record + RECORD_ADDRESS, tx->essence.address, FLEX_TRIT_SIZE_243);
+  uint64_encode(record + RECORD_VALUE, (uint64_t)tx->essence.value);
+  memcpy(record + RECORD_OBSOLETE_TAG, tx->essence.obsolete_tag, FLEX_TRIT_SIZE_81);
+  uint64_encode(record + RECORD_TIMESTAMP, tx->essence.timestamp);
+  uint64_encode(record + RECORD_CURRENT_INDEX, tx->essence.current_index);
+  uint64_encode(record + RECORD_LAST_INDEX, tx->essence.last_index);
+  memcpy(record + RECORD_BUNDLE, tx->essence.bundle, FLEX_TRIT_SIZE_243);
+  memcpy(record + RECORD_TRUNK, tx->attachment.trunk, FLEX_TRIT_SIZE_243);
+  memcpy(record + RECORD_BRANCH, tx->attachment.branch, FLEX_TRIT_SIZE_243);
+  uint64_encode(record + RECORD_ATTACHMENT_TIMESTAMP, tx->attachment.attachment_timestamp);
+  uint64_encode(record + RECORD_ATTACHMENT_TIMESTAMP_LOWER, tx->attachment.attachment_timestamp_lower);
+  uint64_encode(record + RECORD_ATTACHMENT_TIMESTAMP_UPPER, tx->attachment.attachment_timestamp_upper);
+  memcpy(record + RECORD_NONCE, tx->attachment.nonce, FLEX_TRIT_SIZE_81);
+  memcpy(record + RECORD_TAG, tx->attachment.tag, FLEX_TRIT_SIZE_81);
+  memcpy(record + RECORD_SIG_OR_MSG, tx->data.signature_or_message, FLEX_TRIT_SIZE_6561);
+}
+
+static void record_populate_essence(uint8_t const* const record, iota_transaction_t* const tx) {
+  memcpy(tx->essence.address, record + RECORD_ADDRESS, FLEX_TRIT_SIZE_243);
+  tx->loaded_columns_mask.essence |= MASK_ESSENCE_ADDRESS;
+  transaction_set_value(tx, (int64_t)uint64_decode(record + RECORD_VALUE));
+  memcpy(tx->essence.obsolete_tag, record + RECORD_OBSOLETE_TAG, FLEX_TRIT_SIZE_81);
+  tx->loaded_columns_mask.essence |= MASK_ESSENCE_OBSOLETE_TAG;
+  transaction_set_timestamp(tx, uint64_decode(record + RECORD_TIMESTAMP));
+  transaction_set_current_index(tx, uint64_decode(record + RECORD_CURRENT_INDEX));
+  transaction_set_last_index(tx, uint64_decode(record + RECORD_LAST_INDEX));
+  memcpy(tx->essence.bundle, record + RECORD_BUNDLE, FLEX_TRIT_SIZE_243);
+  tx->loaded_columns_mask.essence |= MASK_ESSENCE_BUNDLE;
+}
+
+static void record_populate_attachment(uint8_t const* const record, iota_transaction_t* const tx) {
+  memcpy(tx->attachment.trunk, record + RECORD_TRUNK, FLEX_TRIT_SIZE_243);
+  tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_TRUNK;
+  memcpy(tx->attachment.branch, record + RECORD_BRANCH, FLEX_TRIT_SIZE_243);
+  tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_BRANCH;
+  transaction_set_attachment_timestamp(tx, uint64_decode(record + RECORD_ATTACHMENT_TIMESTAMP));
+  transaction_set_attachment_timestamp_lower(tx, uint64_decode(record + RECORD_ATTACHMENT_TIMESTAMP_LOWER));
+  transaction_set_attachment_timestamp_upper(tx, uint64_decode(record + RECORD_ATTACHMENT_TIMESTAMP_UPPER));
+  memcpy(tx->attachment.nonce, record + RECORD_NONCE, FLEX_TRIT_SIZE_81);
+  tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_NONCE;
+  memcpy(tx->attachment.tag, record + RECORD_TAG, FLEX_TRIT_SIZE_81);
+  tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_TAG;
+}
+
+static void record_populate_data(uint8_t const* const record, iota_transaction_t* const tx) {
+  memcpy(tx->data.signature_or_message, record + RECORD_SIG_OR_MSG, FLEX_TRIT_SIZE_6561);
+  tx->loaded_columns_mask.data |= MASK_DATA_SIG_OR_MSG;
+}
+
+static void metadata_populate(uint8_t const* const metadata, iota_transaction_t* const tx) {
+  transaction_set_snapshot_index(tx, uint64_decode(metadata + METADATA_SNAPSHOT_INDEX));
+  transaction_set_solid(tx, metadata[METADATA_SOLID]);
+  transaction_set_validity(tx, metadata[METADATA_VALIDITY]);
+  transaction_set_arrival_timestamp(tx, uint64_decode(metadata + METADATA_ARRIVAL_TIMESTAMP));
+}
+
+/*
+ * Generic functions
+ */
+
+static bool pack_append_hash(iota_stor_pack_t* const pack, flex_trit_t const* const hash) {
+  if (pack->num_loaded == pack->capacity) {
+    pack->insufficient_capacity = true;
+    return false;
+  }
+  memcpy(pack->models[pack->num_loaded++], hash, FLEX_TRIT_SIZE_243);
+
+  return true;
+}
+
+// Secondary index entries are the indexed value followed by the transaction hash
+static retcode_t index_put(MDB_txn* const txn, MDB_dbi const dbi, flex_trit_t const* const value,
+                           size_t const value_size, flex_trit_t const* const hash) {
+  uint8_t key[INDEX_KEY_SIZE_MAX];
+
+  memcpy(key, value, value_size);
+  memcpy(key + value_size, hash, FLEX_TRIT_SIZE_243);
+
+  return kv_put(txn, dbi, key, value_size + FLEX_TRIT_SIZE_243, NULL, 0, true);
+}
+
+static retcode_t index_del(MDB_txn* const txn, MDB_dbi const dbi, flex_trit_t const* const value,
+                           size_t const value_size, flex_trit_t const* const hash) {
+  uint8_t key[INDEX_KEY_SIZE_MAX];
+
+  memcpy(key, value, value_size);
+  memcpy(key + value_size, hash, FLEX_TRIT_SIZE_243);
+
+  return kv_del(txn, dbi, key, value_size + FLEX_TRIT_SIZE_243);
+}
+
+typedef struct scan_params_s {
+  lmdb_connection_t const* connection;
+  MDB_txn* txn;
+  iota_stor_pack_t* pack;
+  // Partial transactions are loaded in the pack instead of hashes for a model other than MODEL_HASH
+  storage_load_model_t model;
+  uint64_t before_timestamp;
+  uint64_t count;
+} scan_params_t;
+
+static retcode_t pack_append_model(scan_params_t* const params, flex_trit_t const* const hash, bool* const stop);
+
+static flex_trit_t const* key_hash(MDB_val const* const key) {
+  return (flex_trit_t const*)key->mv_data + key->mv_size - FLEX_TRIT_SIZE_243;
+}
+
+/*
+ * Functors
+ */
+
+static retcode_t load_hash_do_func(void* const arg, MDB_val const* const key, MDB_val const* const value,
+                                   bool* const stop) {
+  scan_params_t* params = (scan_params_t*)arg;
+  UNUSED(value);
+
+  if (params->model != MODEL_HASH) {
+    return pack_append_model(params, key_hash(key), stop);
+  }
+
+  *stop = !pack_append_hash(params->pack, key_hash(key));
+
+  return RC_OK;
+}
+
+static retcode_t count_do_func(void* const arg, MDB_val const* const key, MDB_val const* const value,
+                               bool* const stop) {
+  UNUSED(key);
+  UNUSED(value);
+  UNUSED(stop);
+
+  ((scan_params_t*)arg)->count++;
+
+  return RC_OK;
+}
+
+static retcode_t load_approver_do_func(void* const arg, MDB_val const* const key, MDB_val const* const value,
+                                       bool* const stop) {
+  scan_params_t* params = (scan_params_t*)arg;
+  retcode_t ret = RC_OK;
+  MDB_val metadata;
+  bool found = false;
+
+  if (params->before_timestamp != 0) {
+    if ((ret = kv_get(params->txn, params->connection->dbis[LMDB_KEYSPACE_TRANSACTION_METADATA], key_hash(key),
+                      FLEX_TRIT_SIZE_243, &metadata, &found)) != RC_OK) {
+      return ret;
+    }
+    if (!found ||
+        uint64_decode((uint8_t*)metadata.mv_data + METADATA_ARRIVAL_TIMESTAMP) >= params->before_timestamp) {
+      return RC_OK;
+    }
+  }
+
+  return load_hash_do_func(arg, key, value, stop);
+}
+
+static retcode_t load_milestone_candidate_do_func(void* const arg, MDB_val const* const key,
+                                                  MDB_val const* const value, bool* const stop) {
+  scan_params_t* params = (scan_params_t*)arg;
+  retcode_t ret = RC_OK;
+  MDB_val record;
+  bool found = false;
+
+  if ((ret = kv_get(params->txn, params->connection->dbis[LMDB_KEYSPACE_TRANSACTION], key_hash(key),
+                    FLEX_TRIT_SIZE_243, &record, &found)) != RC_OK) {
+    return ret;
+  }
+  if (!found || uint64_decode((uint8_t*)record.mv_data + RECORD_CURRENT_INDEX) != 0) {
+    return RC_OK;
+  }
+
+  if ((ret = kv_exist(params->txn, params->connection->dbis[LMDB_KEYSPACE_MILESTONE_HASH], key_hash(key),
+                      FLEX_TRIT_SIZE_243, &found)) != RC_OK) {
+    return ret;
+  }
+  if (found) {
+    return RC_OK;
+  }
+
+  return load_hash_do_func(arg, key, value, stop);
+}
+
+/*
+ * Transaction operations
+ */
+
+static retcode_t transaction_put(lmdb_connection_t const* const connection, MDB_txn* const txn,
+                                 iota_transaction_t const* const tx, uint64_t const timestamp) {
+  retcode_t ret = RC_OK;
+  flex_trit_t const* hash = tx->consensus.hash;
+  uint8_t record[RECORD_SIZE];
+  uint8_t metadata[METADATA_SIZE];
+
+  record_write(record, tx);
+  memset(metadata, 0, METADATA_SIZE);
+  uint64_encode(metadata + METADATA_ARRIVAL_TIMESTAMP,
+                tx->metadata.arrival_timestamp != 0 ? tx->metadata.arrival_timestamp : timestamp);
+
+  if ((ret = kv_put(txn, connection->dbis[LMDB_KEYSPACE_TRANSACTION], hash, FLEX_TRIT_SIZE_243, record, RECORD_SIZE,
+                    false)) != RC_OK ||
+      (ret = kv_put(txn, connection->dbis[LMDB_KEYSPACE_TRANSACTION_METADATA], hash, FLEX_TRIT_SIZE_243, metadata,
+                    METADATA_SIZE, true)) != RC_OK ||
+      (ret = index_put(txn, connection->dbis[LMDB_KEYSPACE_APPROVER], tx->attachment.trunk, FLEX_TRIT_SIZE_243,
+                       hash)) != RC_OK ||
+      (ret = index_put(txn, connection->dbis[LMDB_KEYSPACE_APPROVER], tx->attachment.branch, FLEX_TRIT_SIZE_243,
+                       hash)) != RC_OK ||
+      (ret = index_put(txn, connection->dbis[LMDB_KEYSPACE_ADDRESS], tx->essence.address, FLEX_TRIT_SIZE_243,
+                       hash)) != RC_OK ||
+      (ret = index_put(txn, connection->dbis[LMDB_KEYSPACE_BUNDLE], tx->essence.bundle, FLEX_TRIT_SIZE_243, hash)) !=
+          RC_OK ||
+      (ret = index_put(txn, connection->dbis[LMDB_KEYSPACE_TAG], tx->attachment.tag, FLEX_TRIT_SIZE_81, hash)) !=
+          RC_OK) {
+    return ret;
+  }
+
+  return RC_OK;
+}
+
+static retcode_t transaction_del(lmdb_connection_t const* const connection, MDB_txn* const txn,
+                                 flex_trit_t const* const hash) {
+  retcode_t ret = RC_OK;
+  MDB_val value;
+  bool found = false;
+  // Values returned by LMDB are invalidated by updates
+  flex_trit_t record[RECORD_SIG_OR_MSG];
+
+  if ((ret = kv_get(txn, connection->dbis[LMDB_KEYSPACE_TRANSACTION], hash, FLEX_TRIT_SIZE_243, &value, &found)) !=
+          RC_OK ||
+      !found) {
+    return ret;
+  }
+  memcpy(record, value.mv_data, RECORD_SIG_OR_MSG);
+
+  if ((ret = kv_del(txn, connection->dbis[LMDB_KEYSPACE_TRANSACTION], hash, FLEX_TRIT_SIZE_243)) != RC_OK ||
+      (ret = kv_del(txn, connection->dbis[LMDB_KEYSPACE_TRANSACTION_METADATA], hash, FLEX_TRIT_SIZE_243)) != RC_OK ||
+      (ret = index_del(txn, connection->dbis[LMDB_KEYSPACE_APPROVER], record + RECORD_TRUNK, FLEX_TRIT_SIZE_243,
+                       hash)) != RC_OK ||
+      (ret = index_del(txn, connection->dbis[LMDB_KEYSPACE_APPROVER], record + RECORD_BRANCH, FLEX_TRIT_SIZE_243,
+                       hash)) != RC_OK ||
+      (ret = index_del(txn, connection->dbis[LMDB_KEYSPACE_ADDRESS], record + RECORD_ADDRESS, FLEX_TRIT_SIZE_243,
+                       hash)) != RC_OK ||
+      (ret = index_del(txn, connection->dbis[LMDB_KEYSPACE_BUNDLE], record + RECORD_BUNDLE, FLEX_TRIT_SIZE_243,
+                       hash)) != RC_OK ||
+      (ret = index_del(txn, connection->dbis[LMDB_KEYSPACE_TAG], record + RECORD_TAG, FLEX_TRIT_SIZE_81, hash)) !=
+          RC_OK) {
+    return ret;
+  }
+
+  return RC_OK;
+}
+
+// Updates a field of the metadata of a transaction, offset being either METADATA_SNAPSHOT_INDEX, METADATA_SOLID or
+// METADATA_VALIDITY
+static retcode_t metadata_update(lmdb_connection_t const* const connection, MDB_txn* const txn,
+                                 flex_trit_t const* const hash, size_t const offset, uint64_t const value) {
+  retcode_t ret = RC_OK;
+  MDB_val current;
+  bool found = false;
+  uint8_t metadata[METADATA_SIZE];
+
+  if ((ret = kv_get(txn, connection->dbis[LMDB_KEYSPACE_TRANSACTION_METADATA], hash, FLEX_TRIT_SIZE_243, &current,
+                    &found)) != RC_OK ||
+      !found) {
+    return ret;
+  }
+
+  memcpy(metadata, current.mv_data, METADATA_SIZE);
+  if (offset == METADATA_SNAPSHOT_INDEX) {
+    uint64_encode(metadata + offset, value);
+  } else {
+    metadata[offset] = (uint8_t)value;
+  }
+
+  return kv_put(txn, connection->dbis[LMDB_KEYSPACE_TRANSACTION_METADATA], hash, FLEX_TRIT_SIZE_243, metadata,
+                METADATA_SIZE, true);
+}
+
+static retcode_t transaction_update(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                    size_t const offset, uint64_t const value) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  ret = metadata_update(lmdb_connection, txn, hash, offset, value);
+
+  return end_write_transaction(txn, ret);
+}
+
+static retcode_t transactions_update(storage_connection_t const* const connection, hash243_set_t const hashes,
+                                     size_t const offset, uint64_t const value) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  hash243_set_entry_t* iter = NULL;
+  hash243_set_entry_t* tmp = NULL;
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  HASH_ITER(hh, hashes, iter, tmp) {
+    if ((ret = metadata_update(lmdb_connection, txn, iter->hash, offset, value)) != RC_OK) {
+      break;
+    }
+  }
+
+  return end_write_transaction(txn, ret);
+}
+
+static retcode_t transaction_get_model(lmdb_connection_t const* const connection, MDB_txn* const txn,
+                                       flex_trit_t const* const hash, storage_load_model_t const model,
+                                       MDB_val* const record, MDB_val* const metadata, bool* const found) {
+  retcode_t ret = RC_OK;
+
+  *found = true;
+  if (model != MODEL_TRANSACTION_METADATA) {
+    if ((ret = kv_get(txn, connection->dbis[LMDB_KEYSPACE_TRANSACTION], hash, FLEX_TRIT_SIZE_243, record, found)) !=
+            RC_OK ||
+        !*found) {
+      return ret;
+    }
+  }
+  if (model != MODEL_TRANSACTION && model != MODEL_TRANSACTION_ESSENCE_CONSENSUS) {
+    ret = kv_get(txn, connection->dbis[LMDB_KEYSPACE_TRANSACTION_METADATA], hash, FLEX_TRIT_SIZE_243, metadata, found);
+  }
+
+  return ret;
+}
+
+static bool transaction_populate_model(MDB_val const* const record, MDB_val const* const metadata,
+                                       flex_trit_t const* const hash, iota_transaction_t* const tx,
+                                       storage_load_model_t const model) {
+  transaction_reset(tx);
+  switch (model) {
+    case MODEL_TRANSACTION:
+      record_populate_essence(record->mv_data, tx);
+      record_populate_attachment(record->mv_data, tx);
+      transaction_set_hash(tx, hash);
+      record_populate_data(record->mv_data, tx);
+      break;
+    case MODEL_TRANSACTION_ESSENCE_METADATA:
+      record_populate_essence(record->mv_data, tx);
+      metadata_populate(metadata->mv_data, tx);
+      break;
+    case MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA:
+      record_populate_essence(record->mv_data, tx);
+      record_populate_attachment(record->mv_data, tx);
+      metadata_populate(metadata->mv_data, tx);
+      break;
+    case MODEL_TRANSACTION_ESSENCE_CONSENSUS:
+      record_populate_essence(record->mv_data, tx);
+      transaction_set_hash(tx, hash);
+      break;
+    case MODEL_TRANSACTION_METADATA:
+      metadata_populate(metadata->mv_data, tx);
+      break;
+    default:
+      return false;
+  }
+
+  return true;
+}
+
+static retcode_t pack_append_model(scan_params_t* const params, flex_trit_t const* const hash, bool* const stop) {
+  retcode_t ret = RC_OK;
+  MDB_val record;
+  MDB_val metadata;
+  bool found = false;
+
+  if (params->pack->num_loaded == params->pack->capacity) {
+    params->pack->insufficient_capacity = true;
+    *stop = true;
+    return RC_OK;
+  }
+
+  if ((ret = transaction_get_model(params->connection, params->txn, hash, params->model, &record, &metadata,
+                                   &found)) != RC_OK ||
+      !found) {
+    return ret;
+  }
+
+  if (!transaction_populate_model(&record, &metadata, hash, params->pack->models[params->pack->num_loaded],
+                                  params->model)) {
+    return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+  transaction_set_hash(params->pack->models[params->pack->num_loaded++], hash);
+
+  return RC_OK;
+}
+
+static retcode_t transaction_load_model(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                        iota_stor_pack_t* const pack, storage_load_model_t const model) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val record;
+  MDB_val metadata;
+  bool found = false;
+
+  pack->insufficient_capacity = false;
+
+  if ((ret = begin_read_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = transaction_get_model(lmdb_connection, txn, hash, model, &record, &metadata, &found)) != RC_OK ||
+      !found) {
+    goto done;
+  }
+
+  if (pack->num_loaded == pack->capacity) {
+    pack->insufficient_capacity = true;
+    goto done;
+  }
+
+  if (transaction_populate_model(&record, &metadata, hash, pack->models[pack->num_loaded], model)) {
+    pack->num_loaded++;
+  } else {
+    ret = RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+done:
+  end_read_transaction(txn);
+  return ret;
+}
+
+static retcode_t scan_prefix(storage_connection_t const* const connection, lmdb_keyspace_t const keyspace,
+                             flex_trit_t const* const prefix, size_t const prefix_size, lmdb_scan_func const func,
+                             scan_params_t* const params) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+
+  if ((ret = begin_read_transaction(lmdb_connection, &params->txn)) != RC_OK) {
+    return ret;
+  }
+
+  params->connection = lmdb_connection;
+  if (params->pack) {
+    params->pack->insufficient_capacity = false;
+  }
+  ret = kv_scan_prefix(params->txn, lmdb_connection->dbis[keyspace], prefix, prefix_size, func, params);
+
+  end_read_transaction(params->txn);
+
+  return ret;
+}
+
+retcode_t storage_transaction_count(storage_connection_t const* const connection, uint64_t* const count) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+
+  if ((ret = begin_read_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  ret = kv_count(txn, lmdb_connection->dbis[LMDB_KEYSPACE_TRANSACTION], count);
+
+  end_read_transaction(txn);
+
+  return ret;
+}
+
+retcode_t storage_transaction_store(storage_connection_t const* const connection, iota_transaction_t const* const tx) {
+  return storage_transactions_store(connection, tx, 1);
+}
+
+retcode_t storage_transactions_store(storage_connection_t const* const connection,
+                                     iota_transaction_t const* const transactions, size_t const count) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  uint64_t timestamp = current_timestamp_ms();
+
+  if (count == 0) {
+    return RC_OK;
+  }
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if ((ret = transaction_put(lmdb_connection, txn, &transactions[i], timestamp)) != RC_OK) {
+      break;
+    }
+  }
+
+  return end_write_transaction(txn, ret);
+}
+
+retcode_t storage_transaction_load(storage_connection_t const* const connection,
+                                   storage_transaction_field_t const field, flex_trit_t const* const key,
+                                   iota_stor_pack_t* const pack) {
+  if (field != TRANSACTION_FIELD_HASH) {
+    return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  return transaction_load_model(connection, key, pack, MODEL_TRANSACTION);
+}
+
+retcode_t storage_transaction_load_essence_metadata(storage_connection_t const* const connection,
+                                                    flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
+  return transaction_load_model(connection, hash, pack, MODEL_TRANSACTION_ESSENCE_METADATA);
+}
+
+retcode_t storage_transaction_load_essence_attachment_metadata(storage_connection_t const* const connection,
+                                                               flex_trit_t const* const hash,
+                                                               iota_stor_pack_t* const pack) {
+  return transaction_load_model(connection, hash, pack, MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA);
+}
+
+retcode_t storage_transaction_load_essence_consensus(storage_connection_t const* const connection,
+                                                     flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
+  return transaction_load_model(connection, hash, pack, MODEL_TRANSACTION_ESSENCE_CONSENSUS);
+}
+
+retcode_t storage_transaction_load_metadata(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                            iota_stor_pack_t* const pack) {
+  return transaction_load_model(connection, hash, pack, MODEL_TRANSACTION_METADATA);
+}
+
+retcode_t storage_transactions_load_partial(storage_connection_t const* const connection,
+                                            hash243_queue_t const hashes, iota_stor_pack_t* const pack,
+                                            storage_load_model_t const model) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  storage_batch_t batch;
+  MDB_txn* txn = NULL;
+  MDB_val record;
+  MDB_val metadata;
+  bool found = false;
+  size_t position = 0;
+
+  if (model == MODEL_HASH || model == MODEL_MILESTONE) {
+    return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  if ((ret = storage_batch_pack_prepare(pack, hash243_queue_count(hashes))) != RC_OK || pack->num_loaded == 0) {
+    return ret;
+  }
+
+  if ((ret = storage_batch_init(&batch, hashes)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = begin_read_transaction(lmdb_connection, &txn)) != RC_OK) {
+    goto done;
+  }
+
+  // Sorted lookups walk the B-tree in key order and duplicates are read once
+  for (size_t i = 0; i < batch.size; i++) {
+    position = batch.entries[i].position;
+    if (i > 0 && memcmp(batch.entries[i].hash, batch.entries[i - 1].hash, FLEX_TRIT_SIZE_243) == 0) {
+      memcpy(pack->models[position], pack->models[batch.entries[i - 1].position], sizeof(iota_transaction_t));
+      continue;
+    }
+    if ((ret = transaction_get_model(lmdb_connection, txn, batch.entries[i].hash, model, &record, &metadata,
+                                     &found)) != RC_OK) {
+      break;
+    }
+    if (found) {
+      transaction_populate_model(&record, &metadata, batch.entries[i].hash, pack->models[position], model);
+    }
+  }
+
+  end_read_transaction(txn);
+
+done:
+  storage_batch_destroy(&batch);
+
+  return ret;
+}
+
+retcode_t storage_transaction_load_hashes(storage_connection_t const* const connection,
+                                          storage_transaction_field_t const field, flex_trit_t const* const key,
+                                          iota_stor_pack_t* const pack) {
+  scan_params_t params = {.pack = pack};
+
+  if (field != TRANSACTION_FIELD_ADDRESS) {
+    return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  return scan_prefix(connection, LMDB_KEYSPACE_ADDRESS, key, FLEX_TRIT_SIZE_243, load_hash_do_func, &params);
+}
+
+retcode_t storage_transaction_load_hashes_of_approvers(storage_connection_t const* const connection,
+                                                       flex_trit_t const* const approvee_hash,
+                                                       iota_stor_pack_t* const pack, uint64_t before_timestamp) {
+  scan_params_t params = {.pack = pack, .before_timestamp = before_timestamp};
+
+  return scan_prefix(connection, LMDB_KEYSPACE_APPROVER, approvee_hash, FLEX_TRIT_SIZE_243, load_approver_do_func,
+                     &params);
+}
+
+retcode_t storage_transaction_load_hashes_of_milestone_candidates(storage_connection_t const* const connection,
+                                                                  flex_trit_t const* const coordinator,
+                                                                  iota_stor_pack_t* const pack) {
+  scan_params_t params = {.pack = pack};
+
+  return scan_prefix(connection, LMDB_KEYSPACE_ADDRESS, coordinator, FLEX_TRIT_SIZE_243,
+                     load_milestone_candidate_do_func, &params);
+}
+
+retcode_t storage_transaction_update_snapshot_index(storage_connection_t const* const connection,
+                                                    flex_trit_t const* const hash, uint64_t const snapshot_index) {
+  return transaction_update(connection, hash, METADATA_SNAPSHOT_INDEX, snapshot_index);
+}
+
+retcode_t storage_transaction_update_solidity(storage_connection_t const* const connection,
+                                              flex_trit_t const* const hash, bool const is_solid) {
+  return transaction_update(connection, hash, METADATA_SOLID, is_solid);
+}
+
+retcode_t storage_transaction_update_validity(storage_connection_t const* const connection,
+                                              flex_trit_t const* const hash, bundle_status_t const validity) {
+  return transaction_update(connection, hash, METADATA_VALIDITY, validity);
+}
+
+retcode_t storage_transactions_update_snapshot_index(storage_connection_t const* const connection,
+                                                     hash243_set_t const hashes, uint64_t const snapshot_index) {
+  return transactions_update(connection, hashes, METADATA_SNAPSHOT_INDEX, snapshot_index);
+}
+
+retcode_t storage_transactions_update_solidity(storage_connection_t const* const connection, hash243_set_t const hashes,
+                                               bool const is_solid) {
+  return transactions_update(connection, hashes, METADATA_SOLID, is_solid);
+}
+
+retcode_t storage_transaction_exist(storage_connection_t const* const connection,
+                                    storage_transaction_field_t const field, flex_trit_t const* const key,
+                                    bool* const exist) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  uint64_t count = 0;
+
+  if (field != TRANSACTION_FIELD_NONE && field != TRANSACTION_FIELD_HASH) {
+    return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  if ((ret = begin_read_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (field == TRANSACTION_FIELD_HASH && key) {
+    ret = kv_exist(txn, lmdb_connection->dbis[LMDB_KEYSPACE_TRANSACTION], key, FLEX_TRIT_SIZE_243, exist);
+  } else if ((ret = kv_count(txn, lmdb_connection->dbis[LMDB_KEYSPACE_TRANSACTION], &count)) == RC_OK) {
+    *exist = count != 0;
+  }
+
+  end_read_transaction(txn);
+
+  return ret;
+}
+
+retcode_t storage_transaction_approvers_count(storage_connection_t const* const connection,
+                                              flex_trit_t const* const hash, uint64_t* const count) {
+  retcode_t ret = RC_OK;
+  scan_params_t params = {.pack = NULL, .count = 0};
+
+  if ((ret = scan_prefix(connection, LMDB_KEYSPACE_APPROVER, hash, FLEX_TRIT_SIZE_243, count_do_func, &params)) !=
+      RC_OK) {
+    return ret;
+  }
+  *count = params.count;
+
+  return RC_OK;
+}
+
+typedef struct find_params_s {
+  scan_params_t scan;
+  hash243_queue_t bundles;
+  hash243_queue_t addresses;
+  hash81_queue_t tags;
+  hash243_queue_t approvees;
+  hash243_set_t found;
+} find_params_t;
+
+static bool hash243_queue_has(hash243_queue_t const queue, flex_trit_t const* const hash) {
+  hash243_queue_entry_t* iter = NULL;
+
+  CDL_FOREACH(queue, iter) {
+    if (memcmp(iter->hash, hash, FLEX_TRIT_SIZE_243) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool hash81_queue_has(hash81_queue_t const queue, flex_trit_t const* const hash) {
+  hash81_queue_entry_t* iter = NULL;
+
+  CDL_FOREACH(queue, iter) {
+    if (memcmp(iter->hash, hash, FLEX_TRIT_SIZE_81) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static retcode_t find_do_func(void* const arg, MDB_val const* const key, MDB_val const* const value,
+                              bool* const stop) {
+  find_params_t* params = (find_params_t*)arg;
+  flex_trit_t const* hash = key_hash(key);
+  retcode_t ret = RC_OK;
+  MDB_val record;
+  flex_trit_t const* bytes = NULL;
+  bool found = false;
+  UNUSED(value);
+
+  if (hash243_set_contains(params->found, hash)) {
+    return RC_OK;
+  }
+
+  if ((ret = kv_get(params->scan.txn, params->scan.connection->dbis[LMDB_KEYSPACE_TRANSACTION], hash,
+                    FLEX_TRIT_SIZE_243, &record, &found)) != RC_OK ||
+      !found) {
+    return ret;
+  }
+  bytes = record.mv_data;
+
+  // Every non-empty criterion has to be matched
+  if ((params->bundles && !hash243_queue_has(params->bundles, bytes + RECORD_BUNDLE)) ||
+      (params->addresses && !hash243_queue_has(params->addresses, bytes + RECORD_ADDRESS)) ||
+      (params->tags && !hash81_queue_has(params->tags, bytes + RECORD_TAG)) ||
+      (params->approvees && !hash243_queue_has(params->approvees, bytes + RECORD_TRUNK) &&
+       !hash243_queue_has(params->approvees, bytes + RECORD_BRANCH))) {
+    return RC_OK;
+  }
+
+  if (!pack_append_hash(params->scan.pack, hash)) {
+    *stop = true;
+    return RC_OK;
+  }
+
+  return hash243_set_add(&params->found, hash);
+}
+
+retcode_t storage_transaction_find(storage_connection_t const* const connection, hash243_queue_t const bundles,
+                                   hash243_queue_t const addresses, hash81_queue_t const tags,
+                                   hash243_queue_t const approvees, iota_stor_pack_t* const pack) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  find_params_t params = {.scan = {.connection = lmdb_connection, .pack = pack},
+                          .bundles = bundles,
+                          .addresses = addresses,
+                          .tags = tags,
+                          .approvees = approvees,
+                          .found = NULL};
+  hash243_queue_entry_t* iter243 = NULL;
+  hash81_queue_entry_t* iter81 = NULL;
+  MDB_dbi dbi = 0;
+  hash243_queue_t keys = NULL;
+
+  pack->insufficient_capacity = false;
+
+  if ((ret = begin_read_transaction(lmdb_connection, &params.scan.txn)) != RC_OK) {
+    return ret;
+  }
+
+  // Candidates are scanned from the first non-empty criterion and filtered by the others
+  if (bundles) {
+    dbi = lmdb_connection->dbis[LMDB_KEYSPACE_BUNDLE];
+    keys = bundles;
+  } else if (addresses) {
+    dbi = lmdb_connection->dbis[LMDB_KEYSPACE_ADDRESS];
+    keys = addresses;
+  } else if (approvees) {
+    dbi = lmdb_connection->dbis[LMDB_KEYSPACE_APPROVER];
+    keys = approvees;
+  }
+
+  if (keys) {
+    CDL_FOREACH(keys, iter243) {
+      if ((ret = kv_scan_prefix(params.scan.txn, dbi, iter243->hash, FLEX_TRIT_SIZE_243, find_do_func, &params)) !=
+              RC_OK ||
+          pack->insufficient_capacity) {
+        break;
+      }
+    }
+  } else if (tags) {
+    CDL_FOREACH(tags, iter81) {
+      if ((ret = kv_scan_prefix(params.scan.txn, lmdb_connection->dbis[LMDB_KEYSPACE_TAG], iter81->hash,
+                                FLEX_TRIT_SIZE_81, find_do_func, &params)) != RC_OK ||
+          pack->insufficient_capacity) {
+        break;
+      }
+    }
+  } else {
+    ret = kv_scan_prefix(params.scan.txn, lmdb_connection->dbis[LMDB_KEYSPACE_TRANSACTION], NULL, 0, find_do_func,
+                         &params);
+  }
+
+  end_read_transaction(params.scan.txn);
+  hash243_set_free(&params.found);
+
+  return ret;
+}
+
+retcode_t storage_transaction_delete(storage_connection_t const* const connection, flex_trit_t const* const hash) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  ret = transaction_del(lmdb_connection, txn, hash);
+
+  return end_write_transaction(txn, ret);
+}
+
+retcode_t storage_transactions_metadata_clear(storage_connection_t const* const connection) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_cursor* cursor = NULL;
+  MDB_val key;
+  MDB_val value;
+  uint8_t metadata[METADATA_SIZE];
+  int rc = 0;
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (mdb_cursor_open(txn, lmdb_connection->dbis[LMDB_KEYSPACE_TRANSACTION_METADATA], &cursor) != MDB_SUCCESS) {
+    return end_write_transaction(txn, RC_STORAGE_FAILED_EXECUTE);
+  }
+
+  for (rc = mdb_cursor_get(cursor, &key, &value, MDB_FIRST); rc == MDB_SUCCESS;
+       rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT)) {
+    // Only the arrival timestamp is kept
+    memset(metadata, 0, METADATA_ARRIVAL_TIMESTAMP);
+    memcpy(metadata + METADATA_ARRIVAL_TIMESTAMP, (uint8_t*)value.mv_data + METADATA_ARRIVAL_TIMESTAMP,
+           sizeof(uint64_t));
+    value.mv_size = METADATA_SIZE;
+    value.mv_data = metadata;
+    if ((rc = mdb_cursor_put(cursor, &key, &value, MDB_CURRENT)) != MDB_SUCCESS) {
+      break;
+    }
+  }
+  if (rc != MDB_NOTFOUND) {
+    ret = RC_STORAGE_FAILED_EXECUTE;
+  }
+
+  mdb_cursor_close(cursor);
+
+  return end_write_transaction(txn, ret);
+}
+
+retcode_t storage_transactions_delete(storage_connection_t const* const connection, hash243_set_t const hashes) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  hash243_set_entry_t* iter = NULL;
+  hash243_set_entry_t* tmp = NULL;
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  HASH_ITER(hh, hashes, iter, tmp) {
+    if ((ret = transaction_del(lmdb_connection, txn, iter->hash)) != RC_OK) {
+      break;
+    }
+  }
+
+  return end_write_transaction(txn, ret);
+}
+
+retcode_t storage_compact(storage_connection_t const* const connection, size_t const pages) {
+  UNUSED(connection);
+  UNUSED(pages);
+
+  // Pages freed by deletions are reused by later writes, the map file itself never shrinks
+  return RC_OK;
+}
+
+/*
+ * Cursor operations
+ */
+
+// Initial capacity of the pack find cursors load their hashes in
+#define CURSOR_FIND_CAPACITY 64
+
+typedef struct lmdb_cursor_s {
+  lmdb_keyspace_t keyspace;
+  lmdb_scan_func func;
+  flex_trit_t prefix[FLEX_TRIT_SIZE_243];
+  size_t prefix_size;
+  // Where the next scan starts: the key of the last loaded entry followed by a null byte, which sorts right after it
+  uint8_t start[INDEX_KEY_SIZE_MAX + 1];
+  size_t start_size;
+  // Find results are deduplicated across criteria so find cursors load all their hashes when opened
+  bool buffered;
+  iota_stor_pack_t found;
+  size_t found_offset;
+} lmdb_cursor_t;
+
+retcode_t storage_cursor_open(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                              storage_cursor_query_t const query, flex_trit_t const* const key,
+                              storage_load_model_t const model) {
+  lmdb_cursor_t* lmdb_cursor = NULL;
+  lmdb_keyspace_t keyspace = LMDB_KEYSPACE_ADDRESS;
+  lmdb_scan_func func = NULL;
+  size_t prefix_size = FLEX_TRIT_SIZE_243;
+
+  switch (query) {
+    case CURSOR_QUERY_TRANSACTIONS:
+      // Transactions are keyed by their hash alone and scanned from the first one
+      keyspace = LMDB_KEYSPACE_TRANSACTION;
+      func = load_hash_do_func;
+      prefix_size = 0;
+      break;
+    case CURSOR_QUERY_ADDRESS:
+      func = load_hash_do_func;
+      break;
+    case CURSOR_QUERY_APPROVERS:
+      keyspace = LMDB_KEYSPACE_APPROVER;
+      func = load_approver_do_func;
+      break;
+    case CURSOR_QUERY_MILESTONE_CANDIDATES:
+      func = load_milestone_candidate_do_func;
+      break;
+    default:
+      return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  if (model == MODEL_MILESTONE) {
+    return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  if ((lmdb_cursor = (lmdb_cursor_t*)calloc(1, sizeof(lmdb_cursor_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  lmdb_cursor->keyspace = keyspace;
+  lmdb_cursor->func = func;
+  if (prefix_size != 0) {
+    memcpy(lmdb_cursor->prefix, key, prefix_size);
+    memcpy(lmdb_cursor->start, key, prefix_size);
+  }
+  lmdb_cursor->prefix_size = prefix_size;
+  lmdb_cursor->start_size = prefix_size;
+
+  cursor->connection = connection;
+  cursor->model = model;
+  cursor->exhausted = false;
+  cursor->actual = lmdb_cursor;
+
+  return RC_OK;
+}
+
+retcode_t storage_cursor_find_open(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                                   hash243_queue_t const bundles, hash243_queue_t const addresses,
+                                   hash81_queue_t const tags, hash243_queue_t const approvees) {
+  retcode_t ret = RC_OK;
+  lmdb_cursor_t* lmdb_cursor = NULL;
+
+  if ((lmdb_cursor = (lmdb_cursor_t*)calloc(1, sizeof(lmdb_cursor_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  lmdb_cursor->buffered = true;
+  if ((ret = hash_pack_init(&lmdb_cursor->found, CURSOR_FIND_CAPACITY)) != RC_OK) {
+    goto done;
+  }
+
+  while ((ret = storage_transaction_find(connection, bundles, addresses, tags, approvees, &lmdb_cursor->found)) ==
+             RC_OK &&
+         lmdb_cursor->found.insufficient_capacity) {
+    if ((ret = hash_pack_resize(&lmdb_cursor->found, 2)) != RC_OK) {
+      break;
+    }
+    lmdb_cursor->found.num_loaded = 0;
+  }
+
+  cursor->connection = connection;
+  cursor->model = MODEL_HASH;
+  cursor->exhausted = false;
+  cursor->actual = lmdb_cursor;
+
+done:
+  if (ret != RC_OK) {
+    if (lmdb_cursor->found.models) {
+      hash_pack_free(&lmdb_cursor->found);
+    }
+    free(lmdb_cursor);
+  }
+  return ret;
+}
+
+retcode_t storage_cursor_next(storage_cursor_t* const cursor, iota_stor_pack_t* const pack) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)cursor->connection->actual;
+  lmdb_cursor_t* lmdb_cursor = (lmdb_cursor_t*)cursor->actual;
+  retcode_t ret = RC_OK;
+  scan_params_t params = {.connection = lmdb_connection, .pack = pack, .model = cursor->model};
+  flex_trit_t const* last = NULL;
+
+  pack->num_loaded = 0;
+  pack->insufficient_capacity = false;
+  if (cursor->model != MODEL_HASH) {
+    storage_batch_pack_reset(pack);
+  }
+
+  if (cursor->exhausted) {
+    return RC_OK;
+  }
+
+  if (lmdb_cursor->buffered) {
+    while (pack->num_loaded < pack->capacity && lmdb_cursor->found_offset < lmdb_cursor->found.num_loaded) {
+      memcpy(pack->models[pack->num_loaded++], lmdb_cursor->found.models[lmdb_cursor->found_offset++],
+             FLEX_TRIT_SIZE_243);
+    }
+    cursor->exhausted = lmdb_cursor->found_offset == lmdb_cursor->found.num_loaded;
+    return RC_OK;
+  }
+
+  // Every batch is scanned in its own read transaction so that an open cursor doesn't hold on to old pages
+  if ((ret = begin_read_transaction(lmdb_connection, &params.txn)) != RC_OK) {
+    return ret;
+  }
+  ret = kv_scan_prefix_from(params.txn, lmdb_connection->dbis[lmdb_cursor->keyspace], lmdb_cursor->prefix,
+                            lmdb_cursor->prefix_size, lmdb_cursor->start, lmdb_cursor->start_size, lmdb_cursor->func,
+                            &params);
+  end_read_transaction(params.txn);
+
+  if (ret != RC_OK) {
+    return ret;
+  }
+
+  // A scan only stops early when the pack is full
+  cursor->exhausted = !pack->insufficient_capacity;
+  pack->insufficient_capacity = false;
+
+  if (pack->num_loaded != 0) {
+    last = cursor->model == MODEL_HASH ? (flex_trit_t const*)pack->models[pack->num_loaded - 1]
+                                       : transaction_hash((iota_transaction_t*)pack->models[pack->num_loaded - 1]);
+    memcpy(lmdb_cursor->start + lmdb_cursor->prefix_size, last, FLEX_TRIT_SIZE_243);
+    lmdb_cursor->start[lmdb_cursor->prefix_size + FLEX_TRIT_SIZE_243] = 0;
+    lmdb_cursor->start_size = lmdb_cursor->prefix_size + FLEX_TRIT_SIZE_243 + 1;
+  }
+
+  return RC_OK;
+}
+
+retcode_t storage_cursor_close(storage_cursor_t* const cursor) {
+  lmdb_cursor_t* lmdb_cursor = (lmdb_cursor_t*)cursor->actual;
+
+  if (lmdb_cursor == NULL) {
+    return RC_OK;
+  }
+
+  if (lmdb_cursor->buffered) {
+    hash_pack_free(&lmdb_cursor->found);
+  }
+  free(lmdb_cursor);
+  cursor->actual = NULL;
+  cursor->exhausted = true;
+
+  return RC_OK;
+}
+
+/*
+ * Bundle operations
+ */
+
+retcode_t storage_bundle_update_validity(storage_connection_t const* const connection,
+                                         bundle_transactions_t const* const bundle, bundle_status_t const status) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  iota_transaction_t* tx = NULL;
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  BUNDLE_FOREACH(bundle, tx) {
+    if ((ret = metadata_update(lmdb_connection, txn, transaction_hash(tx), METADATA_VALIDITY, status)) != RC_OK) {
+      break;
+    }
+  }
+
+  return end_write_transaction(txn, ret);
+}
+
+/*
+ * Milestone operations
+ */
+
+static bool pack_append_milestone(iota_stor_pack_t* const pack, uint64_t const index, flex_trit_t const* const hash) {
+  iota_milestone_t* milestone = NULL;
+
+  if (pack->num_loaded == pack->capacity) {
+    pack->insufficient_capacity = true;
+    return false;
+  }
+  milestone = (iota_milestone_t*)pack->models[pack->num_loaded++];
+  milestone->index = index;
+  memcpy(milestone->hash, hash, FLEX_TRIT_SIZE_243);
+
+  return true;
+}
+
+// Loads the milestone positioned by a cursor operation on the index keyspace
+static retcode_t milestone_load_at(storage_connection_t const* const connection, MDB_cursor_op const op,
+                                   uint64_t const index, iota_stor_pack_t* const pack) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_cursor* cursor = NULL;
+  uint8_t index_bytes[sizeof(uint64_t)];
+  MDB_val key = {.mv_size = sizeof(uint64_t), .mv_data = index_bytes};
+  MDB_val value;
+  int rc = 0;
+
+  uint64_encode(index_bytes, index);
+  pack->insufficient_capacity = false;
+
+  if ((ret = begin_read_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (mdb_cursor_open(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE], &cursor) != MDB_SUCCESS) {
+    ret = RC_STORAGE_FAILED_EXECUTE;
+    goto done;
+  }
+
+  if ((rc = mdb_cursor_get(cursor, &key, &value, op)) == MDB_SUCCESS) {
+    pack_append_milestone(pack, uint64_decode(key.mv_data), value.mv_data);
+  } else if (rc != MDB_NOTFOUND) {
+    ret = RC_STORAGE_FAILED_EXECUTE;
+  }
+
+  mdb_cursor_close(cursor);
+
+done:
+  end_read_transaction(txn);
+  return ret;
+}
+
+retcode_t storage_milestone_clear(storage_connection_t const* const connection) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (mdb_drop(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE], 0) != MDB_SUCCESS ||
+      mdb_drop(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE_HASH], 0) != MDB_SUCCESS ||
+      mdb_drop(txn, lmdb_connection->dbis[LMDB_KEYSPACE_STATE_DELTA], 0) != MDB_SUCCESS) {
+    ret = RC_STORAGE_FAILED_EXECUTE;
+  }
+
+  return end_write_transaction(txn, ret);
+}
+
+retcode_t storage_milestone_store(storage_connection_t const* const connection,
+                                  iota_milestone_t const* const milestone) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  uint8_t index[sizeof(uint64_t)];
+
+  uint64_encode(index, milestone->index);
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = kv_put(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE], index, sizeof(uint64_t), milestone->hash,
+                    FLEX_TRIT_SIZE_243, false)) == RC_OK) {
+    ret = kv_put(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE_HASH], milestone->hash, FLEX_TRIT_SIZE_243, index,
+                 sizeof(uint64_t), false);
+  }
+
+  return end_write_transaction(txn, ret);
+}
+
+retcode_t storage_milestone_load(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                 iota_stor_pack_t* const pack) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val index;
+  bool found = false;
+
+  pack->insufficient_capacity = false;
+
+  if ((ret = begin_read_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = kv_get(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE_HASH], hash, FLEX_TRIT_SIZE_243, &index,
+                    &found)) == RC_OK &&
+      found) {
+    pack_append_milestone(pack, uint64_decode(index.mv_data), hash);
+  }
+
+  end_read_transaction(txn);
+
+  return ret;
+}
+
+retcode_t storage_milestone_load_last(storage_connection_t const* const connection, iota_stor_pack_t* const pack) {
+  return milestone_load_at(connection, MDB_LAST, 0, pack);
+}
+
+retcode_t storage_milestone_load_first(storage_connection_t const* const connection, iota_stor_pack_t* const pack) {
+  return milestone_load_at(connection, MDB_FIRST, 0, pack);
+}
+
+retcode_t storage_milestone_load_by_index(storage_connection_t const* const connection, uint64_t const index,
+                                          iota_stor_pack_t* const pack) {
+  return milestone_load_at(connection, MDB_SET_KEY, index, pack);
+}
+
+retcode_t storage_milestone_load_next(storage_connection_t const* const connection, uint64_t const index,
+                                      iota_stor_pack_t* const pack) {
+  if (index == UINT64_MAX) {
+    pack->insufficient_capacity = false;
+    return RC_OK;
+  }
+
+  return milestone_load_at(connection, MDB_SET_RANGE, index + 1, pack);
+}
+
+retcode_t storage_milestone_exist(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                  bool* const exist) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  uint64_t count = 0;
+
+  if ((ret = begin_read_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (hash) {
+    ret = kv_exist(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE_HASH], hash, FLEX_TRIT_SIZE_243, exist);
+  } else if ((ret = kv_count(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE], &count)) == RC_OK) {
+    *exist = count != 0;
+  }
+
+  end_read_transaction(txn);
+
+  return ret;
+}
+
+retcode_t storage_milestone_delete(storage_connection_t const* const connection, flex_trit_t const* const hash) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val value;
+  uint8_t index[sizeof(uint64_t)];
+  bool found = false;
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = kv_get(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE_HASH], hash, FLEX_TRIT_SIZE_243, &value,
+                    &found)) != RC_OK ||
+      !found) {
+    goto done;
+  }
+  memcpy(index, value.mv_data, sizeof(uint64_t));
+
+  if ((ret = kv_del(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE_HASH], hash, FLEX_TRIT_SIZE_243)) == RC_OK &&
+      (ret = kv_del(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE], index, sizeof(uint64_t))) == RC_OK) {
+    ret = kv_del(txn, lmdb_connection->dbis[LMDB_KEYSPACE_STATE_DELTA], index, sizeof(uint64_t));
+  }
+
+done:
+  return end_write_transaction(txn, ret);
+}
+
+/*
+ * State delta operations
+ */
+
+retcode_t storage_state_delta_store(storage_connection_t const* const connection, uint64_t const index,
+                                    state_delta_t const* const delta) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  uint8_t index_bytes[sizeof(uint64_t)];
+  size_t size = state_delta_serialized_size(delta);
+  byte_t* bytes = NULL;
+  bool exist = false;
+
+  uint64_encode(index_bytes, index);
+
+  if ((bytes = (byte_t*)calloc(size, sizeof(byte_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  if ((ret = state_delta_serialize(delta, bytes)) != RC_OK) {
+    goto done;
+  }
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    goto done;
+  }
+
+  // As with the SQL backends, deltas are only stored for existing milestones
+  if ((ret = kv_exist(txn, lmdb_connection->dbis[LMDB_KEYSPACE_MILESTONE], index_bytes, sizeof(uint64_t), &exist)) ==
+          RC_OK &&
+      exist) {
+    ret = kv_put(txn, lmdb_connection->dbis[LMDB_KEYSPACE_STATE_DELTA], index_bytes, sizeof(uint64_t), bytes, size,
+                 true);
+  }
+
+  ret = end_write_transaction(txn, ret);
+
+done:
+  free(bytes);
+  return ret;
+}
+
+retcode_t storage_state_delta_load(storage_connection_t const* const connection, uint64_t const index,
+                                   state_delta_t* const delta) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  uint8_t index_bytes[sizeof(uint64_t)];
+  MDB_val value;
+  bool found = false;
+
+  *delta = NULL;
+  uint64_encode(index_bytes, index);
+
+  if ((ret = begin_read_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = kv_get(txn, lmdb_connection->dbis[LMDB_KEYSPACE_STATE_DELTA], index_bytes, sizeof(uint64_t), &value,
+                    &found)) == RC_OK &&
+      found) {
+    ret = state_delta_deserialize(value.mv_data, value.mv_size, delta);
+  }
+
+  end_read_transaction(txn);
+
+  return ret;
+}
+
+/*
+ * Spent address operations
+ */
+
+retcode_t storage_spent_address_store(storage_connection_t const* const connection, flex_trit_t const* const address) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  ret = kv_put(txn, lmdb_connection->dbis[LMDB_KEYSPACE_SPENT_ADDRESS], address, FLEX_TRIT_SIZE_243, NULL, 0, true);
+
+  return end_write_transaction(txn, ret);
+}
+
+retcode_t storage_spent_addresses_store(storage_connection_t const* const connection, hash243_set_t const addresses) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  hash243_set_entry_t* iter = NULL;
+  hash243_set_entry_t* tmp = NULL;
+
+  if ((ret = begin_write_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  HASH_ITER(hh, addresses, iter, tmp) {
+    if ((ret = kv_put(txn, lmdb_connection->dbis[LMDB_KEYSPACE_SPENT_ADDRESS], iter->hash, FLEX_TRIT_SIZE_243, NULL, 0,
+                      true)) != RC_OK) {
+      break;
+    }
+  }
+
+  return end_write_transaction(txn, ret);
+}
+
+retcode_t storage_spent_address_exist(storage_connection_t const* const connection, flex_trit_t const* const address,
+                                      bool* const exist) {
+  lmdb_connection_t const* lmdb_connection = (lmdb_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+
+  if ((ret = begin_read_transaction(lmdb_connection, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  ret = kv_exist(txn, lmdb_connection->dbis[LMDB_KEYSPACE_SPENT_ADDRESS], address, FLEX_TRIT_SIZE_243, exist);
+
+  end_read_transaction(txn);
+
+  return ret;
+}
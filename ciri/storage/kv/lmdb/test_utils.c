@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ciri/storage/test_utils.h"
+#include "ciri/storage/kv/lmdb/connection.h"
+#include "ciri/utils/files.h"
+#include "utils/macros.h"
+
+#define LOCK_FILE_SUFFIX "-lock"
+
+retcode_t storage_test_setup(storage_connection_t* const connection, storage_connection_config_t const* const config,
+                             char const* const test_db_path, storage_connection_type_t const type) {
+  UNUSED(test_db_path);
+
+  // Keyspaces are created when the environment is opened, no schema is needed
+  return storage_connection_init(connection, config, type);
+}
+
+retcode_t storage_test_teardown(storage_connection_t* const connection, char const* const test_db_path,
+                                storage_connection_type_t const type) {
+  retcode_t ret = RC_OK;
+  char lock_path[FILENAME_MAX];
+  UNUSED(type);
+
+  if ((ret = storage_connection_destroy(connection)) != RC_OK) {
+    return ret;
+  }
+
+  if (strlen(test_db_path) + sizeof(LOCK_FILE_SUFFIX) > FILENAME_MAX) {
+    return RC_UTILS_FAILED_REMOVE_FILE;
+  }
+  strcpy(lock_path, test_db_path);
+  strcat(lock_path, LOCK_FILE_SUFFIX);
+
+  // LMDB keeps its reader table in a lock file next to the database file
+  if ((ret = iota_utils_remove_file(test_db_path)) != RC_OK) {
+    return ret;
+  }
+
+  return iota_utils_remove_file(lock_path);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include "ciri/storage/kv/lmdb/wrappers.h"
+
+static retcode_t begin_transaction(lmdb_connection_t const* const connection, unsigned int const flags,
+                                   MDB_txn** const txn) {
+  if (mdb_txn_begin(connection->env, NULL, flags, txn) != MDB_SUCCESS) {
+    return RC_STORAGE_FAILED_BEGIN;
+  }
+
+  return RC_OK;
+}
+
+retcode_t begin_read_transaction(lmdb_connection_t const* const connection, MDB_txn** const txn) {
+  return begin_transaction(connection, MDB_RDONLY, txn);
+}
+
+retcode_t begin_write_transaction(lmdb_connection_t const* const connection, MDB_txn** const txn) {
+  return begin_transaction(connection, 0, txn);
+}
+
+retcode_t end_write_transaction(MDB_txn* const txn, retcode_t const ret) {
+  if (ret != RC_OK) {
+    mdb_txn_abort(txn);
+    return ret;
+  }
+
+  if (mdb_txn_commit(txn) != MDB_SUCCESS) {
+    return RC_STORAGE_FAILED_END;
+  }
+
+  return RC_OK;
+}
+
+void end_read_transaction(MDB_txn* const txn) { mdb_txn_abort(txn); }
+
+retcode_t kv_get(MDB_txn* const txn, MDB_dbi const dbi, void const* const key, size_t const key_size,
+                 MDB_val* const value, bool* const found) {
+  MDB_val mdb_key = {.mv_size = key_size, .mv_data = (void*)key};
+  int rc = mdb_get(txn, dbi, &mdb_key, value);
+
+  *found = false;
+  if (rc == MDB_NOTFOUND) {
+    return RC_OK;
+  } else if (rc != MDB_SUCCESS) {
+    return RC_STORAGE_FAILED_EXECUTE;
+  }
+  *found = true;
+
+  return RC_OK;
+}
+
+retcode_t kv_exist(MDB_txn* const txn, MDB_dbi const dbi, void const* const key, size_t const key_size,
+                   bool* const exist) {
+  MDB_val value;
+
+  return kv_get(txn, dbi, key, key_size, &value, exist);
+}
+
+retcode_t kv_put(MDB_txn* const txn, MDB_dbi const dbi, void const* const key, size_t const key_size,
+                 void const* const value, size_t const value_size, bool const overwrite) {
+  MDB_val mdb_key = {.mv_size = key_size, .mv_data = (void*)key};
+  MDB_val mdb_value = {.mv_size = value_size, .mv_data = (void*)value};
+  int rc = mdb_put(txn, dbi, &mdb_key, &mdb_value, overwrite ? 0 : MDB_NOOVERWRITE);
+
+  if (rc == MDB_KEYEXIST) {
+    return RC_STORAGE_FAILED_INSERT_DB;
+  } else if (rc != MDB_SUCCESS) {
+    return RC_STORAGE_FAILED_EXECUTE;
+  }
+
+  return RC_OK;
+}
+
+retcode_t kv_del(MDB_txn* const txn, MDB_dbi const dbi, void const* const key, size_t const key_size) {
+  MDB_val mdb_key = {.mv_size = key_size, .mv_data = (void*)key};
+  int rc = mdb_del(txn, dbi, &mdb_key, NULL);
+
+  if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+    return RC_STORAGE_FAILED_EXECUTE;
+  }
+
+  return RC_OK;
+}
+
+retcode_t kv_scan_prefix(MDB_txn* const txn, MDB_dbi const dbi, void const* const prefix, size_t const prefix_size,
+                         lmdb_scan_func const func, void* const arg) {
+  return kv_scan_prefix_from(txn, dbi, prefix, prefix_size, prefix, prefix_size, func, arg);
+}
+
+retcode_t kv_scan_prefix_from(MDB_txn* const txn, MDB_dbi const dbi, void const* const prefix,
+                              size_t const prefix_size, void const* const start, size_t const start_size,
+                              lmdb_scan_func const func, void* const arg) {
+  retcode_t ret = RC_OK;
+  MDB_cursor* cursor = NULL;
+  MDB_val key = {.mv_size = start_size, .mv_data = (void*)start};
+  MDB_val value;
+  bool stop = false;
+  int rc = 0;
+
+  if (mdb_cursor_open(txn, dbi, &cursor) != MDB_SUCCESS) {
+    return RC_STORAGE_FAILED_EXECUTE;
+  }
+
+  rc = mdb_cursor_get(cursor, &key, &value, start_size == 0 ? MDB_FIRST : MDB_SET_RANGE);
+  while (rc == MDB_SUCCESS && key.mv_size >= prefix_size && memcmp(key.mv_data, prefix, prefix_size) == 0) {
+    if ((ret = func(arg, &key, &value, &stop)) != RC_OK || stop) {
+      break;
+    }
+    rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+  }
+
+  if (ret == RC_OK && rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+    ret = RC_STORAGE_FAILED_EXECUTE;
+  }
+
+  mdb_cursor_close(cursor);
+
+  return ret;
+}
+
+retcode_t kv_count(MDB_txn* const txn, MDB_dbi const dbi, uint64_t* const count) {
+  MDB_stat stat;
+
+  if (mdb_stat(txn, dbi, &stat) != MDB_SUCCESS) {
+    return RC_STORAGE_FAILED_EXECUTE;
+  }
+  *count = stat.ms_entries;
+
+  return RC_OK;
+}
+
+void uint64_encode(uint8_t* const bytes, uint64_t value) {
+  for (int i = sizeof(uint64_t) - 1; i >= 0; i--) {
+    bytes[i] = value & 0xFF;
+    value >>= 8;
+  }
+}
+
+uint64_t uint64_decode(uint8_t const* const bytes) {
+  uint64_t value = 0;
+
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    value = (value << 8) | bytes[i];
+  }
+
+  return value;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CIRI_STORAGE_KV_LMDB_WRAPPERS_H__
+#define __CIRI_STORAGE_KV_LMDB_WRAPPERS_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <lmdb.h>
+
+#include "ciri/storage/kv/lmdb/connection.h"
+#include "common/errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Called on every entry of a scan
+ *
+ * @param arg A user argument
+ * @param key The key of the entry, only valid during the call
+ * @param value The value of the entry, only valid during the call
+ * @param stop Set to true to stop the scan
+ *
+ * @return a status code, the scan stops on error
+ */
+typedef retcode_t (*lmdb_scan_func)(void* const arg, MDB_val const* const key, MDB_val const* const value,
+                                    bool* const stop);
+
+retcode_t begin_read_transaction(lmdb_connection_t const* const connection, MDB_txn** const txn);
+retcode_t begin_write_transaction(lmdb_connection_t const* const connection, MDB_txn** const txn);
+
+/**
+ * Ends a write transaction, committing it if ret is RC_OK and aborting it otherwise
+ *
+ * @param txn The transaction
+ * @param ret The status of the operations done in the transaction
+ *
+ * @return ret, or a status code if committing failed
+ */
+retcode_t end_write_transaction(MDB_txn* const txn, retcode_t const ret);
+void end_read_transaction(MDB_txn* const txn);
+
+retcode_t kv_get(MDB_txn* const txn, MDB_dbi const dbi, void const* const key, size_t const key_size,
+                 MDB_val* const value, bool* const found);
+retcode_t kv_exist(MDB_txn* const txn, MDB_dbi const dbi, void const* const key, size_t const key_size,
+                   bool* const exist);
+
+/**
+ * Puts an entry
+ *
+ * @param txn A write transaction
+ * @param dbi The keyspace
+ * @param key The key
+ * @param key_size The size of the key
+ * @param value The value, may be NULL if value_size is 0
+ * @param value_size The size of the value
+ * @param overwrite Whether an existing entry is overwritten, RC_STORAGE_FAILED_INSERT_DB is returned otherwise
+ *
+ * @return a status code
+ */
+retcode_t kv_put(MDB_txn* const txn, MDB_dbi const dbi, void const* const key, size_t const key_size,
+                 void const* const value, size_t const value_size, bool const overwrite);
+
+/**
+ * Deletes an entry, deleting a missing entry is not an error
+ */
+retcode_t kv_del(MDB_txn* const txn, MDB_dbi const dbi, void const* const key, size_t const key_size);
+
+/**
+ * Scans, in key order, all entries whose keys start with a prefix
+ *
+ * @param txn A transaction
+ * @param dbi The keyspace
+ * @param prefix The prefix, all entries are scanned if prefix_size is 0
+ * @param prefix_size The size of the prefix
+ * @param func Called on every entry
+ * @param arg Passed to func
+ *
+ * @return a status code
+ */
+retcode_t kv_scan_prefix(MDB_txn* const txn, MDB_dbi const dbi, void const* const prefix, size_t const prefix_size,
+                         lmdb_scan_func const func, void* const arg);
+
+/**
+ * Scans, in key order, the entries whose keys start with a prefix, from the first key greater than or equal to a start
+ * key, so that a scan stopped early can be resumed
+ *
+ * @param txn A transaction
+ * @param dbi The keyspace
+ * @param prefix The prefix, all entries are scanned if prefix_size is 0
+ * @param prefix_size The size of the prefix
+ * @param start The start key, starting with the prefix
+ * @param start_size The size of the start key
+ * @param func Called on every entry
+ * @param arg Passed to func
+ *
+ * @return a status code
+ */
+retcode_t kv_scan_prefix_from(MDB_txn* const txn, MDB_dbi const dbi, void const* const prefix,
+                              size_t const prefix_size, void const* const start, size_t const start_size,
+                              lmdb_scan_func const func, void* const arg);
+
+retcode_t kv_count(MDB_txn* const txn, MDB_dbi const dbi, uint64_t* const count);
+
+/**
+ * Big-endian encoding of integers so that the byte order of keys is their numerical order
+ */
+void uint64_encode(uint8_t* const bytes, uint64_t value);
+uint64_t uint64_decode(uint8_t const* const bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CIRI_STORAGE_KV_LMDB_WRAPPERS_H__
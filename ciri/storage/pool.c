@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ciri/storage/pool.h"
+#include "utils/time.h"
+
+retcode_t storage_pool_init(storage_pool_t *const pool, storage_connection_config_t const *const config,
+                            storage_connection_type_t const type, size_t const readers_max) {
+  retcode_t ret = RC_OK;
+  storage_connection_config_t writer_config = {.db_path = NULL, .read_only = false};
+
+  if (pool == NULL || config == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(pool, 0, sizeof(storage_pool_t));
+  pool->type = type;
+  pool->readers_max = readers_max;
+
+  if (config->db_path == NULL) {
+    return RC_STORAGE_NO_PATH_FOR_DB_SPECIFIED;
+  }
+
+  if ((pool->db_path = strdup(config->db_path)) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+
+  if (readers_max > 0 &&
+      ((pool->readers = (storage_connection_t *)calloc(readers_max, sizeof(storage_connection_t))) == NULL ||
+       (pool->readers_busy = (bool *)calloc(readers_max, sizeof(bool))) == NULL)) {
+    ret = RC_OOM;
+    goto done;
+  }
+
+  writer_config.db_path = pool->db_path;
+  if ((ret = storage_connection_init(&pool->writer, &writer_config, type)) != RC_OK) {
+    goto done;
+  }
+
+  lock_handle_init(&pool->lock);
+  lock_handle_init(&pool->writer_lock);
+
+done:
+  if (ret != RC_OK) {
+    free(pool->readers_busy);
+    free(pool->readers);
+    free(pool->db_path);
+    memset(pool, 0, sizeof(storage_pool_t));
+  }
+
+  return ret;
+}
+
+retcode_t storage_pool_destroy(storage_pool_t *const pool) {
+  retcode_t ret = RC_OK;
+
+  if (pool == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if (pool->db_path == NULL) {
+    return RC_OK;
+  }
+
+  for (size_t i = 0; i < pool->stats.readers_open; i++) {
+    ret |= storage_connection_destroy(&pool->readers[i]);
+  }
+  ret |= storage_connection_destroy(&pool->writer);
+
+  lock_handle_destroy(&pool->writer_lock);
+  lock_handle_destroy(&pool->lock);
+  free(pool->readers_busy);
+  free(pool->readers);
+  free(pool->db_path);
+  memset(pool, 0, sizeof(storage_pool_t));
+
+  return ret;
+}
+
+retcode_t storage_pool_reader_acquire(storage_pool_t *const pool, storage_connection_t *const reader) {
+  retcode_t ret = RC_OK;
+  storage_connection_config_t reader_config = {.db_path = pool->db_path, .read_only = true};
+  size_t i = 0;
+
+  lock_handle_lock(&pool->lock);
+
+  // Readers are opened in order so the opened ones are the first ones
+  for (i = 0; i < pool->stats.readers_open && pool->readers_busy[i]; i++) {
+  }
+
+  if (i == pool->readers_max) {
+    pool->stats.reader_exhaustions++;
+    ret = RC_STORAGE_POOL_EXHAUSTED;
+    goto done;
+  }
+
+  if (i == pool->stats.readers_open) {
+    if ((ret = storage_connection_init(&pool->readers[i], &reader_config, pool->type)) != RC_OK) {
+      goto done;
+    }
+    pool->stats.readers_open++;
+  }
+
+  pool->readers_busy[i] = true;
+  pool->stats.readers_in_use++;
+  pool->stats.reader_checkouts++;
+  *reader = pool->readers[i];
+
+done:
+  lock_handle_unlock(&pool->lock);
+
+  return ret;
+}
+
+retcode_t storage_pool_reader_release(storage_pool_t *const pool, storage_connection_t const *const reader) {
+  retcode_t ret = RC_STORAGE_POOL_UNKNOWN_CONNECTION;
+
+  lock_handle_lock(&pool->lock);
+
+  // Backends may share a handle between connections to the same database, any such reader can then be released
+  for (size_t i = 0; i < pool->stats.readers_open; i++) {
+    if (pool->readers[i].actual == reader->actual && pool->readers_busy[i]) {
+      pool->readers_busy[i] = false;
+      pool->stats.readers_in_use--;
+      ret = RC_OK;
+      break;
+    }
+  }
+
+  lock_handle_unlock(&pool->lock);
+
+  return ret;
+}
+
+storage_connection_t const *storage_pool_writer_acquire(storage_pool_t *const pool) {
+  bool busy = false;
+  uint64_t start = 0;
+
+  lock_handle_lock(&pool->lock);
+  busy = pool->writer_busy;
+  lock_handle_unlock(&pool->lock);
+
+  if (busy) {
+    start = current_timestamp_us();
+  }
+  lock_handle_lock(&pool->writer_lock);
+
+  lock_handle_lock(&pool->lock);
+  pool->writer_busy = true;
+  pool->stats.writer_checkouts++;
+  if (busy) {
+    pool->stats.writer_waits++;
+    pool->stats.writer_wait_us += current_timestamp_us() - start;
+  }
+  lock_handle_unlock(&pool->lock);
+
+  return &pool->writer;
+}
+
+void storage_pool_writer_release(storage_pool_t *const pool) {
+  lock_handle_lock(&pool->lock);
+  pool->writer_busy = false;
+  lock_handle_unlock(&pool->lock);
+
+  lock_handle_unlock(&pool->writer_lock);
+}
+
+void storage_pool_stats(storage_pool_t *const pool, storage_pool_stats_t *const stats) {
+  lock_handle_lock(&pool->lock);
+  *stats = pool->stats;
+  lock_handle_unlock(&pool->lock);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CIRI_STORAGE_POOL_H__
+#define __CIRI_STORAGE_POOL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ciri/storage/connection.h"
+#include "common/errors.h"
+#include "utils/handles/lock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct storage_pool_stats_s {
+  // Number of reader connections opened so far
+  size_t readers_open;
+  // Number of reader connections currently checked out
+  size_t readers_in_use;
+  uint64_t reader_checkouts;
+  // Reader checkouts refused because every reader was in use
+  uint64_t reader_exhaustions;
+  uint64_t writer_checkouts;
+  // Writer checkouts that found the writer in use and had to wait for it
+  uint64_t writer_waits;
+  uint64_t writer_wait_us;
+} storage_pool_stats_t;
+
+/**
+ * A pool of connections to a database
+ * Readers are opened read-only and lazily, up to a maximum, and each is used by a single checkout at a time; the only
+ * connection allowed to write is shared and serialized by a lock so that readers never contend with writers
+ */
+typedef struct storage_pool_s {
+  char *db_path;
+  storage_connection_type_t type;
+  lock_handle_t lock;
+  storage_connection_t *readers;
+  bool *readers_busy;
+  size_t readers_max;
+  storage_connection_t writer;
+  lock_handle_t writer_lock;
+  bool writer_busy;
+  storage_pool_stats_t stats;
+} storage_pool_t;
+
+/**
+ * Initializes a pool and opens its writer connection
+ *
+ * @param pool The pool
+ * @param config The configuration of the connections, read_only is ignored
+ * @param type The type of the connections
+ * @param readers_max The maximum number of reader connections
+ *
+ * @return a status code
+ */
+retcode_t storage_pool_init(storage_pool_t *const pool, storage_connection_config_t const *const config,
+                            storage_connection_type_t const type, size_t const readers_max);
+
+/**
+ * Destroys a pool and closes its connections, no connection should be checked out
+ *
+ * @param pool The pool
+ *
+ * @return a status code
+ */
+retcode_t storage_pool_destroy(storage_pool_t *const pool);
+
+/**
+ * Checks a reader connection out of a pool
+ *
+ * @param pool The pool
+ * @param reader Set to the reader connection
+ *
+ * @return RC_STORAGE_POOL_EXHAUSTED if every reader is in use, a status code otherwise
+ */
+retcode_t storage_pool_reader_acquire(storage_pool_t *const pool, storage_connection_t *const reader);
+
+/**
+ * Returns a reader connection to a pool
+ *
+ * @param pool The pool
+ * @param reader The reader connection
+ *
+ * @return a status code
+ */
+retcode_t storage_pool_reader_release(storage_pool_t *const pool, storage_connection_t const *const reader);
+
+/**
+ * Checks the writer connection out of a pool, waiting for it if needed
+ *
+ * @param pool The pool
+ *
+ * @return the writer connection
+ */
+storage_connection_t const *storage_pool_writer_acquire(storage_pool_t *const pool);
+
+/**
+ * Returns the writer connection to a pool
+ *
+ * @param pool The pool
+ */
+void storage_pool_writer_release(storage_pool_t *const pool);
+
+/**
+ * Gets the statistics of a pool
+ *
+ * @param pool The pool
+ * @param stats Filled with the statistics
+ */
+void storage_pool_stats(storage_pool_t *const pool, storage_pool_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CIRI_STORAGE_POOL_H__
@@ -144,6 +144,14 @@ static retcode_t finalize_tangle_statements(mariadb_tangle_connection_t* const c
   ret |= finalize_statement(connection->statements.milestone_delete_by_hash);
   ret |= finalize_statement(connection->statements.state_delta_store);
   ret |= finalize_statement(connection->statements.state_delta_load);
+  if (connection->transactions_insert_batch) {
+    ret |= finalize_statement(connection->transactions_insert_batch);
+  }
+  for (size_t i = 0; i < MARIADB_TRANSACTIONS_SELECT_MODELS_NUM; i++) {
+    if (connection->transactions_select_by_hashes[i]) {
+      ret |= finalize_statement(connection->transactions_select_by_hashes[i]);
+    }
+  }
 
   if (ret != RC_OK) {
     log_error(logger_id, "Finalizing tangle statements failed\n");
@@ -171,7 +179,6 @@ retcode_t storage_connection_init(storage_connection_t* const connection,
   retcode_t ret = RC_OK;
   MYSQL* db = NULL;
   char* database = NULL;
-  UNUSED(config);
 
   if (connection == NULL) {
     return RC_NULL_PARAM;
@@ -203,6 +210,11 @@ retcode_t storage_connection_init(storage_connection_t* const connection,
     return RC_STORAGE_FAILED_OPEN_DB;
   }
 
+  if (config->read_only && mysql_query(db, "SET SESSION TRANSACTION READ ONLY") != 0) {
+    log_error(logger_id, "Setting connection to database %s read-only failed: %s\n", database, mysql_error(db));
+    return RC_STORAGE_FAILED_CONFIG;
+  }
+
   if (type == STORAGE_CONNECTION_TANGLE) {
     ret = prepare_tangle_statements(connection->actual);
   } else if (type == STORAGE_CONNECTION_SPENT_ADDRESSES) {
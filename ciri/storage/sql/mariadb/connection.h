@@ -17,9 +17,15 @@
 extern "C" {
 #endif
 
+// Number of transaction models that can be loaded by batches of hashes
+#define MARIADB_TRANSACTIONS_SELECT_MODELS_NUM 5
+
 typedef struct mariadb_tangle_connection_s {
   MYSQL db;
   tangle_statements_t statements;
+  // Batch statements are prepared by the first operation needing them, readers never prepare the insert one
+  MYSQL_STMT* transactions_insert_batch;
+  MYSQL_STMT* transactions_select_by_hashes[MARIADB_TRANSACTIONS_SELECT_MODELS_NUM];
 } mariadb_tangle_connection_t;
 
 typedef struct mariadb_spent_addresses_connection_s {
@@ -7,6 +7,7 @@
 
 #include <mysql.h>
 
+#include "ciri/storage/batch.h"
 #include "ciri/storage/sql/mariadb/connection.h"
 #include "ciri/storage/sql/mariadb/wrappers.h"
 #include "ciri/storage/storage.h"
@@ -17,6 +18,18 @@
 #include "utils/time.h"
 
 #define MARIADB_LOGGER_ID "mariadb"
+#define MARIADB_TRANSACTION_INSERT_COLUMNS 17
+// Bulk writes (multi-row inserts and array binding) are only built with --define mariadb_bulk=true until they have
+// been run against a server, rows are otherwise written one statement execution at a time
+#ifdef STORAGE_MARIADB_BULK
+// Number of rows bound by a single execution of an array bound statement
+#define MARIADB_ARRAY_SIZE 256
+// Number of rows inserted by a single statement
+#define MARIADB_INSERT_ROWS STORAGE_STATEMENT_TRANSACTIONS_INSERT_BATCH_SIZE
+#else
+#define MARIADB_ARRAY_SIZE 1
+#define MARIADB_INSERT_ROWS 1
+#endif
 
 static logger_id_t logger_id;
 
@@ -58,6 +71,118 @@ static retcode_t mysql_stmt_bind_param_and_execute(MYSQL_STMT* const mariadb_sta
   return RC_OK;
 }
 
+#ifdef STORAGE_MARIADB_BULK
+static retcode_t mysql_stmt_bind_param_and_execute_array(MYSQL_STMT* const mariadb_statement, MYSQL_BIND* const bind,
+                                                         unsigned int const array_size) {
+  unsigned int const no_array = 0;
+  retcode_t ret = RC_OK;
+
+  if (mysql_stmt_attr_set(mariadb_statement, STMT_ATTR_ARRAY_SIZE, &array_size) != 0) {
+    log_statement_error(mariadb_statement);
+    return RC_STORAGE_FAILED_BINDING;
+  }
+
+  ret = mysql_stmt_bind_param_and_execute(mariadb_statement, bind);
+
+  // Connection statements are also executed with single rows
+  mysql_stmt_attr_set(mariadb_statement, STMT_ATTR_ARRAY_SIZE, &no_array);
+
+  return ret;
+}
+#endif
+
+/**
+ * Hashes bound as an array parameter of a statement, which is executed every time the array is full
+ * The other parameters of the statement are arrays of MARIADB_ARRAY_SIZE elements
+ */
+typedef struct hashes_array_s {
+  MYSQL_STMT* statement;
+  MYSQL_BIND* bind;
+  size_t index;
+  void* buffers[MARIADB_ARRAY_SIZE];
+  unsigned long lengths[MARIADB_ARRAY_SIZE];
+  unsigned int size;
+  bool compress;
+} hashes_array_t;
+
+static void hashes_array_init(hashes_array_t* const array, MYSQL_STMT* const mariadb_statement, MYSQL_BIND* const bind,
+                              size_t const index, bool const compress) {
+  array->statement = mariadb_statement;
+  array->bind = bind;
+  array->index = index;
+  array->size = 0;
+  array->compress = compress;
+  bind[index].buffer_type = MYSQL_TYPE_BLOB;
+#ifdef STORAGE_MARIADB_BULK
+  bind[index].buffer = (void*)array->buffers;
+  bind[index].length = array->lengths;
+#endif
+}
+
+static retcode_t hashes_array_flush(hashes_array_t* const array) {
+  retcode_t ret = RC_OK;
+
+  if (array->size == 0) {
+    return RC_OK;
+  }
+
+#ifdef STORAGE_MARIADB_BULK
+  ret = mysql_stmt_bind_param_and_execute_array(array->statement, array->bind, array->size);
+#else
+  // A single row whose hash is bound like any other parameter
+  array->bind[array->index].buffer = array->buffers[0];
+  array->bind[array->index].buffer_length = array->lengths[0];
+  ret = mysql_stmt_bind_param_and_execute(array->statement, array->bind);
+#endif
+  array->size = 0;
+
+  return ret;
+}
+
+static retcode_t hashes_array_push(hashes_array_t* const array, flex_trit_t const* const hash) {
+  array->buffers[array->size] = (void*)hash;
+  array->lengths[array->size] =
+      array->compress ? column_compress_length(hash, FLEX_TRIT_SIZE_243) : FLEX_TRIT_SIZE_243;
+
+  if (++array->size == MARIADB_ARRAY_SIZE) {
+    return hashes_array_flush(array);
+  }
+
+  return RC_OK;
+}
+
+static retcode_t hashes_array_execute(hashes_array_t* const array, hash243_set_t const hashes) {
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+  retcode_t ret = RC_OK;
+
+  HASH_SET_ITER(hashes, iter, tmp) {
+    if ((ret = hashes_array_push(array, iter->hash)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return hashes_array_flush(array);
+}
+
+/**
+ * Prepares a statement built on demand, which is freed
+ */
+static retcode_t prepare_built_statement(MYSQL* const db, MYSQL_STMT** const mariadb_statement, char* const statement) {
+  retcode_t ret = RC_OK;
+
+  if (statement == NULL) {
+    return RC_OOM;
+  }
+
+  if ((ret = prepare_statement(db, mariadb_statement, statement)) != RC_OK && *mariadb_statement != NULL) {
+    finalize_statement(*mariadb_statement);
+    *mariadb_statement = NULL;
+  }
+  free(statement);
+
+  return ret;
+}
+
 static retcode_t execute_statement_one_result(MYSQL_STMT* const mariadb_statement, void* const buffer,
                                               enum enum_field_types const buffer_type) {
   MYSQL_BIND bind[1];
@@ -216,6 +341,32 @@ static void storage_transaction_load_bind_metadata(MYSQL_BIND* const bind, iota_
   (*index)++;
 }
 
+static bool storage_transaction_load_bind_model(MYSQL_BIND* const bind, iota_transaction_t* const transaction,
+                                                storage_load_model_t const model, size_t* const index) {
+  if (model == MODEL_TRANSACTION) {
+    storage_transaction_load_bind_essence(bind, transaction, index);
+    storage_transaction_load_bind_attachment(bind, transaction, index);
+    storage_transaction_load_bind_consensus(bind, transaction, index);
+    storage_transaction_load_bind_data(bind, transaction, index);
+  } else if (model == MODEL_TRANSACTION_ESSENCE_METADATA) {
+    storage_transaction_load_bind_essence(bind, transaction, index);
+    storage_transaction_load_bind_metadata(bind, transaction, index);
+  } else if (model == MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA) {
+    storage_transaction_load_bind_essence(bind, transaction, index);
+    storage_transaction_load_bind_attachment(bind, transaction, index);
+    storage_transaction_load_bind_metadata(bind, transaction, index);
+  } else if (model == MODEL_TRANSACTION_ESSENCE_CONSENSUS) {
+    storage_transaction_load_bind_essence(bind, transaction, index);
+    storage_transaction_load_bind_consensus(bind, transaction, index);
+  } else if (model == MODEL_TRANSACTION_METADATA) {
+    storage_transaction_load_bind_metadata(bind, transaction, index);
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
 static retcode_t storage_transaction_load_generic(MYSQL_STMT* const mariadb_statement, MYSQL_BIND* const bind_out,
                                                   storage_load_model_t const model, flex_trit_t const* const hash,
                                                   iota_stor_pack_t* const pack) {
@@ -233,24 +384,7 @@ static retcode_t storage_transaction_load_generic(MYSQL_STMT* const mariadb_stat
 
   transaction_reset(transaction);
 
-  if (model == MODEL_TRANSACTION) {
-    storage_transaction_load_bind_essence(bind_out, transaction, &index);
-    storage_transaction_load_bind_attachment(bind_out, transaction, &index);
-    storage_transaction_load_bind_consensus(bind_out, transaction, &index);
-    storage_transaction_load_bind_data(bind_out, transaction, &index);
-  } else if (model == MODEL_TRANSACTION_ESSENCE_METADATA) {
-    storage_transaction_load_bind_essence(bind_out, transaction, &index);
-    storage_transaction_load_bind_metadata(bind_out, transaction, &index);
-  } else if (model == MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA) {
-    storage_transaction_load_bind_essence(bind_out, transaction, &index);
-    storage_transaction_load_bind_attachment(bind_out, transaction, &index);
-    storage_transaction_load_bind_metadata(bind_out, transaction, &index);
-  } else if (model == MODEL_TRANSACTION_ESSENCE_CONSENSUS) {
-    storage_transaction_load_bind_essence(bind_out, transaction, &index);
-    storage_transaction_load_bind_consensus(bind_out, transaction, &index);
-  } else if (model == MODEL_TRANSACTION_METADATA) {
-    storage_transaction_load_bind_metadata(bind_out, transaction, &index);
-  } else {
+  if (!storage_transaction_load_bind_model(bind_out, transaction, model, &index)) {
     return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
   }
 
@@ -321,19 +455,13 @@ static retcode_t storage_transaction_update_generic(MYSQL_STMT* const mariadb_st
   return RC_OK;
 }
 
-static retcode_t storage_hashes_load_generic(MYSQL_STMT* const mariadb_statement, iota_stor_pack_t* const pack) {
+static retcode_t storage_hashes_fetch_generic(MYSQL_STMT* const mariadb_statement, iota_stor_pack_t* const pack) {
   size_t i = 0;
   size_t length = 0;
   MYSQL_BIND bind[1];
   flex_trit_t hash[FLEX_TRIT_SIZE_243];
 
   memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
-
-  if (mysql_stmt_execute(mariadb_statement) != 0) {
-    log_statement_error(mariadb_statement);
-    return RC_STORAGE_FAILED_EXECUTE;
-  }
-
   memset(bind, 0, sizeof(bind));
 
   bind[0].buffer = (char*)hash;
@@ -361,6 +489,15 @@ static retcode_t storage_hashes_load_generic(MYSQL_STMT* const mariadb_statement
   return RC_OK;
 }
 
+static retcode_t storage_hashes_load_generic(MYSQL_STMT* const mariadb_statement, iota_stor_pack_t* const pack) {
+  if (mysql_stmt_execute(mariadb_statement) != 0) {
+    log_statement_error(mariadb_statement);
+    return RC_STORAGE_FAILED_EXECUTE;
+  }
+
+  return storage_hashes_fetch_generic(mariadb_statement, pack);
+}
+
 /**
  * Public functions
  */
@@ -390,15 +527,8 @@ retcode_t storage_transaction_count(storage_connection_t const* const connection
   return execute_statement_count(mariadb_statement, count);
 }
 
-retcode_t storage_transaction_store(storage_connection_t const* const connection,
-                                    iota_transaction_t const* const transaction) {
-  mariadb_tangle_connection_t const* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
-  MYSQL_STMT* mariadb_statement = mariadb_connection->statements.transaction_insert;
-  MYSQL_BIND bind[17];
-  uint64_t ts = current_timestamp_ms();
-
-  memset(bind, 0, sizeof(bind));
-
+static void storage_transaction_insert_bind(MYSQL_BIND* const bind, iota_transaction_t const* const transaction,
+                                            uint64_t const* const ts) {
   column_compress_bind(bind, 0, transaction->data.signature_or_message, MYSQL_TYPE_BLOB, FLEX_TRIT_SIZE_6561);
   column_compress_bind(bind, 1, transaction->essence.address, MYSQL_TYPE_BLOB, FLEX_TRIT_SIZE_243);
   column_compress_bind(bind, 2, &transaction->essence.value, MYSQL_TYPE_LONGLONG, -1);
@@ -415,7 +545,21 @@ retcode_t storage_transaction_store(storage_connection_t const* const connection
   column_compress_bind(bind, 13, &transaction->attachment.attachment_timestamp_lower, MYSQL_TYPE_LONGLONG, -1);
   column_compress_bind(bind, 14, transaction->attachment.nonce, MYSQL_TYPE_BLOB, FLEX_TRIT_SIZE_81);
   column_compress_bind(bind, 15, transaction->consensus.hash, MYSQL_TYPE_BLOB, FLEX_TRIT_SIZE_243);
-  column_compress_bind(bind, 16, &ts, MYSQL_TYPE_LONGLONG, -1);
+  column_compress_bind(bind, 16,
+                       transaction->metadata.arrival_timestamp != 0 ? &transaction->metadata.arrival_timestamp : ts,
+                       MYSQL_TYPE_LONGLONG, -1);
+}
+
+retcode_t storage_transaction_store(storage_connection_t const* const connection,
+                                    iota_transaction_t const* const transaction) {
+  mariadb_tangle_connection_t const* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
+  MYSQL_STMT* mariadb_statement = mariadb_connection->statements.transaction_insert;
+  MYSQL_BIND bind[MARIADB_TRANSACTION_INSERT_COLUMNS];
+  uint64_t ts = current_timestamp_ms();
+
+  memset(bind, 0, sizeof(bind));
+
+  storage_transaction_insert_bind(bind, transaction, &ts);
 
   if (mysql_stmt_bind_param_and_execute(mariadb_statement, bind) != 0) {
     return RC_STORAGE_FAILED_BINDING;
@@ -424,6 +568,67 @@ retcode_t storage_transaction_store(storage_connection_t const* const connection
   return RC_OK;
 }
 
+retcode_t storage_transactions_store(storage_connection_t const* const connection,
+                                     iota_transaction_t const* const transactions, size_t const count) {
+  mariadb_tangle_connection_t* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MYSQL_BIND* bind = NULL;
+  MYSQL_STMT* mariadb_statement = NULL;
+  MYSQL_STMT* remaining_statement = NULL;
+  uint64_t ts = current_timestamp_ms();
+  size_t rows = 0;
+
+  if (count == 0) {
+    return RC_OK;
+  }
+
+  if ((bind = (MYSQL_BIND*)calloc(MIN(count, MARIADB_INSERT_ROWS) * MARIADB_TRANSACTION_INSERT_COLUMNS,
+                                  sizeof(MYSQL_BIND))) == NULL) {
+    return RC_OOM;
+  }
+
+  if ((ret = start_transaction(&mariadb_connection->db)) != RC_OK) {
+    goto done;
+  }
+
+  // Bulk builds insert transactions by multi-row statements to save a round trip per transaction
+  for (size_t offset = 0; offset < count && ret == RC_OK; offset += rows) {
+    rows = MIN(MARIADB_INSERT_ROWS, count - offset);
+    if (rows == 1) {
+      mariadb_statement = mariadb_connection->statements.transaction_insert;
+    } else if (rows == STORAGE_STATEMENT_TRANSACTIONS_INSERT_BATCH_SIZE) {
+      if (mariadb_connection->transactions_insert_batch == NULL &&
+          (ret = prepare_built_statement(&mariadb_connection->db, &mariadb_connection->transactions_insert_batch,
+                                         storage_statement_transactions_insert_build(rows))) != RC_OK) {
+        break;
+      }
+      mariadb_statement = mariadb_connection->transactions_insert_batch;
+    } else {
+      // Only the last rows can be fewer than a batch, they are inserted by a statement of their own
+      if ((ret = prepare_built_statement(&mariadb_connection->db, &remaining_statement,
+                                         storage_statement_transactions_insert_build(rows))) != RC_OK) {
+        break;
+      }
+      mariadb_statement = remaining_statement;
+    }
+
+    for (size_t i = 0; i < rows; i++) {
+      storage_transaction_insert_bind(bind + i * MARIADB_TRANSACTION_INSERT_COLUMNS, &transactions[offset + i], &ts);
+    }
+    ret = mysql_stmt_bind_param_and_execute(mariadb_statement, bind);
+  }
+
+  ret = end_transaction(&mariadb_connection->db, ret);
+
+done:
+  if (remaining_statement) {
+    finalize_statement(remaining_statement);
+  }
+  free(bind);
+
+  return ret;
+}
+
 retcode_t storage_transaction_load(storage_connection_t const* const connection,
                                    storage_transaction_field_t const field, flex_trit_t const* const key,
                                    iota_stor_pack_t* const pack) {
@@ -483,6 +688,137 @@ retcode_t storage_transaction_load_metadata(storage_connection_t const* const co
   return storage_transaction_load_generic(mariadb_statement, bind_out, MODEL_TRANSACTION_METADATA, hash, pack);
 }
 
+static retcode_t storage_transactions_load_partial_chunk(MYSQL_STMT* const mariadb_statement,
+                                                         MYSQL_BIND* const bind_in, storage_batch_t const* const batch,
+                                                         size_t const offset, size_t const count,
+                                                         iota_stor_pack_t* const pack,
+                                                         storage_load_model_t const model) {
+  retcode_t ret = RC_OK;
+  MYSQL_BIND bind_out[17];
+  iota_transaction_t transaction;
+  field_mask_t mask;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  size_t hash_length = 0;
+  size_t first = 0, found = 0, index = 0;
+
+  memset(bind_in, 0, STORAGE_BATCH_CHUNK_SIZE * sizeof(MYSQL_BIND));
+  memset(bind_out, 0, sizeof(bind_out));
+
+  // The statement has a placeholder per hash of a full chunk, those left over by a shorter chunk match nothing
+  for (size_t i = 0; i < STORAGE_BATCH_CHUNK_SIZE; i++) {
+    if (i < count) {
+      column_compress_bind(bind_in, i, batch->entries[offset + i].hash, MYSQL_TYPE_BLOB, FLEX_TRIT_SIZE_243);
+    } else {
+      bind_in[i].buffer_type = MYSQL_TYPE_NULL;
+    }
+  }
+
+  if ((ret = mysql_stmt_bind_param_and_execute(mariadb_statement, bind_in)) != RC_OK) {
+    return ret;
+  }
+
+  // Rows are fetched in a single transaction whose columns are bound once and then copied to their positions
+  bind_out[index].buffer = (char*)hash;
+  bind_out[index].buffer_type = MYSQL_TYPE_BLOB;
+  bind_out[index].buffer_length = FLEX_TRIT_SIZE_243;
+  bind_out[index].length = &hash_length;
+  index++;
+  transaction_reset(&transaction);
+  storage_transaction_load_bind_model(bind_out, &transaction, model, &index);
+  mask = transaction.loaded_columns_mask;
+
+  if ((ret = mysql_stmt_bind_and_store_result(mariadb_statement, bind_out)) != RC_OK) {
+    return ret;
+  }
+
+  while (true) {
+    memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+    transaction_reset(&transaction);
+    if (mysql_stmt_fetch(mariadb_statement) != 0) {
+      break;
+    }
+    transaction.loaded_columns_mask = mask;
+    found = storage_batch_find(batch, hash, &first);
+    for (size_t i = first; i < first + found; i++) {
+      memcpy(pack->models[batch->entries[i].position], &transaction, sizeof(iota_transaction_t));
+    }
+  }
+
+  return RC_OK;
+}
+
+retcode_t storage_transactions_load_partial(storage_connection_t const* const connection,
+                                            hash243_queue_t const hashes, iota_stor_pack_t* const pack,
+                                            storage_load_model_t const model) {
+  mariadb_tangle_connection_t* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  storage_batch_t batch;
+  MYSQL_STMT** mariadb_statement = NULL;
+  MYSQL_BIND* bind_in = NULL;
+  char const* statement_format = NULL;
+  size_t count = 0;
+
+  switch (model) {
+    case MODEL_TRANSACTION:
+      statement_format = storage_statement_transactions_select_by_hashes;
+      mariadb_statement = &mariadb_connection->transactions_select_by_hashes[0];
+      break;
+    case MODEL_TRANSACTION_ESSENCE_METADATA:
+      statement_format = storage_statement_transactions_select_essence_metadata_by_hashes;
+      mariadb_statement = &mariadb_connection->transactions_select_by_hashes[1];
+      break;
+    case MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA:
+      statement_format = storage_statement_transactions_select_essence_attachment_metadata_by_hashes;
+      mariadb_statement = &mariadb_connection->transactions_select_by_hashes[2];
+      break;
+    case MODEL_TRANSACTION_ESSENCE_CONSENSUS:
+      statement_format = storage_statement_transactions_select_essence_consensus_by_hashes;
+      mariadb_statement = &mariadb_connection->transactions_select_by_hashes[3];
+      break;
+    case MODEL_TRANSACTION_METADATA:
+      statement_format = storage_statement_transactions_select_metadata_by_hashes;
+      mariadb_statement = &mariadb_connection->transactions_select_by_hashes[4];
+      break;
+    default:
+      return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  if ((ret = storage_batch_pack_prepare(pack, hash243_queue_count(hashes))) != RC_OK || pack->num_loaded == 0) {
+    return ret;
+  }
+
+  // A statement per model is prepared once for full chunks so that each chunk only costs its execution
+  if (*mariadb_statement == NULL &&
+      (ret = prepare_built_statement(
+           &mariadb_connection->db, mariadb_statement,
+           storage_statement_transactions_select_by_hashes_build(statement_format, STORAGE_BATCH_CHUNK_SIZE))) !=
+          RC_OK) {
+    return ret;
+  }
+
+  if ((bind_in = (MYSQL_BIND*)malloc(STORAGE_BATCH_CHUNK_SIZE * sizeof(MYSQL_BIND))) == NULL) {
+    return RC_OOM;
+  }
+
+  if ((ret = storage_batch_init(&batch, hashes)) != RC_OK) {
+    free(bind_in);
+    return ret;
+  }
+
+  for (size_t offset = 0; offset < batch.size; offset += count) {
+    count = MIN(STORAGE_BATCH_CHUNK_SIZE, batch.size - offset);
+    if ((ret = storage_transactions_load_partial_chunk(*mariadb_statement, bind_in, &batch, offset, count, pack,
+                                                       model)) != RC_OK) {
+      break;
+    }
+  }
+
+  storage_batch_destroy(&batch);
+  free(bind_in);
+
+  return ret;
+}
+
 retcode_t storage_transaction_exist(storage_connection_t const* const connection,
                                     storage_transaction_field_t const field, flex_trit_t const* const key,
                                     bool* const exist) {
@@ -647,12 +983,15 @@ retcode_t storage_transaction_approvers_count(storage_connection_t const* const
   return execute_statement_count(mariadb_statement, count);
 }
 
-retcode_t storage_transaction_find(storage_connection_t const* const connection, hash243_queue_t const bundles,
-                                   hash243_queue_t const addresses, hash81_queue_t const tags,
-                                   hash243_queue_t const approvees, iota_stor_pack_t* const pack) {
-  mariadb_tangle_connection_t const* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
+/**
+ * Prepares a find statement for the caller, binds the lists to it and executes it
+ * Bound buffers only have to outlive the execution, which is why binding and executing are not split
+ */
+static retcode_t find_statement_execute(mariadb_tangle_connection_t const* const mariadb_connection,
+                                        hash243_queue_t const bundles, hash243_queue_t const addresses,
+                                        hash81_queue_t const tags, hash243_queue_t const approvees,
+                                        MYSQL_STMT** const mariadb_statement) {
   retcode_t ret = RC_OK;
-  MYSQL_STMT* mariadb_statement = NULL;
   size_t bundles_count = hash243_queue_count(bundles);
   size_t addresses_count = hash243_queue_count(addresses);
   size_t tags_count = hash81_queue_count(tags);
@@ -660,36 +999,42 @@ retcode_t storage_transaction_find(storage_connection_t const* const connection,
   hash243_queue_entry_t* iter243 = NULL;
   hash81_queue_entry_t* iter81 = NULL;
   size_t column = 0;
+  bool if_bundles = !bundles_count;
+  bool if_addresses = !addresses_count;
+  bool if_tags = !tags_count;
+  bool if_approvees = !approvees_count;
   char* statement =
       storage_statement_transaction_find_build(bundles_count, addresses_count, tags_count, approvees_count);
-  MYSQL_BIND bind[50];
+  MYSQL_BIND* bind =
+      (MYSQL_BIND*)calloc(4 + bundles_count + addresses_count + tags_count + 2 * approvees_count, sizeof(MYSQL_BIND));
 
-  memset(bind, 0, sizeof(bind));
+  *mariadb_statement = NULL;
 
-  if ((ret = prepare_statement((MYSQL*)&mariadb_connection->db, &mariadb_statement, statement)) != RC_OK) {
+  if (statement == NULL || bind == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+
+  if ((ret = prepare_statement((MYSQL*)&mariadb_connection->db, mariadb_statement, statement)) != RC_OK) {
     goto done;
   }
 
-  bool if_bundles = !bundles_count;
   column_compress_bind(bind, column++, &if_bundles, MYSQL_TYPE_TINY, -1);
 
   CDL_FOREACH(bundles, iter243) {
     column_compress_bind(bind, column++, iter243->hash, MYSQL_TYPE_BLOB, FLEX_TRIT_SIZE_243);
   }
 
-  bool if_addresses = !addresses_count;
   column_compress_bind(bind, column++, &if_addresses, MYSQL_TYPE_TINY, -1);
 
   CDL_FOREACH(addresses, iter243) {
     column_compress_bind(bind, column++, iter243->hash, MYSQL_TYPE_BLOB, FLEX_TRIT_SIZE_243);
   }
 
-  bool if_tags = !tags_count;
   column_compress_bind(bind, column++, &if_tags, MYSQL_TYPE_TINY, -1);
 
   CDL_FOREACH(tags, iter81) { column_compress_bind(bind, column++, iter81->hash, MYSQL_TYPE_BLOB, FLEX_TRIT_SIZE_81); }
 
-  bool if_approvees = !approvees_count;
   column_compress_bind(bind, column++, &if_approvees, MYSQL_TYPE_TINY, -1);
 
   CDL_FOREACH(approvees, iter243) {
@@ -698,16 +1043,34 @@ retcode_t storage_transaction_find(storage_connection_t const* const connection,
     column++;
   }
 
-  if (mysql_stmt_bind_param(mariadb_statement, bind) != 0) {
-    log_statement_error(mariadb_statement);
-    return RC_STORAGE_FAILED_BINDING;
+  ret = mysql_stmt_bind_param_and_execute(*mariadb_statement, bind);
+
+done:
+  if (ret != RC_OK) {
+    finalize_statement(*mariadb_statement);
+    *mariadb_statement = NULL;
   }
+  free(bind);
+  free(statement);
 
-  ret = storage_hashes_load_generic(mariadb_statement, pack);
+  return ret;
+}
+
+retcode_t storage_transaction_find(storage_connection_t const* const connection, hash243_queue_t const bundles,
+                                   hash243_queue_t const addresses, hash81_queue_t const tags,
+                                   hash243_queue_t const approvees, iota_stor_pack_t* const pack) {
+  mariadb_tangle_connection_t const* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MYSQL_STMT* mariadb_statement = NULL;
+
+  if ((ret = find_statement_execute(mariadb_connection, bundles, addresses, tags, approvees, &mariadb_statement)) !=
+      RC_OK) {
+    return ret;
+  }
+
+  ret = storage_hashes_fetch_generic(mariadb_statement, pack);
 
-done:
   finalize_statement(mariadb_statement);
-  free(statement);
 
   return ret;
 }
@@ -743,18 +1106,25 @@ retcode_t storage_transactions_metadata_clear(storage_connection_t const* const
 retcode_t storage_transactions_update_snapshot_index(storage_connection_t const* const connection,
                                                      hash243_set_t const hashes, uint64_t const snapshot_index) {
   mariadb_tangle_connection_t const* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
-  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+  MYSQL_BIND bind[2];
+  uint64_t snapshot_indexes[MARIADB_ARRAY_SIZE];
+  hashes_array_t array;
   retcode_t ret = RC_OK;
 
+  memset(bind, 0, sizeof(bind));
+
+  for (size_t i = 0; i < MARIADB_ARRAY_SIZE; i++) {
+    snapshot_indexes[i] = snapshot_index;
+  }
+  bind[0].buffer = (void*)snapshot_indexes;
+  bind[0].buffer_type = MYSQL_TYPE_LONGLONG;
+  hashes_array_init(&array, mariadb_connection->statements.transaction_update_snapshot_index, bind, 1, true);
+
   if ((ret = start_transaction((MYSQL*)&mariadb_connection->db)) != RC_OK) {
     return ret;
   }
 
-  HASH_SET_ITER(hashes, iter, tmp) {
-    if ((ret = storage_transaction_update_snapshot_index(connection, iter->hash, snapshot_index)) != RC_OK) {
-      break;
-    }
-  }
+  ret = hashes_array_execute(&array, hashes);
 
   return end_transaction((MYSQL*)&mariadb_connection->db, ret);
 }
@@ -762,55 +1132,276 @@ retcode_t storage_transactions_update_snapshot_index(storage_connection_t const*
 retcode_t storage_transactions_update_solidity(storage_connection_t const* const connection, hash243_set_t const hashes,
                                                bool const is_solid) {
   mariadb_tangle_connection_t const* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
-  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+  MYSQL_BIND bind[2];
+  bool solids[MARIADB_ARRAY_SIZE];
+  hashes_array_t array;
   retcode_t ret = RC_OK;
 
+  memset(bind, 0, sizeof(bind));
+
+  for (size_t i = 0; i < MARIADB_ARRAY_SIZE; i++) {
+    solids[i] = is_solid;
+  }
+  bind[0].buffer = (void*)solids;
+  bind[0].buffer_type = MYSQL_TYPE_TINY;
+  hashes_array_init(&array, mariadb_connection->statements.transaction_update_solidity, bind, 1, true);
+
   if ((ret = start_transaction((MYSQL*)&mariadb_connection->db)) != RC_OK) {
     return ret;
   }
 
-  HASH_SET_ITER(hashes, iter, tmp) {
-    if ((ret = storage_transaction_update_solidity(connection, iter->hash, is_solid)) != RC_OK) {
-      break;
-    }
-  }
+  ret = hashes_array_execute(&array, hashes);
 
   return end_transaction((MYSQL*)&mariadb_connection->db, ret);
 }
 
 retcode_t storage_transactions_delete(storage_connection_t const* const connection, hash243_set_t const hashes) {
   mariadb_tangle_connection_t const* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
-  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+  MYSQL_BIND bind[1];
+  hashes_array_t array;
   retcode_t ret = RC_OK;
 
+  memset(bind, 0, sizeof(bind));
+
+  hashes_array_init(&array, mariadb_connection->statements.transaction_delete, bind, 0, true);
+
   if ((ret = start_transaction((MYSQL*)&mariadb_connection->db)) != RC_OK) {
     return ret;
   }
 
-  HASH_SET_ITER(hashes, iter, tmp) {
-    if ((ret = storage_transaction_delete(connection, iter->hash)) != RC_OK) {
+  ret = hashes_array_execute(&array, hashes);
+
+  return end_transaction((MYSQL*)&mariadb_connection->db, ret);
+}
+
+retcode_t storage_compact(storage_connection_t const* const connection, size_t const pages) {
+  UNUSED(connection);
+  UNUSED(pages);
+
+  // InnoDB purges deleted rows in the background and reuses their pages, only a full table rebuild would shrink files
+  return RC_OK;
+}
+
+/*
+ * Cursor operations
+ */
+
+typedef struct mariadb_cursor_s {
+  // A statement of the cursor whose result, stored by the client, is fetched as results are read
+  MYSQL_STMT* statement;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  size_t length;
+} mariadb_cursor_t;
+
+static retcode_t cursor_init(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                             storage_load_model_t const model, MYSQL_STMT* const mariadb_statement) {
+  mariadb_cursor_t* mariadb_cursor = NULL;
+  MYSQL_BIND bind[1];
+
+  if ((mariadb_cursor = (mariadb_cursor_t*)calloc(1, sizeof(mariadb_cursor_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  memset(bind, 0, sizeof(bind));
+
+  bind[0].buffer = (char*)mariadb_cursor->hash;
+  bind[0].buffer_type = MYSQL_TYPE_BLOB;
+  bind[0].buffer_length = FLEX_TRIT_SIZE_243;
+  bind[0].length = &mariadb_cursor->length;
+
+  if (mysql_stmt_bind_and_store_result(mariadb_statement, bind) != 0) {
+    free(mariadb_cursor);
+    return RC_STORAGE_FAILED_BINDING;
+  }
+
+  mariadb_cursor->statement = mariadb_statement;
+  cursor->connection = connection;
+  cursor->model = model;
+  cursor->exhausted = false;
+  cursor->actual = mariadb_cursor;
+
+  return RC_OK;
+}
+
+retcode_t storage_cursor_open(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                              storage_cursor_query_t const query, flex_trit_t const* const key,
+                              storage_load_model_t const model) {
+  mariadb_tangle_connection_t const* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MYSQL_STMT* mariadb_statement = NULL;
+  char const* statement = NULL;
+  size_t key_binds = 1;
+  MYSQL_BIND bind[2];
+
+  switch (query) {
+    case CURSOR_QUERY_TRANSACTIONS:
+      statement = storage_statement_transaction_select_hashes;
+      key_binds = 0;
+      break;
+    case CURSOR_QUERY_ADDRESS:
+      statement = storage_statement_transaction_select_hashes_by_address;
+      break;
+    case CURSOR_QUERY_APPROVERS:
+      statement = storage_statement_transaction_select_hashes_of_approvers;
+      key_binds = 2;
       break;
+    case CURSOR_QUERY_MILESTONE_CANDIDATES:
+      statement = storage_statement_transaction_select_hashes_of_milestone_candidates;
+      break;
+    default:
+      return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  if (model == MODEL_MILESTONE) {
+    return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  // Each cursor has its own statement so that several cursors can be open at once, e.g. during traversals
+  if ((ret = prepare_statement((MYSQL*)&mariadb_connection->db, &mariadb_statement, statement)) != RC_OK) {
+    return ret;
+  }
+
+  memset(bind, 0, sizeof(bind));
+
+  for (size_t i = 0; i < key_binds; i++) {
+    column_compress_bind(bind, i, key, MYSQL_TYPE_BLOB, FLEX_TRIT_SIZE_243);
+  }
+
+  if ((ret = mysql_stmt_bind_param_and_execute(mariadb_statement, bind)) == RC_OK) {
+    ret = cursor_init(connection, cursor, model, mariadb_statement);
+  }
+
+  if (ret != RC_OK) {
+    finalize_statement(mariadb_statement);
+  }
+  return ret;
+}
+
+retcode_t storage_cursor_find_open(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                                   hash243_queue_t const bundles, hash243_queue_t const addresses,
+                                   hash81_queue_t const tags, hash243_queue_t const approvees) {
+  mariadb_tangle_connection_t const* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  MYSQL_STMT* mariadb_statement = NULL;
+
+  if ((ret = find_statement_execute(mariadb_connection, bundles, addresses, tags, approvees, &mariadb_statement)) !=
+      RC_OK) {
+    return ret;
+  }
+
+  if ((ret = cursor_init(connection, cursor, MODEL_HASH, mariadb_statement)) != RC_OK) {
+    finalize_statement(mariadb_statement);
+  }
+  return ret;
+}
+
+retcode_t storage_cursor_next(storage_cursor_t* const cursor, iota_stor_pack_t* const pack) {
+  mariadb_cursor_t* mariadb_cursor = (mariadb_cursor_t*)cursor->actual;
+  retcode_t ret = RC_OK;
+  hash243_queue_t hashes = NULL;
+  hash243_queue_entry_t* iter = NULL;
+  iota_transaction_t* tx = NULL;
+  size_t count = 0;
+  size_t found = 0;
+  int rc = 0;
+
+  pack->num_loaded = 0;
+  pack->insufficient_capacity = false;
+  if (cursor->model != MODEL_HASH) {
+    storage_batch_pack_reset(pack);
+  }
+
+  while (!cursor->exhausted && count < pack->capacity) {
+    memset(mariadb_cursor->hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+    if ((rc = mysql_stmt_fetch(mariadb_cursor->statement)) == MYSQL_NO_DATA) {
+      cursor->exhausted = true;
+    } else if (rc != 0) {
+      log_statement_error(mariadb_cursor->statement);
+      ret = RC_STORAGE_FAILED_STORE_RESULT;
+      goto done;
+    } else if (cursor->model == MODEL_HASH) {
+      memcpy(pack->models[count++], mariadb_cursor->hash, FLEX_TRIT_SIZE_243);
+    } else if ((ret = hash243_queue_push(&hashes, mariadb_cursor->hash)) != RC_OK) {
+      goto done;
+    } else {
+      count++;
     }
   }
 
-  return end_transaction((MYSQL*)&mariadb_connection->db, ret);
+  if (cursor->model == MODEL_HASH || count == 0) {
+    pack->num_loaded = count;
+    goto done;
+  }
+
+  // Partial transactions are loaded by hashes, those deleted since the query was executed are left out
+  if ((ret = storage_transactions_load_partial(cursor->connection, hashes, pack, cursor->model)) != RC_OK) {
+    goto done;
+  }
+
+  count = 0;
+  CDL_FOREACH(hashes, iter) {
+    tx = (iota_transaction_t*)pack->models[count++];
+    if (tx->loaded_columns_mask.essence == 0 && tx->loaded_columns_mask.metadata == 0) {
+      continue;
+    }
+    if (tx != pack->models[found]) {
+      memcpy(pack->models[found], tx, sizeof(iota_transaction_t));
+    }
+    transaction_set_hash((iota_transaction_t*)pack->models[found++], iter->hash);
+  }
+  pack->num_loaded = found;
+
+done:
+  hash243_queue_free(&hashes);
+  return ret;
+}
+
+retcode_t storage_cursor_close(storage_cursor_t* const cursor) {
+  mariadb_cursor_t* mariadb_cursor = (mariadb_cursor_t*)cursor->actual;
+  retcode_t ret = RC_OK;
+
+  if (mariadb_cursor == NULL) {
+    return RC_OK;
+  }
+
+  ret = finalize_statement(mariadb_cursor->statement);
+  free(mariadb_cursor);
+  cursor->actual = NULL;
+  cursor->exhausted = true;
+
+  return ret;
 }
 
 retcode_t storage_bundle_update_validity(storage_connection_t const* const connection,
                                          bundle_transactions_t const* const bundle, bundle_status_t const status) {
   mariadb_tangle_connection_t const* mariadb_connection = (mariadb_tangle_connection_t*)connection->actual;
+  MYSQL_BIND bind[2];
+  uint8_t statuses[MARIADB_ARRAY_SIZE];
+  hashes_array_t array;
   retcode_t ret = RC_OK;
   iota_transaction_t* tx = NULL;
 
+  memset(bind, 0, sizeof(bind));
+
+  for (size_t i = 0; i < MARIADB_ARRAY_SIZE; i++) {
+    statuses[i] = status;
+  }
+  bind[0].buffer = (void*)statuses;
+  bind[0].buffer_type = MYSQL_TYPE_TINY;
+  hashes_array_init(&array, mariadb_connection->statements.transaction_update_validity, bind, 1, true);
+
   if ((ret = start_transaction((MYSQL*)&mariadb_connection->db)) != RC_OK) {
     return ret;
   }
 
   BUNDLE_FOREACH(bundle, tx) {
-    if ((ret = storage_transaction_update_validity(connection, transaction_hash(tx), status)) != RC_OK) {
+    if ((ret = hashes_array_push(&array, transaction_hash(tx))) != RC_OK) {
       break;
     }
   }
+  if (ret == RC_OK) {
+    ret = hashes_array_flush(&array);
+  }
 
   return end_transaction((MYSQL*)&mariadb_connection->db, ret);
 }
@@ -1134,18 +1725,20 @@ retcode_t storage_spent_address_exist(storage_connection_t const* const connecti
 retcode_t storage_spent_addresses_store(storage_connection_t const* const connection, hash243_set_t const addresses) {
   mariadb_spent_addresses_connection_t const* mariadb_connection =
       (mariadb_spent_addresses_connection_t*)connection->actual;
-  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+  MYSQL_BIND bind[1];
+  hashes_array_t array;
   retcode_t ret = RC_OK;
 
+  memset(bind, 0, sizeof(bind));
+
+  // Spent addresses are stored uncompressed
+  hashes_array_init(&array, mariadb_connection->statements.spent_address_insert, bind, 0, false);
+
   if ((ret = start_transaction((MYSQL*)&mariadb_connection->db)) != RC_OK) {
     return ret;
   }
 
-  HASH_SET_ITER(addresses, iter, tmp) {
-    if ((ret = storage_spent_address_store(connection, iter->hash)) != RC_OK) {
-      break;
-    }
-  }
+  ret = hashes_array_execute(&array, addresses);
 
   return end_transaction((MYSQL*)&mariadb_connection->db, ret);
 }
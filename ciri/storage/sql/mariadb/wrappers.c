@@ -72,16 +72,21 @@ retcode_t end_transaction(MYSQL* const db, retcode_t const ret) {
   return commit_transaction(db);
 }
 
-void column_compress_bind(MYSQL_BIND* const bind, size_t const index, void const* const data,
-                          enum enum_field_types const type, size_t const num_bytes) {
+unsigned long column_compress_length(void const* const data, size_t const num_bytes) {
   ssize_t i = num_bytes - 1;
 
+  for (; i >= 0 && ((flex_trit_t*)data)[i] == FLEX_TRIT_NULL_VALUE; --i) {
+  }
+
+  return i + 1;
+}
+
+void column_compress_bind(MYSQL_BIND* const bind, size_t const index, void const* const data,
+                          enum enum_field_types const type, size_t const num_bytes) {
   bind[index].buffer = (void*)data;
   bind[index].buffer_type = type;
   if (type == MYSQL_TYPE_BLOB) {
-    for (; i >= 0 && ((flex_trit_t*)data)[i] == FLEX_TRIT_NULL_VALUE; --i) {
-    }
-    bind[index].buffer_length = i + 1;
+    bind[index].buffer_length = column_compress_length(data, num_bytes);
   }
   bind[index].is_null = 0;
 }
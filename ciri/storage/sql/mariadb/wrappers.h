@@ -25,6 +25,8 @@ retcode_t commit_transaction(MYSQL* const db);
 retcode_t rollback_transaction(MYSQL* const db);
 retcode_t end_transaction(MYSQL* const db, retcode_t const ret);
 
+// Length of a blob without its trailing null trits, as stored by compressed binds
+unsigned long column_compress_length(void const* const data, size_t const num_bytes);
 void column_compress_bind(MYSQL_BIND* const bind, size_t const index, void const* const data,
                           enum enum_field_types const type, size_t const num_bytes);
 
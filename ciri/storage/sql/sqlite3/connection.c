@@ -21,6 +21,13 @@ static logger_id_t logger_id;
 
 static retcode_t prepare_tangle_statements(sqlite3_tangle_connection_t* const connection) {
   retcode_t ret = RC_OK;
+  char* transactions_delete = NULL;
+
+  // Temporary tables are private to the connection and writable even when the database is opened read-only
+  if (sqlite3_exec(connection->db, storage_statement_find_keys_create, NULL, NULL, NULL) != SQLITE_OK) {
+    log_error(logger_id, "Creating find keys table failed\n");
+    return RC_STORAGE_FAILED_EXECUTE;
+  }
 
   ret = prepare_statement(connection->db, (sqlite3_stmt**)(&connection->statements.transaction_insert),
                           storage_statement_transaction_insert);
@@ -91,6 +98,15 @@ static retcode_t prepare_tangle_statements(sqlite3_tangle_connection_t* const co
                            storage_statement_state_delta_store);
   ret |= prepare_statement(connection->db, (sqlite3_stmt**)(&connection->statements.state_delta_load),
                            storage_statement_state_delta_load);
+  ret |= prepare_statement(connection->db, &connection->find_keys_insert, storage_statement_find_keys_insert);
+  ret |= prepare_statement(connection->db, &connection->find_keys_clear, storage_statement_find_keys_clear);
+  if ((transactions_delete = storage_statement_transactions_select_by_hashes_build(
+           storage_statement_transactions_delete_by_hashes, STORAGE_STATEMENT_TRANSACTIONS_DELETE_BATCH_SIZE)) ==
+      NULL) {
+    return RC_OOM;
+  }
+  ret |= prepare_statement(connection->db, &connection->transactions_delete, transactions_delete);
+  free(transactions_delete);
 
   if (ret != RC_OK) {
     log_error(logger_id, "Preparing tangle statements failed\n");
@@ -148,6 +164,12 @@ static retcode_t finalize_tangle_statements(sqlite3_tangle_connection_t* const c
   ret |= finalize_statement(connection->statements.milestone_delete_by_hash);
   ret |= finalize_statement(connection->statements.state_delta_store);
   ret |= finalize_statement(connection->statements.state_delta_load);
+  ret |= finalize_statement(connection->find_keys_insert);
+  ret |= finalize_statement(connection->find_keys_clear);
+  ret |= finalize_statement(connection->transactions_delete);
+  for (size_t i = 0; i < connection->find_statements.size; i++) {
+    ret |= finalize_statement(connection->find_statements.entries[i].statement);
+  }
 
   if (ret != RC_OK) {
     log_error(logger_id, "Finalizing tangle statements failed\n");
@@ -202,7 +224,9 @@ retcode_t storage_connection_init(storage_connection_t* const connection,
     return RC_STORAGE_NO_PATH_FOR_DB_SPECIFIED;
   }
 
-  if ((rc = sqlite3_open_v2(config->db_path, db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX, NULL)) != SQLITE_OK) {
+  if ((rc = sqlite3_open_v2(config->db_path, db,
+                            (config->read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE) | SQLITE_OPEN_NOMUTEX,
+                            NULL)) != SQLITE_OK) {
     log_critical(logger_id, "Failed to open db on path: %s\n", config->db_path);
     return RC_STORAGE_FAILED_OPEN_DB;
   }
@@ -211,7 +235,14 @@ retcode_t storage_connection_init(storage_connection_t* const connection,
     return RC_STORAGE_FAILED_CONFIG;
   }
 
-  sql = "PRAGMA journal_mode = WAL;PRAGMA foreign_keys = ON";
+  // The journal mode is persistent and set by writers, read-only connections read the WAL without taking write locks
+  // They are not made query only, the read-only open flag already protects the database and find statements need to
+  // write their temporary table
+  if (config->read_only) {
+    sql = "PRAGMA temp_store = MEMORY";
+  } else {
+    sql = "PRAGMA journal_mode = WAL;PRAGMA foreign_keys = ON;PRAGMA temp_store = MEMORY";
+  }
 
   if ((rc = sqlite3_exec(*db, sql, NULL, NULL, &err_msg)) != SQLITE_OK) {
     sqlite3_free(err_msg);
@@ -8,6 +8,8 @@
 #ifndef __CIRI_STORAGE_SQL_SQLITE3_CONNECTION_H__
 #define __CIRI_STORAGE_SQL_SQLITE3_CONNECTION_H__
 
+#include <stdbool.h>
+
 #include <sqlite3.h>
 
 #include "ciri/storage/connection.h"
@@ -20,6 +22,14 @@ extern "C" {
 typedef struct sqlite3_tangle_connection_s {
   sqlite3* db;
   tangle_statements_t statements;
+  // Find statements prepared on demand and the statements filling the temporary table they match long lists against
+  storage_statement_find_cache_t find_statements;
+  sqlite3_stmt* find_keys_insert;
+  sqlite3_stmt* find_keys_clear;
+  // Set while an open find cursor holds its keys in the temporary table
+  bool find_keys_busy;
+  // Deletes STORAGE_STATEMENT_TRANSACTIONS_DELETE_BATCH_SIZE transactions at once
+  sqlite3_stmt* transactions_delete;
 } sqlite3_tangle_connection_t;
 
 typedef struct sqlite3_spent_addresses_connection_s {
@@ -8,10 +8,12 @@
 #include <assert.h>
 #include <inttypes.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 #include <sqlite3.h>
 
+#include "ciri/storage/batch.h"
 #include "ciri/storage/sql/sqlite3/connection.h"
 #include "ciri/storage/sql/sqlite3/wrappers.h"
 #include "ciri/storage/sql/statements.h"
@@ -39,8 +41,8 @@ retcode_t storage_init() {
     return RC_STORAGE_FAILED_CONFIG;
   }
 
-  // TODO - implement connections pool so no two threads
-  // will access db through same connection simultaneously
+  // Connections are never shared between threads at the same time: readers are checked out of the pool by a single
+  // thread and the writer is serialized by the pool lock
   if (sqlite3_config(SQLITE_CONFIG_MULTITHREAD) != SQLITE_OK) {
     return RC_STORAGE_FAILED_CONFIG;
   }
@@ -94,6 +96,37 @@ static void select_transactions_populate_data(sqlite3_stmt* const statement, iot
 static void select_transactions_populate_metadata(sqlite3_stmt* const statement, iota_transaction_t* const tx,
                                                   size_t* const index);
 
+static bool select_transactions_populate_model(sqlite3_stmt* const statement, iota_transaction_t* const tx,
+                                               storage_load_model_t const model, size_t* const index) {
+  if (model == MODEL_TRANSACTION) {
+    transaction_reset(tx);
+    select_transactions_populate_essence(statement, tx, index);
+    select_transactions_populate_attachment(statement, tx, index);
+    select_transactions_populate_consensus(statement, tx, index);
+    select_transactions_populate_data(statement, tx, index);
+  } else if (model == MODEL_TRANSACTION_ESSENCE_METADATA) {
+    transaction_reset(tx);
+    select_transactions_populate_essence(statement, tx, index);
+    select_transactions_populate_metadata(statement, tx, index);
+  } else if (model == MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA) {
+    transaction_reset(tx);
+    select_transactions_populate_essence(statement, tx, index);
+    select_transactions_populate_attachment(statement, tx, index);
+    select_transactions_populate_metadata(statement, tx, index);
+  } else if (model == MODEL_TRANSACTION_ESSENCE_CONSENSUS) {
+    transaction_reset(tx);
+    select_transactions_populate_essence(statement, tx, index);
+    select_transactions_populate_consensus(statement, tx, index);
+  } else if (model == MODEL_TRANSACTION_METADATA) {
+    transaction_reset(tx);
+    select_transactions_populate_metadata(statement, tx, index);
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
 static retcode_t execute_statement_load_gen(sqlite3_stmt* const sqlite_statement, iota_stor_pack_t* const pack,
                                             uint32_t const max_records, storage_load_model_t const model) {
   size_t index = 0;
@@ -112,32 +145,7 @@ static retcode_t execute_statement_load_gen(sqlite3_stmt* const sqlite_statement
     } else if (model == MODEL_MILESTONE) {
       select_milestones_populate_from_row(sqlite_statement, pack->models[pack->num_loaded]);
       pack->num_loaded++;
-    } else if (model == MODEL_TRANSACTION) {
-      transaction_reset(pack->models[pack->num_loaded]);
-      select_transactions_populate_essence(sqlite_statement, pack->models[pack->num_loaded], &index);
-      select_transactions_populate_attachment(sqlite_statement, pack->models[pack->num_loaded], &index);
-      select_transactions_populate_consensus(sqlite_statement, pack->models[pack->num_loaded], &index);
-      select_transactions_populate_data(sqlite_statement, pack->models[pack->num_loaded], &index);
-      pack->num_loaded++;
-    } else if (model == MODEL_TRANSACTION_ESSENCE_METADATA) {
-      transaction_reset(pack->models[pack->num_loaded]);
-      select_transactions_populate_essence(sqlite_statement, pack->models[pack->num_loaded], &index);
-      select_transactions_populate_metadata(sqlite_statement, pack->models[pack->num_loaded], &index);
-      pack->num_loaded++;
-    } else if (model == MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA) {
-      transaction_reset(pack->models[pack->num_loaded]);
-      select_transactions_populate_essence(sqlite_statement, pack->models[pack->num_loaded], &index);
-      select_transactions_populate_attachment(sqlite_statement, pack->models[pack->num_loaded], &index);
-      select_transactions_populate_metadata(sqlite_statement, pack->models[pack->num_loaded], &index);
-      pack->num_loaded++;
-    } else if (model == MODEL_TRANSACTION_ESSENCE_CONSENSUS) {
-      transaction_reset(pack->models[pack->num_loaded]);
-      select_transactions_populate_essence(sqlite_statement, pack->models[pack->num_loaded], &index);
-      select_transactions_populate_consensus(sqlite_statement, pack->models[pack->num_loaded], &index);
-      pack->num_loaded++;
-    } else if (model == MODEL_TRANSACTION_METADATA) {
-      transaction_reset(pack->models[pack->num_loaded]);
-      select_transactions_populate_metadata(sqlite_statement, pack->models[pack->num_loaded], &index);
+    } else if (select_transactions_populate_model(sqlite_statement, pack->models[pack->num_loaded], model, &index)) {
       pack->num_loaded++;
     } else {
       return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
@@ -334,10 +342,9 @@ done:
   return ret;
 }
 
-retcode_t storage_transaction_store(storage_connection_t const* const connection, iota_transaction_t const* const tx) {
-  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+static retcode_t bind_execute_transaction_insert(sqlite3_stmt* const sqlite_statement,
+                                                 iota_transaction_t const* const tx, int64_t const timestamp) {
   retcode_t ret = RC_OK;
-  sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_insert;
 
   if (column_compress_bind(sqlite_statement, 1, tx->data.signature_or_message, FLEX_TRIT_SIZE_6561) != RC_OK ||
       column_compress_bind(sqlite_statement, 2, tx->essence.address, FLEX_TRIT_SIZE_243) != RC_OK ||
@@ -355,20 +362,58 @@ retcode_t storage_transaction_store(storage_connection_t const* const connection
       sqlite3_bind_int64(sqlite_statement, 14, tx->attachment.attachment_timestamp_lower) != SQLITE_OK ||
       column_compress_bind(sqlite_statement, 15, tx->attachment.nonce, FLEX_TRIT_SIZE_81) != RC_OK ||
       column_compress_bind(sqlite_statement, 16, tx->consensus.hash, FLEX_TRIT_SIZE_243) != RC_OK ||
-      sqlite3_bind_int64(sqlite_statement, 17, current_timestamp_ms()) != SQLITE_OK) {
+      sqlite3_bind_int64(sqlite_statement, 17,
+                         tx->metadata.arrival_timestamp != 0 ? tx->metadata.arrival_timestamp : timestamp) !=
+          SQLITE_OK) {
     ret = RC_STORAGE_FAILED_BINDING;
     goto done;
   }
 
-  if ((ret = execute_statement(sqlite_statement)) != RC_OK) {
-    goto done;
-  }
+  ret = execute_statement(sqlite_statement);
 
 done:
   sqlite3_reset(sqlite_statement);
   return ret;
 }
 
+retcode_t storage_transaction_store(storage_connection_t const* const connection, iota_transaction_t const* const tx) {
+  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+
+  return bind_execute_transaction_insert(sqlite3_connection->statements.transaction_insert, tx, current_timestamp_ms());
+}
+
+retcode_t storage_transactions_store(storage_connection_t const* const connection,
+                                     iota_transaction_t const* const transactions, size_t const count) {
+  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+  sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_insert;
+  retcode_t ret = RC_OK;
+  retcode_t ret_rollback;
+  int64_t timestamp = current_timestamp_ms();
+
+  if (count == 0) {
+    return RC_OK;
+  }
+
+  if ((ret = begin_transaction(sqlite3_connection->db)) != RC_OK) {
+    return ret;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if ((ret = bind_execute_transaction_insert(sqlite_statement, &transactions[i], timestamp)) != RC_OK) {
+      break;
+    }
+  }
+
+  if (ret != RC_OK) {
+    if ((ret_rollback = rollback_transaction(sqlite3_connection->db)) != RC_OK) {
+      return ret_rollback;
+    }
+    return ret;
+  }
+
+  return end_transaction(sqlite3_connection->db);
+}
+
 retcode_t storage_transaction_load(storage_connection_t const* const connection,
                                    storage_transaction_field_t const field, flex_trit_t const* const key,
                                    iota_stor_pack_t* const pack) {
@@ -481,6 +526,103 @@ done:
   return ret;
 }
 
+static retcode_t transactions_load_partial_chunk(sqlite3* const db, char const* const statement_format,
+                                                 storage_batch_t const* const batch, size_t const offset,
+                                                 size_t const count, iota_stor_pack_t* const pack,
+                                                 storage_load_model_t const model) {
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  size_t first = 0, found = 0, index = 0;
+  int rc = 0;
+  char* statement = storage_statement_transactions_select_by_hashes_build(statement_format, count);
+
+  if (statement == NULL) {
+    return RC_OOM;
+  }
+
+  if ((ret = prepare_statement(db, &sqlite_statement, statement)) != RC_OK) {
+    goto done;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if (column_compress_bind(sqlite_statement, i + 1, batch->entries[offset + i].hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+      ret = RC_STORAGE_FAILED_BINDING;
+      goto done;
+    }
+  }
+
+  while ((rc = sqlite3_step(sqlite_statement)) == SQLITE_ROW) {
+    column_decompress_load(sqlite_statement, 0, hash, FLEX_TRIT_SIZE_243);
+    found = storage_batch_find(batch, hash, &first);
+    for (size_t i = first; i < first + found; i++) {
+      index = 1;
+      select_transactions_populate_model(sqlite_statement, pack->models[batch->entries[i].position], model, &index);
+    }
+  }
+
+  if (rc != SQLITE_DONE) {
+    ret = RC_STORAGE_FAILED_STEP;
+  }
+
+done:
+  finalize_statement(sqlite_statement);
+  free(statement);
+  return ret;
+}
+
+// Format of the statement selecting the hash and the columns of a model of transactions whose hash is in a clause
+static char const* transactions_select_in_format(storage_load_model_t const model) {
+  switch (model) {
+    case MODEL_TRANSACTION:
+      return storage_statement_transactions_select_by_hashes;
+    case MODEL_TRANSACTION_ESSENCE_METADATA:
+      return storage_statement_transactions_select_essence_metadata_by_hashes;
+    case MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA:
+      return storage_statement_transactions_select_essence_attachment_metadata_by_hashes;
+    case MODEL_TRANSACTION_ESSENCE_CONSENSUS:
+      return storage_statement_transactions_select_essence_consensus_by_hashes;
+    case MODEL_TRANSACTION_METADATA:
+      return storage_statement_transactions_select_metadata_by_hashes;
+    default:
+      return NULL;
+  }
+}
+
+retcode_t storage_transactions_load_partial(storage_connection_t const* const connection,
+                                            hash243_queue_t const hashes, iota_stor_pack_t* const pack,
+                                            storage_load_model_t const model) {
+  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  storage_batch_t batch;
+  char const* statement_format = transactions_select_in_format(model);
+  size_t count = 0;
+
+  if (statement_format == NULL) {
+    return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  if ((ret = storage_batch_pack_prepare(pack, hash243_queue_count(hashes))) != RC_OK || pack->num_loaded == 0) {
+    return ret;
+  }
+
+  if ((ret = storage_batch_init(&batch, hashes)) != RC_OK) {
+    return ret;
+  }
+
+  for (size_t offset = 0; offset < batch.size; offset += count) {
+    count = MIN(STORAGE_BATCH_CHUNK_SIZE, batch.size - offset);
+    if ((ret = transactions_load_partial_chunk(sqlite3_connection->db, statement_format, &batch, offset, count, pack,
+                                               model)) != RC_OK) {
+      break;
+    }
+  }
+
+  storage_batch_destroy(&batch);
+
+  return ret;
+}
+
 retcode_t storage_transaction_load_hashes(storage_connection_t const* const connection,
                                           storage_transaction_field_t const field, flex_trit_t const* const key,
                                           iota_stor_pack_t* const pack) {
@@ -703,87 +845,198 @@ done:
   return ret;
 }
 
-retcode_t storage_transaction_find(storage_connection_t const* const connection, hash243_queue_t const bundles,
-                                   hash243_queue_t const addresses, hash81_queue_t const tags,
-                                   hash243_queue_t const approvees, iota_stor_pack_t* const pack) {
-  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+// Number of placeholders of a list in a find statement
+static size_t find_placeholders(size_t const bucket) {
+  return bucket == STORAGE_STATEMENT_FIND_TEMP_TABLE ? 0 : bucket;
+}
+
+// Binds a key of a list to a placeholder of a find statement or writes it to the find keys temporary table
+static retcode_t find_key_bind(sqlite3_tangle_connection_t const* const sqlite3_connection,
+                               sqlite3_stmt* const sqlite_statement, size_t const column, size_t const bucket,
+                               storage_statement_find_list_t const list, flex_trit_t const* const key,
+                               size_t const num_bytes) {
+  retcode_t ret = RC_OK;
+
+  if (bucket != STORAGE_STATEMENT_FIND_TEMP_TABLE) {
+    return column_compress_bind(sqlite_statement, column, key, num_bytes);
+  }
+
+  if (sqlite3_bind_int(sqlite3_connection->find_keys_insert, 1, list) != SQLITE_OK ||
+      column_compress_bind(sqlite3_connection->find_keys_insert, 2, key, num_bytes) != RC_OK) {
+    ret = RC_STORAGE_FAILED_BINDING;
+    goto done;
+  }
+
+  ret = execute_statement(sqlite3_connection->find_keys_insert);
+
+done:
+  sqlite3_reset(sqlite3_connection->find_keys_insert);
+  return ret;
+}
+
+static void find_keys_clear(sqlite3_tangle_connection_t const* const sqlite3_connection) {
+  execute_statement(sqlite3_connection->find_keys_clear);
+  sqlite3_reset(sqlite3_connection->find_keys_clear);
+}
+
+/**
+ * Gets a find statement, from the cache of the connection or prepared for the caller, and binds the lists to it
+ * When the keys of a list are written to the temporary table, temp_table is set and the caller clears it once done
+ */
+static retcode_t find_statement_bind(sqlite3_tangle_connection_t* const sqlite3_connection,
+                                     hash243_queue_t const bundles, hash243_queue_t const addresses,
+                                     hash81_queue_t const tags, hash243_queue_t const approvees, bool const cached,
+                                     sqlite3_stmt** const sqlite_statement, bool* const temp_table) {
   retcode_t ret = RC_OK;
-  sqlite3_stmt* sqlite_statement = NULL;
   size_t bundles_count = hash243_queue_count(bundles);
   size_t addresses_count = hash243_queue_count(addresses);
   size_t tags_count = hash81_queue_count(tags);
   size_t approvees_count = hash243_queue_count(approvees);
+  size_t bundles_bucket = storage_statement_find_bucket(bundles_count);
+  size_t addresses_bucket = storage_statement_find_bucket(addresses_count);
+  size_t tags_bucket = storage_statement_find_bucket(tags_count);
+  size_t approvees_bucket = storage_statement_find_bucket(approvees_count);
+  uint32_t key = storage_statement_find_key(bundles_bucket, addresses_bucket, tags_bucket, approvees_bucket);
   hash243_queue_entry_t* iter243 = NULL;
   hash81_queue_entry_t* iter81 = NULL;
   size_t column = 1;
+  char* statement = NULL;
 
-  char* statement =
-      storage_statement_transaction_find_build(bundles_count, addresses_count, tags_count, approvees_count);
+  *sqlite_statement = NULL;
+  *temp_table = bundles_bucket == STORAGE_STATEMENT_FIND_TEMP_TABLE ||
+                addresses_bucket == STORAGE_STATEMENT_FIND_TEMP_TABLE ||
+                tags_bucket == STORAGE_STATEMENT_FIND_TEMP_TABLE ||
+                approvees_bucket == STORAGE_STATEMENT_FIND_TEMP_TABLE;
 
-  if ((ret = prepare_statement(sqlite3_connection->db, &sqlite_statement, statement)) != RC_OK) {
+  if (*temp_table && sqlite3_connection->find_keys_busy) {
+    *temp_table = false;
+    return RC_STORAGE_CURSOR_BUSY;
+  }
+
+  if (!cached || (*sqlite_statement = storage_statement_find_cache_get(&sqlite3_connection->find_statements, key)) ==
+                     NULL) {
+    if ((statement = storage_statement_transaction_find_build(bundles_bucket, addresses_bucket, tags_bucket,
+                                                              approvees_bucket)) == NULL) {
+      *temp_table = false;
+      return RC_OOM;
+    }
+    ret = prepare_statement(sqlite3_connection->db, sqlite_statement, statement);
+    free(statement);
+    if (ret != RC_OK) {
+      *temp_table = false;
+      return ret;
+    }
+    if (cached) {
+      finalize_statement(
+          storage_statement_find_cache_put(&sqlite3_connection->find_statements, key, *sqlite_statement));
+    }
+  }
+
+  // Placeholders left over by lists shorter than their bucket stay bound to NULL
+  sqlite3_clear_bindings(*sqlite_statement);
+
+  if (*temp_table && (ret = begin_transaction(sqlite3_connection->db)) != RC_OK) {
+    *temp_table = false;
     goto done;
   }
 
-  if (sqlite3_bind_int(sqlite_statement, column++, !bundles_count) != SQLITE_OK) {
+  if (sqlite3_bind_int(*sqlite_statement, column++, !bundles_count) != SQLITE_OK) {
     ret = RC_STORAGE_FAILED_BINDING;
     goto done;
   }
 
   CDL_FOREACH(bundles, iter243) {
-    if (column_compress_bind(sqlite_statement, column++, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
-      ret = RC_STORAGE_FAILED_BINDING;
+    if ((ret = find_key_bind(sqlite3_connection, *sqlite_statement, column++, bundles_bucket,
+                             STORAGE_STATEMENT_FIND_BUNDLES, iter243->hash, FLEX_TRIT_SIZE_243)) != RC_OK) {
       goto done;
     }
   }
+  column = 2 + find_placeholders(bundles_bucket);
 
-  if (sqlite3_bind_int(sqlite_statement, column++, !addresses_count) != SQLITE_OK) {
+  if (sqlite3_bind_int(*sqlite_statement, column++, !addresses_count) != SQLITE_OK) {
     ret = RC_STORAGE_FAILED_BINDING;
     goto done;
   }
 
   CDL_FOREACH(addresses, iter243) {
-    if (column_compress_bind(sqlite_statement, column++, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
-      ret = RC_STORAGE_FAILED_BINDING;
+    if ((ret = find_key_bind(sqlite3_connection, *sqlite_statement, column++, addresses_bucket,
+                             STORAGE_STATEMENT_FIND_ADDRESSES, iter243->hash, FLEX_TRIT_SIZE_243)) != RC_OK) {
       goto done;
     }
   }
+  column = 3 + find_placeholders(bundles_bucket) + find_placeholders(addresses_bucket);
 
-  if (sqlite3_bind_int(sqlite_statement, column++, !tags_count) != SQLITE_OK) {
+  if (sqlite3_bind_int(*sqlite_statement, column++, !tags_count) != SQLITE_OK) {
     ret = RC_STORAGE_FAILED_BINDING;
     goto done;
   }
 
   CDL_FOREACH(tags, iter81) {
-    if (column_compress_bind(sqlite_statement, column++, iter81->hash, FLEX_TRIT_SIZE_81) != RC_OK) {
-      ret = RC_STORAGE_FAILED_BINDING;
+    if ((ret = find_key_bind(sqlite3_connection, *sqlite_statement, column++, tags_bucket,
+                             STORAGE_STATEMENT_FIND_TAGS, iter81->hash, FLEX_TRIT_SIZE_81)) != RC_OK) {
       goto done;
     }
   }
+  column = 4 + find_placeholders(bundles_bucket) + find_placeholders(addresses_bucket) + find_placeholders(tags_bucket);
 
-  if (sqlite3_bind_int(sqlite_statement, column++, !approvees_count) != SQLITE_OK) {
+  if (sqlite3_bind_int(*sqlite_statement, column++, !approvees_count) != SQLITE_OK) {
     ret = RC_STORAGE_FAILED_BINDING;
     goto done;
   }
 
+  // Approvees are matched against both the branch and the trunk
   CDL_FOREACH(approvees, iter243) {
-    if (column_compress_bind(sqlite_statement, column, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
-      ret = RC_STORAGE_FAILED_BINDING;
+    if ((ret = find_key_bind(sqlite3_connection, *sqlite_statement, column, approvees_bucket,
+                             STORAGE_STATEMENT_FIND_APPROVEES, iter243->hash, FLEX_TRIT_SIZE_243)) != RC_OK) {
       goto done;
     }
-    if (column_compress_bind(sqlite_statement, column + approvees_count, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (approvees_bucket != STORAGE_STATEMENT_FIND_TEMP_TABLE &&
+        column_compress_bind(*sqlite_statement, column + approvees_bucket, iter243->hash, FLEX_TRIT_SIZE_243) !=
+            RC_OK) {
       ret = RC_STORAGE_FAILED_BINDING;
       goto done;
     }
     column++;
   }
 
-  if ((ret = execute_statement_load_hashes(sqlite_statement, pack)) != RC_OK) {
-    goto done;
+done:
+  if (*temp_table) {
+    if (ret == RC_OK) {
+      ret = end_transaction(sqlite3_connection->db);
+    } else {
+      rollback_transaction(sqlite3_connection->db);
+    }
+    if (ret != RC_OK) {
+      find_keys_clear(sqlite3_connection);
+      *temp_table = false;
+    }
   }
+  if (ret != RC_OK && !cached) {
+    finalize_statement(*sqlite_statement);
+    *sqlite_statement = NULL;
+  }
+  return ret;
+}
 
-done:
-  finalize_statement(sqlite_statement);
-  free(statement);
+retcode_t storage_transaction_find(storage_connection_t const* const connection, hash243_queue_t const bundles,
+                                   hash243_queue_t const addresses, hash81_queue_t const tags,
+                                   hash243_queue_t const approvees, iota_stor_pack_t* const pack) {
+  sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement = NULL;
+  bool temp_table = false;
+
+  if ((ret = find_statement_bind(sqlite3_connection, bundles, addresses, tags, approvees, true, &sqlite_statement,
+                                 &temp_table)) == RC_OK) {
+    ret = execute_statement_load_hashes(sqlite_statement, pack);
+  }
+
+  if (sqlite_statement) {
+    sqlite3_reset(sqlite_statement);
+  }
+  if (temp_table) {
+    find_keys_clear(sqlite3_connection);
+  }
   return ret;
 }
 
@@ -824,35 +1077,241 @@ retcode_t storage_transactions_delete(storage_connection_t const* const connecti
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   retcode_t ret_rollback;
-  bool should_rollback_if_failed = false;
-  sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_delete;
+  sqlite3_stmt* sqlite_statement = sqlite3_connection->transactions_delete;
+  hash243_set_entry_t* iter = NULL;
+  hash243_set_entry_t* tmp = NULL;
+  size_t column = 1;
+  size_t remaining = HASH_COUNT(hashes);
 
   if ((ret = begin_transaction(sqlite3_connection->db)) != RC_OK) {
     return ret;
   }
 
-  should_rollback_if_failed = true;
-
-  {
-    bind_execute_hash_params_t params = {.sqlite_statement = sqlite_statement, .hash_index = 1};
-
-    if ((ret = hash243_set_for_each(hashes, (hash243_on_container_func)bind_execute_hash_do_func, &params)) != RC_OK) {
+  // Hashes are deleted by full batches, the placeholders left over by the last one being bound to NULL
+  sqlite3_clear_bindings(sqlite_statement);
+  HASH_ITER(hh, hashes, iter, tmp) {
+    if (column_compress_bind(sqlite_statement, column++, iter->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+      ret = RC_STORAGE_FAILED_BINDING;
       goto done;
     }
+    remaining--;
+    if (column > STORAGE_STATEMENT_TRANSACTIONS_DELETE_BATCH_SIZE || remaining == 0) {
+      if ((ret = execute_statement(sqlite_statement)) != RC_OK) {
+        goto done;
+      }
+      sqlite3_reset(sqlite_statement);
+      sqlite3_clear_bindings(sqlite_statement);
+      column = 1;
+    }
   }
 
 done:
   sqlite3_reset(sqlite_statement);
-  if (ret != RC_OK && should_rollback_if_failed) {
+  if (ret != RC_OK) {
     if ((ret_rollback = rollback_transaction(sqlite3_connection->db)) != RC_OK) {
       return ret_rollback;
     }
     return ret;
   }
-  if ((ret = end_transaction(sqlite3_connection->db)) != RC_OK) {
+
+  return end_transaction(sqlite3_connection->db);
+}
+
+retcode_t storage_compact(storage_connection_t const* const connection, size_t const pages) {
+  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+  sqlite3_stmt* sqlite_statement = NULL;
+  char statement[64];
+  retcode_t ret = RC_OK;
+  int rc = 0;
+
+  // Only releases pages of databases created with auto_vacuum set to INCREMENTAL, does nothing otherwise
+  snprintf(statement, sizeof(statement), "PRAGMA incremental_vacuum(%zu)", pages);
+  if ((ret = prepare_statement(sqlite3_connection->db, &sqlite_statement, statement)) != RC_OK) {
+    return ret;
+  }
+
+  while ((rc = sqlite3_step(sqlite_statement)) == SQLITE_ROW) {
+  }
+  if (rc != SQLITE_DONE) {
+    ret = RC_STORAGE_FAILED_STEP;
+  }
+
+  finalize_statement(sqlite_statement);
+
+  return ret;
+}
+
+/*
+ * Cursor operations
+ */
+
+typedef struct sqlite3_cursor_s {
+  // A statement of the cursor, stepped as results are read
+  sqlite3_stmt* statement;
+  // Whether the keys of a find cursor are in the find keys temporary table
+  bool find_keys;
+} sqlite3_cursor_t;
+
+static retcode_t cursor_init(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                             storage_load_model_t const model, sqlite3_stmt* const sqlite_statement,
+                             bool const find_keys) {
+  sqlite3_cursor_t* sqlite3_cursor = NULL;
+
+  if ((sqlite3_cursor = (sqlite3_cursor_t*)malloc(sizeof(sqlite3_cursor_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  sqlite3_cursor->statement = sqlite_statement;
+  sqlite3_cursor->find_keys = find_keys;
+  cursor->connection = connection;
+  cursor->model = model;
+  cursor->exhausted = false;
+  cursor->actual = sqlite3_cursor;
+
+  return RC_OK;
+}
+
+retcode_t storage_cursor_open(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                              storage_cursor_query_t const query, flex_trit_t const* const key,
+                              storage_load_model_t const model) {
+  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement = NULL;
+  char const* hashes_statement = NULL;
+  char const* statement_format = NULL;
+  char* statement = NULL;
+  size_t key_binds = 1;
+
+  switch (query) {
+    case CURSOR_QUERY_TRANSACTIONS:
+      hashes_statement = storage_statement_transaction_select_hashes;
+      key_binds = 0;
+      break;
+    case CURSOR_QUERY_ADDRESS:
+      hashes_statement = storage_statement_transaction_select_hashes_by_address;
+      break;
+    case CURSOR_QUERY_APPROVERS:
+      hashes_statement = storage_statement_transaction_select_hashes_of_approvers;
+      key_binds = 2;
+      break;
+    case CURSOR_QUERY_MILESTONE_CANDIDATES:
+      hashes_statement = storage_statement_transaction_select_hashes_of_milestone_candidates;
+      break;
+    default:
+      return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+  }
+
+  // Partial transactions are selected by the hashes the query selects
+  if (model != MODEL_HASH) {
+    if ((statement_format = transactions_select_in_format(model)) == NULL) {
+      return RC_STORAGE_FAILED_NOT_IMPLEMENTED;
+    }
+    if ((statement = storage_statement_transactions_select_in_build(statement_format, hashes_statement)) == NULL) {
+      return RC_OOM;
+    }
+  }
+
+  // Each cursor has its own statement so that several cursors can be open at once, e.g. during traversals
+  ret = prepare_statement(sqlite3_connection->db, &sqlite_statement, statement ? statement : hashes_statement);
+  free(statement);
+  if (ret != RC_OK) {
+    return ret;
+  }
+
+  for (size_t i = 1; i <= key_binds; i++) {
+    if (column_compress_bind(sqlite_statement, i, key, FLEX_TRIT_SIZE_243) != RC_OK) {
+      ret = RC_STORAGE_FAILED_BINDING;
+      goto done;
+    }
+  }
+
+  ret = cursor_init(connection, cursor, model, sqlite_statement, false);
+
+done:
+  if (ret != RC_OK) {
+    finalize_statement(sqlite_statement);
+  }
+  return ret;
+}
+
+retcode_t storage_cursor_find_open(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                                   hash243_queue_t const bundles, hash243_queue_t const addresses,
+                                   hash81_queue_t const tags, hash243_queue_t const approvees) {
+  sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement = NULL;
+  bool temp_table = false;
+
+  if ((ret = find_statement_bind(sqlite3_connection, bundles, addresses, tags, approvees, false, &sqlite_statement,
+                                 &temp_table)) != RC_OK) {
+    return ret;
+  }
+
+  if ((ret = cursor_init(connection, cursor, MODEL_HASH, sqlite_statement, temp_table)) != RC_OK) {
+    finalize_statement(sqlite_statement);
+    if (temp_table) {
+      find_keys_clear(sqlite3_connection);
+    }
     return ret;
   }
 
+  sqlite3_connection->find_keys_busy |= temp_table;
+
+  return RC_OK;
+}
+
+retcode_t storage_cursor_next(storage_cursor_t* const cursor, iota_stor_pack_t* const pack) {
+  sqlite3_cursor_t* sqlite3_cursor = (sqlite3_cursor_t*)cursor->actual;
+  iota_transaction_t* tx = NULL;
+  size_t index = 0;
+  int rc = 0;
+
+  pack->num_loaded = 0;
+  pack->insufficient_capacity = false;
+  if (cursor->model != MODEL_HASH) {
+    storage_batch_pack_reset(pack);
+  }
+
+  // A statement stepped once done starts over, hence the exhausted flag
+  while (!cursor->exhausted && pack->num_loaded < pack->capacity) {
+    if ((rc = sqlite3_step(sqlite3_cursor->statement)) == SQLITE_DONE) {
+      cursor->exhausted = true;
+    } else if (rc != SQLITE_ROW) {
+      return RC_STORAGE_FAILED_STEP;
+    } else if (cursor->model == MODEL_HASH) {
+      column_decompress_load(sqlite3_cursor->statement, 0, (flex_trit_t*)pack->models[pack->num_loaded++],
+                             FLEX_TRIT_SIZE_243);
+    } else {
+      tx = (iota_transaction_t*)pack->models[pack->num_loaded++];
+      index = 1;
+      select_transactions_populate_model(sqlite3_cursor->statement, tx, cursor->model, &index);
+      column_decompress_load(sqlite3_cursor->statement, 0, tx->consensus.hash, FLEX_TRIT_SIZE_243);
+      tx->loaded_columns_mask.consensus |= MASK_CONSENSUS_HASH;
+    }
+  }
+
+  return RC_OK;
+}
+
+retcode_t storage_cursor_close(storage_cursor_t* const cursor) {
+  sqlite3_tangle_connection_t* sqlite3_connection = NULL;
+  sqlite3_cursor_t* sqlite3_cursor = (sqlite3_cursor_t*)cursor->actual;
+  retcode_t ret = RC_OK;
+
+  if (sqlite3_cursor == NULL) {
+    return RC_OK;
+  }
+
+  ret = finalize_statement(sqlite3_cursor->statement);
+  if (sqlite3_cursor->find_keys) {
+    sqlite3_connection = (sqlite3_tangle_connection_t*)cursor->connection->actual;
+    find_keys_clear(sqlite3_connection);
+    sqlite3_connection->find_keys_busy = false;
+  }
+  free(sqlite3_cursor);
+  cursor->actual = NULL;
+  cursor->exhausted = true;
+
   return ret;
 }
 
@@ -1,3 +1,6 @@
+-- Lets pruning give the pages of deleted transactions back to the file system a few at a time
+PRAGMA auto_vacuum = INCREMENTAL;
+
 CREATE TABLE IF NOT EXISTS iota_transaction (
   signature_or_message BLOB NOT NULL,
   address BLOB NOT NULL,
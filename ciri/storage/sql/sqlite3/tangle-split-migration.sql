@@ -0,0 +1,94 @@
+-- Migrates a tangle database created with tangle-schema.sql to the layout of tangle-split-schema.sql
+-- Usage: sqlite3 ciri/db/tangle-mainnet.db < ciri/storage/sql/sqlite3/tangle-split-migration.sql
+-- The node must be stopped and the database needs about twice its size in free disk space while being rewritten
+-- Stops at the first error, e.g. if the database was already migrated, in which case nothing is changed
+
+.bail on
+
+BEGIN TRANSACTION;
+
+CREATE TABLE iota_transaction_hot (
+  address BLOB NOT NULL,
+  value INTEGER NOT NULL,
+  obsolete_tag BLOB,
+  timestamp INTEGER NOT NULL,
+  current_index SMALLINT NOT NULL,
+  last_index SMALLINT NOT NULL,
+  bundle BLOB NOT NULL,
+  trunk BLOB NOT NULL,
+  branch BLOB NOT NULL,
+  tag BLOB NOT NULL,
+  attachment_timestamp INTEGER NOT NULL,
+  attachment_timestamp_lower INTEGER NOT NULL,
+  attachment_timestamp_upper INTEGER NOT NULL,
+  nonce BLOB NOT NULL,
+  hash BLOB NOT NULL PRIMARY KEY,
+  snapshot_index INTEGER NOT NULL DEFAULT 0,
+  solid SMALLINT NOT NULL DEFAULT 0,
+  validity SMALLINT NOT NULL DEFAULT 0,
+  arrival_timestamp INTEGER NOT NULL
+);
+
+CREATE TABLE iota_transaction_cold (
+  hash BLOB NOT NULL PRIMARY KEY,
+  signature_or_message BLOB NOT NULL
+);
+
+INSERT INTO iota_transaction_hot(address, value, obsolete_tag, timestamp, current_index, last_index, bundle, trunk,
+  branch, tag, attachment_timestamp, attachment_timestamp_lower, attachment_timestamp_upper, nonce, hash,
+  snapshot_index, solid, validity, arrival_timestamp)
+SELECT address, value, obsolete_tag, timestamp, current_index, last_index, bundle, trunk, branch, tag,
+  attachment_timestamp, attachment_timestamp_lower, attachment_timestamp_upper, nonce, hash, snapshot_index, solid,
+  validity, arrival_timestamp
+FROM iota_transaction;
+
+INSERT INTO iota_transaction_cold(hash, signature_or_message)
+SELECT hash, signature_or_message FROM iota_transaction;
+
+-- Also drops the indexes of the table, they are created again on iota_transaction_hot once it is filled
+DROP TABLE iota_transaction;
+
+CREATE INDEX IF NOT EXISTS address_index ON iota_transaction_hot(address);
+CREATE INDEX IF NOT EXISTS bundle_index ON iota_transaction_hot(bundle);
+CREATE INDEX IF NOT EXISTS trunk_index ON iota_transaction_hot(trunk);
+CREATE INDEX IF NOT EXISTS branch_index ON iota_transaction_hot(branch);
+CREATE INDEX IF NOT EXISTS tag_index ON iota_transaction_hot(tag);
+CREATE INDEX IF NOT EXISTS arrival_time_index ON iota_transaction_hot(arrival_timestamp);
+
+-- The join is left and on a unique key so that SQLite omits it when no column of iota_transaction_cold is used
+CREATE VIEW IF NOT EXISTS iota_transaction AS
+  SELECT c.signature_or_message, h.address, h.value, h.obsolete_tag, h.timestamp, h.current_index, h.last_index,
+    h.bundle, h.trunk, h.branch, h.tag, h.attachment_timestamp, h.attachment_timestamp_lower,
+    h.attachment_timestamp_upper, h.nonce, h.hash, h.snapshot_index, h.solid, h.validity, h.arrival_timestamp
+  FROM iota_transaction_hot h LEFT JOIN iota_transaction_cold c ON c.hash = h.hash;
+
+-- Defaults of iota_transaction_hot do not apply through the view
+CREATE TRIGGER IF NOT EXISTS iota_transaction_insert INSTEAD OF INSERT ON iota_transaction
+BEGIN
+  INSERT INTO iota_transaction_hot(address, value, obsolete_tag, timestamp, current_index, last_index, bundle, trunk,
+    branch, tag, attachment_timestamp, attachment_timestamp_lower, attachment_timestamp_upper, nonce, hash,
+    snapshot_index, solid, validity, arrival_timestamp)
+  VALUES(NEW.address, NEW.value, NEW.obsolete_tag, NEW.timestamp, NEW.current_index, NEW.last_index, NEW.bundle,
+    NEW.trunk, NEW.branch, NEW.tag, NEW.attachment_timestamp, NEW.attachment_timestamp_lower,
+    NEW.attachment_timestamp_upper, NEW.nonce, NEW.hash, COALESCE(NEW.snapshot_index, 0), COALESCE(NEW.solid, 0),
+    COALESCE(NEW.validity, 0), NEW.arrival_timestamp);
+  INSERT INTO iota_transaction_cold(hash, signature_or_message) VALUES(NEW.hash, NEW.signature_or_message);
+END;
+
+CREATE TRIGGER IF NOT EXISTS iota_transaction_update INSTEAD OF UPDATE OF snapshot_index, solid, validity
+  ON iota_transaction
+BEGIN
+  UPDATE iota_transaction_hot SET snapshot_index = NEW.snapshot_index, solid = NEW.solid, validity = NEW.validity
+  WHERE hash = OLD.hash;
+END;
+
+CREATE TRIGGER IF NOT EXISTS iota_transaction_delete INSTEAD OF DELETE ON iota_transaction
+BEGIN
+  DELETE FROM iota_transaction_hot WHERE hash = OLD.hash;
+  DELETE FROM iota_transaction_cold WHERE hash = OLD.hash;
+END;
+
+COMMIT;
+
+PRAGMA auto_vacuum = INCREMENTAL;
+VACUUM;
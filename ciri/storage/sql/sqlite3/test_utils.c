@@ -10,12 +10,18 @@
 #include "ciri/utils/files.h"
 #include "utils/macros.h"
 
+#ifdef STORAGE_SQLITE3_SPLIT_SCHEMA
+#define TANGLE_TEST_DB "ciri/storage/sql/sqlite3/tangle-split.db"
+#else
+#define TANGLE_TEST_DB "ciri/storage/sql/sqlite3/tangle.db"
+#endif
+
 retcode_t storage_test_setup(storage_connection_t* const connection, storage_connection_config_t const* const config,
                              char const* const test_db_path, storage_connection_type_t const type) {
   retcode_t ret = RC_OK;
 
   if (type == STORAGE_CONNECTION_TANGLE) {
-    ret = iota_utils_copy_file(test_db_path, "ciri/storage/sql/sqlite3/tangle.db");
+    ret = iota_utils_copy_file(test_db_path, TANGLE_TEST_DB);
   } else if (type == STORAGE_CONNECTION_SPENT_ADDRESSES) {
     ret = iota_utils_copy_file(test_db_path, "ciri/storage/sql/sqlite3/spent-addresses.db");
   }
@@ -12,6 +12,7 @@
 #include <string.h>
 
 #include "ciri/storage/defs.h"
+#include "ciri/storage/sql/statements.h"
 #include "utils/macros.h"
 
 /*
@@ -58,6 +59,9 @@ char *storage_statement_transaction_select_by_hash =
     "," TRANSACTION_COL_HASH "," TRANSACTION_COL_SIG_OR_MSG " FROM " TRANSACTION_TABLE_NAME
     " WHERE " TRANSACTION_COL_HASH "=?";
 
+char *storage_statement_transaction_select_hashes =
+    "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME;
+
 char *storage_statement_transaction_select_hashes_by_address =
     "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_ADDRESS "=?";
 
@@ -141,25 +145,84 @@ char *storage_statement_transaction_select_metadata =
     "SELECT " TRANSACTION_COL_SNAPSHOT_INDEX "," TRANSACTION_COL_SOLID "," TRANSACTION_COL_VALIDITY
     "," TRANSACTION_COL_ARRIVAL_TIME " FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_HASH "=?";
 
+/*
+ * Batched transaction statements
+ */
+
+#define TRANSACTION_COLS_ESSENCE                                                                                  \
+  TRANSACTION_COL_ADDRESS "," TRANSACTION_COL_VALUE "," TRANSACTION_COL_OBSOLETE_TAG "," TRANSACTION_COL_TIMESTAMP \
+                          "," TRANSACTION_COL_CURRENT_INDEX "," TRANSACTION_COL_LAST_INDEX "," TRANSACTION_COL_BUNDLE
+#define TRANSACTION_COLS_ATTACHMENT                                                                            \
+  TRANSACTION_COL_TRUNK "," TRANSACTION_COL_BRANCH "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP                    \
+                        "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP_LOWER "," TRANSACTION_COL_ATTACHMENT_TIMESTAMP_UPPER \
+                        "," TRANSACTION_COL_NONCE "," TRANSACTION_COL_TAG
+#define TRANSACTION_COLS_METADATA \
+  TRANSACTION_COL_SNAPSHOT_INDEX "," TRANSACTION_COL_SOLID "," TRANSACTION_COL_VALIDITY "," TRANSACTION_COL_ARRIVAL_TIME
+#define TRANSACTIONS_FROM_HASHES " FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_HASH " IN(%s)"
+
+char *storage_statement_transactions_select_by_hashes =
+    "SELECT " TRANSACTION_COL_HASH "," TRANSACTION_COLS_ESSENCE "," TRANSACTION_COLS_ATTACHMENT
+    "," TRANSACTION_COL_HASH "," TRANSACTION_COL_SIG_OR_MSG TRANSACTIONS_FROM_HASHES;
+
+char *storage_statement_transactions_select_essence_metadata_by_hashes =
+    "SELECT " TRANSACTION_COL_HASH "," TRANSACTION_COLS_ESSENCE "," TRANSACTION_COLS_METADATA TRANSACTIONS_FROM_HASHES;
+
+char *storage_statement_transactions_select_essence_attachment_metadata_by_hashes =
+    "SELECT " TRANSACTION_COL_HASH "," TRANSACTION_COLS_ESSENCE "," TRANSACTION_COLS_ATTACHMENT
+    "," TRANSACTION_COLS_METADATA TRANSACTIONS_FROM_HASHES;
+
+char *storage_statement_transactions_select_essence_consensus_by_hashes =
+    "SELECT " TRANSACTION_COL_HASH "," TRANSACTION_COLS_ESSENCE "," TRANSACTION_COL_HASH TRANSACTIONS_FROM_HASHES;
+
+char *storage_statement_transactions_select_metadata_by_hashes =
+    "SELECT " TRANSACTION_COL_HASH "," TRANSACTION_COLS_METADATA TRANSACTIONS_FROM_HASHES;
+
+char *storage_statement_transactions_delete_by_hashes = "DELETE" TRANSACTIONS_FROM_HASHES;
+
 /*
  * Transaction statement builders
  */
 
+static char *storage_statement_find_in_clause_build(size_t const count, storage_statement_find_list_t const list) {
+  char *in_clause = NULL;
+
+  if (count != STORAGE_STATEMENT_FIND_TEMP_TABLE) {
+    return storage_statement_in_clause_build(count);
+  }
+
+  if ((in_clause = (char *)malloc(64)) != NULL) {
+    snprintf(in_clause, 64, "SELECT " FIND_KEYS_COL_KEY " FROM " FIND_KEYS_TABLE_NAME " WHERE " FIND_KEYS_COL_LIST
+             "=%d", list);
+  }
+
+  return in_clause;
+}
+
 char *storage_statement_transaction_find_build(size_t const bundles_count, size_t const addresses_count,
                                                size_t const tags_count, size_t const approvees_count) {
-  // Base size of the query + enough space for "?" or "NULL" (bindings)
-  size_t statement_size = storage_statement_transaction_find_size + 16 + 2 * bundles_count + 2 * addresses_count +
-                          2 * tags_count + 4 * approvees_count;
-  char *statement = (char *)malloc(statement_size);
-
-  char *bundles_in_clause = storage_statement_in_clause_build(bundles_count);
-  char *addresses_in_clause = storage_statement_in_clause_build(addresses_count);
-  char *tags_in_clause = storage_statement_in_clause_build(tags_count);
-  char *approvees_in_clause = storage_statement_in_clause_build(approvees_count);
+  char *statement = NULL;
+  size_t statement_size = 0;
+
+  char *bundles_in_clause = storage_statement_find_in_clause_build(bundles_count, STORAGE_STATEMENT_FIND_BUNDLES);
+  char *addresses_in_clause =
+      storage_statement_find_in_clause_build(addresses_count, STORAGE_STATEMENT_FIND_ADDRESSES);
+  char *tags_in_clause = storage_statement_find_in_clause_build(tags_count, STORAGE_STATEMENT_FIND_TAGS);
+  char *approvees_in_clause =
+      storage_statement_find_in_clause_build(approvees_count, STORAGE_STATEMENT_FIND_APPROVEES);
+
+  if (bundles_in_clause == NULL || addresses_in_clause == NULL || tags_in_clause == NULL ||
+      approvees_in_clause == NULL) {
+    goto done;
+  }
 
-  snprintf(statement, statement_size, storage_statement_transaction_find, bundles_in_clause, addresses_in_clause,
-           tags_in_clause, approvees_in_clause, approvees_in_clause);
+  statement_size = storage_statement_transaction_find_size + strlen(bundles_in_clause) + strlen(addresses_in_clause) +
+                   strlen(tags_in_clause) + 2 * strlen(approvees_in_clause) + 1;
+  if ((statement = (char *)malloc(statement_size)) != NULL) {
+    snprintf(statement, statement_size, storage_statement_transaction_find, bundles_in_clause, addresses_in_clause,
+             tags_in_clause, approvees_in_clause, approvees_in_clause);
+  }
 
+done:
   free(bundles_in_clause);
   free(addresses_in_clause);
   free(tags_in_clause);
@@ -168,6 +231,139 @@ char *storage_statement_transaction_find_build(size_t const bundles_count, size_
   return statement;
 }
 
+char *storage_statement_transactions_select_by_hashes_build(char const *const statement, size_t const hashes_count) {
+  char *in_clause = storage_statement_in_clause_build(hashes_count);
+  char *built_statement = NULL;
+
+  if (in_clause) {
+    built_statement = storage_statement_transactions_select_in_build(statement, in_clause);
+  }
+  free(in_clause);
+
+  return built_statement;
+}
+
+char *storage_statement_transactions_select_in_build(char const *const statement, char const *const in_clause) {
+  size_t statement_size = strlen(statement) + strlen(in_clause) + 1;
+  char *built_statement = (char *)malloc(statement_size);
+
+  if (built_statement) {
+    snprintf(built_statement, statement_size, statement, in_clause);
+  }
+
+  return built_statement;
+}
+
+char *storage_statement_transactions_insert_build(size_t const rows) {
+  // The row of the single insert statement is repeated after its VALUES keyword
+  char const *row = strrchr(storage_statement_transaction_insert, '(');
+  size_t insert_size = strlen(storage_statement_transaction_insert);
+  size_t row_size = strlen(row);
+  char *statement = NULL;
+  size_t offset = insert_size;
+
+  if (rows == 0 || (statement = (char *)malloc(insert_size + (rows - 1) * (row_size + 1) + 1)) == NULL) {
+    return NULL;
+  }
+
+  memcpy(statement, storage_statement_transaction_insert, insert_size);
+  for (size_t i = 1; i < rows; i++) {
+    statement[offset++] = ',';
+    memcpy(statement + offset, row, row_size);
+    offset += row_size;
+  }
+  statement[offset] = '\0';
+
+  return statement;
+}
+
+/*
+ * Find statements
+ */
+
+char *storage_statement_find_keys_create = "CREATE TEMP TABLE IF NOT EXISTS " FIND_KEYS_TABLE_NAME
+                                           "(" FIND_KEYS_COL_LIST " INTEGER NOT NULL," FIND_KEYS_COL_KEY
+                                           " BLOB NOT NULL,PRIMARY KEY(" FIND_KEYS_COL_LIST "," FIND_KEYS_COL_KEY
+                                           "))WITHOUT ROWID";
+
+char *storage_statement_find_keys_insert =
+    "INSERT OR IGNORE INTO " FIND_KEYS_TABLE_NAME "(" FIND_KEYS_COL_LIST "," FIND_KEYS_COL_KEY ")VALUES(?,?)";
+
+char *storage_statement_find_keys_clear = "DELETE FROM " FIND_KEYS_TABLE_NAME;
+
+size_t storage_statement_find_bucket(size_t const count) {
+  size_t bucket = 1;
+
+  if (count == 0) {
+    return 0;
+  } else if (count > STORAGE_STATEMENT_FIND_IN_CLAUSE_MAX) {
+    return STORAGE_STATEMENT_FIND_TEMP_TABLE;
+  }
+
+  while (bucket < count) {
+    bucket <<= 1;
+  }
+
+  return bucket;
+}
+
+// Each bucket is encoded on a byte: 0 when empty, 1 + log2 of its size or 0xFF for the temporary table
+static uint32_t storage_statement_find_bucket_code(size_t const bucket) {
+  uint32_t code = 0;
+
+  if (bucket == STORAGE_STATEMENT_FIND_TEMP_TABLE) {
+    return 0xFF;
+  }
+
+  for (size_t size = bucket; size != 0; size >>= 1) {
+    code++;
+  }
+
+  return code;
+}
+
+uint32_t storage_statement_find_key(size_t const bundles_bucket, size_t const addresses_bucket,
+                                    size_t const tags_bucket, size_t const approvees_bucket) {
+  return storage_statement_find_bucket_code(bundles_bucket) |
+         storage_statement_find_bucket_code(addresses_bucket) << 8 |
+         storage_statement_find_bucket_code(tags_bucket) << 16 |
+         storage_statement_find_bucket_code(approvees_bucket) << 24;
+}
+
+void *storage_statement_find_cache_get(storage_statement_find_cache_t *const cache, uint32_t const key) {
+  for (size_t i = 0; i < cache->size; i++) {
+    if (cache->entries[i].key == key) {
+      cache->entries[i].last_used = ++cache->clock;
+      return cache->entries[i].statement;
+    }
+  }
+
+  return NULL;
+}
+
+void *storage_statement_find_cache_put(storage_statement_find_cache_t *const cache, uint32_t const key,
+                                       void *const statement) {
+  storage_statement_find_cache_entry_t *entry = &cache->entries[0];
+  void *evicted = NULL;
+
+  if (cache->size < STORAGE_STATEMENT_FIND_CACHE_SIZE) {
+    entry = &cache->entries[cache->size++];
+  } else {
+    for (size_t i = 1; i < cache->size; i++) {
+      if (cache->entries[i].last_used < entry->last_used) {
+        entry = &cache->entries[i];
+      }
+    }
+    evicted = entry->statement;
+  }
+
+  entry->key = key;
+  entry->last_used = ++cache->clock;
+  entry->statement = statement;
+
+  return evicted;
+}
+
 /*
  * Milestone statements
  */
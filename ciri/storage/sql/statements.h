@@ -9,6 +9,7 @@
 #define __CIRI_STORAGE_SQL_STATEMENTS_H__
 
 #include <inttypes.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -65,6 +66,7 @@ extern char* storage_statement_in_clause_build(size_t const count);
 
 extern char* storage_statement_transaction_insert;
 extern char* storage_statement_transaction_select_by_hash;
+extern char* storage_statement_transaction_select_hashes;
 extern char* storage_statement_transaction_select_hashes_by_address;
 extern char* storage_statement_transaction_select_hashes_of_approvers;
 extern char* storage_statement_transaction_select_hashes_of_approvers_before_date;
@@ -89,12 +91,83 @@ extern char* storage_statement_transaction_select_essence_attachment_metadata;
 extern char* storage_statement_transaction_select_essence_consensus;
 extern char* storage_statement_transaction_select_metadata;
 
+/*
+ * Batched transaction statements
+ * The hash comes first followed by the columns of the non-batched statement
+ */
+
+extern char* storage_statement_transactions_select_by_hashes;
+extern char* storage_statement_transactions_select_essence_metadata_by_hashes;
+extern char* storage_statement_transactions_select_essence_attachment_metadata_by_hashes;
+extern char* storage_statement_transactions_select_essence_consensus_by_hashes;
+extern char* storage_statement_transactions_select_metadata_by_hashes;
+
+// Number of hashes deleted by a single execution of the batched delete statement
+#define STORAGE_STATEMENT_TRANSACTIONS_DELETE_BATCH_SIZE 64
+
+extern char* storage_statement_transactions_delete_by_hashes;
+
 /*
  * Transaction statement builders
  */
 
+// A count of STORAGE_STATEMENT_FIND_TEMP_TABLE matches the list against the find keys temporary table
 extern char* storage_statement_transaction_find_build(size_t const bundles_count, size_t const addresses_count,
                                                       size_t const tags_count, size_t const approvees_count);
+extern char* storage_statement_transactions_select_by_hashes_build(char const* const statement,
+                                                                   size_t const hashes_count);
+// The IN clause may also be a query selecting hashes, e.g. to stream partial transactions of an address
+extern char* storage_statement_transactions_select_in_build(char const* const statement, char const* const in_clause);
+
+// Number of rows inserted by a single execution of a multi-row transaction insert statement
+#define STORAGE_STATEMENT_TRANSACTIONS_INSERT_BATCH_SIZE 32
+
+// Inserts rows of the columns of storage_statement_transaction_insert in a single statement
+extern char* storage_statement_transactions_insert_build(size_t const rows);
+
+/*
+ * Find statements
+ *
+ * Find statements are prepared for bucketed list sizes, the placeholders left over by a shorter list being bound to
+ * NULL, and kept by connections in a small LRU cache. Lists longer than the largest bucket are written to a temporary
+ * table instead of being bound in an IN clause.
+ */
+
+#define STORAGE_STATEMENT_FIND_IN_CLAUSE_MAX 64
+#define STORAGE_STATEMENT_FIND_TEMP_TABLE SIZE_MAX
+#define STORAGE_STATEMENT_FIND_CACHE_SIZE 16
+
+typedef enum storage_statement_find_list_e {
+  STORAGE_STATEMENT_FIND_BUNDLES,
+  STORAGE_STATEMENT_FIND_ADDRESSES,
+  STORAGE_STATEMENT_FIND_TAGS,
+  STORAGE_STATEMENT_FIND_APPROVEES,
+} storage_statement_find_list_t;
+
+typedef struct storage_statement_find_cache_entry_s {
+  uint32_t key;
+  uint64_t last_used;
+  void* statement;
+} storage_statement_find_cache_entry_t;
+
+typedef struct storage_statement_find_cache_s {
+  storage_statement_find_cache_entry_t entries[STORAGE_STATEMENT_FIND_CACHE_SIZE];
+  size_t size;
+  uint64_t clock;
+} storage_statement_find_cache_t;
+
+extern char* storage_statement_find_keys_create;
+extern char* storage_statement_find_keys_insert;
+extern char* storage_statement_find_keys_clear;
+
+// Rounds a list size up to the next power of two, or to STORAGE_STATEMENT_FIND_TEMP_TABLE past the largest bucket
+extern size_t storage_statement_find_bucket(size_t const count);
+extern uint32_t storage_statement_find_key(size_t const bundles_bucket, size_t const addresses_bucket,
+                                           size_t const tags_bucket, size_t const approvees_bucket);
+extern void* storage_statement_find_cache_get(storage_statement_find_cache_t* const cache, uint32_t const key);
+// Returns the least recently used statement it evicted, for the caller to finalize, or NULL
+extern void* storage_statement_find_cache_put(storage_statement_find_cache_t* const cache, uint32_t const key,
+                                              void* const statement);
 
 /*
  * Milestone statements
@@ -72,9 +72,31 @@ typedef enum storage_value_type_e {
 
 extern retcode_t storage_transaction_count(storage_connection_t const* const connection, uint64_t* const count);
 
+/**
+ * Stores a transaction, with its arrival timestamp if set and the current time otherwise
+ *
+ * @param connection A storage connection
+ * @param transaction The transaction
+ *
+ * @return a status code
+ */
 extern retcode_t storage_transaction_store(storage_connection_t const* const connection,
                                            iota_transaction_t const* const transaction);
 
+/**
+ * Stores transactions in a single database transaction
+ * Either all transactions are stored or none of them are, with their arrival timestamps if set and the current time
+ * otherwise
+ *
+ * @param connection A storage connection
+ * @param transactions An array of transactions
+ * @param count The number of transactions in the array
+ *
+ * @return a status code
+ */
+extern retcode_t storage_transactions_store(storage_connection_t const* const connection,
+                                            iota_transaction_t const* const transactions, size_t const count);
+
 extern retcode_t storage_transaction_load(storage_connection_t const* const connection,
                                           storage_transaction_field_t const field, flex_trit_t const* const key,
                                           iota_stor_pack_t* const pack);
@@ -93,6 +115,22 @@ extern retcode_t storage_transaction_load_essence_consensus(storage_connection_t
 extern retcode_t storage_transaction_load_metadata(storage_connection_t const* const connection,
                                                    flex_trit_t const* const hash, iota_stor_pack_t* const pack);
 
+/**
+ * Loads transactions, or parts of them, from a list of hashes with as few statements as possible
+ * The i-th model of the pack is loaded with the transaction of the i-th hash and has an empty loaded columns mask if
+ * it was not found
+ *
+ * @param connection A storage connection
+ * @param hashes A list of transaction hashes
+ * @param pack A pack of transactions, insufficient_capacity is set and nothing is loaded if it can't hold all hashes
+ * @param model MODEL_TRANSACTION or one of the partial transaction models
+ *
+ * @return a status code
+ */
+extern retcode_t storage_transactions_load_partial(storage_connection_t const* const connection,
+                                                   hash243_queue_t const hashes, iota_stor_pack_t* const pack,
+                                                   storage_load_model_t const model);
+
 extern retcode_t storage_transaction_exist(storage_connection_t const* const connection,
                                            storage_transaction_field_t const field, flex_trit_t const* const key,
                                            bool* const exist);
@@ -139,6 +177,95 @@ extern retcode_t storage_transactions_update_solidity(storage_connection_t const
 
 extern retcode_t storage_transactions_delete(storage_connection_t const* const connection, hash243_set_t const hashes);
 
+/**
+ * Gives the space left by deleted transactions back to the file system, if the backend supports it
+ *
+ * @param connection A storage connection
+ * @param pages The maximum number of pages to give back, 0 for all of them
+ *
+ * @return a status code
+ */
+extern retcode_t storage_compact(storage_connection_t const* const connection, size_t const pages);
+
+/*
+ * Cursor operations
+ *
+ * A cursor streams the results of a query by batches of the size of the pack it is read with, so that callers don't
+ * need a pack large enough for all results nor to run the query again after a resize.
+ */
+
+typedef enum storage_cursor_query_e {
+  // All transactions
+  CURSOR_QUERY_TRANSACTIONS,
+  // Transactions of an address
+  CURSOR_QUERY_ADDRESS,
+  // Transactions directly approving a transaction
+  CURSOR_QUERY_APPROVERS,
+  // Tail transactions of a coordinator address that are not stored as milestones yet
+  CURSOR_QUERY_MILESTONE_CANDIDATES,
+} storage_cursor_query_t;
+
+typedef struct storage_cursor_s {
+  storage_connection_t const* connection;
+  storage_load_model_t model;
+  bool exhausted;
+  // Backend specific state
+  void* actual;
+} storage_cursor_t;
+
+/**
+ * Opens a cursor on the transactions matching a query
+ *
+ * @param connection A storage connection, used by the cursor until it is closed
+ * @param cursor The cursor
+ * @param query The query
+ * @param key The address for CURSOR_QUERY_ADDRESS and CURSOR_QUERY_MILESTONE_CANDIDATES, the approvee hash for
+ * CURSOR_QUERY_APPROVERS, ignored for CURSOR_QUERY_TRANSACTIONS
+ * @param model MODEL_HASH or one of the partial transaction models, partial models are loaded with their hash
+ *
+ * @return a status code
+ */
+extern retcode_t storage_cursor_open(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                                     storage_cursor_query_t const query, flex_trit_t const* const key,
+                                     storage_load_model_t const model);
+
+/**
+ * Opens a cursor on the hashes of the transactions matching the criteria of a findTransactions request
+ * There may be at most one find cursor open on a connection
+ *
+ * @param connection A storage connection, used by the cursor until it is closed
+ * @param cursor The cursor
+ * @param bundles A list of bundle hashes
+ * @param addresses A list of addresses
+ * @param tags A list of tags
+ * @param approvees A list of approvee hashes
+ *
+ * @return a status code
+ */
+extern retcode_t storage_cursor_find_open(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                                          hash243_queue_t const bundles, hash243_queue_t const addresses,
+                                          hash81_queue_t const tags, hash243_queue_t const approvees);
+
+/**
+ * Loads the next results of a cursor in a pack, from its first model up to its capacity
+ * Transaction models are all reset first, the cursor is exhausted once a call loads no result
+ *
+ * @param cursor The cursor
+ * @param pack A pack of hashes or of transactions, depending on the model of the cursor
+ *
+ * @return a status code
+ */
+extern retcode_t storage_cursor_next(storage_cursor_t* const cursor, iota_stor_pack_t* const pack);
+
+/**
+ * Closes a cursor, whether exhausted or not
+ *
+ * @param cursor The cursor
+ *
+ * @return a status code
+ */
+extern retcode_t storage_cursor_close(storage_cursor_t* const cursor);
+
 /*
  * Bundle operations
  */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * Measures the throughput of the storage backend it is linked with so that backends can be compared
+ *
+ * Usage: benchmark_storage [number of transactions]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ciri/storage/storage.h"
+#include "ciri/storage/test_utils.h"
+#include "ciri/storage/tests/defs.h"
+#include "common/model/transaction.h"
+#include "common/trinary/add.h"
+#include "utils/time.h"
+
+#define BENCHMARK_DB_PATH "ciri/storage/tests/benchmark.db"
+#define BENCHMARK_TRANSACTIONS_NUM 10000
+// Every approvee is approved by this number of transactions
+#define BENCHMARK_APPROVERS_NUM 8
+
+static void report(char const* const name, size_t const ops, uint64_t const start) {
+  uint64_t elapsed = current_timestamp_ms() - start;
+
+  printf("%-16s %8zu ops in %6" PRIu64 " ms: %10.0f ops/s\n", name, ops, elapsed,
+         elapsed ? ops * 1000.0 / elapsed : 0.0);
+}
+
+int main(int argc, char** argv) {
+  retcode_t ret = RC_OK;
+  storage_connection_config_t config = {.db_path = BENCHMARK_DB_PATH};
+  storage_connection_t connection;
+  size_t transactions_num = argc > 1 ? strtoul(argv[1], NULL, 10) : BENCHMARK_TRANSACTIONS_NUM;
+  size_t approvees_num = 0;
+  flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
+  trit_t hash_trits[HASH_LENGTH_TRIT];
+  flex_trit_t* hashes = NULL;
+  iota_transaction_t transaction;
+  iota_stor_pack_t pack;
+  uint64_t start = 0;
+  bool exist = false;
+
+  if (transactions_num < BENCHMARK_APPROVERS_NUM) {
+    transactions_num = BENCHMARK_APPROVERS_NUM;
+  }
+  approvees_num = transactions_num / BENCHMARK_APPROVERS_NUM;
+
+  if ((hashes = (flex_trit_t*)malloc(transactions_num * FLEX_TRIT_SIZE_243)) == NULL ||
+      hash_pack_init(&pack, BENCHMARK_APPROVERS_NUM) != RC_OK) {
+    free(hashes);
+    return EXIT_FAILURE;
+  }
+
+  if ((ret = storage_init()) != RC_OK) {
+    fprintf(stderr, "Initializing storage failed: %d\n", ret);
+    goto done;
+  }
+
+  if ((ret = storage_test_setup(&connection, &config, BENCHMARK_DB_PATH, STORAGE_CONNECTION_TANGLE)) != RC_OK) {
+    fprintf(stderr, "Setting up connection failed: %d\n", ret);
+    goto destroy;
+  }
+
+  flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  transaction_deserialize_from_trits(&transaction, transaction_trits, false);
+  flex_trits_to_trits(hash_trits, HASH_LENGTH_TRIT, TEST_TX_HASH, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+  for (size_t i = 0; i < transactions_num; i++) {
+    flex_trits_from_trits(hashes + i * FLEX_TRIT_SIZE_243, HASH_LENGTH_TRIT, hash_trits, HASH_LENGTH_TRIT,
+                          HASH_LENGTH_TRIT);
+    add_assign(hash_trits, HASH_LENGTH_TRIT, 1);
+  }
+
+  start = current_timestamp_ms();
+  for (size_t i = 0; i < transactions_num; i++) {
+    transaction_set_hash(&transaction, hashes + i * FLEX_TRIT_SIZE_243);
+    transaction_set_trunk(&transaction, hashes + (i % approvees_num) * FLEX_TRIT_SIZE_243);
+    transaction_set_branch(&transaction, hashes + (i % approvees_num) * FLEX_TRIT_SIZE_243);
+    if ((ret = storage_transaction_store(&connection, &transaction)) != RC_OK) {
+      fprintf(stderr, "Storing transaction failed: %d\n", ret);
+      goto teardown;
+    }
+  }
+  report("store", transactions_num, start);
+
+  start = current_timestamp_ms();
+  for (size_t i = 0; i < transactions_num; i++) {
+    if ((ret = storage_transaction_exist(&connection, TRANSACTION_FIELD_HASH, hashes + i * FLEX_TRIT_SIZE_243,
+                                         &exist)) != RC_OK ||
+        !exist) {
+      fprintf(stderr, "Checking transaction existence failed: %d\n", ret);
+      goto teardown;
+    }
+  }
+  report("exist", transactions_num, start);
+
+  start = current_timestamp_ms();
+  for (size_t i = 0; i < approvees_num; i++) {
+    hash_pack_reset(&pack);
+    if ((ret = storage_transaction_load_hashes_of_approvers(&connection, hashes + i * FLEX_TRIT_SIZE_243, &pack, 0)) !=
+            RC_OK ||
+        pack.num_loaded != BENCHMARK_APPROVERS_NUM) {
+      fprintf(stderr, "Loading approvers failed: %d\n", ret);
+      goto teardown;
+    }
+  }
+  report("load approvers", approvees_num, start);
+
+teardown:
+  if (ret == RC_OK && (!exist || pack.num_loaded != BENCHMARK_APPROVERS_NUM)) {
+    ret = RC_STORAGE_FAILED_EXECUTE;
+  }
+  storage_test_teardown(&connection, BENCHMARK_DB_PATH, STORAGE_CONNECTION_TANGLE);
+
+destroy:
+  storage_destroy();
+
+done:
+  hash_pack_free(&pack);
+  free(hashes);
+
+  return ret == RC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
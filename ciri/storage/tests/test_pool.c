@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/storage/pool.h"
+#include "ciri/storage/storage.h"
+#include "ciri/storage/test_utils.h"
+#include "ciri/storage/tests/defs.h"
+#include "common/model/transaction.h"
+
+#define TEST_POOL_READERS_MAX 2
+
+static char* tangle_test_db_path = "ciri/storage/tests/test.db";
+
+static storage_connection_config_t config;
+static storage_connection_t connection;
+static storage_pool_t pool;
+
+void setUp(void) {
+  TEST_ASSERT(storage_test_setup(&connection, &config, tangle_test_db_path, STORAGE_CONNECTION_TANGLE) == RC_OK);
+  TEST_ASSERT(storage_pool_init(&pool, &config, STORAGE_CONNECTION_TANGLE, TEST_POOL_READERS_MAX) == RC_OK);
+}
+
+void tearDown(void) {
+  TEST_ASSERT(storage_pool_destroy(&pool) == RC_OK);
+  TEST_ASSERT(storage_test_teardown(&connection, tangle_test_db_path, STORAGE_CONNECTION_TANGLE) == RC_OK);
+}
+
+static void test_pool_readers(void) {
+  storage_connection_t readers[TEST_POOL_READERS_MAX + 1];
+  storage_connection_t unknown = {.actual = NULL};
+  storage_pool_stats_t stats;
+
+  storage_pool_stats(&pool, &stats);
+  TEST_ASSERT_EQUAL_INT(0, stats.readers_open);
+
+  for (size_t i = 0; i < TEST_POOL_READERS_MAX; i++) {
+    TEST_ASSERT(storage_pool_reader_acquire(&pool, &readers[i]) == RC_OK);
+  }
+  TEST_ASSERT(storage_pool_reader_acquire(&pool, &readers[TEST_POOL_READERS_MAX]) == RC_STORAGE_POOL_EXHAUSTED);
+
+  storage_pool_stats(&pool, &stats);
+  TEST_ASSERT_EQUAL_INT(TEST_POOL_READERS_MAX, stats.readers_open);
+  TEST_ASSERT_EQUAL_INT(TEST_POOL_READERS_MAX, stats.readers_in_use);
+  TEST_ASSERT_EQUAL_INT(TEST_POOL_READERS_MAX, stats.reader_checkouts);
+  TEST_ASSERT_EQUAL_INT(1, stats.reader_exhaustions);
+
+  TEST_ASSERT(storage_pool_reader_release(&pool, &readers[0]) == RC_OK);
+  TEST_ASSERT(storage_pool_reader_release(&pool, &unknown) == RC_STORAGE_POOL_UNKNOWN_CONNECTION);
+  TEST_ASSERT(storage_pool_reader_acquire(&pool, &readers[TEST_POOL_READERS_MAX]) == RC_OK);
+  TEST_ASSERT(readers[TEST_POOL_READERS_MAX].actual == readers[0].actual);
+
+  storage_pool_stats(&pool, &stats);
+  TEST_ASSERT_EQUAL_INT(TEST_POOL_READERS_MAX, stats.readers_open);
+  TEST_ASSERT_EQUAL_INT(TEST_POOL_READERS_MAX, stats.readers_in_use);
+  TEST_ASSERT_EQUAL_INT(TEST_POOL_READERS_MAX + 1, stats.reader_checkouts);
+
+  for (size_t i = 1; i <= TEST_POOL_READERS_MAX; i++) {
+    TEST_ASSERT(storage_pool_reader_release(&pool, &readers[i]) == RC_OK);
+  }
+
+  storage_pool_stats(&pool, &stats);
+  TEST_ASSERT_EQUAL_INT(0, stats.readers_in_use);
+}
+
+static void test_pool_writer(void) {
+  flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
+  iota_transaction_t transaction;
+  storage_connection_t reader;
+  storage_connection_t const* writer = NULL;
+  storage_pool_stats_t stats;
+  bool exist = false;
+
+  flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  transaction_deserialize_from_trits(&transaction, transaction_trits, true);
+
+  TEST_ASSERT(storage_pool_reader_acquire(&pool, &reader) == RC_OK);
+  TEST_ASSERT(storage_transaction_exist(&reader, TRANSACTION_FIELD_HASH, TEST_TX_HASH, &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+
+  writer = storage_pool_writer_acquire(&pool);
+  TEST_ASSERT_NOT_NULL(writer);
+  TEST_ASSERT(storage_transaction_store(writer, &transaction) == RC_OK);
+  storage_pool_writer_release(&pool);
+
+  TEST_ASSERT(storage_transaction_exist(&reader, TRANSACTION_FIELD_HASH, TEST_TX_HASH, &exist) == RC_OK);
+  TEST_ASSERT_TRUE(exist);
+  TEST_ASSERT(storage_pool_reader_release(&pool, &reader) == RC_OK);
+
+  storage_pool_stats(&pool, &stats);
+  TEST_ASSERT_EQUAL_INT(1, stats.writer_checkouts);
+  TEST_ASSERT_EQUAL_INT(0, stats.writer_waits);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  TEST_ASSERT(storage_init() == RC_OK);
+
+  config.db_path = tangle_test_db_path;
+
+  RUN_TEST(test_pool_readers);
+  RUN_TEST(test_pool_writer);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
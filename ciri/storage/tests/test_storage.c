@@ -71,7 +71,7 @@ static void test_transaction_count(void) {
   uint64_t count = 0;
   trit_t hash[HASH_LENGTH_TRIT];
   flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
 
   flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
                          NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
@@ -92,18 +92,70 @@ static void test_transaction_count(void) {
 }
 
 static void test_transaction_store(void) {
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
 
   store_test_transaction(&transaction);
 }
 
 static void test_transaction_store_duplicate(void) {
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
 
   store_test_transaction(&transaction);
   TEST_ASSERT(storage_transaction_store(&connection, &transaction) != RC_OK);
 }
 
+static void test_transactions_store(void) {
+  uint64_t count = 0;
+  trit_t hash[HASH_LENGTH_TRIT];
+  flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
+  iota_transaction_t transactions[10] = {};
+
+  flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  transaction_deserialize_from_trits(&transactions[0], transaction_trits, true);
+  flex_trits_to_trits(hash, HASH_LENGTH_TRIT, transaction_hash(&transactions[0]), HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+
+  for (size_t i = 1; i < 10; i++) {
+    transactions[i] = transactions[0];
+    add_assign(hash, HASH_LENGTH_TRIT, 1);
+    flex_trits_from_trits(transaction_hash(&transactions[i]), HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT,
+                          HASH_LENGTH_TRIT);
+  }
+
+  TEST_ASSERT(storage_transactions_store(&connection, transactions, 0) == RC_OK);
+  TEST_ASSERT(storage_transaction_count(&connection, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(count, 0);
+
+  TEST_ASSERT(storage_transactions_store(&connection, transactions, 10) == RC_OK);
+  TEST_ASSERT(storage_transaction_count(&connection, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(count, 10);
+}
+
+static void test_transactions_store_duplicate(void) {
+  uint64_t count = 0;
+  trit_t hash[HASH_LENGTH_TRIT];
+  flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
+  iota_transaction_t transactions[3] = {};
+
+  flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  transaction_deserialize_from_trits(&transactions[0], transaction_trits, true);
+  flex_trits_to_trits(hash, HASH_LENGTH_TRIT, transaction_hash(&transactions[0]), HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+  transactions[1] = transactions[0];
+  add_assign(hash, HASH_LENGTH_TRIT, 1);
+  flex_trits_from_trits(transaction_hash(&transactions[1]), HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+  transactions[2] = transactions[0];
+
+  // The whole batch is rolled back
+  TEST_ASSERT(storage_transactions_store(&connection, transactions, 3) != RC_OK);
+  TEST_ASSERT(storage_transaction_count(&connection, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(count, 0);
+
+  TEST_ASSERT(storage_transactions_store(&connection, transactions, 2) == RC_OK);
+  TEST_ASSERT(storage_transaction_count(&connection, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(count, 2);
+}
+
 static void test_transaction_load_not_found(void) {
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
 
@@ -113,7 +165,7 @@ static void test_transaction_load_not_found(void) {
 }
 
 static void test_transaction_load_found(void) {
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
 
   store_test_transaction(&transaction);
@@ -146,7 +198,7 @@ static void test_transaction_load_found(void) {
 }
 
 static void test_transaction_load_essence_metadata(void) {
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
 
   store_test_transaction(&transaction);
@@ -178,7 +230,7 @@ static void test_transaction_load_essence_metadata(void) {
 }
 
 static void test_transaction_load_essence_attachment_metadata(void) {
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
 
   store_test_transaction(&transaction);
@@ -218,7 +270,7 @@ static void test_transaction_load_essence_attachment_metadata(void) {
 }
 
 static void test_transaction_load_essence_consensus(void) {
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
 
   store_test_transaction(&transaction);
@@ -244,7 +296,7 @@ static void test_transaction_load_essence_consensus(void) {
 
 static void test_transaction_load_metadata(void) {
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
 
   store_test_transaction(&transaction);
 
@@ -267,6 +319,52 @@ static void test_transaction_load_metadata(void) {
   TEST_ASSERT_EQUAL_INT(ptr->loaded_columns_mask.data & MASK_DATA_ALL, 0);
 }
 
+static void test_transactions_load_partial(void) {
+  iota_transaction_t transaction = {};
+  iota_transaction_t loaded_transactions[3];
+  iota_transaction_t* ptrs[3] = {&loaded_transactions[0], &loaded_transactions[1], &loaded_transactions[2]};
+  iota_stor_pack_t pack = {.models = (void**)ptrs, .capacity = 3, .num_loaded = 0, .insufficient_capacity = false};
+  hash243_queue_t hashes = NULL;
+
+  store_test_transaction(&transaction);
+  TEST_ASSERT(storage_transaction_update_snapshot_index(&connection, TEST_TX_HASH, 42) == RC_OK);
+
+  // The trunk is not stored and the hash is given twice
+  TEST_ASSERT(hash243_queue_push(&hashes, TEST_TX_HASH) == RC_OK);
+  TEST_ASSERT(hash243_queue_push(&hashes, transaction_trunk(&transaction)) == RC_OK);
+  TEST_ASSERT(hash243_queue_push(&hashes, TEST_TX_HASH) == RC_OK);
+
+  TEST_ASSERT(storage_transactions_load_partial(&connection, hashes, &pack, MODEL_TRANSACTION_ESSENCE_METADATA) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(pack.num_loaded, 3);
+  TEST_ASSERT_FALSE(pack.insufficient_capacity);
+
+  for (size_t i = 0; i < 3; i += 2) {
+    TEST_ASSERT_EQUAL_MEMORY(transaction_address(ptrs[i]), transaction_address(&transaction), FLEX_TRIT_SIZE_243);
+    TEST_ASSERT_EQUAL_MEMORY(transaction_bundle(ptrs[i]), transaction_bundle(&transaction), FLEX_TRIT_SIZE_243);
+    TEST_ASSERT_EQUAL_INT(transaction_value(ptrs[i]), transaction_value(&transaction));
+    TEST_ASSERT_EQUAL_UINT64(transaction_snapshot_index(ptrs[i]), 42);
+    TEST_ASSERT_EQUAL_INT(ptrs[i]->loaded_columns_mask.essence, MASK_ESSENCE_ALL);
+    TEST_ASSERT_EQUAL_INT(ptrs[i]->loaded_columns_mask.metadata, MASK_METADATA_ALL);
+    TEST_ASSERT_EQUAL_INT(ptrs[i]->loaded_columns_mask.attachment & MASK_ATTACHMENT_ALL, 0);
+  }
+  TEST_ASSERT_EQUAL_INT(ptrs[1]->loaded_columns_mask.essence, 0);
+  TEST_ASSERT_EQUAL_INT(ptrs[1]->loaded_columns_mask.metadata, 0);
+
+  TEST_ASSERT(storage_transactions_load_partial(&connection, hashes, &pack, MODEL_TRANSACTION) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(pack.num_loaded, 3);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(ptrs[2]), TEST_TX_HASH, FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_signature(ptrs[2]), transaction_signature(&transaction), FLEX_TRIT_SIZE_6561);
+  TEST_ASSERT_EQUAL_INT(ptrs[1]->loaded_columns_mask.data, 0);
+
+  pack.capacity = 2;
+  TEST_ASSERT(storage_transactions_load_partial(&connection, hashes, &pack, MODEL_TRANSACTION_METADATA) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(pack.num_loaded, 0);
+  TEST_ASSERT_TRUE(pack.insufficient_capacity);
+
+  hash243_queue_free(&hashes);
+}
+
 static void test_transaction_exist_false(void) {
   bool exist;
 
@@ -280,7 +378,7 @@ static void test_transaction_exist_false(void) {
 }
 
 static void test_transaction_exist_true(void) {
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   bool exist;
 
   store_test_transaction(&transaction);
@@ -296,7 +394,7 @@ static void test_transaction_exist_true(void) {
 
 static void test_transaction_update_snapshot_index(void) {
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
 
   store_test_transaction(&transaction);
 
@@ -311,7 +409,7 @@ static void test_transaction_update_snapshot_index(void) {
 
 static void test_transaction_update_solidity(void) {
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
 
   store_test_transaction(&transaction);
 
@@ -326,7 +424,7 @@ static void test_transaction_update_solidity(void) {
 
 static void test_transaction_update_validity(void) {
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
 
   store_test_transaction(&transaction);
 
@@ -342,7 +440,7 @@ static void test_transaction_update_validity(void) {
 static void test_transaction_load_hashes_insufficient_capacity(void) {
   trit_t hash[HASH_LENGTH_TRIT];
   flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   iota_stor_pack_t pack;
 
   hash_pack_init(&pack, 5);
@@ -372,7 +470,7 @@ static void test_transaction_load_hashes(void) {
   flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
   flex_trit_t first_address[FLEX_TRIT_SIZE_243];
   flex_trit_t second_address[FLEX_TRIT_SIZE_243];
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   iota_stor_pack_t pack;
   hash243_set_t first_cmp_set = NULL;
   hash243_set_t second_cmp_set = NULL;
@@ -429,7 +527,7 @@ static void test_transaction_load_hashes_of_approvers_no_timestamp(void) {
   uint64_t count = 0;
   trit_t hash[HASH_LENGTH_TRIT];
   flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   iota_stor_pack_t pack;
   hash243_set_t cmp_set = NULL;
 
@@ -475,7 +573,7 @@ static void test_transaction_load_hashes_of_approvers_timestamp(void) {
   uint64_t count = 0;
   trit_t hash[HASH_LENGTH_TRIT];
   flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   iota_stor_pack_t pack;
   hash243_set_t cmp_set = NULL;
 
@@ -527,7 +625,7 @@ static void test_transaction_load_hashes_of_approvers_timestamp(void) {
 static void test_transaction_load_hashes_of_milestone_candidates(void) {
   trit_t hash[HASH_LENGTH_TRIT];
   flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   iota_milestone_t milestone;
   iota_stor_pack_t pack;
   hash243_set_t cmp_set = NULL;
@@ -569,7 +667,7 @@ static void test_transaction_approvers_count(void) {
   uint64_t count = 0;
   trit_t hash[HASH_LENGTH_TRIT];
   flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
 
   flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
                          NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
@@ -604,7 +702,7 @@ static void test_transaction_find(void) {
 }
 
 static void test_transaction_delete(void) {
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   bool exist;
 
   store_test_transaction(&transaction);
@@ -621,7 +719,7 @@ static void test_transaction_delete(void) {
 
 static void test_transactions_metadata_clear(void) {
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
 
   store_test_transaction(&transaction);
 
@@ -642,7 +740,7 @@ static void test_transactions_update_snapshot_index(void) {
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
   trit_t hash[HASH_LENGTH_TRIT];
   flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   hash243_set_t hashes = NULL;
 
   flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
@@ -683,7 +781,7 @@ static void test_transactions_update_solidity(void) {
   DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
   trit_t hash[HASH_LENGTH_TRIT];
   flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   hash243_set_t hashes = NULL;
 
   flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
@@ -724,7 +822,7 @@ static void test_transactions_delete(void) {
   uint64_t count = 0;
   trit_t hash[HASH_LENGTH_TRIT];
   flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t transaction;
+  iota_transaction_t transaction = {};
   hash243_set_t hashes = NULL;
 
   flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
@@ -736,7 +834,8 @@ static void test_transactions_delete(void) {
 
   flex_trits_to_trits(hash, HASH_LENGTH_TRIT, transaction_hash(&transaction), HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
 
-  for (size_t i = 0; i < 10; i++) {
+  // More transactions than a batched delete statement deletes at once
+  for (size_t i = 0; i < 200; i++) {
     flex_trits_from_trits(transaction_hash(&transaction), HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
     TEST_ASSERT(storage_transaction_store(&connection, &transaction) == RC_OK);
     if (i % 2) {
@@ -746,14 +845,230 @@ static void test_transactions_delete(void) {
   }
 
   TEST_ASSERT(storage_transaction_count(&connection, &count) == RC_OK);
-  TEST_ASSERT_EQUAL_INT(count, 10);
+  TEST_ASSERT_EQUAL_INT(count, 200);
 
   TEST_ASSERT(storage_transactions_delete(&connection, hashes) == RC_OK);
 
   TEST_ASSERT(storage_transaction_count(&connection, &count) == RC_OK);
-  TEST_ASSERT_EQUAL_INT(count, 5);
+  TEST_ASSERT_EQUAL_INT(count, 100);
 
+  TEST_ASSERT(storage_compact(&connection, 0) == RC_OK);
+
+  hash243_set_free(&hashes);
+}
+
+// More transactions than two full chunks of any batched statement and not a multiple of any chunk size, so that every
+// batched store, update and delete spans several chunks with a partial last one
+#define TEST_CHUNKS_TRANSACTIONS 519
+
+static void test_transactions_chunks(void) {
+  DECLARE_PACK_SINGLE_TX(loaded_transaction, ptr, pack);
+  uint64_t count = 0;
+  trit_t hash[HASH_LENGTH_TRIT];
+  flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
+  iota_transaction_t* transactions = NULL;
+  hash243_set_t hashes = NULL;
+
+  transactions = (iota_transaction_t*)calloc(TEST_CHUNKS_TRANSACTIONS, sizeof(iota_transaction_t));
+  TEST_ASSERT_NOT_NULL(transactions);
+  flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  transaction_deserialize_from_trits(&transactions[0], transaction_trits, true);
+  flex_trits_to_trits(hash, HASH_LENGTH_TRIT, transaction_hash(&transactions[0]), HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+
+  for (size_t i = 1; i < TEST_CHUNKS_TRANSACTIONS; i++) {
+    transactions[i] = transactions[0];
+    add_assign(hash, HASH_LENGTH_TRIT, 1);
+    flex_trits_from_trits(transaction_hash(&transactions[i]), HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT,
+                          HASH_LENGTH_TRIT);
+  }
+  // Half of them, still more than two chunks of an array bound statement
+  for (size_t i = 1; i < TEST_CHUNKS_TRANSACTIONS; i += 2) {
+    TEST_ASSERT(hash243_set_add(&hashes, transaction_hash(&transactions[i])) == RC_OK);
+  }
+
+  TEST_ASSERT(storage_transactions_store(&connection, transactions, TEST_CHUNKS_TRANSACTIONS) == RC_OK);
+  TEST_ASSERT(storage_transaction_count(&connection, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TEST_CHUNKS_TRANSACTIONS, count);
+
+  TEST_ASSERT(storage_transactions_update_snapshot_index(&connection, hashes, 42) == RC_OK);
+  TEST_ASSERT(storage_transactions_update_solidity(&connection, hashes, true) == RC_OK);
+
+  for (size_t i = 0; i < TEST_CHUNKS_TRANSACTIONS; i++) {
+    hash_pack_reset(&pack);
+    TEST_ASSERT(storage_transaction_load_metadata(&connection, transaction_hash(&transactions[i]), &pack) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+    TEST_ASSERT_EQUAL_UINT64(i % 2 ? 42 : 0, transaction_snapshot_index(ptr));
+    TEST_ASSERT_EQUAL_INT(i % 2 == 1, transaction_solid(ptr));
+  }
+
+  TEST_ASSERT(storage_transactions_delete(&connection, hashes) == RC_OK);
+  TEST_ASSERT(storage_transaction_count(&connection, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TEST_CHUNKS_TRANSACTIONS - hash243_set_size(hashes), count);
+
+  hash243_set_free(&hashes);
+  free(transactions);
+}
+
+#define TEST_CURSOR_TRANSACTIONS 25
+#define TEST_CURSOR_BATCH 4
+
+// Stores transactions of the test address approving the test transaction through their trunk
+static void store_cursor_transactions(hash243_set_t* const hashes) {
+  trit_t hash[HASH_LENGTH_TRIT];
+  flex_trit_t transaction_trits[FLEX_TRIT_SIZE_8019];
+  iota_transaction_t transaction = {};
+
+  flex_trits_from_trytes(transaction_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  transaction_deserialize_from_trits(&transaction, transaction_trits, true);
+  flex_trits_to_trits(hash, HASH_LENGTH_TRIT, TEST_TX_HASH, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+
+  for (size_t i = 0; i < TEST_CURSOR_TRANSACTIONS; i++) {
+    add_assign(hash, HASH_LENGTH_TRIT, 1);
+    flex_trits_from_trits(transaction_hash(&transaction), HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+    memcpy(transaction_trunk(&transaction), TEST_TX_HASH, FLEX_TRIT_SIZE_243);
+    transaction_set_value(&transaction, i);
+    TEST_ASSERT(storage_transaction_store(&connection, &transaction) == RC_OK);
+    TEST_ASSERT(hash243_set_add(hashes, transaction_hash(&transaction)) == RC_OK);
+  }
+}
+
+static void test_cursor(void) {
+  iota_transaction_t transaction = {};
+  iota_transaction_t loaded_transactions[TEST_CURSOR_BATCH];
+  iota_transaction_t* ptrs[TEST_CURSOR_BATCH];
+  iota_stor_pack_t tx_pack = {
+      .models = (void**)ptrs, .capacity = TEST_CURSOR_BATCH, .num_loaded = 0, .insufficient_capacity = false};
+  iota_stor_pack_t pack;
+  iota_stor_pack_t approvers_pack;
+  storage_cursor_t cursor;
+  storage_cursor_t approvers_cursor;
+  hash243_set_t hashes = NULL;
+  hash243_set_t loaded = NULL;
+  size_t batches = 0;
+  uint64_t values = 0;
+
+  for (size_t i = 0; i < TEST_CURSOR_BATCH; i++) {
+    ptrs[i] = &loaded_transactions[i];
+  }
+  hash_pack_init(&pack, TEST_CURSOR_BATCH);
+  hash_pack_init(&approvers_pack, TEST_CURSOR_BATCH);
+
+  store_test_transaction(&transaction);
+  store_cursor_transactions(&hashes);
+
+  // Hashes are streamed by batches of the capacity of the pack
+  TEST_ASSERT(storage_cursor_open(&connection, &cursor, CURSOR_QUERY_ADDRESS, transaction_address(&transaction),
+                                  MODEL_HASH) == RC_OK);
+  while (storage_cursor_next(&cursor, &pack) == RC_OK && pack.num_loaded != 0) {
+    TEST_ASSERT_FALSE(pack.insufficient_capacity);
+    for (size_t i = 0; i < pack.num_loaded; i++) {
+      TEST_ASSERT(hash243_set_add(&loaded, pack.models[i]) == RC_OK);
+    }
+    batches++;
+  }
+  TEST_ASSERT_TRUE(cursor.exhausted);
+  TEST_ASSERT(storage_cursor_close(&cursor) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TEST_CURSOR_TRANSACTIONS + 1, hash243_set_size(loaded));
+  TEST_ASSERT_EQUAL_INT((TEST_CURSOR_TRANSACTIONS + TEST_CURSOR_BATCH) / TEST_CURSOR_BATCH, batches);
+  hash243_set_free(&loaded);
+
+  // Partial transactions are loaded with their hash, models keeping nothing of a previous load
+  memset(loaded_transactions, 0xFF, sizeof(loaded_transactions));
+  TEST_ASSERT(storage_cursor_open(&connection, &cursor, CURSOR_QUERY_ADDRESS, transaction_address(&transaction),
+                                  MODEL_TRANSACTION_ESSENCE_METADATA) == RC_OK);
+  while (storage_cursor_next(&cursor, &tx_pack) == RC_OK && tx_pack.num_loaded != 0) {
+    for (size_t i = 0; i < tx_pack.num_loaded; i++) {
+      TEST_ASSERT_EQUAL_MEMORY(transaction_address(ptrs[i]), transaction_address(&transaction), FLEX_TRIT_SIZE_243);
+      TEST_ASSERT_EQUAL_INT(ptrs[i]->loaded_columns_mask.metadata, MASK_METADATA_ALL);
+      TEST_ASSERT_EQUAL_INT(0, ptrs[i]->loaded_columns_mask.attachment);
+      TEST_ASSERT_EQUAL_INT(0, ptrs[i]->loaded_columns_mask.data);
+      TEST_ASSERT(hash243_set_add(&loaded, transaction_hash(ptrs[i])) == RC_OK);
+      values += transaction_value(ptrs[i]);
+    }
+  }
+  TEST_ASSERT(storage_cursor_close(&cursor) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TEST_CURSOR_TRANSACTIONS + 1, hash243_set_size(loaded));
+  TEST_ASSERT_EQUAL_INT(transaction_value(&transaction) + TEST_CURSOR_TRANSACTIONS * (TEST_CURSOR_TRANSACTIONS - 1) / 2,
+                        values);
+  hash243_set_free(&loaded);
+
+  // All transactions are streamed without a key
+  TEST_ASSERT(storage_cursor_open(&connection, &cursor, CURSOR_QUERY_TRANSACTIONS, NULL, MODEL_HASH) == RC_OK);
+  while (storage_cursor_next(&cursor, &pack) == RC_OK && pack.num_loaded != 0) {
+    for (size_t i = 0; i < pack.num_loaded; i++) {
+      TEST_ASSERT(hash243_set_add(&loaded, pack.models[i]) == RC_OK);
+    }
+  }
+  TEST_ASSERT(storage_cursor_close(&cursor) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TEST_CURSOR_TRANSACTIONS + 1, hash243_set_size(loaded));
+  TEST_ASSERT_TRUE(hash243_set_contains(loaded, TEST_TX_HASH));
+  hash243_set_free(&loaded);
+
+  // Cursors can be nested
+  TEST_ASSERT(storage_cursor_open(&connection, &cursor, CURSOR_QUERY_APPROVERS, TEST_TX_HASH, MODEL_HASH) == RC_OK);
+  TEST_ASSERT(storage_cursor_next(&cursor, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TEST_CURSOR_BATCH, pack.num_loaded);
+  TEST_ASSERT(storage_cursor_open(&connection, &approvers_cursor, CURSOR_QUERY_APPROVERS, TEST_TX_HASH, MODEL_HASH) ==
+              RC_OK);
+  while (storage_cursor_next(&approvers_cursor, &approvers_pack) == RC_OK && approvers_pack.num_loaded != 0) {
+    for (size_t i = 0; i < approvers_pack.num_loaded; i++) {
+      TEST_ASSERT_TRUE(hash243_set_contains(hashes, approvers_pack.models[i]));
+      TEST_ASSERT(hash243_set_add(&loaded, approvers_pack.models[i]) == RC_OK);
+    }
+  }
+  TEST_ASSERT(storage_cursor_close(&approvers_cursor) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TEST_CURSOR_TRANSACTIONS, hash243_set_size(loaded));
+  hash243_set_free(&loaded);
+
+  do {
+    for (size_t i = 0; i < pack.num_loaded; i++) {
+      TEST_ASSERT_TRUE(hash243_set_contains(hashes, pack.models[i]));
+      TEST_ASSERT(hash243_set_add(&loaded, pack.models[i]) == RC_OK);
+    }
+  } while (storage_cursor_next(&cursor, &pack) == RC_OK && pack.num_loaded != 0);
+  TEST_ASSERT(storage_cursor_close(&cursor) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TEST_CURSOR_TRANSACTIONS, hash243_set_size(loaded));
+
+  hash_pack_free(&pack);
+  hash_pack_free(&approvers_pack);
+  hash243_set_free(&hashes);
+  hash243_set_free(&loaded);
+}
+
+static void test_cursor_find(void) {
+  iota_transaction_t transaction = {};
+  iota_stor_pack_t pack;
+  storage_cursor_t cursor;
+  hash243_queue_t addresses = NULL;
+  hash243_queue_t approvees = NULL;
+  hash243_set_t hashes = NULL;
+  hash243_set_t loaded = NULL;
+
+  hash_pack_init(&pack, TEST_CURSOR_BATCH);
+
+  store_test_transaction(&transaction);
+  store_cursor_transactions(&hashes);
+
+  TEST_ASSERT(hash243_queue_push(&addresses, transaction_address(&transaction)) == RC_OK);
+  TEST_ASSERT(hash243_queue_push(&approvees, TEST_TX_HASH) == RC_OK);
+
+  TEST_ASSERT(storage_cursor_find_open(&connection, &cursor, NULL, addresses, NULL, approvees) == RC_OK);
+  while (storage_cursor_next(&cursor, &pack) == RC_OK && pack.num_loaded != 0) {
+    for (size_t i = 0; i < pack.num_loaded; i++) {
+      TEST_ASSERT_TRUE(hash243_set_contains(hashes, pack.models[i]));
+      TEST_ASSERT(hash243_set_add(&loaded, pack.models[i]) == RC_OK);
+    }
+  }
+  TEST_ASSERT(storage_cursor_close(&cursor) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TEST_CURSOR_TRANSACTIONS, hash243_set_size(loaded));
+
+  hash_pack_free(&pack);
+  hash243_queue_free(&addresses);
+  hash243_queue_free(&approvees);
   hash243_set_free(&hashes);
+  hash243_set_free(&loaded);
 }
 
 static void test_bundle_update_validity(void) {}
@@ -1062,12 +1377,15 @@ int main(void) {
   RUN_TEST(test_transaction_count);
   RUN_TEST(test_transaction_store);
   RUN_TEST(test_transaction_store_duplicate);
+  RUN_TEST(test_transactions_store);
+  RUN_TEST(test_transactions_store_duplicate);
   RUN_TEST(test_transaction_load_not_found);
   RUN_TEST(test_transaction_load_found);
   RUN_TEST(test_transaction_load_essence_metadata);
   RUN_TEST(test_transaction_load_essence_attachment_metadata);
   RUN_TEST(test_transaction_load_essence_consensus);
   RUN_TEST(test_transaction_load_metadata);
+  RUN_TEST(test_transactions_load_partial);
   RUN_TEST(test_transaction_exist_false);
   RUN_TEST(test_transaction_exist_true);
   RUN_TEST(test_transaction_update_snapshot_index);
@@ -1085,6 +1403,9 @@ int main(void) {
   RUN_TEST(test_transactions_update_snapshot_index);
   RUN_TEST(test_transactions_update_solidity);
   RUN_TEST(test_transactions_delete);
+  RUN_TEST(test_transactions_chunks);
+  RUN_TEST(test_cursor);
+  RUN_TEST(test_cursor_find);
 
   RUN_TEST(test_bundle_update_validity);
 
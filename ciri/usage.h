@@ -17,19 +17,36 @@ typedef enum cli_arg_value_e {
 
   CONF_SPENT_ADDRESSES_DB_PATH,
   CONF_TANGLE_DB_PATH,
+  CONF_TANGLE_DB_READERS,
   CONF_TANGLE_DB_REVALIDATE,
+  CONF_TANGLE_CACHE_SIZE,
+  CONF_TANGLE_GRAPH_ENABLED,
+  CONF_TANGLE_FILTER_SIZE,
+  CONF_TANGLE_FILTER_FALSE_POSITIVE_RATE,
 
   // Node configuration
 
   CONF_AUTO_TETHERING_ENABLED,
+  CONF_HASHER_BATCH_DELAY,
+  CONF_HASHER_BATCH_FILL,
+  CONF_HASHER_THREADS,
   CONF_MAX_NEIGHBORS,
   CONF_MWM,
+  CONF_NEIGHBOR_INGRESS_RATE,
   CONF_NEIGHBORING_ADDRESS,
   CONF_P_SEND_MILESTONE,
+  CONF_PIPELINE_QUEUE_SIZE,
+  CONF_RECENT_SEEN_BYTES_CACHE_SHARDS,
   CONF_RECENT_SEEN_BYTES_CACHE_SIZE,
   CONF_RECONNECT_ATTEMPT_INTERVAL,
   CONF_REQUESTER_QUEUE_SIZE,
+  CONF_REQUESTER_RETRY_INTERVAL,
+  CONF_ROUTER_THREADS,
+  CONF_STORE_BATCH_DELAY,
+  CONF_STORE_BATCH_SIZE,
   CONF_TIPS_CACHE_SIZE,
+  CONF_TRANSACTION_BYTES_CACHE_SIZE,
+  CONF_VALIDATOR_THREADS,
 
   // API configuration
 
@@ -45,6 +62,8 @@ typedef enum cli_arg_value_e {
   CONF_COORDINATOR_DEPTH,
   CONF_COORDINATOR_SECURITY_LEVEL,
   CONF_COORDINATOR_SIGNATURE_TYPE,
+  CONF_CW_RATING_CALCULATOR,
+  CONF_CW_RATING_THREADS,
   CONF_LAST_MILESTONE,
   CONF_MAX_DEPTH,
   CONF_SNAPSHOT_FILE,
@@ -87,8 +106,22 @@ static struct cli_argument_s {
     {"spent-addresses-db-path", CONF_SPENT_ADDRESSES_DB_PATH, "Path to the spent addresses database file.",
      REQUIRED_ARG},
     {"tangle-db-path", CONF_TANGLE_DB_PATH, "Path to the tangle database file.", REQUIRED_ARG},
+    {"tangle-db-readers", CONF_TANGLE_DB_READERS,
+     "Maximum number of pooled read-only connections to the tangle database, 0 disables the pool.", REQUIRED_ARG},
     {"tangle-db-revalidate", CONF_TANGLE_DB_REVALIDATE,
      "Reloads milestones, state of the ledger and transactions metadata from the tangle database.", REQUIRED_ARG},
+    {"tangle-cache-size", CONF_TANGLE_CACHE_SIZE,
+     "Number of transactions whose partially loaded fields are cached, 0 disables the cache.", REQUIRED_ARG},
+    {"tangle-graph-enabled", CONF_TANGLE_GRAPH_ENABLED,
+     "Keeps the graph of the tangle and the metadata of its transactions in memory to speed up traversals.",
+     REQUIRED_ARG},
+    {"tangle-filter-size", CONF_TANGLE_FILTER_SIZE,
+     "Number of transactions the filter answering existence checks without querying the database can hold, 0 "
+     "disables the filter.",
+     REQUIRED_ARG},
+    {"tangle-filter-false-positive-rate", CONF_TANGLE_FILTER_FALSE_POSITIVE_RATE,
+     "Maximum rate of absent transactions the filter reports as possibly present. Value must be in ]0,1[.",
+     REQUIRED_ARG},
 
     // Node configuration
 
@@ -96,11 +129,24 @@ static struct cli_argument_s {
      "Whether to accept new connections from unknown neighbors (which are not defined in the config and were not added "
      "via addNeighbors).",
      REQUIRED_ARG},
+    {"hasher-batch-delay", CONF_HASHER_BATCH_DELAY,
+     "Maximum time (in microseconds) a transaction waits for other transactions to be hashed together, 0 hashes queued "
+     "transactions right away.",
+     REQUIRED_ARG},
+    {"hasher-batch-fill", CONF_HASHER_BATCH_FILL,
+     "Percentage of the lanes of a Curl transform a hasher thread waits to fill before hashing. Value must be in "
+     "[1,100].",
+     REQUIRED_ARG},
+    {"hasher-threads", CONF_HASHER_THREADS, "Number of threads hashing incoming transactions.", REQUIRED_ARG},
     {"max-neighbors", CONF_MAX_NEIGHBORS, "The maximum number of neighbors allowed to be connected.", REQUIRED_ARG},
     {"mwm", CONF_MWM,
      "Number of trailing ternary 0s that must appear at the end of a "
      "transaction hash. Difficulty can be described as 3^mwm.",
      REQUIRED_ARG},
+    {"neighbor-ingress-rate", CONF_NEIGHBOR_INGRESS_RATE,
+     "Maximum number of transactions per second received from a neighbor, lowered for neighbors sending invalid or "
+     "stale transactions. 0 for no limit.",
+     REQUIRED_ARG},
     {"neighboring-address", CONF_NEIGHBORING_ADDRESS, "The address to bind the TCP server socket to.", REQUIRED_ARG},
     {"neighboring-port", 't', "The TCP receiver port.", REQUIRED_ARG},
     {"neighbors", 'n', "URIs of neighbouring nodes, separated by a space.", REQUIRED_ARG},
@@ -108,15 +154,39 @@ static struct cli_argument_s {
      "Probability of sending a milestone transaction when the node looks for a "
      "random transaction to send to a neighbor. Value must be in [0,1].",
      REQUIRED_ARG},
+    {"pipeline-queue-size", CONF_PIPELINE_QUEUE_SIZE,
+     "Maximum number of packets queued in front of each stage of the processing pipeline. Packets are dropped when a "
+     "queue is full.",
+     REQUIRED_ARG},
+    {"recent-seen-bytes-cache-shards", CONF_RECENT_SEEN_BYTES_CACHE_SHARDS,
+     "The number of independently locked shards of the network cache, rounded up to a power of two.", REQUIRED_ARG},
     {"recent-seen-bytes-cache-size", CONF_RECENT_SEEN_BYTES_CACHE_SIZE,
      "The number of entries to keep in the network cache.", REQUIRED_ARG},
     {"reconnect-attempt-interval", CONF_RECONNECT_ATTEMPT_INTERVAL,
      "The interval (in seconds) at which to reconnect to neighbors.", REQUIRED_ARG},
     {"requester-queue-size", CONF_REQUESTER_QUEUE_SIZE, "Size of the transaction requester queue.", REQUIRED_ARG},
+    {"requester-retry-interval", CONF_REQUESTER_RETRY_INTERVAL,
+     "Interval (in milliseconds) before a missing transaction is requested again, doubled after each attempt.",
+     REQUIRED_ARG},
+    {"router-threads", CONF_ROUTER_THREADS,
+     "Number of threads running an event loop for neighbors, each neighbor being served by a single one.",
+     REQUIRED_ARG},
+    {"store-batch-delay", CONF_STORE_BATCH_DELAY,
+     "Maximum time (in microseconds) a new transaction waits to be stored together with other new transactions.",
+     REQUIRED_ARG},
+    {"store-batch-size", CONF_STORE_BATCH_SIZE,
+     "Maximum number of new transactions stored in a single database transaction. 1 stores transactions one by one.",
+     REQUIRED_ARG},
     {"tips-cache-size", CONF_TIPS_CACHE_SIZE,
      "Size of the tips cache. Also bounds the number of tips returned by "
      "getTips API call.",
      REQUIRED_ARG},
+    {"transaction-bytes-cache-size", CONF_TRANSACTION_BYTES_CACHE_SIZE,
+     "Number of transactions whose gossip bytes are cached to answer requests without loading them, 0 disables it.",
+     REQUIRED_ARG},
+    {"validator-threads", CONF_VALIDATOR_THREADS,
+     "Number of threads validating and storing incoming transactions, each one using its own database connection.",
+     REQUIRED_ARG},
 
     // API configuration
 
@@ -152,6 +222,14 @@ static struct cli_argument_s {
     {"coordinator-signature-type", CONF_COORDINATOR_SIGNATURE_TYPE,
      "The signature type used in coordinator signatures. Valid types: \"CURL_P27\", \"CURL_P81\" and \"KERL\".",
      REQUIRED_ARG},
+    {"cw-rating-calculator", CONF_CW_RATING_CALCULATOR,
+     "Implementation calculating the cumulative weights of the tip selection. Valid implementations: \"DFS\" and "
+     "\"BITSET\".",
+     REQUIRED_ARG},
+    {"cw-rating-threads", CONF_CW_RATING_THREADS,
+     "Number of threads of the BITSET cumulative weights calculator, wide layers of the subtangle being shared "
+     "between them.",
+     REQUIRED_ARG},
     {"last-milestone", CONF_LAST_MILESTONE,
      "The index of the last milestone issued by the corrdinator before the "
      "last snapshot.",
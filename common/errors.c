@@ -77,6 +77,7 @@ const char* error_2_string(retcode_t err) {
     case RC_CONSENSUS_NOT_IMPLEMENTED:
     case RC_CW_FAILED_IN_DFS_FROM_DB:
     case RC_CW_FAILED_IN_LIGHT_DFS:
+    case RC_CW_FAILED_IN_PROPAGATION:
     case RC_EXIT_PROBABILITIES_INVALID_ENTRYPOINT:
 
     // Utils module
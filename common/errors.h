@@ -156,6 +156,9 @@ enum retcode_t {
   RC_STORAGE_FAILED_SET_ATTR = 0x12 | RC_MODULE_STORAGE | RC_SEVERITY_FATAL,
   RC_STORAGE_FAILED_INIT_STATEMENT = 0x13 | RC_MODULE_STORAGE | RC_SEVERITY_MAJOR,
   RC_STORAGE_FAILED_CLOSE_STATEMENT = 0x14 | RC_MODULE_STORAGE | RC_SEVERITY_MAJOR,
+  RC_STORAGE_POOL_EXHAUSTED = 0x15 | RC_MODULE_STORAGE | RC_SEVERITY_MINOR,
+  RC_STORAGE_POOL_UNKNOWN_CONNECTION = 0x16 | RC_MODULE_STORAGE | RC_SEVERITY_MAJOR,
+  RC_STORAGE_CURSOR_BUSY = 0x17 | RC_MODULE_STORAGE | RC_SEVERITY_MINOR,
 
   // Neighbor Module
   RC_NEIGHBOR_FAILED_URI_PARSING = 0x01 | RC_MODULE_NEIGHBOR | RC_SEVERITY_MAJOR,
@@ -196,6 +199,7 @@ enum retcode_t {
   // Consensus CW Module
   RC_CW_FAILED_IN_DFS_FROM_DB = 0x01 | RC_MODULE_CW | RC_SEVERITY_MAJOR,
   RC_CW_FAILED_IN_LIGHT_DFS = 0x02 | RC_MODULE_CW | RC_SEVERITY_MAJOR,
+  RC_CW_FAILED_IN_PROPAGATION = 0x03 | RC_MODULE_CW | RC_SEVERITY_MAJOR,
 
   // Consensus Exit Probabilities Module
   RC_EXIT_PROBABILITIES_INVALID_ENTRYPOINT = 0x01 | RC_MODULE_EXIT_PROBABILITIES | RC_SEVERITY_MAJOR,
@@ -233,6 +237,7 @@ enum retcode_t {
   // Tangle Module
   RC_TANGLE_TAIL_NOT_FOUND = 0x01 | RC_MODULE_TANGLE | RC_SEVERITY_MODERATE,
   RC_TANGLE_NOT_A_TAIL = 0x02 | RC_MODULE_TANGLE | RC_SEVERITY_MODERATE,
+  RC_TANGLE_OTHER_DATABASE = 0x03 | RC_MODULE_TANGLE | RC_SEVERITY_MAJOR,
 
   // Utils Module
   RC_UTILS_FAILED_REMOVE_FILE = 0x01 | RC_MODULE_UTILS | RC_SEVERITY_MAJOR,
@@ -258,6 +263,7 @@ enum retcode_t {
   RC_UTILS_SOCKET_RECV = 0x15 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
   RC_UTILS_SOCKET_SEND = 0x16 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
   RC_UTILS_BUNDLE_MINER_BAD_PARAM = 0x17 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
+  RC_UTILS_RING_BUFFER_FULL = 0x18 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
 
   // Processor component Module
   RC_PROCESSOR_INVALID_TRANSACTION = 0x01 | RC_MODULE_PROCESSOR | RC_SEVERITY_MODERATE,
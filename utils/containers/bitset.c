@@ -19,13 +19,14 @@ void bitset_reset(bitset_t* const bitset) {
 }
 
 bool bitset_is_set(bitset_t* const bitset, size_t pos) {
-  bitset->bitset_integer_index = pos / (sizeof(*bitset) * 8);
-  bitset->bitset_relative_index = pos % (sizeof(*bitset) * 8);
+  bitset->bitset_integer_index = pos / (sizeof(*bitset->raw_bits) * 8);
+  bitset->bitset_relative_index = pos % (sizeof(*bitset->raw_bits) * 8);
 
   return bitset->raw_bits[bitset->bitset_integer_index] & (1ULL << bitset->bitset_relative_index);
 }
 
 void bitset_set_true(bitset_t* const bitset, size_t pos) {
-  bitset->bitset_integer_index = pos / (sizeof(*bitset) * 8);
-  bitset->raw_bits[bitset->bitset_integer_index] |= (1ULL << pos);
+  bitset->bitset_integer_index = pos / (sizeof(*bitset->raw_bits) * 8);
+  bitset->bitset_relative_index = pos % (sizeof(*bitset->raw_bits) * 8);
+  bitset->raw_bits[bitset->bitset_integer_index] |= (1ULL << bitset->bitset_relative_index);
 }
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xxhash.h"
+
+#include "utils/containers/bloom_filter.h"
+
+/*
+ * Private functions
+ */
+
+static inline size_t bloom_filter_position(bloom_filter_t const *const filter, uint64_t const digest, size_t const i) {
+  uint32_t const h1 = (uint32_t)digest;
+  uint32_t const h2 = (uint32_t)(digest >> 32) | 1;
+
+  return ((uint64_t)h1 + i * (uint64_t)h2) % filter->bits_num;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t bloom_filter_init(bloom_filter_t *const filter, size_t const capacity, double const false_positive_rate) {
+  double bits_per_element = 0;
+
+  if (filter == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (capacity == 0 || false_positive_rate <= 0 || false_positive_rate >= 1) {
+    return RC_INVALID_PARAM;
+  }
+
+  // Optimal sizing: m = -n * ln(p) / ln(2)^2 bits and k = m / n * ln(2) hashes
+  bits_per_element = -log(false_positive_rate) / (M_LN2 * M_LN2);
+  filter->bits_num = (size_t)ceil(capacity * bits_per_element);
+  filter->bits_num = (filter->bits_num + 63) & ~(size_t)63;
+  filter->hashes_num = (size_t)round(bits_per_element * M_LN2);
+  if (filter->hashes_num == 0) {
+    filter->hashes_num = 1;
+  }
+  filter->capacity = capacity;
+  filter->size = 0;
+
+  if ((filter->bits = (uint64_t *)calloc(filter->bits_num / 64, sizeof(uint64_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  return RC_OK;
+}
+
+void bloom_filter_destroy(bloom_filter_t *const filter) {
+  if (filter == NULL) {
+    return;
+  }
+
+  free(filter->bits);
+  filter->bits = NULL;
+  filter->bits_num = 0;
+}
+
+void bloom_filter_reset(bloom_filter_t *const filter) {
+  if (filter == NULL) {
+    return;
+  }
+
+  memset(filter->bits, 0, filter->bits_num / 8);
+  filter->size = 0;
+}
+
+void bloom_filter_add(bloom_filter_t *const filter, void const *const data, size_t const length) {
+  uint64_t digest = 0;
+  size_t position = 0;
+
+  if (filter == NULL || data == NULL) {
+    return;
+  }
+
+  digest = XXH64(data, length, 0);
+  for (size_t i = 0; i < filter->hashes_num; i++) {
+    position = bloom_filter_position(filter, digest, i);
+    filter->bits[position / 64] |= (uint64_t)1 << (position % 64);
+  }
+  filter->size++;
+}
+
+bool bloom_filter_contains(bloom_filter_t const *const filter, void const *const data, size_t const length) {
+  uint64_t digest = 0;
+  size_t position = 0;
+
+  if (filter == NULL || data == NULL) {
+    return false;
+  }
+
+  digest = XXH64(data, length, 0);
+  for (size_t i = 0; i < filter->hashes_num; i++) {
+    position = bloom_filter_position(filter, digest, i);
+    if ((filter->bits[position / 64] & ((uint64_t)1 << (position % 64))) == 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
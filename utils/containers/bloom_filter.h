@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __UTILS_CONTAINERS_BLOOM_FILTER_H__
+#define __UTILS_CONTAINERS_BLOOM_FILTER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A fixed size Bloom filter
+ *
+ * Answers membership queries with no false negatives and a bounded rate of false positives. The bit positions of an
+ * element are derived from a single 64 bits hash by double hashing. Elements can not be removed, only the whole filter
+ * can be reset.
+ */
+typedef struct bloom_filter_s {
+  uint64_t *bits;     /*!< The bits */
+  size_t bits_num;    /*!< Number of bits */
+  size_t hashes_num;  /*!< Number of bit positions per element */
+  size_t capacity;    /*!< Number of elements the filter is sized for */
+  size_t size;        /*!< Number of elements added since the last reset, including duplicates */
+} bloom_filter_t;
+
+/**
+ * @brief Initializes a Bloom filter sized for a number of elements and a false positive rate
+ *
+ * @param[out]  filter              The Bloom filter
+ * @param[in]   capacity            The expected number of elements
+ * @param[in]   false_positive_rate The false positive rate once capacity elements were added, in ]0,1[
+ *
+ * @return a status code
+ */
+retcode_t bloom_filter_init(bloom_filter_t *const filter, size_t const capacity, double const false_positive_rate);
+
+/**
+ * @brief Destroys a Bloom filter
+ *
+ * @param[in,out] filter The Bloom filter
+ */
+void bloom_filter_destroy(bloom_filter_t *const filter);
+
+/**
+ * @brief Removes all elements of a Bloom filter
+ *
+ * @param[in,out] filter The Bloom filter
+ */
+void bloom_filter_reset(bloom_filter_t *const filter);
+
+/**
+ * @brief Adds an element to a Bloom filter
+ *
+ * @param[in,out] filter  The Bloom filter
+ * @param[in]     data    The element
+ * @param[in]     length  The size of the element
+ */
+void bloom_filter_add(bloom_filter_t *const filter, void const *const data, size_t const length);
+
+/**
+ * @brief Tells whether an element may have been added to a Bloom filter
+ *
+ * @param[in] filter  The Bloom filter
+ * @param[in] data    The element
+ * @param[in] length  The size of the element
+ *
+ * @return false if the element was never added, true if it probably was
+ */
+bool bloom_filter_contains(bloom_filter_t const *const filter, void const *const data, size_t const length);
+
+/**
+ * @brief Tells whether a Bloom filter holds as many elements as it was sized for
+ *
+ * @param[in] filter The Bloom filter
+ *
+ * @return true if full, false otherwise
+ */
+static inline bool bloom_filter_is_full(bloom_filter_t const *const filter) { return filter->size >= filter->capacity; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_CONTAINERS_BLOOM_FILTER_H__
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/containers/lf_ring_buffer.h"
+
+#define LF_RING_BUFFER_SLOT_ALIGNMENT sizeof(atomic_size_t)
+
+/*
+ * Private functions
+ */
+
+static inline atomic_size_t *slot_sequence(lf_ring_buffer_t const *const ring_buffer, size_t const pos) {
+  return (atomic_size_t *)(ring_buffer->slots + (pos & ring_buffer->mask) * ring_buffer->slot_size);
+}
+
+static inline void *slot_element(atomic_size_t *const sequence) { return (uint8_t *)sequence + sizeof(atomic_size_t); }
+
+/*
+ * Public functions
+ */
+
+retcode_t lf_ring_buffer_init(lf_ring_buffer_t *const ring_buffer, size_t const capacity, size_t const element_size) {
+  size_t actual_capacity = 1;
+
+  if (ring_buffer == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (capacity == 0 || element_size == 0) {
+    return RC_INVALID_PARAM;
+  }
+
+  while (actual_capacity < capacity) {
+    actual_capacity <<= 1;
+  }
+
+  ring_buffer->element_size = element_size;
+  ring_buffer->slot_size = sizeof(atomic_size_t) + element_size;
+  ring_buffer->slot_size = (ring_buffer->slot_size + LF_RING_BUFFER_SLOT_ALIGNMENT - 1) &
+                           ~(LF_RING_BUFFER_SLOT_ALIGNMENT - 1);
+  ring_buffer->mask = actual_capacity - 1;
+
+  if ((ring_buffer->slots = (uint8_t *)malloc(actual_capacity * ring_buffer->slot_size)) == NULL) {
+    return RC_OOM;
+  }
+
+  for (size_t i = 0; i < actual_capacity; i++) {
+    atomic_init(slot_sequence(ring_buffer, i), i);
+  }
+  atomic_init(&ring_buffer->enqueue_pos, 0);
+  atomic_init(&ring_buffer->dequeue_pos, 0);
+
+  return RC_OK;
+}
+
+void lf_ring_buffer_destroy(lf_ring_buffer_t *const ring_buffer) {
+  if (ring_buffer == NULL) {
+    return;
+  }
+
+  free(ring_buffer->slots);
+  ring_buffer->slots = NULL;
+  ring_buffer->mask = 0;
+}
+
+retcode_t lf_ring_buffer_push(lf_ring_buffer_t *const ring_buffer, void const *const element) {
+  atomic_size_t *sequence = NULL;
+  size_t pos = 0;
+  size_t seq = 0;
+  intptr_t diff = 0;
+
+  if (ring_buffer == NULL || element == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  pos = atomic_load_explicit(&ring_buffer->enqueue_pos, memory_order_relaxed);
+  while (true) {
+    sequence = slot_sequence(ring_buffer, pos);
+    seq = atomic_load_explicit(sequence, memory_order_acquire);
+    diff = (intptr_t)seq - (intptr_t)pos;
+    if (diff == 0) {
+      // The slot is free for this lap, try to claim it
+      if (atomic_compare_exchange_weak_explicit(&ring_buffer->enqueue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The slot still holds an element of the previous lap
+      return RC_UTILS_RING_BUFFER_FULL;
+    } else {
+      // Another producer claimed the slot
+      pos = atomic_load_explicit(&ring_buffer->enqueue_pos, memory_order_relaxed);
+    }
+  }
+
+  memcpy(slot_element(sequence), element, ring_buffer->element_size);
+  atomic_store_explicit(sequence, pos + 1, memory_order_release);
+
+  return RC_OK;
+}
+
+bool lf_ring_buffer_pop(lf_ring_buffer_t *const ring_buffer, void *const element) {
+  atomic_size_t *sequence = NULL;
+  size_t pos = 0;
+  size_t seq = 0;
+  intptr_t diff = 0;
+
+  if (ring_buffer == NULL || element == NULL) {
+    return false;
+  }
+
+  pos = atomic_load_explicit(&ring_buffer->dequeue_pos, memory_order_relaxed);
+  while (true) {
+    sequence = slot_sequence(ring_buffer, pos);
+    seq = atomic_load_explicit(sequence, memory_order_acquire);
+    diff = (intptr_t)seq - (intptr_t)(pos + 1);
+    if (diff == 0) {
+      // The slot is filled for this lap, try to claim it
+      if (atomic_compare_exchange_weak_explicit(&ring_buffer->dequeue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The slot has not been filled yet
+      return false;
+    } else {
+      // Another consumer claimed the slot
+      pos = atomic_load_explicit(&ring_buffer->dequeue_pos, memory_order_relaxed);
+    }
+  }
+
+  memcpy(element, slot_element(sequence), ring_buffer->element_size);
+  atomic_store_explicit(sequence, pos + ring_buffer->mask + 1, memory_order_release);
+
+  return true;
+}
+
+size_t lf_ring_buffer_pop_batch(lf_ring_buffer_t *const ring_buffer, void *const elements, size_t const max) {
+  size_t count = 0;
+
+  if (ring_buffer == NULL || elements == NULL) {
+    return 0;
+  }
+
+  while (count < max && lf_ring_buffer_pop(ring_buffer, (uint8_t *)elements + count * ring_buffer->element_size)) {
+    count++;
+  }
+
+  return count;
+}
+
+size_t lf_ring_buffer_size(lf_ring_buffer_t *const ring_buffer) {
+  size_t enqueue_pos = 0;
+  size_t dequeue_pos = 0;
+
+  if (ring_buffer == NULL) {
+    return 0;
+  }
+
+  dequeue_pos = atomic_load_explicit(&ring_buffer->dequeue_pos, memory_order_relaxed);
+  enqueue_pos = atomic_load_explicit(&ring_buffer->enqueue_pos, memory_order_relaxed);
+
+  return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+}
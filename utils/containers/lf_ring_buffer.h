@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __UTILS_CONTAINERS_LF_RING_BUFFER_H__
+#define __UTILS_CONTAINERS_LF_RING_BUFFER_H__
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LF_RING_BUFFER_CACHE_LINE_SIZE 64
+
+/**
+ * @brief A fixed capacity lock-free ring buffer of fixed size elements.
+ *
+ * Any number of producers and consumers can use it concurrently. Each slot carries a sequence number that tells
+ * producers and consumers whether the slot is free or filled for the current lap, which makes push and pop a single
+ * CAS on the respective position. Elements are copied in and out so that no allocation happens after initialization.
+ * The capacity is rounded up to the next power of two.
+ */
+typedef struct lf_ring_buffer_s {
+  uint8_t *slots;      /*!< Contiguous memory holding all slots */
+  size_t slot_size;    /*!< Size of a slot: a sequence number followed by an element */
+  size_t element_size; /*!< Size of an element */
+  size_t mask;         /*!< Capacity - 1, used to wrap positions */
+  alignas(LF_RING_BUFFER_CACHE_LINE_SIZE) atomic_size_t enqueue_pos; /*!< Next position to push to */
+  alignas(LF_RING_BUFFER_CACHE_LINE_SIZE) atomic_size_t dequeue_pos; /*!< Next position to pop from */
+} lf_ring_buffer_t;
+
+/**
+ * @brief Initializes a ring buffer
+ *
+ * @param[out]  ring_buffer   The ring buffer
+ * @param[in]   capacity      The minimum number of elements the ring buffer can hold
+ * @param[in]   element_size  The size of an element
+ *
+ * @return a status code
+ */
+retcode_t lf_ring_buffer_init(lf_ring_buffer_t *const ring_buffer, size_t const capacity, size_t const element_size);
+
+/**
+ * @brief Destroys a ring buffer, remaining elements are discarded
+ *
+ * @param[in,out] ring_buffer The ring buffer
+ */
+void lf_ring_buffer_destroy(lf_ring_buffer_t *const ring_buffer);
+
+/**
+ * @brief Pushes a copy of an element to a ring buffer
+ *
+ * @param[in,out] ring_buffer The ring buffer
+ * @param[in]     element     The element
+ *
+ * @return RC_OK if pushed, RC_UTILS_RING_BUFFER_FULL if the ring buffer is full
+ */
+retcode_t lf_ring_buffer_push(lf_ring_buffer_t *const ring_buffer, void const *const element);
+
+/**
+ * @brief Pops an element from a ring buffer
+ *
+ * @param[in,out] ring_buffer The ring buffer
+ * @param[out]    element     Where to copy the element
+ *
+ * @return true if an element was popped, false if the ring buffer was empty
+ */
+bool lf_ring_buffer_pop(lf_ring_buffer_t *const ring_buffer, void *const element);
+
+/**
+ * @brief Pops up to a given number of elements from a ring buffer
+ *
+ * @param[in,out] ring_buffer The ring buffer
+ * @param[out]    elements    An array of at least max elements
+ * @param[in]     max         The maximum number of elements to pop
+ *
+ * @return the number of popped elements
+ */
+size_t lf_ring_buffer_pop_batch(lf_ring_buffer_t *const ring_buffer, void *const elements, size_t const max);
+
+/**
+ * @brief Gets the number of elements in a ring buffer
+ *
+ * Only a snapshot when producers or consumers are active.
+ *
+ * @param[in] ring_buffer The ring buffer
+ *
+ * @return the number of elements
+ */
+size_t lf_ring_buffer_size(lf_ring_buffer_t *const ring_buffer);
+
+/**
+ * @brief Gets the capacity of a ring buffer
+ *
+ * @param[in] ring_buffer The ring buffer
+ *
+ * @return the capacity
+ */
+static inline size_t lf_ring_buffer_capacity(lf_ring_buffer_t const *const ring_buffer) {
+  return ring_buffer->slots ? ring_buffer->mask + 1 : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_CONTAINERS_LF_RING_BUFFER_H__
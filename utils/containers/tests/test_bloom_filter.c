@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "utils/containers/bloom_filter.h"
+
+#define ELEMENTS_NUM 10000
+
+static bloom_filter_t filter;
+
+void test_init(void) {
+  TEST_ASSERT(bloom_filter_init(NULL, 8, 0.01) == RC_NULL_PARAM);
+  TEST_ASSERT(bloom_filter_init(&filter, 0, 0.01) == RC_INVALID_PARAM);
+  TEST_ASSERT(bloom_filter_init(&filter, 8, 0) == RC_INVALID_PARAM);
+  TEST_ASSERT(bloom_filter_init(&filter, 8, 1) == RC_INVALID_PARAM);
+
+  // 1% false positives needs about 9.6 bits and 7 hashes per element
+  TEST_ASSERT(bloom_filter_init(&filter, 100, 0.01) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(filter.hashes_num, 7);
+  TEST_ASSERT_EQUAL_INT(filter.bits_num, 960);
+  bloom_filter_destroy(&filter);
+}
+
+void test_add_contains(void) {
+  size_t false_positives = 0;
+
+  TEST_ASSERT(bloom_filter_init(&filter, ELEMENTS_NUM, 0.01) == RC_OK);
+
+  for (uint64_t i = 0; i < ELEMENTS_NUM; i += 2) {
+    TEST_ASSERT_FALSE(bloom_filter_is_full(&filter));
+    bloom_filter_add(&filter, &i, sizeof(i));
+  }
+
+  // No false negatives
+  for (uint64_t i = 0; i < ELEMENTS_NUM; i += 2) {
+    TEST_ASSERT_TRUE(bloom_filter_contains(&filter, &i, sizeof(i)));
+  }
+
+  // Half full, false positives stay well below the target rate
+  for (uint64_t i = 1; i < ELEMENTS_NUM; i += 2) {
+    false_positives += bloom_filter_contains(&filter, &i, sizeof(i));
+  }
+  TEST_ASSERT(false_positives < ELEMENTS_NUM / 2 / 100);
+
+  for (uint64_t i = ELEMENTS_NUM; i < 2 * ELEMENTS_NUM; i += 2) {
+    bloom_filter_add(&filter, &i, sizeof(i));
+  }
+  TEST_ASSERT_TRUE(bloom_filter_is_full(&filter));
+
+  bloom_filter_reset(&filter);
+  TEST_ASSERT_FALSE(bloom_filter_is_full(&filter));
+  for (uint64_t i = 0; i < ELEMENTS_NUM; i += 2) {
+    TEST_ASSERT_FALSE(bloom_filter_contains(&filter, &i, sizeof(i)));
+  }
+
+  bloom_filter_destroy(&filter);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_init);
+  RUN_TEST(test_add_contains);
+
+  return UNITY_END();
+}
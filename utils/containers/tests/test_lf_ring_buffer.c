@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "utils/containers/lf_ring_buffer.h"
+#include "utils/handles/thread.h"
+
+#define PRODUCERS_NUM 4
+#define ELEMENTS_PER_PRODUCER 10000
+
+typedef struct element_s {
+  uint32_t producer;
+  uint32_t value;
+} element_t;
+
+static lf_ring_buffer_t ring_buffer;
+
+void test_init(void) {
+  TEST_ASSERT(lf_ring_buffer_init(NULL, 8, sizeof(element_t)) == RC_NULL_PARAM);
+  TEST_ASSERT(lf_ring_buffer_init(&ring_buffer, 0, sizeof(element_t)) == RC_INVALID_PARAM);
+  TEST_ASSERT(lf_ring_buffer_init(&ring_buffer, 8, 0) == RC_INVALID_PARAM);
+
+  // Capacity is rounded up to a power of two
+  TEST_ASSERT(lf_ring_buffer_init(&ring_buffer, 5, sizeof(element_t)) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_capacity(&ring_buffer), 8);
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_size(&ring_buffer), 0);
+  lf_ring_buffer_destroy(&ring_buffer);
+}
+
+void test_push_pop(void) {
+  element_t element = {0, 0};
+
+  TEST_ASSERT(lf_ring_buffer_init(&ring_buffer, 4, sizeof(element_t)) == RC_OK);
+
+  TEST_ASSERT_FALSE(lf_ring_buffer_pop(&ring_buffer, &element));
+
+  // Filling it over capacity fails on the last push
+  for (uint32_t i = 0; i < 4; i++) {
+    element.value = i;
+    TEST_ASSERT(lf_ring_buffer_push(&ring_buffer, &element) == RC_OK);
+  }
+  TEST_ASSERT(lf_ring_buffer_push(&ring_buffer, &element) == RC_UTILS_RING_BUFFER_FULL);
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_size(&ring_buffer), 4);
+
+  // Elements come out in FIFO order
+  for (uint32_t i = 0; i < 4; i++) {
+    TEST_ASSERT_TRUE(lf_ring_buffer_pop(&ring_buffer, &element));
+    TEST_ASSERT_EQUAL_INT(element.value, i);
+  }
+  TEST_ASSERT_FALSE(lf_ring_buffer_pop(&ring_buffer, &element));
+
+  // Wrapping around several laps
+  for (uint32_t i = 0; i < 10; i++) {
+    element.value = i;
+    TEST_ASSERT(lf_ring_buffer_push(&ring_buffer, &element) == RC_OK);
+    TEST_ASSERT_TRUE(lf_ring_buffer_pop(&ring_buffer, &element));
+    TEST_ASSERT_EQUAL_INT(element.value, i);
+  }
+
+  lf_ring_buffer_destroy(&ring_buffer);
+}
+
+void test_pop_batch(void) {
+  element_t element = {0, 0};
+  element_t elements[8];
+
+  TEST_ASSERT(lf_ring_buffer_init(&ring_buffer, 8, sizeof(element_t)) == RC_OK);
+
+  for (uint32_t i = 0; i < 6; i++) {
+    element.value = i;
+    TEST_ASSERT(lf_ring_buffer_push(&ring_buffer, &element) == RC_OK);
+  }
+
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_pop_batch(&ring_buffer, elements, 4), 4);
+  for (uint32_t i = 0; i < 4; i++) {
+    TEST_ASSERT_EQUAL_INT(elements[i].value, i);
+  }
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_pop_batch(&ring_buffer, elements, 8), 2);
+  TEST_ASSERT_EQUAL_INT(elements[0].value, 4);
+  TEST_ASSERT_EQUAL_INT(elements[1].value, 5);
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_pop_batch(&ring_buffer, elements, 8), 0);
+
+  lf_ring_buffer_destroy(&ring_buffer);
+}
+
+static void *producer_routine(void *arg) {
+  element_t element = {(uint32_t)(uintptr_t)arg, 0};
+
+  while (element.value < ELEMENTS_PER_PRODUCER) {
+    if (lf_ring_buffer_push(&ring_buffer, &element) == RC_OK) {
+      element.value++;
+    }
+  }
+
+  return NULL;
+}
+
+void test_concurrent_producers(void) {
+  thread_handle_t producers[PRODUCERS_NUM];
+  uint32_t next[PRODUCERS_NUM] = {0};
+  element_t elements[64];
+  size_t total = 0;
+  size_t count = 0;
+
+  TEST_ASSERT(lf_ring_buffer_init(&ring_buffer, 256, sizeof(element_t)) == RC_OK);
+
+  for (size_t i = 0; i < PRODUCERS_NUM; i++) {
+    TEST_ASSERT(thread_handle_create(&producers[i], producer_routine, (void *)(uintptr_t)i) == 0);
+  }
+
+  // Every element is received exactly once and in order for a given producer
+  while (total < PRODUCERS_NUM * ELEMENTS_PER_PRODUCER) {
+    count = lf_ring_buffer_pop_batch(&ring_buffer, elements, 64);
+    for (size_t i = 0; i < count; i++) {
+      TEST_ASSERT_EQUAL_INT(elements[i].value, next[elements[i].producer]);
+      next[elements[i].producer]++;
+    }
+    total += count;
+  }
+
+  for (size_t i = 0; i < PRODUCERS_NUM; i++) {
+    TEST_ASSERT(thread_handle_join(producers[i], NULL) == 0);
+    TEST_ASSERT_EQUAL_INT(next[i], ELEMENTS_PER_PRODUCER);
+  }
+  TEST_ASSERT_EQUAL_INT(lf_ring_buffer_size(&ring_buffer), 0);
+
+  lf_ring_buffer_destroy(&ring_buffer);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_init);
+  RUN_TEST(test_push_pop);
+  RUN_TEST(test_pop_batch);
+  RUN_TEST(test_concurrent_producers);
+
+  return UNITY_END();
+}
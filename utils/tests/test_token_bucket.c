@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "utils/token_bucket.h"
+
+void test_token_bucket_burst(void) {
+  token_bucket_t bucket;
+
+  token_bucket_init(&bucket, 10, 5, 1000);
+
+  // A full bucket allows a burst, then nothing until refilled
+  for (size_t i = 0; i < 5; i++) {
+    TEST_ASSERT_TRUE(token_bucket_consume(&bucket, 1, 1000));
+  }
+  TEST_ASSERT_FALSE(token_bucket_consume(&bucket, 1, 1000));
+
+  // 10 tokens per second is one every 100ms
+  TEST_ASSERT_FALSE(token_bucket_consume(&bucket, 1, 1050));
+  TEST_ASSERT_TRUE(token_bucket_consume(&bucket, 1, 1100));
+  TEST_ASSERT_FALSE(token_bucket_consume(&bucket, 1, 1100));
+
+  // Refills never exceed the burst size
+  for (size_t i = 0; i < 5; i++) {
+    TEST_ASSERT_TRUE(token_bucket_consume(&bucket, 1, 60000));
+  }
+  TEST_ASSERT_FALSE(token_bucket_consume(&bucket, 1, 60000));
+
+  // A clock going backwards does not add tokens, nor does it going forward again over the same interval
+  TEST_ASSERT_FALSE(token_bucket_consume(&bucket, 1, 30000));
+  TEST_ASSERT_FALSE(token_bucket_consume(&bucket, 1, 60000));
+  TEST_ASSERT_TRUE(token_bucket_consume(&bucket, 1, 60100));
+}
+
+void test_token_bucket_set_rate(void) {
+  token_bucket_t bucket;
+
+  token_bucket_init(&bucket, 100, 100, 0);
+
+  // Lowering the burst size drops the extra tokens
+  token_bucket_set_rate(&bucket, 10, 2, 0);
+  TEST_ASSERT_TRUE(token_bucket_consume(&bucket, 2, 0));
+  TEST_ASSERT_FALSE(token_bucket_consume(&bucket, 1, 0));
+
+  // Tokens accumulated before the change are kept at the old rate
+  token_bucket_set_rate(&bucket, 1, 2, 100);
+  TEST_ASSERT_TRUE(token_bucket_consume(&bucket, 1, 100));
+  TEST_ASSERT_FALSE(token_bucket_consume(&bucket, 1, 600));
+  TEST_ASSERT_TRUE(token_bucket_consume(&bucket, 1, 1100));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_token_bucket_burst);
+  RUN_TEST(test_token_bucket_set_rate);
+
+  return UNITY_END();
+}
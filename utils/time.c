@@ -36,6 +36,23 @@ uint64_t current_timestamp_ms() {
 #endif
 }
 
+uint64_t current_timestamp_us() {
+#ifdef _WIN32
+  __int64 wintime;
+
+  GetSystemTimeAsFileTime((FILETIME*)&wintime);
+  wintime -= 116444736000000000LL;
+
+  return wintime / 10LL;
+#else
+  struct timeval tv = {0, 0};
+
+  gettimeofday(&tv, NULL);
+  uint64_t us = tv.tv_sec * 1000000ULL + tv.tv_usec;
+  return us;
+#endif
+}
+
 void sleep_ms(uint64_t milliseconds) {
 #ifdef _WIN32
   Sleep(milliseconds);
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "utils/token_bucket.h"
+
+static void token_bucket_refill(token_bucket_t *const bucket, uint64_t const now) {
+  // A clock going backwards neither adds tokens nor moves the last refill back, which would credit the same interval
+  // twice once the clock goes forward again
+  if (now > bucket->last) {
+    bucket->tokens += (now - bucket->last) * bucket->rate / 1000.0;
+    if (bucket->tokens > bucket->burst) {
+      bucket->tokens = bucket->burst;
+    }
+    bucket->last = now;
+  }
+}
+
+void token_bucket_init(token_bucket_t *const bucket, double const rate, double const burst, uint64_t const now) {
+  bucket->tokens = burst;
+  bucket->rate = rate;
+  bucket->burst = burst;
+  bucket->last = now;
+}
+
+void token_bucket_set_rate(token_bucket_t *const bucket, double const rate, double const burst, uint64_t const now) {
+  token_bucket_refill(bucket, now);
+  bucket->rate = rate;
+  bucket->burst = burst;
+  if (bucket->tokens > burst) {
+    bucket->tokens = burst;
+  }
+}
+
+bool token_bucket_consume(token_bucket_t *const bucket, double const tokens, uint64_t const now) {
+  token_bucket_refill(bucket, now);
+  if (bucket->tokens < tokens) {
+    return false;
+  }
+  bucket->tokens -= tokens;
+
+  return true;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __UTILS_TOKEN_BUCKET_H__
+#define __UTILS_TOKEN_BUCKET_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A token bucket rate limiter
+ *
+ * Tokens are added continuously at a given rate, up to a burst size, and each operation consumes some. The bucket is
+ * refilled lazily from the elapsed time when tokens are consumed. It is not thread safe.
+ */
+typedef struct token_bucket_s {
+  double tokens;  /*!< Tokens available */
+  double rate;    /*!< Tokens added per second */
+  double burst;   /*!< Maximum number of tokens */
+  uint64_t last;  /*!< Time (in milliseconds) of the last refill */
+} token_bucket_t;
+
+/**
+ * Initializes a full token bucket
+ *
+ * @param[out]  bucket  The token bucket
+ * @param[in]   rate    Tokens added per second
+ * @param[in]   burst   Maximum number of tokens
+ * @param[in]   now     Current time in milliseconds
+ */
+void token_bucket_init(token_bucket_t *const bucket, double const rate, double const burst, uint64_t const now);
+
+/**
+ * Changes the rate and burst size of a token bucket, tokens above the new burst size are dropped
+ *
+ * @param[in,out] bucket  The token bucket
+ * @param[in]     rate    Tokens added per second
+ * @param[in]     burst   Maximum number of tokens
+ * @param[in]     now     Current time in milliseconds
+ */
+void token_bucket_set_rate(token_bucket_t *const bucket, double const rate, double const burst, uint64_t const now);
+
+/**
+ * Consumes tokens from a token bucket if enough are available
+ *
+ * @param[in,out] bucket  The token bucket
+ * @param[in]     tokens  The number of tokens to consume
+ * @param[in]     now     Current time in milliseconds
+ *
+ * @return true if the tokens were consumed, false if not enough were available
+ */
+bool token_bucket_consume(token_bucket_t *const bucket, double const tokens, uint64_t const now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_TOKEN_BUCKET_H__